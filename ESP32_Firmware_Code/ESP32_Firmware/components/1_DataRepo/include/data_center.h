@@ -59,3 +59,25 @@ void DataCenter_Set_Env(const DC_EnvData_t *in_data);
 
 void DataCenter_Get_Timer(DC_TimerData_t *out_data);
 void DataCenter_Set_Timer(const DC_TimerData_t *in_data);
+
+// ============================================================
+// 3. [新增] 数据变更通知 (供 UI 等需要即时刷新的模块订阅)
+// ============================================================
+#define DC_DOMAIN_LIGHTING  (1u << 0)
+#define DC_DOMAIN_SYSTEM    (1u << 1)
+#define DC_DOMAIN_ENV       (1u << 2)
+#define DC_DOMAIN_TIMER     (1u << 3)
+
+#define DC_CHANGE_CB_MAX    4
+
+/**
+ * @brief 数据变更回调
+ * @param domains 发生变化的数据域 (DC_DOMAIN_xxx 位掩码)
+ * @note  在调用 Set 接口的任务上下文中同步执行，须轻量且不可阻塞 (如只发任务通知)
+ */
+typedef void (*DC_Change_Cb_t)(uint32_t domains);
+
+/**
+ * @brief 注册数据变更回调 (最多 DC_CHANGE_CB_MAX 个，系统初始化阶段调用)
+ */
+void DataCenter_Register_Change_Cb(DC_Change_Cb_t cb);
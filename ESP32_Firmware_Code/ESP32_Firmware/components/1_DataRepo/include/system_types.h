@@ -36,6 +36,7 @@ typedef enum {
     EVT_LLM_RESULT,               // LLM 回复内容 (参数: 字符串指针)
     EVT_TTS_PLAY_START,           // TTS 开始播放
     EVT_TTS_PLAY_FINISH,          // TTS 播放结束
+    EVT_AUDIO_WAKEUP,             // [新增] 检测到唤醒词 (等同按键单击)
 
     // 5. 设备控制 (Output)
     EVT_LIGHT_SET_COLOR = 0x500,  // 设置灯光颜色 (参数: RGB/CCT)
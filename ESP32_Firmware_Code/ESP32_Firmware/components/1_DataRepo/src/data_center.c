@@ -18,6 +18,19 @@ typedef struct {
 static GlobalDataTree_t s_DataTree;
 static SemaphoreHandle_t s_Mutex = NULL;
 
+// [新增] 数据变更回调表
+static DC_Change_Cb_t s_change_cbs[DC_CHANGE_CB_MAX];
+static int s_change_cb_num = 0;
+
+static void _notify_change(uint32_t domains) {
+    for (int i = 0; i < s_change_cb_num; i++) s_change_cbs[i](domains);
+}
+
+void DataCenter_Register_Change_Cb(DC_Change_Cb_t cb) {
+    if (!cb || s_change_cb_num >= DC_CHANGE_CB_MAX) return;
+    s_change_cbs[s_change_cb_num++] = cb;
+}
+
 void DataCenter_Init(void) {
     if (s_Mutex == NULL) s_Mutex = xSemaphoreCreateMutex();
     xSemaphoreTake(s_Mutex, portMAX_DELAY);
@@ -64,6 +77,7 @@ void DataCenter_Set_Lighting(const DC_LightingData_t *in_data) {
 
     if (changed) {
         EventBus_Send(EVT_DATA_LIGHT_CHANGED, NULL, 0);
+        _notify_change(DC_DOMAIN_LIGHTING);
         Storage_NVS_RequestSave(); // [关键] 触发防抖保存
     }
 }
@@ -88,6 +102,7 @@ void DataCenter_Set_System(const DC_SystemData_t *in_data) {
 
     if (changed) {
         EventBus_Send(EVT_DATA_SYS_CHANGED, NULL, 0);
+        _notify_change(DC_DOMAIN_SYSTEM);
         Storage_NVS_RequestSave(); // [关键] 触发防抖保存
     }
 }
@@ -108,7 +123,10 @@ void DataCenter_Set_Env(const DC_EnvData_t *in_data) {
         changed = true;
     }
     xSemaphoreGive(s_Mutex);
-    if (changed) EventBus_Send(EVT_DATA_ENV_CHANGED, NULL, 0);
+    if (changed) {
+        EventBus_Send(EVT_DATA_ENV_CHANGED, NULL, 0);
+        _notify_change(DC_DOMAIN_ENV);
+    }
 }
 void DataCenter_Get_Timer(DC_TimerData_t *out_data) {
     if (!out_data) return;
@@ -125,7 +143,10 @@ void DataCenter_Set_Timer(const DC_TimerData_t *in_data) {
         changed = true;
     }
     xSemaphoreGive(s_Mutex);
-    if (changed) EventBus_Send(EVT_DATA_TIMER_CHANGED, NULL, 0);
+    if (changed) {
+        EventBus_Send(EVT_DATA_TIMER_CHANGED, NULL, 0);
+        _notify_change(DC_DOMAIN_TIMER);
+    }
 }
 
 void DataCenter_PrintStatus(void) {
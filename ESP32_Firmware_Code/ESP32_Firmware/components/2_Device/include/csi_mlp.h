@@ -0,0 +1,68 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file    csi_mlp.h
+ * @brief   CSI 存在检测的 int8 小型 MLP (特征提取 + 推理)
+ * @note    纯 C 实现，不依赖 ESP-IDF / FreeRTOS：固件中作为 dev_csi 的第 4 个检测器 (V4)，
+ *          主机端由 Thesis_Data_Analysis/train_7_3_csi_mlp.py 编译成动态库，
+ *          在回放数据上做精度回归检查。权重由训练脚本导出到 src/csi_mlp_weights.h。
+ *
+ * 特征 (每 500ms 窗口 CSI_MLP_IN 个, 均按 8*log2(1+x) 量化到 int8 [0,127]):
+ *   [0..15]  16 个子载波频带的归一化幅值在窗口内的时间方差
+ *   [16]     相邻帧频带幅值的平均绝对变化量
+ *   [17]     总振幅相对极差 (千分比)
+ *   [18]     RSSI 方差 (x16)
+ *   [19]     16 个频带方差中的最大值
+ */
+
+#define CSI_MLP_BANDS   16
+#define CSI_MLP_IN      20
+#define CSI_MLP_HIDDEN  16
+
+/** @brief 跨窗口的逐帧状态 (上一帧的频带幅值) */
+typedef struct {
+    uint16_t prev_band[CSI_MLP_BANDS];
+    bool     has_prev;
+} CSI_MLP_State_t;
+
+/** @brief 单个窗口的累加量 (出特征后清零) */
+typedef struct {
+    uint32_t frames;
+    uint32_t diffs;                     // 参与帧间变化统计的帧数
+    uint32_t band_sum[CSI_MLP_BANDS];
+    uint64_t band_sq[CSI_MLP_BANDS];
+    uint32_t diff_sum;
+    uint32_t amp_min;
+    uint32_t amp_max;
+    uint64_t amp_sum;
+    int32_t  rssi_sum;
+    uint32_t rssi_sq;
+} CSI_MLP_Window_t;
+
+/**
+ * @brief 累加一帧
+ * @param amps      每个子载波的 |I|+|Q|
+ * @param sub_count 子载波数 (< CSI_MLP_BANDS 时忽略该帧)
+ * @param total_amp 所有子载波幅值之和
+ */
+void CSI_MLP_Accumulate(CSI_MLP_State_t *st, CSI_MLP_Window_t *w, const uint16_t *amps,
+                        int sub_count, uint32_t total_amp, int8_t rssi);
+
+/**
+ * @brief 由窗口累加量计算量化特征
+ * @return false=窗口帧数不足 (< 2)，out 未写入
+ */
+bool CSI_MLP_Features(const CSI_MLP_Window_t *w, int8_t out[CSI_MLP_IN]);
+
+/**
+ * @brief int8 推理
+ * @return 有人概率 x1000 (0~1000)
+ */
+uint32_t CSI_MLP_Infer(const int8_t x[CSI_MLP_IN]);
+
+/**
+ * @brief 当前权重是否为训练导出的 (占位权重时返回 false，融合中不参与投票)
+ */
+bool CSI_MLP_Is_Trained(void);
@@ -2,6 +2,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#define CSI_MODE_ENSEMBLE 0   // 多算法加权融合判定 (默认)
+#define CSI_DETECTOR_NUM  4   // 检测器注册表容量 (V1..V4)；V4 仅在 MLP 权重已训练时注册
+
 /**
  * @brief CSI 状态改变回调函数类型
  */
@@ -13,7 +16,22 @@ typedef void (*csi_presence_cb_t)(bool is_present);
 void Dev_CSI_Init(csi_presence_cb_t cb);
 
 /**
- * @brief 动态切换 CSI 算法模式
- * @param mode 1: 归一化轮廓绝对差值法; 2: 宏观总振幅极差法; 3: 轮廓均方误差与截尾滤波法
+ * @brief 动态切换 CSI 判定模式
+ * @param mode 0: 多算法加权融合 (默认); 1: 归一化轮廓绝对差值法;
+ *             2: 宏观总振幅极差法; 3: 轮廓均方误差与截尾滤波法; 4: int8 MLP 分类器 (仅权重已训练时可选)
+ * @note  所有算法始终并行计算并输出 [雷达-ENS] 日志，模式只决定由谁驱动存在回调
  */
 void Dev_CSI_Set_Mode(uint8_t mode);
+
+/**
+ * @brief 启动空房标定 (非阻塞，由 csi_monitor 任务执行)
+ * @param duration_ms 标定时长，0 使用默认 30s
+ * @note  标定期间暂停存在判定；结束后按无人得分的中位数/MAD 设定进入/保持阈值并写入 NVS
+ */
+void Dev_CSI_Start_Calibration(uint32_t duration_ms);
+
+/**
+ * @brief 开关自适应探测速率
+ * @param enable true: 无人 200ms / 动作 50ms / 稳定有人 100ms (默认); false: 固定 50ms (对照测试用)
+ */
+void Dev_CSI_Set_Adaptive_Probe(bool enable);
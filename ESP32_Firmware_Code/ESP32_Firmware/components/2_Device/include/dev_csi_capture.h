@@ -0,0 +1,66 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_wifi.h"
+
+/**
+ * @file    dev_csi_capture.h
+ * @brief   CSI 原始帧二进制采集 (TCP 推流)
+ * @note    开启后 Wi-Fi CSI 回调只把每帧原始 I/Q 拷入无锁帧槽 (槽满丢帧并计数)，
+ *          后台任务补上 CRC16 打包后以 TCP 客户端身份推送到 PC 上的 csi_capture_receiver.py，
+ *          由 PC 端转存为按列存储的文件 (numpy memmap 直接加载)，用于离线训练与调参。
+ *
+ * 线上记录格式 (小端, packed):
+ *   u16 magic (0xC5A1) | u16 iq_len | u32 seq | u64 ts_us | i8 rssi | u8 channel | u8 label | u8 flags
+ *   | int8 iq[iq_len] | u16 crc16 (XMODEM, 覆盖帧头 + iq)
+ */
+
+#define CSI_CAP_MAGIC      0xC5A1
+#define CSI_CAP_MAX_IQ     384     // 单帧 I/Q 字节上限 (LLTF + HT-LTF + STBC)
+
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint16_t iq_len;
+    uint32_t seq;
+    uint64_t ts_us;
+    int8_t   rssi;
+    uint8_t  channel;
+    uint8_t  label;     /*!< 当前标注 (csilabel 指令设置，0 = 未标注) */
+    uint8_t  flags;     /*!< bit0: 本帧之前有丢帧 */
+} CSI_Cap_Header_t;
+
+/** @brief 采集统计 */
+typedef struct {
+    uint32_t frames;    /*!< 已写入缓冲的帧 */
+    uint32_t dropped;   /*!< 缓冲满丢弃的帧 */
+    uint32_t bytes_sent;/*!< 已通过 TCP 发出的字节 */
+    bool     connected;
+} CSI_Cap_Stats_t;
+
+/**
+ * @brief 开始采集并连接 PC 端接收器
+ * @param host 接收器 IPv4 地址 (如 "192.168.1.100")
+ * @param port 接收器端口
+ * @return true=已启动 (连接在后台进行，断线自动重连)
+ */
+bool Dev_CSI_Capture_Start(const char *host, uint16_t port);
+
+/**
+ * @brief 停止采集并断开连接
+ */
+void Dev_CSI_Capture_Stop(void);
+
+/**
+ * @brief 设置后续帧的标注 (0 = 未标注)
+ */
+void Dev_CSI_Capture_Set_Label(uint8_t label);
+
+/**
+ * @brief 由 dev_csi 的 Wi-Fi CSI 回调调用 (未开启采集时立即返回)
+ */
+void Dev_CSI_Capture_Push(const wifi_csi_info_t *info);
+
+/**
+ * @brief 获取采集统计
+ */
+void Dev_CSI_Capture_Get_Stats(CSI_Cap_Stats_t *out);
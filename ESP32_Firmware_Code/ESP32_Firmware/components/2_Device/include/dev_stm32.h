@@ -13,12 +13,28 @@ void Dev_STM32_Init(void);
  */
 void Dev_STM32_Set_Light(uint16_t warm, uint16_t cold);
 
+/**
+ * @brief 让 STM32 在本地渐变到目标亮度 / 色温 (过渡由 STM32 的 DMA 完成，只需发送一帧)
+ * @param bri  目标亮度 (0-1000)
+ * @param cct  目标色温 (0-1000，0 全暖 / 1000 全冷)
+ * @param ms   过渡时长 (ms)，0 表示立即设置
+ * @param ease 缓动曲线: 0 匀速, 1 先慢后快, 2 先快后慢, 3 缓入缓出
+ */
+void Dev_STM32_Fade_Light(uint16_t bri, uint16_t cct, uint16_t ms, uint8_t ease);
+
 /**
  * @brief 向 STM32 发送模式切换指令
  * @param mode 0: Local 模式, 1: Remote UI 模式
  */
 void Dev_STM32_Set_Mode(uint8_t mode);
 
+/**
+ * @brief 开关 STM32 本地环境光补偿 (按 LDR 读数闭环调节亮度，保持桌面照度恒定)
+ * @param enable 1: 开启, 0: 关闭
+ * @param target 目标 LDR 读数 (0-1000，与 env 上报的 l 同量纲)；< 0 表示保持当前照度
+ */
+void Dev_STM32_Set_ALC(uint8_t enable, int16_t target);
+
 /**
  * @brief 动态切换 CRC 发送策略 (用于误码率与拦截测试)
  * @param mode 0: 正确 CRC (crc_right); 1: 错误 CRC (crc_error)
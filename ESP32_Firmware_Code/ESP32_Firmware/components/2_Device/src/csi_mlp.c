@@ -0,0 +1,96 @@
+#include "csi_mlp.h"
+#include "csi_mlp_weights.h"
+#include <math.h>
+#include <string.h>
+
+// ============================================================
+// 1. 特征累加 (每帧调用，运行在 csi_proc 任务)
+// ============================================================
+void CSI_MLP_Accumulate(CSI_MLP_State_t *st, CSI_MLP_Window_t *w, const uint16_t *amps,
+                        int sub_count, uint32_t total_amp, int8_t rssi) {
+    if (sub_count < CSI_MLP_BANDS || total_amp < (uint32_t)sub_count) return;
+
+    // 与 V1/V3 相同的归一化: norm = amp * 100 / mean
+    uint32_t inv = ((uint32_t)sub_count * 100u << 16) / total_amp;
+    int band_size = sub_count / CSI_MLP_BANDS;
+
+    uint32_t diff = 0;
+    for (int b = 0; b < CSI_MLP_BANDS; b++) {
+        uint32_t acc = 0;
+        const uint16_t *p = &amps[b * band_size];
+        for (int i = 0; i < band_size; i++) acc += (p[i] * inv) >> 16;
+        uint16_t band = (uint16_t)(acc / band_size);
+
+        w->band_sum[b] += band;
+        w->band_sq[b] += (uint32_t)band * band;
+        if (st->has_prev) diff += (band > st->prev_band[b]) ? band - st->prev_band[b] : st->prev_band[b] - band;
+        st->prev_band[b] = band;
+    }
+    if (st->has_prev) {
+        w->diff_sum += diff / CSI_MLP_BANDS;
+        w->diffs++;
+    }
+    st->has_prev = true;
+
+    if (w->frames == 0 || total_amp < w->amp_min) w->amp_min = total_amp;
+    if (w->frames == 0 || total_amp > w->amp_max) w->amp_max = total_amp;
+    w->amp_sum += total_amp;
+    w->rssi_sum += rssi;
+    w->rssi_sq += (uint32_t)(rssi * rssi);
+    w->frames++;
+}
+
+// ============================================================
+// 2. 特征量化
+// ============================================================
+static int8_t _quant(uint32_t x) {
+    float q = 8.0f * log2f(1.0f + (float)x);
+    return (q >= 127.0f) ? 127 : (int8_t)q;
+}
+
+/** @brief 方差 = (n*Σx² - (Σx)²) / n² (整数) */
+static uint32_t _var(uint64_t sq, uint64_t sum, uint32_t n) {
+    uint64_t a = sq * n, b = sum * sum;
+    return (a > b) ? (uint32_t)((a - b) / ((uint64_t)n * n)) : 0;
+}
+
+bool CSI_MLP_Features(const CSI_MLP_Window_t *w, int8_t out[CSI_MLP_IN]) {
+    uint32_t n = w->frames;
+    if (n < 2) return false;
+
+    uint32_t var_max = 0;
+    for (int b = 0; b < CSI_MLP_BANDS; b++) {
+        uint32_t v = _var(w->band_sq[b], w->band_sum[b], n);
+        if (v > var_max) var_max = v;
+        out[b] = _quant(v);
+    }
+    out[16] = _quant(w->diffs ? w->diff_sum / w->diffs : 0);
+    out[17] = _quant(w->amp_sum ? (uint32_t)((uint64_t)(w->amp_max - w->amp_min) * 1000u * n / w->amp_sum) : 0);
+    int64_t rs = w->rssi_sum;
+    uint64_t rvar16 = ((uint64_t)w->rssi_sq * n > (uint64_t)(rs * rs))
+                        ? ((uint64_t)w->rssi_sq * n - (uint64_t)(rs * rs)) * 16u / ((uint64_t)n * n) : 0;
+    out[18] = _quant((uint32_t)rvar16);
+    out[19] = _quant(var_max);
+    return true;
+}
+
+// ============================================================
+// 3. int8 推理: IN -> HIDDEN (ReLU, 右移 S1 回到 int8) -> 1 (logit)
+// ============================================================
+uint32_t CSI_MLP_Infer(const int8_t x[CSI_MLP_IN]) {
+    int32_t out = CSI_MLP_B2;
+    for (int j = 0; j < CSI_MLP_HIDDEN; j++) {
+        int32_t acc = CSI_MLP_B1[j];
+        for (int i = 0; i < CSI_MLP_IN; i++) acc += (int32_t)CSI_MLP_W1[j][i] * x[i];
+        acc >>= CSI_MLP_S1;
+        if (acc < 0) acc = 0;
+        if (acc > 127) acc = 127;
+        out += (int32_t)CSI_MLP_W2[j] * acc;
+    }
+    float logit = (float)out / CSI_MLP_OUT_SCALE;
+    return (uint32_t)(1000.0f / (1.0f + expf(-logit)));
+}
+
+bool CSI_MLP_Is_Trained(void) {
+    return CSI_MLP_TRAINED != 0;
+}
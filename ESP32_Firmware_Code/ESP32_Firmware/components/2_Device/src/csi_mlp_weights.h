@@ -0,0 +1,13 @@
+#pragma once
+// 由 Thesis_Data_Analysis/train_7_3_csi_mlp.py 自动生成，请勿手动修改
+// 占位权重: 尚未用采集数据训练，dev_csi.c 不注册 V4 (CSI_MLP_TRAINED = 0)
+#include <stdint.h>
+
+#define CSI_MLP_TRAINED     0
+#define CSI_MLP_S1          0
+#define CSI_MLP_OUT_SCALE   1.0f
+#define CSI_MLP_B2          0
+
+static const int8_t CSI_MLP_W1[16][20] = { { 0 } };
+static const int32_t CSI_MLP_B1[16] = { 0 };
+static const int8_t CSI_MLP_W2[16] = { 0 };
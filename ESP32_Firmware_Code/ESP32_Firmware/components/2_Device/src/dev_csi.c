@@ -1,11 +1,17 @@
 #include "dev_csi.h"
+#include "dev_csi_capture.h"
+#include "csi_mlp.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_netif.h"
 #include "ping/ping_sock.h"
+#include "esp_timer.h"
+#include "nvs.h"
 #include <math.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -13,18 +19,66 @@ static const char *TAG = "Dev_CSI";
 
 #define MAX_SUBCARRIERS 128
 #define CSI_LEAVE_TIMEOUT_MS 15000
+#define CSI_FRAME_QUEUE_LEN  8      // 前端帧队列深度 (2 的幂)，20 帧/s 下约 400ms 余量
+#define CSI_FE_STATS_MS      10000  // 前端统计打印周期
+#define CSI_FUSE_THRESHOLD   100    // 融合得分判定阈值 (各算法得分按自身阈值归一化到 100)
+#define CSI_FUSE_NORM_CAP    300    // 单算法归一化得分上限，防止单一尖峰主导融合结果
+
+// [新增] 自适应阈值 (噪声基底 = 无人时得分的中位数 / MAD)
+#define CSI_NF_WIN           64     // 噪声样本窗口 (500ms 一个，约 32s)
+#define CSI_NF_MIN_SAMPLES   32     // 样本不足时不更新阈值
+#define CSI_NF_UPDATE_MS     10000  // 在线更新周期
+#define CSI_NF_STEP_UP       16     // 在线更新: 阈值上调步长 1/16 (防止漏检的动作慢慢抬高阈值)
+#define CSI_NF_STEP_DOWN     4      // 在线更新: 阈值下调步长 1/4 (环境变安静后尽快回落)
+#define CSI_NF_K_ENTER       6      // 进入阈值 = 中位数 + 6σ
+#define CSI_NF_K_LEAVE       3      // 离开(保持)阈值 = 中位数 + 3σ
+#define CSI_NF_SAVE_MIN_MS   600000 // 在线漂移写 Flash 的最小间隔 (10 分钟)
+#define CSI_CALIB_DEFAULT_MS 30000  // 空房标定默认时长
+#define CSI_NVS_NAMESPACE    "csi_cal"
+#define CSI_NVS_KEY          "th"
+
+// [新增] 自适应探测速率: 无人时低速，首次动作时加速确认，稳定有人后回落
+#define CSI_PROBE_FAST_MS        50     // 原固定速率 (20 包/s)，也是统计"节省"的基准
+#define CSI_PROBE_STEADY_MS      100    // 稳定有人
+#define CSI_PROBE_IDLE_MS        200    // 无人
+#define CSI_PROBE_HOLD_MS        3000   // 触发加速后至少保持高速的时间，避免频繁重建会话
+#define CSI_PROBE_STEADY_AFTER_MS 10000 // 判定有人持续多久后回落到 STEADY
+#define CSI_EMA_REF_DT_MS        50     // 基线 EMA 系数 1/16 对应的参考帧间隔
 
 // ============================================================
-// 函数指针定义 (策略模式)
+// [新增] CSI 前端: 在 Wi-Fi 回调里只做一次 |I|+|Q| 幅值计算，
+// 结果放入无锁单生产者/单消费者队列，由 csi_proc 任务跑检测算法
 // ============================================================
-typedef void (*csi_rx_algo_t)(wifi_csi_info_t *info);
-typedef uint32_t (*csi_eval_algo_t)(void);
+typedef struct {
+    uint32_t tick;                      // 接收时刻 (FreeRTOS tick)
+    uint16_t dt_ms;                     // 距上一帧的间隔 (帧率补偿用)
+    int8_t   rssi;
+    uint8_t  channel;
+    uint16_t sub_count;                 // 有效子载波数
+    uint32_t total_amp;                 // 所有子载波幅值之和
+    uint16_t amps[MAX_SUBCARRIERS];     // 每个子载波的 |I|+|Q|
+} csi_frame_t;
+
+static csi_frame_t s_frame_ring[CSI_FRAME_QUEUE_LEN];
+static volatile uint32_t s_frame_wr = 0;    // 仅 Wi-Fi 回调写
+static volatile uint32_t s_frame_rd = 0;    // 仅 csi_proc 任务写
+static TaskHandle_t s_proc_task = NULL;
+static uint32_t s_prev_frame_tick = 0;      // 仅 Wi-Fi 回调访问
+
+// 前端统计: csi_proc / Wi-Fi 回调累加，monitor 任务打印后清零 (仅用于日志，允许轻微误差)
+static volatile uint32_t s_fe_dropped = 0;
+static uint32_t s_fe_frames = 0;
+static int64_t  s_fe_proc_us_sum = 0;
+static uint32_t s_fe_proc_us_max = 0;
 
-static csi_rx_algo_t s_current_rx_algo = NULL;
-static csi_eval_algo_t s_current_eval_algo = NULL;
+// ============================================================
+// 函数指针定义 (策略模式)
+// ============================================================
+// win 指向该算法自己的窗口统计量 (双缓冲之一)；eval 出分后清空该窗口
+typedef void (*csi_rx_algo_t)(void *win, const csi_frame_t *frame);
+typedef uint32_t (*csi_eval_algo_t)(void *win);
 
-static uint8_t s_current_mode = 3;
-static uint32_t s_current_threshold = 250;
+static volatile uint8_t s_current_mode = CSI_MODE_ENSEMBLE;
 
 static csi_presence_cb_t s_app_cb = NULL;
 static volatile uint32_t s_last_active_tick = 0;
@@ -34,161 +88,430 @@ static bool s_is_present = false;
 static esp_ping_handle_t s_ping_handle = NULL;
 static volatile uint32_t s_last_csi_rx_tick = 0;
 
+// [新增] 探测速率状态 (仅 monitor / UART 任务访问)
+static uint32_t s_probe_interval_ms = CSI_PROBE_FAST_MS;
+static volatile bool s_probe_adaptive = true;
+static uint32_t s_probe_sent_done = 0;      // 已结束会话累计发出的探测包
+
 // ============================================================
 // 算法 1：归一化轮廓绝对差值法 (V1)
+// 基线只由 csi_proc 任务读写；窗口统计量见下方双缓冲说明
 // ============================================================
-static uint32_t s_a1_diff_sum = 0;
-static uint32_t s_a1_count = 0;
+typedef struct {
+    uint32_t diff_sum;
+    uint32_t count;
+} a1_win_t;
+
+static a1_win_t s_a1_win[2];
 static uint16_t s_a1_baseline[MAX_SUBCARRIERS] = {0};
 static bool s_a1_init = false;
 
-static void algo1_rx(wifi_csi_info_t *info) {
-    int sub_count = info->len / 2;
-    if (sub_count > MAX_SUBCARRIERS) sub_count = MAX_SUBCARRIERS;
-    int8_t *data = (int8_t *)info->buf;
-    
-    uint32_t total_amp = 0;
-    uint16_t amps[MAX_SUBCARRIERS];
-    for (int i = 0; i < sub_count; i++) {
-        amps[i] = abs(data[i * 2]) + abs(data[i * 2 + 1]);
-        total_amp += amps[i];
-    }
-    uint32_t mean_amp = total_amp / sub_count;
-    if (mean_amp == 0) return;
+/**
+ * @brief 归一化系数 (Q16): norm = amp * 100 / mean = (amp * inv) >> 16
+ * @note  每帧只做一次除法，取代每个子载波一次的整数除法。
+ *        total >= sub_count 时 inv <= 100<<16，amp(<=256) * inv 不会溢出 32 位
+ */
+static inline uint32_t _norm_inv_q16(const csi_frame_t *f) {
+    if (f->sub_count == 0 || f->total_amp < f->sub_count) return 0; // 平均幅值 < 1，视为无效帧
+    return ((uint32_t)f->sub_count * 100u << 16) / f->total_amp;
+}
+
+/**
+ * @brief 帧率补偿的基线 EMA 系数 (x/16): 以 50ms 帧间隔下 1/16 为基准，
+ *        帧间隔变长时按比例加大步长，保持基线的时间常数 (~0.8s) 不随探测速率变化
+ */
+static inline uint32_t _ema_k16(const csi_frame_t *f) {
+    uint32_t k = (f->dt_ms + CSI_EMA_REF_DT_MS / 2) / CSI_EMA_REF_DT_MS;
+    if (k < 1) k = 1;
+    if (k > 8) k = 8;
+    return k;
+}
+
+static void algo1_rx(void *win, const csi_frame_t *f) {
+    a1_win_t *w = (a1_win_t *)win;
+    uint32_t inv = _norm_inv_q16(f);
+    if (inv == 0) return;
+    int sub_count = f->sub_count;
+    uint32_t k = _ema_k16(f);
 
     uint32_t total_diff = 0;
     for (int i = 0; i < sub_count; i++) {
-        uint16_t norm = (amps[i] * 100) / mean_amp;
+        uint16_t norm = (f->amps[i] * inv) >> 16;
         if (!s_a1_init) {
             s_a1_baseline[i] = norm;
         } else {
             total_diff += abs((int)norm - (int)s_a1_baseline[i]);
-            s_a1_baseline[i] = (s_a1_baseline[i] * 15 + norm) / 16;
+            s_a1_baseline[i] = (s_a1_baseline[i] * (16 - k) + norm * k) / 16;
         }
     }
     if (!s_a1_init) { s_a1_init = true; return; }
     
-    s_a1_diff_sum += (total_diff / sub_count);
-    s_a1_count++;
+    w->diff_sum += (total_diff / sub_count);
+    w->count++;
 }
 
-static uint32_t algo1_eval(void) {
+static uint32_t algo1_eval(void *win) {
+    a1_win_t *w = (a1_win_t *)win;
     uint32_t score = 0;
-    if (s_a1_count > 0) score = s_a1_diff_sum / s_a1_count;
-    s_a1_diff_sum = 0;
-    s_a1_count = 0;
+    if (w->count > 0) score = w->diff_sum / w->count;
+    w->diff_sum = 0;
+    w->count = 0;
     return score;
 }
 
 // ============================================================
 // 算法 2：宏观总振幅极差法 (V2)
+// [修改] 窗口内流式维护最小/最大值，不再缓存历史 (原 64 点上限会静默丢样本)
+// [修改] 极差随样本数增大，低探测速率时按正态极差期望 d2(n) 折算到 10 帧/窗口 (20 帧/s)
 // ============================================================
-static uint32_t s_a2_history[64];
-static int s_a2_count = 0;
-
-static void algo2_rx(wifi_csi_info_t *info) {
-    int8_t *data = (int8_t *)info->buf;
-    uint32_t total_amp = 0;
-    for (int i = 0; i < info->len - 1; i += 2) {
-        total_amp += abs(data[i]) + abs(data[i+1]);
-    }
-    if (s_a2_count < 64) s_a2_history[s_a2_count++] = total_amp;
+// d2(n) * 1000, n = 0..10；样本数 >= 10 时不折算 (保持原 50ms 探测下的得分不变)
+static const uint16_t s_a2_d2_x1000[11] = {
+    0, 0, 1128, 1693, 2059, 2326, 2534, 2704, 2847, 2970, 3078
+};
+#define A2_REF_N 10
+typedef struct {
+    uint32_t min_a;
+    uint32_t max_a;
+    uint32_t count;
+} a2_win_t;
+
+static a2_win_t s_a2_win[2];
+
+static void algo2_rx(void *win, const csi_frame_t *f) {
+    a2_win_t *w = (a2_win_t *)win;
+    if (w->count == 0 || f->total_amp < w->min_a) w->min_a = f->total_amp;
+    if (w->count == 0 || f->total_amp > w->max_a) w->max_a = f->total_amp;
+    w->count++;
 }
 
-static uint32_t algo2_eval(void) {
+static uint32_t algo2_eval(void *win) {
+    a2_win_t *w = (a2_win_t *)win;
     uint32_t score = 0;
-    if (s_a2_count > 2) {
-        uint32_t max_a = 0, min_a = 0xFFFFFFFF;
-        for (int i = 0; i < s_a2_count; i++) {
-            if (s_a2_history[i] > max_a) max_a = s_a2_history[i];
-            if (s_a2_history[i] < min_a) min_a = s_a2_history[i];
-        }
-        score = max_a - min_a;
+    if (w->count >= A2_REF_N) {
+        score = w->max_a - w->min_a;
+    } else if (w->count >= 2) {
+        score = (uint32_t)((uint64_t)(w->max_a - w->min_a) * s_a2_d2_x1000[A2_REF_N] / s_a2_d2_x1000[w->count]);
     }
-    s_a2_count = 0;
+    w->count = 0;
     return score;
 }
 
 // ============================================================
 // 算法 3：轮廓均方误差与截尾滤波法 (V3)
+// [修改] 截尾均值改为流式: 只保留窗口内最小/最大各 A3_TRIM_KEEP 个值 (有序插入) 与总和，
+//        出分时减去两端 count/5 个值即可，取代每 500ms 一次的拷贝 + 冒泡排序。
+//        count <= 5*A3_TRIM_KEEP (80 帧/窗口) 时结果与原排序实现完全一致
 // ============================================================
-static uint32_t s_a3_history[32];
-static int s_a3_count = 0;
+#define A3_TRIM_KEEP 16
+
+typedef struct {
+    uint64_t sum;
+    uint32_t count;
+    uint8_t  n_lo, n_hi;
+    uint32_t lo[A3_TRIM_KEEP];  // 最小的若干个值，升序
+    uint32_t hi[A3_TRIM_KEEP];  // 最大的若干个值，降序
+} a3_win_t;
+
+static a3_win_t s_a3_win[2];
 static uint16_t s_a3_baseline[MAX_SUBCARRIERS] = {0};
 static bool s_a3_init = false;
 
-static void algo3_rx(wifi_csi_info_t *info) {
-    int sub_count = info->len / 2;
-    if (sub_count > MAX_SUBCARRIERS) sub_count = MAX_SUBCARRIERS;
-    int8_t *data = (int8_t *)info->buf;
-    
-    uint32_t total_amp = 0;
-    uint16_t amps[MAX_SUBCARRIERS];
-    for (int i = 0; i < sub_count; i++) {
-        amps[i] = abs(data[i * 2]) + abs(data[i * 2 + 1]);
-        total_amp += amps[i];
+/** @brief 有序插入到长度受限的数组 (desc=false 升序保留最小值，true 降序保留最大值) */
+static inline void _bounded_insert(uint32_t *arr, uint8_t *n, uint32_t v, bool desc) {
+    int i = *n;
+    if (i == A3_TRIM_KEEP) {
+        if (desc ? (v <= arr[i - 1]) : (v >= arr[i - 1])) return;
+        i--;                    // 挤掉末尾元素
+    } else {
+        (*n)++;
+    }
+    while (i > 0 && (desc ? (arr[i - 1] < v) : (arr[i - 1] > v))) {
+        arr[i] = arr[i - 1];
+        i--;
     }
-    uint32_t mean_amp = total_amp / sub_count;
-    if (mean_amp == 0) return;
+    arr[i] = v;
+}
+
+/** @brief 窗口内追加一个样本 (总和 + 两端有序保留) */
+static inline void _a3_push(a3_win_t *w, uint32_t v) {
+    w->sum += v;
+    w->count++;
+    _bounded_insert(w->lo, &w->n_lo, v, false);
+    _bounded_insert(w->hi, &w->n_hi, v, true);
+}
+
+static void algo3_rx(void *win, const csi_frame_t *f) {
+    a3_win_t *w = (a3_win_t *)win;
+    uint32_t inv = _norm_inv_q16(f);
+    if (inv == 0) return;
+    int sub_count = f->sub_count;
+    uint32_t k = _ema_k16(f);
 
     uint32_t total_sq_diff = 0;
     for (int i = 0; i < sub_count; i++) {
-        uint16_t norm = (amps[i] * 100) / mean_amp;
+        uint16_t norm = (f->amps[i] * inv) >> 16;
         if (!s_a3_init) {
             s_a3_baseline[i] = norm;
         } else {
             int diff = abs((int)norm - (int)s_a3_baseline[i]);
             total_sq_diff += (diff * diff);
-            s_a3_baseline[i] = (s_a3_baseline[i] * 15 + norm) / 16;
+            s_a3_baseline[i] = (s_a3_baseline[i] * (16 - k) + norm * k) / 16;
         }
     }
     if (!s_a3_init) { s_a3_init = true; return; }
     
-    if (s_a3_count < 32) s_a3_history[s_a3_count++] = total_sq_diff / sub_count;
+    _a3_push(w, total_sq_diff / sub_count);
 }
 
-static uint32_t algo3_eval(void) {
+static uint32_t algo3_eval(void *win) {
+    a3_win_t *w = (a3_win_t *)win;
     uint32_t score = 0;
-    int count = s_a3_count;
-    uint32_t local[32];
-    for (int i = 0; i < count; i++) local[i] = s_a3_history[i];
-    s_a3_count = 0;
+    uint32_t count = w->count;
 
     if (count > 0) {
-        for (int i = 0; i < count - 1; i++) {
-            for (int j = i + 1; j < count; j++) {
-                if (local[i] > local[j]) {
-                    uint32_t temp = local[i]; local[i] = local[j]; local[j] = temp;
-                }
-            }
-        }
-        int start = 0, end = count;
-        if (count >= 6) {
-            int trim = count / 5;
-            start = trim; end = count - trim;
-        }
-        uint32_t sum = 0;
-        for (int i = start; i < end; i++) sum += local[i];
-        score = sum / (end - start);
+        uint32_t trim = (count >= 6) ? count / 5 : 0;
+        if (trim > A3_TRIM_KEEP) trim = A3_TRIM_KEEP;
+        uint64_t sum = w->sum;
+        for (uint32_t i = 0; i < trim; i++) sum -= (uint64_t)w->lo[i] + w->hi[i];
+        score = (uint32_t)(sum / (count - 2 * trim));
     }
+    w->sum = 0;
+    w->count = 0;
+    w->n_lo = 0;
+    w->n_hi = 0;
     return score;
 }
 
+// ============================================================
+// [新增] 算法 4：int8 小型 MLP (V4)，特征与推理见 csi_mlp.c，
+// 权重由 Thesis_Data_Analysis/train_7_3_csi_mlp.py 训练导出
+// ============================================================
+static CSI_MLP_Window_t s_a4_win[2];
+static CSI_MLP_State_t s_a4_state;
+static int64_t  s_a4_infer_us_sum = 0;   // 推理耗时统计 (monitor 任务写)
+static uint32_t s_a4_infer_us_max = 0;
+static uint32_t s_a4_infer_cnt = 0;
+
+static void algo4_rx(void *win, const csi_frame_t *f) {
+    CSI_MLP_Accumulate(&s_a4_state, (CSI_MLP_Window_t *)win, f->amps, f->sub_count, f->total_amp, f->rssi);
+}
+
+static uint32_t algo4_eval(void *win) {
+    CSI_MLP_Window_t *w = (CSI_MLP_Window_t *)win;
+    int8_t x[CSI_MLP_IN];
+    uint32_t score = 0;
+    if (CSI_MLP_Features(w, x)) {
+        int64_t t0 = esp_timer_get_time();
+        score = CSI_MLP_Infer(x);
+        uint32_t cost = (uint32_t)(esp_timer_get_time() - t0);
+        s_a4_infer_us_sum += cost;
+        if (cost > s_a4_infer_us_max) s_a4_infer_us_max = cost;
+        s_a4_infer_cnt++;
+    }
+    memset(w, 0, sizeof(*w));
+    return score;
+}
+
+static void algo1_reset(void) { s_a1_init = false; memset(s_a1_win, 0, sizeof(s_a1_win)); }
+static void algo2_reset(void) { memset(s_a2_win, 0, sizeof(s_a2_win)); }
+static void algo3_reset(void) { s_a3_init = false; memset(s_a3_win, 0, sizeof(s_a3_win)); }
+static void algo4_reset(void) { memset(&s_a4_state, 0, sizeof(s_a4_state)); memset(s_a4_win, 0, sizeof(s_a4_win)); }
+
+// ============================================================
+// [新增] 检测器注册表: 每帧所有检测器并行消费同一帧，
+// 新算法只需实现 rx/eval/reset 与一对窗口，并在此追加一行
+// ============================================================
+typedef struct {
+    const char     *name;       // 日志短名 (V1/V2/...)
+    const char     *desc;       // 切换模式时打印的描述
+    csi_rx_algo_t   rx;
+    csi_eval_algo_t eval;
+    void          (*reset)(void);
+    void           *win[2];     // 双缓冲窗口 (下标由 s_win_active 选择)
+    uint32_t        th_default; // 出厂阈值 (未标定时使用，也是自适应的上下限基准)
+    uint8_t         weight;     // 融合权重，0 = 只计算不参与融合
+    bool            fixed_th;   // true = 阈值固定 (概率类得分)，不参与自适应标定
+    uint32_t        th_enter;   // 当前进入阈值 (判定有人)
+    uint32_t        th_leave;   // 当前保持阈值 (有人状态下刷新活动时间)
+    uint32_t        last_score; // 最近一次 eval 得分 (monitor 任务写)
+    int64_t         cost_us_sum;// 前端统计: rx 累计耗时
+    uint32_t        cost_us_max;
+    uint32_t        nf_hist[CSI_NF_WIN]; // 噪声样本环形窗口 (仅 monitor 任务访问)
+    uint16_t        nf_count;
+    uint16_t        nf_idx;
+} csi_detector_t;
+
+static csi_detector_t s_detectors[] = {
+    { .name = "V1", .desc = "Normalized Abs Diff", .rx = algo1_rx, .eval = algo1_eval, .reset = algo1_reset,
+      .win = { &s_a1_win[0], &s_a1_win[1] }, .th_default = 8, .weight = 1 },
+    { .name = "V2", .desc = "Macro Amp Range", .rx = algo2_rx, .eval = algo2_eval, .reset = algo2_reset,
+      .win = { &s_a2_win[0], &s_a2_win[1] }, .th_default = 150, .weight = 1 },
+    { .name = "V3", .desc = "Squared MSE + Trimmed Mean", .rx = algo3_rx, .eval = algo3_eval, .reset = algo3_reset,
+      .win = { &s_a3_win[0], &s_a3_win[1] }, .th_default = 250, .weight = 2 },
+    // 得分为有人概率 x1000；必须放在最后: 占位权重 (未训练) 时 _detectors_register 不注册它
+    { .name = "V4", .desc = "Int8 MLP Classifier", .rx = algo4_rx, .eval = algo4_eval, .reset = algo4_reset,
+      .win = { &s_a4_win[0], &s_a4_win[1] }, .th_default = 500, .weight = 2, .fixed_th = true },
+};
+_Static_assert(sizeof(s_detectors) / sizeof(s_detectors[0]) == CSI_DETECTOR_NUM,
+               "CSI_DETECTOR_NUM must match s_detectors[]");
+#define CSI_DET_MLP  3      // V4 在 s_detectors[] 中的下标
+
+// [新增] 实际注册的检测器数量 (Init 中确定后不再改变): MLP 未训练时为 3，V4 不运行、不出分、不可选
+static int s_detector_num = CSI_DETECTOR_NUM;
+
+// ============================================================
+// [新增] 窗口双缓冲交接 (替代原来跨任务裸读写历史数组)
+// csi_proc 只写 s_win_active 指向的窗口；monitor 翻转 s_win_active 后，
+// 等 csi_proc 写完手上那一帧 (s_win_busy) 再独占读取旧窗口。
+// 两边均用 seq_cst: 要么写方复查时看到翻转，要么读方看到 busy 标记并等待
+// ============================================================
+static volatile uint32_t s_win_active = 0;
+static volatile uint32_t s_win_busy = 0;    // 0 = 空闲，否则 = 正在写的窗口下标 + 1
+static volatile uint32_t s_win_wait_spins = 0; // 统计: monitor 等待写方的次数
+
+/** @brief csi_proc 侧: 声明即将写入的窗口下标 */
+static inline uint32_t _win_begin_write(void) {
+    uint32_t w = __atomic_load_n(&s_win_active, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&s_win_busy, w + 1, __ATOMIC_SEQ_CST);
+    uint32_t w2 = __atomic_load_n(&s_win_active, __ATOMIC_SEQ_CST);
+    if (w2 != w) {              // 恰好被翻转，改写新窗口
+        w = w2;
+        __atomic_store_n(&s_win_busy, w + 1, __ATOMIC_SEQ_CST);
+    }
+    return w;
+}
+
+static inline void _win_end_write(void) {
+    __atomic_store_n(&s_win_busy, 0, __ATOMIC_RELEASE);
+}
+
+/** @brief monitor 侧: 翻转窗口并返回可独占读取的旧窗口下标 */
+static uint32_t _win_swap_for_read(void) {
+    uint32_t old = __atomic_load_n(&s_win_active, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&s_win_active, old ^ 1u, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&s_win_busy, __ATOMIC_SEQ_CST) == old + 1) {
+        s_win_wait_spins++;
+        taskYIELD();            // 写方一帧只需几十到几百 us
+    }
+    return old;
+}
+
+/**
+ * @brief NVS 中保存的标定结果: th[0..count) 为进入阈值，th[count..2*count) 为保持阈值，顺序同 s_detectors[]
+ * @note  按 count 变长保存 (CSI_CALIB_SIZE)。v1 为定长 (count 固定为当时的检测器数 3 或 4)，布局相同，
+ *        v2 起只保存已注册的检测器；加载时按 count 取前 min(count, 已注册数) 项，其余用出厂阈值
+ */
+typedef struct {
+    uint8_t  version;
+    uint8_t  count;
+    uint32_t th[2 * CSI_DETECTOR_NUM];
+} csi_calib_blob_t;
+#define CSI_CALIB_VERSION 2
+#define CSI_CALIB_SIZE(n) (offsetof(csi_calib_blob_t, th) + 2 * (size_t)(n) * sizeof(uint32_t))
+
+static volatile uint32_t s_calib_req_ms = 0;   // 非 0 表示有待开始的标定请求 (UART 任务写)
+
 // ============================================================
 // 核心调度与任务
 // ============================================================
+/**
+ * @brief 前端: 由一帧原始 I/Q 计算每个子载波的 |I|+|Q|、总幅值与帧间隔
+ * @param now 接收时刻 (tick)；主机端回放程序 (Thesis_Data_Analysis/host/csi_replay_host.c) 传入采集时间戳
+ */
+static void _fe_fill(csi_frame_t *f, const wifi_csi_info_t *info, uint32_t now) {
+    int sub_count = info->len / 2;
+    if (sub_count > MAX_SUBCARRIERS) sub_count = MAX_SUBCARRIERS;
+    const int8_t *data = (const int8_t *)info->buf;
+
+    uint32_t total_amp = 0;
+    for (int i = 0; i < sub_count; i++) {
+        uint16_t a = abs(data[i * 2]) + abs(data[i * 2 + 1]);
+        f->amps[i] = a;
+        total_amp += a;
+    }
+    f->sub_count = sub_count;
+    f->total_amp = total_amp;
+    uint32_t dt = (now - s_prev_frame_tick) * portTICK_PERIOD_MS;
+    f->dt_ms = (dt > 1000) ? 1000 : (uint16_t)dt;
+    s_prev_frame_tick = now;
+    f->tick = now;
+    f->rssi = info->rx_ctrl.rssi;
+    f->channel = info->rx_ctrl.channel;
+}
+
+/**
+ * @brief Wi-Fi 驱动回调 (运行在 Wi-Fi 任务中，必须尽快返回)
+ * @note  只计算一次幅值并入队；队列满时丢弃新帧而不是阻塞驱动
+ */
 static void wifi_csi_rx_cb(void *ctx, wifi_csi_info_t *info) {
     s_last_csi_rx_tick = xTaskGetTickCount(); // [关键] 喂狗：只要收到 CSI 数据就更新时间戳
-    if (s_current_rx_algo) s_current_rx_algo(info);
+    if (!info || !info->buf || !s_proc_task) return;
+
+    Dev_CSI_Capture_Push(info); // [新增] 原始帧采集 (未开启时立即返回)
+
+    uint32_t wr = s_frame_wr;
+    if (wr - s_frame_rd >= CSI_FRAME_QUEUE_LEN) {
+        s_fe_dropped++;
+        return;
+    }
+
+    _fe_fill(&s_frame_ring[wr & (CSI_FRAME_QUEUE_LEN - 1)], info, s_last_csi_rx_tick);
+
+    // 先写完帧内容，再发布写指针 (release)，消费者看到新指针时帧一定完整
+    __atomic_store_n(&s_frame_wr, wr + 1, __ATOMIC_RELEASE);
+    xTaskNotifyGive(s_proc_task);
+}
+
+/**
+ * @brief 一帧依次交给所有检测器，并累计前端性能统计
+ */
+static void _proc_frame(const csi_frame_t *f) {
+    int64_t t0 = esp_timer_get_time();
+    int64_t t_prev = t0;
+    uint32_t w = _win_begin_write();
+    for (int i = 0; i < s_detector_num; i++) {
+        csi_detector_t *d = &s_detectors[i];
+        d->rx(d->win[w], f);
+        int64_t t_now = esp_timer_get_time();
+        uint32_t c = (uint32_t)(t_now - t_prev);
+        d->cost_us_sum += c;
+        if (c > d->cost_us_max) d->cost_us_max = c;
+        t_prev = t_now;
+    }
+    _win_end_write();
+    uint32_t cost = (uint32_t)(t_prev - t0);
+
+    s_fe_frames++;
+    s_fe_proc_us_sum += cost;
+    if (cost > s_fe_proc_us_max) s_fe_proc_us_max = cost;
+}
+
+/**
+ * @brief 帧处理任务: 从前端队列取帧，依次交给所有检测器
+ */
+static void csi_proc_task(void *arg) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (s_frame_rd != __atomic_load_n(&s_frame_wr, __ATOMIC_ACQUIRE)) {
+            _proc_frame(&s_frame_ring[s_frame_rd & (CSI_FRAME_QUEUE_LEN - 1)]);
+
+            // 处理完才归还槽位 (release)，保证生产者不会覆盖正在读的帧
+            __atomic_store_n(&s_frame_rd, s_frame_rd + 1, __ATOMIC_RELEASE);
+        }
+    }
 }
 
 // [新增] 停止 Ping 发射器
 static void stop_ping_emitter(void) {
     if (s_ping_handle) {
+        uint32_t sent = 0;
+        esp_ping_get_profile(s_ping_handle, ESP_PING_PROF_REQUEST, &sent, sizeof(sent));
+        s_probe_sent_done += sent;
         esp_ping_stop(s_ping_handle);
         esp_ping_delete_session(s_ping_handle);
         s_ping_handle = NULL;
-        ESP_LOGI(TAG, "Ping emitter stopped.");
+        ESP_LOGD(TAG, "Ping emitter stopped.");
     }
 }
 
@@ -209,46 +532,215 @@ static void start_ping_emitter(void) {
     ping_config.target_addr.type = ESP_IPADDR_TYPE_V4;
     ping_config.target_addr.u_addr.ip4.addr = ip_info.gw.addr; 
     ping_config.count = ESP_PING_COUNT_INFINITE;               
-    ping_config.interval_ms = 50;                              
+    ping_config.interval_ms = s_probe_interval_ms;             
     ping_config.data_size = 32;                                
 
     if (esp_ping_new_session(&ping_config, NULL, &s_ping_handle) == ESP_OK) {
         esp_ping_start(s_ping_handle);
-        ESP_LOGI(TAG, "Ping emitter started targeting GW: " IPSTR, IP2STR(&ip_info.gw));
+        ESP_LOGI(TAG, "Ping emitter started targeting GW: " IPSTR " (%lu ms)", IP2STR(&ip_info.gw), s_probe_interval_ms);
     }
 }
 
+/** @brief 当前会话 + 已结束会话累计发出的探测包数 */
+static uint32_t _probe_sent_total(void) {
+    uint32_t sent = 0;
+    if (s_ping_handle) esp_ping_get_profile(s_ping_handle, ESP_PING_PROF_REQUEST, &sent, sizeof(sent));
+    return s_probe_sent_done + sent;
+}
+
+/** @brief 切换探测间隔 (esp_ping 不支持运行时改间隔，只能重建会话) */
+static void _probe_set_interval(uint32_t interval_ms) {
+    if (interval_ms == s_probe_interval_ms) return;
+    s_probe_interval_ms = interval_ms;
+    if (s_ping_handle) start_ping_emitter();
+}
+
+void Dev_CSI_Set_Adaptive_Probe(bool enable) {
+    s_probe_adaptive = enable;
+    ESP_LOGW(TAG, ">>> CSI probe rate: %s <<<", enable ? "Adaptive" : "Fixed 50ms");
+}
+
 void Dev_CSI_Set_Mode(uint8_t mode) {
-    esp_wifi_set_csi(false); // 切换前先关闭 CSI，保证线程安全
-    
-    s_current_mode = mode;
-    if (mode == 1) {
-        s_current_rx_algo = algo1_rx;
-        s_current_eval_algo = algo1_eval;
-        s_current_threshold = 8;
-        s_a1_init = false; s_a1_count = 0; s_a1_diff_sum = 0;
-        ESP_LOGW(TAG, ">>> Switched to Mode 1: Normalized Abs Diff <<<");
-    } else if (mode == 2) {
-        s_current_rx_algo = algo2_rx;
-        s_current_eval_algo = algo2_eval;
-        s_current_threshold = 150;
-        s_a2_count = 0;
-        ESP_LOGW(TAG, ">>> Switched to Mode 2: Macro Amp Range <<<");
-    } else if (mode == 3) {
-        s_current_rx_algo = algo3_rx;
-        s_current_eval_algo = algo3_eval;
-        s_current_threshold = 250;
-        s_a3_init = false; s_a3_count = 0;
-        ESP_LOGW(TAG, ">>> Switched to Mode 3: Squared MSE + Trimmed Mean <<<");
+    if (mode > s_detector_num) {
+        ESP_LOGE(TAG, "Invalid CSI mode %d (%d detectors registered)", mode, s_detector_num);
+        return;
     }
-    
-    s_is_present = false;
-    esp_wifi_set_csi(true);
+    // 所有检测器始终在跑，切换只改变"谁来做判定"，无需关闭 CSI，也不清空各算法基线
+    __atomic_store_n(&s_current_mode, mode, __ATOMIC_RELAXED);
+
+    if (mode == CSI_MODE_ENSEMBLE) {
+        ESP_LOGW(TAG, ">>> Switched to Mode 0: Weighted Ensemble <<<");
+    } else {
+        ESP_LOGW(TAG, ">>> Switched to Mode %d: %s <<<", mode, s_detectors[mode - 1].desc);
+    }
+}
+
+/**
+ * @brief 融合得分: 各检测器得分按各自阈值归一化 (阈值 = 100)，
+ *        截断到 CSI_FUSE_NORM_CAP 后按权重加权平均 (加权软投票)
+ * @param use_leave true=按保持阈值归一化, false=按进入阈值归一化
+ * @note  截断是为了防止某一个算法的异常尖峰单独"投出"有人
+ */
+static uint32_t _fuse_scores(bool use_leave) {
+    uint32_t acc = 0, wsum = 0;
+    for (int i = 0; i < s_detector_num; i++) {
+        const csi_detector_t *d = &s_detectors[i];
+        uint32_t th = use_leave ? d->th_leave : d->th_enter;
+        if (d->weight == 0 || th == 0) continue;
+        uint32_t norm = (uint32_t)((uint64_t)d->last_score * CSI_FUSE_THRESHOLD / th);
+        if (norm > CSI_FUSE_NORM_CAP) norm = CSI_FUSE_NORM_CAP;
+        acc += norm * d->weight;
+        wsum += d->weight;
+    }
+    return wsum ? acc / wsum : 0;
+}
+
+/**
+ * @brief 结束当前 500ms 窗口: 翻转双缓冲，所有检测器出分，返回融合得分 (按进入阈值归一化)
+ */
+static uint32_t _eval_window(void) {
+    uint32_t rw = _win_swap_for_read();
+    for (int i = 0; i < s_detector_num; i++) {
+        csi_detector_t *d = &s_detectors[i];
+        d->last_score = d->eval(d->win[rw]);
+    }
+    return _fuse_scores(false);
+}
+
+// ============================================================
+// [新增] 自适应阈值: 空房标定 + 在线噪声基底估计 (中位数 / MAD)
+// 仅在 csi_monitor 任务中调用，无需加锁
+// ============================================================
+static void _sort_u32(uint32_t *a, int n) {
+    for (int i = 1; i < n; i++) {      // 插入排序，n <= 64 且 10s 才跑一次
+        uint32_t v = a[i];
+        int j = i - 1;
+        while (j >= 0 && a[j] > v) { a[j + 1] = a[j]; j--; }
+        a[j + 1] = v;
+    }
+}
+
+/**
+ * @brief 由噪声样本计算进入/保持阈值
+ * @note  σ ≈ 1.4826 * MAD；结果限制在出厂阈值的 [1/4, 4] 倍内，避免标定时有人走动或环境极静导致失控
+ */
+static bool _nf_estimate(const csi_detector_t *d, uint32_t *enter, uint32_t *leave) {
+    int n = d->nf_count;
+    if (d->fixed_th || n < CSI_NF_MIN_SAMPLES) return false;
+
+    uint32_t buf[CSI_NF_WIN];
+    memcpy(buf, d->nf_hist, n * sizeof(uint32_t));
+    _sort_u32(buf, n);
+    uint32_t median = buf[n / 2];
+    for (int i = 0; i < n; i++) buf[i] = (buf[i] > median) ? buf[i] - median : median - buf[i];
+    _sort_u32(buf, n);
+    uint32_t sigma = (buf[n / 2] * 1483u + 999u) / 1000u;
+    if (sigma == 0) sigma = 1;   // 量化得分 (如 V1) 的 MAD 可能为 0
+
+    uint32_t lo = d->th_default / 4 + 1, hi = d->th_default * 4;
+    uint32_t e = median + CSI_NF_K_ENTER * sigma;
+    uint32_t l = median + CSI_NF_K_LEAVE * sigma;
+    if (e < lo) e = lo;
+    if (e > hi) e = hi;
+    if (l >= e) l = e * 2 / 3;
+    if (l == 0) l = 1;
+    *enter = e;
+    *leave = l;
+    return true;
+}
+
+/** @brief 阈值向噪声估计值移动一步: 上调 1/16，下调 1/4 (向上取整，保证能收敛到目标) */
+static uint32_t _nf_step(uint32_t cur, uint32_t target) {
+    if (target > cur) return cur + (target - cur + CSI_NF_STEP_UP - 1) / CSI_NF_STEP_UP;
+    return cur - (cur - target + CSI_NF_STEP_DOWN - 1) / CSI_NF_STEP_DOWN;
+}
+
+static void _nf_push(csi_detector_t *d, uint32_t score) {
+    d->nf_hist[d->nf_idx] = score;
+    d->nf_idx = (d->nf_idx + 1) % CSI_NF_WIN;
+    if (d->nf_count < CSI_NF_WIN) d->nf_count++;
+}
+
+static void _thresholds_reset_default(void) {
+    for (int i = 0; i < s_detector_num; i++) {
+        s_detectors[i].th_enter = s_detectors[i].th_default;
+        s_detectors[i].th_leave = s_detectors[i].th_default * 2 / 3;
+    }
+}
+
+static void _thresholds_log(const char *reason) {
+    for (int i = 0; i < s_detector_num; i++) {
+        ESP_LOGI(TAG, "[CSI-TH] %s %s 进入: %lu | 离开: %lu", reason, s_detectors[i].name,
+                 s_detectors[i].th_enter, s_detectors[i].th_leave);
+    }
+}
+
+static void _thresholds_load(void) {
+    _thresholds_reset_default();
+    nvs_handle_t h;
+    if (nvs_open(CSI_NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK) {
+        ESP_LOGW(TAG, "No CSI calibration in NVS, using defaults (run 'csical' in an empty room).");
+        return;
+    }
+    csi_calib_blob_t blob;
+    size_t size = sizeof(blob);
+    esp_err_t err = nvs_get_blob(h, CSI_NVS_KEY, &blob, &size);
+    nvs_close(h);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "No CSI calibration in NVS, using defaults (run 'csical' in an empty room).");
+        return;
+    }
+    // [修改] 不认识的标定数据不再静默忽略: 打印原因后使用出厂阈值
+    if (err != ESP_OK || blob.version == 0 || blob.version > CSI_CALIB_VERSION ||
+        blob.count == 0 || blob.count > CSI_DETECTOR_NUM || size != CSI_CALIB_SIZE(blob.count)) {
+        ESP_LOGW(TAG, "Discarding CSI calibration in NVS (err 0x%x, v%d, count %d, %u bytes), "
+                 "using defaults (run 'csical' in an empty room).",
+                 err, blob.version, blob.count, (unsigned)size);
+        return;
+    }
+
+    int n = (blob.count < s_detector_num) ? blob.count : s_detector_num;
+    for (int i = 0; i < n; i++) {
+        s_detectors[i].th_enter = blob.th[i];
+        s_detectors[i].th_leave = blob.th[blob.count + i];
+    }
+    if (blob.version != CSI_CALIB_VERSION || blob.count != s_detector_num) {
+        ESP_LOGW(TAG, "CSI calibration v%d with %d detectors migrated: kept %d, %d use defaults.",
+                 blob.version, blob.count, n, s_detector_num - n);
+    }
+    _thresholds_log("NVS");
+}
+
+static void _thresholds_save(void) {
+    csi_calib_blob_t blob = { .version = CSI_CALIB_VERSION, .count = (uint8_t)s_detector_num };
+    for (int i = 0; i < s_detector_num; i++) {
+        blob.th[i] = s_detectors[i].th_enter;
+        blob.th[s_detector_num + i] = s_detectors[i].th_leave;
+    }
+    nvs_handle_t h;
+    if (nvs_open(CSI_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK) return;
+    nvs_set_blob(h, CSI_NVS_KEY, &blob, CSI_CALIB_SIZE(s_detector_num));
+    nvs_commit(h);
+    nvs_close(h);
+    ESP_LOGI(TAG, "CSI thresholds saved to NVS.");
+}
+
+void Dev_CSI_Start_Calibration(uint32_t duration_ms) {
+    s_calib_req_ms = duration_ms ? duration_ms : CSI_CALIB_DEFAULT_MS;
 }
 
 static void csi_monitor_task(void *arg) {
     int consecutive_motion_count = 0;
     s_last_csi_rx_tick = xTaskGetTickCount(); // 初始化看门狗
+    uint32_t last_stats_tick = s_last_csi_rx_tick;
+    uint32_t last_nf_tick = s_last_csi_rx_tick;
+    uint32_t last_save_tick = s_last_csi_rx_tick;
+    uint32_t calib_end_tick = 0;
+    uint32_t present_since_tick = 0;
+    uint32_t probe_fast_until = 0;
+    uint32_t probe_stats_sent = _probe_sent_total();
+    bool calibrating = false;
+    bool nf_dirty = false;
 
     while (1) {
         uint32_t now = xTaskGetTickCount();
@@ -263,23 +755,85 @@ static void csi_monitor_task(void *arg) {
             s_last_csi_rx_tick = now; // 重置 tick，避免疯狂重启
         }
 
-        uint32_t score = 0;
-        if (s_current_eval_algo) score = s_current_eval_algo();
+        // [新增] 空房标定请求: 清空噪声窗口，标定期间暂停存在判定
+        if (s_calib_req_ms) {
+            calib_end_tick = now + pdMS_TO_TICKS(s_calib_req_ms);
+            ESP_LOGW(TAG, ">>> CSI calibration started (%lu ms), please leave the room <<<", s_calib_req_ms);
+            s_calib_req_ms = 0;
+            calibrating = true;
+            for (int i = 0; i < s_detector_num; i++) {
+                s_detectors[i].nf_count = 0;
+                s_detectors[i].nf_idx = 0;
+            }
+            // [修改] 标定期间跳过了离开超时，这里直接结束有人状态 (用户被要求离开房间)，
+            //        否则标定前的"有人"会一直保持到标定结束后再等一个超时
+            consecutive_motion_count = 0;
+            if (s_is_present) {
+                s_is_present = false;
+                if (s_app_cb) s_app_cb(false);
+            }
+        }
 
-        ESP_LOGI(TAG, "[雷达-V%d] 得分: %4lu | 阈值: %lu", s_current_mode, score, s_current_threshold);
+        // [修改] 所有检测器同时出分，再按当前模式选择判定依据
+        uint32_t fused = _eval_window();
+        char line[128];
+        int len = 0;
+        for (int i = 0; i < s_detector_num; i++) {
+            const csi_detector_t *d = &s_detectors[i];
+            len += snprintf(line + len, sizeof(line) - len, "%s:%lu/%lu ",
+                            d->name, d->last_score, d->th_enter);
+            if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
+        }
 
-        if (score > s_current_threshold) {
-            consecutive_motion_count++;
-            if (consecutive_motion_count >= 2) {
-                s_last_active_tick = now; 
-                if (!s_is_present) {
-                    s_is_present = true;
-                    if (s_app_cb) s_app_cb(true); 
+        uint8_t mode = __atomic_load_n(&s_current_mode, __ATOMIC_RELAXED);
+        bool over_enter, over_leave;
+        if (mode == CSI_MODE_ENSEMBLE) {
+            over_enter = fused > CSI_FUSE_THRESHOLD;
+            over_leave = _fuse_scores(true) > CSI_FUSE_THRESHOLD;
+        } else {
+            const csi_detector_t *d = &s_detectors[mode - 1];
+            over_enter = d->last_score > d->th_enter;
+            over_leave = d->last_score > d->th_leave;
+            // 单算法模式保留原有日志格式，兼容论文数据脚本
+            ESP_LOGI(TAG, "[雷达-V%d] 得分: %4lu | 阈值: %lu", mode, d->last_score, d->th_enter);
+        }
+        ESP_LOGI(TAG, "[雷达-ENS] %s| 融合:%lu/%d | 模式:%d | 探测:%lums", line, fused, CSI_FUSE_THRESHOLD, mode,
+                 s_probe_interval_ms);
+
+        if (calibrating) {
+            for (int i = 0; i < s_detector_num; i++) _nf_push(&s_detectors[i], s_detectors[i].last_score);
+            if ((int32_t)(now - calib_end_tick) >= 0) {
+                calibrating = false;
+                for (int i = 0; i < s_detector_num; i++) {
+                    csi_detector_t *d = &s_detectors[i];
+                    _nf_estimate(d, &d->th_enter, &d->th_leave);
                 }
+                _thresholds_log("标定");
+                _thresholds_save();
+                last_save_tick = now;
+                nf_dirty = false;
             }
+            vTaskDelay(pdMS_TO_TICKS(500));
+            continue;
+        }
+
+        // [修改] 进入/保持双阈值迟滞: 连续 2 次超进入阈值才判定有人，
+        //        有人之后只要超过较低的保持阈值就刷新活动时间
+        if (over_enter) {
+            consecutive_motion_count++;
         } else {
             consecutive_motion_count = 0;
         }
+        if (!s_is_present) {
+            if (consecutive_motion_count >= 2) {
+                s_last_active_tick = now;
+                present_since_tick = now;
+                s_is_present = true;
+                if (s_app_cb) s_app_cb(true);
+            }
+        } else if (over_leave) {
+            s_last_active_tick = now;
+        }
 
         if (s_is_present) {
             uint32_t elapsed = (now >= s_last_active_tick) ? (now - s_last_active_tick) : 0;
@@ -288,12 +842,112 @@ static void csi_monitor_task(void *arg) {
                 if (s_app_cb) s_app_cb(false); 
             }
         }
+
+        // [新增] 探测速率调度: 无人 IDLE -> 出现动作 FAST (保持 3s) -> 稳定有人 STEADY，
+        //        有人但安静超过离开超时的一半时重新加速，避免低速采样导致误关灯
+        uint32_t want = CSI_PROBE_FAST_MS;
+        if (over_enter) probe_fast_until = now + pdMS_TO_TICKS(CSI_PROBE_HOLD_MS);
+        bool hold_fast = (int32_t)(probe_fast_until - now) > 0;
+        if (s_probe_adaptive) {
+            if (!s_is_present) {
+                want = hold_fast ? CSI_PROBE_FAST_MS : CSI_PROBE_IDLE_MS;
+            } else {
+                uint32_t quiet_ms = (now - s_last_active_tick) * portTICK_PERIOD_MS;
+                uint32_t present_ms = (now - present_since_tick) * portTICK_PERIOD_MS;
+                bool steady = present_ms >= CSI_PROBE_STEADY_AFTER_MS && quiet_ms < CSI_LEAVE_TIMEOUT_MS / 2;
+                want = steady ? CSI_PROBE_STEADY_MS : CSI_PROBE_FAST_MS;
+            }
+        }
+        _probe_set_interval(want);
+
+        // [新增] 在线噪声基底: 只用"判定无人"期间的得分，缓慢跟踪环境变化
+        // [修改] 最近 CSI_PROBE_HOLD_MS 内超过进入阈值的窗口 (尚未确认的动作) 不计入噪声样本，
+        //        否则人的动作被当作噪声抬高阈值，阈值越高越难判定有人，只会一路涨到上限。
+        //        阈值上调慢 (1/16)、下调快 (1/4)，环境变安静后阈值能及时回落
+        if (!s_is_present && !hold_fast) {
+            for (int i = 0; i < s_detector_num; i++) _nf_push(&s_detectors[i], s_detectors[i].last_score);
+        }
+        if ((now - last_nf_tick) * portTICK_PERIOD_MS >= CSI_NF_UPDATE_MS) {
+            last_nf_tick = now;
+            for (int i = 0; i < s_detector_num; i++) {
+                csi_detector_t *d = &s_detectors[i];
+                uint32_t e, l;
+                if (!_nf_estimate(d, &e, &l)) continue;
+                uint32_t ne = _nf_step(d->th_enter, e);
+                uint32_t nl = _nf_step(d->th_leave, l);
+                if (ne != d->th_enter || nl != d->th_leave) nf_dirty = true;
+                d->th_enter = ne;
+                d->th_leave = (nl < ne) ? nl : ne;
+            }
+            if (nf_dirty && (now - last_save_tick) * portTICK_PERIOD_MS >= CSI_NF_SAVE_MIN_MS) {
+                _thresholds_log("在线");
+                _thresholds_save();
+                last_save_tick = now;
+                nf_dirty = false;
+            }
+        }
+
+        // [新增] 前端性能统计 (帧率 / 丢帧 / 单帧处理耗时)
+        if ((now - last_stats_tick) * portTICK_PERIOD_MS >= CSI_FE_STATS_MS) {
+            uint32_t frames = s_fe_frames;
+            ESP_LOGI(TAG, "[CSI-FE] 帧: %lu | 丢弃: %lu | 处理: avg %lu us, max %lu us | 窗口等待: %lu",
+                     frames, s_fe_dropped,
+                     frames ? (uint32_t)(s_fe_proc_us_sum / frames) : 0, s_fe_proc_us_max, s_win_wait_spins);
+            for (int i = 0; i < s_detector_num; i++) {
+                csi_detector_t *d = &s_detectors[i];
+                ESP_LOGI(TAG, "[CSI-FE] %s 耗时: avg %lu us, max %lu us", d->name,
+                         frames ? (uint32_t)(d->cost_us_sum / frames) : 0, d->cost_us_max);
+                d->cost_us_sum = 0;
+                d->cost_us_max = 0;
+            }
+            if (s_detector_num > CSI_DET_MLP) {
+                ESP_LOGI(TAG, "[CSI-ML] 推理: avg %lu us, max %lu us (%lu 窗口)",
+                         s_a4_infer_cnt ? (uint32_t)(s_a4_infer_us_sum / s_a4_infer_cnt) : 0, s_a4_infer_us_max,
+                         s_a4_infer_cnt);
+            }
+            s_a4_infer_us_sum = 0;
+            s_a4_infer_us_max = 0;
+            s_a4_infer_cnt = 0;
+            // 探测包统计: 与固定 50ms 探测相比节省的包数，折算到每小时
+            uint32_t period_ms = (now - last_stats_tick) * portTICK_PERIOD_MS;
+            uint32_t sent_total = _probe_sent_total();
+            uint32_t sent = sent_total - probe_stats_sent;
+            uint32_t fixed = period_ms / CSI_PROBE_FAST_MS;
+            uint32_t saved = (fixed > sent) ? fixed - sent : 0;
+            ESP_LOGI(TAG, "[CSI-PROBE] 间隔: %lu ms | 探测包: %lu (固定 50ms: %lu) | 节省: %lu%% | 约 %lu 包/小时",
+                     s_probe_interval_ms, sent, fixed, fixed ? saved * 100 / fixed : 0,
+                     period_ms ? (uint32_t)((uint64_t)saved * 3600000 / period_ms) : 0);
+            probe_stats_sent = sent_total;
+            s_fe_frames = 0;
+            s_fe_proc_us_sum = 0;
+            s_fe_proc_us_max = 0;
+            s_fe_dropped = 0;
+            s_win_wait_spins = 0;
+            last_stats_tick = now;
+        }
         vTaskDelay(pdMS_TO_TICKS(500)); 
     }
 }
 
+/**
+ * @brief 确定注册的检测器并复位其状态 (主机端回放程序同样调用)
+ * @note  csi_mlp_weights.h 仍是占位权重 (CSI_MLP_TRAINED = 0) 时不注册 V4，
+ *        用 train_7_3_csi_mlp.py 导出训练好的权重后自动启用
+ */
+static void _detectors_register(void) {
+    s_detector_num = CSI_MLP_Is_Trained() ? CSI_DETECTOR_NUM : CSI_DET_MLP;
+    if (s_detector_num <= CSI_DET_MLP) {
+        ESP_LOGW(TAG, "CSI MLP weights are placeholders, V4 not registered (export them with train_7_3_csi_mlp.py).");
+    }
+    for (int i = 0; i < s_detector_num; i++) s_detectors[i].reset();
+}
+
 void Dev_CSI_Init(csi_presence_cb_t cb) {
     s_app_cb = cb;
+    _detectors_register();
+    _thresholds_load(); // [新增] 先加载标定阈值，再启动监控任务
+    // 帧处理任务优先级高于监控任务，保证 500ms 评估窗口内的帧都已处理
+    xTaskCreate(csi_proc_task, "csi_proc", 4096, NULL, 6, &s_proc_task);
     xTaskCreate(csi_monitor_task, "csi_monitor", 4096, NULL, 5, NULL);
 
     wifi_csi_config_t csi_config = {0}; 
@@ -308,8 +962,9 @@ void Dev_CSI_Init(csi_presence_cb_t cb) {
     esp_wifi_set_csi_config(&csi_config);
     esp_wifi_set_csi_rx_cb(wifi_csi_rx_cb, NULL);
     
-    // 默认启动第三版算法
-    Dev_CSI_Set_Mode(3);
+    // [修改] 默认使用多算法加权融合判定
+    Dev_CSI_Set_Mode(CSI_MODE_ENSEMBLE);
+    esp_wifi_set_csi(true);
     
     start_ping_emitter();
 }
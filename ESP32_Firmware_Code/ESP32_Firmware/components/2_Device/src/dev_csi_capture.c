@@ -0,0 +1,261 @@
+#include "dev_csi_capture.h"
+#include "crc16.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "lwip/sockets.h"
+#include <string.h>
+#include <stdlib.h>
+
+static const char *TAG = "Dev_CSI_Cap";
+
+#define CSI_CAP_SLOTS        64          // 帧槽数 (2 的幂)，64 * 404B ≈ 26KB，20 帧/s 下缓冲 3s 网络抖动
+#define CSI_CAP_CHUNK        1436        // 单次 send 的字节数 (一个 TCP MSS 内)
+#define CSI_CAP_RETRY_MS     2000        // 连接失败重试间隔
+#define CSI_CAP_STATS_MS     10000       // 统计打印周期
+#define CSI_CAP_REC_MAX      (sizeof(CSI_Cap_Header_t) + CSI_CAP_MAX_IQ + 2)
+_Static_assert(CSI_CAP_CHUNK >= CSI_CAP_REC_MAX, "CSI_CAP_CHUNK must hold one full record");
+
+// [修改] Wi-Fi 回调只把原始帧拷进无锁单生产者/单消费者帧槽 (与 dev_csi.c 的前端队列同一做法)，
+//        CRC 与打包由推流任务完成，回调里不再取互斥锁 (原 RingBuffer_Write 以 portMAX_DELAY 等锁，会阻塞 Wi-Fi 驱动)
+typedef struct {
+    CSI_Cap_Header_t hdr;           // crc 之外的帧头字段由回调填好
+    int8_t iq[CSI_CAP_MAX_IQ];
+} csi_cap_slot_t;
+
+static csi_cap_slot_t *s_slots = NULL;
+static uint8_t *s_chunk = NULL;              // 推流任务的打包缓冲 (Start 中分配)
+static volatile uint32_t s_slot_wr = 0;     // 仅 Wi-Fi 回调写
+static volatile uint32_t s_slot_rd = 0;     // 仅推流任务写
+static TaskHandle_t s_task = NULL;
+static volatile bool s_enabled = false;
+static volatile uint8_t s_label = 0;
+// 目标地址与推流任务侧统计由 s_cfg_mutex 保护；Start 每次更新地址时 s_cfg_gen 加 1，推流任务据此断开重连
+static SemaphoreHandle_t s_cfg_mutex = NULL;
+static char s_host[16] = {0};
+static uint16_t s_port = 0;
+static volatile uint32_t s_cfg_gen = 0;
+
+// 以下仅 Wi-Fi 回调 (唯一生产者) 访问
+static uint32_t s_seq = 0;
+static bool s_drop_pending = false;
+
+static CSI_Cap_Stats_t s_stats = {0};
+
+// ============================================================
+// 1. 生产者: Wi-Fi CSI 回调中只拷贝一帧到空闲槽 (无锁、不阻塞，槽满直接丢帧)
+// ============================================================
+void Dev_CSI_Capture_Push(const wifi_csi_info_t *info) {
+    if (!s_enabled || !s_slots || !info || !info->buf) return;
+
+    uint32_t wr = s_slot_wr;
+    if (wr - __atomic_load_n(&s_slot_rd, __ATOMIC_ACQUIRE) >= CSI_CAP_SLOTS) {
+        s_stats.dropped++;
+        s_drop_pending = true;
+        s_seq++;    // 序号照常递增，接收端据此统计丢帧
+        return;
+    }
+
+    uint16_t iq_len = (info->len > CSI_CAP_MAX_IQ) ? CSI_CAP_MAX_IQ : info->len;
+    csi_cap_slot_t *slot = &s_slots[wr & (CSI_CAP_SLOTS - 1)];
+    CSI_Cap_Header_t *h = &slot->hdr;
+    h->magic   = CSI_CAP_MAGIC;
+    h->iq_len  = iq_len;
+    h->seq     = s_seq++;
+    h->ts_us   = (uint64_t)esp_timer_get_time();
+    h->rssi    = info->rx_ctrl.rssi;
+    h->channel = info->rx_ctrl.channel;
+    h->label   = s_label;
+    h->flags   = s_drop_pending ? 0x01 : 0x00;
+    memcpy(slot->iq, info->buf, iq_len);
+
+    // 先写完槽内容，再发布写指针 (release)，推流任务看到新指针时帧一定完整
+    __atomic_store_n(&s_slot_wr, wr + 1, __ATOMIC_RELEASE);
+    s_drop_pending = false;
+    s_stats.frames++;
+}
+
+/**
+ * @brief 推流任务侧: 把已就绪的帧槽按线上记录格式 (帧头 + iq + CRC16) 打包进 out
+ * @return 写入 out 的字节数 (0 = 没有就绪的帧)
+ * @note  只打包能完整放下的记录，取走的槽立即归还给回调
+ */
+static size_t _pack_records(uint8_t *out, size_t cap) {
+    size_t len = 0;
+    uint32_t wr = __atomic_load_n(&s_slot_wr, __ATOMIC_ACQUIRE);
+    while (s_slot_rd != wr) {
+        const csi_cap_slot_t *slot = &s_slots[s_slot_rd & (CSI_CAP_SLOTS - 1)];
+        size_t body = sizeof(CSI_Cap_Header_t) + slot->hdr.iq_len;
+        if (len + body + 2 > cap) break;
+
+        memcpy(out + len, &slot->hdr, sizeof(CSI_Cap_Header_t));
+        memcpy(out + len + sizeof(CSI_Cap_Header_t), slot->iq, slot->hdr.iq_len);
+        uint16_t crc = CRC16_Calculate(out + len, body);
+        memcpy(out + len + body, &crc, 2);
+        len += body + 2;
+
+        __atomic_store_n(&s_slot_rd, s_slot_rd + 1, __ATOMIC_RELEASE);
+    }
+    return len;
+}
+
+// ============================================================
+// 2. 消费者: TCP 推流任务 (断线自动重连；半截记录由接收端按 magic + CRC 重新同步)
+// ============================================================
+static int _connect(const char *host, uint16_t port) {
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        ESP_LOGE(TAG, "Invalid host: %s", host);
+        return -1;
+    }
+
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+    if (sock < 0) return -1;
+
+    struct timeval tv = { .tv_sec = 1, .tv_usec = 0 };
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+static bool _send_all(int sock, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        int n = send(sock, data, len, 0);
+        if (n <= 0) return false;
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+static void csi_cap_task(void *arg) {
+    uint32_t last_stats_tick = xTaskGetTickCount();
+    char host[sizeof(s_host)];
+    uint16_t port;
+    uint32_t gen;
+
+    while (1) {
+        if (!s_enabled) {
+            __atomic_store_n(&s_slot_rd, s_slot_wr, __ATOMIC_RELEASE); // 丢弃停止前未发出的帧
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // 取一份目标地址，之后 Start 改地址只会让 s_cfg_gen 变化，不会改到正在使用的副本
+        xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+        memcpy(host, s_host, sizeof(host));
+        port = s_port;
+        gen = s_cfg_gen;
+        xSemaphoreGive(s_cfg_mutex);
+
+        int sock = _connect(host, port);
+        if (sock < 0) {
+            ESP_LOGW(TAG, "Connect %s:%d failed, retry in %d ms", host, port, CSI_CAP_RETRY_MS);
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CSI_CAP_RETRY_MS)); // Start / Stop 可提前唤醒
+            continue;
+        }
+        xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+        s_stats.connected = true;
+        xSemaphoreGive(s_cfg_mutex);
+        ESP_LOGI(TAG, "Streaming CSI to %s:%d", host, port);
+
+        while (s_enabled && gen == s_cfg_gen) {
+            size_t n = _pack_records(s_chunk, CSI_CAP_CHUNK);
+            if (n == 0) {
+                vTaskDelay(pdMS_TO_TICKS(20));
+            } else {
+                if (!_send_all(sock, s_chunk, n)) {
+                    ESP_LOGW(TAG, "Send failed, reconnecting...");
+                    break;
+                }
+                xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+                s_stats.bytes_sent += n;
+                xSemaphoreGive(s_cfg_mutex);
+            }
+
+            uint32_t now = xTaskGetTickCount();
+            if ((now - last_stats_tick) * portTICK_PERIOD_MS >= CSI_CAP_STATS_MS) {
+                ESP_LOGI(TAG, "[CSI-CAP] 帧: %lu | 丢弃: %lu | 已发送: %lu KB | 标注: %d",
+                         s_stats.frames, s_stats.dropped, s_stats.bytes_sent / 1024, s_label);
+                last_stats_tick = now;
+            }
+        }
+
+        close(sock);
+        xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+        s_stats.connected = false;
+        xSemaphoreGive(s_cfg_mutex);
+        if (gen != s_cfg_gen) {
+            // 换了接收端: 旧地址未发出的帧不再补发
+            __atomic_store_n(&s_slot_rd, __atomic_load_n(&s_slot_wr, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+        }
+    }
+}
+
+// ============================================================
+// 3. 接口实现
+// ============================================================
+bool Dev_CSI_Capture_Start(const char *host, uint16_t port) {
+    if (!host || port == 0 || strlen(host) >= sizeof(s_host)) return false;
+
+    // 缓冲、锁与任务只创建一次；任一步失败都直接返回，采集保持关闭
+    if (!s_slots) s_slots = (csi_cap_slot_t *)malloc(CSI_CAP_SLOTS * sizeof(csi_cap_slot_t));
+    if (!s_chunk) s_chunk = (uint8_t *)malloc(CSI_CAP_CHUNK);
+    if (!s_cfg_mutex) s_cfg_mutex = xSemaphoreCreateMutex();
+    if (!s_slots || !s_chunk || !s_cfg_mutex) {
+        ESP_LOGE(TAG, "Capture buffer alloc failed");
+        return false;
+    }
+    if (!s_task && xTaskCreate(csi_cap_task, "csi_cap", 4096, NULL, 3, &s_task) != pdPASS) {
+        s_task = NULL;
+        ESP_LOGE(TAG, "Capture task create failed");
+        return false;
+    }
+
+    // 先停掉生产者 (回调见到 s_enabled = false 即返回，不再写帧计数)，再在锁内换地址、清统计；
+    // 采集中改地址时 s_cfg_gen 变化，推流任务断开旧连接后按新地址重连
+    bool was_enabled = s_enabled;
+    s_enabled = false;
+    xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+    bool changed = strcmp(s_host, host) != 0 || s_port != port;
+    strcpy(s_host, host);
+    s_port = port;
+    if (changed) s_cfg_gen++;
+    if (changed || !was_enabled) memset(&s_stats, 0, sizeof(s_stats));
+    xSemaphoreGive(s_cfg_mutex);
+    s_enabled = true;
+    xTaskNotifyGive(s_task);
+    ESP_LOGW(TAG, ">>> CSI capture ON -> %s:%d <<<", host, port);
+    return true;
+}
+
+void Dev_CSI_Capture_Stop(void) {
+    if (!s_enabled) return;
+    s_enabled = false;
+    xTaskNotifyGive(s_task);    // 重连等待中也立即回到空闲
+    ESP_LOGW(TAG, ">>> CSI capture OFF (frames: %lu, dropped: %lu) <<<", s_stats.frames, s_stats.dropped);
+}
+
+void Dev_CSI_Capture_Set_Label(uint8_t label) {
+    s_label = label;
+    ESP_LOGI(TAG, "Capture label -> %d", label);
+}
+
+void Dev_CSI_Capture_Get_Stats(CSI_Cap_Stats_t *out) {
+    if (!out) return;
+    if (!s_cfg_mutex) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+    *out = s_stats;
+    xSemaphoreGive(s_cfg_mutex);
+}
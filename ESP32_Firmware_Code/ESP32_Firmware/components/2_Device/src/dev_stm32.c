@@ -97,6 +97,23 @@ void Dev_STM32_Set_Light(uint16_t warm, uint16_t cold) {
     _send_raw(buf);
 }
 
+void Dev_STM32_Fade_Light(uint16_t bri, uint16_t cct, uint16_t ms, uint8_t ease) {
+    char buf[128];
+    snprintf(buf, sizeof(buf), "{\"cmd\":\"fade\",\"bri\":%d,\"cct\":%d,\"ms\":%d,\"ease\":%d}",
+             bri, cct, ms, ease);
+    _send_raw(buf);
+}
+
+void Dev_STM32_Set_ALC(uint8_t enable, int16_t target) {
+    char buf[64];
+    if (enable && target >= 0) {
+        snprintf(buf, sizeof(buf), "{\"cmd\":\"alc\",\"en\":1,\"target\":%d}", target);
+    } else {
+        snprintf(buf, sizeof(buf), "{\"cmd\":\"alc\",\"en\":%d}", enable ? 1 : 0);
+    }
+    _send_raw(buf);
+}
+
 void Dev_STM32_Set_Mode(uint8_t mode) {
     char buf[64];
     snprintf(buf, sizeof(buf), "{\"cmd\":\"mode\",\"val\":%d}", mode);
@@ -1,5 +1,15 @@
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
+
+/** @brief 上报统计 (用于评估 MQTT 流量) */
+typedef struct {
+    uint32_t requests;      /*!< Agent_MQTT_Publish_Status 调用次数 */
+    uint32_t publishes;     /*!< 实际发出的消息数 (增量 + 快照) */
+    uint32_t snapshots;     /*!< 其中全量快照数 */
+    uint32_t suppressed;    /*!< 合并后无字段变化而跳过的次数 */
+    uint32_t bytes;         /*!< 累计发出的 payload 字节数 */
+} Agent_MQTT_Stats_t;
 
 /**
  * @brief 初始化并启动 MQTT 客户端
@@ -13,7 +23,22 @@ void Agent_MQTT_Init(void);
 void Agent_MQTT_Stop(void);
 
 /**
- * @brief 主动发布当前设备状态 (Lighting + Env) 到 MQTT_TOPIC_STATUS
- * @note  通常在数据中心发生变化时调用
+ * @brief 请求发布当前设备状态 (Lighting + Env) 到 MQTT_TOPIC_STATUS
+ * @note  通常在数据中心发生变化时调用。调用本身不发包：
+ *        MQTT_COALESCE_MS 窗口内的多次请求合并为一条只含变化字段的增量消息 (QoS 1)。
+ *        增量以 broker 已确认 (PUBACK) 的状态为基准，断线丢失的字段会在下一条增量里重发。
  */
 void Agent_MQTT_Publish_Status(void);
+
+/**
+ * @brief 发布一条事件到 MQTT_TOPIC_EVENT (QoS 1)
+ * @param json 完整 JSON 字符串 (不超过 MQTT_OUTBOX_PAYLOAD_MAX)
+ * @note  未连接、客户端尚未初始化或发件箱中仍有待发消息时进入离线发件箱，连接后按顺序回放，
+ *        事件不会越过排队中的旧消息
+ */
+void Agent_MQTT_Publish_Event(const char *json);
+
+/**
+ * @brief 获取上报统计
+ */
+void Agent_MQTT_Get_Stats(Agent_MQTT_Stats_t *out);
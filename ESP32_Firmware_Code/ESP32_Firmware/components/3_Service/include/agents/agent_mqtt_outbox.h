@@ -0,0 +1,55 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "mqtt_client.h"
+
+/**
+ * @file    agent_mqtt_outbox.h
+ * @brief   MQTT 离线发件箱
+ * @note    断网期间的状态增量和事件先进入 PSRAM 环形队列；队列满时把最旧的 MQTT_OUTBOX_SPILL_MAX / 4 条作为一个块追加到 NVS
+ *          (每块一个键，回放完整块后擦除，不重写已有数据)，NVS 也满时才丢弃最旧的一块。
+ *          重连后由 Agent_MQTT 的发布任务按节奏回放 (先 NVS, 后 PSRAM)。
+ */
+
+#define MQTT_OUTBOX_PAYLOAD_MAX  120   // 单条消息 payload 上限 (字节)
+
+/** @brief 发件箱统计 */
+typedef struct {
+    uint32_t queued;    /*!< 累计入队 */
+    uint32_t spilled;   /*!< 累计溢出到 NVS */
+    uint32_t dropped;   /*!< 累计丢弃 (NVS 也满 / 消息过长) */
+    uint32_t replayed;  /*!< 累计重连后成功回放 */
+    uint16_t pending;   /*!< 当前待发 (PSRAM + NVS) */
+} Agent_MQTT_Outbox_Stats_t;
+
+/**
+ * @brief 初始化 (分配 PSRAM 队列，读取上次断电前残留在 NVS 中的消息数)
+ * @note  可重复调用。应在产生第一条事件之前调用 (早于 Agent_MQTT_Init)，联网前的事件才不会丢失
+ */
+void Agent_MQTT_Outbox_Init(void);
+
+/**
+ * @brief 消息入队 (线程安全)
+ * @param topic   主题 (必须是常量字符串，队列只保存指针)
+ * @return true=入队成功
+ */
+bool Agent_MQTT_Outbox_Push(const char *topic, const char *payload, int len, int qos, int retain);
+
+/**
+ * @brief 回放一批消息
+ * @param client   已连接的客户端
+ * @param max_msgs 本批最多发送条数 (节流)
+ * @return 剩余待发条数
+ */
+int Agent_MQTT_Outbox_Drain(esp_mqtt_client_handle_t client, int max_msgs);
+
+/**
+ * @brief 当前待发条数 (PSRAM + NVS)
+ * @note  非 0 时新消息必须入队排在后面，直接发送会越过排队中的旧消息
+ */
+int Agent_MQTT_Outbox_Pending(void);
+
+/**
+ * @brief 获取统计
+ */
+void Agent_MQTT_Outbox_Get_Stats(Agent_MQTT_Outbox_Stats_t *out);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file    svc_intent.h
+ * @brief   本地离线意图匹配 (Local Intent Engine)
+ * @note    对 ASR 文本做关键词语法匹配，命中灯光/定时类指令时直接操作 DataCenter，
+ *          无需经过 LampMind 云端；未命中 (开放式问答) 时返回 false，由调用者回落到 LampMind。
+ */
+
+/** @brief 意图类型 */
+typedef enum {
+    INTENT_NONE = 0,
+    INTENT_POWER_ON,        /*!< 开灯 */
+    INTENT_POWER_OFF,       /*!< 关灯 */
+    INTENT_BRI_SET,         /*!< 亮度设为 N% (value) */
+    INTENT_BRI_UP,          /*!< 亮一点 */
+    INTENT_BRI_DOWN,        /*!< 暗一点 */
+    INTENT_BRI_MAX,         /*!< 最亮 */
+    INTENT_BRI_MIN,         /*!< 最暗 */
+    INTENT_CCT_SET,         /*!< 色温设为 N% (value, 0=暖, 100=冷) */
+    INTENT_CCT_WARM,        /*!< 暖一点 */
+    INTENT_CCT_COOL,        /*!< 冷一点 */
+    INTENT_TIMER_SET,       /*!< N 秒后关灯 (value = 秒) */
+    INTENT_TIMER_CANCEL,    /*!< 取消定时 */
+} SvcIntent_Type_t;
+
+/** @brief 匹配结果 */
+typedef struct {
+    SvcIntent_Type_t type;
+    int32_t          value; /*!< 槽位值 (百分比或秒)，无槽位时为 0 */
+} SvcIntent_Result_t;
+
+/**
+ * @brief 纯文本匹配 (无副作用，不依赖 RTOS，可在主机端单独编译验证)
+ * @param text ASR 识别文本 (UTF-8)
+ * @param out  匹配结果
+ * @return true=命中本地语法, false=交给 LampMind
+ */
+bool Svc_Intent_Match(const char *text, SvcIntent_Result_t *out);
+
+/**
+ * @brief 匹配并执行 (写入 DataCenter)
+ * @param text      ASR 识别文本
+ * @param out_reply 命中时返回 malloc 的播报文本 (调用者负责释放)，可为 NULL
+ * @return true=已在本地处理, false=未命中
+ * @note 命中时打印 "[TIMING] Intent: ..." 匹配耗时 (us)，与 T0~T4 链路标签区分
+ */
+bool Svc_Intent_Process(const char *text, char **out_reply);
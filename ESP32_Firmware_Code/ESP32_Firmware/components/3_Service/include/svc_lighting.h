@@ -1,6 +1,6 @@
 #pragma once
 
 /**
- * @brief 执行灯光状态更新 (将 DataCenter 的数据转换为 PWM 并下发给 STM32)
+ * @brief 执行灯光状态更新 (将 DataCenter 的数据转换为 fade 渐变指令下发给 STM32)
  */
 void Svc_Lighting_Apply(void);
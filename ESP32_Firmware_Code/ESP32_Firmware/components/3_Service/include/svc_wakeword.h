@@ -0,0 +1,42 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file    svc_wakeword.h
+ * @brief   语音唤醒服务 (ESP-SR WakeNet)
+ * @note    在 Core 1 上持续读取 I2S 麦克风，检测到唤醒词后向 EventBus 发送 EVT_AUDIO_WAKEUP，
+ *          效果等同于按键单击。非 IDLE 状态 (录音/播报中) 自动暂停，避免与 ASR 抢麦克风、被 TTS 回声误唤醒。
+ *          其他任务读取麦克风前必须先调用 Svc_WakeWord_Pause()，确认监听任务已让出 I2S RX。
+ */
+
+/** @brief 唤醒统计 (用于评估误唤醒率与 CPU 预算) */
+typedef struct {
+    uint32_t detections;      /*!< 累计唤醒次数 */
+    uint32_t audio_sec;       /*!< 累计监听的音频时长 (s) */
+    uint8_t  cpu_load_pct;    /*!< 最近一个统计周期 detect() 耗时 / 音频时长 (%) */
+} SvcWakeWord_Stats_t;
+
+/**
+ * @brief 初始化唤醒词模型并创建监听任务 (需在 Dev_Audio_Init 之后调用)
+ */
+void Svc_WakeWord_Init(void);
+
+/**
+ * @brief 开启/暂停监听
+ * @param enable true=监听, false=暂停 (不读取麦克风)
+ * @note  暂停只置标志，不等待正在进行的读取结束; 需要独占麦克风时用 Svc_WakeWord_Pause()
+ */
+void Svc_WakeWord_Set_Enable(bool enable);
+
+/**
+ * @brief 暂停监听，并阻塞到监听任务当前这一帧读取结束 (最多一帧，约 30ms)
+ * @note  返回后监听任务不会再读取 I2S RX，直到 Svc_WakeWord_Set_Enable(true)。
+ *        未启用唤醒词 (KWS_ENABLE=0 或初始化失败) 时立即返回。
+ */
+void Svc_WakeWord_Pause(void);
+
+/**
+ * @brief 获取统计数据
+ */
+void Svc_WakeWord_Get_Stats(SvcWakeWord_Stats_t *out);
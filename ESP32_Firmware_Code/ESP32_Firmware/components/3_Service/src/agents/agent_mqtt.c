@@ -4,32 +4,98 @@
 #include "cJSON.h"
 #include "data_center.h"
 #include "app_config.h"
+#include "agents/agent_mqtt_outbox.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 static const char *TAG = "Agent_MQTT";
 static esp_mqtt_client_handle_t s_client = NULL;
 static bool s_is_connected = false;
 
+// ============================================================
+// [新增] 上报节流相关
+// ============================================================
+#define PUB_NOTIFY_DELTA     (1 << 0)   // 合并窗口到期，发增量
+#define PUB_NOTIFY_SNAPSHOT  (1 << 1)   // 发全量快照 (周期 / 刚连上)
+#define PUB_NOTIFY_DRAIN     (1 << 2)   // 刚连上，回放离线发件箱
+#define PUB_NOTIFY_ACKED     (1 << 3)   // 收到 PUBACK，检查在途的状态消息是否已确认
+
+#define PUB_ACK_RING         8          // 最近收到的 PUBACK msg_id (MQTT 任务写，发布任务读)
+
+#define AVAIL_ONLINE_MSG     "{\"id\":\"" MQTT_DEVICE_ID "\",\"online\":1}"
+#define AVAIL_OFFLINE_MSG    "{\"id\":\"" MQTT_DEVICE_ID "\",\"online\":0}"
+
+/** @brief 已上报给 broker 的状态镜像，用于计算增量 */
+typedef struct {
+    uint8_t power;
+    uint8_t brightness;
+    uint8_t color_temp;
+    int8_t  temp;
+    uint8_t hum;
+} MQTT_StatusMirror_t;
+
+static TaskHandle_t s_pub_task = NULL;
+static TimerHandle_t s_coalesce_timer = NULL;
+static TimerHandle_t s_snapshot_timer = NULL;
+static MQTT_StatusMirror_t s_last_pub;  // broker 已确认 (PUBACK) 的状态，增量以它为基准
+static bool s_has_last_pub = false;     // false 时下一条增量退化为全量
+static MQTT_StatusMirror_t s_inflight;  // 最近一条已发出、尚未确认的状态消息
+static int s_inflight_id = -1;
+static MQTT_StatusMirror_t s_last_queued; // 离线时最近一条进发件箱的状态，离线增量以它为基准
+static bool s_has_last_queued = false;
+static volatile int s_ack_ring[PUB_ACK_RING];
+static volatile uint32_t s_ack_wr = 0;
+static bool s_snapshot_dirty = false;   // 上次快照后是否发过增量
+static Agent_MQTT_Stats_t s_stats = {0};
+static char s_pub_buf[128];             // 预分配的 payload 缓冲区，取代 cJSON 动态分配
+
 // ============================================================
 // 内部逻辑：处理收到的控制指令
 // ============================================================
 
+// [新增] 上次执行的控制序号 (每台设备独立)
+static uint32_t s_last_seq = 0;
+static bool s_has_seq = false;
+static uint32_t s_stale_dropped = 0;
+
 /**
- * @brief 解析来自 Python 的 JSON 指令
- * 格式示例: {"power":1, "brightness":80, "color_temp":20}
+ * @brief 序号检查: 没带 seq 的旧格式指令直接放行
+ * @return true=执行, false=过期/重复指令，丢弃
  */
-static void _handle_ctrl_msg(const char *data, int len) {
-    // 1. 解析 JSON
-    cJSON *json = cJSON_ParseWithLength(data, len);
-    if (!json) {
-        ESP_LOGE(TAG, "JSON Parse Failed");
-        return;
+static bool _seq_accept(const cJSON *obj) {
+    cJSON *seq = cJSON_GetObjectItem(obj, "seq");
+    if (!cJSON_IsNumber(seq)) return true;
+
+    uint32_t val = (uint32_t)seq->valuedouble;
+    if (s_has_seq) {
+        int32_t diff = (int32_t)(val - s_last_seq); // 按 32 位回绕比较
+        if (diff <= 0 && diff > -MQTT_SEQ_STALE_WINDOW) {
+            s_stale_dropped++;
+            ESP_LOGW(TAG, "Stale cmd dropped: seq %lu <= %lu (total %lu)", val, s_last_seq, s_stale_dropped);
+            return false;
+        }
     }
+    s_last_seq = val;
+    s_has_seq = true;
+    return true;
+}
+
+/**
+ * @brief 把一条指令对象写入数据中心
+ * 格式示例: {"seq":12, "power":1, "brightness":80, "color_temp":20} (字段均可选)
+ */
+static void _apply_ctrl_obj(const cJSON *json) {
+    if (!_seq_accept(json)) return;
 
-    // 2. 获取当前数据中心的状态作为基础 (避免覆盖未修改的字段)
+    // 1. 获取当前数据中心的状态作为基础 (避免覆盖未修改的字段)
     DC_LightingData_t light_data;
     DataCenter_Get_Lighting(&light_data);
 
-    // 3. 提取字段并更新
+    // 2. 提取字段并更新
     cJSON *pwr = cJSON_GetObjectItem(json, "power");
     if (pwr) {
         light_data.power = (pwr->valueint != 0);
@@ -52,13 +118,42 @@ static void _handle_ctrl_msg(const char *data, int len) {
         light_data.color_temp = (uint8_t)val;
     }
 
-    // 4. 写回数据中心
+    // 3. 写回数据中心
     // 注意：DataCenter_Set_Lighting 内部会自动比对数据，
     // 如果数据真的变了，它会发出 EVT_DATA_LIGHT_CHANGED 事件。
     DataCenter_Set_Lighting(&light_data);
     
     ESP_LOGI(TAG, "Applied Control: Pwr:%d, Bri:%d, CCT:%d", 
              light_data.power, light_data.brightness, light_data.color_temp);
+}
+
+/**
+ * @brief 解析来自 Python 的 JSON 指令 (单控 / 组播 / 批量)
+ * 单控/组播: {"seq":12, "brightness":80}
+ * 批量信封: {"batch":[{"id":"esp32_001","seq":12,"brightness":80}, {"id":"esp32_002", ...}]}
+ *          只执行 id 与本机 MQTT_DEVICE_ID 相同的条目
+ */
+static void _handle_ctrl_msg(const char *data, int len) {
+    // 1. 解析 JSON
+    cJSON *json = cJSON_ParseWithLength(data, len);
+    if (!json) {
+        ESP_LOGE(TAG, "JSON Parse Failed");
+        return;
+    }
+
+    cJSON *batch = cJSON_GetObjectItem(json, "batch");
+    if (cJSON_IsArray(batch)) {
+        cJSON *item = NULL;
+        cJSON_ArrayForEach(item, batch) {
+            cJSON *id = cJSON_GetObjectItem(item, "id");
+            if (cJSON_IsString(id) && strcmp(id->valuestring, MQTT_DEVICE_ID) == 0) {
+                _apply_ctrl_obj(item);
+                break;
+            }
+        }
+    } else {
+        _apply_ctrl_obj(json);
+    }
 
     cJSON_Delete(json);
 }
@@ -76,8 +171,13 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
             s_is_connected = true;
             // 连接成功后，订阅控制主题
             esp_mqtt_client_subscribe(s_client, MQTT_TOPIC_CTRL, 1);
-            // 上线时主动上报一次当前状态
-            Agent_MQTT_Publish_Status();
+            // [新增] 分区组播 + 全楼广播
+            esp_mqtt_client_subscribe(s_client, MQTT_TOPIC_GROUP_PREFIX MQTT_LAMP_ZONE, 1);
+            esp_mqtt_client_subscribe(s_client, MQTT_TOPIC_GROUP_PREFIX "all", 1);
+            // [新增] 覆盖 broker 上的遗嘱消息
+            esp_mqtt_client_publish(s_client, MQTT_TOPIC_AVAIL, AVAIL_ONLINE_MSG, 0, 1, 1);
+            // 上线时先回放离线期间的消息，再上报一次全量快照 (retain)
+            if (s_pub_task) xTaskNotify(s_pub_task, PUB_NOTIFY_DRAIN | PUB_NOTIFY_SNAPSHOT, eSetBits);
             break;
             
         case MQTT_EVENT_DISCONNECTED:
@@ -85,10 +185,20 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
             s_is_connected = false;
             break;
 
+        case MQTT_EVENT_PUBLISHED:
+            // PUBACK 可能早于 publish() 返回，先记下 msg_id，由发布任务比对
+            s_ack_ring[s_ack_wr % PUB_ACK_RING] = event->msg_id;
+            s_ack_wr++;
+            if (s_pub_task) xTaskNotify(s_pub_task, PUB_NOTIFY_ACKED, eSetBits);
+            break;
+
         case MQTT_EVENT_DATA:
             ESP_LOGI(TAG, "MQTT Data: Topic=%.*s", event->topic_len, event->topic);
-            // 判断是否是控制主题
-            if (strncmp(event->topic, MQTT_TOPIC_CTRL, event->topic_len) == 0) {
+            // 判断是否是控制主题 (单控 或 组播)
+            if ((event->topic_len == strlen(MQTT_TOPIC_CTRL) &&
+                 strncmp(event->topic, MQTT_TOPIC_CTRL, event->topic_len) == 0) ||
+                (event->topic_len > strlen(MQTT_TOPIC_GROUP_PREFIX) &&
+                 strncmp(event->topic, MQTT_TOPIC_GROUP_PREFIX, strlen(MQTT_TOPIC_GROUP_PREFIX)) == 0)) {
                 _handle_ctrl_msg(event->data, event->data_len);
             }
             break;
@@ -102,6 +212,173 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     }
 }
 
+// ============================================================
+// [新增] 状态发布任务 (定时器回调只负责唤醒，组包和发送都在这里)
+// ============================================================
+static void _read_status(MQTT_StatusMirror_t *st) {
+    DC_LightingData_t light;
+    DC_EnvData_t env;
+    DataCenter_Get_Lighting(&light);
+    DataCenter_Get_Env(&env);
+
+    st->power = light.power ? 1 : 0;
+    st->brightness = light.brightness;
+    st->color_temp = light.color_temp;
+    st->temp = env.indoor_temp;
+    st->hum = env.indoor_hum;
+}
+
+/**
+ * @brief 组包: base=NULL 输出全部字段，否则只输出与 base 不同的字段
+ * @return payload 长度，0 表示没有字段需要发送
+ */
+static int _format_status(const MQTT_StatusMirror_t *st, const MQTT_StatusMirror_t *base) {
+    int len = 0;
+    const int cap = sizeof(s_pub_buf);
+    const bool full = (base == NULL);
+
+    len += snprintf(s_pub_buf, cap, "{\"id\":\"%s\",", MQTT_DEVICE_ID); // 群控场景下区分来源
+    const int head_len = len;
+    if (full || st->power != base->power)
+        len += snprintf(s_pub_buf + len, cap - len, "\"power\":%u,", st->power);
+    if (full || st->brightness != base->brightness)
+        len += snprintf(s_pub_buf + len, cap - len, "\"brightness\":%u,", st->brightness);
+    if (full || st->color_temp != base->color_temp)
+        len += snprintf(s_pub_buf + len, cap - len, "\"color_temp\":%u,", st->color_temp);
+    if (full || st->temp != base->temp)
+        len += snprintf(s_pub_buf + len, cap - len, "\"temp\":%d,", st->temp);
+    if (full || st->hum != base->hum)
+        len += snprintf(s_pub_buf + len, cap - len, "\"hum\":%u,", st->hum);
+
+    if (len == head_len) return 0; // 没有变化字段
+    s_pub_buf[len - 1] = '}'; // 覆盖最后一个逗号
+    s_pub_buf[len] = '\0';
+    return len;
+}
+
+/** @brief 给离线消息追加 "ts" (SNTP 同步后才有意义)，便于面板按时间还原历史 */
+static int _append_timestamp(int len) {
+    time_t now = time(NULL);
+    if (now < 1600000000) return len; // 尚未同步时间
+    len--; // 去掉 '}'
+    len += snprintf(s_pub_buf + len, sizeof(s_pub_buf) - len, ",\"ts\":%lld}", (long long)now);
+    return len;
+}
+
+static bool _mirror_equal(const MQTT_StatusMirror_t *a, const MQTT_StatusMirror_t *b) {
+    return a->power == b->power && a->brightness == b->brightness && a->color_temp == b->color_temp &&
+           a->temp == b->temp && a->hum == b->hum;
+}
+
+/** @brief 收到 PUBACK: 在途的状态消息已确认，推进增量基准 */
+static void _check_acked(void) {
+    if (s_inflight_id < 0) return;
+    for (int i = 0; i < PUB_ACK_RING; i++) {
+        if (s_ack_ring[i] == s_inflight_id) {
+            s_last_pub = s_inflight;
+            s_has_last_pub = true;
+            s_inflight_id = -1;
+            return;
+        }
+    }
+}
+
+static void _publish_status(bool snapshot) {
+    if (!s_client) return;
+
+    // [新增] 离线: 快照不入队 (重连后会重发)，增量相对上一条入队的状态计算后进发件箱
+    if (!s_is_connected && snapshot) return;
+
+    MQTT_StatusMirror_t st;
+    _read_status(&st);
+
+    if (!s_is_connected) {
+        const MQTT_StatusMirror_t *base = s_has_last_queued ? &s_last_queued : (s_has_last_pub ? &s_last_pub : NULL);
+        int len = _format_status(&st, base);
+        if (len == 0) {
+            s_stats.suppressed++;
+            return;
+        }
+        len = _append_timestamp(len);
+        if (Agent_MQTT_Outbox_Push(MQTT_TOPIC_STATUS, s_pub_buf, len, 1, 0)) {
+            s_last_queued = st;
+            s_has_last_queued = true;
+            s_snapshot_dirty = true;
+        }
+        return;
+    }
+
+    // 同样的内容已在途 (还没等到 PUBACK)，不重复发送
+    if (!snapshot && s_inflight_id >= 0 && _mirror_equal(&st, &s_inflight)) {
+        s_stats.suppressed++;
+        return;
+    }
+
+    // 增量相对 broker 已确认的状态计算: 未确认 (丢失) 的字段会在下一条增量里重发
+    int len = _format_status(&st, (snapshot || !s_has_last_pub) ? NULL : &s_last_pub);
+    if (len == 0) {
+        s_stats.suppressed++;
+        return;
+    }
+
+    // 增量: QoS 1 不保留；快照: QoS 1 + retain，后上线的订阅者立即拿到完整状态
+    int msg_id = esp_mqtt_client_publish(s_client, MQTT_TOPIC_STATUS, s_pub_buf, len, 1, snapshot ? 1 : 0);
+    if (msg_id < 0) return;
+
+    s_inflight = st;
+    s_inflight_id = msg_id;
+    s_stats.publishes++;
+    s_stats.bytes += len;
+    if (snapshot) {
+        s_stats.snapshots++;
+        s_snapshot_dirty = false;
+        s_has_last_queued = false; // 快照覆盖了离线期间的全部增量
+    } else {
+        s_snapshot_dirty = true;
+    }
+}
+
+static void mqtt_pub_task(void *pvParameters) {
+    uint32_t bits = 0;
+    while (1) {
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+
+        if (bits & PUB_NOTIFY_ACKED) _check_acked();
+
+        if (bits & PUB_NOTIFY_DRAIN) {
+            // [新增] 分批回放，每批之间让出时间给实时消息
+            int remain = 0;
+            do {
+                remain = Agent_MQTT_Outbox_Drain(s_client, MQTT_OUTBOX_DRAIN_BATCH);
+                if (remain > 0) vTaskDelay(pdMS_TO_TICKS(MQTT_OUTBOX_DRAIN_INTERVAL_MS));
+            } while (remain > 0 && s_is_connected);
+
+            Agent_MQTT_Outbox_Stats_t ob;
+            Agent_MQTT_Outbox_Get_Stats(&ob);
+            ESP_LOGI(TAG, "[Outbox] queued:%lu spilled:%lu dropped:%lu replayed:%lu pending:%u",
+                     ob.queued, ob.spilled, ob.dropped, ob.replayed, ob.pending);
+        }
+
+        if (bits & PUB_NOTIFY_SNAPSHOT) {
+            _publish_status(true);
+            ESP_LOGI(TAG, "[MQTT] req:%lu pub:%lu snap:%lu skip:%lu bytes:%lu",
+                     s_stats.requests, s_stats.publishes, s_stats.snapshots,
+                     s_stats.suppressed, s_stats.bytes);
+        } else if (bits & PUB_NOTIFY_DELTA) {
+            _publish_status(false);
+        }
+    }
+}
+
+static void _coalesce_timer_cb(TimerHandle_t xTimer) {
+    if (s_pub_task) xTaskNotify(s_pub_task, PUB_NOTIFY_DELTA, eSetBits);
+}
+
+static void _snapshot_timer_cb(TimerHandle_t xTimer) {
+    // 上次快照之后没有任何增量，retain 的快照仍然准确，无需重发
+    if (s_pub_task && s_snapshot_dirty) xTaskNotify(s_pub_task, PUB_NOTIFY_SNAPSHOT, eSetBits);
+}
+
 // ============================================================
 // 公开接口
 // ============================================================
@@ -112,8 +389,24 @@ void Agent_MQTT_Init(void) {
     esp_mqtt_client_config_t mqtt_cfg = {
         .broker.address.uri = MQTT_BROKER_URI,
         .session.keepalive = 60,
+        .buffer.size = 4096, // [新增] 批量信封可能超过默认 1KB，避免被分片
+        // [新增] 遗嘱: 异常掉线 (keepalive 超时) 时 broker 代发 offline
+        .session.last_will = {
+            .topic = MQTT_TOPIC_AVAIL,
+            .msg = AVAIL_OFFLINE_MSG,
+            .qos = 1,
+            .retain = 1,
+        },
     };
 
+    if (!s_pub_task) {
+        Agent_MQTT_Outbox_Init();
+        xTaskCreate(mqtt_pub_task, "MQTT_Pub", 3072, NULL, 4, &s_pub_task);
+        s_coalesce_timer = xTimerCreate("mqtt_coal", pdMS_TO_TICKS(MQTT_COALESCE_MS), pdFALSE, NULL, _coalesce_timer_cb);
+        s_snapshot_timer = xTimerCreate("mqtt_snap", pdMS_TO_TICKS(MQTT_SNAPSHOT_PERIOD_MS), pdTRUE, NULL, _snapshot_timer_cb);
+        xTimerStart(s_snapshot_timer, 0);
+    }
+
     s_client = esp_mqtt_client_init(&mqtt_cfg);
     esp_mqtt_client_register_event(s_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
     esp_mqtt_client_start(s_client);
@@ -129,33 +422,29 @@ void Agent_MQTT_Stop(void) {
 }
 
 void Agent_MQTT_Publish_Status(void) {
-    if (!s_client || !s_is_connected) return;
+    s_stats.requests++;
+    if (!s_coalesce_timer) return;
 
-    // 1. 获取最新数据
-    DC_LightingData_t light;
-    DC_EnvData_t env;
-    DataCenter_Get_Lighting(&light);
-    DataCenter_Get_Env(&env);
+    // 窗口从第一次变化开始计时 (不 Reset)，持续拖动滑块时也保证每个窗口至少发一次
+    if (xTimerIsTimerActive(s_coalesce_timer) == pdFALSE) {
+        xTimerStart(s_coalesce_timer, 0);
+    }
+}
 
-    // 2. 构建 JSON
-    cJSON *root = cJSON_CreateObject();
-    
-    // 灯光数据
-    cJSON_AddNumberToObject(root, "power", light.power ? 1 : 0);
-    cJSON_AddNumberToObject(root, "brightness", light.brightness);
-    cJSON_AddNumberToObject(root, "color_temp", light.color_temp);
-    
-    // 环境数据 (如果有传感器)
-    cJSON_AddNumberToObject(root, "temp", env.indoor_temp);
-    cJSON_AddNumberToObject(root, "hum", env.indoor_hum);
+void Agent_MQTT_Publish_Event(const char *json) {
+    if (!json) return;
+    int len = strlen(json);
 
-    // 3. 发送
-    char *json_str = cJSON_PrintUnformatted(root);
-    if (json_str) {
-        esp_mqtt_client_publish(s_client, MQTT_TOPIC_STATUS, json_str, 0, 1, 0);
-        free(json_str);
-        // ESP_LOGI(TAG, "Status Published"); // 调试时可打开
+    // 发件箱非空时直接发会越过排队中的旧事件，只有队列已空且在线时才直接发送
+    if (s_client && s_is_connected && Agent_MQTT_Outbox_Pending() == 0 &&
+        esp_mqtt_client_publish(s_client, MQTT_TOPIC_EVENT, json, len, 1, 0) >= 0) {
+        return;
     }
-    
-    cJSON_Delete(root);
+    // 客户端尚未初始化 / 离线 / 正在回放: 入队，连接后按顺序发出
+    Agent_MQTT_Outbox_Push(MQTT_TOPIC_EVENT, json, len, 1, 0);
+    if (s_is_connected && s_pub_task) xTaskNotify(s_pub_task, PUB_NOTIFY_DRAIN, eSetBits);
+}
+
+void Agent_MQTT_Get_Stats(Agent_MQTT_Stats_t *out) {
+    if (out) *out = s_stats;
 }
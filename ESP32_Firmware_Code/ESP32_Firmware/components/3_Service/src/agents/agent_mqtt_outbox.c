@@ -0,0 +1,331 @@
+#include "agents/agent_mqtt_outbox.h"
+#include "app_config.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "MQTT_Outbox";
+
+#define OUTBOX_NVS_NAMESPACE  "mqtt_ob"
+#define OUTBOX_NVS_LEGACY_KEY "spill"   // 旧版: 整个溢出区存为一个 blob，每次溢出 / 回放都整块重写
+#define OUTBOX_NVS_HEAD_KEY   "head"
+#define OUTBOX_NVS_TAIL_KEY   "tail"
+
+// [修改] 溢出区改为追加式: 每次溢出写一个新块 (键 "c<槽位>")，回放完整块后直接擦除该键，
+//        每条消息在 flash 上只写一次，不再反复重写整个溢出区
+// 块数固定，块大小由溢出上限均分 (与 PSRAM 队列容量无关)；只有 1 块时每次溢出都要先删掉唯一的块再重写同一个键，
+// 等于回到整块重写，所以至少 2 块
+#define OUTBOX_SPILL_CHUNKS   4
+#define OUTBOX_SPILL_CHUNK    (MQTT_OUTBOX_SPILL_MAX / OUTBOX_SPILL_CHUNKS)   // 每次溢出的条数 = 一个块
+_Static_assert(OUTBOX_SPILL_CHUNKS >= 2, "NVS spill needs at least 2 chunks to stay append-only");
+_Static_assert(OUTBOX_SPILL_CHUNK >= 1 && OUTBOX_SPILL_CHUNK <= MQTT_OUTBOX_CAPACITY,
+               "MQTT_OUTBOX_SPILL_MAX must give 1..MQTT_OUTBOX_CAPACITY msgs per chunk");
+_Static_assert(OUTBOX_SPILL_CHUNK <= 255, "chunk length is stored in uint8_t");
+
+/** @brief 队列条目 (定长，便于整块写入 NVS) */
+typedef struct {
+    const char *topic;
+    uint8_t  qos;
+    uint8_t  retain;
+    uint8_t  len;
+    char     payload[MQTT_OUTBOX_PAYLOAD_MAX];
+} OutboxEntry_t;
+
+/** @brief NVS 中保存的条目 (不能存指针，用主题索引代替) */
+typedef struct {
+    uint8_t  topic_idx;
+    uint8_t  qos;
+    uint8_t  retain;
+    uint8_t  len;
+    char     payload[MQTT_OUTBOX_PAYLOAD_MAX];
+} OutboxSpill_t;
+
+// 可能进入发件箱的主题，NVS 里只存下标
+static const char *s_topics[] = { MQTT_TOPIC_STATUS, MQTT_TOPIC_EVENT };
+#define OUTBOX_TOPIC_NUM (sizeof(s_topics) / sizeof(s_topics[0]))
+
+static OutboxEntry_t *s_ring = NULL;    // PSRAM 环形队列
+static uint16_t s_head = 0;             // 下一条待发
+static uint32_t s_head_seq = 0;         // 已从队头移出的条数 (Drain 据此判断发布期间队头是否被溢出移走)
+static uint16_t s_count = 0;
+static uint16_t s_spill_count = 0;      // NVS 中尚未回放的条数
+static uint32_t s_chunk_head = 0;       // NVS 块序号 [head, tail)，持久化在 OUTBOX_NVS_HEAD_KEY / TAIL_KEY
+static uint32_t s_chunk_tail = 0;
+static uint8_t  s_chunk_len[OUTBOX_SPILL_CHUNKS];  // 按槽位记录每块的条数
+static OutboxSpill_t *s_replay = NULL;  // 正在回放的块 (最旧的一块)
+static int s_replay_pos = -1;           // 块内下一条，-1 表示还没读入
+static SemaphoreHandle_t s_mutex = NULL;
+static Agent_MQTT_Outbox_Stats_t s_stats = {0};
+
+// ============================================================
+// NVS 溢出区
+// ============================================================
+static int _topic_to_idx(const char *topic) {
+    for (int i = 0; i < OUTBOX_TOPIC_NUM; i++) {
+        if (strcmp(topic, s_topics[i]) == 0) return i;
+    }
+    return -1;
+}
+
+static void _chunk_key(uint32_t seq, char *key, size_t size) {
+    snprintf(key, size, "c%u", (unsigned)(seq % OUTBOX_SPILL_CHUNKS));
+}
+
+/** @brief 追加一块到 NVS 尾部 (只写新键 + 4 字节的尾序号) */
+static bool _chunk_append(const OutboxSpill_t *buf, int n) {
+    nvs_handle_t h;
+    char key[8];
+    if (nvs_open(OUTBOX_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK) return false;
+    _chunk_key(s_chunk_tail, key, sizeof(key));
+    bool ok = nvs_set_blob(h, key, buf, sizeof(OutboxSpill_t) * n) == ESP_OK &&
+              nvs_set_u32(h, OUTBOX_NVS_TAIL_KEY, s_chunk_tail + 1) == ESP_OK;
+    nvs_commit(h);
+    nvs_close(h);
+    if (ok) {
+        s_chunk_len[s_chunk_tail % OUTBOX_SPILL_CHUNKS] = (uint8_t)n;
+        s_chunk_tail++;
+    }
+    return ok;
+}
+
+/** @brief 删除最旧的一块 (回放完成或 NVS 已满)，未回放的条数从计数中扣除 */
+static void _chunk_pop(void) {
+    nvs_handle_t h;
+    char key[8];
+    int left = s_chunk_len[s_chunk_head % OUTBOX_SPILL_CHUNKS] - (s_replay_pos > 0 ? s_replay_pos : 0);
+    if (nvs_open(OUTBOX_NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) {
+        _chunk_key(s_chunk_head, key, sizeof(key));
+        nvs_erase_key(h, key);
+        nvs_set_u32(h, OUTBOX_NVS_HEAD_KEY, s_chunk_head + 1);
+        nvs_commit(h);
+        nvs_close(h);
+    }
+    s_chunk_len[s_chunk_head % OUTBOX_SPILL_CHUNKS] = 0;
+    s_chunk_head++;
+    s_spill_count -= left;
+    s_replay_pos = -1;
+}
+
+/** @brief 把最旧的一块读入回放缓冲区，返回条数 (读不出时丢弃该块，返回 0) */
+static int _chunk_load(void) {
+    nvs_handle_t h;
+    char key[8];
+    size_t size = sizeof(OutboxSpill_t) * OUTBOX_SPILL_CHUNK;
+    esp_err_t err = ESP_FAIL;
+    if (nvs_open(OUTBOX_NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) {
+        _chunk_key(s_chunk_head, key, sizeof(key));
+        err = nvs_get_blob(h, key, s_replay, &size);
+        nvs_close(h);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS chunk %u unreadable (%d), dropped", (unsigned)s_chunk_head, err);
+        s_stats.dropped += s_chunk_len[s_chunk_head % OUTBOX_SPILL_CHUNKS];
+        _chunk_pop();
+        return 0;
+    }
+    int n = size / sizeof(OutboxSpill_t);
+    uint8_t *len = &s_chunk_len[s_chunk_head % OUTBOX_SPILL_CHUNKS];
+    s_spill_count = s_spill_count - *len + n;
+    *len = (uint8_t)n;
+    s_replay_pos = 0;
+    if (n == 0) _chunk_pop();
+    return n;
+}
+
+/** @brief 启动时恢复块序号与条数；旧版整块 blob 按块迁移后删除 */
+static void _spill_restore(void) {
+    nvs_handle_t h;
+    if (nvs_open(OUTBOX_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK) return;
+    nvs_get_u32(h, OUTBOX_NVS_HEAD_KEY, &s_chunk_head);
+    nvs_get_u32(h, OUTBOX_NVS_TAIL_KEY, &s_chunk_tail);
+    if (s_chunk_tail - s_chunk_head > OUTBOX_SPILL_CHUNKS) {
+        ESP_LOGW(TAG, "NVS chunk index corrupt (head %u tail %u), reset",
+                 (unsigned)s_chunk_head, (unsigned)s_chunk_tail);
+        s_chunk_head = s_chunk_tail;
+    }
+    for (uint32_t seq = s_chunk_head; seq != s_chunk_tail; seq++) {
+        char key[8];
+        size_t size = 0;
+        _chunk_key(seq, key, sizeof(key));
+        if (nvs_get_blob(h, key, NULL, &size) != ESP_OK) size = 0;
+        s_chunk_len[seq % OUTBOX_SPILL_CHUNKS] = size / sizeof(OutboxSpill_t);
+        s_spill_count += size / sizeof(OutboxSpill_t);
+    }
+
+    size_t size = 0;
+    if (nvs_get_blob(h, OUTBOX_NVS_LEGACY_KEY, NULL, &size) == ESP_OK) {
+        OutboxSpill_t *buf = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (buf && nvs_get_blob(h, OUTBOX_NVS_LEGACY_KEY, buf, &size) == ESP_OK) {
+            int n = size / sizeof(OutboxSpill_t);
+            for (int i = 0; i < n && s_chunk_tail - s_chunk_head < OUTBOX_SPILL_CHUNKS; i += OUTBOX_SPILL_CHUNK) {
+                int m = (n - i < OUTBOX_SPILL_CHUNK) ? n - i : OUTBOX_SPILL_CHUNK;
+                if (_chunk_append(&buf[i], m)) s_spill_count += m;
+            }
+            ESP_LOGI(TAG, "Migrated %d msgs from legacy NVS blob", n);
+        }
+        free(buf);
+        nvs_erase_key(h, OUTBOX_NVS_LEGACY_KEY);
+        nvs_commit(h);
+    }
+    nvs_close(h);
+}
+
+/** @brief PSRAM 队列满: 把最旧的 OUTBOX_SPILL_CHUNK 条作为一个新块追加到 NVS (持锁调用) */
+static void _spill_oldest_chunk(void) {
+    OutboxSpill_t *buf = heap_caps_malloc(sizeof(OutboxSpill_t) * OUTBOX_SPILL_CHUNK,
+                                          MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) {
+        // 没内存做溢出，只能丢最旧的一条
+        s_head = (s_head + 1) % MQTT_OUTBOX_CAPACITY;
+        s_head_seq++;
+        s_count--;
+        s_stats.dropped++;
+        return;
+    }
+
+    if (s_chunk_tail - s_chunk_head == OUTBOX_SPILL_CHUNKS) {
+        // NVS 也满: 丢弃 NVS 中最旧的一块
+        s_stats.dropped += s_chunk_len[s_chunk_head % OUTBOX_SPILL_CHUNKS] - (s_replay_pos > 0 ? s_replay_pos : 0);
+        _chunk_pop();
+    }
+
+    for (int i = 0; i < OUTBOX_SPILL_CHUNK; i++) {
+        const OutboxEntry_t *e = &s_ring[(s_head + i) % MQTT_OUTBOX_CAPACITY];
+        buf[i].topic_idx = (uint8_t)_topic_to_idx(e->topic);
+        buf[i].qos = e->qos;
+        buf[i].retain = e->retain;
+        buf[i].len = e->len;
+        memcpy(buf[i].payload, e->payload, e->len);
+    }
+
+    if (_chunk_append(buf, OUTBOX_SPILL_CHUNK)) {
+        s_spill_count += OUTBOX_SPILL_CHUNK;
+        s_stats.spilled += OUTBOX_SPILL_CHUNK;
+        ESP_LOGW(TAG, "RAM outbox full, spilled %d msgs to NVS (NVS holds %d)", OUTBOX_SPILL_CHUNK, s_spill_count);
+    } else {
+        s_stats.dropped += OUTBOX_SPILL_CHUNK;
+        ESP_LOGE(TAG, "NVS spill failed, dropped %d msgs", OUTBOX_SPILL_CHUNK);
+    }
+    s_head = (s_head + OUTBOX_SPILL_CHUNK) % MQTT_OUTBOX_CAPACITY;
+    s_head_seq += OUTBOX_SPILL_CHUNK;
+    s_count -= OUTBOX_SPILL_CHUNK;
+    free(buf);
+}
+
+// ============================================================
+// 对外接口
+// ============================================================
+void Agent_MQTT_Outbox_Init(void) {
+    if (s_ring) return;
+    s_mutex = xSemaphoreCreateMutex();
+    s_ring = heap_caps_calloc(MQTT_OUTBOX_CAPACITY, sizeof(OutboxEntry_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    s_replay = heap_caps_malloc(sizeof(OutboxSpill_t) * OUTBOX_SPILL_CHUNK, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!s_ring || !s_replay) {
+        ESP_LOGE(TAG, "PSRAM Malloc Failed!");
+        free(s_ring);
+        free(s_replay);
+        s_ring = NULL;
+        s_replay = NULL;
+        return;
+    }
+
+    _spill_restore();
+    if (s_spill_count) ESP_LOGI(TAG, "%d msgs left in NVS from last session", s_spill_count);
+}
+
+bool Agent_MQTT_Outbox_Push(const char *topic, const char *payload, int len, int qos, int retain) {
+    if (!s_ring || _topic_to_idx(topic) < 0 || len <= 0 || len > MQTT_OUTBOX_PAYLOAD_MAX) {
+        s_stats.dropped++;
+        return false;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (s_count == MQTT_OUTBOX_CAPACITY) _spill_oldest_chunk();
+
+    OutboxEntry_t *e = &s_ring[(s_head + s_count) % MQTT_OUTBOX_CAPACITY];
+    e->topic = topic;
+    e->qos = (uint8_t)qos;
+    e->retain = (uint8_t)retain;
+    e->len = (uint8_t)len;
+    memcpy(e->payload, payload, len);
+    s_count++;
+    s_stats.queued++;
+    xSemaphoreGive(s_mutex);
+    return true;
+}
+
+int Agent_MQTT_Outbox_Drain(esp_mqtt_client_handle_t client, int max_msgs) {
+    if (!s_ring || !client) return 0;
+    int sent = 0;
+    OutboxSpill_t msg;      // 当前条目的副本: 发布时不持锁，其他任务的 Push 不会被整段回放阻塞
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    while (sent < max_msgs) {
+        // 1. 先发 NVS 中更旧的消息 (逐块读入，整块发完才擦除；掉电时未擦除的块重启后整块重发，与 QoS 1 语义一致)
+        // 2. 再发 PSRAM 队列 (NVS 没发完时不发，保证顺序)
+        bool from_nvs = s_spill_count > 0;
+        const char *topic;
+        uint32_t mark;
+        int pos = 0;
+
+        if (from_nvs) {
+            int n = s_replay_pos < 0 ? _chunk_load() : s_chunk_len[s_chunk_head % OUTBOX_SPILL_CHUNKS];
+            if (n == 0) continue;
+            msg = s_replay[s_replay_pos];
+            topic = msg.topic_idx < OUTBOX_TOPIC_NUM ? s_topics[msg.topic_idx] : NULL;
+            mark = s_chunk_head;
+            pos = s_replay_pos;
+        } else if (s_count > 0) {
+            const OutboxEntry_t *e = &s_ring[s_head];
+            topic = e->topic;
+            msg.qos = e->qos;
+            msg.retain = e->retain;
+            msg.len = e->len;
+            memcpy(msg.payload, e->payload, e->len);
+            mark = s_head_seq;
+        } else {
+            break;
+        }
+
+        xSemaphoreGive(s_mutex);
+        bool ok = !topic || esp_mqtt_client_publish(client, topic, msg.payload, msg.len, msg.qos, msg.retain) >= 0;
+        xSemaphoreTake(s_mutex, portMAX_DELAY);
+        if (!ok) break;
+        sent++;
+
+        // 发布期间 Push 可能已把这条溢出到 NVS、或把它所在的块当作最旧块丢弃: 位置变了就不再推进
+        // (溢出的那份之后会再发一次，与 QoS 1 至少一次的语义一致)
+        if (from_nvs) {
+            if (mark != s_chunk_head || pos != s_replay_pos) continue;
+            s_replay_pos++;
+            s_spill_count--;
+            s_stats.replayed++;
+            if (s_replay_pos >= s_chunk_len[s_chunk_head % OUTBOX_SPILL_CHUNKS]) _chunk_pop();
+        } else {
+            if (mark != s_head_seq) continue;
+            s_head = (s_head + 1) % MQTT_OUTBOX_CAPACITY;
+            s_head_seq++;
+            s_count--;
+            s_stats.replayed++;
+        }
+    }
+
+    int remain = s_count + s_spill_count;
+    xSemaphoreGive(s_mutex);
+    return remain;
+}
+
+int Agent_MQTT_Outbox_Pending(void) {
+    return s_count + s_spill_count;
+}
+
+void Agent_MQTT_Outbox_Get_Stats(Agent_MQTT_Outbox_Stats_t *out) {
+    if (!out) return;
+    *out = s_stats;
+    out->pending = s_count + s_spill_count;
+}
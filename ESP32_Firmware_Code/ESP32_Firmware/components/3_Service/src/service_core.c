@@ -1,4 +1,6 @@
 #include "service_core.h"
+#include <stdlib.h>
+#include <string.h>
 #include "event_bus.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -7,6 +9,8 @@
 #include "agents/agent_lampmind.h" 
 #include "agents/agent_baidu_tts.h" // [新增] 引入 TTS
 #include "svc_lighting.h" 
+#include "svc_intent.h" // [新增] 本地离线意图
+#include "svc_wakeword.h" // [新增] 语音唤醒
 #include "agents/agent_mqtt.h" 
 
 static const char *TAG = "Svc_Core";
@@ -31,9 +35,11 @@ static void tts_play_task(void *pvParameters) {
 static void _handle_state_idle(SystemEvent_t *evt) {
     switch (evt->type) {
         case EVT_KEY_CLICK:
-            ESP_LOGI(TAG, "[IDLE] Key Click -> Switch to LISTENING");
+        case EVT_AUDIO_WAKEUP: // [新增] 唤醒词与按键单击走同一流程
+            ESP_LOGI(TAG, "[IDLE] %s -> Switch to LISTENING", evt->type == EVT_KEY_CLICK ? "Key Click" : "Wake Word");
             s_current_state = SYS_STATE_LISTENING;
             EventBus_Send(EVT_SYS_STATE_CHANGE, (void*)SYS_STATE_LISTENING, 0);
+            Svc_WakeWord_Pause(); // 等唤醒词任务让出麦克风后再开始录音，两者不会交替读取同一个 I2S 流
             xTaskCreate((TaskFunction_t)Agent_ASR_Run_Session, "ASR_Task", 8192, (void*)5000, 5, NULL);
             break;
         case EVT_NET_CONNECTED:
@@ -52,7 +58,15 @@ static void _handle_state_listening(SystemEvent_t *evt) {
                 ESP_LOGI(TAG, "[LISTENING] ASR Result: %s", (char*)evt->data);
                 s_current_state = SYS_STATE_PROCESSING;
                 EventBus_Send(EVT_SYS_STATE_CHANGE, (void*)SYS_STATE_PROCESSING, 0);
-                xTaskCreate(Agent_LampMind_Chat_Task, "LampMind_Task", 8192, evt->data, 5, NULL);
+
+                // [新增] 先走本地语法：灯光/定时类指令直接执行，回复文本伪装成 LLM_RESULT 进入播报流程
+                char *reply = NULL;
+                if (Svc_Intent_Process((char*)evt->data, &reply)) {
+                    free(evt->data);
+                    EventBus_Send(EVT_LLM_RESULT, reply, reply ? strlen(reply) : 0);
+                } else {
+                    xTaskCreate(Agent_LampMind_Chat_Task, "LampMind_Task", 8192, evt->data, 5, NULL);
+                }
             } else {
                 ESP_LOGW(TAG, "[LISTENING] ASR Empty -> Back to IDLE");
                 s_current_state = SYS_STATE_IDLE;
@@ -117,6 +131,9 @@ void Service_Core_Task(void *pvParameters) {
                 Agent_MQTT_Publish_Status();
             } else if (evt.type == EVT_NET_CONNECTED) {
                 Agent_MQTT_Init();
+            } else if (evt.type == EVT_SYS_STATE_CHANGE) {
+                // [新增] 只在 IDLE 时监听唤醒词：录音时把麦克风让给 ASR，播报时避免回声误唤醒
+                Svc_WakeWord_Set_Enable((SystemState_t)(intptr_t)evt.data == SYS_STATE_IDLE);
             }
             
             // --- 状态机事件 ---
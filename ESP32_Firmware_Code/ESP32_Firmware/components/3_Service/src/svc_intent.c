@@ -0,0 +1,325 @@
+#include "svc_intent.h"
+#include "data_center.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *TAG = "Svc_Intent";
+
+// ============================================================
+// 1. 语法配置
+// ============================================================
+#define INTENT_MAX_TEXT_LEN   64    // 超过此长度 (约 20 个汉字) 视为开放式对话，直接交给 LampMind
+#define INTENT_BRI_STEP       20    // "亮一点/暗一点" 步进 (%)
+#define INTENT_CCT_STEP       20    // "暖一点/冷一点" 步进 (%)
+#define INTENT_BRI_MIN_LEVEL  5     // "最暗" 对应亮度 (%)，不直接关灯
+#define INTENT_TIMER_MAX_SEC  (12 * 3600)
+
+/** @brief 槽位类型: 命中关键词后，从关键词之后的文本中解析数值 */
+typedef enum {
+    SLOT_NONE = 0,
+    SLOT_PERCENT,   // 0-100
+    SLOT_DURATION,  // 时长 -> 秒
+} IntentSlot_t;
+
+/** @brief 一条语法规则 (静态表，编译期确定，按顺序匹配，先命中者优先) */
+typedef struct {
+    SvcIntent_Type_t type;
+    IntentSlot_t     slot;
+    const char      *keywords[8]; // 任意一个命中即可，NULL 结尾
+} IntentRule_t;
+
+// 注意顺序: 带槽位的/更具体的规则放前面，避免 "十分钟后关灯" 被 "关灯" 抢先命中，
+// "太亮了" 被 "亮" 类规则误判
+static const IntentRule_t s_rules[] = {
+    { INTENT_TIMER_CANCEL, SLOT_NONE,     { "取消定时", "关闭定时", "关掉定时", "不用定时", NULL } },
+    { INTENT_TIMER_SET,    SLOT_DURATION, { "定时", "后关", "以后关", NULL } },
+    { INTENT_BRI_SET,      SLOT_PERCENT,  { "亮度", NULL } },
+    { INTENT_CCT_SET,      SLOT_PERCENT,  { "色温", NULL } },
+    { INTENT_BRI_MAX,      SLOT_NONE,     { "最亮", "全亮", "亮度最大", NULL } },
+    { INTENT_BRI_MIN,      SLOT_NONE,     { "最暗", "亮度最小", NULL } },
+    { INTENT_BRI_DOWN,     SLOT_NONE,     { "太亮", "暗一点", "暗一些", "调暗", "暗点", "刺眼", "亮度调低", "调低亮度" } },
+    { INTENT_BRI_UP,       SLOT_NONE,     { "太暗", "亮一点", "亮一些", "调亮", "亮点", "看不清", "亮度调高", "调高亮度" } },
+    { INTENT_CCT_WARM,     SLOT_NONE,     { "暖一点", "调暖", "暖光", "黄一点", "太白", "太冷" } },
+    { INTENT_CCT_COOL,     SLOT_NONE,     { "冷一点", "调冷", "冷光", "白一点", "白光", "太黄" } },
+    { INTENT_POWER_OFF,    SLOT_NONE,     { "关灯", "关闭台灯", "关掉", "把灯关", "熄灯", "关闭灯" } },
+    { INTENT_POWER_ON,     SLOT_NONE,     { "开灯", "打开台灯", "打开灯", "把灯打开", "亮灯", "开台灯" } },
+};
+#define INTENT_RULE_NUM (sizeof(s_rules) / sizeof(s_rules[0]))
+
+// 含有这些词的句子是在"提问"而不是"下指令"，交给 LampMind
+static const char *s_question_words[] = { "吗", "为什么", "怎么", "什么", "多少", "是不是" };
+#define INTENT_QWORD_NUM (sizeof(s_question_words) / sizeof(s_question_words[0]))
+
+// ============================================================
+// 2. 数值解析 (阿拉伯数字 / 中文数字)
+// ============================================================
+static const char *s_cn_digits[] = { "零", "一", "二", "三", "四", "五", "六", "七", "八", "九" };
+
+static int _cn_digit(const char *p) {
+    for (int i = 0; i < 10; i++) {
+        if (strncmp(p, s_cn_digits[i], 3) == 0) return i;
+    }
+    if (strncmp(p, "两", 3) == 0) return 2;
+    return -1;
+}
+
+/**
+ * @brief 从 p 开始解析一个数字 (支持 "85" / "八十五" / "一百" / "十")
+ * @return 解析到的字节数，0 表示不是数字
+ */
+static int _parse_number(const char *p, int32_t *val) {
+    const char *s = p;
+    int32_t num = 0;
+
+    if (*s >= '0' && *s <= '9') {
+        while (*s >= '0' && *s <= '9') {
+            num = num * 10 + (*s - '0');
+            if (num > 100000) break;
+            s++;
+        }
+        *val = num;
+        return (int)(s - p);
+    }
+
+    int32_t section = 0; // 当前还未乘单位的数字
+    bool found = false;
+    while (*s) {
+        int d = _cn_digit(s);
+        if (d >= 0) {
+            section = d;
+            found = true;
+            s += 3;
+        } else if (strncmp(s, "十", 3) == 0) {
+            num += (found && section ? section : 1) * 10; // "十五" 省略了 "一"
+            section = 0;
+            found = true;
+            s += 3;
+        } else if (strncmp(s, "百", 3) == 0) {
+            num += (section ? section : 1) * 100;
+            section = 0;
+            found = true;
+            s += 3;
+        } else {
+            break;
+        }
+    }
+    if (!found) return 0;
+    *val = num + section;
+    return (int)(s - p);
+}
+
+/** @brief 在 p 之后查找百分比数值 ("百分之五十" / "50%" / "调到80") */
+static bool _parse_percent(const char *p, int32_t *val) {
+    for (; *p; p++) {
+        if (strncmp(p, "百分之", 9) == 0) {
+            p += 9;
+            if (*p == '\0') break; // "百分之" 在句尾，没有数值 (不能再 p++ 越过结尾)
+        }
+        int n = _parse_number(p, val);
+        if (n > 0) {
+            // "调高一点" / "暗一些" 里的 "一" 是程度副词，不是数值
+            if (strncmp(p + n, "点", 3) == 0 || strncmp(p + n, "些", 3) == 0) return false;
+            if (*val > 100) *val = 100;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief 在整句中查找时长 ("十分钟" / "1个小时" / "半小时" / "30秒") -> 秒 */
+static bool _parse_duration(const char *text, int32_t *sec) {
+    if (strstr(text, "半小时") || strstr(text, "半个小时")) {
+        *sec = 30 * 60;
+        return true;
+    }
+    for (const char *p = text; *p; p++) {
+        int32_t num = 0;
+        int n = _parse_number(p, &num);
+        if (n == 0) continue;
+        const char *u = p + n;
+        if (strncmp(u, "个", 3) == 0) u += 3;
+        if (strncmp(u, "小时", 6) == 0)      *sec = num * 3600;
+        else if (strncmp(u, "分", 3) == 0)   *sec = num * 60;
+        else if (strncmp(u, "秒", 3) == 0)   *sec = num;
+        else { p += n - 1; continue; }
+        if (*sec <= 0) return false;
+        if (*sec > INTENT_TIMER_MAX_SEC) *sec = INTENT_TIMER_MAX_SEC;
+        return true;
+    }
+    return false;
+}
+
+// ============================================================
+// 3. 匹配
+// ============================================================
+bool Svc_Intent_Match(const char *text, SvcIntent_Result_t *out) {
+    if (!text || !out) return false;
+    out->type = INTENT_NONE;
+    out->value = 0;
+
+    if (strlen(text) > INTENT_MAX_TEXT_LEN) return false;
+    for (size_t i = 0; i < INTENT_QWORD_NUM; i++) {
+        if (strstr(text, s_question_words[i])) return false;
+    }
+
+    for (size_t r = 0; r < INTENT_RULE_NUM; r++) {
+        const IntentRule_t *rule = &s_rules[r];
+        for (int k = 0; k < 8 && rule->keywords[k]; k++) {
+            const char *hit = strstr(text, rule->keywords[k]);
+            if (!hit) continue;
+
+            int32_t val = 0;
+            if (rule->slot == SLOT_PERCENT) {
+                if (!_parse_percent(hit + strlen(rule->keywords[k]), &val)) continue;
+            } else if (rule->slot == SLOT_DURATION) {
+                if (!_parse_duration(text, &val)) continue;
+            }
+            out->type = rule->type;
+            out->value = val;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================
+// 4. 定时关灯 (1 Hz 倒计时，写入 DataCenter 的 timer 域)
+// ============================================================
+static esp_timer_handle_t s_countdown_timer = NULL;
+
+static void _countdown_cb(void *arg) {
+    DC_TimerData_t timer;
+    DataCenter_Get_Timer(&timer);
+    if (timer.state != TIMER_RUNNING) {
+        esp_timer_stop(s_countdown_timer);
+        return;
+    }
+    if (timer.remain_sec > 0) timer.remain_sec--;
+    if (timer.remain_sec == 0) {
+        timer.state = TIMER_IDLE;
+        esp_timer_stop(s_countdown_timer);
+
+        DC_LightingData_t light;
+        DataCenter_Get_Lighting(&light);
+        light.power = false;
+        DataCenter_Set_Lighting(&light);
+        ESP_LOGI(TAG, "Timer expired -> Light OFF");
+    }
+    DataCenter_Set_Timer(&timer);
+}
+
+static void _timer_start(uint32_t sec) {
+    if (!s_countdown_timer) {
+        const esp_timer_create_args_t args = {
+            .callback = _countdown_cb,
+            .name = "intent_timer",
+        };
+        if (esp_timer_create(&args, &s_countdown_timer) != ESP_OK) return;
+    }
+    esp_timer_stop(s_countdown_timer); // 未运行时返回错误，忽略即可
+
+    DC_TimerData_t timer = { .state = TIMER_RUNNING, .remain_sec = sec, .total_sec = sec };
+    DataCenter_Set_Timer(&timer);
+    esp_timer_start_periodic(s_countdown_timer, 1000 * 1000);
+}
+
+static void _timer_cancel(void) {
+    if (s_countdown_timer) esp_timer_stop(s_countdown_timer);
+    DC_TimerData_t timer = { .state = TIMER_IDLE, .remain_sec = 0, .total_sec = 0 };
+    DataCenter_Set_Timer(&timer);
+}
+
+// ============================================================
+// 5. 执行
+// ============================================================
+static int _clamp_pct(int v) {
+    if (v < 0) return 0;
+    if (v > 100) return 100;
+    return v;
+}
+
+bool Svc_Intent_Process(const char *text, char **out_reply) {
+    SvcIntent_Result_t res;
+
+    int64_t t_start = esp_timer_get_time();
+    bool matched = Svc_Intent_Match(text, &res);
+    int64_t t_cost = esp_timer_get_time() - t_start;
+
+    if (!matched) {
+        ESP_LOGI(TAG, "No local intent (%lld us) -> LampMind", t_cost);
+        return false;
+    }
+    ESP_LOGI(TAG, "[TIMING] Intent: Local Match (type=%d, val=%ld, %lld us)",
+             res.type, (long)res.value, t_cost);
+
+    DC_LightingData_t light;
+    DataCenter_Get_Lighting(&light);
+    char reply[64];
+
+    switch (res.type) {
+        case INTENT_POWER_ON:
+            light.power = true;
+            snprintf(reply, sizeof(reply), "好的，已开灯");
+            break;
+        case INTENT_POWER_OFF:
+            light.power = false;
+            snprintf(reply, sizeof(reply), "好的，已关灯");
+            break;
+        case INTENT_BRI_SET:
+            light.power = (res.value > 0);
+            if (res.value > 0) light.brightness = (uint8_t)res.value;
+            snprintf(reply, sizeof(reply), "亮度已调到百分之%ld", (long)res.value);
+            break;
+        case INTENT_BRI_UP:
+            light.power = true;
+            light.brightness = _clamp_pct(light.brightness + INTENT_BRI_STEP);
+            snprintf(reply, sizeof(reply), "好的，亮一点");
+            break;
+        case INTENT_BRI_DOWN:
+            light.brightness = _clamp_pct(light.brightness - INTENT_BRI_STEP);
+            if (light.brightness < INTENT_BRI_MIN_LEVEL) light.brightness = INTENT_BRI_MIN_LEVEL;
+            snprintf(reply, sizeof(reply), "好的，暗一点");
+            break;
+        case INTENT_BRI_MAX:
+            light.power = true;
+            light.brightness = 100;
+            snprintf(reply, sizeof(reply), "已调到最亮");
+            break;
+        case INTENT_BRI_MIN:
+            light.power = true;
+            light.brightness = INTENT_BRI_MIN_LEVEL;
+            snprintf(reply, sizeof(reply), "已调到最暗");
+            break;
+        case INTENT_CCT_SET:
+            light.color_temp = (uint8_t)res.value;
+            snprintf(reply, sizeof(reply), "色温已调到百分之%ld", (long)res.value);
+            break;
+        case INTENT_CCT_WARM:
+            light.color_temp = _clamp_pct(light.color_temp - INTENT_CCT_STEP);
+            snprintf(reply, sizeof(reply), "好的，暖一点");
+            break;
+        case INTENT_CCT_COOL:
+            light.color_temp = _clamp_pct(light.color_temp + INTENT_CCT_STEP);
+            snprintf(reply, sizeof(reply), "好的，冷一点");
+            break;
+        case INTENT_TIMER_SET:
+            _timer_start((uint32_t)res.value);
+            if (res.value >= 60) snprintf(reply, sizeof(reply), "好的，%ld分钟后关灯", (long)(res.value / 60));
+            else snprintf(reply, sizeof(reply), "好的，%ld秒后关灯", (long)res.value);
+            break;
+        case INTENT_TIMER_CANCEL:
+            _timer_cancel();
+            snprintf(reply, sizeof(reply), "定时已取消");
+            break;
+        default:
+            return false;
+    }
+
+    DataCenter_Set_Lighting(&light); // 内部 memcmp 去重，定时类指令不会误触发灯光事件
+
+    if (out_reply) *out_reply = strdup(reply);
+    return true;
+}
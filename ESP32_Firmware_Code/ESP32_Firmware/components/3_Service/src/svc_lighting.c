@@ -2,28 +2,28 @@
 #include "data_center.h"
 #include "dev_stm32.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 static const char *TAG = "Svc_Light";
 
-// [新增] 缓存上次下发的 PWM 值，用于去重
-static uint16_t s_last_warm = 0xFFFF;
-static uint16_t s_last_cold = 0xFFFF;
+// [新增] 渐变参数: 单次变化 (开关、语音、MQTT) 用较长的缓入缓出；
+// 连续拖动滑块时每帧间隔约 50ms，用匀速渐变填满到下一帧的间隔，STM32 输出连续
+#define SVC_LIGHT_FADE_MS       300
+#define SVC_LIGHT_DRAG_GAP_MS   200
+#define SVC_LIGHT_DRAG_MIN_MS   50
+
+// [新增] 缓存上次下发的亮度 / 色温 (0-1000)，用于去重
+static uint16_t s_last_bri = 0xFFFF;
+static uint16_t s_last_cct = 0xFFFF;
+static int64_t s_last_send_us = 0;
 
 void Svc_Lighting_Apply(void) {
     DC_LightingData_t light;
     DataCenter_Get_Lighting(&light);
 
-    uint16_t warm_pwm = 0;
-    uint16_t cold_pwm = 0;
-
-    if (light.power) {
-        uint16_t total_pwm = light.brightness * 10; 
-        cold_pwm = (total_pwm * light.color_temp) / 100;
-        warm_pwm = total_pwm - cold_pwm;
-    } else {
-        warm_pwm = 0;
-        cold_pwm = 0;
-    }
+    // 关灯时只把亮度渐变到 0，色温保持，再次打开时颜色不变
+    uint16_t bri = light.power ? light.brightness * 10 : 0;
+    uint16_t cct = light.color_temp * 10;
 
     // [新增] 检查是否与上次下发的一致
     // 注意：这里有一个潜在问题。如果 STM32 本地改了 (比如手势)，上报了新值，
@@ -38,17 +38,28 @@ void Svc_Lighting_Apply(void) {
     // STM32 收到 500/500，发现和当前一样，不动作。这是安全的。
     
     // 为了减少串口流量，我们还是加一个简单的过滤：
-    if (warm_pwm == s_last_warm && cold_pwm == s_last_cold) {
+    if (bri == s_last_bri && cct == s_last_cct) {
         // ESP_LOGD(TAG, "Light state unchanged, skip sending.");
         return;
     }
 
-    ESP_LOGI(TAG, "Apply Light -> Power:%d, Bri:%d, CCT:%d => Warm:%d, Cold:%d", 
-             light.power, light.brightness, light.color_temp, warm_pwm, cold_pwm);
+    // [新增] 一帧 fade 代替逐帧 light，过渡由 STM32 本地完成
+    int64_t now = esp_timer_get_time();
+    int64_t gap_ms = (now - s_last_send_us) / 1000;
+    uint16_t ms = SVC_LIGHT_FADE_MS;
+    uint8_t ease = 3;   // 缓入缓出
+    if (gap_ms < SVC_LIGHT_DRAG_GAP_MS) {
+        ms = (gap_ms < SVC_LIGHT_DRAG_MIN_MS) ? SVC_LIGHT_DRAG_MIN_MS : (uint16_t)gap_ms;
+        ease = 0;       // 匀速，相邻两段首尾衔接
+    }
+
+    ESP_LOGI(TAG, "Apply Light -> Power:%d, Bri:%d, CCT:%d => Fade %d/%d in %dms", 
+             light.power, light.brightness, light.color_temp, bri, cct, ms);
 
-    Dev_STM32_Set_Light(warm_pwm, cold_pwm);
+    Dev_STM32_Fade_Light(bri, cct, ms, ease);
     
     // 更新缓存
-    s_last_warm = warm_pwm;
-    s_last_cold = cold_pwm;
+    s_last_bri = bri;
+    s_last_cct = cct;
+    s_last_send_us = now;
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "svc_wakeword.h"
+#include "dev_audio.h"
+#include "event_bus.h"
+#include "app_config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_wn_iface.h"
+#include "esp_wn_models.h"
+#include "model_path.h"
+#include <stdlib.h>
+
+static const char *TAG = "Svc_KWS";
+
+static const esp_wn_iface_t *s_wakenet = NULL;
+static model_iface_data_t *s_model = NULL;
+static volatile bool s_enabled = true;
+static SvcWakeWord_Stats_t s_stats = {0};
+static TaskHandle_t s_task = NULL;
+static SemaphoreHandle_t s_mic_lock = NULL; // KWS 每次读取麦克风期间持有，Pause 借此确认读取已结束
+
+// 负载统计: detect() 累计耗时 / 期间音频时长
+static int64_t s_busy_us = 0;
+static int64_t s_audio_us = 0;
+static int64_t s_audio_us_total = 0;
+
+// ============================================================
+// 单帧处理 (监听任务与主机端 WAV 回放共用)
+// ============================================================
+/**
+ * @brief 处理一帧 I2S 原始数据: 32bit -> 16bit、WakeNet detect、负载统计
+ * @note  主机端评估程序 (Thesis_Data_Analysis/host/kws_host.c) 直接调用本函数回放 WAV，
+ *        与板上走同一条转换与统计路径
+ */
+static wakenet_state_t _process_frame(const int32_t *raw_buf, int16_t *pcm_buf, int chunk) {
+    // 32bit -> 16bit (与 ASR 录音相同的移位增益)
+    for (int i = 0; i < chunk; i++) {
+        int32_t val = raw_buf[i] >> 14;
+        if (val > 32767) val = 32767;
+        if (val < -32768) val = -32768;
+        pcm_buf[i] = (int16_t)val;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    wakenet_state_t state = s_wakenet->detect(s_model, pcm_buf);
+    s_busy_us += esp_timer_get_time() - t0;
+    s_audio_us += (int64_t)chunk * 1000000 / AUDIO_SAMPLE_RATE;
+
+    if (s_audio_us >= (int64_t)KWS_STATS_PERIOD_MS * 1000) {
+        s_audio_us_total += s_audio_us;
+        s_stats.audio_sec = (uint32_t)(s_audio_us_total / 1000000);
+        s_stats.cpu_load_pct = (uint8_t)(s_busy_us * 100 / s_audio_us);
+        // 误唤醒率: 在无人说唤醒词的环境下长时间运行，detections / 小时 即 FA/h
+        ESP_LOGI(TAG, "[KWS] CPU load: %u%% | Detections: %lu in %lu s",
+                 s_stats.cpu_load_pct, s_stats.detections, s_stats.audio_sec);
+        s_busy_us = 0;
+        s_audio_us = 0;
+    }
+    return state;
+}
+
+// ============================================================
+// 监听任务 (Core 1)
+// ============================================================
+static void wakeword_task(void *pvParameters) {
+    int chunk = s_wakenet->get_samp_chunksize(s_model); // WakeNet 每帧采样点数 (16k, 16bit)
+    int32_t *raw_buf = malloc(chunk * sizeof(int32_t));
+    int16_t *pcm_buf = malloc(chunk * sizeof(int16_t));
+    if (!raw_buf || !pcm_buf) {
+        ESP_LOGE(TAG, "Malloc Failed!");
+        free(raw_buf);
+        free(pcm_buf);
+        vTaskDelete(NULL);
+        return;
+    }
+
+    while (1) {
+        if (!s_enabled) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // 暂停期间不读麦克风，等 Set_Enable(true) 唤醒
+            continue;
+        }
+
+        // 持锁读取一帧; 拿到锁后再检查一次，Pause 之后不会再开始新的读取
+        size_t bytes_read = 0;
+        xSemaphoreTake(s_mic_lock, portMAX_DELAY);
+        if (s_enabled) {
+            Dev_Audio_Read(raw_buf, chunk * sizeof(int32_t), &bytes_read);
+        }
+        xSemaphoreGive(s_mic_lock);
+        if (bytes_read < chunk * sizeof(int32_t)) continue;
+
+        if (_process_frame(raw_buf, pcm_buf, chunk) == WAKENET_DETECTED && s_enabled) {
+            s_stats.detections++;
+            ESP_LOGI(TAG, "Wake word detected (total %lu)", s_stats.detections);
+            if (EventBus_Send(EVT_AUDIO_WAKEUP, NULL, 0) == ESP_OK) {
+                s_enabled = false; // 等状态机回到 IDLE 再重新打开
+            }
+        }
+    }
+}
+
+// ============================================================
+// 对外接口
+// ============================================================
+void Svc_WakeWord_Init(void) {
+#if (KWS_ENABLE == 1)
+    srmodel_list_t *models = esp_srmodel_init("model"); // 模型存放在 partitions.csv 的 model 分区
+    char *wn_name = esp_srmodel_filter(models, ESP_WN_PREFIX, NULL);
+    if (!wn_name) {
+        ESP_LOGE(TAG, "No WakeNet model found in 'model' partition");
+        return;
+    }
+
+    s_wakenet = esp_wn_handle_from_name(wn_name);
+    s_model = s_wakenet->create(wn_name, KWS_DET_MODE);
+    if (!s_model) {
+        ESP_LOGE(TAG, "WakeNet create failed: %s", wn_name);
+        return;
+    }
+    ESP_LOGI(TAG, "WakeNet ready: %s (word: %s)", wn_name, s_wakenet->get_word_name(s_model, 1));
+
+    s_mic_lock = xSemaphoreCreateMutex();
+    if (!s_mic_lock) {
+        ESP_LOGE(TAG, "Mic lock create failed");
+        return;
+    }
+
+    // 与 GUI 同在 Core 1，优先级低于 GUI_Task，保证界面流畅
+    xTaskCreatePinnedToCore(wakeword_task, "KWS_Task", 4096, NULL, 4, &s_task, 1);
+#endif
+}
+
+void Svc_WakeWord_Set_Enable(bool enable) {
+    s_enabled = enable;
+    if (enable && s_task) xTaskNotifyGive(s_task);
+}
+
+void Svc_WakeWord_Pause(void) {
+    s_enabled = false;
+    if (!s_mic_lock) return;
+    // 正在读取的一帧结束后 KWS 才会释放锁 (最多一帧，约 30ms)
+    xSemaphoreTake(s_mic_lock, portMAX_DELAY);
+    xSemaphoreGive(s_mic_lock);
+}
+
+void Svc_WakeWord_Get_Stats(SvcWakeWord_Stats_t *out) {
+    if (out) *out = s_stats;
+}
@@ -4,3 +4,9 @@
  * @brief 初始化并构建主界面
  */
 void UI_Main_Init(void);
+
+/**
+ * @brief [新增] 把 DataCenter 的灯光/环境数据同步到界面
+ * @note  由 GUI 任务在收到数据变更唤醒后持锁调用
+ */
+void UI_Main_Sync(void);
@@ -1,11 +1,72 @@
 #pragma once
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 /**
  * @brief 初始化屏幕底层驱动并注册到 LVGL
  */
 void UI_Port_Disp_Init(void);
 
+/**
+ * @brief [新增] 开始统计刷屏性能 (FPS、刷新/渲染/等待 DMA/DMA 刷屏耗时)，每秒打印一次 [UI-PERF]
+ * @note  需在 GUI 任务 (持有 g_lvgl_mux) 中调用
+ */
+void UI_Port_Disp_Perf_Start(void);
+
+/**
+ * @brief [新增] 停止统计并打印整段汇总 [UI-PERF-SUM]
+ */
+void UI_Port_Disp_Perf_Stop(void);
+
 /**
  * @brief 初始化触摸底层驱动并注册到 LVGL
+ * @note  [修改] PENIRQ 中断唤醒独立的触摸任务，DMA 采样 + 中值/IIR 滤波 + 压力检测，
+ *        LVGL 读回调只取无锁发布的最新触点
  */
 void UI_Port_Touch_Init(void);
+
+/**
+ * @brief [新增] 触摸按下中断唤醒 GUI 任务后调用：恢复 LVGL 输入设备读取定时器并立即读一次
+ * @note  松手后读取定时器会被暂停，避免空闲时每 30ms 轮询一次触摸
+ */
+void UI_Port_Touch_Resume(void);
+
+/**
+ * @brief [新增] 在控件响应触摸的回调里调用，打印本次按下到该响应的延迟 [TOUCH] (每次按下只打印一次)
+ * @param what 响应名称 (如 "滑块更新")
+ */
+void UI_Port_Touch_Report_Latency(const char *what);
+
+// ============================================================
+// [新增] GUI 任务唤醒管理 (ui_port_wake.c)
+// GUI 任务阻塞等待: LVGL 下一个定时器到期 / 触摸中断 / 数据变更通知
+// ============================================================
+typedef enum {
+    UI_WAKE_TOUCH = 0,  // 触摸采样任务检测到按下 / 抬起
+    UI_WAKE_DATA,       // DataCenter 数据变更
+    UI_WAKE_SRC_NUM
+} UI_Wake_Src_t;
+
+/** @brief 绑定 GUI 任务 (必须在注册任何唤醒源之前调用) */
+void UI_Port_Wake_Bind(TaskHandle_t gui_task);
+
+/** @brief 唤醒 GUI 任务 (任务上下文) */
+void UI_Port_Wake(UI_Wake_Src_t src);
+
+/**
+ * @brief GUI 任务阻塞等待唤醒
+ * @param wait_ms lv_timer_handler() 的返回值 (距下一个 LVGL 定时器到期的时间)
+ * @return 唤醒源位掩码 (1 << UI_Wake_Src_t)，0 表示定时器到期
+ */
+uint32_t UI_Port_Wait(uint32_t wait_ms);
+
+/** @brief 按 esp_timer 补齐 LVGL 时基 (调用 lv_timer_handler 前、以及渲染过程中调用) */
+void UI_Port_Tick_Sync(void);
+
+/**
+ * @brief 统计本次唤醒，每 10s 打印一次 [UI-WAKE] 唤醒次数与 GUI 占用率
+ * @param bits    UI_Port_Wait() 的返回值
+ * @param busy_us 本次唤醒的处理耗时
+ */
+void UI_Port_Wake_Account(uint32_t bits, uint32_t busy_us);
@@ -1,4 +1,5 @@
 #include "ui_main.h"
+#include "ui_port.h"
 #include "lvgl.h"
 #include "data_center.h"
 #include "esp_log.h"
@@ -25,6 +26,7 @@ static void slider_bri_event_cb(lv_event_t * e) {
     lv_obj_t * slider = lv_event_get_target(e);
     
     if (code == LV_EVENT_VALUE_CHANGED) {
+        UI_Port_Touch_Report_Latency("亮度滑块更新"); // [新增] 触摸延迟统计
         // 拖动时：50ms 限流，保证丝滑且不卡死总线
         if (lv_tick_elaps(s_last_bri_tick) > 50) {
             int bri = lv_slider_get_value(slider);
@@ -49,6 +51,7 @@ static void slider_cct_event_cb(lv_event_t * e) {
     lv_obj_t * slider = lv_event_get_target(e);
     
     if (code == LV_EVENT_VALUE_CHANGED) {
+        UI_Port_Touch_Report_Latency("色温滑块更新");
         if (lv_tick_elaps(s_last_cct_tick) > 50) {
             int cct = lv_slider_get_value(slider);
             DC_LightingData_t light;
@@ -91,14 +94,22 @@ static void btn_test_event_cb(lv_event_t * e) {
         lv_anim_set_exec_cb(&a, auto_anim_cb);
         lv_anim_start(&a);
         lv_obj_set_style_bg_color(s_btn_test, lv_palette_main(LV_PALETTE_RED), 0);
+        UI_Port_Disp_Perf_Start(); // [新增] 动画期间统计帧率与刷屏耗时
     } else {
         lv_anim_del(s_slider_bri, auto_anim_cb);
+        UI_Port_Disp_Perf_Stop();
         lv_obj_set_style_bg_color(s_btn_test, lv_palette_main(LV_PALETTE_BLUE), 0);
         lv_obj_invalidate(lv_scr_act()); // 停止时自愈
     }
 }
 
-static void ui_sync_timer_cb(lv_timer_t * timer) {
+/** @brief DataCenter 变更回调 (调用方任务上下文)：只唤醒 GUI 任务，由其在持锁后调用 UI_Main_Sync */
+static void dc_change_cb(uint32_t domains) {
+    if (domains & (DC_DOMAIN_LIGHTING | DC_DOMAIN_ENV)) UI_Port_Wake(UI_WAKE_DATA);
+}
+
+// [修改] 原 500ms 轮询定时器改为数据变更时由 GUI 任务调用
+void UI_Main_Sync(void) {
     DC_EnvData_t env;
     DataCenter_Get_Env(&env);
     lv_label_set_text_fmt(s_label_env, "Temp: %d C   Hum: %d %%   Lux: %d", 
@@ -171,7 +182,8 @@ void UI_Main_Init(void) {
     lv_obj_set_style_text_color(s_label_env, lv_color_hex(0x00FF00), LV_PART_MAIN);
     lv_obj_align(s_label_env, LV_ALIGN_BOTTOM_MID, 0, -20);
 
-    lv_timer_create(ui_sync_timer_cb, 500, NULL);
+    UI_Main_Sync();
+    DataCenter_Register_Change_Cb(dc_change_cb);
 
     ESP_LOGI(TAG, "Main UI Initialized");
 }
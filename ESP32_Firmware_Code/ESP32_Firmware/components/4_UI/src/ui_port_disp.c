@@ -8,6 +8,9 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_lcd_ili9341.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+#include "esp_timer.h"
 
 static const char *TAG = "UI_PORT_DISP";
 
@@ -28,32 +31,156 @@ static const char *TAG = "UI_PORT_DISP";
 #define LCD_H_RES 320
 #define LCD_V_RES 240
 
-// 单缓冲，1/4 屏幕大小
-#define DISP_BUF_SIZE (LCD_H_RES * LCD_V_RES / 4)
+// ============================================================
+// [修改] 刷屏缓冲配置
+// ============================================================
+#define UI_DISP_DOUBLE_BUF   1   // 1: 双缓冲，LVGL 渲染下一块的同时 DMA 刷上一块; 0: 单缓冲 (改造前)
+#define UI_DISP_FULL_FRAME   0   // 1: 两块整帧缓冲 + full_refresh (每帧整屏刷新，需 PSRAM); 0: 按带局部刷新
+#define UI_DISP_BUF_PSRAM    0   // 1: 缓冲放 PSRAM (S3 的 GDMA 可直接读 PSRAM，需 64 字节对齐)
+#define UI_DISP_BUF_LINES    30  // 局部刷新时每块缓冲的行数 (双缓冲 2x30 行与原单缓冲 1/4 屏占用相同)
+
+#if UI_DISP_FULL_FRAME
+#define DISP_BUF_SIZE (LCD_H_RES * LCD_V_RES)
+#if !UI_DISP_BUF_PSRAM
+#error "UI_DISP_FULL_FRAME 需要 UI_DISP_BUF_PSRAM (两块整帧缓冲共 300KB)"
+#endif
+#else
+#define DISP_BUF_SIZE (LCD_H_RES * UI_DISP_BUF_LINES)
+#endif
+
+#if UI_DISP_BUF_PSRAM && !CONFIG_SPIRAM
+#error "UI_DISP_BUF_PSRAM 需要在 menuconfig 中开启 PSRAM"
+#endif
+
+#define UI_PERF_LOG_MS       1000 // 性能统计打印周期
 
 static esp_lcd_panel_io_handle_t io_handle = NULL; 
 static esp_lcd_panel_handle_t panel_handle = NULL;
 
 static lv_disp_draw_buf_t disp_buf;
 static lv_color_t *buf1 = NULL; 
+static lv_color_t *buf2 = NULL;
 static lv_disp_drv_t disp_drv;
 
-// 全局隔离标志位
-volatile bool g_lcd_is_flushing = false;
+// ============================================================
+// [新增] 刷屏性能统计
+// 刷新耗时来自 LVGL monitor_cb (渲染 + 等待 DMA)，DMA 刷屏耗时与
+// LVGL 阻塞等待 DMA 的耗时在传输完成中断里累加 (32 位 us，只取差值，回绕无影响)
+// ============================================================
+typedef struct {
+    uint32_t frames;
+    uint32_t px;
+    uint32_t refr_ms_sum;
+    uint32_t refr_ms_max;
+    uint32_t flush_us;
+    uint32_t wait_us;
+    int64_t  start_us;
+} disp_perf_t;
+
+static volatile uint32_t s_isr_flush_us = 0; // 中断写
+static volatile uint32_t s_isr_wait_us = 0;  // 中断写
+static volatile int64_t  s_flush_t0 = 0;
+static volatile int64_t  s_wait_t0 = 0;
+static volatile bool     s_waiting = false;
+
+static bool s_perf_on = false;
+static disp_perf_t s_perf_win;     // 当前打印周期
+static disp_perf_t s_perf_total;   // 整个 Auto Test 过程
+static uint32_t s_perf_flush_base, s_perf_wait_base;
+
+static void _perf_reset(disp_perf_t *p) {
+    memset(p, 0, sizeof(*p));
+    p->start_us = esp_timer_get_time();
+}
+
+static void _perf_log(const char *title, const disp_perf_t *p) {
+    uint32_t span_ms = (uint32_t)((esp_timer_get_time() - p->start_us) / 1000);
+    if (p->frames == 0 || span_ms == 0) return;
+    uint32_t refr = p->refr_ms_sum / p->frames;
+    uint32_t wait = p->wait_us / 1000 / p->frames;
+    ESP_LOGI(TAG, "[%s] FPS: %lu.%lu | 刷新: avg %lu ms / max %lu ms | 渲染: %lu ms | 等待DMA: %lu ms | DMA刷屏: %lu ms/帧 | 像素: %lu/帧 | 缓冲: %s",
+             title, p->frames * 1000 / span_ms, (p->frames * 10000 / span_ms) % 10, refr, p->refr_ms_max,
+             (refr > wait) ? refr - wait : 0, wait, p->flush_us / 1000 / p->frames, p->px / p->frames,
+             buf2 ? (UI_DISP_FULL_FRAME ? "双整帧" : "双缓冲") : "单缓冲");
+}
+
+static void _perf_add(disp_perf_t *p, uint32_t time_ms, uint32_t px, uint32_t flush_us, uint32_t wait_us) {
+    p->frames++;
+    p->px += px;
+    p->refr_ms_sum += time_ms;
+    if (time_ms > p->refr_ms_max) p->refr_ms_max = time_ms;
+    p->flush_us += flush_us;
+    p->wait_us += wait_us;
+}
+
+/** @brief LVGL 每完成一次刷新回调一次 (GUI 任务上下文) */
+static void lvgl_monitor_cb(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px) {
+    if (!s_perf_on) return;
+    uint32_t flush_now = s_isr_flush_us, wait_now = s_isr_wait_us;
+    uint32_t flush_us = flush_now - s_perf_flush_base, wait_us = wait_now - s_perf_wait_base;
+    s_perf_flush_base = flush_now;
+    s_perf_wait_base = wait_now;
+
+    _perf_add(&s_perf_win, time_ms, px, flush_us, wait_us);
+    _perf_add(&s_perf_total, time_ms, px, flush_us, wait_us);
+    if (esp_timer_get_time() - s_perf_win.start_us >= UI_PERF_LOG_MS * 1000LL) {
+        _perf_log("UI-PERF", &s_perf_win);
+        _perf_reset(&s_perf_win);
+    }
+}
+
+/** @brief LVGL 等待 DMA 完成时反复调用，记录本次等待的起点 (终点在传输完成中断里) */
+static void lvgl_wait_cb(lv_disp_drv_t *drv) {
+    UI_Port_Tick_Sync();
+    if (!s_waiting) {
+        s_wait_t0 = esp_timer_get_time();
+        s_waiting = true;
+    }
+    if (!drv->draw_buf->flushing) s_waiting = false; // 中断已在置位前到达
+}
 
 static bool notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx) {
     lv_disp_drv_t *disp_driver = (lv_disp_drv_t *)user_ctx;
-    g_lcd_is_flushing = false; // 释放总线
+    int64_t now = esp_timer_get_time();
+    s_isr_flush_us += (uint32_t)(now - s_flush_t0);
+    if (s_waiting) {
+        s_isr_wait_us += (uint32_t)(now - s_wait_t0);
+        s_waiting = false;
+    }
     lv_disp_flush_ready(disp_driver);
     return false; 
 }
 
 static void lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map) {
     esp_lcd_panel_handle_t panel = (esp_lcd_panel_handle_t) drv->user_data;
-    g_lcd_is_flushing = true;  // 锁定总线
+    UI_Port_Tick_Sync();       // [新增] 渲染中途补齐时基，monitor_cb 的刷新耗时才准确
+    s_flush_t0 = esp_timer_get_time();
     esp_lcd_panel_draw_bitmap(panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_map);
 }
 
+void UI_Port_Disp_Perf_Start(void) {
+    s_perf_flush_base = s_isr_flush_us;
+    s_perf_wait_base = s_isr_wait_us;
+    _perf_reset(&s_perf_win);
+    _perf_reset(&s_perf_total);
+    s_perf_on = true;
+}
+
+void UI_Port_Disp_Perf_Stop(void) {
+    if (!s_perf_on) return;
+    s_perf_on = false;
+    _perf_log("UI-PERF-SUM", &s_perf_total);
+}
+
+/** @brief 分配一块刷屏缓冲 (DMA 可访问) */
+static lv_color_t *_alloc_draw_buf(void) {
+#if UI_DISP_BUF_PSRAM
+    return heap_caps_aligned_alloc(64, DISP_BUF_SIZE * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+#else
+    return heap_caps_malloc(DISP_BUF_SIZE * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+#endif
+}
+
 void UI_Port_Disp_Init(void) {
     ESP_LOGI(TAG, "Initialize Intel 8080 bus");
 
@@ -109,13 +236,21 @@ void UI_Port_Disp_Init(void) {
 
     lv_init();
 
-    buf1 = heap_caps_malloc(DISP_BUF_SIZE * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    buf1 = _alloc_draw_buf();
     assert(buf1);
+#if UI_DISP_DOUBLE_BUF || UI_DISP_FULL_FRAME
+    buf2 = _alloc_draw_buf();
+    if (!buf2) ESP_LOGW(TAG, "Second draw buffer alloc failed, fallback to single buffer");
+#endif
+    ESP_LOGI(TAG, "Draw buffer: %d x %d px (%s, %s)", buf2 ? 2 : 1, DISP_BUF_SIZE,
+             UI_DISP_BUF_PSRAM ? "PSRAM" : "Internal DMA", UI_DISP_FULL_FRAME ? "full refresh" : "partial");
 
-    lv_disp_draw_buf_init(&disp_buf, buf1, NULL, DISP_BUF_SIZE);
+    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, DISP_BUF_SIZE);
 
     lv_disp_drv_init(&disp_drv);
-    disp_drv.full_refresh = 0; 
+    disp_drv.full_refresh = (UI_DISP_FULL_FRAME && buf2) ? 1 : 0;
+    disp_drv.monitor_cb = lvgl_monitor_cb;
+    disp_drv.wait_cb = lvgl_wait_cb;
     disp_drv.hor_res = LCD_H_RES;
     disp_drv.ver_res = LCD_V_RES;
     disp_drv.flush_cb = lvgl_flush_cb; 
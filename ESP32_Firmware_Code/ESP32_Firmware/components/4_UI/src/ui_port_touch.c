@@ -2,7 +2,10 @@
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "lvgl.h"
+#include <string.h>
 
 static const char *TAG = "UI_PORT_TOUCH";
 
@@ -17,57 +20,226 @@ static const char *TAG = "UI_PORT_TOUCH";
 #define TOUCH_Y_MIN 140
 #define TOUCH_Y_MAX 1875
 
+// ============================================================
+// [新增] 采样与滤波参数
+// ============================================================
+#define TOUCH_SAMPLE_MS     10    // 按下期间的采样周期
+#define TOUCH_MEDIAN_N      5     // 每次采样 X/Y 各转换 5 次取中值
+#define TOUCH_SPREAD_MAX    60    // 5 次转换极差超过该值 (ADC 码) 视为按下/抬起过渡期的坏样本
+#define TOUCH_Z_THRESHOLD   180   // 压力 Z = Z1 + 2047 - Z2 低于该值视为未按下 (与坐标同为 11 位)
+#define TOUCH_IIR_SHIFT     1     // IIR: p += (m - p) >> 1
+#define TOUCH_IIR_FRAC      4     // IIR 状态的小数位 (Q4)
+
+#define XPT_CMD_X   0xD0
+#define XPT_CMD_Y   0x90
+#define XPT_CMD_Z1  0xB0
+#define XPT_CMD_Z2  0xC0
+
+// 一次 DMA 事务的转换序列: Z1, Z2, X*N, Y*N (16 时钟重叠模式: 每个命令字节后紧跟 2 字节结果)
+#define TOUCH_CONV_NUM      (2 + 2 * TOUCH_MEDIAN_N)
+#define TOUCH_XFER_LEN      (TOUCH_CONV_NUM * 2 + 1)
+
+/**
+ * @brief 最新触点 (触摸任务写，LVGL 读，单个 32 位原子变量，无锁)
+ *        bit31: 按下 | bit30..20: 序号 | bit19..10: y | bit9..0: x
+ */
+static uint32_t s_point = 0;
+#define PT_PACK(x, y, pr, seq) (((uint32_t)(pr) << 31) | (((seq) & 0x7FFu) << 20) | ((uint32_t)(y) << 10) | (uint32_t)(x))
+#define PT_X(p)         ((p) & 0x3FFu)
+#define PT_Y(p)         (((p) >> 10) & 0x3FFu)
+#define PT_PRESSED(p)   ((p) >> 31)
+
 static spi_device_handle_t spi_handle;
-extern volatile bool g_lcd_is_flushing;
-
-static uint16_t xpt2046_read_adc(uint8_t cmd) {
-    uint8_t tx_data[3] = {cmd, 0x00, 0x00};
-    uint8_t rx_data[3] = {0};
-    spi_transaction_t t = { .length = 24, .tx_buffer = tx_data, .rx_buffer = rx_data };
-    spi_device_polling_transmit(spi_handle, &t);
-    return (rx_data[1] << 4) | (rx_data[2] >> 4);
+static lv_indev_drv_t s_indev_drv;
+static TaskHandle_t s_touch_task = NULL;
+static uint8_t *s_tx = NULL;  // DMA 缓冲
+static uint8_t *s_rx = NULL;
+
+// 延迟统计: 按下中断时间戳 (us，32 位回绕无影响)
+static volatile uint32_t s_down_us = 0;
+static volatile bool s_latency_pending = false;
+
+// ============================================================
+// 1. 中断: 笔按下 (PENIRQ 下降沿)，关中断后唤醒触摸任务
+//    (转换期间 PENIRQ 会抖动，采样结束、确认抬起后再重新打开)
+// ============================================================
+static void IRAM_ATTR touch_irq_isr(void *arg) {
+    gpio_intr_disable(TOUCH_IRQ);
+    s_down_us = (uint32_t)esp_timer_get_time();
+    s_latency_pending = true;
+    BaseType_t hp_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(s_touch_task, &hp_woken);
+    if (hp_woken) portYIELD_FROM_ISR();
 }
 
-static uint16_t xpt2046_read_filtered(uint8_t cmd) {
-    uint16_t buf[5];
-    for(int i = 0; i < 5; i++) buf[i] = xpt2046_read_adc(cmd);
-    for(int i = 0; i < 4; i++) {
-        for(int j = i + 1; j < 5; j++) {
-            if(buf[i] > buf[j]) {
-                uint16_t temp = buf[i]; buf[i] = buf[j]; buf[j] = temp;
-            }
+// ============================================================
+// 2. 采样: 一次 DMA 事务完成全部转换
+// ============================================================
+typedef struct {
+    uint16_t x, y;  // 中值
+    uint16_t z;     // 压力
+    bool     valid; // 极差与压力均合格
+} touch_raw_t;
+
+static uint16_t _median5(uint16_t *v, uint16_t *spread) {
+    for (int i = 0; i < TOUCH_MEDIAN_N - 1; i++) {
+        for (int j = i + 1; j < TOUCH_MEDIAN_N; j++) {
+            if (v[i] > v[j]) { uint16_t t = v[i]; v[i] = v[j]; v[j] = t; }
         }
     }
-    return buf[2];
+    *spread = v[TOUCH_MEDIAN_N - 1] - v[0];
+    return v[TOUCH_MEDIAN_N / 2];
 }
 
-static void touch_read_cb(lv_indev_drv_t * drv, lv_indev_data_t * data) {
-    // 【智能隔离】如果 LCD 正在刷屏，直接 return。
-    // 注意：这里不修改 data 的内容，LVGL 会自动沿用上一次的坐标和按下状态，
-    // 这样既避免了总线打架，又保证了拖动滑块时不会“断触”。
-    if (g_lcd_is_flushing) {
-        return; 
-    }
+static bool _sample(touch_raw_t *out) {
+    spi_transaction_t t = { .length = TOUCH_XFER_LEN * 8, .tx_buffer = s_tx, .rx_buffer = s_rx };
+    spi_transaction_t *done;
+    if (spi_device_queue_trans(spi_handle, &t, portMAX_DELAY) != ESP_OK) return false;
+    if (spi_device_get_trans_result(spi_handle, &done, portMAX_DELAY) != ESP_OK) return false;
 
-    if (gpio_get_level(TOUCH_IRQ) == 1) {
-        data->state = LV_INDEV_STATE_REL; 
-        return;
+    uint16_t v[TOUCH_CONV_NUM];
+    for (int i = 0; i < TOUCH_CONV_NUM; i++) {
+        v[i] = (s_rx[1 + 2 * i] << 4) | (s_rx[2 + 2 * i] >> 4); // 与原驱动相同的 11 位刻度，沿用校准值
     }
+    uint16_t sx, sy;
+    out->x = _median5(&v[2], &sx);
+    out->y = _median5(&v[2 + TOUCH_MEDIAN_N], &sy);
+    int z = (int)v[0] + 2047 - (int)v[1];
+    out->z = (z < 0) ? 0 : (uint16_t)z;
+    out->valid = (out->z >= TOUCH_Z_THRESHOLD) && sx <= TOUCH_SPREAD_MAX && sy <= TOUCH_SPREAD_MAX;
+    return true;
+}
 
-    uint16_t raw_x = xpt2046_read_filtered(0xD0);
-    uint16_t raw_y = xpt2046_read_filtered(0x90);
+static void _map(const touch_raw_t *r, int32_t *x, int32_t *y) {
+    *x = ((int32_t)r->y - TOUCH_X_MIN) * 320 / (TOUCH_X_MAX - TOUCH_X_MIN);
+    *y = (TOUCH_Y_MAX - (int32_t)r->x) * 240 / (TOUCH_Y_MAX - TOUCH_Y_MIN);
+    if (*x < 0) *x = 0;
+    if (*x > 319) *x = 319;
+    if (*y < 0) *y = 0;
+    if (*y > 239) *y = 239;
+}
 
-    int32_t x = (raw_y - TOUCH_X_MIN) * 320 / (TOUCH_X_MAX - TOUCH_X_MIN);
-    int32_t y = (TOUCH_Y_MAX - raw_x) * 240 / (TOUCH_Y_MAX - TOUCH_Y_MIN);
+// ============================================================
+// 3. 抖动统计 (单次按压内，原始中值 vs 滤波输出的标准差)
+// ============================================================
+typedef struct {
+    uint32_t n;
+    int64_t  sx, sy, sxx, syy;
+} jitter_acc_t;
 
-    if (x < 0) x = 0; 
-    if (x > 319) x = 319;
-    if (y < 0) y = 0; 
-    if (y > 239) y = 239;
+static void _jitter_add(jitter_acc_t *a, int32_t x, int32_t y) {
+    a->n++;
+    a->sx += x; a->sy += y;
+    a->sxx += (int64_t)x * x; a->syy += (int64_t)y * y;
+}
 
-    data->point.x = x;
-    data->point.y = y;
-    data->state = LV_INDEV_STATE_PR; 
+/** @brief 标准差 (x10，单位 px，Q4 坐标按 scale 换算) */
+static uint32_t _jitter_std10(const jitter_acc_t *a, int scale) {
+    if (a->n < 2) return 0;
+    int64_t n = a->n;
+    int64_t vx = (a->sxx * n - a->sx * a->sx) / (n * n);
+    int64_t vy = (a->syy * n - a->sy * a->sy) / (n * n);
+    int64_t v = (vx + vy) * 100 / ((int64_t)scale * scale);
+    uint32_t r = 0;
+    while ((int64_t)(r + 1) * (r + 1) <= v) r++;
+    return r;
+}
+
+// ============================================================
+// 4. 触摸任务: 中断唤醒 -> 按下期间每 10ms 采样 -> 抬起后重新等中断
+// ============================================================
+static void touch_task(void *arg) {
+    uint32_t seq = 0;
+    while (1) {
+        gpio_intr_enable(TOUCH_IRQ);
+        if (gpio_get_level(TOUCH_IRQ) == 1) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else {
+            gpio_intr_disable(TOUCH_IRQ); // 开中断前已按下 (未产生下降沿)
+            s_down_us = (uint32_t)esp_timer_get_time();
+            s_latency_pending = true;
+        }
+
+        int32_t fx = 0, fy = 0;          // IIR 状态 (Q4)
+        bool pressed = false;
+        uint32_t first_us = 0, z_sum = 0;
+        int64_t down_us = esp_timer_get_time();
+        jitter_acc_t j_raw = {0}, j_flt = {0};
+        TickType_t last_wake = xTaskGetTickCount();
+
+        while (1) {
+            touch_raw_t r;
+            bool ok = _sample(&r) && r.valid && gpio_get_level(TOUCH_IRQ) == 0;
+            if (!ok) {
+                if (gpio_get_level(TOUCH_IRQ) == 1) break; // 抬起
+            } else {
+                int32_t x, y;
+                _map(&r, &x, &y);
+                if (!pressed) {
+                    fx = x << TOUCH_IIR_FRAC;
+                    fy = y << TOUCH_IIR_FRAC;
+                    first_us = (uint32_t)esp_timer_get_time() - s_down_us;
+                    pressed = true;
+                } else {
+                    fx += ((x << TOUCH_IIR_FRAC) - fx) >> TOUCH_IIR_SHIFT;
+                    fy += ((y << TOUCH_IIR_FRAC) - fy) >> TOUCH_IIR_SHIFT;
+                }
+                _jitter_add(&j_raw, x, y);
+                _jitter_add(&j_flt, fx, fy);
+                z_sum += r.z;
+
+                uint32_t px = (fx + (1 << (TOUCH_IIR_FRAC - 1))) >> TOUCH_IIR_FRAC;
+                uint32_t py = (fy + (1 << (TOUCH_IIR_FRAC - 1))) >> TOUCH_IIR_FRAC;
+                uint32_t old = __atomic_load_n(&s_point, __ATOMIC_RELAXED);
+                if (!PT_PRESSED(old) || PT_X(old) != px || PT_Y(old) != py) {
+                    __atomic_store_n(&s_point, PT_PACK(px, py, 1, ++seq), __ATOMIC_RELEASE);
+                    UI_Port_Wake(UI_WAKE_TOUCH);
+                }
+            }
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+        }
+
+        // 抬起: 发布松开状态 (保留最后坐标)
+        uint32_t old = __atomic_load_n(&s_point, __ATOMIC_RELAXED);
+        __atomic_store_n(&s_point, PT_PACK(PT_X(old), PT_Y(old), 0, ++seq), __ATOMIC_RELEASE);
+        UI_Port_Wake(UI_WAKE_TOUCH);
+        s_latency_pending = false;
+
+        if (pressed) {
+            ESP_LOGI(TAG, "[TOUCH] 按压: %lu ms | 有效采样: %lu | 抖动 原始: %lu.%lu px / 滤波: %lu.%lu px | 首点延迟: %lu us | 平均压力: %lu",
+                     (uint32_t)((esp_timer_get_time() - down_us) / 1000), j_raw.n,
+                     _jitter_std10(&j_raw, 1) / 10, _jitter_std10(&j_raw, 1) % 10,
+                     _jitter_std10(&j_flt, 1 << TOUCH_IIR_FRAC) / 10, _jitter_std10(&j_flt, 1 << TOUCH_IIR_FRAC) % 10,
+                     first_us, z_sum / j_raw.n);
+        }
+    }
+}
+
+// ============================================================
+// 5. LVGL 输入设备回调: 只读取最新触点，不访问 SPI
+// ============================================================
+static void touch_read_cb(lv_indev_drv_t * drv, lv_indev_data_t * data) {
+    uint32_t p = __atomic_load_n(&s_point, __ATOMIC_ACQUIRE);
+    data->point.x = PT_X(p);
+    data->point.y = PT_Y(p);
+    if (PT_PRESSED(p)) {
+        data->state = LV_INDEV_STATE_PR;
+    } else {
+        data->state = LV_INDEV_STATE_REL;
+        lv_timer_pause(drv->read_timer); // 松手后停止轮询，等触摸任务发布新触点再恢复
+    }
+}
+
+void UI_Port_Touch_Resume(void) {
+    if (!s_indev_drv.read_timer) return;
+    lv_timer_resume(s_indev_drv.read_timer);
+    lv_timer_ready(s_indev_drv.read_timer);
+}
+
+void UI_Port_Touch_Report_Latency(const char *what) {
+    if (!s_latency_pending) return;
+    s_latency_pending = false;
+    ESP_LOGI(TAG, "[TOUCH] 按下 -> %s: %lu us", what, (uint32_t)esp_timer_get_time() - s_down_us);
 }
 
 void UI_Port_Touch_Init(void) {
@@ -83,13 +255,32 @@ void UI_Port_Touch_Init(void) {
 
     spi_device_interface_config_t devcfg = {
         .clock_speed_hz = 2 * 1000 * 1000, // 触摸 SPI 保持 2MHz
-        .mode = 0, .spics_io_num = TOUCH_CS, .queue_size = 7,
+        .mode = 0, .spics_io_num = TOUCH_CS, .queue_size = 2,
     };
     ESP_ERROR_CHECK(spi_bus_add_device(SPI2_HOST, &devcfg, &spi_handle));
 
-    static lv_indev_drv_t indev_drv;
-    lv_indev_drv_init(&indev_drv);
-    indev_drv.type = LV_INDEV_TYPE_POINTER;
-    indev_drv.read_cb = touch_read_cb;
-    lv_indev_drv_register(&indev_drv);
+    // 转换命令序列: 偶数字节为命令，奇数字节及末尾补 0 (最后一个命令 PD=00，转换后掉电并重新使能 PENIRQ)
+    s_tx = heap_caps_malloc(TOUCH_XFER_LEN, MALLOC_CAP_DMA);
+    s_rx = heap_caps_malloc(TOUCH_XFER_LEN, MALLOC_CAP_DMA);
+    assert(s_tx && s_rx);
+    memset(s_tx, 0, TOUCH_XFER_LEN);
+    static const uint8_t cmds[2] = { XPT_CMD_Z1, XPT_CMD_Z2 };
+    for (int i = 0; i < TOUCH_CONV_NUM; i++) {
+        uint8_t cmd = (i < 2) ? cmds[i] : (i < 2 + TOUCH_MEDIAN_N) ? XPT_CMD_X : XPT_CMD_Y;
+        s_tx[2 * i] = cmd;
+    }
+
+    lv_indev_drv_init(&s_indev_drv);
+    s_indev_drv.type = LV_INDEV_TYPE_POINTER;
+    s_indev_drv.read_cb = touch_read_cb;
+    lv_indev_drv_register(&s_indev_drv);
+
+    // 触摸任务优先级高于 GUI 任务，保证按下期间采样周期稳定
+    xTaskCreatePinnedToCore(touch_task, "touch", 3072, NULL, 6, &s_touch_task, 1);
+
+    // PENIRQ 下降沿唤醒触摸任务 (ISR 服务可能已被其他模块安装)
+    gpio_set_intr_type(TOUCH_IRQ, GPIO_INTR_NEGEDGE);
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) ESP_ERROR_CHECK(err);
+    ESP_ERROR_CHECK(gpio_isr_handler_add(TOUCH_IRQ, touch_irq_isr, NULL));
 }
@@ -0,0 +1,79 @@
+#include "ui_port.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+#include <string.h>
+
+static const char *TAG = "UI_PORT_WAKE";
+
+#define UI_WAKE_STATS_MS  10000  // 唤醒统计打印周期
+
+static TaskHandle_t s_gui_task = NULL;
+static int64_t s_tick_last_us = 0;
+
+// 以下仅 GUI 任务访问
+static uint32_t s_wake_cnt[UI_WAKE_SRC_NUM + 1]; // 最后一项为纯定时唤醒
+static int64_t  s_busy_us = 0;
+static int64_t  s_stats_start_us = 0;
+
+// ============================================================
+// 1. 唤醒通知 (任务通知的位 = 唤醒源)
+// ============================================================
+void UI_Port_Wake_Bind(TaskHandle_t gui_task) {
+    s_gui_task = gui_task;
+    s_tick_last_us = esp_timer_get_time();
+    s_stats_start_us = s_tick_last_us;
+}
+
+void UI_Port_Wake(UI_Wake_Src_t src) {
+    if (s_gui_task) xTaskNotify(s_gui_task, 1u << src, eSetBits);
+}
+
+uint32_t UI_Port_Wait(uint32_t wait_ms) {
+    uint32_t bits = 0;
+    if (wait_ms > UI_WAKE_STATS_MS) wait_ms = UI_WAKE_STATS_MS; // 含 LV_NO_TIMER_READY: 空闲时仍按周期输出统计
+    TickType_t ticks = pdMS_TO_TICKS(wait_ms);
+    if (ticks == 0 && wait_ms > 0) ticks = 1;
+    xTaskNotifyWait(0, UINT32_MAX, &bits, ticks);
+    return bits;
+}
+
+// ============================================================
+// 2. LVGL 时基: 由 esp_timer 推算，按需补齐 (无周期性节拍中断)
+// ============================================================
+void UI_Port_Tick_Sync(void) {
+    int64_t now = esp_timer_get_time();
+    uint32_t ms = (uint32_t)((now - s_tick_last_us) / 1000);
+    if (ms) {
+        lv_tick_inc(ms);
+        s_tick_last_us += (int64_t)ms * 1000;  // 保留不足 1ms 的余量，长期不漂移
+    }
+}
+
+// ============================================================
+// 3. 唤醒与 CPU 占用统计
+// ============================================================
+void UI_Port_Wake_Account(uint32_t bits, uint32_t busy_us) {
+    if (bits == 0) {
+        s_wake_cnt[UI_WAKE_SRC_NUM]++;
+    } else {
+        for (int i = 0; i < UI_WAKE_SRC_NUM; i++) {
+            if (bits & (1u << i)) s_wake_cnt[i]++;
+        }
+    }
+    s_busy_us += busy_us;
+
+    int64_t span = esp_timer_get_time() - s_stats_start_us;
+    if (span < UI_WAKE_STATS_MS * 1000LL) return;
+
+    uint32_t total = s_wake_cnt[UI_WAKE_SRC_NUM];
+    for (int i = 0; i < UI_WAKE_SRC_NUM; i++) total += s_wake_cnt[i];
+    uint32_t permille = (uint32_t)(s_busy_us * 1000 / span);
+    ESP_LOGI(TAG, "[UI-WAKE] 唤醒: %lu 次/%lus (定时 %lu | 触摸 %lu | 数据 %lu) | GUI 占用 Core1: %lu.%lu%%",
+             total, (uint32_t)(span / 1000000), s_wake_cnt[UI_WAKE_SRC_NUM], s_wake_cnt[UI_WAKE_TOUCH],
+             s_wake_cnt[UI_WAKE_DATA], permille / 10, permille % 10);
+
+    memset(s_wake_cnt, 0, sizeof(s_wake_cnt));
+    s_busy_us = 0;
+    s_stats_start_us = esp_timer_get_time();
+}
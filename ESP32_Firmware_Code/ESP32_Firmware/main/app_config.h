@@ -20,6 +20,12 @@
 // 最大录音时长 (ms): 百度限制 60秒
 #define ASR_MAX_DURATION_MS     60000 
 
+// --- KWS (Wake Word) Settings ---
+// 唤醒词模型在 menuconfig -> ESP Speech Recognition 中选择，烧录到 model 分区
+#define KWS_ENABLE              1
+#define KWS_DET_MODE            DET_MODE_95   // DET_MODE_90 更灵敏，DET_MODE_95 误唤醒更少
+#define KWS_STATS_PERIOD_MS     60000         // CPU 负载 / 唤醒次数统计打印周期
+
 // --- Button System ---
 // [修改] 使用外接按钮 GPIO 21
 // 接线方式: GPIO 21 <--> 按钮 <--> GND
@@ -58,4 +64,29 @@
 // 发布主题：向 Python 发送当前状态
 #define MQTT_TOPIC_STATUS       "device/lamp/status"
 
+// [新增] 群控: 订阅 <前缀><分区> 与 <前缀>all 两个组播主题，消息格式与 MQTT_TOPIC_CTRL 相同
+#define MQTT_DEVICE_ID          LAMPMIND_DEVICE_ID
+#define MQTT_TOPIC_GROUP_PREFIX "device/lamp/group/"
+#define MQTT_LAMP_ZONE          "floor1"
+// [新增] 序号防乱序: seq 落后上次已执行序号且差值在此窗口内的指令视为过期并丢弃；
+//        落后超过窗口视为发送端重启/回绕，重新接受
+#define MQTT_SEQ_STALE_WINDOW   100000
+
+// [新增] 事件主题 (人体感应等)，离线时进入发件箱
+#define MQTT_TOPIC_EVENT        "device/lamp/event"
+// [新增] 在线状态 (retain)，异常掉线时由 broker 代发遗嘱 {"online":0}
+#define MQTT_TOPIC_AVAIL        "device/lamp/" MQTT_DEVICE_ID "/availability"
+
+// [新增] 离线发件箱: PSRAM 队列容量 / NVS 溢出区容量 (条)
+#define MQTT_OUTBOX_CAPACITY    64
+#define MQTT_OUTBOX_SPILL_MAX   32
+// [新增] 重连回放节奏: 每批条数 / 批间隔，避免重连瞬间把 broker 和 Wi-Fi 打满
+#define MQTT_OUTBOX_DRAIN_BATCH        5
+#define MQTT_OUTBOX_DRAIN_INTERVAL_MS  100
+
+// [新增] 状态上报节流: 合并窗口内的多次变化只发一条增量 (仅含相对上次已确认状态变化的字段, QoS 1)
+#define MQTT_COALESCE_MS        200
+// [新增] 全量快照 (retain, QoS 1) 周期，供后上线的面板获取完整状态；期间无变化则跳过
+#define MQTT_SNAPSHOT_PERIOD_MS 30000
+
 #endif // APP_CONFIG_H
\ No newline at end of file
@@ -9,12 +9,14 @@
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
 
 #include "manager/mgr_wifi.h"
 #include "dev_audio.h"
 #include "dev_stm32.h" 
 #include "dev_csi.h"       
+#include "dev_csi_capture.h"
 #include "app_config.h"
 #include "service_core.h"
 #include "event_bus.h"
@@ -25,6 +27,9 @@
 #include "Key.h"
 #include "svc_audio.h" 
 #include "agents/agent_baidu_tts.h"
+#include "agents/agent_mqtt.h"
+#include "agents/agent_mqtt_outbox.h"
+#include "svc_wakeword.h"
 
 // --- UI 相关头文件 ---
 #include "lvgl.h"
@@ -32,6 +37,7 @@
 #include "ui_main.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "MAIN";
@@ -60,19 +66,26 @@ static void my_csi_presence_callback(bool is_present) {
     
     // 写入数据中心 (内部会自动触发 3 秒防抖保存，并同步给 UI 和 STM32)
     DataCenter_Set_Lighting(&light);
+
+    // [新增] 上报人体感应事件 (断网时进入离线发件箱，重连后补发)
+    Agent_MQTT_Publish_Event(is_present ? "{\"event\":\"presence\",\"val\":1}"
+                                        : "{\"event\":\"presence\",\"val\":0}");
 }
 
 // ============================================================================
 // 2. LVGL 渲染任务 (Core 1)
 // ============================================================================
 /**
- * @brief GUI 渲染与触控轮询任务
- * @note  绑定在 Core 1 运行，确保高频 UI 刷新不被 Wi-Fi 协议栈阻塞
+ * @brief GUI 渲染与触控任务 (事件驱动)
+ * @note  绑定在 Core 1 运行，确保高频 UI 刷新不被 Wi-Fi 协议栈阻塞。
+ *        [修改] 不再固定 10ms 轮询：阻塞等待 LVGL 下一个定时器到期 (lv_timer_handler 返回值)、
+ *        触摸按下中断或 DataCenter 数据变更通知，空闲时 Core 1 几乎不被唤醒。
  * @param arg 任务参数 (未使用)
  */
 static void gui_task(void *arg) {
     ESP_LOGI(TAG, "GUI Task Started on Core 1");
     g_lvgl_mux = xSemaphoreCreateMutex();
+    UI_Port_Wake_Bind(xTaskGetCurrentTaskHandle());
 
     // 初始化底层显示与触摸驱动
     UI_Port_Disp_Init();
@@ -83,14 +96,20 @@ static void gui_task(void *arg) {
     UI_Main_Init(); 
     xSemaphoreGive(g_lvgl_mux);
 
-    // LVGL 核心心跳循环
+    // LVGL 事件循环
+    uint32_t wait_ms = 0;
     while (1) {
-        vTaskDelay(pdMS_TO_TICKS(10));
-        lv_tick_inc(10);
-        if (xSemaphoreTake(g_lvgl_mux, pdMS_TO_TICKS(10)) == pdTRUE) {
-            lv_timer_handler();
-            xSemaphoreGive(g_lvgl_mux);
-        }
+        uint32_t bits = UI_Port_Wait(wait_ms);
+        int64_t t0 = esp_timer_get_time();
+
+        xSemaphoreTake(g_lvgl_mux, portMAX_DELAY);
+        UI_Port_Tick_Sync();
+        if (bits & (1u << UI_WAKE_TOUCH)) UI_Port_Touch_Resume();
+        if (bits & (1u << UI_WAKE_DATA)) UI_Main_Sync();
+        wait_ms = lv_timer_handler();
+        xSemaphoreGive(g_lvgl_mux);
+
+        UI_Port_Wake_Account(bits, (uint32_t)(esp_timer_get_time() - t0));
     }
 }
 
@@ -193,14 +212,62 @@ static void pc_uart_cmd_task(void *arg) {
                 }
             }
             // 4. CSI 算法动态切换
-            else if (strcmp(line, "csi1") == 0) {
+            else if (strcmp(line, "csi0") == 0) {
+                Dev_CSI_Set_Mode(0);
+            } else if (strcmp(line, "csi1") == 0) {
                 Dev_CSI_Set_Mode(1);
             } else if (strcmp(line, "csi2") == 0) {
                 Dev_CSI_Set_Mode(2);
             } else if (strcmp(line, "csi3") == 0) {
                 Dev_CSI_Set_Mode(3);
+            } else if (strcmp(line, "csi4") == 0) {
+                Dev_CSI_Set_Mode(4);
+            } else if (strcmp(line, "csical") == 0) {
+                Dev_CSI_Start_Calibration(0); // 空房标定 30s
+            } else if (strcmp(line, "csiprobe0") == 0) {
+                Dev_CSI_Set_Adaptive_Probe(false); // 固定 50ms 探测 (对照组)
+            } else if (strcmp(line, "csiprobe1") == 0) {
+                Dev_CSI_Set_Adaptive_Probe(true);  // 自适应探测速率
             } 
-            // 5. CRC 动态切换指令 (用于误码率拦截测试)
+            // 4.1 CSI 原始帧采集 (TCP 推流到 PC 端 csi_capture_receiver.py)
+            else if (strncmp(line, "csicap ", 7) == 0) {
+                char host[16] = {0};
+                unsigned int port = 0;
+                if (strcmp(line + 7, "off") == 0) {
+                    Dev_CSI_Capture_Stop();
+                } else if (sscanf(line + 7, "%15s %u", host, &port) == 2 && port > 0 && port < 65536) {
+                    Dev_CSI_Capture_Start(host, (uint16_t)port);
+                } else {
+                    ESP_LOGW(TAG, "Usage: csicap <ip> <port> | csicap off");
+                }
+            } else if (strncmp(line, "csilabel ", 9) == 0) {
+                Dev_CSI_Capture_Set_Label((uint8_t)atoi(line + 9));
+            }
+            // 5. STM32 环境光补偿 (格式: alc on | alc off | alc <目标 0-1000>)
+            else if (strcmp(line, "alc on") == 0) {
+                Dev_STM32_Set_ALC(1, -1);
+            } else if (strcmp(line, "alc off") == 0) {
+                Dev_STM32_Set_ALC(0, 0);
+            } else if (strncmp(line, "alc ", 4) == 0) {
+                int target = -1;
+                if (sscanf(line + 4, "%d", &target) == 1 && target >= 0 && target <= 1000) {
+                    Dev_STM32_Set_ALC(1, (int16_t)target);
+                } else {
+                    ESP_LOGW(TAG, "Usage: alc on | alc off | alc <0-1000>");
+                }
+            }
+            // 5.1 STM32 渐变 (格式: fade <亮度 0-1000> <色温 0-1000> <时长 ms> [缓动 0-3])
+            else if (strncmp(line, "fade ", 5) == 0) {
+                int bri = -1, cct = -1, ms = -1, ease = 3;
+                if (sscanf(line + 5, "%d %d %d %d", &bri, &cct, &ms, &ease) >= 3 &&
+                    bri >= 0 && bri <= 1000 && cct >= 0 && cct <= 1000 &&
+                    ms >= 0 && ms <= 60000 && ease >= 0 && ease <= 3) {
+                    Dev_STM32_Fade_Light((uint16_t)bri, (uint16_t)cct, (uint16_t)ms, (uint8_t)ease);
+                } else {
+                    ESP_LOGW(TAG, "Usage: fade <bri 0-1000> <cct 0-1000> <ms 0-60000> [ease 0-3]");
+                }
+            }
+            // 6. CRC 动态切换指令 (用于误码率拦截测试)
             else if (strcmp(line, "crc0") == 0) {
                 Dev_STM32_Set_CRC_Mode(0); // 恢复正常 CRC
             } else if (strcmp(line, "crc1") == 0) {
@@ -236,6 +303,7 @@ void app_main(void) {
     DataCenter_Init(); 
     Storage_NVS_Init();      // 初始化防抖定时器
     Storage_NVS_Load_All();  // 从 Flash 加载上次关机前的数据
+    Agent_MQTT_Outbox_Init(); // [新增] 发件箱先于 MQTT 客户端就绪，联网前产生的事件也能入队
 
     // 2. 初始化 Wi-Fi 信息结构体 (清空缓存)
     wifi_information_init();
@@ -251,6 +319,7 @@ void app_main(void) {
     };
     Dev_Audio_Init(&audio_cfg);
     Svc_Audio_Init();
+    Svc_WakeWord_Init(); // [新增] 唤醒词监听 (Core 1)
 
     // 4. 启动 GUI 任务 (绑定至 Core 1)
     xTaskCreatePinnedToCore(gui_task, "GUI_Task", 1024 * 8, NULL, 5, NULL, 1);
@@ -2,6 +2,7 @@
 
 import json
 import queue
+import time
 from typing import Any
 
 try:
@@ -22,6 +23,8 @@ class MqttService:
         self.ui_queue = ui_queue
         self.client: mqtt.Client | None = None
         self.topic_status = ""
+        # 控制序号：以毫秒时间戳为种子单调递增，面板重启后也不会小于设备记录的上次序号。
+        self._last_seq = 0
 
     def connect(self, profile: MqttProfile, topic_status: str) -> None:
         """按给定档案连接 broker，并启动网络循环线程。"""
@@ -61,6 +64,25 @@ class MqttService:
     def is_connected(self) -> bool:
         return bool(self.client and self.client.is_connected())
 
+    def next_seq(self) -> int:
+        """返回下一个控制序号（32 位回绕，设备端按差值比较）。"""
+        now_ms = int(time.time() * 1000) & 0xFFFFFFFF
+        diff = (now_ms - self._last_seq) & 0xFFFFFFFF
+        if diff == 0 or diff >= 0x80000000:
+            now_ms = (self._last_seq + 1) & 0xFFFFFFFF
+        self._last_seq = now_ms
+        return now_ms
+
+    def publish_batch(self, topic: str, entries: list[dict]) -> bool:
+        """发布批量信封：entries 为 [{"id": "esp32_001", "brightness": 80}, ...]。
+
+        每个条目自动补上 seq，设备只执行 id 与自身匹配的条目。
+        """
+        batch = [dict(item, seq=self.next_seq()) for item in entries if item.get("id")]
+        if not batch:
+            return False
+        return self.publish_json(topic, {"batch": batch})
+
     def publish_json(self, topic: str, payload: dict) -> bool:
         """发布 JSON 消息；成功返回 True。"""
         if not self.client or not self.client.is_connected():
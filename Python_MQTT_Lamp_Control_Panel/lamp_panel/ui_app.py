@@ -335,7 +335,9 @@ class LampControlPanelApp:
     def _publish_control(self, partial_payload: dict) -> None:
         if not partial_payload:
             return
-        self.mqtt_service.publish_json(self.config.topic_ctrl, partial_payload)
+        # 控制主题可以是单灯主题，也可以是组播主题（如 device/lamp/group/floor1）。
+        payload = dict(partial_payload, seq=self.mqtt_service.next_seq())
+        self.mqtt_service.publish_json(self.config.topic_ctrl, payload)
 
     def on_power_toggle(self) -> None:
         if self.updating_from_device:
@@ -0,0 +1,211 @@
+﻿#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""群控仿真：在本机启动 N 个虚拟灯，测量组播/批量指令的扇出延迟。
+
+虚拟灯的解析逻辑与固件 agent_mqtt.c 保持一致：
+- 订阅 device/lamp/group/<zone> 与 device/lamp/group/all；
+- 批量信封只执行 id 与自身匹配的条目；
+- seq 不大于上次已执行序号（且在过期窗口内）的指令被丢弃。
+
+所有虚拟灯与控制端运行在同一进程，直接用 perf_counter 计算“发布 -> 灯收到”的延迟。
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import statistics
+import threading
+import time
+
+try:
+    import paho.mqtt.client as mqtt
+except ImportError as exc:  # pragma: no cover
+    raise SystemExit("缺少依赖库 paho-mqtt，请先执行：pip install paho-mqtt") from exc
+
+GROUP_PREFIX = "device/lamp/group/"
+SEQ_STALE_WINDOW = 100000  # 与固件 MQTT_SEQ_STALE_WINDOW 一致
+
+
+def make_client(client_id: str) -> mqtt.Client:
+    """兼容 paho-mqtt 1.x / 2.x 的客户端构造。"""
+    if hasattr(mqtt, "CallbackAPIVersion"):
+        return mqtt.Client(mqtt.CallbackAPIVersion.VERSION1, client_id=client_id, protocol=mqtt.MQTTv311)
+    return mqtt.Client(client_id=client_id, protocol=mqtt.MQTTv311)
+
+
+class VirtualLamp:
+    """单个虚拟灯。"""
+
+    def __init__(self, device_id: str, zone: str, broker: str, port: int, recorder: "LatencyRecorder") -> None:
+        self.device_id = device_id
+        self.zone = zone
+        self.recorder = recorder
+        self.state = {"power": 0, "brightness": 50, "color_temp": 50}
+        self.last_seq: int | None = None
+        self.dropped = 0
+
+        self.client = make_client(f"sim_{device_id}")
+        self.client.on_connect = self._on_connect
+        self.client.on_message = self._on_message
+        self.client.connect(broker, port, keepalive=60)
+        self.client.loop_start()
+
+    def stop(self) -> None:
+        self.client.loop_stop()
+        self.client.disconnect()
+
+    def _on_connect(self, client: mqtt.Client, _userdata, _flags, rc: int) -> None:
+        if rc == 0:
+            client.subscribe([(GROUP_PREFIX + self.zone, 1), (GROUP_PREFIX + "all", 1)])
+            self.recorder.mark_ready(self.device_id)
+
+    def _seq_accept(self, cmd: dict) -> bool:
+        if "seq" not in cmd:
+            return True
+        seq = int(cmd["seq"]) & 0xFFFFFFFF
+        if self.last_seq is not None:
+            diff = (seq - self.last_seq) & 0xFFFFFFFF
+            if diff >= 0x80000000:
+                diff -= 0x100000000
+            if -SEQ_STALE_WINDOW < diff <= 0:
+                self.dropped += 1
+                return False
+        self.last_seq = seq
+        return True
+
+    def _on_message(self, _client: mqtt.Client, _userdata, msg) -> None:
+        t_recv = time.perf_counter()
+        try:
+            data = json.loads(msg.payload.decode("utf-8"))
+        except (ValueError, UnicodeDecodeError):
+            return
+
+        cmd = data
+        if isinstance(data.get("batch"), list):
+            cmd = next((item for item in data["batch"] if item.get("id") == self.device_id), None)
+            if cmd is None:
+                return
+
+        if not self._seq_accept(cmd):
+            return
+        for key in ("power", "brightness", "color_temp"):
+            if key in cmd:
+                self.state[key] = int(cmd[key])
+        if "t_sent" in data:
+            self.recorder.add(data.get("round", -1), t_recv - float(data["t_sent"]))
+
+
+class LatencyRecorder:
+    """线程安全的延迟收集器。"""
+
+    def __init__(self) -> None:
+        self.lock = threading.Lock()
+        self.samples: list[float] = []
+        self.per_round: dict[int, int] = {}
+        self.ready: set[str] = set()
+
+    def mark_ready(self, device_id: str) -> None:
+        with self.lock:
+            self.ready.add(device_id)
+
+    def add(self, round_idx: int, latency_s: float) -> None:
+        with self.lock:
+            self.samples.append(latency_s * 1000.0)
+            self.per_round[round_idx] = self.per_round.get(round_idx, 0) + 1
+
+    def count(self, round_idx: int) -> int:
+        with self.lock:
+            return self.per_round.get(round_idx, 0)
+
+
+def percentile(sorted_vals: list[float], pct: float) -> float:
+    if not sorted_vals:
+        return float("nan")
+    idx = min(len(sorted_vals) - 1, max(0, int(round(pct / 100.0 * (len(sorted_vals) - 1)))))
+    return sorted_vals[idx]
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="智能灯群控仿真（扇出延迟统计）")
+    parser.add_argument("--broker", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--lamps", type=int, default=20, help="虚拟灯数量")
+    parser.add_argument("--zone", default="floor1")
+    parser.add_argument("--rounds", type=int, default=20, help="发送轮数")
+    parser.add_argument("--interval", type=float, default=0.5, help="每轮间隔（秒）")
+    parser.add_argument("--mode", choices=("group", "batch"), default="group",
+                        help="group: 每轮一条组播；batch: 每轮一条批量信封（每灯独立参数）")
+    parser.add_argument("--reorder", action="store_true",
+                        help="每轮额外重发上一轮的旧序号，验证过期指令被丢弃")
+    return parser.parse_args()
+
+
+def main() -> None:
+    args = parse_args()
+    recorder = LatencyRecorder()
+    lamps = [
+        VirtualLamp(f"sim_{i:03d}", args.zone, args.broker, args.port, recorder)
+        for i in range(args.lamps)
+    ]
+
+    deadline = time.time() + 10
+    while len(recorder.ready) < args.lamps and time.time() < deadline:
+        time.sleep(0.05)
+    print(f"[仿真] {len(recorder.ready)}/{args.lamps} 个虚拟灯已连接")
+
+    ctrl = make_client("sim_controller")
+    ctrl.connect(args.broker, args.port, keepalive=60)
+    ctrl.loop_start()
+    topic = GROUP_PREFIX + args.zone
+
+    seq = int(time.time() * 1000) & 0xFFFFFFFF
+    last_payload = None
+    lost = 0
+    for r in range(args.rounds):
+        seq = (seq + 1) & 0xFFFFFFFF
+        brightness = 10 + (r * 37) % 90
+        if args.mode == "group":
+            payload = {"seq": seq, "brightness": brightness}
+        else:
+            payload = {
+                "batch": [
+                    {"id": lamp.device_id, "seq": seq, "brightness": (brightness + i) % 101}
+                    for i, lamp in enumerate(lamps)
+                ]
+            }
+        payload["round"] = r
+        payload["t_sent"] = time.perf_counter()
+        ctrl.publish(topic, json.dumps(payload), qos=1)
+
+        if args.reorder and last_payload is not None:
+            stale = dict(last_payload, round=-1, t_sent=time.perf_counter())
+            ctrl.publish(topic, json.dumps(stale), qos=1)
+        last_payload = payload
+
+        wait_until = time.time() + max(args.interval, 1.0)
+        while recorder.count(r) < args.lamps and time.time() < wait_until:
+            time.sleep(0.005)
+        lost += args.lamps - recorder.count(r)
+        time.sleep(max(0.0, args.interval - 0.005))
+
+    ctrl.loop_stop()
+    ctrl.disconnect()
+    for lamp in lamps:
+        lamp.stop()
+
+    vals = sorted(recorder.samples)
+    print(f"[结果] 模式={args.mode} 灯数={args.lamps} 轮数={args.rounds} 样本={len(vals)} 丢失={lost}")
+    if vals:
+        print(
+            "[延迟] "
+            f"p50={percentile(vals, 50):.2f} ms  p90={percentile(vals, 90):.2f} ms  "
+            f"p99={percentile(vals, 99):.2f} ms  max={vals[-1]:.2f} ms  mean={statistics.mean(vals):.2f} ms"
+        )
+    if args.reorder:
+        dropped = sum(lamp.dropped for lamp in lamps)
+        print(f"[序号] 过期指令丢弃 {dropped} 次（期望 {args.lamps * max(0, args.rounds - 1)}）")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,105 @@
+"""CSI 原始帧采集文件的加载工具 (numpy memmap)。
+
+采集目录由 csi_capture_receiver.py 生成，按列存储:
+    meta.json       格式说明 (列名 -> dtype, I/Q 定长步长)
+    ts_us.bin       uint64   设备端 esp_timer 时间戳 (us)
+    seq.bin         uint32   设备端帧序号 (不连续处即为丢帧)
+    rssi.bin        int8
+    channel.bin     uint8
+    label.bin       uint8    csilabel 指令设置的标注 (0 = 未标注)
+    flags.bin       uint8    bit0: 本帧之前设备端有丢帧
+    iq_len.bin      uint16   本帧有效 I/Q 字节数
+    iq.bin          int8     [N, iq_stride]，不足部分补 0
+
+用法:
+    from csi_capture_loader import load_capture, amplitudes
+    cap = load_capture('data/csi_capture_20260101_120000')
+    amp = amplitudes(cap)          # [N, iq_stride // 2]，与固件 |I|+|Q| 一致
+"""
+
+import json
+import os
+
+import numpy as np
+
+FORMAT_NAME = 'csi-columnar-v1'
+IQ_STRIDE = 384     # 与固件 CSI_CAP_MAX_IQ 一致
+
+COLUMNS = {
+    'ts_us': '<u8',
+    'seq': '<u4',
+    'rssi': 'i1',
+    'channel': 'u1',
+    'label': 'u1',
+    'flags': 'u1',
+    'iq_len': '<u2',
+}
+
+LABEL_NAMES = {0: '未标注', 1: '无人', 2: '静止', 3: '微动', 4: '活动'}
+
+
+def write_meta(path, count):
+    meta = {
+        'format': FORMAT_NAME,
+        'count': int(count),
+        'iq_stride': IQ_STRIDE,
+        'columns': dict(COLUMNS, iq='i1'),
+        'labels': LABEL_NAMES,
+    }
+    with open(os.path.join(path, 'meta.json'), 'w', encoding='utf-8') as f:
+        json.dump(meta, f, ensure_ascii=False, indent=2)
+
+
+def load_capture(path):
+    """把采集目录以只读 memmap 方式映射为 {列名: ndarray}，不把数据读入内存。
+
+    行数以 ts_us.bin 的实际长度为准 (接收端异常退出时 meta.json 里的 count 可能偏小)，
+    各列取最短长度，保证半写入的末尾记录被忽略。
+    """
+    with open(os.path.join(path, 'meta.json'), 'r', encoding='utf-8') as f:
+        meta = json.load(f)
+    if meta.get('format') != FORMAT_NAME:
+        raise ValueError(f"不支持的采集格式: {meta.get('format')}")
+
+    stride = int(meta['iq_stride'])
+    sizes = {}
+    for name, dtype in meta['columns'].items():
+        fn = os.path.join(path, f'{name}.bin')
+        item = np.dtype(dtype).itemsize * (stride if name == 'iq' else 1)
+        sizes[name] = os.path.getsize(fn) // item if os.path.exists(fn) else 0
+    n = min(sizes.values())
+
+    cap = {}
+    for name, dtype in meta['columns'].items():
+        fn = os.path.join(path, f'{name}.bin')
+        shape = (n, stride) if name == 'iq' else (n,)
+        cap[name] = np.memmap(fn, dtype=dtype, mode='r', shape=shape) if n else np.zeros(shape, dtype=dtype)
+    return cap
+
+
+def amplitudes(cap, rows=slice(None)):
+    """每个子载波的 |I|+|Q| (与固件 csi_frame_t.amps 相同定义)，返回 uint16 [N, iq_stride // 2]。"""
+    iq = np.asarray(cap['iq'][rows], dtype=np.int16)
+    return (np.abs(iq[:, 0::2]) + np.abs(iq[:, 1::2])).astype(np.uint16)
+
+
+def summary(cap):
+    """打印采集概况: 时长、帧率、丢帧、各标注的帧数。"""
+    n = len(cap['ts_us'])
+    if n == 0:
+        print("采集为空")
+        return
+    dur = (int(cap['ts_us'][-1]) - int(cap['ts_us'][0])) / 1e6
+    seq = cap['seq'].astype(np.int64)
+    lost = int(np.sum(np.maximum(np.diff(seq) - 1, 0))) if n > 1 else 0
+    print(f"帧数: {n} | 时长: {dur:.1f}s | 平均帧率: {n / dur if dur > 0 else 0:.1f} 帧/s | 丢帧: {lost}")
+    labels, counts = np.unique(cap['label'], return_counts=True)
+    for lab, cnt in zip(labels, counts):
+        print(f"  标注 {LABEL_NAMES.get(int(lab), lab)}: {cnt} 帧")
+
+
+if __name__ == '__main__':
+    import argparse
+    parser = argparse.ArgumentParser(description='查看 CSI 采集目录概况')
+    parser.add_argument('path', help='csi_capture_receiver.py 生成的采集目录')
+    summary(load_capture(parser.parse_args().path))
@@ -0,0 +1,142 @@
+"""CSI 原始帧 TCP 接收器: 接收 ESP32 `csicap <ip> <port>` 推送的二进制帧，按列落盘。
+
+线上记录格式与固件 dev_csi_capture.h 一致 (小端):
+    u16 magic(0xC5A1) | u16 iq_len | u32 seq | u64 ts_us | i8 rssi | u8 channel | u8 label | u8 flags
+    | int8 iq[iq_len] | u16 crc16 (XMODEM, 覆盖帧头 + iq)
+
+断线重连时 TCP 流里可能残留半条记录，接收端按 magic + CRC 重新同步。
+产出目录可用 csi_capture_loader.load_capture() 以 numpy memmap 方式加载。
+"""
+
+import argparse
+import os
+import socket
+import struct
+import time
+
+import numpy as np
+
+from csi_capture_loader import COLUMNS, IQ_STRIDE, write_meta
+
+MAGIC = 0xC5A1
+HEADER = struct.Struct('<HHIQbBBB')
+MAGIC_BYTES = struct.pack('<H', MAGIC)
+META_FLUSH_S = 5.0
+
+
+def crc16_xmodem(data):
+    """与固件 CRC16_Calculate 相同 (Poly 0x1021, Init 0x0000)。"""
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+class ColumnWriter:
+    """按列追加写文件。"""
+
+    def __init__(self, path):
+        self.path = path
+        os.makedirs(path, exist_ok=True)
+        self.files = {name: open(os.path.join(path, f'{name}.bin'), 'ab') for name in list(COLUMNS) + ['iq']}
+        self.count = 0
+        self.last_meta = 0.0
+        write_meta(path, 0)
+
+    def append(self, fields, iq):
+        for name, dtype in COLUMNS.items():
+            self.files[name].write(np.asarray(fields[name], dtype=dtype).tobytes())
+        row = np.zeros(IQ_STRIDE, dtype=np.int8)
+        row[:len(iq)] = np.frombuffer(iq, dtype=np.int8)
+        self.files['iq'].write(row.tobytes())
+        self.count += 1
+
+    def sync(self, force=False):
+        """刷新到磁盘 (每批数据后调用)，meta.json 每 5s 更新一次，进程被杀也能加载已收数据。"""
+        for f in self.files.values():
+            f.flush()
+        if force or time.time() - self.last_meta > META_FLUSH_S:
+            write_meta(self.path, self.count)
+            self.last_meta = time.time()
+
+    def close(self):
+        self.sync(force=True)
+        for f in self.files.values():
+            f.close()
+
+
+def parse_stream(buf, writer, stats):
+    """从缓冲区中解析尽可能多的完整记录，返回未消费的剩余字节。"""
+    pos = 0
+    while True:
+        idx = buf.find(MAGIC_BYTES, pos)
+        if idx < 0:
+            return buf[-1:] if buf else buf     # 保留最后 1 字节，magic 可能跨包
+        if len(buf) - idx < HEADER.size:
+            return buf[idx:]
+        magic, iq_len, seq, ts_us, rssi, channel, label, flags = HEADER.unpack_from(buf, idx)
+        if iq_len > IQ_STRIDE:
+            stats['resync'] += 1
+            pos = idx + 1
+            continue
+        end = idx + HEADER.size + iq_len + 2
+        if len(buf) < end:
+            return buf[idx:]
+        crc = struct.unpack_from('<H', buf, end - 2)[0]
+        if crc != crc16_xmodem(buf[idx:end - 2]):
+            stats['crc_err'] += 1
+            pos = idx + 1
+            continue
+        writer.append({'ts_us': ts_us, 'seq': seq, 'rssi': rssi, 'channel': channel,
+                       'label': label, 'flags': flags, 'iq_len': iq_len},
+                      buf[idx + HEADER.size:end - 2])
+        stats['frames'] += 1
+        pos = end
+
+
+def main():
+    parser = argparse.ArgumentParser(description='CSI 原始帧 TCP 接收器 (按列落盘)')
+    parser.add_argument('--port', type=int, default=5566, help='监听端口 (与 csicap 指令一致)')
+    parser.add_argument('--out', default=None, help='输出目录，默认 data/csi_capture_<时间>')
+    args = parser.parse_args()
+
+    out = args.out or os.path.join('data', time.strftime('csi_capture_%Y%m%d_%H%M%S'))
+    writer = ColumnWriter(out)
+    stats = {'frames': 0, 'crc_err': 0, 'resync': 0}
+
+    srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    srv.bind(('0.0.0.0', args.port))
+    srv.listen(1)
+    print(f"[接收] 监听 0.0.0.0:{args.port}，输出目录 {out}，Ctrl+C 结束")
+
+    last_print = time.time()
+    try:
+        while True:
+            conn, addr = srv.accept()
+            print(f"[接收] 设备已连接: {addr[0]}")
+            buf = b''
+            with conn:
+                while True:
+                    data = conn.recv(65536)
+                    if not data:
+                        break
+                    buf = parse_stream(buf + data, writer, stats)
+                    writer.sync()
+                    if time.time() - last_print > 5:
+                        print(f"[接收] 帧: {stats['frames']} | CRC 错误: {stats['crc_err']} | 重同步: {stats['resync']}")
+                        last_print = time.time()
+            print("[接收] 连接断开，等待重连...")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        writer.close()
+        srv.close()
+        print(f"✅ 已保存 {writer.count} 帧到 {out}")
+
+
+if __name__ == '__main__':
+    main()
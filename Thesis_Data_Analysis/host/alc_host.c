@@ -0,0 +1,247 @@
+/**
+ * 主机端环境光补偿 (ALC) 闭环仿真: 直接编译固件的 ALC.c，LDR 采样链与 LightCtrl 的调用节奏
+ * 按固件复现，被控对象用下面的桌面照度模型代替。
+ *
+ * 被控对象 (1ms 步长):
+ *   - 桌面照度 E = 环境光 + 台灯满亮照度 x 亮度/1000 (x 灯效系数 gain，覆盖不同灯高 / 桌面反射率)
+ *   - 光敏电阻: R = R10 * (E/10)^-gamma，一阶响应 tau = 20ms；与 10k 分压，亮处电压高
+ *   - ADC: 4kHz 采样 + 均匀噪声，40 点块平均 x16 + 一阶 IIR (与 LDR.c 相同的整数运算)
+ *   - 控制器: 每 ALC_PERIOD_MS 读取 0~1000 测量值执行一次 ALC_Step，输出立即作用到 PWM
+ *
+ * 场景 (600s，把一天的日照变化压缩进来):
+ *     0~ 60s  夜间 (环境 20 lx)，t=0 从 30% 亮度开启 ALC -> 阶跃响应 (超调 / 调节时间)
+ *    60~540s  日照按正弦升到 650 lx 再落下，叠加 3 次云遮 (2s 内降 60%，持续 20~40s)
+ *   540~600s  夜间，t=560s 房间顶灯打开 (+200 lx 阶跃)
+ *
+ * 输出一行指标 (CSV 格式，无表头):
+ *   gain,kp,ki,step,db,overshoot,settle_s,iae,reversals,hold_pp,max_rate,energy_alc,energy_fixed,saved_pct
+ *   overshoot  阶跃段测量值超过目标的最大量 (0~1000 量纲)
+ *   reversals  输出方向反转 (反向摆动 >= VISIBLE_SWING) 次数减去理想输出的反转次数，
+ *              理想输出 = 每个控制周期按静态模型反解出的亮度，多出来的反转即可见振荡
+ *   iae        |测量 - 目标| 对时间的积分 (0~1000 量纲 x 秒)，只统计目标可达的时刻
+ *              (日光已超过目标、灯已在 ALC_MIN_BRI 时的误差不是控制器造成的)
+ *   hold_pp    环境光恒定段 (40~60s, 580~600s) 输出峰峰值的较大者
+ *   max_rate   输出最大变化速率 (每秒)
+ *   energy_*   亮度对时间的积分 (PWM 功率近似正比于亮度)；fixed = 夜间达到目标所需的固定亮度
+ *
+ * 用法: alc_host <轨迹 CSV 或 -> <灯效 %> [kp_q8 ki_q8 max_step deadband]
+ * 省略控制参数时使用 Config.h 中的 ALC_*。
+ * (由 sim_7_1_7_alc_daylight.py 编译并运行)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Config.h"
+#include "ALC.h"
+
+#define SIM_MS              600000
+#define LAMP_FULL_LUX       500.0   // 满亮时灯在桌面产生的照度 (gain = 100%)
+#define NIGHT_LUX           20.0
+#define LDR_R10             20000.0 // 10 lx 时的阻值 (GL5528 量级)
+#define LDR_GAMMA           0.7
+#define LDR_RFIX            10000.0
+#define LDR_TAU_MS          20.0
+#define ADC_NOISE_LSB       20
+#define VISIBLE_SWING       10      // 1% 亮度
+#define START_BRI           300
+
+static uint32_t s_Rand = 12345;
+
+static int RandNoise(int amp)
+{
+    s_Rand = s_Rand * 1103515245u + 12345u;
+    return (int)((s_Rand >> 8) % (uint32_t)(2 * amp + 1)) - amp;
+}
+
+/** @brief 环境光照度 (lx) */
+static double Ambient(int ms)
+{
+    double t = ms / 1000.0;
+
+    if (t < 60.0 || t >= 540.0)
+    {
+        return NIGHT_LUX + ((t >= 560.0) ? 200.0 : 0.0);
+    }
+
+    double day = NIGHT_LUX + 630.0 * sin(M_PI * (t - 60.0) / 480.0);
+    static const double clouds[][2] = { { 150.0, 30.0 }, { 260.0, 40.0 }, { 400.0, 20.0 } };
+    for (unsigned i = 0; i < sizeof(clouds) / sizeof(clouds[0]); i++)
+    {
+        double t0 = clouds[i][0], t1 = clouds[i][0] + clouds[i][1];
+        double k = 0.0;
+        if (t >= t0 && t < t1)           k = fmin((t - t0) / 2.0, 1.0);
+        else if (t >= t1 && t < t1 + 2.0) k = 1.0 - (t - t1) / 2.0;
+        day *= 1.0 - 0.6 * k;
+    }
+    return day;
+}
+
+/** @brief 照度 -> ADC 值 (0~4095，无噪声) */
+static double LdrAdc(double lux)
+{
+    if (lux < 0.1) lux = 0.1;
+    double r = LDR_R10 * pow(lux / 10.0, -LDR_GAMMA);
+    return 4095.0 * LDR_RFIX / (LDR_RFIX + r);
+}
+
+/** @brief 与 LDR_GetLuxPercentage 相同的 0~1000 映射 */
+static int16_t Meas(double lux)
+{
+    uint32_t filt = (uint32_t)(LdrAdc(lux) * 16.0);
+    return (int16_t)((filt * 1000) / 65520);
+}
+
+/** @brief 静态模型反解: 环境光 amb 下达到 target 的最小亮度 (二分，结果限制在 [min_bri, 1000]) */
+static int BriFor(double amb, double gain, int16_t target, int min_bri)
+{
+    int lo = min_bri, hi = 1000;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (Meas(amb + gain * LAMP_FULL_LUX * mid / 1000.0) >= target) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+/** @brief 带回差的方向反转计数: 反向摆动超过 VISIBLE_SWING 才算一次反转 */
+typedef struct {
+    int Dir;        // 1 上升, -1 下降, 0 未定
+    int Extreme;    // 当前方向上的极值
+    int Count;
+} Reversal_t;
+
+static void Reversal_Update(Reversal_t *r, int v)
+{
+    if ((r->Dir >= 0 && v > r->Extreme) || (r->Dir <= 0 && v < r->Extreme))
+    {
+        if (r->Dir == 0 && abs(v - r->Extreme) >= VISIBLE_SWING) r->Dir = (v > r->Extreme) ? 1 : -1;
+        if (r->Dir != 0) r->Extreme = v;
+        return;
+    }
+    if (r->Dir != 0 && abs(v - r->Extreme) >= VISIBLE_SWING)
+    {
+        r->Count++;
+        r->Dir = -r->Dir;
+        r->Extreme = v;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3 && argc != 7)
+    {
+        fprintf(stderr, "usage: %s <trace.csv|-> <gain_pct> [kp_q8 ki_q8 max_step deadband]\n", argv[0]);
+        return 2;
+    }
+    double gain = atoi(argv[2]) / 100.0;
+    int16_t kp = ALC_KP_Q8, ki = ALC_KI_Q8, step = ALC_MAX_STEP, db = ALC_DEADBAND;
+    if (argc == 7)
+    {
+        kp = (int16_t)atoi(argv[3]);
+        ki = (int16_t)atoi(argv[4]);
+        step = (int16_t)atoi(argv[5]);
+        db = (int16_t)atoi(argv[6]);
+    }
+
+    FILE *trace = NULL;
+    if (argv[1][0] != '-')
+    {
+        trace = fopen(argv[1], "w");
+        if (!trace) { perror(argv[1]); return 2; }
+        fprintf(trace, "t_s,ambient_lux,desk_lux,meas,target,bri\n");
+    }
+
+    // 目标 = 夜间 60% 亮度时的读数，ALC 从 30% 亮度开始 -> 阶跃响应
+    int16_t target = Meas(NIGHT_LUX + gain * LAMP_FULL_LUX * 0.6);
+
+    // 固定亮度基准: 夜间达到同一目标所需的亮度
+    int bri_fixed = BriFor(NIGHT_LUX, gain, target, 0);
+
+    ALC_t alc;
+    ALC_Init(&alc, kp, ki, step, db, ALC_MIN_BRI, 1000);
+    ALC_Reset(&alc, START_BRI);
+    int16_t bri = START_BRI;
+
+    double ldr_lux = NIGHT_LUX + gain * LAMP_FULL_LUX * bri / 1000.0;
+    uint32_t sum = 0, iir_acc = 0;
+    uint16_t filtered = 0;
+    int n = 0, first_block = 1;
+
+    int overshoot = 0, settle_ms = -1, max_rate = 0;
+    double iae = 0.0, energy = 0.0;
+    int hold_min[2] = { 1000, 1000 }, hold_max[2] = { 0, 0 };
+    int ideal = BriFor(NIGHT_LUX, gain, target, ALC_MIN_BRI);
+    Reversal_t rev = { 0, START_BRI, 0 };
+    Reversal_t rev_ideal = { 0, START_BRI, 0 };     // 理想输出同样从 START_BRI 出发
+    int16_t prev_bri = bri;
+
+    for (int ms = 0; ms < SIM_MS; ms++)
+    {
+        double amb = Ambient(ms);
+        double desk = amb + gain * LAMP_FULL_LUX * bri / 1000.0;
+        ldr_lux += (desk - ldr_lux) / LDR_TAU_MS;
+
+        // 4kHz ADC，每 LDR_BLOCK_SAMPLES 点一块，块平均 + IIR 与 LDR_ProcessBlock 一致
+        for (int s = 0; s < LDR_SAMPLE_RATE_HZ / 1000; s++)
+        {
+            int adc = (int)LdrAdc(ldr_lux) + RandNoise(ADC_NOISE_LSB);
+            if (adc < 0) adc = 0;
+            if (adc > 4095) adc = 4095;
+            sum += (uint32_t)adc;
+            if (++n == LDR_BLOCK_SAMPLES)
+            {
+                uint16_t x = (uint16_t)((sum * 16u) / LDR_BLOCK_SAMPLES);
+                if (first_block) { iir_acc = (uint32_t)x << LDR_IIR_SHIFT; first_block = 0; }
+                else iir_acc = iir_acc - (iir_acc >> LDR_IIR_SHIFT) + x;
+                filtered = (uint16_t)(iir_acc >> LDR_IIR_SHIFT);
+                sum = 0;
+                n = 0;
+            }
+        }
+        int16_t meas = (int16_t)(((uint32_t)filtered * 1000) / 65520);
+
+        if (ms % ALC_PERIOD_MS == 0 && !first_block)
+        {
+            bri = ALC_Step(&alc, target, meas);
+
+            int rate = abs(bri - prev_bri) * (1000 / ALC_PERIOD_MS);
+            if (rate > max_rate) max_rate = rate;
+            prev_bri = bri;
+
+            Reversal_Update(&rev, bri);
+            ideal = BriFor(amb, gain, target, ALC_MIN_BRI);
+            Reversal_Update(&rev_ideal, ideal);
+        }
+
+        if (ms < 60000)
+        {
+            if (meas - target > overshoot) overshoot = meas - target;
+            if (abs(meas - target) > 20) settle_ms = -1;
+            else if (settle_ms < 0) settle_ms = ms;
+        }
+        if ((ms >= 40000 && ms < 60000) || ms >= 580000)
+        {
+            int w = (ms >= 580000);
+            if (bri < hold_min[w]) hold_min[w] = bri;
+            if (bri > hold_max[w]) hold_max[w] = bri;
+        }
+        if (ms >= 10000 && ideal > ALC_MIN_BRI && ideal < 1000) iae += abs(meas - target) / 1000.0;
+        energy += bri / 1000.0;
+
+        if (trace && ms % 100 == 0)
+        {
+            fprintf(trace, "%.1f,%.1f,%.1f,%d,%d,%d\n", ms / 1000.0, amb, desk, meas, target, bri);
+        }
+    }
+    if (trace) fclose(trace);
+
+    double energy_fixed = bri_fixed * (SIM_MS / 1000.0);
+    int hold_pp = hold_max[0] - hold_min[0];
+    if (hold_max[1] - hold_min[1] > hold_pp) hold_pp = hold_max[1] - hold_min[1];
+    printf("%d,%d,%d,%d,%d,%d,%.2f,%.1f,%d,%d,%d,%.1f,%.1f,%.1f\n",
+           (int)(gain * 100), kp, ki, step, db, overshoot,
+           settle_ms < 0 ? -1.0 : settle_ms / 1000.0, iae, rev.Count - rev_ideal.Count, hold_pp, max_rate,
+           energy, energy_fixed, 100.0 * (1.0 - energy / energy_fixed));
+    return 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * 主机端 ControlManager → LightCtrl → LED 渐变调用链测试: 直接编译固件的 ControlManager.c、LightCtrl.c、ALC.c、
+ * EventBus.c、SystemModel.c，LED / LDR / 协议 / 串口在本文件中打桩，记录每次 LED_FadeTo 的参数。
+ * 事件经真实的 EventBus 投递与分发，与 main.c 中的调用顺序一致。
+ * LED_IsFading 固定返回 0 (渐变早已结束)，这正是 "目标与输出相同则跳过" 最容易误判的情况。
+ *
+ *   unit:  固定用例 (近距调光调亮度 / 色温每个新目标都驱动 LED、目标不变时不重复渐变、
+ *          远程 light 回显与当前输出相同时跳过、不同时渐变)
+ *
+ * 输出 (stdout，逐行): case,<name>,<ok>   (失败时前面另有 fail,<name>,<line>,<条件>)
+ * 用法: control_fade_host unit
+ * 任一用例失败，退出码 1。(由 sim_7_1_9_led_fade.py 编译并运行)
+ */
+#include <stdio.h>
+#include <string.h>
+#include "ControlManager.h"
+#include "LightCtrl.h"
+#include "EventBus.h"
+#include "SystemModel.h"
+#include "Protocol.h"
+#include "PAJ7620.h"
+#include "LED.h"
+#include "LDR.h"
+#include "Config.h"
+
+/* ---------------- 外设 / 服务替身 ---------------- */
+GPIO_TypeDef Host_GPIOB;
+I2C_TypeDef Host_I2C1, Host_I2C2;
+
+static uint32_t s_Tick;
+uint32_t System_GetTick(void) { return s_Tick; }
+
+int USART_DMA_Printf(const char *fmt, ...) { (void)fmt; return 1; }
+
+static uint32_t s_LedCalls;
+static uint16_t s_LedBri, s_LedCct;
+static uint32_t s_LedMs;
+
+void LED_Init(void) {}
+void LED_Mix_Init(uint16_t warm_flux, uint16_t cold_flux) { (void)warm_flux; (void)cold_flux; }
+uint8_t LED_IsFading(void) { return 0; }
+
+void LED_FadeTo(uint16_t bri, uint16_t cct, uint32_t ms, uint8_t ease)
+{
+    (void)ease;
+    s_LedCalls++;
+    s_LedBri = bri;
+    s_LedCct = cct;
+    s_LedMs = ms;
+}
+
+uint16_t LDR_GetLuxPercentage(void) { return 500; }
+
+static Proto_LightCallback_t s_LightCb;
+void Protocol_SetModeCallback(Proto_ModeCallback_t cb) { (void)cb; }
+void Protocol_SetLightCallback(Proto_LightCallback_t cb) { s_LightCb = cb; }
+void Protocol_SetALCCallback(Proto_ALCCallback_t cb) { (void)cb; }
+void Protocol_SetFadeCallback(Proto_FadeCallback_t cb) { (void)cb; }
+void Protocol_Report_Encoder(int16_t diff) { (void)diff; }
+void Protocol_Report_Key(const char *name, const char *action) { (void)name; (void)action; }
+void Protocol_Report_Gesture(uint8_t gesture) { (void)gesture; }
+void Protocol_Report_State(uint16_t warm, uint16_t cold) { (void)warm; (void)cold; }
+
+/* ---------------- 运行 ---------------- */
+static void Post(EventType_t type, int16_t value)
+{
+    EventBus_Post(type, 0, value, 0);
+    EventBus_Dispatch_Task();
+}
+
+/** @brief 近距调光一个目标: 间隔超过 50ms 的更新节流，返回期望的输出值 */
+static uint16_t Prox(uint8_t brightness)
+{
+    s_Tick += 60;
+    Post(EVT_PROXIMITY, brightness);
+    return (uint16_t)((brightness > 20) ? (brightness - 20) * 5 : 0);
+}
+
+/** @brief 从固定的初始状态进入近距调光 */
+static void EnterProximity(LightFocus_t focus)
+{
+    s_Tick += 1000;
+    LightCtrl_SetLevel(300, 500);
+    g_SystemModel.Light.Focus = focus;
+    Post(EVT_GESTURE, PAJ7620_GESTURE_FORWARD);
+    s_LedCalls = 0;
+}
+
+/* ---------------- unit ---------------- */
+static const char *s_Case;
+static int s_CaseFail, s_AnyFail;
+
+#define CHECK(c) do { if (!(c)) { printf("fail,%s,%d,%s\n", s_Case, __LINE__, #c); s_CaseFail = 1; } } while (0)
+
+static void Begin(const char *name) { s_Case = name; s_CaseFail = 0; }
+static void End(void) { printf("case,%s,%d\n", s_Case, !s_CaseFail); s_AnyFail |= s_CaseFail; }
+
+/** @brief 焦点在亮度: 每个新的手掌距离都以 FADE_PROX_MS 驱动 LED，色温不变，模型跟随输出 */
+static void Case_ProxBrightness(void)
+{
+    Begin("prox_brightness");
+    EnterProximity(FOCUS_BRIGHTNESS);
+    for (uint8_t v = 60; v <= 200; v += 20)
+    {
+        uint32_t calls = s_LedCalls;
+        uint16_t want = Prox(v);
+        CHECK(s_LedCalls == calls + 1);
+        CHECK(s_LedBri == want && s_LedCct == 500 && s_LedMs == FADE_PROX_MS);
+        CHECK(g_SystemModel.Light.Brightness == (int16_t)want && g_SystemModel.Light.ColorTemp == 500);
+    }
+    Post(EVT_PROXIMITY_EXIT, 0);
+    End();
+}
+
+/** @brief 焦点在色温: 调色温，亮度不变 */
+static void Case_ProxColorTemp(void)
+{
+    Begin("prox_color_temp");
+    EnterProximity(FOCUS_COLOR_TEMP);
+    for (uint8_t v = 200; v >= 60; v -= 20)
+    {
+        uint32_t calls = s_LedCalls;
+        uint16_t want = Prox(v);
+        CHECK(s_LedCalls == calls + 1);
+        CHECK(s_LedBri == 300 && s_LedCct == want);
+        CHECK(g_SystemModel.Light.ColorTemp == (int16_t)want);
+    }
+    Post(EVT_PROXIMITY_EXIT, 0);
+    g_SystemModel.Light.Focus = FOCUS_BRIGHTNESS;
+    End();
+}
+
+/** @brief 手掌停住: 目标与输出相同，不重复启动渐变 */
+static void Case_ProxHold(void)
+{
+    Begin("prox_hold");
+    EnterProximity(FOCUS_BRIGHTNESS);
+    uint16_t want = Prox(120);
+    CHECK(s_LedCalls == 1 && s_LedBri == want);
+    Prox(120);
+    Prox(120);
+    CHECK(s_LedCalls == 1);
+    Post(EVT_PROXIMITY_EXIT, 0);
+    End();
+}
+
+/** @brief 远程 light: 与当前输出相同 (ESP32 回显) 时跳过，不同时以 FADE_RAW_MS 渐变 */
+static void Case_LightEcho(void)
+{
+    Begin("light_echo");
+    LightCtrl_SetLevel(400, 500);
+    s_LedCalls = 0;
+    s_LightCb(200, 200);
+    CHECK(s_LedCalls == 0);
+    s_LightCb(100, 300);
+    CHECK(s_LedCalls == 1 && s_LedBri == 400 && s_LedCct == 750 && s_LedMs == FADE_RAW_MS);
+    End();
+}
+
+int main(int argc, char **argv)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    if (argc < 2 || strcmp(argv[1], "unit") != 0)
+    {
+        fprintf(stderr, "usage: %s unit\n", argv[0]);
+        return 2;
+    }
+
+    EventBus_Init();
+    Control_Init();
+    Case_ProxBrightness();
+    Case_ProxColorTemp();
+    Case_ProxHold();
+    Case_LightEcho();
+    return s_AnyFail;
+}
@@ -0,0 +1,231 @@
+/**
+ * 主机端 CSI 回放: 直接包含 ESP32 固件的 dev_csi.c (调用其中的静态前端 / 检测器 / 融合函数，
+ * Wi-Fi / Ping / FreeRTOS 用 stub_esp32 桩，不创建任务)，读取 csi_capture_receiver.py 保存的采集目录，
+ * 逐帧按采集时间戳送入前端 _fe_fill 与检测器 _proc_frame，每 500ms (采集时间) 评估一次窗口 _eval_window，
+ * 与 csi_monitor 任务的评估周期一致。
+ *
+ * 本程序把固件中的 esp_timer_get_time 替换为纳秒计时，因此固件内的逐检测器耗时统计
+ * (cost_us_sum / s_fe_proc_us_sum / s_a4_infer_us_sum) 在这里单位为 ns。
+ *
+ * 输出:
+ *   <frames_csv>   idx,ts_ms,label,sub_count,fe_ns,proc_ns        每帧的前端 / 检测器处理耗时
+ *   <windows_csv>  t_s,label,V1,...,Vn,fused                       每个 500ms 窗口的得分 (label 取窗口内多数帧)
+ *   stdout (逐行 key,v1,v2,...):
+ *     frames,<count>,<duration_ms>
+ *     fe_ns,<mean>,<p50>,<p99>,<max>
+ *     proc_ns,<mean>,<p50>,<p99>,<max>
+ *     det,<name>,<weight>,<mean_ns>,<max_ns>                     每个检测器 rx 的平均 / 最大耗时
+ *     infer_ns,<mean>,<max>,<windows>                            V4 推理 (eval) 耗时
+ *
+ * 用法: csi_replay_host <capture_dir> <frames_csv> <windows_csv>
+ * (由 sim_7_3_1_csi_replay.py 编译并运行)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_timer.h"
+
+// 固件内的 esp_timer_get_time 改由本文件的纳秒计时提供 (esp_timer.h 已包含，不会再被展开)
+static int64_t ReplayNowNs(void);
+#define esp_timer_get_time ReplayNowNs
+#include "../../ESP32_Firmware_Code/ESP32_Firmware/components/2_Device/src/dev_csi.c"
+
+#define WINDOW_MS 500
+
+/* ---------------- 固件其他模块的替身 ---------------- */
+void Dev_CSI_Capture_Push(const wifi_csi_info_t *info) { (void)info; }
+
+static int64_t ReplayNowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* ---------------- 采集目录 (按列存储，见 csi_capture_loader.py) ---------------- */
+typedef struct {
+    size_t    n;
+    int       stride;
+    uint64_t *ts_us;
+    int8_t   *rssi;
+    uint8_t  *channel;
+    uint8_t  *label;
+    uint16_t *iq_len;
+    int8_t   *iq;
+} capture_t;
+
+static void *ReadColumn(const char *dir, const char *name, size_t item, size_t *count)
+{
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s.bin", dir, name);
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "csi_replay_host: cannot open %s\n", path);
+        exit(2);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    void *buf = malloc(size ? (size_t)size : 1);
+    if (fread(buf, 1, (size_t)size, f) != (size_t)size)
+    {
+        fprintf(stderr, "csi_replay_host: short read %s\n", path);
+        exit(2);
+    }
+    fclose(f);
+    *count = (size_t)size / item;
+    return buf;
+}
+
+/** @brief 从 meta.json 取 iq_stride (格式固定，不引入 JSON 库) */
+static int ReadStride(const char *dir)
+{
+    char path[1024], text[4096];
+    snprintf(path, sizeof(path), "%s/meta.json", dir);
+    FILE *f = fopen(path, "r");
+    if (!f) return CSI_CAP_MAX_IQ;
+    size_t len = fread(text, 1, sizeof(text) - 1, f);
+    fclose(f);
+    text[len] = '\0';
+    const char *p = strstr(text, "\"iq_stride\"");
+    return p ? atoi(strchr(p, ':') + 1) : CSI_CAP_MAX_IQ;
+}
+
+/** @brief 各列取最短长度，与 csi_capture_loader.load_capture 相同，忽略半写入的末尾记录 */
+static void LoadCapture(const char *dir, capture_t *cap)
+{
+    size_t n[6];
+    cap->stride = ReadStride(dir);
+    cap->ts_us = ReadColumn(dir, "ts_us", 8, &n[0]);
+    cap->rssi = ReadColumn(dir, "rssi", 1, &n[1]);
+    cap->channel = ReadColumn(dir, "channel", 1, &n[2]);
+    cap->label = ReadColumn(dir, "label", 1, &n[3]);
+    cap->iq_len = ReadColumn(dir, "iq_len", 2, &n[4]);
+    cap->iq = ReadColumn(dir, "iq", (size_t)cap->stride, &n[5]);
+    cap->n = n[0];
+    for (int i = 1; i < 6; i++)
+        if (n[i] < cap->n) cap->n = n[i];
+}
+
+/* ---------------- 统计 ---------------- */
+static int CmpU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void PrintDist(const char *key, uint32_t *v, size_t n)
+{
+    if (n == 0)
+    {
+        printf("%s,0,0,0,0\n", key);
+        return;
+    }
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) sum += v[i];
+    qsort(v, n, sizeof(v[0]), CmpU32);
+    printf("%s,%.0f,%u,%u,%u\n", key, sum / n, (unsigned)v[n / 2], (unsigned)v[n * 99 / 100], (unsigned)v[n - 1]);
+}
+
+/** @brief 窗口内帧数最多的标注 */
+static int MajorityLabel(const uint32_t *cnt)
+{
+    int best = 0;
+    for (int i = 1; i < 256; i++)
+        if (cnt[i] > cnt[best]) best = i;
+    return best;
+}
+
+static void WriteWindow(FILE *fw, uint32_t t_ms, uint32_t *label_cnt)
+{
+    uint32_t fused = _eval_window();
+    fprintf(fw, "%.1f,%d", t_ms / 1000.0, MajorityLabel(label_cnt));
+    for (int i = 0; i < s_detector_num; i++) fprintf(fw, ",%u", (unsigned)s_detectors[i].last_score);
+    fprintf(fw, ",%u\n", (unsigned)fused);
+    memset(label_cnt, 0, 256 * sizeof(label_cnt[0]));
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        fprintf(stderr, "usage: %s <capture_dir> <frames_csv> <windows_csv>\n", argv[0]);
+        return 2;
+    }
+    capture_t cap;
+    LoadCapture(argv[1], &cap);
+    if (cap.n == 0)
+    {
+        fprintf(stderr, "csi_replay_host: empty capture\n");
+        return 2;
+    }
+    FILE *ff = fopen(argv[2], "w");
+    FILE *fw = fopen(argv[3], "w");
+    if (!ff || !fw)
+    {
+        fprintf(stderr, "csi_replay_host: cannot write output\n");
+        return 2;
+    }
+
+    // 与 Dev_CSI_Init 相同的初始状态 (出厂阈值，未训练的 V4 不注册)
+    _detectors_register();
+    _thresholds_reset_default();
+
+    fprintf(ff, "idx,ts_ms,label,sub_count,fe_ns,proc_ns\n");
+    fprintf(fw, "t_s,label");
+    for (int i = 0; i < s_detector_num; i++) fprintf(fw, ",%s", s_detectors[i].name);
+    fprintf(fw, ",fused\n");
+
+    uint32_t *fe_ns = malloc(cap.n * sizeof(uint32_t));
+    uint32_t *proc_ns = malloc(cap.n * sizeof(uint32_t));
+    uint32_t label_cnt[256] = { 0 };
+    uint32_t next_win = WINDOW_MS;
+    uint32_t now = 0;
+    s_prev_frame_tick = 0;
+
+    for (size_t k = 0; k < cap.n; k++)
+    {
+        now = (uint32_t)((cap.ts_us[k] - cap.ts_us[0]) / 1000);   // 虚拟 tick (1 tick = 1ms)
+        while (now >= next_win)
+        {
+            WriteWindow(fw, next_win, label_cnt);
+            next_win += WINDOW_MS;
+        }
+
+        wifi_csi_info_t info = { 0 };
+        info.buf = cap.iq + k * (size_t)cap.stride;
+        info.len = cap.iq_len[k] > cap.stride ? (uint16_t)cap.stride : cap.iq_len[k];
+        info.rx_ctrl.rssi = cap.rssi[k];
+        info.rx_ctrl.channel = cap.channel[k];
+
+        csi_frame_t *f = &s_frame_ring[0];
+        int64_t t0 = esp_timer_get_time();
+        _fe_fill(f, &info, now);
+        int64_t t1 = esp_timer_get_time();
+        int64_t proc0 = s_fe_proc_us_sum;
+        _proc_frame(f);
+
+        fe_ns[k] = (uint32_t)(t1 - t0);
+        proc_ns[k] = (uint32_t)(s_fe_proc_us_sum - proc0);
+        label_cnt[cap.label[k]]++;
+        fprintf(ff, "%zu,%u,%u,%u,%u,%u\n", k, (unsigned)now, cap.label[k], f->sub_count,
+                (unsigned)fe_ns[k], (unsigned)proc_ns[k]);
+    }
+    WriteWindow(fw, next_win, label_cnt);
+    fclose(ff);
+    fclose(fw);
+
+    printf("frames,%zu,%u\n", cap.n, (unsigned)now);
+    PrintDist("fe_ns", fe_ns, cap.n);
+    PrintDist("proc_ns", proc_ns, cap.n);
+    for (int i = 0; i < s_detector_num; i++)
+    {
+        const csi_detector_t *d = &s_detectors[i];
+        printf("det,%s,%u,%.0f,%u\n", d->name, d->weight, (double)d->cost_us_sum / cap.n, (unsigned)d->cost_us_max);
+    }
+    printf("infer_ns,%.0f,%u,%u\n", s_a4_infer_cnt ? (double)s_a4_infer_us_sum / s_a4_infer_cnt : 0.0,
+           (unsigned)s_a4_infer_us_max, (unsigned)s_a4_infer_cnt);
+    return 0;
+}
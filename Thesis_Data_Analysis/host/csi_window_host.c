@@ -0,0 +1,277 @@
+/**
+ * 主机端 CSI 窗口统计测试: 直接包含 ESP32 固件的 dev_csi.c，检查 V2 / V3 的流式窗口统计与窗口双缓冲交接。
+ *
+ * equiv:  随机生成 <windows> 个窗口 (每窗 0~80 个样本)，V3 流式截尾均值 (_a3_push + algo3_eval) 与
+ *         "排序后去掉两端 count/5 个再求均值" 的参考实现逐窗比较，V2 流式极差与全量 min/max 比较。
+ * bench:  每窗 n 个样本时，原实现 (32 点历史 + 拷贝 + 冒泡排序) 与流式实现的单窗耗时 (ns)。
+ * race:   两个线程按固件的方式交接窗口 <seconds> 秒: 写线程 (csi_proc) 每帧 _win_begin_write / 写 / _win_end_write，
+ *         读线程 (csi_monitor) 随机间隔 _win_swap_for_read 后读取并清空旧窗口。
+ *         写入中的窗口被读到记为重叠；读线程累计的样本数 / 序号和与写线程不一致记为丢失。
+ *
+ * 输出 (stdout，逐行 key,v1,v2,...):
+ *   equiv,<windows>,<samples>,<v3_mismatch>,<v2_mismatch>
+ *   bench,<n>,<old_ns>,<new_ns>
+ *   race,<writes>,<swaps>,<overlaps>,<lost_samples>,<wait_spins>
+ *
+ * 用法: csi_window_host equiv <windows> | bench | race <seconds>
+ * (由 sim_7_3_2_csi_window.py 编译并运行)
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../ESP32_Firmware_Code/ESP32_Firmware/components/2_Device/src/dev_csi.c"
+
+#define MAX_WIN_SAMPLES 80      // 5 * A3_TRIM_KEEP，流式截尾均值保证精确的上限
+
+void Dev_CSI_Capture_Push(const wifi_csi_info_t *info) { (void)info; }
+
+static uint32_t s_Rng = 2463534242u;
+
+static uint32_t XorShift(void)
+{
+    s_Rng ^= s_Rng << 13;
+    s_Rng ^= s_Rng >> 17;
+    s_Rng ^= s_Rng << 5;
+    return s_Rng;
+}
+
+/** @brief V3 帧得分的近似分布: 多数在噪声附近，偶有大尖峰；窄范围时大量重复值 */
+static uint32_t RandScore(uint32_t range)
+{
+    uint32_t v = XorShift() % range;
+    if (XorShift() % 16 == 0) v += XorShift() % (range * 8);
+    return v;
+}
+
+static int64_t NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* ---------------- 参考实现 ---------------- */
+/** @brief 截尾均值: 排序后去掉两端 count/5 个 (count >= 6)，与改造前 algo3_eval 的定义相同 */
+static uint32_t RefTrimmedMean(const uint32_t *v, int count)
+{
+    if (count == 0) return 0;
+    uint32_t local[MAX_WIN_SAMPLES];
+    memcpy(local, v, count * sizeof(uint32_t));
+    for (int i = 1; i < count; i++)
+    {
+        uint32_t x = local[i];
+        int j = i - 1;
+        while (j >= 0 && local[j] > x) { local[j + 1] = local[j]; j--; }
+        local[j + 1] = x;
+    }
+    int start = 0, end = count;
+    if (count >= 6)
+    {
+        start = count / 5;
+        end = count - start;
+    }
+    uint64_t sum = 0;
+    for (int i = start; i < end; i++) sum += local[i];
+    return (uint32_t)(sum / (end - start));
+}
+
+/* 改造前的 V3: 32 点历史，出分时拷贝 + 冒泡排序 */
+static uint32_t s_OldHist[32];
+static int s_OldCount;
+
+static void OldRx(uint32_t v)
+{
+    if (s_OldCount < 32) s_OldHist[s_OldCount++] = v;
+}
+
+static uint32_t OldEval(void)
+{
+    int count = s_OldCount;
+    uint32_t local[32];
+    for (int i = 0; i < count; i++) local[i] = s_OldHist[i];
+    s_OldCount = 0;
+    uint32_t score = 0;
+    if (count > 0)
+    {
+        for (int i = 0; i < count - 1; i++)
+            for (int j = i + 1; j < count; j++)
+                if (local[i] > local[j]) { uint32_t t = local[i]; local[i] = local[j]; local[j] = t; }
+        int start = 0, end = count;
+        if (count >= 6)
+        {
+            int trim = count / 5;
+            start = trim;
+            end = count - trim;
+        }
+        uint32_t sum = 0;
+        for (int i = start; i < end; i++) sum += local[i];
+        score = sum / (end - start);
+    }
+    return score;
+}
+
+/* ---------------- equiv ---------------- */
+static int RunEquiv(int windows)
+{
+    a3_win_t w3;
+    a2_win_t w2;
+    memset(&w3, 0, sizeof(w3));
+    memset(&w2, 0, sizeof(w2));
+    uint32_t v[MAX_WIN_SAMPLES];
+    long samples = 0;
+    int bad3 = 0, bad2 = 0;
+
+    for (int k = 0; k < windows; k++)
+    {
+        int n = (int)(XorShift() % (MAX_WIN_SAMPLES + 1));
+        uint32_t range = (k % 4 == 0) ? 8 : 2000;
+        uint32_t lo = UINT32_MAX, hi = 0;
+        csi_frame_t f = { 0 };
+        for (int i = 0; i < n; i++)
+        {
+            v[i] = RandScore(range);
+            _a3_push(&w3, v[i]);
+            f.total_amp = v[i] * 16;
+            algo2_rx(&w2, &f);
+            if (f.total_amp < lo) lo = f.total_amp;
+            if (f.total_amp > hi) hi = f.total_amp;
+        }
+        samples += n;
+
+        if (algo3_eval(&w3) != RefTrimmedMean(v, n)) bad3++;
+        uint32_t got2 = algo2_eval(&w2);
+        uint32_t want2 = 0;
+        if (n >= A2_REF_N) want2 = hi - lo;
+        else if (n >= 2) want2 = (uint32_t)((uint64_t)(hi - lo) * s_a2_d2_x1000[A2_REF_N] / s_a2_d2_x1000[n]);
+        if (got2 != want2) bad2++;
+    }
+    printf("equiv,%d,%ld,%d,%d\n", windows, samples, bad3, bad2);
+    return 0;
+}
+
+/* ---------------- bench ---------------- */
+static volatile uint32_t s_Sink;
+
+static void RunBench(void)
+{
+    static const int sizes[] = { 4, 10, 20, 32, 64 };
+    enum { POOL = 1 << 16 };
+    uint32_t *pool = malloc(POOL * sizeof(uint32_t));
+    for (int i = 0; i < POOL; i++) pool[i] = RandScore(2000);
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        int n = sizes[s];
+        int reps = 4000000 / n;
+        uint32_t acc = 0;
+        int p = 0;
+
+        int64_t t0 = NowNs();
+        for (int r = 0; r < reps; r++)
+        {
+            for (int i = 0; i < n; i++) OldRx(pool[(p + i) & (POOL - 1)]);
+            acc += OldEval();
+            p += n;
+        }
+        int64_t t_old = NowNs() - t0;
+
+        a3_win_t w;
+        memset(&w, 0, sizeof(w));
+        p = 0;
+        t0 = NowNs();
+        for (int r = 0; r < reps; r++)
+        {
+            for (int i = 0; i < n; i++) _a3_push(&w, pool[(p + i) & (POOL - 1)]);
+            acc += algo3_eval(&w);
+            p += n;
+        }
+        int64_t t_new = NowNs() - t0;
+        s_Sink = acc;
+        printf("bench,%d,%.1f,%.1f\n", n, (double)t_old / reps, (double)t_new / reps);
+    }
+    free(pool);
+}
+
+/* ---------------- race ---------------- */
+typedef struct {
+    uint64_t seq_sum;
+    uint32_t count;
+    volatile uint32_t writing;  // 写线程正在写本窗口
+} race_win_t;
+
+static race_win_t s_RaceWin[2];
+static volatile int s_Stop;
+static uint64_t s_Writes, s_WriteSum;
+
+static void *Writer(void *arg)
+{
+    (void)arg;
+    uint64_t seq = 0;
+    while (!__atomic_load_n(&s_Stop, __ATOMIC_RELAXED))
+    {
+        uint32_t w = _win_begin_write();
+        race_win_t *rw = &s_RaceWin[w];
+        rw->writing = 1;
+        seq++;
+        rw->seq_sum += seq;
+        for (volatile int spin = 0; spin < 20; spin++) {}   // 模拟一帧的处理时间，拉长写入区间
+        rw->count++;
+        rw->writing = 0;
+        _win_end_write();
+    }
+    s_Writes = seq;
+    s_WriteSum = seq * (seq + 1) / 2;
+    return NULL;
+}
+
+static int RunRace(int seconds)
+{
+    pthread_t th;
+    pthread_create(&th, NULL, Writer, NULL);
+
+    uint64_t swaps = 0, overlaps = 0, got = 0, got_sum = 0;
+    int64_t end = NowNs() + (int64_t)seconds * 1000000000LL;
+    while (NowNs() < end)
+    {
+        uint32_t r = _win_swap_for_read();
+        race_win_t *rw = &s_RaceWin[r];
+        if (rw->writing) overlaps++;
+        got += rw->count;
+        got_sum += rw->seq_sum;
+        rw->count = 0;
+        rw->seq_sum = 0;
+        if (rw->writing) overlaps++;
+        swaps++;
+        usleep(XorShift() % 200);
+    }
+    __atomic_store_n(&s_Stop, 1, __ATOMIC_RELAXED);
+    pthread_join(th, NULL);
+
+    // 写线程停止后收走两个窗口中剩余的样本
+    for (int i = 0; i < 2; i++)
+    {
+        race_win_t *rw = &s_RaceWin[_win_swap_for_read()];
+        got += rw->count;
+        got_sum += rw->seq_sum;
+        rw->count = 0;
+        rw->seq_sum = 0;
+    }
+    uint64_t lost = (got == s_Writes && got_sum == s_WriteSum) ? 0 : (s_Writes > got ? s_Writes - got : 1);
+    printf("race,%llu,%llu,%llu,%llu,%u\n", (unsigned long long)s_Writes, (unsigned long long)swaps,
+           (unsigned long long)overlaps, (unsigned long long)lost, (unsigned)s_win_wait_spins);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    if (argc >= 3 && strcmp(argv[1], "equiv") == 0) return RunEquiv(atoi(argv[2]));
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) { RunBench(); return 0; }
+    if (argc >= 3 && strcmp(argv[1], "race") == 0) return RunRace(atoi(argv[2]));
+
+    fprintf(stderr, "usage: %s equiv <windows> | bench | race <seconds>\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,160 @@
+/**
+ * 主机端 DHT11 解码测试: 直接编译固件的 DHT11_Decode.c，用合成的下降沿捕获序列检验解码器。
+ *
+ *   1. 固定用例: 标准帧、计数器回绕、多余的沿、无应答、帧截断、毛刺、漏沿、校验和错误
+ *   2. 抖动扫描: 随机数据 + 随机起始计数值，每个沿的捕获时刻加 ±J us 均匀抖动，
+ *      同时每个脉宽在手册给出的范围内随机取值，统计各抖动幅度下的
+ *      解码成功 / 检出错误 (TIMING / CHECKSUM) / 错误数据被接受 的比例
+ *
+ * 用法: dht11_decode_host <CSV 路径> [每档帧数] [必须全部成功的最大抖动 us]
+ * 固定用例失败，或抖动 <= 门限时有任何一帧未正确解码，退出码 1。
+ * (由 sim_7_1_6_dht11_decode.py 编译并运行)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "DHT11_Decode.h"
+
+static uint32_t s_Rand = 12345;
+
+static uint32_t Rand32(void)
+{
+    s_Rand = s_Rand * 1103515245u + 12345u;
+    return s_Rand >> 1;
+}
+
+/** @brief [lo, hi] 均匀分布的整数 */
+static int RandRange(int lo, int hi)
+{
+    return lo + (int)(Rand32() % (uint32_t)(hi - lo + 1));
+}
+
+/**
+  * @brief  合成一帧的下降沿捕获值
+  * @param  jitter: 每个捕获值叠加的 ±jitter us 抖动
+  * @param  spread: 1 = 脉宽在手册范围内随机，0 = 取典型值
+  */
+static void Make_Frame(const uint8_t data[5], uint16_t start, int jitter, int spread, uint16_t edges[DHT11_EDGE_NUM])
+{
+    int32_t t = start;      // 真实下降沿时刻 (us)
+    int k = 0;
+
+    edges[k++] = (uint16_t)(t + RandRange(-jitter, jitter));
+    t += spread ? RandRange(78, 88) + RandRange(78, 88) : 80 + 80;      // 响应低 + 高
+    edges[k++] = (uint16_t)(t + RandRange(-jitter, jitter));
+
+    for (int i = 0; i < 40; i++)
+    {
+        int bit = (data[i >> 3] >> (7 - (i & 7))) & 1;
+        int low = spread ? RandRange(48, 55) : 50;
+        int high = bit ? (spread ? RandRange(68, 74) : 70) : (spread ? RandRange(23, 28) : 26);
+        t += low + high;
+        edges[k++] = (uint16_t)(t + RandRange(-jitter, jitter));
+    }
+}
+
+static void Random_Data(uint8_t d[5])
+{
+    d[0] = (uint8_t)RandRange(20, 90);
+    d[1] = 0;
+    d[2] = (uint8_t)RandRange(0, 50);
+    d[3] = (uint8_t)RandRange(0, 9);
+    d[4] = (uint8_t)(d[0] + d[1] + d[2] + d[3]);
+}
+
+/* ---------------- 固定用例 ---------------- */
+
+static int s_Fail = 0;
+
+static void Expect(const char *name, DHT11_DecStatus_t got, DHT11_DecStatus_t want)
+{
+    printf("  %-28s status=%d %s\n", name, got, got == want ? "ok" : "FAIL");
+    if (got != want) s_Fail++;
+}
+
+static void Fixed_Cases(void)
+{
+    uint8_t data[5] = { 45, 0, 23, 0, 68 };
+    uint8_t out[5];
+    uint16_t e[DHT11_EDGE_NUM + 4];
+
+    printf("固定用例:\n");
+
+    Make_Frame(data, 1000, 0, 0, e);
+    Expect("nominal", DHT11_Decode(e, DHT11_EDGE_NUM, out), DHT11_DEC_OK);
+    if (memcmp(out, data, 5) != 0) { printf("  nominal: data mismatch FAIL\n"); s_Fail++; }
+
+    Make_Frame(data, 65535 - 2000, 0, 0, e);                 // 帧中途计数器回绕
+    Expect("counter wrap", DHT11_Decode(e, DHT11_EDGE_NUM, out), DHT11_DEC_OK);
+    if (memcmp(out, data, 5) != 0) { printf("  counter wrap: data mismatch FAIL\n"); s_Fail++; }
+
+    Make_Frame(data, 1000, 0, 0, e);
+    e[DHT11_EDGE_NUM] = e[DHT11_EDGE_NUM - 1] + 300;          // 帧后多出的沿被忽略
+    Expect("extra edge", DHT11_Decode(e, DHT11_EDGE_NUM + 1, out), DHT11_DEC_OK);
+
+    Expect("no response", DHT11_Decode(e, 0, out), DHT11_DEC_NO_RESPONSE);
+    Expect("truncated", DHT11_Decode(e, 30, out), DHT11_DEC_SHORT);
+
+    Make_Frame(data, 1000, 0, 0, e);                          // 位中间插入毛刺
+    memmove(&e[11], &e[10], (DHT11_EDGE_NUM - 11) * sizeof(e[0]));
+    e[10] = e[9] + 20;
+    Expect("glitch", DHT11_Decode(e, DHT11_EDGE_NUM, out), DHT11_DEC_TIMING);
+
+    Make_Frame(data, 1000, 0, 0, e);                          // 漏掉一个沿: 间隔变成两位之和
+    memmove(&e[10], &e[11], (DHT11_EDGE_NUM - 11) * sizeof(e[0]));
+    e[DHT11_EDGE_NUM - 1] = e[DHT11_EDGE_NUM - 2] + 76;
+    Expect("missed edge", DHT11_Decode(e, DHT11_EDGE_NUM, out), DHT11_DEC_TIMING);
+
+    data[4]++;                                                // 校验和错误
+    Make_Frame(data, 1000, 0, 0, e);
+    Expect("checksum", DHT11_Decode(e, DHT11_EDGE_NUM, out), DHT11_DEC_CHECKSUM);
+}
+
+/* ---------------- 抖动扫描 ---------------- */
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <csv> [frames] [max_jitter_ok]\n", argv[0]);
+        return 2;
+    }
+    int frames = argc > 2 ? atoi(argv[2]) : 5000;
+    int jitter_ok = argc > 3 ? atoi(argv[3]) : 8;
+
+    Fixed_Cases();
+
+    FILE *csv = fopen(argv[1], "w");
+    if (!csv) { perror(argv[1]); return 2; }
+    fprintf(csv, "jitter_us,frames,ok,timing,checksum,wrong_accepted\n");
+
+    printf("\n抖动扫描 (每档 %d 帧):\n", frames);
+    for (int j = 0; j <= 30; j += 2)
+    {
+        int ok = 0, timing = 0, checksum = 0, wrong = 0;
+        for (int f = 0; f < frames; f++)
+        {
+            uint8_t data[5], out[5];
+            uint16_t e[DHT11_EDGE_NUM];
+
+            Random_Data(data);
+            Make_Frame(data, (uint16_t)Rand32(), j, 1, e);
+            DHT11_DecStatus_t st = DHT11_Decode(e, DHT11_EDGE_NUM, out);
+            if (st == DHT11_DEC_OK)
+            {
+                if (memcmp(out, data, 5) == 0) ok++;
+                else wrong++;
+            }
+            else if (st == DHT11_DEC_CHECKSUM) checksum++;
+            else timing++;
+        }
+        fprintf(csv, "%d,%d,%d,%d,%d,%d\n", j, frames, ok, timing, checksum, wrong);
+        printf("  ±%2dus  ok=%5.1f%%  timing=%5.1f%%  checksum=%5.1f%%  wrong=%d\n", j,
+               100.0 * ok / frames, 100.0 * timing / frames, 100.0 * checksum / frames, wrong);
+        if (j <= jitter_ok && ok != frames) s_Fail++;
+    }
+    fclose(csv);
+
+    if (s_Fail) fprintf(stderr, "%d failure(s)\n", s_Fail);
+    return s_Fail ? 1 : 0;
+}
@@ -0,0 +1,332 @@
+/**
+ * 主机端事件总线测试: 直接编译固件的 EventBus.c (__DMB 由 host/stub/stm32f10x.h 提供，串口为本文件的替身)。
+ *
+ *   unit:  固定用例 (队列 FIFO 顺序与 uint8_t 下标回绕、满时丢弃计数、历史最高占用、
+ *          分发顺序 (先中断队列后主循环队列)、处理函数中新投递的事件留到下一次、订阅范围检查、[EvtBus] 统计行)
+ *   race:  生产者线程 (模拟中断) 每 <produce_us> 调用一次 EventBus_PostFromISR，消费者线程 (模拟主循环)
+ *          每 <dispatch_us> 调用一次 EventBus_Dispatch_Task，持续 <seconds> 秒。每个事件携带序号与由序号推出的载荷，
+ *          处理函数检查序号严格递增 (乱序 / 重复)、载荷与序号一致 (读到写了一半的槽位)，
+ *          结束后核对 投递成功 + 丢弃 = 尝试次数、收到 = 投递成功、队列的 Dropped 与生产者看到的失败次数一致。
+ *
+ * 输出 (stdout，逐行 key,v1,v2,...):
+ *   unit:  case,<name>,<ok>   (失败时前面另有 fail,<name>,<line>,<条件>)
+ *   race:  race,<dispatch_us>,<attempts>,<posted>,<dropped>,<queue_dropped>,<received>,<order_err>,<payload_err>,<high_water>
+ *
+ * 用法: eventbus_host unit | race <seconds> <produce_us> <dispatch_us>
+ * 任一固定用例失败，或 race 中任何一项核对不通过，退出码 1。
+ * (由 sim_7_1_10_eventbus.py 编译并运行)
+ */
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "EventBus.h"
+#include "USART_DMA.h"
+
+/* ---------------- 串口替身 ---------------- */
+static char s_LastLine[192];
+
+int USART_DMA_Printf(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(s_LastLine, sizeof(s_LastLine), fmt, ap);
+    va_end(ap);
+    s_LastLine[strcspn(s_LastLine, "\r\n")] = '\0';
+    return 1;
+}
+
+/* ---------------- unit ---------------- */
+static const char *s_Case;
+static int s_CaseFail, s_AnyFail;
+
+#define CHECK(c) do { if (!(c)) { printf("fail,%s,%d,%s\n", s_Case, __LINE__, #c); s_CaseFail = 1; } } while (0)
+
+static void Begin(const char *name)
+{
+    s_Case = name;
+    s_CaseFail = 0;
+    EventBus_Init();
+}
+
+static void End(void)
+{
+    printf("case,%s,%d\n", s_Case, !s_CaseFail);
+    s_AnyFail |= s_CaseFail;
+}
+
+static Event_t MakeEvt(uint32_t seq)
+{
+    Event_t e = { EVT_ENCODER, (uint8_t)seq, (int16_t)(seq * 31u), seq };
+    return e;
+}
+
+/** @brief 占用在 0..SIZE 之间来回变化，下标经过多次 uint8_t 回绕后仍严格 FIFO */
+static void Case_FifoWrap(void)
+{
+    Begin("fifo_wrap");
+    EventQueue_t q;
+    memset(&q, 0, sizeof(q));
+    uint32_t in = 0, out = 0, bad = 0;
+    for (int round = 0; round < 200; round++)
+    {
+        int push = 1 + round % EVT_QUEUE_SIZE;
+        for (int i = 0; i < push; i++)
+        {
+            Event_t e = MakeEvt(in);
+            if (EventQueue_Push(&q, &e)) in++;
+        }
+        CHECK(EventQueue_Count(&q) == in - out);
+        int pop = 1 + (round * 7) % EVT_QUEUE_SIZE;
+        Event_t e;
+        for (int i = 0; i < pop && EventQueue_Pop(&q, &e); i++, out++)
+        {
+            if (e.Param != out || e.Value != (int16_t)(out * 31u) || e.Src != (uint8_t)out) bad++;
+        }
+    }
+    Event_t e;
+    while (EventQueue_Pop(&q, &e))
+        if (e.Param != out++) bad++;
+    CHECK(bad == 0);
+    CHECK(in == out && in > 1000);   // 下标至少回绕数次
+    End();
+}
+
+/** @brief 满时丢弃并计数，不覆盖已有事件；腾出一个槽位后恢复 */
+static void Case_FullDrop(void)
+{
+    Begin("full_drop");
+    EventQueue_t q;
+    memset(&q, 0, sizeof(q));
+    for (uint32_t i = 0; i < EVT_QUEUE_SIZE; i++)
+    {
+        Event_t e = MakeEvt(i);
+        CHECK(EventQueue_Push(&q, &e) == 1);
+    }
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        Event_t e = MakeEvt(1000 + i);
+        CHECK(EventQueue_Push(&q, &e) == 0);
+    }
+    CHECK(q.Dropped == 5 && EventQueue_Count(&q) == EVT_QUEUE_SIZE && q.HighWater == EVT_QUEUE_SIZE);
+
+    Event_t e;
+    CHECK(EventQueue_Pop(&q, &e) && e.Param == 0);
+    Event_t n = MakeEvt(2000);
+    CHECK(EventQueue_Push(&q, &n) == 1 && q.Dropped == 5);
+    for (uint32_t i = 1; i < EVT_QUEUE_SIZE; i++) CHECK(EventQueue_Pop(&q, &e) && e.Param == i);
+    CHECK(EventQueue_Pop(&q, &e) && e.Param == 2000);
+    CHECK(EventQueue_Pop(&q, &e) == 0);
+    End();
+}
+
+/** @brief 历史最高占用只增不减，出队后保持 */
+static void Case_HighWater(void)
+{
+    Begin("high_water");
+    EventQueue_t q;
+    memset(&q, 0, sizeof(q));
+    Event_t e = MakeEvt(0);
+    for (int i = 0; i < 5; i++) EventQueue_Push(&q, &e);
+    while (EventQueue_Pop(&q, &e)) {}
+    for (int i = 0; i < 3; i++) EventQueue_Push(&q, &e);
+    CHECK(q.HighWater == 5 && EventQueue_Count(&q) == 3);
+    for (int i = 0; i < 4; i++) EventQueue_Push(&q, &e);
+    CHECK(q.HighWater == 7);
+    End();
+}
+
+/* 分发记录 */
+static Event_t s_Seen[64];
+static int s_SeenNum;
+
+static void RecordHandler(const Event_t *evt)
+{
+    if (s_SeenNum < 64) s_Seen[s_SeenNum++] = *evt;
+}
+
+/** @brief 处理函数里再投递一个事件: 本次分发不处理，留到下一次 */
+static void RepostHandler(const Event_t *evt)
+{
+    RecordHandler(evt);
+    if (evt->Param < 3) EventBus_Post(EVT_KEY, 0, 0, evt->Param + 1);
+}
+
+/** @brief 先分发中断队列、再分发主循环队列，各自 FIFO；未订阅的类型被取出但不调用 */
+static void Case_Dispatch(void)
+{
+    Begin("dispatch");
+    s_SeenNum = 0;
+    EventBus_Subscribe(EVT_ENCODER, RecordHandler);
+    EventBus_Subscribe(EVT_GESTURE, RecordHandler);
+    EventBus_Post(EVT_ENCODER, 0, 1, 10);
+    EventBus_PostFromISR(EVT_GESTURE, 0, 2, 20);
+    EventBus_Post(EVT_KEY, 0, 3, 11);           // 未订阅
+    EventBus_Post(EVT_ENCODER, 0, 4, 12);
+    EventBus_PostFromISR(EVT_GESTURE, 0, 5, 21);
+
+    EventBus_Dispatch_Task();
+    CHECK(s_SeenNum == 4);
+    CHECK(s_Seen[0].Param == 20 && s_Seen[1].Param == 21 && s_Seen[2].Param == 10 && s_Seen[3].Param == 12);
+    EventBus_Dispatch_Task();
+    CHECK(s_SeenNum == 4);
+
+    EventBus_Stats_Task();
+    CHECK(strstr(s_LastLine, "dispatched=5 ") != NULL);
+    CHECK(strstr(s_LastLine, "main 0/") != NULL && strstr(s_LastLine, "hw=3 drop=0") != NULL);
+    End();
+}
+
+static void Case_Repost(void)
+{
+    Begin("repost");
+    s_SeenNum = 0;
+    EventBus_Subscribe(EVT_KEY, RepostHandler);
+    EventBus_Post(EVT_KEY, 0, 0, 0);
+    for (int i = 1; i <= 4; i++)
+    {
+        EventBus_Dispatch_Task();
+        CHECK(s_SeenNum == i && s_Seen[i - 1].Param == (uint32_t)(i - 1));
+    }
+    EventBus_Dispatch_Task();
+    CHECK(s_SeenNum == 4);
+    End();
+}
+
+/** @brief EVT_NONE / 越界类型不能订阅，投递后只被计数 */
+static void Case_SubscribeRange(void)
+{
+    Begin("subscribe_range");
+    s_SeenNum = 0;
+    EventBus_Subscribe(EVT_NONE, RecordHandler);
+    EventBus_Subscribe(EVT_TYPE_NUM, RecordHandler);
+    EventBus_Post(EVT_NONE, 0, 0, 0);
+    EventBus_Post((EventType_t)200, 0, 0, 0);
+    EventBus_Dispatch_Task();
+    CHECK(s_SeenNum == 0);
+    EventBus_Stats_Task();
+    CHECK(strstr(s_LastLine, "dispatched=2 ") != NULL);
+    End();
+}
+
+/** @brief 队列满时总线接口返回 0，[EvtBus] 行给出各队列的历史最高与丢弃数 */
+static void Case_StatsLine(void)
+{
+    Begin("stats_line");
+    for (int i = 0; i < EVT_QUEUE_SIZE + 3; i++) EventBus_PostFromISR(EVT_GESTURE, 0, 0, i);
+    CHECK(EventBus_PostFromISR(EVT_GESTURE, 0, 0, 0) == 0);
+    EventBus_Post(EVT_KEY, 0, 0, 0);
+    EventBus_Stats_Task();
+    char want[64];
+    snprintf(want, sizeof(want), "isr %u/%u hw=%u drop=4", EVT_QUEUE_SIZE, EVT_QUEUE_SIZE, EVT_QUEUE_SIZE);
+    CHECK(strstr(s_LastLine, want) != NULL);
+    CHECK(strstr(s_LastLine, "main 1/") != NULL);
+    End();
+}
+
+static int RunUnit(void)
+{
+    Case_FifoWrap();
+    Case_FullDrop();
+    Case_HighWater();
+    Case_Dispatch();
+    Case_Repost();
+    Case_SubscribeRange();
+    Case_StatsLine();
+    return s_AnyFail;
+}
+
+/* ---------------- race ---------------- */
+static volatile int s_Stop;
+static uint32_t s_ProduceNs;
+static uint64_t s_Attempts, s_Posted, s_Dropped;
+static uint64_t s_Received, s_OrderErr, s_PayloadErr;
+static int64_t  s_LastSeq = -1;
+
+static int64_t NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void RaceHandler(const Event_t *evt)
+{
+    s_Received++;
+    if ((int64_t)evt->Param <= s_LastSeq) s_OrderErr++;
+    s_LastSeq = evt->Param;
+    if (evt->Src != (uint8_t)evt->Param || evt->Value != (int16_t)(evt->Param * 31u)) s_PayloadErr++;
+}
+
+/** @brief 模拟中断: 按固定间隔投递 (忙等计时，间隔比 usleep 精确) */
+static void *Producer(void *arg)
+{
+    (void)arg;
+    uint32_t seq = 0;
+    int64_t next = NowNs();
+    while (!__atomic_load_n(&s_Stop, __ATOMIC_RELAXED))
+    {
+        while (NowNs() < next) {}
+        next += s_ProduceNs;
+        if (EventBus_PostFromISR(EVT_GESTURE, (uint8_t)seq, (int16_t)(seq * 31u), seq)) s_Posted++;
+        else s_Dropped++;
+        seq++;
+    }
+    s_Attempts = seq;
+    return NULL;
+}
+
+/** @brief 读取队列统计: 借 [EvtBus] 行取出中断队列的 hw / drop */
+static void IsrQueueStats(unsigned *hw, unsigned *drop)
+{
+    EventBus_Stats_Task();
+    const char *p = strstr(s_LastLine, "| isr ");
+    *hw = *drop = 0;
+    if (p) sscanf(p, "| isr %*u/%*u hw=%u drop=%u", hw, drop);
+}
+
+static int RunRace(int seconds, int produce_us, int dispatch_us)
+{
+    EventBus_Init();
+    EventBus_Subscribe(EVT_GESTURE, RaceHandler);
+    s_ProduceNs = (uint32_t)produce_us * 1000u;
+
+    pthread_t th;
+    pthread_create(&th, NULL, Producer, NULL);
+    int64_t end = NowNs() + (int64_t)seconds * 1000000000LL;
+    while (NowNs() < end)
+    {
+        EventBus_Dispatch_Task();
+        if (dispatch_us > 0)
+        {
+            struct timespec ts = { 0, (long)dispatch_us * 1000L };
+            nanosleep(&ts, NULL);
+        }
+    }
+    __atomic_store_n(&s_Stop, 1, __ATOMIC_RELAXED);
+    pthread_join(th, NULL);
+    EventBus_Dispatch_Task();    // 生产者停止后取完剩余事件
+
+    unsigned hw, qdrop;
+    IsrQueueStats(&hw, &qdrop);
+    printf("race,%d,%llu,%llu,%llu,%u,%llu,%llu,%llu,%u\n", dispatch_us,
+           (unsigned long long)s_Attempts, (unsigned long long)s_Posted, (unsigned long long)s_Dropped, qdrop,
+           (unsigned long long)s_Received, (unsigned long long)s_OrderErr, (unsigned long long)s_PayloadErr, hw);
+
+    // Dropped 为 uint16_t，按 65536 取模比较
+    int ok = s_Posted + s_Dropped == s_Attempts && s_Received == s_Posted &&
+             qdrop == (unsigned)(s_Dropped & 0xFFFF) && s_OrderErr == 0 && s_PayloadErr == 0;
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    if (argc >= 2 && strcmp(argv[1], "unit") == 0) return RunUnit();
+    if (argc >= 5 && strcmp(argv[1], "race") == 0) return RunRace(atoi(argv[2]), atoi(argv[3]), atoi(argv[4]));
+
+    fprintf(stderr, "usage: %s unit | race <seconds> <produce_us> <dispatch_us>\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,166 @@
+/**
+ * 主机端本地意图匹配测试: 直接编译 ESP32 固件的 svc_intent.c (esp_log / esp_timer 用 stub_esp32 桩)，
+ * 本文件提供 DataCenter 的替身。
+ *
+ * 1. 语料: 逐条运行 Svc_Intent_Match，与期望的意图 / 槽位值比较，并重复 N 次取平均匹配耗时 (us)。
+ *    输出 (CSV，含表头): text,expect,expect_value,got,got_value,ok,us
+ * 2. 动作: 从给定灯光状态执行 Svc_Intent_Process，检查写入 DataCenter 的结果
+ *    (步进、下限、开关联动、定时倒计时到期关灯)，失败时打印到 stderr。
+ *
+ * 用法: intent_host <语料 CSV> <重复次数>
+ * 退出码: 0 = 语料与动作全部通过，1 = 有不一致
+ * (由 sim_7_2_2_intent_corpus.py 编译并运行)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "svc_intent.h"
+#include "data_center.h"
+#include "esp_timer.h"
+
+static const char *s_Names[] = {
+    "NONE", "POWER_ON", "POWER_OFF", "BRI_SET", "BRI_UP", "BRI_DOWN", "BRI_MAX", "BRI_MIN",
+    "CCT_SET", "CCT_WARM", "CCT_COOL", "TIMER_SET", "TIMER_CANCEL",
+};
+#define NAME_NUM ((int)(sizeof(s_Names) / sizeof(s_Names[0])))
+
+/* ---------------- DataCenter 的替身 ---------------- */
+static DC_LightingData_t s_Light;
+static DC_TimerData_t s_Timer;
+
+void DataCenter_Get_Lighting(DC_LightingData_t *out_data) { *out_data = s_Light; }
+void DataCenter_Set_Lighting(const DC_LightingData_t *in_data) { s_Light = *in_data; }
+void DataCenter_Get_Timer(DC_TimerData_t *out_data) { *out_data = s_Timer; }
+void DataCenter_Set_Timer(const DC_TimerData_t *in_data) { s_Timer = *in_data; }
+
+/* ---------------- 1. 语料 ---------------- */
+static int RunCorpus(const char *path, int repeat)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return 1; }
+
+    char line[512];
+    int fail = 0;
+    if (!fgets(line, sizeof(line), f)) { fclose(f); return 1; }   // 表头
+    printf("text,expect,expect_value,got,got_value,ok,us\n");
+
+    while (fgets(line, sizeof(line), f))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *text = strtok(line, ",");
+        char *expect = strtok(NULL, ",");
+        char *val = strtok(NULL, ",");
+        if (!text || !expect || !val) continue;
+
+        SvcIntent_Result_t res;
+        bool hit = false;
+        int64_t t0 = esp_timer_get_time();
+        for (int i = 0; i < repeat; i++) hit = Svc_Intent_Match(text, &res);
+        double us = (double)(esp_timer_get_time() - t0) / repeat;
+
+        const char *got = (hit && res.type < NAME_NUM) ? s_Names[res.type] : "NONE";
+        long got_val = hit ? (long)res.value : 0;
+        int ok = strcmp(got, expect) == 0 && got_val == atol(val);
+        if (!ok) fail = 1;
+        printf("%s,%s,%s,%s,%ld,%d,%.3f\n", text, expect, val, got, got_val, ok, us);
+    }
+    fclose(f);
+    return fail;
+}
+
+/* ---------------- 2. 动作 ---------------- */
+typedef struct {
+    const char *text;
+    DC_LightingData_t before;
+    DC_LightingData_t after;
+} ActionCase_t;
+
+static const ActionCase_t s_Actions[] = {
+    { "亮一点",         { true,  50, 50 }, { true,  70, 50 } },
+    { "亮一点",         { true,  95, 50 }, { true, 100, 50 } },
+    { "太亮了",         { true,  50, 50 }, { true,  30, 50 } },
+    { "暗一点",         { true,  10, 50 }, { true,   5, 50 } },     // 不低于 "最暗" 档，不直接关灯
+    { "关灯",           { true,  50, 50 }, { false, 50, 50 } },     // 关灯保留亮度，开灯时恢复
+    { "开灯",           { false, 50, 50 }, { true,  50, 50 } },
+    { "亮度调到八十",   { false, 50, 50 }, { true,  80, 50 } },     // 设定亮度时顺带开灯
+    { "亮度调到零",     { true,  50, 50 }, { false, 50, 50 } },
+    { "最亮",           { false, 20, 50 }, { true, 100, 50 } },
+    { "暖一点",         { true,  50, 50 }, { true,  50, 30 } },
+    { "冷一点",         { true,  50, 90 }, { true,  50, 100 } },
+    { "色温调到百分之十", { true, 50, 50 }, { true,  50, 10 } },
+};
+
+static int SameLight(const DC_LightingData_t *a, const DC_LightingData_t *b)
+{
+    return a->power == b->power && a->brightness == b->brightness && a->color_temp == b->color_temp;
+}
+
+static int RunActions(void)
+{
+    int fail = 0;
+    char *reply = NULL;
+
+    for (size_t i = 0; i < sizeof(s_Actions) / sizeof(s_Actions[0]); i++)
+    {
+        const ActionCase_t *c = &s_Actions[i];
+        s_Light = c->before;
+        if (!Svc_Intent_Process(c->text, &reply) || !reply || !SameLight(&s_Light, &c->after))
+        {
+            fprintf(stderr, "action fail: %s -> power=%d bri=%u cct=%u (expect %d/%u/%u)\n", c->text,
+                    s_Light.power, s_Light.brightness, s_Light.color_temp,
+                    c->after.power, c->after.brightness, c->after.color_temp);
+            fail = 1;
+        }
+        free(reply);
+        reply = NULL;
+    }
+
+    // 定时: 启动后每秒回调一次，到期关灯并回到 IDLE；取消后状态清零
+    s_Light = (DC_LightingData_t){ true, 60, 40 };
+    Svc_Intent_Process("三十秒后关灯", &reply);
+    free(reply);
+    if (s_Timer.state != TIMER_RUNNING || s_Timer.remain_sec != 30 || !host_esp_timer_last ||
+        host_esp_timer_last->period_us != 1000000)
+    {
+        fprintf(stderr, "action fail: timer not started (state=%d remain=%u)\n", s_Timer.state, (unsigned)s_Timer.remain_sec);
+        return 1;
+    }
+    for (int s = 0; s < 29; s++) host_esp_timer_last->callback(host_esp_timer_last->arg);
+    if (s_Timer.remain_sec != 1 || !s_Light.power)
+    {
+        fprintf(stderr, "action fail: timer expired early (remain=%u)\n", (unsigned)s_Timer.remain_sec);
+        fail = 1;
+    }
+    host_esp_timer_last->callback(host_esp_timer_last->arg);
+    if (s_Timer.state != TIMER_IDLE || s_Light.power || host_esp_timer_last->period_us != 0)
+    {
+        fprintf(stderr, "action fail: timer expiry did not switch the light off\n");
+        fail = 1;
+    }
+
+    Svc_Intent_Process("定时十分钟", &reply);
+    free(reply);
+    Svc_Intent_Process("取消定时", &reply);
+    free(reply);
+    if (s_Timer.state != TIMER_IDLE || s_Timer.remain_sec != 0 || host_esp_timer_last->period_us != 0)
+    {
+        fprintf(stderr, "action fail: timer cancel\n");
+        fail = 1;
+    }
+    return fail;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <corpus.csv> <repeat>\n", argv[0]);
+        return 2;
+    }
+    int repeat = atoi(argv[2]);
+    if (repeat < 1) repeat = 1;
+
+    int fail = RunCorpus(argv[1], repeat);
+    fail |= RunActions();
+    return fail;
+}
@@ -0,0 +1,230 @@
+/**
+ * 主机端唤醒词评估: 直接编译固件的 svc_wakeword.c，用监听任务每帧调用的 _process_frame
+ * (32bit -> 16bit 移位、WakeNet detect、负载统计) 回放 WAV 文件。
+ * WakeNet 只有 ESP32 / ESP32-S3 预编译库，主机上由 stub_esp32/wakenet_host.c 的替身模型
+ * (或 sim_7_2_5_kws_wav_eval.py --model-src 指定的实现) 提供同一个 esp_wn_iface_t 接口。
+ *
+ *   unit:  固定用例 (I2S 32bit 样本的移位与限幅、统计周期到达时的 audio_sec / cpu_load_pct)
+ *   eval:  逐帧回放一个 16kHz / 16bit / 单声道 WAV (样本左移 14 位还原成 I2S 读到的 32bit 数据)；
+ *          唤醒后跳过 <refractory_ms> 的音频 —— 板上唤醒后麦克风交给 ASR，状态机回到 IDLE 前 KWS 不读取
+ *
+ * 输出 (stdout，逐行):
+ *   unit:  case,<name>,<ok>   (失败时前面另有 fail,<name>,<line>,<条件>)
+ *   eval:  det,<ms>           每次唤醒在文件中的时刻
+ *          eval,<audio_ms>,<frames>,<detections>,<frame_us_mean>,<frame_us_max>,<chunk>
+ *
+ * 用法: kws_host unit | eval <wav> <refractory_ms>
+ * 任一固定用例失败退出码 1；WAV 无法读取或格式不符退出码 2。(由 sim_7_2_5_kws_wav_eval.py 编译并运行)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../ESP32_Firmware_Code/ESP32_Firmware/components/3_Service/src/svc_wakeword.c"
+
+/* ---------------- 外设 / 服务替身 (只有监听任务引用，回放时不创建任务) ---------------- */
+esp_err_t Dev_Audio_Read(void *buffer, size_t len, size_t *bytes_read)
+{
+    memset(buffer, 0, len);
+    *bytes_read = 0;
+    return ESP_OK;
+}
+
+esp_err_t EventBus_Send(EventType_t type, void *data, int len)
+{
+    (void)type;
+    (void)data;
+    (void)len;
+    return ESP_OK;
+}
+
+/** @brief 与 Svc_WakeWord_Init 相同的模型加载流程 (不创建监听任务) */
+static int Model_Load(void)
+{
+    srmodel_list_t *models = esp_srmodel_init("model");
+    char *wn_name = esp_srmodel_filter(models, ESP_WN_PREFIX, NULL);
+    if (!wn_name) return 0;
+    s_wakenet = esp_wn_handle_from_name(wn_name);
+    s_model = s_wakenet->create(wn_name, KWS_DET_MODE);
+    return s_model != NULL;
+}
+
+/* ---------------- unit: 探针模型 ---------------- */
+#define PROBE_CHUNK     512
+
+static int16_t s_ProbeLast[PROBE_CHUNK];
+static int     s_ProbeBusyUs;
+
+static int Probe_Chunk(model_iface_data_t *m) { (void)m; return PROBE_CHUNK; }
+
+static wakenet_state_t Probe_Detect(model_iface_data_t *m, int16_t *samples)
+{
+    (void)m;
+    memcpy(s_ProbeLast, samples, sizeof(s_ProbeLast));
+    int64_t t0 = esp_timer_get_time();
+    while (esp_timer_get_time() - t0 < s_ProbeBusyUs) {}
+    return WAKENET_NO_DETECT;
+}
+
+static const esp_wn_iface_t s_Probe = { .get_samp_chunksize = Probe_Chunk, .detect = Probe_Detect };
+
+static const char *s_Case;
+static int s_CaseFail, s_AnyFail;
+
+#define CHECK(c) do { if (!(c)) { printf("fail,%s,%d,%s\n", s_Case, __LINE__, #c); s_CaseFail = 1; } } while (0)
+
+static void Begin(const char *name)
+{
+    s_Case = name;
+    s_CaseFail = 0;
+    s_wakenet = &s_Probe;
+    s_model = NULL;
+    s_busy_us = s_audio_us = s_audio_us_total = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+static void End(void)
+{
+    printf("case,%s,%d\n", s_Case, !s_CaseFail);
+    s_AnyFail |= s_CaseFail;
+}
+
+/** @brief I2S 32bit 样本右移 14 位: 截断取整，超出 16bit 的部分限幅 */
+static void Case_Convert(void)
+{
+    static int32_t raw[PROBE_CHUNK];
+    static int16_t pcm[PROBE_CHUNK];
+    static const int32_t in[]  = { 0, 1 << 14, -(1 << 14), 32767 * (1 << 14), INT32_MAX, INT32_MIN,
+                                   12345 * (1 << 14) + 100, -1, -32768 * (1 << 14) };
+    static const int16_t out[] = { 0, 1, -1, 32767, 32767, -32768, 12345, -1, -32768 };
+
+    Begin("convert");
+    memset(raw, 0, sizeof(raw));
+    memcpy(raw, in, sizeof(in));
+    _process_frame(raw, pcm, PROBE_CHUNK);
+    for (unsigned i = 0; i < sizeof(out) / sizeof(out[0]); i++) CHECK(s_ProbeLast[i] == out[i]);
+    CHECK(s_ProbeLast[PROBE_CHUNK - 1] == 0);
+    End();
+}
+
+/** @brief KWS_STATS_PERIOD_MS 的音频到达时更新 audio_sec 与 cpu_load_pct，之后重新计时 */
+static void Case_Stats(void)
+{
+    static int32_t raw[PROBE_CHUNK];
+    static int16_t pcm[PROBE_CHUNK];
+    const int64_t frame_us = (int64_t)PROBE_CHUNK * 1000000 / AUDIO_SAMPLE_RATE;
+    const int frames = (int)(((int64_t)KWS_STATS_PERIOD_MS * 1000 + frame_us - 1) / frame_us);
+
+    Begin("stats");
+    memset(raw, 0, sizeof(raw));
+    s_ProbeBusyUs = (int)(frame_us / 20);       // 约 5% 的负载
+    for (int i = 0; i < frames - 1; i++) _process_frame(raw, pcm, PROBE_CHUNK);
+    CHECK(s_stats.audio_sec == 0);
+    _process_frame(raw, pcm, PROBE_CHUNK);
+    CHECK(s_stats.audio_sec == (uint32_t)(frames * frame_us / 1000000));
+    CHECK(s_stats.cpu_load_pct >= 4);
+    CHECK(s_audio_us == 0 && s_busy_us == 0);
+    s_ProbeBusyUs = 0;
+    End();
+}
+
+/* ---------------- eval: WAV 回放 ---------------- */
+static uint32_t Le32(const uint8_t *p) { return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24; }
+static uint16_t Le16(const uint8_t *p) { return (uint16_t)(p[0] | p[1] << 8); }
+
+/** @brief 读取 16kHz / 16bit / 单声道 PCM WAV，返回样本数 (失败 -1) */
+static long Wav_Load(const char *path, int16_t **out)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = malloc(size > 0 ? size : 1);
+    long got = buf ? (long)fread(buf, 1, size, f) : 0;
+    fclose(f);
+    if (got != size || size < 12 || memcmp(buf, "RIFF", 4) || memcmp(buf + 8, "WAVE", 4)) {
+        free(buf);
+        return -1;
+    }
+
+    int fmt_ok = 0;
+    long n = -1;
+    for (long pos = 12; pos + 8 <= size; ) {
+        uint32_t len = Le32(buf + pos + 4);
+        const uint8_t *body = buf + pos + 8;
+        if (pos + 8 + (long)len > size) break;
+        if (!memcmp(buf + pos, "fmt ", 4) && len >= 16) {
+            fmt_ok = Le16(body) == 1 && Le16(body + 2) == 1 && Le32(body + 4) == AUDIO_SAMPLE_RATE &&
+                     Le16(body + 14) == 16;
+        } else if (!memcmp(buf + pos, "data", 4) && fmt_ok) {
+            n = len / 2;
+            *out = malloc((n > 0 ? n : 1) * sizeof(int16_t));
+            for (long i = 0; i < n; i++) (*out)[i] = (int16_t)Le16(body + 2 * i);
+            break;
+        }
+        pos += 8 + len + (len & 1);
+    }
+    free(buf);
+    return n;
+}
+
+static int Eval(const char *path, int refractory_ms)
+{
+    int16_t *wav = NULL;
+    long n = Wav_Load(path, &wav);
+    if (n < 0) {
+        fprintf(stderr, "%s: not a %d Hz / 16-bit / mono PCM WAV\n", path, AUDIO_SAMPLE_RATE);
+        return 2;
+    }
+    if (!Model_Load() || s_wakenet->get_samp_rate(s_model) != AUDIO_SAMPLE_RATE) {
+        fprintf(stderr, "WakeNet model load failed or sample rate != %d\n", AUDIO_SAMPLE_RATE);
+        free(wav);
+        return 2;
+    }
+
+    int chunk = s_wakenet->get_samp_chunksize(s_model);
+    int32_t *raw = malloc(chunk * sizeof(int32_t));
+    int16_t *pcm = malloc(chunk * sizeof(int16_t));
+    long refractory = (long)refractory_ms * AUDIO_SAMPLE_RATE / 1000;
+    long frames = 0;
+    int64_t sum_us = 0, max_us = 0;
+
+    for (long pos = 0; pos + chunk <= n; ) {
+        for (int i = 0; i < chunk; i++) raw[i] = (int32_t)wav[pos + i] * (1 << 14);
+
+        int64_t t0 = esp_timer_get_time();
+        wakenet_state_t state = _process_frame(raw, pcm, chunk);
+        int64_t dt = esp_timer_get_time() - t0;
+        frames++;
+        sum_us += dt;
+        if (dt > max_us) max_us = dt;
+
+        pos += chunk;
+        if (state == WAKENET_DETECTED) {
+            s_stats.detections++;
+            printf("det,%ld\n", pos * 1000 / AUDIO_SAMPLE_RATE);
+            pos += refractory;
+        }
+    }
+
+    printf("eval,%ld,%ld,%lu,%.2f,%lld,%d\n", n * 1000 / AUDIO_SAMPLE_RATE, frames,
+           (unsigned long)s_stats.detections, frames ? (double)sum_us / frames : 0.0, (long long)max_us, chunk);
+    s_wakenet->destroy(s_model);
+    free(raw);
+    free(pcm);
+    free(wav);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    if (argc >= 2 && strcmp(argv[1], "unit") == 0) {
+        Case_Convert();
+        Case_Stats();
+        return s_AnyFail;
+    }
+    if (argc >= 4 && strcmp(argv[1], "eval") == 0) return Eval(argv[2], atoi(argv[3]));
+    fprintf(stderr, "usage: %s unit | eval <wav> <refractory_ms>\n", argv[0]);
+    return 2;
+}
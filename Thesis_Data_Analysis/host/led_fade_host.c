@@ -0,0 +1,296 @@
+/**
+ * 主机端 LED 渐变引擎测试: 直接编译固件的 LED_Fade.c、LED_Mix.c 与 LED_CIE_LUT.c，
+ * 按 LED.c 的方式模拟 DMA1_Ch3 循环读取两个块、读完一半触发中断填充 (LED_FadeTo 的
+ * 起始逻辑与中断处理也与 LED.c 相同)，逐 PWM 周期记录写入 CCR1 / CCR2 的值。
+ *
+ * 场景:
+ *   step_*   单次渐变: 亮度 / 色温阶跃，4 种缓动曲线 x 150 / 400 / 1000ms
+ *   prox     无极调光: 手掌距离随机游走，每 50ms 一个新目标，FADE_PROX_MS 匀速渐变衔接
+ *   drag     ESP32 滑块拖动: 每 50ms 一帧，按与上一帧的间隔匀速渐变 (svc_lighting.c 的策略)
+ * 对照 (old): 同样的目标序列，每个指令立即跳变 (旧版 SetRawPWM 的行为)。
+ *
+ * 以块 (16 个 PWM 周期 = 7.3ms，人眼积分时间内) 为单位计算总光通量的 CIE L*:
+ *   reach_ms   单次渐变: 暖 / 冷块平均最后一次不等于终值的时刻 (应与设定时长相差不超过 2 块)
+ *   mono       单次渐变: 任一路块平均与总体方向相反、变化超过 1 个 PWM 计数的次数 (应为 0)
+ *   final_ok   结束后两个块都是终值的静止抖动序列，并且中断已关闭
+ *   dL_new     相邻块之间 L* 的最大变化 (渐变引擎)
+ *   dL_old     同一目标序列立即跳变时相邻块 L* 的最大变化
+ *   refills    中断填充次数 / 秒 (渐变期间)
+ *
+ * 输出 (CSV 格式，无表头，每个场景一行):
+ *   name,ease,ms,reach_ms,mono,final_ok,dL_new,dL_old,refills_per_s
+ * 给出目录时另存逐块轨迹 <dir>/led_fade_<name>.csv: t_ms,L_new,L_old
+ *
+ * 用法: led_fade_host <轨迹目录 或 -> <FADE_PROX_MS>
+ * (由 sim_7_1_9_led_fade.py 编译并运行)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "LED_Fade.h"
+
+#define PERIOD_US       ((double)LED_PWM_PERIOD / LED_TIM_CLK_MHZ)
+#define MAX_BLOCKS      4096
+
+/* ---------------- 模拟 LED.c ---------------- */
+static uint16_t s_Buf[LED_BLOCK_LEN * 2];
+static LED_Fade_t s_Fade;
+static uint8_t s_ItOn;
+static int s_Half;              // DMA 正在读取的一半
+static uint32_t s_Refills;
+
+static void Led_Hold(void)
+{
+    s_Fade.State = LED_FADE_IDLE;
+    LED_Fade_Hold(&s_Fade, &s_Buf[0]);
+    LED_Fade_Hold(&s_Fade, &s_Buf[LED_BLOCK_LEN]);
+}
+
+static void Led_SetLevel(uint16_t bri, uint16_t cct)
+{
+    s_ItOn = 0;
+    LED_Fade_Set(&s_Fade, bri, cct);
+    Led_Hold();
+}
+
+static void Led_FadeTo(uint16_t bri, uint16_t cct, uint32_t ms, uint8_t ease)
+{
+    if (ms == 0) { Led_SetLevel(bri, cct); return; }
+
+    s_ItOn = 0;
+    if (s_Fade.State == LED_FADE_IDLE)
+    {
+        LED_Fade_Start(&s_Fade, bri, cct, ms, ease);
+        LED_Fade_Refill(&s_Fade, &s_Buf[(1 - s_Half) * LED_BLOCK_LEN]);
+    }
+    else
+    {
+        LED_Fade_Start(&s_Fade, bri, cct, ms, ease);
+    }
+    s_ItOn = 1;
+}
+
+/** @brief DMA 读完当前一半: 中断填充这一半，切换到另一半 */
+static void Dma_HalfDone(void)
+{
+    if (s_ItOn)
+    {
+        s_Refills++;
+        if (!LED_Fade_Refill(&s_Fade, &s_Buf[s_Half * LED_BLOCK_LEN])) s_ItOn = 0;
+    }
+    s_Half ^= 1;
+}
+
+/* ---------------- 指标 ---------------- */
+static double Lstar(double y)
+{
+    return (y > 216.0 / 24389.0) ? 116.0 * cbrt(y) - 16.0 : y * 24389.0 / 27.0;
+}
+
+static double BlockL(uint32_t sum)
+{
+    return Lstar((double)sum / ((double)LED_PWM_PERIOD * LED_DITHER_FRAMES));
+}
+
+typedef struct { uint32_t at_block; uint16_t bri, cct; uint32_t ms; uint8_t ease; } Cmd_t;
+
+typedef struct {
+    uint32_t sum_new[MAX_BLOCKS];   // 每块两路 CCR 之和 (光通量，两路光通量相同)
+    uint32_t sum_w[MAX_BLOCKS];     // 每块暖 / 冷各自的 CCR 之和
+    uint32_t sum_c[MAX_BLOCKS];
+    uint32_t sum_old[MAX_BLOCKS];
+    uint32_t n;
+    uint32_t refills;
+    uint32_t fade_blocks;
+    uint8_t final_ok;
+} Run_t;
+
+/** @brief 执行指令序列，逐块记录输出 */
+static void Simulate(const Cmd_t *cmds, int ncmd, uint16_t bri0, uint16_t cct0, uint32_t nblocks, Run_t *r)
+{
+    uint32_t old_w, old_c;
+    uint16_t old_frames[LED_BLOCK_LEN];
+    int ci = 0;
+
+    memset(r, 0, sizeof(*r));
+    s_Half = 0;
+    s_Refills = 0;
+    Led_SetLevel(bri0, cct0);
+    LED_Mix(bri0, cct0, &old_w, &old_c);
+
+    for (uint32_t b = 0; b < nblocks && b < MAX_BLOCKS; b++)
+    {
+        // 指令在块的中间到达 (DMA 正在读取 s_Half)
+        while (ci < ncmd && cmds[ci].at_block == b)
+        {
+            Led_FadeTo(cmds[ci].bri, cmds[ci].cct, cmds[ci].ms, cmds[ci].ease);
+            LED_Mix(cmds[ci].bri, cmds[ci].cct, &old_w, &old_c);
+            ci++;
+        }
+        if (s_ItOn) r->fade_blocks++;
+
+        const uint16_t *half = &s_Buf[s_Half * LED_BLOCK_LEN];
+        uint32_t sw = 0, sc = 0, sum;
+        for (int i = 0; i < LED_BLOCK_LEN; i += 2)
+        {
+            sw += half[i];
+            sc += half[i + 1];
+        }
+        r->sum_w[b] = sw;
+        r->sum_c[b] = sc;
+        r->sum_new[b] = sw + sc;
+
+        LED_Dither_Fill(old_w, &old_frames[0], 2);
+        LED_Dither_Fill(old_c, &old_frames[1], 2);
+        sum = 0;
+        for (int i = 0; i < LED_BLOCK_LEN; i++) sum += old_frames[i];
+        r->sum_old[b] = sum;
+
+        Dma_HalfDone();
+        r->n = b + 1;
+    }
+    r->refills = s_Refills;
+
+    // 结束后: 中断已关闭，两半都是终值的静止序列
+    uint16_t hold[LED_BLOCK_LEN];
+    LED_Fade_Hold(&s_Fade, hold);
+    r->final_ok = !s_ItOn && s_Fade.State == LED_FADE_IDLE &&
+                  memcmp(hold, &s_Buf[0], sizeof(hold)) == 0 &&
+                  memcmp(hold, &s_Buf[LED_BLOCK_LEN], sizeof(hold)) == 0;
+}
+
+static void MaxDelta(const Run_t *r, double *dl_new, double *dl_old)
+{
+    *dl_new = *dl_old = 0;
+    for (uint32_t b = 1; b < r->n; b++)
+    {
+        double dn = fabs(BlockL(r->sum_new[b]) - BlockL(r->sum_new[b - 1]));
+        double dold = fabs(BlockL(r->sum_old[b]) - BlockL(r->sum_old[b - 1]));
+        if (dn > *dl_new) *dl_new = dn;
+        if (dold > *dl_old) *dl_old = dold;
+    }
+}
+
+static void SaveTrace(const char *dir, const char *name, const Run_t *r)
+{
+    if (!dir) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/led_fade_%s.csv", dir, name);
+    FILE *f = fopen(path, "w");
+    if (!f) { perror(path); return; }
+    fprintf(f, "t_ms,L_new,L_old\n");
+    for (uint32_t b = 0; b < r->n; b++)
+    {
+        fprintf(f, "%.2f,%.4f,%.4f\n", b * PERIOD_US * LED_DITHER_FRAMES / 1000.0,
+                BlockL(r->sum_new[b]), BlockL(r->sum_old[b]));
+    }
+    fclose(f);
+}
+
+static uint32_t MsToBlock(double ms)
+{
+    return (uint32_t)(ms * 1000.0 / (PERIOD_US * LED_DITHER_FRAMES));
+}
+
+static void Report(const char *name, int ease, uint32_t ms, double reach_ms, int mono, const Run_t *r)
+{
+    double dn, dold;
+    MaxDelta(r, &dn, &dold);
+    double fade_s = r->fade_blocks * PERIOD_US * LED_DITHER_FRAMES / 1e6;
+    printf("%s,%d,%u,%.2f,%d,%d,%.4f,%.4f,%.1f\n", name, ease, (unsigned)ms, reach_ms, mono, r->final_ok,
+           dn, dold, fade_s > 0 ? r->refills / fade_s : 0.0);
+}
+
+/* ---------------- 场景 ---------------- */
+static Run_t s_Run;
+
+static void StepCase(const char *dir, const char *name, uint16_t b0, uint16_t c0, uint16_t b1, uint16_t c1,
+                     uint32_t ms, uint8_t ease)
+{
+    Cmd_t cmd = { 4, b1, c1, ms, ease };
+    uint32_t start = cmd.at_block;
+    Simulate(&cmd, 1, b0, c0, start + MsToBlock(ms) + 16, &s_Run);
+
+    // 到达时刻: 最后一个 (暖, 冷) 不等于终值的块之后
+    uint32_t last = start, end = s_Run.n - 1;
+    for (uint32_t b = start; b < s_Run.n; b++)
+        if (s_Run.sum_w[b] != s_Run.sum_w[end] || s_Run.sum_c[b] != s_Run.sum_c[end]) last = b + 1;
+    double reach_ms = (last - start) * PERIOD_US * LED_DITHER_FRAMES / 1000.0;
+
+    // 单调: 任一路的块平均与总体方向相反、变化超过 1 个计数 (每块 16 帧)
+    int sw = (s_Run.sum_w[end] >= s_Run.sum_w[0]) ? 1 : -1;
+    int sc = (s_Run.sum_c[end] >= s_Run.sum_c[0]) ? 1 : -1;
+    int mono = 0;
+    for (uint32_t b = 1; b < s_Run.n; b++)
+    {
+        int32_t dw = (int32_t)s_Run.sum_w[b] - (int32_t)s_Run.sum_w[b - 1];
+        int32_t dc = (int32_t)s_Run.sum_c[b] - (int32_t)s_Run.sum_c[b - 1];
+        if (dw * sw < -(int32_t)LED_DITHER_FRAMES || dc * sc < -(int32_t)LED_DITHER_FRAMES) mono++;
+    }
+
+    char full[64];
+    snprintf(full, sizeof(full), "%s_e%d_%u", name, ease, (unsigned)ms);
+    Report(full, ease, ms, reach_ms, mono, &s_Run);
+    if (ease == LED_EASE_IN_OUT && ms == 400) SaveTrace(dir, name, &s_Run);
+}
+
+static uint32_t s_Rand = 20240601;
+static int Rand(int n)
+{
+    s_Rand = s_Rand * 1103515245u + 12345u;
+    return (int)((s_Rand >> 8) % (uint32_t)n);
+}
+
+/** @brief 连续目标: 每 50ms 一个新亮度 (随机游走)，gap_fade = 1 时按间隔渐变，否则固定时长 */
+static void ChainCase(const char *dir, const char *name, uint32_t fade_ms, uint8_t gap_fade)
+{
+    static Cmd_t cmds[128];
+    int n = 0;
+    int bri = 300;
+    double t = 30;
+    while (n < 100)
+    {
+        bri += Rand(121) - 60;
+        if (bri < 0) bri = 0;
+        if (bri > 1000) bri = 1000;
+        double gap = gap_fade ? 45 + Rand(20) : 50;     // 滑块 / 无极调光的更新间隔
+        cmds[n].at_block = MsToBlock(t);
+        cmds[n].bri = (uint16_t)bri;
+        cmds[n].cct = 500;
+        cmds[n].ms = gap_fade ? (uint32_t)gap : fade_ms;
+        cmds[n].ease = LED_EASE_LINEAR;
+        n++;
+        t += gap;
+    }
+    Simulate(cmds, n, 300, 500, MsToBlock(t + 200), &s_Run);
+    Report(name, LED_EASE_LINEAR, fade_ms, 0, 0, &s_Run);
+    SaveTrace(dir, name, &s_Run);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <trace_dir|-> <FADE_PROX_MS>\n", argv[0]);
+        return 2;
+    }
+    const char *dir = (argv[1][0] == '-') ? NULL : argv[1];
+    uint32_t prox_ms = (uint32_t)atoi(argv[2]);
+    static const uint32_t durations[] = { 150, 400, 1000 };
+
+    LED_Mix_Init(100, 100);
+
+    for (int e = LED_EASE_LINEAR; e <= LED_EASE_IN_OUT; e++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            StepCase(dir, "up", 0, 500, 1000, 500, durations[i], (uint8_t)e);
+            StepCase(dir, "down", 800, 200, 50, 200, durations[i], (uint8_t)e);
+            StepCase(dir, "cct", 600, 0, 600, 1000, durations[i], (uint8_t)e);
+        }
+    }
+    ChainCase(dir, "prox", prox_ms, 0);
+    ChainCase(dir, "drag", 0, 1);
+    return 0;
+}
@@ -0,0 +1,125 @@
+/**
+ * 主机端 LED 混光测试: 直接编译固件的 LED_Mix.c 与生成的 LED_CIE_LUT.c，
+ * 检查感知亮度映射、恒光通量混光和时间抖动序列。
+ *
+ * 检查项:
+ *   flat       亮度 1~1000 中线性输出与上一档相同的档数 (应为 0，即每档都有变化)
+ *   mono       任一色温下，总光通量随亮度下降的次数 (应为 0)
+ *   lumen_err  同一亮度下各色温 (0~1000，步长 10) 总光通量与理想值的最大偏差，
+ *              换算为 CIE L* 差值 (感知量纲，相邻亮度档约 0.1)
+ *   dither_err 0~LED_DUTY_MAX_Q4 全部占空比中，16 帧平均值不等于 duty/16 或
+ *              帧间差超过 1 个计数的个数 (应为 0)
+ *   dL_*       相邻亮度档之间的 CIE L* 步长: 新映射 (含 Q4 量化) 与旧版线性映射
+ *              (占空比 = 亮度 / 1000) 的最大 / 最小值
+ *
+ * 输出一行指标 (CSV 格式，无表头):
+ *   warm_flux,cold_flux,flat,mono,lumen_err,dither_err,dL_new_max,dL_new_min,dL_old_max,dL_old_min
+ * 轨迹 CSV: bri,L_old,L_new,duty_new_pct,warm_q4,cold_q4 (色温 500)
+ *
+ * 用法: led_mix_host <轨迹 CSV 或 -> <暖光光通量> <冷光光通量>
+ * (由 sim_7_1_8_led_cie_lut.py 编译并运行)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "LED_Mix.h"
+
+/** @brief 相对亮度 (0~1) -> CIE L* (0~100) */
+static double Lstar(double y)
+{
+    return (y > 216.0 / 24389.0) ? 116.0 * cbrt(y) - 16.0 : y * 24389.0 / 27.0;
+}
+
+static int CheckDither(void)
+{
+    uint16_t frames[LED_DITHER_FRAMES];
+    int err = 0;
+
+    for (uint32_t d = 0; d <= LED_DUTY_MAX_Q4; d++)
+    {
+        LED_Dither_Fill(d, frames, 1);
+        uint32_t sum = 0;
+        uint16_t lo = 0xFFFF, hi = 0;
+        for (unsigned i = 0; i < LED_DITHER_FRAMES; i++)
+        {
+            sum += frames[i];
+            if (frames[i] < lo) lo = frames[i];
+            if (frames[i] > hi) hi = frames[i];
+        }
+        if (sum != d || hi - lo > 1 || hi > LED_PWM_PERIOD) err++;
+    }
+    return err;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        fprintf(stderr, "usage: %s <trace.csv|-> <warm_flux> <cold_flux>\n", argv[0]);
+        return 2;
+    }
+    const char *trace = argv[1];
+    int fw = atoi(argv[2]);
+    int fc = atoi(argv[3]);
+    int fmin = (fw < fc) ? fw : fc;
+
+    LED_Mix_Init((uint16_t)fw, (uint16_t)fc);
+
+    FILE *ft = NULL;
+    if (trace[0] != '-')
+    {
+        ft = fopen(trace, "w");
+        if (!ft) { perror(trace); return 2; }
+        fprintf(ft, "bri,L_old,L_new,duty_new_pct,warm_q4,cold_q4\n");
+    }
+
+    int flat = 0, mono = 0;
+    double lumen_err = 0;
+    double dl_new_max = 0, dl_new_min = 1e9, dl_old_max = 0, dl_old_min = 1e9;
+    double prev_lumen[101] = {0};
+    double l_new_prev = 0, l_old_prev = 0;
+
+    for (int b = 0; b <= 1000; b++)
+    {
+        uint32_t y = LED_Mix_Linear((uint16_t)b);
+        if (b > 0 && y == LED_Mix_Linear((uint16_t)(b - 1))) flat++;
+
+        for (int k = 0; k <= 100; k++)
+        {
+            uint32_t w, c;
+            LED_Mix((uint16_t)b, (uint16_t)(k * 10), &w, &c);
+
+            // 总光通量以较暗一路满占空比为 1 个单位: (w*fw + c*fc) / fmin，理想值 = y
+            double lumen = ((double)w * fw + (double)c * fc) / fmin;
+            double e = fabs(Lstar(lumen / LED_DUTY_MAX_Q4) - Lstar((double)y / LED_DUTY_MAX_Q4));
+            if (e > lumen_err) lumen_err = e;
+            if (b > 0 && lumen < prev_lumen[k]) mono++;
+            prev_lumen[k] = lumen;
+
+            if (k == 50 && ft)
+            {
+                double l_new = Lstar((double)y / LED_DUTY_MAX_Q4);
+                fprintf(ft, "%d,%.4f,%.4f,%.5f,%u,%u\n", b, Lstar(b / 1000.0), l_new,
+                        100.0 * y / LED_DUTY_MAX_Q4, (unsigned)w, (unsigned)c);
+            }
+        }
+
+        double l_new = Lstar((double)y / LED_DUTY_MAX_Q4);
+        double l_old = Lstar(b / 1000.0);
+        if (b > 0)
+        {
+            double dn = l_new - l_new_prev, dold = l_old - l_old_prev;
+            if (dn > dl_new_max) dl_new_max = dn;
+            if (dn < dl_new_min) dl_new_min = dn;
+            if (dold > dl_old_max) dl_old_max = dold;
+            if (dold < dl_old_min) dl_old_min = dold;
+        }
+        l_new_prev = l_new;
+        l_old_prev = l_old;
+    }
+    if (ft) fclose(ft);
+
+    printf("%d,%d,%d,%d,%.4f,%d,%.4f,%.4f,%.4f,%.4f\n", fw, fc, flat, mono, lumen_err, CheckDither(),
+           dl_new_max, dl_new_min, dl_old_max, dl_old_min);
+    return 0;
+}
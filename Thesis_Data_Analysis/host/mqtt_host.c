@@ -0,0 +1,229 @@
+/**
+ * 主机端 MQTT 上报测试: 直接编译 ESP32 固件的 agent_mqtt.c / agent_mqtt_outbox.c
+ * (FreeRTOS / esp-mqtt / NVS 用 stub_esp32 桩，esp-mqtt 桩是真正连接 broker 的 MQTT 3.1.1 客户端)，
+ * 本文件提供 DataCenter 的替身并按脚本改变灯光状态。
+ *
+ * sweep:  以 <rate_hz> 的频率模拟拖动亮度 / 色温滑块 <seconds> 秒 (三角波，每次变化都调用
+ *         Agent_MQTT_Publish_Status，与 DataCenter 变更回调的调用方式一致)，结束后等待最后一个合并窗口发出。
+ * outage: 按 main.c 的顺序先初始化发件箱，在 Agent_MQTT_Init 之前发出 3 条事件，连上后每 <event_ms>
+ *         发一条带序号的事件 {"event":"seq","val":N}、每 4 条事件改变一次亮度，共 <seconds> 秒
+ *         (期间由 sim_7_2_4_mqtt_outage.py 停止并重启 broker)；之后等待发件箱清空，打印统计后保持连接，
+ *         等待测试脚本强制结束进程以检查遗嘱消息。
+ *
+ * 输出 (stdout，逐行 key,v1,v2,...):
+ *   connected,<ms>                                    连上 broker 所用时间
+ *   sweep,<requests>,<ms>                             滑块扫描的请求数与时长
+ *   final,<power>,<brightness>,<color_temp>,<temp>,<hum>   最终状态 (订阅端还原的结果应与之相同)
+ *   stats,<requests>,<publishes>,<snapshots>,<suppressed>,<bytes>
+ *   events,<count>                                    outage: 发出的事件数 (序号 0 ~ count-1)
+ *   outbox,<queued>,<spilled>,<dropped>,<replayed>,<pending>
+ *   nvs,<writes>,<bytes>,<erases>                     outage: NVS 写入次数 / 字节数 / 擦除次数
+ *   done                                              outage: 统计已打印，等待被结束
+ *
+ * 用法: mqtt_host sweep <seconds> <rate_hz>
+ *       mqtt_host outage <seconds> <event_ms>
+ * broker 地址由环境变量 HOST_MQTT_HOST / HOST_MQTT_PORT 指定
+ * (由 sim_7_2_3_mqtt_throughput.py / sim_7_2_4_mqtt_outage.py 编译并运行)
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "agents/agent_mqtt.h"
+#include "agents/agent_mqtt_outbox.h"
+#include "data_center.h"
+#include "esp_timer.h"
+#include "nvs.h"
+
+/* ---------------- DataCenter 的替身 (发布任务与脚本线程并发访问) ---------------- */
+static pthread_mutex_t s_Lock = PTHREAD_MUTEX_INITIALIZER;
+static DC_LightingData_t s_Light = { true, 50, 50 };
+static DC_EnvData_t s_Env;
+
+void DataCenter_Get_Lighting(DC_LightingData_t *out_data)
+{
+    pthread_mutex_lock(&s_Lock);
+    *out_data = s_Light;
+    pthread_mutex_unlock(&s_Lock);
+}
+
+void DataCenter_Set_Lighting(const DC_LightingData_t *in_data)
+{
+    pthread_mutex_lock(&s_Lock);
+    s_Light = *in_data;
+    pthread_mutex_unlock(&s_Lock);
+}
+
+void DataCenter_Get_Env(DC_EnvData_t *out_data)
+{
+    pthread_mutex_lock(&s_Lock);
+    *out_data = s_Env;
+    pthread_mutex_unlock(&s_Lock);
+}
+
+static int64_t NowMs(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+/** @brief 等待连接成功: 连上后发布任务会立即发一次快照 */
+static int WaitConnected(int timeout_ms)
+{
+    int64_t t0 = NowMs();
+    Agent_MQTT_Stats_t st;
+    do {
+        Agent_MQTT_Get_Stats(&st);
+        if (st.snapshots > 0) return (int)(NowMs() - t0);
+        usleep(10 * 1000);
+    } while (NowMs() - t0 < timeout_ms);
+    return -1;
+}
+
+/** @brief 三角波: 周期 period 步，在 [lo, hi] 之间往返 */
+static uint8_t Triangle(int step, int period, int lo, int hi)
+{
+    int half = period / 2;
+    int k = step % period;
+    int v = k < half ? k : period - k;
+    return (uint8_t)(lo + (hi - lo) * v / half);
+}
+
+static void PrintFinal(void)
+{
+    DC_LightingData_t l;
+    DC_EnvData_t e;
+    DataCenter_Get_Lighting(&l);
+    DataCenter_Get_Env(&e);
+    printf("final,%d,%d,%d,%d,%d\n", l.power ? 1 : 0, l.brightness, l.color_temp, e.indoor_temp, e.indoor_hum);
+}
+
+static void PrintStats(void)
+{
+    Agent_MQTT_Stats_t st;
+    Agent_MQTT_Get_Stats(&st);
+    printf("stats,%u,%u,%u,%u,%u\n", (unsigned)st.requests, (unsigned)st.publishes,
+           (unsigned)st.snapshots, (unsigned)st.suppressed, (unsigned)st.bytes);
+}
+
+static void PrintOutbox(void)
+{
+    Agent_MQTT_Outbox_Stats_t ob;
+    host_nvs_stats_t nvs;
+    Agent_MQTT_Outbox_Get_Stats(&ob);
+    host_nvs_get_stats(&nvs);
+    printf("outbox,%u,%u,%u,%u,%u\n", (unsigned)ob.queued, (unsigned)ob.spilled, (unsigned)ob.dropped,
+           (unsigned)ob.replayed, (unsigned)ob.pending);
+    printf("nvs,%u,%u,%u\n", (unsigned)nvs.writes, (unsigned)nvs.bytes, (unsigned)nvs.erases);
+}
+
+/* ---------------- sweep: 拖动滑块 ---------------- */
+static int RunSweep(int seconds, int rate_hz)
+{
+    s_Env.indoor_temp = 24;
+    s_Env.indoor_hum = 45;
+
+    Agent_MQTT_Init();
+    int conn_ms = WaitConnected(5000);
+    if (conn_ms < 0)
+    {
+        fprintf(stderr, "mqtt_host: broker not reachable\n");
+        return 1;
+    }
+    printf("connected,%d\n", conn_ms);
+
+    const int steps = seconds * rate_hz;
+    const int period_us = 1000000 / rate_hz;
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 1; i <= steps; i++)
+    {
+        DC_LightingData_t l;
+        DataCenter_Get_Lighting(&l);
+        l.brightness = Triangle(i, 2 * rate_hz, 10, 100);     // 2 秒一个来回
+        l.color_temp = Triangle(i / 4, rate_hz, 0, 100);      // 色温变化慢一些
+        DataCenter_Set_Lighting(&l);
+        Agent_MQTT_Publish_Status();
+
+        int64_t next = t0 + (int64_t)i * period_us;
+        int64_t wait = next - esp_timer_get_time();
+        if (wait > 0) usleep((useconds_t)wait);
+    }
+    printf("sweep,%d,%lld\n", steps, (long long)((esp_timer_get_time() - t0) / 1000));
+
+    // 等最后一个合并窗口发出并收到 PUBACK
+    usleep(1000 * 1000);
+    PrintFinal();
+    PrintStats();
+    fflush(stdout);
+
+    Agent_MQTT_Stop();
+    return 0;
+}
+
+/* ---------------- outage: broker 停止 / 重启期间持续产生事件 ---------------- */
+static void SendSeqEvent(int seq)
+{
+    char json[48];
+    snprintf(json, sizeof(json), "{\"event\":\"seq\",\"val\":%d}", seq);
+    Agent_MQTT_Publish_Event(json);
+}
+
+static int RunOutage(int seconds, int event_ms)
+{
+    s_Env.indoor_temp = 24;
+    s_Env.indoor_hum = 45;
+
+    // 与 main.c 相同: 发件箱先就绪，联网前 (Agent_MQTT_Init 之前) 的事件进入发件箱
+    Agent_MQTT_Outbox_Init();
+    int seq = 0;
+    for (; seq < 3; seq++) SendSeqEvent(seq);
+
+    Agent_MQTT_Init();
+    int conn_ms = WaitConnected(5000);
+    if (conn_ms < 0)
+    {
+        fprintf(stderr, "mqtt_host: broker not reachable\n");
+        return 1;
+    }
+    printf("connected,%d\n", conn_ms);
+
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 1; (esp_timer_get_time() - t0) / 1000 < seconds * 1000; i++)
+    {
+        SendSeqEvent(seq++);
+        if (i % 4 == 0)
+        {
+            DC_LightingData_t l;
+            DataCenter_Get_Lighting(&l);
+            l.brightness = Triangle(i / 4, 40, 10, 100);
+            DataCenter_Set_Lighting(&l);
+            Agent_MQTT_Publish_Status();
+        }
+        int64_t wait = t0 + (int64_t)i * event_ms * 1000 - esp_timer_get_time();
+        if (wait > 0) usleep((useconds_t)wait);
+    }
+    printf("events,%d\n", seq);
+
+    // 等待发件箱回放完毕 (最多 30 秒)，再等最后一个合并窗口
+    for (int i = 0; i < 300 && Agent_MQTT_Outbox_Pending() > 0; i++) usleep(100 * 1000);
+    usleep(1000 * 1000);
+    PrintFinal();
+    PrintStats();
+    PrintOutbox();
+    printf("done\n");
+    fflush(stdout);
+
+    for (;;) pause();
+}
+
+int main(int argc, char **argv)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    if (argc >= 4 && strcmp(argv[1], "sweep") == 0)
+        return RunSweep(atoi(argv[2]), atoi(argv[3]));
+    if (argc >= 4 && strcmp(argv[1], "outage") == 0)
+        return RunOutage(atoi(argv[2]), atoi(argv[3]));
+
+    fprintf(stderr, "usage: %s sweep <seconds> <rate_hz> | outage <seconds> <event_ms>\n", argv[0]);
+    return 2;
+}
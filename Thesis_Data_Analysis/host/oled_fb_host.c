@@ -0,0 +1,195 @@
+/**
+ * 主机端 OLED 渲染测试: 直接编译固件的 OLED_FB.c + UIManager.c + SystemModel.c，
+ * 用本文件替换 OLED.c 的硬件部分 (写页回调写入模拟 GDDRAM，并统计 I2C 字节数)。
+ *
+ * 每次模型更新后运行 UIManager_Task 直到 SCHED_DONE，然后:
+ *   - 校验模拟 GDDRAM 与帧缓冲逐字节一致 (脏区跟踪漏刷时退出码 1)
+ *   - 导出一帧 PBM (P4) 图像
+ *   - 输出一行 CSV: 本次更新的事务数 / 字节数，以及旧版逐字符刷新需要的字节数
+ *
+ * 用法: oled_fb_host <帧输出目录> <CSV 路径>
+ * (由 sim_7_1_5_oled_render.py 编译并运行)
+ */
+#include <stdio.h>
+#include <string.h>
+#include "OLED.h"
+#include "OLED_FB.h"
+#include "UIManager.h"
+#include "SystemModel.h"
+#include "Scheduler.h"
+
+// I2C 字节数 (含地址字节): 命令事务 = 地址 + 0x00 + 3 个命令，数据事务 = 地址 + 0x40 + 数据
+#define CMD_XFER_BYTES      5
+#define DATA_XFER_OVERHEAD  2
+// 旧版 OLED_ShowChar: 两次 SetCursor (各 3 个单命令事务) + 16 个单字节数据事务，每个事务 3 字节
+#define LEGACY_CHAR_BYTES   ((3 + 3 + 16) * 3)
+
+static uint8_t s_GDDRAM[OLED_PAGES][OLED_WIDTH];
+static uint32_t s_Bytes, s_Pages, s_Cols;
+
+static void Host_WritePage(uint8_t page, uint8_t col, const uint8_t *data, uint8_t len)
+{
+    if (page >= OLED_PAGES || (uint16_t)col + len > OLED_WIDTH)
+    {
+        fprintf(stderr, "write out of range: page=%u col=%u len=%u\n", page, col, len);
+        return;
+    }
+    memcpy(&s_GDDRAM[page][col], data, len);
+    s_Bytes += CMD_XFER_BYTES + DATA_XFER_OVERHEAD + len;
+    s_Pages++;
+    s_Cols += len;
+}
+
+/* ---------------- OLED.c 的替身 ---------------- */
+
+uint8_t OLED_Flush_Step(void)
+{
+    return OLED_FB_Flush(Host_WritePage, 1);
+}
+
+void OLED_Refresh(void)
+{
+    while (OLED_Flush_Step());
+}
+
+void OLED_Init(void)
+{
+    memset(s_GDDRAM, 0xA5, sizeof(s_GDDRAM));   // 上电后屏幕内容未知
+    OLED_FB_Reset();
+    OLED_Refresh();
+}
+
+/* ---------------- 校验与导出 ---------------- */
+
+/** @brief 旧版按 8x16 字符格刷新: 统计内容变化的字符格数 */
+static uint32_t Count_Changed_Cells(uint8_t before[OLED_PAGES][OLED_WIDTH])
+{
+    const uint8_t (*fb)[OLED_WIDTH] = OLED_FB_GetBuffer();
+    uint32_t n = 0;
+    for (int row = 0; row < OLED_PAGES / 2; row++)
+    {
+        for (int cell = 0; cell < OLED_WIDTH / 8; cell++)
+        {
+            int x = cell * 8;
+            if (memcmp(&before[row * 2][x], &fb[row * 2][x], 8) != 0 ||
+                memcmp(&before[row * 2 + 1][x], &fb[row * 2 + 1][x], 8) != 0) n++;
+        }
+    }
+    return n;
+}
+
+static int Write_PBM(const char *dir, int idx)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%03d.pbm", dir, idx);
+    FILE *f = fopen(path, "wb");
+    if (!f) { perror(path); return -1; }
+
+    fprintf(f, "P4\n%d %d\n", OLED_WIDTH, OLED_HEIGHT);
+    for (int y = 0; y < OLED_HEIGHT; y++)
+    {
+        for (int x0 = 0; x0 < OLED_WIDTH; x0 += 8)
+        {
+            uint8_t b = 0;
+            for (int k = 0; k < 8; k++)
+            {
+                if (s_GDDRAM[y >> 3][x0 + k] & (1u << (y & 7))) b |= (uint8_t)(0x80 >> k);
+            }
+            fputc(b, f);
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+/* ---------------- 测试场景 ---------------- */
+
+typedef struct {
+    const char *Name;
+    int16_t Bri, Cct;
+    LightFocus_t Focus;
+    float Temp, Humi, Lux;
+} Step_t;
+
+static const Step_t SCENARIO[] = {
+    { "boot",        500, 500, FOCUS_BRIGHTNESS,  0.0f,  0.0f,   0.0f },
+    { "sensor",      500, 500, FOCUS_BRIGHTNESS, 25.0f, 40.0f, 300.0f },
+    { "bri+15",      515, 500, FOCUS_BRIGHTNESS, 25.0f, 40.0f, 300.0f },
+    { "bri+15",      530, 500, FOCUS_BRIGHTNESS, 25.0f, 40.0f, 300.0f },
+    { "bri+15",      545, 500, FOCUS_BRIGHTNESS, 25.0f, 40.0f, 300.0f },
+    { "bri+15",      560, 500, FOCUS_BRIGHTNESS, 25.0f, 40.0f, 300.0f },
+    { "bri+90",      650, 500, FOCUS_BRIGHTNESS, 25.0f, 40.0f, 300.0f },
+    { "bri max",    1000, 500, FOCUS_BRIGHTNESS, 25.0f, 40.0f, 300.0f },
+    { "focus",      1000, 500, FOCUS_COLOR_TEMP, 25.0f, 40.0f, 300.0f },
+    { "cct-15",     1000, 485, FOCUS_COLOR_TEMP, 25.0f, 40.0f, 300.0f },
+    { "cct-15",     1000, 470, FOCUS_COLOR_TEMP, 25.0f, 40.0f, 300.0f },
+    { "cct min",    1000,   0, FOCUS_COLOR_TEMP, 25.0f, 40.0f, 300.0f },
+    { "temp+1",     1000,   0, FOCUS_COLOR_TEMP, 26.0f, 40.0f, 300.0f },
+    { "lux",        1000,   0, FOCUS_COLOR_TEMP, 26.0f, 41.0f, 520.0f },
+    { "no change",  1000,   0, FOCUS_COLOR_TEMP, 26.0f, 41.0f, 520.0f },
+    { "sensor err", 1000,   0, FOCUS_COLOR_TEMP, -99.0f, 0.0f,   0.0f },
+    { "focus",      1000,   0, FOCUS_BRIGHTNESS, -99.0f, 0.0f,   0.0f },
+    { "bri-15",      985,   0, FOCUS_BRIGHTNESS, -99.0f, 0.0f,   0.0f },
+    { "off",           0,   0, FOCUS_BRIGHTNESS, -99.0f, 0.0f,   0.0f },
+};
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <frame_dir> <csv>\n", argv[0]);
+        return 2;
+    }
+    FILE *csv = fopen(argv[2], "w");
+    if (!csv) { perror(argv[2]); return 2; }
+    fprintf(csv, "step,name,pages,cols,bytes,task_steps,legacy_cells,legacy_bytes\n");
+
+    uint8_t before[OLED_PAGES][OLED_WIDTH];
+    int errors = 0;
+    int n = (int)(sizeof(SCENARIO) / sizeof(SCENARIO[0]));
+
+    SystemModel_Init();
+    memset(before, 0, sizeof(before));
+    s_Bytes = s_Pages = s_Cols = 0;
+    UIManager_Init();   // 含 OLED_Init 全屏刷新与标题
+
+    for (int i = 0; i < n; i++)
+    {
+        const Step_t *st = &SCENARIO[i];
+        uint32_t steps = 0;
+
+        g_SystemModel.Light.Brightness = st->Bri;
+        g_SystemModel.Light.ColorTemp = st->Cct;
+        g_SystemModel.Light.Focus = st->Focus;
+        g_SystemModel.Sensor.Temperature = st->Temp;
+        g_SystemModel.Sensor.Humidity = st->Humi;
+        g_SystemModel.Sensor.Lux = st->Lux;
+
+        // 第一次更新连同初始化的字节一起统计 (上电全屏刷新)
+        if (i > 0)
+        {
+            memcpy(before, OLED_FB_GetBuffer(), sizeof(before));
+            s_Bytes = s_Pages = s_Cols = 0;
+        }
+
+        do { steps++; } while (UIManager_Task() != SCHED_DONE && steps < 1000);
+
+        if (OLED_FB_IsDirty() || memcmp(s_GDDRAM, OLED_FB_GetBuffer(), sizeof(s_GDDRAM)) != 0)
+        {
+            fprintf(stderr, "step %d (%s): GDDRAM differs from framebuffer\n", i, st->Name);
+            errors++;
+        }
+
+        uint32_t cells = Count_Changed_Cells(before);
+        if (i == 0) cells = (OLED_PAGES / 2) * (OLED_WIDTH / 8);   // 旧版上电同样整屏清除
+        fprintf(csv, "%d,%s,%u,%u,%u,%u,%u,%u\n", i, st->Name,
+                (unsigned)s_Pages, (unsigned)s_Cols, (unsigned)s_Bytes, (unsigned)steps,
+                (unsigned)cells, (unsigned)(cells * LEGACY_CHAR_BYTES));
+
+        if (Write_PBM(argv[1], i) != 0) errors++;
+    }
+
+    fclose(csv);
+    if (errors) fprintf(stderr, "%d error(s)\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,546 @@
+/**
+ * 主机端 PAJ7620 驱动测试: 直接编译固件的 PAJ7620.c，GPIO / EXTI / NVIC 用 host/stub/stm32f10x.h 的声明、
+ * 在本文件中实现；I2C_Lib_* 接到一个寄存器级的 PAJ7620 模型:
+ *   * 0x43 / 0x44 手势标志读后清零，标志非零时 INT (PB5) 为低，由高变低时触发 EXTI5 (可模拟漏掉的沿)
+ *   * 非阻塞事务在两次 gest 任务调用之间 (或驱动忙等、连续轮询 I2C_Lib_Poll 时) 完成，与硬件 I2C 下 "结果滞后一个调用周期" 一致
+ *   * 每个事务按 400kHz 计总线时间: (设备地址 W + 寄存器 + 设备地址 R + 数据) 每字节 23us
+ * gest 任务按 main.c 的 10ms 周期调用 PAJ7620_Process_StateMachine。
+ *
+ *   unit:  固定用例 (空闲时只有保底轮询、INT 触发读取与回调 (每个沿一次中断回调)、漏沿靠电平补读、FORWARD 进入近距调光并每次读亮度、
+ *          亮度低于阈值退出、反向手势滤波、总线错误不回调、阻塞全量读先处理在途的一轮、[PAJ] 统计行)
+ *   load:  <seconds> 秒随机手势 (平均间隔 <gap_ms>，FORWARD 后保持 1~4s 近距调光)，统计总线占用与回调
+ *
+ * 输出 (stdout，逐行 key,v1,v2,...):
+ *   unit:  case,<name>,<ok>   (失败时前面另有 fail,<name>,<line>,<条件>)
+ *   load:  load,<calls>,<prox_calls>,<gestures>,<hooks_ok>,<max_latency_ms>,<flag_reads>,<obj_reads>,<bus_us>,<flag_us>,<obj_us>
+ *          paj,<[PAJ] 统计行>
+ *
+ * 用法: paj7620_host unit | load <seconds> <gap_ms> <seed>
+ * 任一固定用例失败，或 load 中有手势没有得到对应回调，退出码 1。
+ * (由 sim_7_1_11_paj7620_int.py 编译并运行)
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "PAJ7620.h"
+#include "I2C_Driver.h"
+#include "SystemSupport.h"
+
+#define GEST_PERIOD_MS      10      // main.c 中 gest 任务的周期
+#define I2C_BYTE_US         23      // 400kHz: 9 位 + 间隙
+#define MAX_QUEUE           8
+#define POLL_SPIN_DONE      4       // 约 100us 的事务在忙等中要轮询几次
+
+/* ---------------- 外设替身 ---------------- */
+GPIO_TypeDef Host_GPIOB;
+I2C_TypeDef Host_I2C1, Host_I2C2;
+
+static uint32_t s_Tick;
+static uint8_t  s_ExtiEnabled;      // EXTI_Init 已配置 EXTI5 下降沿
+static uint8_t  s_ExtiPending;
+static uint8_t  s_DropEdge;         // 1: 下一个下降沿不产生中断 (模拟漏沿)
+
+void EXTI9_5_IRQHandler(void);
+
+uint32_t System_GetTick(void) { return s_Tick; }
+void Delay_ms(uint32_t ms) { s_Tick += ms; }
+
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state) { (void)periph; (void)state; }
+void GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init) { (void)gpio; (void)init; }
+void GPIO_EXTILineConfig(uint8_t port, uint8_t pin) { (void)port; (void)pin; }
+void NVIC_Init(NVIC_InitTypeDef *init) { (void)init; }
+
+void EXTI_Init(EXTI_InitTypeDef *init)
+{
+    s_ExtiEnabled = init->EXTI_Line == EXTI_Line5 && init->EXTI_Trigger == EXTI_Trigger_Falling &&
+                    init->EXTI_Mode == EXTI_Mode_Interrupt && init->EXTI_LineCmd == ENABLE;
+}
+
+ITStatus EXTI_GetITStatus(uint32_t line) { return (line == EXTI_Line5 && s_ExtiPending) ? SET : RESET; }
+void EXTI_ClearITPendingBit(uint32_t line) { if (line == EXTI_Line5) s_ExtiPending = 0; }
+
+static char s_LastLine[160];
+
+int USART_DMA_Printf(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(s_LastLine, sizeof(s_LastLine), fmt, ap);
+    va_end(ap);
+    s_LastLine[strcspn(s_LastLine, "\r\n")] = '\0';
+    return 1;
+}
+
+/* ---------------- PAJ7620 寄存器模型 ---------------- */
+static uint8_t s_Reg[256];
+
+/** @brief 手势标志非零时 INT 为低 */
+static uint8_t IntLow(void) { return s_Reg[PAJ_ADDR_INT_FLAG1] || s_Reg[PAJ_ADDR_INT_FLAG2]; }
+
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *gpio, uint16_t pin)
+{
+    return (gpio == GPIOB && pin == GPIO_Pin_5) ? !IntLow() : 1;
+}
+
+/** @brief 传感器识别到手势: 置标志，INT 由高变低时触发 EXTI5 */
+static void Sensor_Gesture(uint8_t flag1, uint8_t flag2)
+{
+    uint8_t was_low = IntLow();
+    s_Reg[PAJ_ADDR_INT_FLAG1] |= flag1;
+    s_Reg[PAJ_ADDR_INT_FLAG2] |= flag2;
+    if (was_low || !IntLow() || !s_ExtiEnabled) return;
+    if (s_DropEdge)
+    {
+        s_DropEdge = 0;
+        return;
+    }
+    s_ExtiPending = 1;
+    EXTI9_5_IRQHandler();
+}
+
+static void Sensor_Object(uint8_t brightness, uint16_t size)
+{
+    s_Reg[PAJ_ADDR_OBJ_BRIGHTNESS] = brightness;
+    s_Reg[PAJ_ADDR_OBJ_SIZE_L] = (uint8_t)size;
+    s_Reg[PAJ_ADDR_OBJ_SIZE_H] = (uint8_t)(size >> 8);
+}
+
+/* ---------------- I2C 替身 ---------------- */
+static I2C_Xfer_t *s_Queue[MAX_QUEUE];
+static int s_QueueNum;
+static uint32_t s_PollSpin;
+static uint8_t s_FailNext;          // 1: 下一个事务 NACK
+static uint32_t s_FlagReads, s_ObjReads, s_VelReads, s_BusUs;
+
+/** @brief 在模型上执行一次寄存器读 / 写，返回 I2C_XferStatus_t */
+static uint8_t DoXfer(uint8_t reg, uint8_t is_read, uint8_t *buf, uint16_t len, uint16_t *bus_us)
+{
+    *bus_us = (uint16_t)((is_read ? 3 + len : 2 + len) * I2C_BYTE_US);
+    s_BusUs += *bus_us;
+    if (s_FailNext)
+    {
+        s_FailNext = 0;
+        return I2C_XFER_NACK;
+    }
+    if (!is_read)
+    {
+        memcpy(&s_Reg[reg], buf, len);
+        return I2C_XFER_OK;
+    }
+    memcpy(buf, &s_Reg[reg], len);
+    if (reg == PAJ_ADDR_INT_FLAG1)
+    {
+        s_FlagReads++;
+        s_Reg[PAJ_ADDR_INT_FLAG1] = 0;      // 读清，INT 回到高电平
+        if (len >= 2) s_Reg[PAJ_ADDR_INT_FLAG2] = 0;
+    }
+    else if (reg == PAJ_ADDR_OBJ_BRIGHTNESS) s_ObjReads++;
+    else if (reg == PAJ_ADDR_VEL_X_L) s_VelReads++;
+    return I2C_XFER_OK;
+}
+
+/** @brief 总线把队列中的事务全部传完 */
+static void Bus_Complete(void)
+{
+    for (int i = 0; i < s_QueueNum; i++)
+    {
+        I2C_Xfer_t *x = s_Queue[i];
+        uint16_t us;
+        x->Status = DoXfer(x->Reg, x->IsRead, x->Buf, x->Len, &us);
+        x->BusUs = us;
+        if (x->Done) x->Done(x);
+    }
+    s_QueueNum = 0;
+    s_PollSpin = 0;
+}
+
+void I2C_Lib_Init(I2C_TypeDef *I2Cx) { (void)I2Cx; }
+uint8_t I2C_Lib_IsHardware(I2C_TypeDef *I2Cx) { (void)I2Cx; return 1; }
+/** @brief 驱动忙等时反复调用: 连续轮询 POLL_SPIN_DONE 次视为传输结束 (单次轮询时事务仍在总线上) */
+void I2C_Lib_Poll(I2C_TypeDef *I2Cx)
+{
+    (void)I2Cx;
+    if (++s_PollSpin >= POLL_SPIN_DONE) Bus_Complete();
+}
+
+void I2C_Lib_Submit(I2C_TypeDef *I2Cx, I2C_Xfer_t *x)
+{
+    (void)I2Cx;
+    x->Status = I2C_XFER_PENDING;
+    if (s_QueueNum < MAX_QUEUE) s_Queue[s_QueueNum++] = x;
+}
+
+uint8_t I2C_Lib_Read(I2C_TypeDef *I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t *pData, uint16_t Size)
+{
+    uint16_t us;
+    (void)I2Cx; (void)DevAddr;
+    Bus_Complete();
+    return DoXfer(RegAddr, 1, pData, Size, &us) == I2C_XFER_OK ? 0 : 1;
+}
+
+uint8_t I2C_Lib_Write(I2C_TypeDef *I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t *pData, uint16_t Size)
+{
+    uint16_t us;
+    (void)I2Cx; (void)DevAddr;
+    Bus_Complete();
+    return DoXfer(RegAddr, 0, pData, Size, &us) == I2C_XFER_OK ? 0 : 1;
+}
+
+/* ---------------- 回调记录 ---------------- */
+enum { H_UP = 1, H_DOWN, H_LEFT, H_RIGHT, H_FORWARD, H_BACKWARD, H_CW, H_CCW, H_WAVE, H_PROX, H_PROX_EXIT };
+
+static uint8_t  s_Hooks[64];
+static uint32_t s_HookTick[64];
+static int      s_HookNum;
+static uint8_t  s_LastProx;
+static uint32_t s_ProxCalls;
+static uint32_t s_IsrHooks;         // INT 中断回调次数 (main.c 中由它向 EventBus 投递 EVT_GESTURE_INT)
+
+static void Hook(uint8_t h)
+{
+    if (s_HookNum < 64)
+    {
+        s_HookTick[s_HookNum] = s_Tick;
+        s_Hooks[s_HookNum++] = h;
+    }
+}
+
+void PAJ7620_Hook_OnUp(void) { Hook(H_UP); }
+void PAJ7620_Hook_OnDown(void) { Hook(H_DOWN); }
+void PAJ7620_Hook_OnLeft(void) { Hook(H_LEFT); }
+void PAJ7620_Hook_OnRight(void) { Hook(H_RIGHT); }
+void PAJ7620_Hook_OnForward(void) { Hook(H_FORWARD); }
+void PAJ7620_Hook_OnBackward(void) { Hook(H_BACKWARD); }
+void PAJ7620_Hook_OnClockwise(void) { Hook(H_CW); }
+void PAJ7620_Hook_OnCounterClockwise(void) { Hook(H_CCW); }
+void PAJ7620_Hook_OnWave(void) { Hook(H_WAVE); }
+void PAJ7620_Hook_OnProximity(uint8_t brightness) { s_LastProx = brightness; s_ProxCalls++; }
+void PAJ7620_Hook_OnProximityExit(void) { Hook(H_PROX_EXIT); }
+void PAJ7620_Hook_OnIntFromISR(void) { s_IsrHooks++; }
+
+/* ---------------- 运行 ---------------- */
+/** @brief 一个 gest 周期: 总线完成上一轮事务，然后调用状态机 */
+static void Gest_Step(void)
+{
+    s_Tick += GEST_PERIOD_MS;
+    Bus_Complete();
+    PAJ7620_Process_StateMachine();
+}
+
+static void Gest_Run(uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t += GEST_PERIOD_MS) Gest_Step();
+}
+
+/** @brief 上电并初始化驱动 (状态机静态变量只能通过驱动自身的流程回到空闲) */
+static int Sensor_PowerOn(void)
+{
+    memset(s_Reg, 0, sizeof(s_Reg));
+    s_Reg[PAJ_ADDR_PART_ID] = 0x20;
+    s_QueueNum = 0;
+    s_ExtiEnabled = s_ExtiPending = s_DropEdge = s_FailNext = 0;
+    int rc = PAJ7620_Init();
+    s_Reg[PAJ_ADDR_PART_ID] = 0x20;     // 初始化表会写 0x00 (Bank 1 寄存器，模型不区分 Bank)
+    return rc;
+}
+
+static void ResetCounters(void)
+{
+    s_FlagReads = s_ObjReads = s_VelReads = s_BusUs = 0;
+    s_HookNum = 0;
+    s_ProxCalls = 0;
+    s_LastProx = 0;
+    s_IsrHooks = 0;
+}
+
+/* ---------------- unit ---------------- */
+static const char *s_Case;
+static int s_CaseFail, s_AnyFail;
+
+#define CHECK(c) do { if (!(c)) { printf("fail,%s,%d,%s\n", s_Case, __LINE__, #c); s_CaseFail = 1; } } while (0)
+
+static void Begin(const char *name)
+{
+    s_Case = name;
+    s_CaseFail = 0;
+    Gest_Run(1000);             // 拉开与上一个用例的间隔 (反向手势滤波窗口、保底轮询计时)
+    while (s_QueueNum) Gest_Step();     // 不留在途的保底读
+    ResetCounters();
+}
+
+static void End(void)
+{
+    printf("case,%s,%d\n", s_Case, !s_CaseFail);
+    s_AnyFail |= s_CaseFail;
+}
+
+/** @brief 初始化: 识别芯片、配置 EXTI5 下降沿、读清残留标志 */
+static void Case_Init(void)
+{
+    s_Case = "init";
+    s_CaseFail = 0;
+    s_Reg[PAJ_ADDR_INT_FLAG1] = PAJ7620_GESTURE_UP;     // 上电残留
+    CHECK(Sensor_PowerOn() == 0);
+    CHECK(s_ExtiEnabled);
+    CHECK(!IntLow());
+    End();
+}
+
+/** @brief 无手势: 只有 PAJ_IDLE_POLL_MS 保底读，不读物体亮度，不回调 */
+static void Case_IdleFallback(void)
+{
+    Begin("idle_fallback");
+    Gest_Run(5000);
+    CHECK(s_FlagReads == 5000 / PAJ_IDLE_POLL_MS);
+    CHECK(s_ObjReads == 0 && s_HookNum == 0);
+    End();
+}
+
+/** @brief INT 沿触发: 下一个周期提交 2 字节突发读，再下一个周期回调一次 */
+static void Case_IntGesture(void)
+{
+    Begin("int_gesture");
+    Sensor_Gesture(PAJ7620_GESTURE_RIGHT, 0);
+    CHECK(IntLow() && s_IsrHooks == 1);
+    Gest_Step();
+    CHECK(s_HookNum == 0);              // 硬件 I2C: 结果滞后一个调用周期
+    Gest_Step();
+    CHECK(s_HookNum == 1 && s_Hooks[0] == H_RIGHT);
+    CHECK(s_FlagReads == 1 && !IntLow());
+    Gest_Run(100);
+    CHECK(s_HookNum == 1 && s_FlagReads == 1);
+    End();
+}
+
+/** @brief 漏掉下降沿: INT 电平仍为低，下一个周期照样读取 */
+static void Case_MissedEdge(void)
+{
+    Begin("missed_edge");
+    s_DropEdge = 1;
+    Sensor_Gesture(PAJ7620_GESTURE_UP, 0);
+    CHECK(s_IsrHooks == 0);
+    Gest_Run(2 * GEST_PERIOD_MS);
+    CHECK(s_HookNum == 1 && s_Hooks[0] == H_UP);
+    CHECK(s_FlagReads == 1);
+    End();
+}
+
+/** @brief WAVE 在标志 2 中，同一次突发读取到 */
+static void Case_Wave(void)
+{
+    Begin("wave");
+    Sensor_Gesture(0, PAJ7620_GESTURE_WAVE);
+    Gest_Run(2 * GEST_PERIOD_MS);
+    CHECK(s_HookNum == 1 && s_Hooks[0] == H_WAVE && s_FlagReads == 1);
+    End();
+}
+
+/** @brief FORWARD 进入近距调光: 每个周期读亮度并回调；亮度低于阈值退出，之后不再读亮度 */
+static void Case_Proximity(void)
+{
+    Begin("proximity");
+    Sensor_Object(150, 300);
+    Sensor_Gesture(PAJ7620_GESTURE_FORWARD, 0);
+    Gest_Run(2 * GEST_PERIOD_MS);
+    CHECK(s_HookNum == 1 && s_Hooks[0] == H_FORWARD);
+
+    Gest_Run(500);
+    CHECK(s_ObjReads >= 500 / GEST_PERIOD_MS - 1 && s_ObjReads <= 500 / GEST_PERIOD_MS + 1);
+    CHECK(s_ProxCalls >= 500 / GEST_PERIOD_MS - 1 && s_LastProx == 150);
+
+    Sensor_Object(10, 0);
+    Gest_Run(3 * GEST_PERIOD_MS);
+    CHECK(s_HookNum == 2 && s_Hooks[1] == H_PROX_EXIT);
+    uint32_t obj = s_ObjReads;
+    Gest_Run(1000);
+    CHECK(s_ObjReads == obj);
+    End();
+}
+
+/** @brief 600ms 内的反向手势被滤掉 (回正动作)，超过后正常响应 */
+static void Case_ReverseFilter(void)
+{
+    Begin("reverse_filter");
+    Sensor_Gesture(PAJ7620_GESTURE_LEFT, 0);
+    Gest_Run(100);
+    Sensor_Gesture(PAJ7620_GESTURE_RIGHT, 0);
+    Gest_Run(100);
+    CHECK(s_HookNum == 1 && s_Hooks[0] == H_LEFT);
+    Gest_Run(600);
+    Sensor_Gesture(PAJ7620_GESTURE_RIGHT, 0);
+    Gest_Run(100);
+    CHECK(s_HookNum == 2 && s_Hooks[1] == H_RIGHT);
+    End();
+}
+
+/** @brief 事务失败: 不回调，INT 仍为低，下一个周期重新读取 */
+static void Case_BusError(void)
+{
+    Begin("bus_error");
+    s_FailNext = 1;
+    Sensor_Gesture(PAJ7620_GESTURE_DOWN, 0);
+    Gest_Run(2 * GEST_PERIOD_MS);
+    CHECK(s_HookNum == 0 && IntLow());
+    Gest_Run(2 * GEST_PERIOD_MS);
+    CHECK(s_HookNum == 1 && s_Hooks[0] == H_DOWN);
+    End();
+}
+
+/** @brief 阻塞全量读: 先处理在途的手势读 (标志已被读清，不能丢)，再读 3 段并填写速度 */
+static void Case_ReadAll(void)
+{
+    Begin("read_all");
+    Sensor_Gesture(PAJ7620_GESTURE_CLOCKWISE, 0);
+    s_Tick += GEST_PERIOD_MS;
+    PAJ7620_Process_StateMachine();     // 提交后仍在总线上
+    CHECK(s_QueueNum == 1);
+
+    s_Reg[PAJ_ADDR_VEL_X_L] = (uint8_t)-5;
+    s_Reg[PAJ_ADDR_VEL_Y_L] = 7;
+    Sensor_Object(90, 0x0123);
+    PAJ7620_Data_t d;
+    PAJ7620_ReadAllData(&d);
+    CHECK(s_HookNum == 1 && s_Hooks[0] == H_CW);
+    CHECK(d.IsConnected && d.ObjectBrightness == 90 && d.ObjectSize == 0x0123);
+    CHECK(d.VelocityX == -5 && d.VelocityY == 7);
+    CHECK(s_VelReads == 1 && s_FlagReads == 2);
+    End();
+}
+
+/** @brief [PAJ] 行: INT 次数、读取次数与总线时间，打印后清零 */
+static void Case_StatsLine(void)
+{
+    Begin("stats_line");
+    PAJ7620_Stats_Task();
+    Sensor_Gesture(PAJ7620_GESTURE_BACKWARD, 0);
+    Gest_Run(1000);
+    PAJ7620_Stats_Task();
+    // 1 次 INT 读 + 1000ms 内至多 2 次保底读，每次 (3 + 2) 字节
+    unsigned ints, reads, avg, max;
+    CHECK(sscanf(s_LastLine, "[PAJ] int=%u reads=%u bus=%*u.%*u%% avg=%uus max=%uus", &ints, &reads, &avg, &max) == 4);
+    CHECK(ints == 1 && reads >= 1 && reads <= 3);
+    CHECK(avg == 5 * I2C_BYTE_US && max == 5 * I2C_BYTE_US);
+    CHECK(strstr(s_LastLine, "(hw)") != NULL);
+    PAJ7620_Stats_Task();
+    CHECK(strstr(s_LastLine, "int=0 reads=0 ") != NULL);
+    End();
+}
+
+static int RunUnit(void)
+{
+    Case_Init();
+    Case_IdleFallback();
+    Case_IntGesture();
+    Case_MissedEdge();
+    Case_Wave();
+    Case_Proximity();
+    Case_ReverseFilter();
+    Case_BusError();
+    Case_ReadAll();
+    Case_StatsLine();
+    return s_AnyFail;
+}
+
+/* ---------------- load ---------------- */
+static uint32_t s_Rng = 1;
+
+static uint32_t Rand32(void)
+{
+    s_Rng = s_Rng * 1103515245u + 12345u;
+    return s_Rng >> 1;
+}
+
+/** @brief 下一个手势的间隔: 平均 gap_ms，至少隔开反向滤波窗口 (避免被当作回正动作) */
+static uint32_t NextGap(int gap_ms)
+{
+    const uint32_t min_gap = 700;
+    if ((uint32_t)gap_ms <= min_gap) return min_gap;
+    return min_gap + Rand32() % (2 * ((uint32_t)gap_ms - min_gap));
+}
+
+static int RunLoad(int seconds, int gap_ms, uint32_t seed)
+{
+    static const struct { uint8_t flag; uint8_t hook; } kGest[] = {
+        { PAJ7620_GESTURE_UP, H_UP }, { PAJ7620_GESTURE_DOWN, H_DOWN },
+        { PAJ7620_GESTURE_LEFT, H_LEFT }, { PAJ7620_GESTURE_RIGHT, H_RIGHT },
+        { PAJ7620_GESTURE_CLOCKWISE, H_CW }, { PAJ7620_GESTURE_COUNTER_CW, H_CCW },
+        { PAJ7620_GESTURE_FORWARD, H_FORWARD },
+    };
+    s_Rng = seed ? seed : 1;
+    if (Sensor_PowerOn() != 0) return 2;
+    Gest_Run(1000);
+    ResetCounters();
+    PAJ7620_Stats_Task();
+
+    uint32_t end = s_Tick + (uint32_t)seconds * 1000u;
+    uint32_t calls = 0, prox_calls = 0, gestures = 0, bad = 0, max_lat = 0;
+    uint32_t next_gest = s_Tick + NextGap(gap_ms);
+    uint32_t prox_end = 0;
+    int in_prox = 0;
+
+    while (s_Tick < end)
+    {
+        if (!in_prox && s_Tick >= next_gest)
+        {
+            int k = (int)(Rand32() % (sizeof(kGest) / sizeof(kGest[0])));
+            s_HookNum = 0;
+            uint32_t t0 = s_Tick;
+            if (kGest[k].flag == PAJ7620_GESTURE_FORWARD)
+            {
+                Sensor_Object((uint8_t)(80 + Rand32() % 120), 200);
+                prox_end = s_Tick + 1000 + Rand32() % 3000;
+                in_prox = 1;
+            }
+            Sensor_Gesture(kGest[k].flag, 0);
+            gestures++;
+            // 最多 5 个周期内必须得到对应回调
+            for (int i = 0; i < 5 && s_HookNum == 0; i++)
+            {
+                Gest_Step();
+                calls++;
+                prox_calls += in_prox;
+            }
+            if (s_HookNum != 1 || s_Hooks[0] != kGest[k].hook) bad++;
+            else if (s_HookTick[0] - t0 > max_lat) max_lat = s_HookTick[0] - t0;
+            next_gest = s_Tick + NextGap(gap_ms);
+            continue;
+        }
+        if (in_prox && s_Tick >= prox_end)
+        {
+            Sensor_Object(5, 0);    // 手移开
+            in_prox = 0;
+            s_HookNum = 0;
+            for (int i = 0; i < 5 && s_HookNum == 0; i++)
+            {
+                Gest_Step();
+                calls++;
+                prox_calls++;
+            }
+            if (s_HookNum != 1 || s_Hooks[0] != H_PROX_EXIT) bad++;
+            next_gest = s_Tick + NextGap(gap_ms);
+            continue;
+        }
+        Gest_Step();
+        calls++;
+        prox_calls += in_prox;
+    }
+    PAJ7620_Stats_Task();
+
+    printf("load,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", (unsigned)calls, (unsigned)prox_calls, (unsigned)gestures,
+           (unsigned)(gestures - bad), (unsigned)max_lat, (unsigned)s_FlagReads, (unsigned)s_ObjReads,
+           (unsigned)s_BusUs, 5u * I2C_BYTE_US, 6u * I2C_BYTE_US);
+    printf("paj,%s\n", s_LastLine);
+    return bad ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    if (argc >= 2 && strcmp(argv[1], "unit") == 0) return RunUnit();
+    if (argc >= 5 && strcmp(argv[1], "load") == 0)
+        return RunLoad(atoi(argv[2]), atoi(argv[3]), (uint32_t)strtoul(argv[4], NULL, 10));
+
+    fprintf(stderr, "usage: %s unit | load <seconds> <gap_ms> <seed>\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,502 @@
+/**
+ * 主机端调度器测试: 直接编译固件的 Scheduler.c，SysTick / DWT CYCCNT / __WFI / 串口由本文件的虚拟时钟替代。
+ * 任务入口不真正耗时，而是按脚本把虚拟时钟推进指定的微秒数，因此结果与主机速度无关、可逐拍复现。
+ *
+ *   unit:     固定用例 (优先级与表中顺序、分步恢复与响应时间、周期对齐、错过释放的丢弃与超时计数、
+ *             单步计时与 DWT 回绕、SysTick 回绕、空闲 __WFI、[Sched] 统计任务的串口水位让步与清零)
+ *   latency:  按任务文件组成任务表 (由 sim_7_1_4_scheduler_latency.py 从 main.c 解析生成)，
+ *             回放旋钮事件，测量 旋钮转过一格 -> evt 任务处理完成 的延迟
+ *
+ * 任务文件 (逐行):
+ *   param,<sched|evt_post|on_enc|stats_line>,<us>
+ *   task,<name>,<period_ms>,<deadline_ms>,<prio>,<cost_us:ret cost_us:ret ...>
+ *     enc / evt / stats 三个任务名有专门的行为: enc 读取到期的旋钮事件并投递，evt 处理投递的事件，
+ *     stats 调用固件的 Scheduler_Stats_Task (每打印一行消耗 stats_line us)；其余任务循环执行脚本。
+ *
+ * 输出 (stdout，逐行 key,v1,v2,...):
+ *   unit:     case,<name>,<ok>   (失败时前面另有 fail,<name>,<line>,<条件>)
+ *   latency:  lat,<events>,<handled>,<p50_us>,<p99_us>,<max_us>
+ *             busy,<busy_us>,<duration_us>
+ *             step,<name>,<step_max_us>                       每个任务的最长单步 (全程)
+ *             sched,<[Sched] 行>                              最后一轮完整的固件统计输出
+ *
+ * 用法: scheduler_host unit | latency <任务文件> <事件文件 (每行一个 us 时刻)> <时长 s> <延迟 CSV>
+ * 任一固定用例失败，退出码 1。
+ * (由 sim_7_1_4_scheduler_latency.py 编译并运行)
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Scheduler.h"
+#include "SystemSupport.h"
+#include "USART_DMA.h"
+
+#define CPU_MHZ         72
+#define CYC_PER_TICK    (CPU_MHZ * 1000ULL)
+#define MAX_TASKS       16
+#define MAX_STEPS       16
+#define MAX_LOG         4096
+#define MAX_LINES       32
+
+/* ---------------- 虚拟时钟 (SysTick / DWT / __WFI 的替身) ---------------- */
+uint32_t SystemCoreClock = CPU_MHZ * 1000000u;
+
+static uint64_t s_Cyc;          // 自本次运行开始的 CPU 周期数
+static uint64_t s_IdleCyc;      // 其中 __WFI 休眠的周期数
+static uint32_t s_TickBase;     // System_GetTick 的起点 (测试节拍回绕)
+static uint32_t s_CycBase;      // DWT CYCCNT 的起点 (测试周期计数回绕)
+static uint32_t s_WfiCount;
+
+uint32_t System_GetTick(void) { return s_TickBase + (uint32_t)(s_Cyc / CYC_PER_TICK); }
+uint32_t System_GetCycle(void) { return s_CycBase + (uint32_t)s_Cyc; }
+
+/** @brief 休眠到下一个 SysTick */
+void __WFI(void)
+{
+    uint64_t next = (s_Cyc / CYC_PER_TICK + 1) * CYC_PER_TICK;
+    s_IdleCyc += next - s_Cyc;
+    s_Cyc = next;
+    s_WfiCount++;
+}
+
+static void Advance(uint32_t us) { s_Cyc += (uint64_t)us * CPU_MHZ; }
+static uint32_t ElapsedTick(void) { return (uint32_t)(s_Cyc / CYC_PER_TICK); }
+static uint64_t ElapsedUs(void) { return s_Cyc / CPU_MHZ; }
+
+/* ---------------- 串口替身: 记录 [Sched] 输出 ---------------- */
+static uint8_t  s_TxUsage;
+static uint32_t s_PrintCostUs;
+static char     s_Lines[MAX_LINES][160];
+static int      s_LineNum;
+static char     s_Round[MAX_LINES][160];    // 最后一轮完整的统计输出
+static int      s_RoundNum;
+
+int USART_DMA_Printf(const char *fmt, ...)
+{
+    char buf[160];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    buf[strcspn(buf, "\r\n")] = '\0';
+
+    // 汇总行开始新的一轮，保存上一轮
+    if (strncmp(buf, "[Sched] window=", 15) == 0 && s_LineNum)
+    {
+        memcpy(s_Round, s_Lines, sizeof(s_Lines));
+        s_RoundNum = s_LineNum;
+        s_LineNum = 0;
+    }
+    if (s_LineNum < MAX_LINES) strcpy(s_Lines[s_LineNum++], buf);
+    Advance(s_PrintCostUs);
+    return 1;
+}
+
+uint8_t USART_DMA_GetUsage(void) { return s_TxUsage; }
+
+/* ---------------- 脚本任务 ---------------- */
+typedef enum { KIND_SCRIPT = 0, KIND_ENC, KIND_EVT, KIND_STATS } task_kind_t;
+
+typedef struct {
+    char        name[8];
+    task_kind_t kind;
+    int         n, idx;
+    uint32_t    cost_us[MAX_STEPS];
+    uint32_t    ret[MAX_STEPS];
+    uint32_t    step_max_us;    // 全程最长单步 (固件统计每轮清零)
+} script_t;
+
+static Sched_Task_t s_Tbl[MAX_TASKS];
+static script_t     s_Script[MAX_TASKS];
+static int          s_TaskNum;
+static uint32_t     s_SchedUs;      // 每次调度一步的开销 (选择任务 + DWT 计时)
+
+static struct { uint8_t task; uint32_t tick; } s_Log[MAX_LOG];
+static int s_LogNum;
+
+/* 旋钮事件 (latency 模式) */
+static uint64_t *s_EvUs;
+static uint32_t *s_EvLat;
+static int      s_EvNum;
+static int      s_EvRead;       // enc 已读出的事件数
+static int      s_EvHandled;    // evt 已处理的事件数
+static int      s_EvBatches;    // 已投递未分发的事件数 (enc 每次读出的格数合并为一个事件)
+static uint32_t s_EvtPostUs, s_OnEncUs;
+
+static uint32_t RunTask(int i)
+{
+    script_t *s = &s_Script[i];
+    uint64_t start = s_Cyc;
+    uint32_t ret;
+
+    if (s_LogNum < MAX_LOG)
+    {
+        s_Log[s_LogNum].task = (uint8_t)i;
+        s_Log[s_LogNum].tick = System_GetTick();
+        s_LogNum++;
+    }
+    Advance(s_SchedUs);
+
+    switch (s->kind)
+    {
+    case KIND_ENC:      // Encoder_Get: 读出到期的格数，有变化时 EventBus_Post
+    {
+        int read = s_EvRead;
+        Advance(s->cost_us[0]);
+        while (s_EvRead < s_EvNum && s_EvUs[s_EvRead] <= ElapsedUs()) s_EvRead++;
+        if (s_EvRead > read)
+        {
+            Advance(s_EvtPostUs);
+            s_EvBatches++;
+        }
+        ret = SCHED_DONE;
+        break;
+    }
+    case KIND_EVT:      // EventBus_Dispatch_Task: 每个事件调用一次 ControlManager
+        Advance(s->cost_us[0] + s_EvBatches * s_OnEncUs);
+        s_EvBatches = 0;
+        for (; s_EvHandled < s_EvRead; s_EvHandled++)
+            s_EvLat[s_EvHandled] = (uint32_t)(ElapsedUs() - s_EvUs[s_EvHandled]);
+        ret = SCHED_DONE;
+        break;
+    case KIND_STATS:
+        ret = Scheduler_Stats_Task();
+        break;
+    default:
+        Advance(s->cost_us[s->idx]);
+        ret = s->ret[s->idx];
+        s->idx = (s->idx + 1) % s->n;
+        break;
+    }
+
+    uint32_t us = (uint32_t)((s_Cyc - start) / CPU_MHZ);
+    if (us > s->step_max_us) s->step_max_us = us;
+    return ret;
+}
+
+#define TRAMP(i) static uint32_t Task##i(void) { return RunTask(i); }
+TRAMP(0) TRAMP(1) TRAMP(2) TRAMP(3) TRAMP(4) TRAMP(5) TRAMP(6) TRAMP(7)
+TRAMP(8) TRAMP(9) TRAMP(10) TRAMP(11) TRAMP(12) TRAMP(13) TRAMP(14) TRAMP(15)
+static const Sched_Func_t s_Tramp[MAX_TASKS] = {
+    Task0, Task1, Task2, Task3, Task4, Task5, Task6, Task7,
+    Task8, Task9, Task10, Task11, Task12, Task13, Task14, Task15,
+};
+
+/** @brief 虚拟时钟与任务表归零 */
+static void Reset(void)
+{
+    s_Cyc = s_IdleCyc = 0;
+    s_TickBase = s_CycBase = 0;
+    s_WfiCount = 0;
+    s_TxUsage = 0;
+    s_PrintCostUs = 0;
+    s_LineNum = s_RoundNum = 0;
+    s_TaskNum = 0;
+    s_SchedUs = 0;
+    s_LogNum = 0;
+    memset(s_Script, 0, sizeof(s_Script));
+}
+
+/**
+  * @brief  追加一个任务
+  * @param  script: "cost_us:ret cost_us:ret ..."，循环执行；ret 省略时为 SCHED_DONE
+  */
+static int AddTask(const char *name, uint16_t period, uint16_t deadline, uint8_t prio, const char *script)
+{
+    int i = s_TaskNum++;
+    script_t *s = &s_Script[i];
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->kind = strcmp(name, "enc") == 0 ? KIND_ENC :
+              strcmp(name, "evt") == 0 ? KIND_EVT :
+              strcmp(name, "stats") == 0 ? KIND_STATS : KIND_SCRIPT;
+
+    const char *p = script;
+    while (*p && s->n < MAX_STEPS)
+    {
+        char *end;
+        s->cost_us[s->n] = (uint32_t)strtoul(p, &end, 10);
+        if (end == p) break;
+        s->ret[s->n] = (*end == ':') ? (uint32_t)strtoul(end + 1, &end, 10) : SCHED_DONE;
+        s->n++;
+        p = end + strspn(end, " ");
+    }
+    if (s->n == 0) s->n = 1;
+
+    Sched_Task_t t = SCHED_TASK(s->name, s_Tramp[i], period, deadline, prio);
+    s_Tbl[i] = t;
+    return i;
+}
+
+/** @brief 反复调用 Scheduler_Run 直到 (相对) 节拍 end */
+static void RunUntil(uint32_t end)
+{
+    while (ElapsedTick() < end) Scheduler_Run();
+}
+
+/* ---------------- unit ---------------- */
+static const char *s_Case;
+static int s_CaseFail, s_AnyFail;
+
+#define CHECK(c) do { if (!(c)) { printf("fail,%s,%d,%s\n", s_Case, __LINE__, #c); s_CaseFail = 1; } } while (0)
+
+static void Begin(const char *name)
+{
+    Reset();
+    s_Case = name;
+    s_CaseFail = 0;
+}
+
+static void End(void)
+{
+    printf("case,%s,%d\n", s_Case, !s_CaseFail);
+    s_AnyFail |= s_CaseFail;
+}
+
+/** @brief 第 k 条执行记录 (任务下标, 开始节拍相对值) 是否符合预期 */
+static int LogIs(int k, int task, uint32_t tick)
+{
+    return k < s_LogNum && s_Log[k].task == task && s_Log[k].tick - s_TickBase == tick;
+}
+
+/** @brief 同一节拍内: 优先级数值小的先执行，相同优先级按表中顺序 */
+static void Case_PrioOrder(void)
+{
+    Begin("prio_order");
+    int a = AddTask("A", 10, 0, 2, "0");
+    int b = AddTask("B", 10, 0, 1, "0");
+    int c = AddTask("C", 10, 0, 1, "0");
+    Scheduler_Init(s_Tbl, s_TaskNum);
+    RunUntil(1);
+    CHECK(s_LogNum == 3);
+    CHECK(LogIs(0, b, 0) && LogIs(1, c, 0) && LogIs(2, a, 0));
+    End();
+}
+
+/** @brief 分步任务: NEXT_STEP 下一拍继续、N 表示 N ms 后继续，响应时间从名义释放时刻算起 */
+static void Case_Steps(void)
+{
+    Begin("steps");
+    int s = AddTask("S", 100, 50, 0, "10:1 10:20 10:0");
+    Scheduler_Init(s_Tbl, s_TaskNum);
+    RunUntil(100);
+    CHECK(s_LogNum == 3);
+    CHECK(LogIs(0, s, 0) && LogIs(1, s, 1) && LogIs(2, s, 21));
+    CHECK(s_Tbl[s].Stats.Steps == 3 && s_Tbl[s].Stats.Runs == 1);
+    CHECK(s_Tbl[s].Stats.RespMaxMs == 21 && s_Tbl[s].Stats.Overruns == 0);
+    End();
+}
+
+/** @brief 周期按释放时刻对齐，执行耗时不会让后续释放漂移 */
+static void Case_NoDrift(void)
+{
+    Begin("no_drift");
+    int p = AddTask("P", 10, 0, 0, "3000");
+    Scheduler_Init(s_Tbl, s_TaskNum);
+    RunUntil(100);
+    CHECK(s_LogNum == 10);
+    for (int k = 0; k < s_LogNum; k++) CHECK(LogIs(k, p, 10u * k));
+    CHECK(s_Tbl[p].Stats.Runs == 10 && s_Tbl[p].Stats.Skips == 0);
+    CHECK(s_Tbl[p].Stats.RespMaxMs == 3);
+    CHECK(s_Tbl[p].Stats.StepMaxUs == 3000 && s_Tbl[p].Stats.ExecSumUs == 30000);
+    End();
+}
+
+/**
+  * @brief  低优先级任务单步 23ms 挡住 5ms 周期任务:
+  *         释放 5 在 23ms 才完成 (超时 1 次)，错过的释放 10 / 15 被丢弃，释放 20 立即补上，之后恢复 25
+  */
+static void Case_SkipOverrun(void)
+{
+    Begin("skip_overrun");
+    int p = AddTask("P", 5, 0, 0, "0");
+    AddTask("B", 1000, 0, 1, "23000");
+    Scheduler_Init(s_Tbl, s_TaskNum);
+    RunUntil(30);
+    CHECK(LogIs(0, p, 0) && LogIs(2, p, 23) && LogIs(3, p, 23) && LogIs(4, p, 25));
+    CHECK(s_Tbl[p].Stats.Runs == 4);
+    CHECK(s_Tbl[p].Stats.Overruns == 1 && s_Tbl[p].Stats.Skips == 2);
+    CHECK(s_Tbl[p].Stats.RespMaxMs == 18);
+    End();
+}
+
+/** @brief 单步耗时按 DWT 周期数换算，CYCCNT 在步中回绕不影响结果 */
+static void Case_DwtWrap(void)
+{
+    Begin("dwt_wrap");
+    int p = AddTask("P", 1, 0, 0, "150");
+    s_CycBase = 0xFFFFFFFFu - 50u * CPU_MHZ;
+    Scheduler_Init(s_Tbl, s_TaskNum);
+    RunUntil(10);
+    CHECK(s_Tbl[p].Stats.Runs == 10);
+    CHECK(s_Tbl[p].Stats.StepMaxUs == 150 && s_Tbl[p].Stats.ExecSumUs == 1500);
+    End();
+}
+
+/** @brief SysTick 计数回绕前后，到期判断与周期对齐不变 */
+static void Case_TickWrap(void)
+{
+    Begin("tick_wrap");
+    int p = AddTask("P", 4, 0, 0, "0");
+    s_TickBase = 0xFFFFFFF6u;
+    Scheduler_Init(s_Tbl, s_TaskNum);
+    RunUntil(20);
+    CHECK(s_LogNum == 5);
+    for (int k = 0; k < s_LogNum; k++) CHECK(LogIs(k, p, 4u * k));
+    CHECK(s_Tbl[p].Stats.RespMaxMs == 0 && s_Tbl[p].Stats.Skips == 0);
+    End();
+}
+
+/** @brief 无就绪任务时每个节拍只 __WFI 一次，不提前执行任务 */
+static void Case_IdleWfi(void)
+{
+    Begin("idle_wfi");
+    int p = AddTask("P", 10, 0, 0, "100");
+    Scheduler_Init(s_Tbl, s_TaskNum);
+    RunUntil(100);
+    CHECK(s_LogNum == 10);
+    for (int k = 0; k < s_LogNum; k++) CHECK(LogIs(k, p, 10u * k));
+    CHECK(s_WfiCount == 100);
+    CHECK(s_IdleCyc == 100 * CYC_PER_TICK - 10 * 100 * CPU_MHZ);
+    End();
+}
+
+/** @brief 统计任务: 串口水位高时让出不打印；之后每步一行，打印完一轮清零统计 */
+static void Case_StatsTask(void)
+{
+    Begin("stats_task");
+    int x = AddTask("X", 1, 0, 0, "10");
+    int st = AddTask("stats", 1000, 0, 7, "");
+    Scheduler_Init(s_Tbl, s_TaskNum);
+
+    s_TxUsage = 80;
+    RunUntil(5);
+    CHECK(s_LineNum == 0);
+    CHECK(s_Tbl[st].Active && s_Tbl[st].Stats.Steps == 5);
+
+    s_TxUsage = 0;
+    RunUntil(10);
+    CHECK(s_LineNum == 3);
+    CHECK(strncmp(s_Lines[0], "[Sched] window=", 15) == 0);
+    CHECK(strncmp(s_Lines[1], "[Sched] X ", 10) == 0 && strstr(s_Lines[1], " runs=7 ") != NULL);
+    CHECK(strncmp(s_Lines[2], "[Sched] stats ", 14) == 0);
+    // 清零发生在 tick 7，之后 X 在 tick 8 / 9 各完成一次
+    CHECK(s_Tbl[x].Stats.Runs == 2);
+    CHECK(s_Tbl[st].Stats.Runs == 1 && s_Tbl[st].Stats.RespMaxMs == 7 && !s_Tbl[st].Active);
+    End();
+}
+
+static int RunUnit(void)
+{
+    Case_PrioOrder();
+    Case_Steps();
+    Case_NoDrift();
+    Case_SkipOverrun();
+    Case_DwtWrap();
+    Case_TickWrap();
+    Case_IdleWfi();
+    Case_StatsTask();
+    return s_AnyFail;
+}
+
+/* ---------------- latency ---------------- */
+static int CmpU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int LoadTasks(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char line[512];
+    while (fgets(line, sizeof(line), f))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        char name[16], script[400] = "";
+        unsigned period, deadline, prio, us;
+        if (sscanf(line, "param,%15[^,],%u", name, &us) == 2)
+        {
+            if (strcmp(name, "sched") == 0) s_SchedUs = us;
+            else if (strcmp(name, "evt_post") == 0) s_EvtPostUs = us;
+            else if (strcmp(name, "on_enc") == 0) s_OnEncUs = us;
+            else if (strcmp(name, "stats_line") == 0) s_PrintCostUs = us;
+        }
+        else if (sscanf(line, "task,%15[^,],%u,%u,%u,%399[^\n]", name, &period, &deadline, &prio, script) >= 4)
+        {
+            if (s_TaskNum == MAX_TASKS) break;
+            AddTask(name, (uint16_t)period, (uint16_t)deadline, (uint8_t)prio, script);
+        }
+    }
+    fclose(f);
+    return s_TaskNum ? 0 : -1;
+}
+
+static int LoadEvents(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int cap = 1024;
+    s_EvUs = malloc(cap * sizeof(uint64_t));
+    unsigned long long t;
+    while (fscanf(f, "%llu", &t) == 1)
+    {
+        if (s_EvNum == cap) s_EvUs = realloc(s_EvUs, (cap *= 2) * sizeof(uint64_t));
+        s_EvUs[s_EvNum++] = t;
+    }
+    fclose(f);
+    s_EvLat = calloc(s_EvNum ? s_EvNum : 1, sizeof(uint32_t));
+    return 0;
+}
+
+static int RunLatency(const char *task_file, const char *event_file, double duration_s, const char *csv)
+{
+    Reset();
+    if (LoadTasks(task_file) != 0 || LoadEvents(event_file) != 0)
+    {
+        fprintf(stderr, "scheduler_host: cannot load %s / %s\n", task_file, event_file);
+        return 2;
+    }
+    Scheduler_Init(s_Tbl, s_TaskNum);
+    uint32_t ticks = (uint32_t)(duration_s * 1000.0);
+    RunUntil(ticks);
+    // 仿真时长不足一个统计周期时，取尚未结束的这一轮
+    if (s_RoundNum == 0 && s_LineNum)
+    {
+        memcpy(s_Round, s_Lines, sizeof(s_Lines));
+        s_RoundNum = s_LineNum;
+    }
+
+    FILE *f = fopen(csv, "w");
+    if (!f)
+    {
+        fprintf(stderr, "scheduler_host: cannot write %s\n", csv);
+        return 2;
+    }
+    fprintf(f, "t_us,latency_us\n");
+    for (int i = 0; i < s_EvHandled; i++) fprintf(f, "%llu,%u\n", (unsigned long long)s_EvUs[i], (unsigned)s_EvLat[i]);
+    fclose(f);
+
+    uint32_t *sorted = malloc((s_EvHandled ? s_EvHandled : 1) * sizeof(uint32_t));
+    memcpy(sorted, s_EvLat, s_EvHandled * sizeof(uint32_t));
+    qsort(sorted, s_EvHandled, sizeof(uint32_t), CmpU32);
+    int n = s_EvHandled;
+    printf("lat,%d,%d,%u,%u,%u\n", s_EvNum, n, n ? (unsigned)sorted[n / 2] : 0,
+           n ? (unsigned)sorted[n * 99 / 100] : 0, n ? (unsigned)sorted[n - 1] : 0);
+    printf("busy,%llu,%llu\n", (unsigned long long)((s_Cyc - s_IdleCyc) / CPU_MHZ), (unsigned long long)ElapsedUs());
+    for (int i = 0; i < s_TaskNum; i++) printf("step,%s,%u\n", s_Script[i].name, (unsigned)s_Script[i].step_max_us);
+    for (int i = 0; i < s_RoundNum; i++) printf("sched,%s\n", s_Round[i]);
+    free(sorted);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    if (argc >= 2 && strcmp(argv[1], "unit") == 0) return RunUnit();
+    if (argc >= 6 && strcmp(argv[1], "latency") == 0) return RunLatency(argv[2], argv[3], atof(argv[4]), argv[5]);
+
+    fprintf(stderr, "usage: %s unit | latency <tasks> <events> <seconds> <csv>\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,75 @@
+/* 主机端编译桩: 提供固件头文件与被测源文件依赖的基本类型、CMSIS 符号和标准外设库声明 */
+#ifndef __STM32F10X_H
+#define __STM32F10X_H
+
+#include <stdint.h>
+
+#ifndef __weak
+#define __weak      __attribute__((weak))
+#endif
+
+/* CMSIS 符号: 由用到它们的测试程序定义 (如 scheduler_host.c 用虚拟时钟实现 __WFI) */
+extern uint32_t SystemCoreClock;
+void __WFI(void);
+
+/* 内存屏障: 主机上用完整的内存栅栏代替 (EventBus 的无锁队列依赖它发布 / 释放槽位) */
+#define __DMB()     __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* ============================================================
+ *  标准外设库的最小子集 (PAJ7620.c 的 INT 引脚与 I2C 接口用到)
+ *  只有类型与声明，函数由用到它们的测试程序实现 (如 paj7620_host.c)
+ * ============================================================ */
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, ITStatus;
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+
+typedef struct { uint32_t Id; } GPIO_TypeDef;
+typedef struct { uint32_t Id; } I2C_TypeDef;
+extern GPIO_TypeDef Host_GPIOB;
+extern I2C_TypeDef Host_I2C1, Host_I2C2;
+#define GPIOB       (&Host_GPIOB)
+#define I2C1        (&Host_I2C1)
+#define I2C2        (&Host_I2C2)
+
+#define GPIO_Pin_5              ((uint16_t)0x0020)
+#define GPIO_PortSourceGPIOB    ((uint8_t)0x01)
+#define GPIO_PinSource5         ((uint8_t)0x05)
+#define EXTI_Line5              ((uint32_t)0x00020)
+#define RCC_APB2Periph_AFIO     ((uint32_t)0x00000001)
+#define RCC_APB2Periph_GPIOB    ((uint32_t)0x00000008)
+#define EXTI9_5_IRQn            23
+
+typedef enum { GPIO_Speed_10MHz = 1, GPIO_Speed_2MHz, GPIO_Speed_50MHz } GPIOSpeed_TypeDef;
+typedef enum { GPIO_Mode_IN_FLOATING = 0x04, GPIO_Mode_IPD = 0x28, GPIO_Mode_IPU = 0x48 } GPIOMode_TypeDef;
+typedef enum { EXTI_Mode_Interrupt = 0x00, EXTI_Mode_Event = 0x04 } EXTIMode_TypeDef;
+typedef enum { EXTI_Trigger_Rising = 0x08, EXTI_Trigger_Falling = 0x0C, EXTI_Trigger_Rising_Falling = 0x10 } EXTITrigger_TypeDef;
+
+typedef struct {
+    uint16_t          GPIO_Pin;
+    GPIOSpeed_TypeDef GPIO_Speed;
+    GPIOMode_TypeDef  GPIO_Mode;
+} GPIO_InitTypeDef;
+
+typedef struct {
+    uint32_t            EXTI_Line;
+    EXTIMode_TypeDef    EXTI_Mode;
+    EXTITrigger_TypeDef EXTI_Trigger;
+    FunctionalState     EXTI_LineCmd;
+} EXTI_InitTypeDef;
+
+typedef struct {
+    uint8_t         NVIC_IRQChannel;
+    uint8_t         NVIC_IRQChannelPreemptionPriority;
+    uint8_t         NVIC_IRQChannelSubPriority;
+    FunctionalState NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState);
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct);
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void GPIO_EXTILineConfig(uint8_t GPIO_PortSource, uint8_t GPIO_PinSource);
+void EXTI_Init(EXTI_InitTypeDef *EXTI_InitStruct);
+ITStatus EXTI_GetITStatus(uint32_t EXTI_Line);
+void EXTI_ClearITPendingBit(uint32_t EXTI_Line);
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct);
+
+#endif
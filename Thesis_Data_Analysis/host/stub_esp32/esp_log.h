@@ -0,0 +1,27 @@
+/* 主机端编译桩: ESP_LOGx 打印到 stderr (设置环境变量 HOST_LOG=1 时)，否则丢弃 */
+#ifndef HOST_ESP_LOG_H
+#define HOST_ESP_LOG_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static inline void host_esp_log(char level, const char *tag, const char *fmt, ...)
+{
+    static int s_on = -1;
+    if (s_on < 0) s_on = getenv("HOST_LOG") != NULL;
+    if (!s_on) return;
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "%c %s: ", level, tag);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+#define ESP_LOGE(tag, fmt, ...) host_esp_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) host_esp_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) host_esp_log('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) host_esp_log('D', tag, fmt, ##__VA_ARGS__)
+
+#endif
@@ -0,0 +1,33 @@
+/* 主机端编译桩: 没有网络接口，esp_netif_get_handle_from_ifkey 返回 NULL (固件据此跳过 Ping 发射器) */
+#ifndef HOST_ESP_NETIF_H
+#define HOST_ESP_NETIF_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct esp_netif_obj esp_netif_t;
+
+typedef struct {
+    uint32_t addr;
+} esp_ip4_addr_t;
+
+typedef struct {
+    esp_ip4_addr_t ip;
+    esp_ip4_addr_t netmask;
+    esp_ip4_addr_t gw;
+} esp_netif_ip_info_t;
+
+#define IPSTR "%d.%d.%d.%d"
+#define esp_ip4_addr_get_byte(a, n) (((const uint8_t *)(&(a)->addr))[n])
+#define IP2STR(a) esp_ip4_addr_get_byte(a, 0), esp_ip4_addr_get_byte(a, 1), \
+                  esp_ip4_addr_get_byte(a, 2), esp_ip4_addr_get_byte(a, 3)
+
+static inline esp_netif_t *esp_netif_get_handle_from_ifkey(const char *key) { (void)key; return NULL; }
+static inline esp_err_t esp_netif_get_ip_info(esp_netif_t *netif, esp_netif_ip_info_t *info)
+{
+    (void)netif;
+    info->ip.addr = info->netmask.addr = info->gw.addr = 0;
+    return ESP_FAIL;
+}
+
+#endif
@@ -0,0 +1,38 @@
+/* 主机端编译桩: esp_timer_get_time 用单调时钟，定时器只记录回调 (由测试程序手动触发) */
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+#include <time.h>
+#include "esp_err.h"
+
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+} esp_timer_create_args_t;
+
+typedef struct host_esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    uint64_t period_us;     // 0 = 未运行
+} *esp_timer_handle_t;
+
+static inline int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t period_us);
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t t);
+
+// 最近一次 esp_timer_create 创建的定时器 (测试程序用来手动触发回调)
+extern esp_timer_handle_t host_esp_timer_last;
+
+#endif
@@ -0,0 +1,35 @@
+/* 主机端 esp_timer 桩的实现: 不自动触发，测试程序读取 handle->callback 手动调用 */
+#include <stdlib.h>
+#include "esp_timer.h"
+
+esp_timer_handle_t host_esp_timer_last;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out)
+{
+    esp_timer_handle_t t = calloc(1, sizeof(*t));
+    if (!t) return ESP_ERR_NO_MEM;
+    t->callback = args->callback;
+    t->arg = args->arg;
+    *out = t;
+    host_esp_timer_last = t;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t period_us)
+{
+    if (t->period_us) return ESP_ERR_INVALID_STATE;
+    t->period_us = period_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeout_us)
+{
+    return esp_timer_start_periodic(t, timeout_us);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t t)
+{
+    if (!t->period_us) return ESP_ERR_INVALID_STATE;
+    t->period_us = 0;
+    return ESP_OK;
+}
@@ -0,0 +1,40 @@
+/* 主机端编译桩: 只保留 CSI 相关的类型与接口 (CSI 由回放程序从采集文件送入，驱动接口为空操作) */
+#ifndef HOST_ESP_WIFI_H
+#define HOST_ESP_WIFI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct {
+    int8_t   rssi;
+    uint8_t  channel;
+    uint32_t timestamp;
+} wifi_pkt_rx_ctrl_t;
+
+typedef struct {
+    wifi_pkt_rx_ctrl_t rx_ctrl;
+    uint8_t  mac[6];
+    uint8_t  dmac[6];
+    bool     first_word_invalid;
+    int8_t  *buf;
+    uint16_t len;
+} wifi_csi_info_t;
+
+typedef struct {
+    bool    lltf_en;
+    bool    htltf_en;
+    bool    stbc_htltf2_en;
+    bool    ltf_merge_en;
+    bool    channel_filter_en;
+    bool    manu_scale;
+    uint8_t shift;
+} wifi_csi_config_t;
+
+typedef void (*wifi_csi_cb_t)(void *ctx, wifi_csi_info_t *info);
+
+static inline esp_err_t esp_wifi_set_csi_config(const wifi_csi_config_t *cfg) { (void)cfg; return ESP_OK; }
+static inline esp_err_t esp_wifi_set_csi_rx_cb(wifi_csi_cb_t cb, void *ctx) { (void)cb; (void)ctx; return ESP_OK; }
+static inline esp_err_t esp_wifi_set_csi(bool en) { (void)en; return ESP_OK; }
+
+#endif
@@ -0,0 +1,31 @@
+/* 主机端编译桩: ESP-SR WakeNet 接口 (esp-sr 1.9 的 esp_wn_iface.h 中固件用到的部分)，
+ * 主机上的模型实现见 wakenet_host.c */
+#ifndef HOST_ESP_WN_IFACE_H
+#define HOST_ESP_WN_IFACE_H
+
+#include <stdint.h>
+
+typedef enum {
+    DET_MODE_90 = 0,        // 更灵敏
+    DET_MODE_95 = 1,        // 误唤醒更少
+} det_mode_t;
+
+typedef enum {
+    WAKENET_NO_DETECT = 0,
+    WAKENET_CHANNEL_VERIFIED = -1,
+    WAKENET_DETECTED = 1,
+    WAKENET_VERIFIED = 2,
+} wakenet_state_t;
+
+typedef struct model_iface_data_t model_iface_data_t;
+
+typedef struct {
+    model_iface_data_t *(*create)(const void *model_name, det_mode_t det_mode);
+    int (*get_samp_chunksize)(model_iface_data_t *model);
+    int (*get_samp_rate)(model_iface_data_t *model);
+    char *(*get_word_name)(model_iface_data_t *model, int word_index);
+    wakenet_state_t (*detect)(model_iface_data_t *model, int16_t *samples);
+    void (*destroy)(model_iface_data_t *model);
+} esp_wn_iface_t;
+
+#endif
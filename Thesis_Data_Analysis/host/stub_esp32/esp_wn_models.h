@@ -0,0 +1,11 @@
+/* 主机端编译桩: 按模型名取 WakeNet 接口 (由 wakenet_host.c 实现) */
+#ifndef HOST_ESP_WN_MODELS_H
+#define HOST_ESP_WN_MODELS_H
+
+#include "esp_wn_iface.h"
+
+#define ESP_WN_PREFIX   "wn"
+
+const esp_wn_iface_t *esp_wn_handle_from_name(const char *model_name);
+
+#endif
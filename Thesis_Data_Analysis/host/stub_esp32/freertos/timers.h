@@ -0,0 +1,18 @@
+/* 主机端编译桩: 软件定时器 (一个服务线程按到期时间调用回调，与 FreeRTOS Timer Service 任务相同) */
+#ifndef HOST_FREERTOS_TIMERS_H
+#define HOST_FREERTOS_TIMERS_H
+
+#include "FreeRTOS.h"
+
+typedef struct host_timer *TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t);
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload, void *id,
+                           TimerCallbackFunction_t cb);
+BaseType_t xTimerStart(TimerHandle_t t, TickType_t wait);
+BaseType_t xTimerStop(TimerHandle_t t, TickType_t wait);
+BaseType_t xTimerReset(TimerHandle_t t, TickType_t wait);
+BaseType_t xTimerIsTimerActive(TimerHandle_t t);
+void *pvTimerGetTimerID(TimerHandle_t t);
+
+#endif
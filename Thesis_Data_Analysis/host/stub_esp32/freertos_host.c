@@ -0,0 +1,341 @@
+/**
+ * 主机端 FreeRTOS 桩的实现: 每个任务一个 pthread，任务通知用互斥量 + 条件变量，
+ * 软件定时器由一个服务线程按到期时间顺序调用回调。只实现固件用到的接口，不模拟优先级和时间片。
+ */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+
+/* ---------------- 时间 ---------------- */
+static uint64_t _now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void _abs_deadline(struct timespec *ts, TickType_t ticks)
+{
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += ticks / 1000;
+    ts->tv_nsec += (long)(ticks % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000) { ts->tv_sec++; ts->tv_nsec -= 1000000000; }
+}
+
+static void _cond_init(pthread_cond_t *c)
+{
+    pthread_condattr_t a;
+    pthread_condattr_init(&a);
+    pthread_condattr_setclock(&a, CLOCK_MONOTONIC);
+    pthread_cond_init(c, &a);
+    pthread_condattr_destroy(&a);
+}
+
+/** @brief 在 m 已加锁时等待 c，ticks = portMAX_DELAY 表示一直等; 超时返回 0 */
+static int _cond_wait(pthread_cond_t *c, pthread_mutex_t *m, const struct timespec *dl, TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) { pthread_cond_wait(c, m); return 1; }
+    return pthread_cond_timedwait(c, m, dl) != ETIMEDOUT;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    static uint64_t s_start;
+    if (!s_start) s_start = _now_ms();
+    return (TickType_t)(_now_ms() - s_start);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec ts = { ticks / 1000, (long)(ticks % 1000) * 1000000 };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+/* ---------------- 任务与通知 ---------------- */
+struct host_task {
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    uint32_t value;
+    uint8_t pending;
+};
+
+static __thread TaskHandle_t s_self;
+
+static void *_task_entry(void *p)
+{
+    TaskHandle_t t = p;
+    s_self = t;
+    t->fn(t->arg);
+    return NULL;
+}
+
+static TaskHandle_t _task_alloc(void)
+{
+    TaskHandle_t t = calloc(1, sizeof(*t));
+    pthread_mutex_init(&t->mtx, NULL);
+    _cond_init(&t->cond);
+    return t;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    if (!s_self) s_self = _task_alloc(); // 主线程等非 xTaskCreate 创建的线程
+    return s_self;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *out)
+{
+    (void)name; (void)stack; (void)prio;
+    TaskHandle_t t = _task_alloc();
+    t->fn = fn;
+    t->arg = arg;
+    if (out) *out = t;
+    if (pthread_create(&t->thread, NULL, _task_entry, t) != 0) return pdFAIL;
+    pthread_detach(t->thread);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *out, BaseType_t core)
+{
+    (void)core;
+    return xTaskCreate(fn, name, stack, arg, prio, out);
+}
+
+void vTaskDelete(TaskHandle_t t)
+{
+    if (t == NULL || t == s_self) pthread_exit(NULL);
+    // 删除其他任务: 固件未使用
+}
+
+BaseType_t xTaskNotify(TaskHandle_t t, uint32_t value, eNotifyAction action)
+{
+    pthread_mutex_lock(&t->mtx);
+    switch (action)
+    {
+        case eSetBits:               t->value |= value; break;
+        case eIncrement:             t->value++; break;
+        case eSetValueWithOverwrite: t->value = value; break;
+        default: break;
+    }
+    t->pending = 1;
+    pthread_cond_broadcast(&t->cond);
+    pthread_mutex_unlock(&t->mtx);
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks)
+{
+    TaskHandle_t t = xTaskGetCurrentTaskHandle();
+    struct timespec dl;
+    _abs_deadline(&dl, ticks);
+
+    pthread_mutex_lock(&t->mtx);
+    if (!t->pending) t->value &= ~clear_on_entry;
+    while (!t->pending)
+    {
+        if (!_cond_wait(&t->cond, &t->mtx, &dl, ticks)) break;
+    }
+    BaseType_t got = t->pending ? pdTRUE : pdFALSE;
+    if (value) *value = t->value;
+    if (got)
+    {
+        t->value &= ~clear_on_exit;
+        t->pending = 0;
+    }
+    pthread_mutex_unlock(&t->mtx);
+    return got;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    TaskHandle_t t = xTaskGetCurrentTaskHandle();
+    struct timespec dl;
+    _abs_deadline(&dl, ticks);
+
+    pthread_mutex_lock(&t->mtx);
+    while (t->value == 0)
+    {
+        if (!_cond_wait(&t->cond, &t->mtx, &dl, ticks)) break;
+    }
+    uint32_t v = t->value;
+    if (v) t->value = clear_on_exit ? 0 : v - 1;
+    t->pending = 0;
+    pthread_mutex_unlock(&t->mtx);
+    return v;
+}
+
+/* ---------------- 信号量 ---------------- */
+struct host_sem {
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    uint32_t count;
+};
+
+static SemaphoreHandle_t _sem_new(uint32_t count)
+{
+    SemaphoreHandle_t s = calloc(1, sizeof(*s));
+    pthread_mutex_init(&s->mtx, NULL);
+    _cond_init(&s->cond);
+    s->count = count;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return _sem_new(1); }
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { return _sem_new(0); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks)
+{
+    struct timespec dl;
+    _abs_deadline(&dl, ticks);
+    pthread_mutex_lock(&s->mtx);
+    while (s->count == 0)
+    {
+        if (ticks == 0 || !_cond_wait(&s->cond, &s->mtx, &dl, ticks)) break;
+    }
+    BaseType_t got = s->count ? pdTRUE : pdFALSE;
+    if (got) s->count--;
+    pthread_mutex_unlock(&s->mtx);
+    return got;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+    pthread_mutex_lock(&s->mtx);
+    s->count = 1;
+    pthread_cond_signal(&s->cond);
+    pthread_mutex_unlock(&s->mtx);
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t s)
+{
+    pthread_mutex_destroy(&s->mtx);
+    pthread_cond_destroy(&s->cond);
+    free(s);
+}
+
+/* ---------------- 软件定时器 ---------------- */
+struct host_timer {
+    TimerCallbackFunction_t cb;
+    void *id;
+    TickType_t period;
+    uint8_t auto_reload;
+    uint8_t active;
+    uint64_t expire_ms;
+    struct host_timer *next;
+};
+
+static pthread_mutex_t s_tmr_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_tmr_cond;
+static struct host_timer *s_timers;
+static pthread_t s_tmr_thread;
+static int s_tmr_started;
+
+static void *_timer_service(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&s_tmr_mtx);
+    while (1)
+    {
+        uint64_t now = _now_ms(), next = UINT64_MAX;
+        struct host_timer *due = NULL;
+        for (struct host_timer *t = s_timers; t; t = t->next)
+        {
+            if (!t->active) continue;
+            if (t->expire_ms <= now) { due = t; break; }
+            if (t->expire_ms < next) next = t->expire_ms;
+        }
+        if (due)
+        {
+            if (due->auto_reload) due->expire_ms += due->period;
+            else due->active = 0;
+            pthread_mutex_unlock(&s_tmr_mtx);
+            due->cb(due);       // 回调里可以再次 Start / Stop 定时器
+            pthread_mutex_lock(&s_tmr_mtx);
+            continue;
+        }
+        if (next == UINT64_MAX)
+        {
+            pthread_cond_wait(&s_tmr_cond, &s_tmr_mtx);
+        }
+        else
+        {
+            struct timespec dl = { (time_t)(next / 1000), (long)(next % 1000) * 1000000 };
+            pthread_cond_timedwait(&s_tmr_cond, &s_tmr_mtx, &dl);
+        }
+    }
+    return NULL;
+}
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload, void *id,
+                           TimerCallbackFunction_t cb)
+{
+    (void)name;
+    struct host_timer *t = calloc(1, sizeof(*t));
+    t->cb = cb;
+    t->id = id;
+    t->period = period ? period : 1;
+    t->auto_reload = auto_reload ? 1 : 0;
+
+    pthread_mutex_lock(&s_tmr_mtx);
+    if (!s_tmr_started)
+    {
+        _cond_init(&s_tmr_cond);
+        pthread_create(&s_tmr_thread, NULL, _timer_service, NULL);
+        pthread_detach(s_tmr_thread);
+        s_tmr_started = 1;
+    }
+    t->next = s_timers;
+    s_timers = t;
+    pthread_mutex_unlock(&s_tmr_mtx);
+    return t;
+}
+
+BaseType_t xTimerStart(TimerHandle_t t, TickType_t wait)
+{
+    (void)wait;
+    pthread_mutex_lock(&s_tmr_mtx);
+    t->expire_ms = _now_ms() + t->period;
+    t->active = 1;
+    pthread_cond_signal(&s_tmr_cond);
+    pthread_mutex_unlock(&s_tmr_mtx);
+    return pdPASS;
+}
+
+BaseType_t xTimerReset(TimerHandle_t t, TickType_t wait)
+{
+    return xTimerStart(t, wait);
+}
+
+BaseType_t xTimerStop(TimerHandle_t t, TickType_t wait)
+{
+    (void)wait;
+    pthread_mutex_lock(&s_tmr_mtx);
+    t->active = 0;
+    pthread_mutex_unlock(&s_tmr_mtx);
+    return pdPASS;
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t t)
+{
+    pthread_mutex_lock(&s_tmr_mtx);
+    BaseType_t a = t->active ? pdTRUE : pdFALSE;
+    pthread_mutex_unlock(&s_tmr_mtx);
+    return a;
+}
+
+void *pvTimerGetTimerID(TimerHandle_t t)
+{
+    return t->id;
+}
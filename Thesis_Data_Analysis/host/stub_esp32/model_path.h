@@ -0,0 +1,13 @@
+/* 主机端编译桩: ESP-SR 模型分区列表 (由 wakenet_host.c 实现，只含一个主机模型) */
+#ifndef HOST_MODEL_PATH_H
+#define HOST_MODEL_PATH_H
+
+typedef struct {
+    char **model_name;
+    int num;
+} srmodel_list_t;
+
+srmodel_list_t *esp_srmodel_init(const char *partition_label);
+char *esp_srmodel_filter(srmodel_list_t *models, const char *keyword1, const char *keyword2);
+
+#endif
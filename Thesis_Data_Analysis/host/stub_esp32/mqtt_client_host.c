@@ -0,0 +1,471 @@
+/**
+ * 主机端 esp-mqtt 桩的实现: 最小 MQTT 3.1.1 客户端 (TCP，无 TLS)，用于把固件 MQTT 代码接到本机 broker
+ * (mosquitto) 上做集成测试。与 esp-mqtt 的行为保持一致的部分:
+ *   - 一个网络线程负责连接 / 收包 / 心跳，事件回调在该线程中执行
+ *   - 断线后按 reconnect_timeout_ms (默认 10s，可用环境变量 HOST_MQTT_RECONNECT_MS 覆盖) 自动重连
+ *   - 未连接时 publish 返回 -1；QoS 0 返回 0，QoS 1 返回 msg_id，收到 PUBACK 时发 MQTT_EVENT_PUBLISHED
+ *   - 已发出但未收到 PUBACK 的 QoS 1 消息保存在客户端内部，重连后 (CONNECTED 事件之前) 按原顺序带 DUP 标志重发
+ */
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "mqtt_client.h"
+
+struct pending {
+    int msg_id;
+    uint8_t *pkt;
+    int len;
+    struct pending *next;
+};
+
+struct host_mqtt_client {
+    char host[64];
+    int port;
+    char client_id[64];
+    int keepalive;
+    int reconnect_ms;
+    char *will_topic;
+    char *will_msg;
+    int will_qos;
+    int will_retain;
+
+    esp_event_handler_t handler;
+    void *handler_args;
+
+    struct pending *unacked;    // 未确认的 QoS 1 消息 (按发送顺序)
+
+    pthread_t thread;
+    pthread_mutex_t tx;     // 写 socket 互斥 (任意任务都可以 publish)
+    volatile int sock;
+    volatile int connected;
+    volatile int running;
+    uint16_t next_id;
+};
+
+/* ---------------- 编码 ---------------- */
+static int _put_len(uint8_t *p, uint32_t len)
+{
+    int n = 0;
+    do {
+        uint8_t b = len % 128;
+        len /= 128;
+        p[n++] = b | (len ? 0x80 : 0);
+    } while (len);
+    return n;
+}
+
+static int _put_str(uint8_t *p, const char *s, int len)
+{
+    p[0] = (uint8_t)(len >> 8);
+    p[1] = (uint8_t)len;
+    memcpy(p + 2, s, len);
+    return len + 2;
+}
+
+static int _send_all(struct host_mqtt_client *c, const uint8_t *buf, int len)
+{
+    pthread_mutex_lock(&c->tx);
+    int off = 0;
+    while (c->sock >= 0 && off < len)
+    {
+        ssize_t n = send(c->sock, buf + off, len - off, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        off += (int)n;
+    }
+    pthread_mutex_unlock(&c->tx);
+    return off == len ? 0 : -1;
+}
+
+/** @brief 组装固定头 + 可变部分并发送 */
+static int _send_packet(struct host_mqtt_client *c, uint8_t type, const uint8_t *body, int len)
+{
+    uint8_t *pkt = malloc(len + 5);
+    pkt[0] = type;
+    int h = 1 + _put_len(pkt + 1, (uint32_t)len);
+    memcpy(pkt + h, body, len);
+    int r = _send_all(c, pkt, h + len);
+    free(pkt);
+    return r;
+}
+
+/** @brief 收到 PUBACK: 从未确认列表中移除 */
+static void _unacked_remove(struct host_mqtt_client *c, int msg_id)
+{
+    pthread_mutex_lock(&c->tx);
+    for (struct pending **pp = &c->unacked; *pp; pp = &(*pp)->next)
+    {
+        if ((*pp)->msg_id == msg_id)
+        {
+            struct pending *p = *pp;
+            *pp = p->next;
+            free(p->pkt);
+            free(p);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&c->tx);
+}
+
+/** @brief 重连后按原顺序重发未确认的 QoS 1 消息 */
+static void _unacked_resend(struct host_mqtt_client *c)
+{
+    pthread_mutex_lock(&c->tx);
+    for (struct pending *p = c->unacked; p && c->sock >= 0; p = p->next)
+    {
+        p->pkt[0] |= 0x08;      // DUP
+        send(c->sock, p->pkt, p->len, MSG_NOSIGNAL);
+    }
+    pthread_mutex_unlock(&c->tx);
+}
+
+/* ---------------- 事件 ---------------- */
+static void _dispatch(struct host_mqtt_client *c, esp_mqtt_event_t *ev)
+{
+    ev->client = c;
+    if (c->handler) c->handler(c->handler_args, "MQTT_EVENTS", ev->event_id, ev);
+}
+
+static void _simple_event(struct host_mqtt_client *c, esp_mqtt_event_id_t id, int msg_id)
+{
+    esp_mqtt_event_t ev = { 0 };
+    ev.event_id = id;
+    ev.msg_id = msg_id;
+    _dispatch(c, &ev);
+}
+
+/* ---------------- 连接 ---------------- */
+static int _tcp_connect(const char *host, int port)
+{
+    char sport[8];
+    struct addrinfo hints = { 0 }, *res = NULL;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(sport, sizeof(sport), "%d", port);
+    if (getaddrinfo(host, sport, &hints, &res) != 0) return -1;
+    int s = -1;
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next)
+    {
+        s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (s < 0) continue;
+        if (connect(s, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(s);
+        s = -1;
+    }
+    freeaddrinfo(res);
+    return s;
+}
+
+static int _send_connect(struct host_mqtt_client *c)
+{
+    uint8_t body[512];
+    int n = _put_str(body, "MQTT", 4);
+    body[n++] = 4;                              // 协议级别 3.1.1
+    uint8_t flags = 0x02;                       // clean session
+    if (c->will_topic) flags |= 0x04 | (uint8_t)((c->will_qos & 3) << 3) | (c->will_retain ? 0x20 : 0);
+    body[n++] = flags;
+    body[n++] = (uint8_t)(c->keepalive >> 8);
+    body[n++] = (uint8_t)c->keepalive;
+    n += _put_str(body + n, c->client_id, (int)strlen(c->client_id));
+    if (c->will_topic)
+    {
+        n += _put_str(body + n, c->will_topic, (int)strlen(c->will_topic));
+        n += _put_str(body + n, c->will_msg, (int)strlen(c->will_msg));
+    }
+    return _send_packet(c, 0x10, body, n);
+}
+
+/** @brief 读满 len 字节，超时 / 断开返回 -1 */
+static int _recv_all(int s, uint8_t *buf, int len, int timeout_ms)
+{
+    int off = 0;
+    while (off < len)
+    {
+        struct pollfd pfd = { s, POLLIN, 0 };
+        if (poll(&pfd, 1, timeout_ms) <= 0) return -1;
+        ssize_t n = recv(s, buf + off, len - off, 0);
+        if (n <= 0) return -1;
+        off += (int)n;
+    }
+    return 0;
+}
+
+/** @brief 读一个完整报文，返回类型字节; 剩余部分存入 *body (调用者释放) */
+static int _recv_packet(int s, uint8_t **body, uint32_t *len, int timeout_ms)
+{
+    uint8_t type, b;
+    if (_recv_all(s, &type, 1, timeout_ms) < 0) return -1;
+    uint32_t rl = 0, mul = 1;
+    do {
+        if (_recv_all(s, &b, 1, 5000) < 0) return -1;
+        rl += (b & 0x7F) * mul;
+        mul *= 128;
+    } while (b & 0x80);
+    *body = malloc(rl + 1);
+    if (rl && _recv_all(s, *body, (int)rl, 5000) < 0) { free(*body); return -1; }
+    (*body)[rl] = 0;
+    *len = rl;
+    return type;
+}
+
+static void _handle_publish(struct host_mqtt_client *c, uint8_t type, uint8_t *p, uint32_t len)
+{
+    int qos = (type >> 1) & 3;
+    uint16_t tl = (uint16_t)(p[0] << 8 | p[1]);
+    uint32_t off = 2 + tl;
+    int msg_id = 0;
+    if (qos)
+    {
+        msg_id = p[off] << 8 | p[off + 1];
+        off += 2;
+    }
+
+    esp_mqtt_event_t ev = { 0 };
+    ev.event_id = MQTT_EVENT_DATA;
+    ev.topic = (char *)p + 2;
+    ev.topic_len = tl;
+    ev.data = (char *)p + off;
+    ev.data_len = ev.total_data_len = (int)(len - off);
+    ev.msg_id = msg_id;
+    ev.qos = qos;
+    ev.retain = type & 1;
+    _dispatch(c, &ev);
+
+    if (qos == 1)
+    {
+        uint8_t ack[2] = { (uint8_t)(msg_id >> 8), (uint8_t)msg_id };
+        _send_packet(c, 0x40, ack, 2);
+    }
+}
+
+static void *_net_thread(void *arg)
+{
+    struct host_mqtt_client *c = arg;
+    while (c->running)
+    {
+        int s = _tcp_connect(c->host, c->port);
+        if (s >= 0)
+        {
+            c->sock = s;
+            uint8_t *body = NULL;
+            uint32_t len = 0;
+            if (_send_connect(c) == 0 && _recv_packet(s, &body, &len, 5000) == 0x20 && len >= 2 && body[1] == 0)
+            {
+                free(body);
+                _unacked_resend(c);
+                c->connected = 1;
+                _simple_event(c, MQTT_EVENT_CONNECTED, 0);
+
+                time_t last_tx = time(NULL);
+                while (c->running)
+                {
+                    int type = _recv_packet(s, &body, &len, 500);
+                    if (type < 0)
+                    {
+                        // 只是超时: 到心跳时间就发 PINGREQ; 真正断开时 poll 会返回可读且 recv = 0
+                        struct pollfd pfd = { s, POLLIN, 0 };
+                        if (poll(&pfd, 1, 0) != 0) break;
+                        if (c->keepalive && time(NULL) - last_tx >= c->keepalive / 2)
+                        {
+                            uint8_t ping[2] = { 0xC0, 0x00 };
+                            if (_send_all(c, ping, 2) < 0) break;
+                            last_tx = time(NULL);
+                        }
+                        continue;
+                    }
+                    switch (type & 0xF0)
+                    {
+                        case 0x30: _handle_publish(c, (uint8_t)type, body, len); break;
+                        case 0x40:
+                            _unacked_remove(c, body[0] << 8 | body[1]);
+                            _simple_event(c, MQTT_EVENT_PUBLISHED, body[0] << 8 | body[1]);
+                            break;
+                        case 0x90: _simple_event(c, MQTT_EVENT_SUBSCRIBED, body[0] << 8 | body[1]); break;
+                        default: break;
+                    }
+                    free(body);
+                }
+            }
+            else
+            {
+                free(body);
+            }
+
+            pthread_mutex_lock(&c->tx);
+            c->sock = -1;
+            pthread_mutex_unlock(&c->tx);
+            close(s);
+            if (c->connected)
+            {
+                c->connected = 0;
+                _simple_event(c, MQTT_EVENT_DISCONNECTED, 0);
+            }
+        }
+        if (!c->running) break;
+        _simple_event(c, MQTT_EVENT_ERROR, 0);
+        for (int waited = 0; c->running && waited < c->reconnect_ms; waited += 50) usleep(50 * 1000);
+    }
+    return NULL;
+}
+
+/* ---------------- 对外接口 ---------------- */
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *cfg)
+{
+    struct host_mqtt_client *c = calloc(1, sizeof(*c));
+    const char *uri = cfg->broker.address.uri;
+    c->port = 1883;
+    if (uri)
+    {
+        const char *h = strstr(uri, "://");
+        h = h ? h + 3 : uri;
+        const char *colon = strrchr(h, ':');
+        size_t hl = colon ? (size_t)(colon - h) : strlen(h);
+        if (hl >= sizeof(c->host)) hl = sizeof(c->host) - 1;
+        memcpy(c->host, h, hl);
+        if (colon) c->port = atoi(colon + 1);
+    }
+    else if (cfg->broker.address.hostname)
+    {
+        snprintf(c->host, sizeof(c->host), "%s", cfg->broker.address.hostname);
+        if (cfg->broker.address.port) c->port = (int)cfg->broker.address.port;
+    }
+    // 测试程序可以用环境变量把固件里写死的 broker 地址改到本机
+    if (getenv("HOST_MQTT_HOST")) snprintf(c->host, sizeof(c->host), "%s", getenv("HOST_MQTT_HOST"));
+    if (getenv("HOST_MQTT_PORT")) c->port = atoi(getenv("HOST_MQTT_PORT"));
+
+    if (cfg->credentials.client_id) snprintf(c->client_id, sizeof(c->client_id), "%s", cfg->credentials.client_id);
+    else snprintf(c->client_id, sizeof(c->client_id), "host_esp32_%d", (int)getpid());
+    c->keepalive = cfg->session.keepalive ? cfg->session.keepalive : 120;
+    c->reconnect_ms = cfg->network.reconnect_timeout_ms ? cfg->network.reconnect_timeout_ms : 10000;
+    if (getenv("HOST_MQTT_RECONNECT_MS")) c->reconnect_ms = atoi(getenv("HOST_MQTT_RECONNECT_MS"));
+    if (cfg->session.last_will.topic)
+    {
+        c->will_topic = strdup(cfg->session.last_will.topic);
+        c->will_msg = strdup(cfg->session.last_will.msg ? cfg->session.last_will.msg : "");
+        c->will_qos = cfg->session.last_will.qos;
+        c->will_retain = cfg->session.last_will.retain;
+    }
+    c->sock = -1;
+    c->next_id = 1;
+    pthread_mutex_init(&c->tx, NULL);
+    return c;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t c, int32_t event, esp_event_handler_t handler, void *args)
+{
+    (void)event;
+    c->handler = handler;
+    c->handler_args = args;
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t c)
+{
+    if (c->running) return ESP_FAIL;
+    c->running = 1;
+    return pthread_create(&c->thread, NULL, _net_thread, c) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t c)
+{
+    if (!c->running) return ESP_FAIL;
+    c->running = 0;
+    pthread_mutex_lock(&c->tx);
+    if (c->sock >= 0)
+    {
+        uint8_t disc[2] = { 0xE0, 0x00 };
+        send(c->sock, disc, 2, MSG_NOSIGNAL);
+        shutdown(c->sock, SHUT_RDWR);
+    }
+    pthread_mutex_unlock(&c->tx);
+    pthread_join(c->thread, NULL);
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t c)
+{
+    if (c->running) esp_mqtt_client_stop(c);
+    while (c->unacked)
+    {
+        struct pending *p = c->unacked;
+        c->unacked = p->next;
+        free(p->pkt);
+        free(p);
+    }
+    free(c->will_topic);
+    free(c->will_msg);
+    free(c);
+    return ESP_OK;
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t c, const char *topic, const char *data, int len, int qos, int retain)
+{
+    if (!c || !c->connected) return -1;
+    if (len <= 0) len = data ? (int)strlen(data) : 0;
+    int tl = (int)strlen(topic);
+    int body_len = 2 + tl + (qos > 0 ? 2 : 0) + len;
+    uint8_t *pkt = malloc(body_len + 5);
+    pkt[0] = (uint8_t)(0x30 | ((qos & 3) << 1) | (retain ? 1 : 0));
+    int n = 1 + _put_len(pkt + 1, (uint32_t)body_len);
+    n += _put_str(pkt + n, topic, tl);
+
+    pthread_mutex_lock(&c->tx);
+    int msg_id = 0;
+    if (qos > 0)
+    {
+        msg_id = c->next_id++;
+        if (c->next_id == 0) c->next_id = 1;
+        pkt[n++] = (uint8_t)(msg_id >> 8);
+        pkt[n++] = (uint8_t)msg_id;
+    }
+    memcpy(pkt + n, data, len);
+    n += len;
+
+    int sent = 0;
+    while (c->sock >= 0 && sent < n)
+    {
+        ssize_t r = send(c->sock, pkt + sent, n - sent, MSG_NOSIGNAL);
+        if (r <= 0) break;
+        sent += (int)r;
+    }
+    if (qos > 0)
+    {
+        // 与 esp-mqtt 一样: 连接状态下 QoS 1 消息先进入内部发件箱，写失败也在重连后重发
+        struct pending *p = malloc(sizeof(*p)), **pp = &c->unacked;
+        p->msg_id = msg_id;
+        p->pkt = pkt;
+        p->len = n;
+        p->next = NULL;
+        while (*pp) pp = &(*pp)->next;
+        *pp = p;
+        pkt = NULL;
+    }
+    pthread_mutex_unlock(&c->tx);
+    free(pkt);
+    if (qos == 0 && sent < n) return -1;
+    return msg_id;
+}
+
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t c, const char *topic, int qos)
+{
+    if (!c || !c->connected) return -1;
+    int tl = (int)strlen(topic);
+    uint8_t *body = malloc(tl + 5);
+    pthread_mutex_lock(&c->tx);
+    int msg_id = c->next_id++;
+    if (c->next_id == 0) c->next_id = 1;
+    pthread_mutex_unlock(&c->tx);
+    body[0] = (uint8_t)(msg_id >> 8);
+    body[1] = (uint8_t)msg_id;
+    int n = 2 + _put_str(body + 2, topic, tl);
+    body[n++] = (uint8_t)qos;
+    int r = _send_packet(c, 0x82, body, n);
+    free(body);
+    return r < 0 ? -1 : msg_id;
+}
@@ -0,0 +1,42 @@
+/* 主机端编译桩: NVS 键值存储 (内存实现)，并统计写入次数 / 字节数，用于评估 Flash 磨损 */
+#ifndef HOST_NVS_H
+#define HOST_NVS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#define ESP_ERR_NVS_BASE            0x1100
+#define ESP_ERR_NVS_NOT_FOUND       (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_INVALID_LENGTH  (ESP_ERR_NVS_BASE + 0x0c)
+
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out);
+void nvs_close(nvs_handle_t h);
+esp_err_t nvs_commit(nvs_handle_t h);
+esp_err_t nvs_erase_key(nvs_handle_t h, const char *key);
+esp_err_t nvs_erase_all(nvs_handle_t h);
+
+esp_err_t nvs_set_blob(nvs_handle_t h, const char *key, const void *value, size_t len);
+esp_err_t nvs_get_blob(nvs_handle_t h, const char *key, void *out, size_t *len);
+esp_err_t nvs_set_u8(nvs_handle_t h, const char *key, uint8_t v);
+esp_err_t nvs_get_u8(nvs_handle_t h, const char *key, uint8_t *v);
+esp_err_t nvs_set_u16(nvs_handle_t h, const char *key, uint16_t v);
+esp_err_t nvs_get_u16(nvs_handle_t h, const char *key, uint16_t *v);
+esp_err_t nvs_set_u32(nvs_handle_t h, const char *key, uint32_t v);
+esp_err_t nvs_get_u32(nvs_handle_t h, const char *key, uint32_t *v);
+esp_err_t nvs_set_i32(nvs_handle_t h, const char *key, int32_t v);
+esp_err_t nvs_get_i32(nvs_handle_t h, const char *key, int32_t *v);
+
+/** @brief 写入统计 (测试程序读取): set 调用次数与写入的数据字节数 */
+typedef struct {
+    uint32_t writes;
+    uint32_t bytes;
+    uint32_t erases;
+} host_nvs_stats_t;
+
+void host_nvs_get_stats(host_nvs_stats_t *out);
+
+#endif
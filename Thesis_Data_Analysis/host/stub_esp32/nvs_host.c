@@ -0,0 +1,138 @@
+/* 主机端 NVS 桩的实现: 按 (命名空间, 键) 保存在内存链表中 */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nvs.h"
+
+#define NS_MAX 16
+
+typedef struct kv {
+    char ns[16];
+    char key[16];
+    void *data;
+    size_t len;
+    struct kv *next;
+} kv_t;
+
+static pthread_mutex_t s_mtx = PTHREAD_MUTEX_INITIALIZER;
+static kv_t *s_kv;
+static char s_ns[NS_MAX][16];
+static int s_ns_num;
+static host_nvs_stats_t s_stats;
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    (void)mode;
+    pthread_mutex_lock(&s_mtx);
+    int i;
+    for (i = 0; i < s_ns_num; i++)
+        if (strncmp(s_ns[i], ns, 15) == 0) break;
+    if (i == s_ns_num)
+    {
+        if (s_ns_num == NS_MAX) { pthread_mutex_unlock(&s_mtx); return ESP_FAIL; }
+        strncpy(s_ns[s_ns_num++], ns, 15);
+    }
+    pthread_mutex_unlock(&s_mtx);
+    *out = (nvs_handle_t)(i + 1);
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t h) { (void)h; }
+esp_err_t nvs_commit(nvs_handle_t h) { (void)h; return ESP_OK; }
+
+static kv_t **_find(nvs_handle_t h, const char *key)
+{
+    kv_t **pp = &s_kv;
+    for (; *pp; pp = &(*pp)->next)
+        if (strcmp((*pp)->ns, s_ns[h - 1]) == 0 && strncmp((*pp)->key, key, 15) == 0) break;
+    return pp;
+}
+
+static esp_err_t _set(nvs_handle_t h, const char *key, const void *v, size_t len)
+{
+    pthread_mutex_lock(&s_mtx);
+    kv_t **pp = _find(h, key);
+    if (!*pp)
+    {
+        *pp = calloc(1, sizeof(kv_t));
+        strncpy((*pp)->ns, s_ns[h - 1], 15);
+        strncpy((*pp)->key, key, 15);
+    }
+    free((*pp)->data);
+    (*pp)->data = malloc(len ? len : 1);
+    memcpy((*pp)->data, v, len);
+    (*pp)->len = len;
+    s_stats.writes++;
+    s_stats.bytes += len;
+    pthread_mutex_unlock(&s_mtx);
+    return ESP_OK;
+}
+
+static esp_err_t _get(nvs_handle_t h, const char *key, void *out, size_t *len, int exact)
+{
+    pthread_mutex_lock(&s_mtx);
+    kv_t *kv = *_find(h, key);
+    esp_err_t err = ESP_OK;
+    if (!kv) err = ESP_ERR_NVS_NOT_FOUND;
+    else if (!out) *len = kv->len;          // 只查询长度
+    else if (exact ? kv->len != *len : kv->len > *len) err = ESP_ERR_NVS_INVALID_LENGTH;
+    else { memcpy(out, kv->data, kv->len); *len = kv->len; }
+    pthread_mutex_unlock(&s_mtx);
+    return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t h, const char *key)
+{
+    pthread_mutex_lock(&s_mtx);
+    kv_t **pp = _find(h, key);
+    esp_err_t err = ESP_ERR_NVS_NOT_FOUND;
+    if (*pp)
+    {
+        kv_t *kv = *pp;
+        *pp = kv->next;
+        free(kv->data);
+        free(kv);
+        s_stats.erases++;
+        err = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_mtx);
+    return err;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t h)
+{
+    pthread_mutex_lock(&s_mtx);
+    for (kv_t **pp = &s_kv; *pp;)
+    {
+        if (strcmp((*pp)->ns, s_ns[h - 1]) == 0)
+        {
+            kv_t *kv = *pp;
+            *pp = kv->next;
+            free(kv->data);
+            free(kv);
+            s_stats.erases++;
+        }
+        else pp = &(*pp)->next;
+    }
+    pthread_mutex_unlock(&s_mtx);
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t h, const char *key, const void *value, size_t len) { return _set(h, key, value, len); }
+esp_err_t nvs_get_blob(nvs_handle_t h, const char *key, void *out, size_t *len) { return _get(h, key, out, len, 0); }
+
+#define NVS_INT(name, type)                                                                     \
+    esp_err_t nvs_set_##name(nvs_handle_t h, const char *key, type v) { return _set(h, key, &v, sizeof(v)); } \
+    esp_err_t nvs_get_##name(nvs_handle_t h, const char *key, type *v) { size_t l = sizeof(*v); return _get(h, key, v, &l, 1); }
+
+NVS_INT(u8, uint8_t)
+NVS_INT(u16, uint16_t)
+NVS_INT(u32, uint32_t)
+NVS_INT(i32, int32_t)
+
+void host_nvs_get_stats(host_nvs_stats_t *out)
+{
+    pthread_mutex_lock(&s_mtx);
+    *out = s_stats;
+    pthread_mutex_unlock(&s_mtx);
+}
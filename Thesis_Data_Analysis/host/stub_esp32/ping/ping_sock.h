@@ -0,0 +1,45 @@
+/* 主机端编译桩: esp_ping 会话接口 (空操作，只为让 dev_csi.c 能在主机上编译) */
+#ifndef HOST_PING_SOCK_H
+#define HOST_PING_SOCK_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef void *esp_ping_handle_t;
+
+#define ESP_IPADDR_TYPE_V4      0
+#define ESP_PING_COUNT_INFINITE 0
+
+typedef struct {
+    struct {
+        union { struct { uint32_t addr; } ip4; } u_addr;
+        uint8_t type;
+    } target_addr;
+    uint32_t count;
+    uint32_t interval_ms;
+    uint32_t timeout_ms;
+    uint32_t data_size;
+} esp_ping_config_t;
+
+#define ESP_PING_DEFAULT_CONFIG() { .count = 5, .interval_ms = 1000, .timeout_ms = 1000, .data_size = 64 }
+
+typedef struct { void *cb_args; } esp_ping_callbacks_t;
+
+typedef enum { ESP_PING_PROF_SEQNO, ESP_PING_PROF_REQUEST, ESP_PING_PROF_REPLY } esp_ping_profile_t;
+
+static inline esp_err_t esp_ping_new_session(const esp_ping_config_t *cfg, const esp_ping_callbacks_t *cbs,
+                                             esp_ping_handle_t *out)
+{
+    (void)cfg; (void)cbs; *out = NULL;
+    return ESP_FAIL;
+}
+static inline esp_err_t esp_ping_start(esp_ping_handle_t h) { (void)h; return ESP_OK; }
+static inline esp_err_t esp_ping_stop(esp_ping_handle_t h) { (void)h; return ESP_OK; }
+static inline esp_err_t esp_ping_delete_session(esp_ping_handle_t h) { (void)h; return ESP_OK; }
+static inline esp_err_t esp_ping_get_profile(esp_ping_handle_t h, esp_ping_profile_t p, void *out, uint32_t size)
+{
+    (void)h; (void)p; (void)out; (void)size;
+    return ESP_FAIL;
+}
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * 主机端 WakeNet 替身模型: ESP-SR 的 WakeNet (MFCC 前端 + 量化网络) 只以 ESP32 / ESP32-S3 预编译库发布，
+ * 不能在 x86 主机上链接运行，这里用一个 "能量包络 + 时长" 检测器实现同一个 esp_wn_iface_t 接口:
+ *   * 每帧 512 点 (16kHz，32ms，与 WakeNet9 相同)，帧能量 (dBFS) 高于跟踪的底噪 + 门限即为有声
+ *   * 有声段 (中间允许不超过 WN_HOST_HANG 帧的短停顿) 结束时，时长落在 0.4~1.2s 内判为唤醒
+ *   * DET_MODE_90 门限 12dB，DET_MODE_95 门限 15dB
+ * 它只用来验证固件的帧处理 / 统计 / 唤醒后暂停这条路径和评估脚本本身，误唤醒率与检出率不代表 WakeNet；
+ * 需要评估其他主机端模型时，用 sim_7_2_5_kws_wav_eval.py --model-src 换掉本文件。
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_wn_iface.h"
+#include "esp_wn_models.h"
+#include "model_path.h"
+
+#define WN_HOST_NAME        "wn_host_energy"
+#define WN_HOST_CHUNK       512
+#define WN_HOST_RATE        16000
+#define WN_HOST_FRAME_MS    (WN_HOST_CHUNK * 1000 / WN_HOST_RATE)
+#define WN_HOST_HANG        6       // 有声段中允许的最长停顿 (帧)，超过即认为一段结束
+#define WN_HOST_WORD_MIN    (400 / WN_HOST_FRAME_MS)
+#define WN_HOST_WORD_MAX    (1200 / WN_HOST_FRAME_MS)
+
+struct model_iface_data_t {
+    float th_db;
+    float floor_db;
+    int   started;
+    int   seg;          // 当前段已持续的帧数 (含停顿)
+    int   gap;          // 当前连续无声帧数
+};
+
+static model_iface_data_t *_create(const void *model_name, det_mode_t det_mode)
+{
+    (void)model_name;
+    model_iface_data_t *m = calloc(1, sizeof(*m));
+    if (m) m->th_db = det_mode == DET_MODE_95 ? 15.0f : 12.0f;
+    return m;
+}
+
+static int _chunk(model_iface_data_t *m) { (void)m; return WN_HOST_CHUNK; }
+static int _rate(model_iface_data_t *m) { (void)m; return WN_HOST_RATE; }
+static char *_word(model_iface_data_t *m, int idx) { (void)m; (void)idx; return "host_energy"; }
+static void _destroy(model_iface_data_t *m) { free(m); }
+
+static wakenet_state_t _detect(model_iface_data_t *m, int16_t *samples)
+{
+    double sum = 0;
+    for (int i = 0; i < WN_HOST_CHUNK; i++) sum += (double)samples[i] * samples[i];
+    float e = (float)(10.0 * log10(sum / WN_HOST_CHUNK / (32768.0 * 32768.0) + 1e-12));
+
+    // 底噪跟踪: 下降快、上升慢 (长时间的持续声音会慢慢被当作背景)
+    if (!m->started) {
+        m->floor_db = e;
+        m->started = 1;
+    } else if (e < m->floor_db) {
+        m->floor_db += 0.5f * (e - m->floor_db);
+    } else {
+        m->floor_db += 0.002f * (e - m->floor_db);
+    }
+
+    if (e > m->floor_db + m->th_db) {
+        m->seg += m->gap + 1;
+        m->gap = 0;
+        return WAKENET_NO_DETECT;
+    }
+    if (m->seg == 0) return WAKENET_NO_DETECT;
+    if (++m->gap <= WN_HOST_HANG) return WAKENET_NO_DETECT;
+
+    int len = m->seg;
+    m->seg = 0;
+    m->gap = 0;
+    return (len >= WN_HOST_WORD_MIN && len <= WN_HOST_WORD_MAX) ? WAKENET_DETECTED : WAKENET_NO_DETECT;
+}
+
+static const esp_wn_iface_t s_iface = {
+    .create = _create,
+    .get_samp_chunksize = _chunk,
+    .get_samp_rate = _rate,
+    .get_word_name = _word,
+    .detect = _detect,
+    .destroy = _destroy,
+};
+
+const esp_wn_iface_t *esp_wn_handle_from_name(const char *model_name)
+{
+    (void)model_name;
+    return &s_iface;
+}
+
+srmodel_list_t *esp_srmodel_init(const char *partition_label)
+{
+    static char *s_names[] = { WN_HOST_NAME };
+    static srmodel_list_t s_list = { s_names, 1 };
+    (void)partition_label;
+    return &s_list;
+}
+
+char *esp_srmodel_filter(srmodel_list_t *models, const char *keyword1, const char *keyword2)
+{
+    for (int i = 0; models && i < models->num; i++) {
+        if ((!keyword1 || strstr(models->model_name[i], keyword1)) &&
+            (!keyword2 || strstr(models->model_name[i], keyword2)))
+            return models->model_name[i];
+    }
+    return NULL;
+}
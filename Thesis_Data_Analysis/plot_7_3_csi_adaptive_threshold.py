@@ -0,0 +1,205 @@
+import os
+import argparse
+import pandas as pd
+import matplotlib.pyplot as plt
+import numpy as np
+
+from plot_7_3_csi_ensemble_eval import (parse_ensemble_log, parse_weights, evaluate,
+                                        CONSECUTIVE_HITS, LEAVE_TIMEOUT_MS,
+                                        FUSE_THRESHOLD, FUSE_NORM_CAP)
+
+# ==========================================
+# 1. 全局配置 (与固件 dev_csi.c 保持一致)
+# ==========================================
+DEFAULT_THRESHOLDS = {'V1': 8, 'V2': 150, 'V3': 250}   # s_detectors[].th_default
+NF_WIN = 64                 # CSI_NF_WIN
+NF_MIN_SAMPLES = 32         # CSI_NF_MIN_SAMPLES
+NF_UPDATE_MS = 10000        # CSI_NF_UPDATE_MS
+NF_K_ENTER = 6              # CSI_NF_K_ENTER
+NF_K_LEAVE = 3              # CSI_NF_K_LEAVE
+NF_STEP_UP = 16             # CSI_NF_STEP_UP
+NF_STEP_DOWN = 4            # CSI_NF_STEP_DOWN
+NF_HOLD_MS = 3000           # CSI_PROBE_HOLD_MS: 超过进入阈值后这段时间内的窗口不计入噪声样本
+CALIB_MS = 30000            # CSI_CALIB_DEFAULT_MS
+
+
+def nf_estimate(samples, th_default):
+    """复现 _nf_estimate(): 中位数 + K·σ，σ = 1.4826·MAD，并限制在出厂阈值的 [1/4, 4] 倍。"""
+    n = len(samples)
+    if n < NF_MIN_SAMPLES:
+        return None
+    buf = sorted(samples)
+    median = buf[n // 2]
+    dev = sorted(abs(v - median) for v in buf)
+    sigma = max(1, (dev[n // 2] * 1483 + 999) // 1000)
+    lo, hi = th_default // 4 + 1, th_default * 4
+    enter = min(max(median + NF_K_ENTER * sigma, lo), hi)
+    leave = median + NF_K_LEAVE * sigma
+    if leave >= enter:
+        leave = enter * 2 // 3
+    return enter, max(leave, 1)
+
+
+def nf_step(cur, target):
+    """复现 _nf_step(): 上调 1/16，下调 1/4 (向上取整)。"""
+    if target > cur:
+        return cur + (target - cur + NF_STEP_UP - 1) // NF_STEP_UP
+    return cur - (cur - target + NF_STEP_DOWN - 1) // NF_STEP_DOWN
+
+
+def fuse_row(scores, thresholds, weights):
+    acc = wsum = 0
+    for name, th in thresholds.items():
+        w = weights.get(name, 0)
+        if w == 0 or th == 0:
+            continue
+        acc += min(scores[name] * FUSE_THRESHOLD // th, FUSE_NORM_CAP) * w
+        wsum += w
+    return acc // wsum if wsum else 0
+
+
+def replay_fixed(df, names, weights):
+    """改造前: 出厂固定阈值，进入/保持共用一个阈值。"""
+    th = {n: DEFAULT_THRESHOLDS[n] for n in names}
+    out = np.zeros(len(df), dtype=bool)
+    consecutive, present, last_active = 0, False, 0
+    for i, row in enumerate(df.itertuples(index=False)):
+        scores = {n: getattr(row, n) for n in names}
+        t = row.Timestamp_ms
+        if fuse_row(scores, th, weights) > FUSE_THRESHOLD:
+            consecutive += 1
+            if consecutive >= CONSECUTIVE_HITS:
+                last_active, present = t, True
+        else:
+            consecutive = 0
+        if present and t - last_active > LEAVE_TIMEOUT_MS:
+            present = False
+        out[i] = present
+    return out
+
+
+def replay_adaptive(df, names, weights, calib_rows):
+    """改造后: 空房标定 + 在线中位数/MAD 噪声基底 + 进入/保持双阈值迟滞。"""
+    enter = {n: DEFAULT_THRESHOLDS[n] for n in names}
+    leave = {n: DEFAULT_THRESHOLDS[n] * 2 // 3 for n in names}
+    hist = {n: [] for n in names}
+    out = np.zeros(len(df), dtype=bool)
+    consecutive, present, last_active = 0, False, 0
+    last_nf = df['Timestamp_ms'].iloc[0]
+    last_over = None
+    log = []
+
+    for i, row in enumerate(df.itertuples(index=False)):
+        scores = {n: getattr(row, n) for n in names}
+        t = row.Timestamp_ms
+
+        over_enter = fuse_row(scores, enter, weights) > FUSE_THRESHOLD
+        if over_enter:
+            last_over = t
+        if i < calib_rows:
+            for n in names:
+                hist[n] = (hist[n] + [scores[n]])[-NF_WIN:]
+            if i == calib_rows - 1:
+                for n in names:
+                    est = nf_estimate(hist[n], DEFAULT_THRESHOLDS[n])
+                    if est:
+                        enter[n], leave[n] = est
+                log.append((t, '标定', dict(enter), dict(leave)))
+            out[i] = present
+            continue
+
+        if over_enter:
+            consecutive += 1
+        else:
+            consecutive = 0
+        if not present:
+            if consecutive >= CONSECUTIVE_HITS:
+                last_active, present = t, True
+        elif fuse_row(scores, leave, weights) > FUSE_THRESHOLD:
+            last_active = t
+        if present and t - last_active > LEAVE_TIMEOUT_MS:
+            present = False
+
+        recent_motion = last_over is not None and t - last_over < NF_HOLD_MS
+        if not present and not recent_motion:
+            for n in names:
+                hist[n] = (hist[n] + [scores[n]])[-NF_WIN:]
+        if t - last_nf >= NF_UPDATE_MS:
+            last_nf = t
+            for n in names:
+                est = nf_estimate(hist[n], DEFAULT_THRESHOLDS[n])
+                if not est:
+                    continue
+                ne = nf_step(enter[n], est[0])
+                nl = nf_step(leave[n], est[1])
+                enter[n], leave[n] = ne, min(nl, ne)
+            log.append((t, '在线', dict(enter), dict(leave)))
+        out[i] = present
+    return out, log
+
+
+def count_false_triggers(truth, decision):
+    """无人时段内 "关 -> 开" 的次数 (误触发开灯)，回放起点视为关灯。"""
+    prev = np.concatenate(([False], decision[:-1]))
+    rising = decision & ~prev
+    return int(np.sum(rising & ~truth))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='CSI 自适应阈值回放测试 (改造前/后误触发对比)')
+    parser.add_argument('--input', default='data/csi_ensemble_annotated.txt', help='带 <标签> 标注的 [雷达-ENS] 日志')
+    parser.add_argument('--absent-labels', default='无人,离开', help='表示"房间无人"的标签 (逗号分隔)')
+    parser.add_argument('--weights', default='V1=1,V2=1,V3=2', help='融合权重，与固件 s_detectors[] 一致')
+    parser.add_argument('--calib-s', type=float, default=CALIB_MS / 1000.0,
+                        help='把日志开头多少秒当作空房标定 (0 = 不标定，仅在线估计)')
+    args = parser.parse_args()
+
+    absent = {s.strip() for s in args.absent_labels.split(',') if s.strip()}
+    df, thresholds = parse_ensemble_log(args.input, absent)
+    if df is not None:
+        names = [n for n in sorted(thresholds) if n in DEFAULT_THRESHOLDS]
+        df = df.dropna(subset=names).reset_index(drop=True)
+        weights = parse_weights(args.weights)
+        ts = df['Timestamp_ms'].to_numpy()
+        truth = df['Present'].to_numpy()
+
+        calib_rows = int(np.searchsorted(ts, ts[0] + args.calib_s * 1000.0)) if args.calib_s > 0 else 0
+        if calib_rows and truth[:calib_rows].any():
+            print("⚠️ 标定窗口内包含有人标签，标定结果会偏高。")
+
+        fixed = replay_fixed(df, names, weights)
+        adaptive, th_log = replay_adaptive(df, names, weights, calib_rows)
+
+        # 标定期间不参与统计
+        sl = slice(calib_rows, None)
+        rows = {}
+        for label, dec in (('固定阈值', fixed), ('自适应+迟滞', adaptive)):
+            r = evaluate(ts[sl], truth[sl], dec[sl])
+            r['误触发开灯次数'] = count_false_triggers(truth[sl], dec[sl])
+            rows[label] = r
+        table = pd.DataFrame(rows).T
+
+        print("=" * 60)
+        print("📊 CSI 自适应阈值回放结果:")
+        print(table.round(2))
+        for t, reason, e, l in th_log[-3:]:
+            print(f"  [{reason}] t={t / 1000.0:.1f}s 进入={e} 离开={l}")
+        print("=" * 60)
+        table.to_csv('data/parsed_csi_adaptive_threshold.csv', encoding='utf-8-sig')
+
+        t_s = (ts - ts[0]) / 1000.0
+        fig, ax = plt.subplots(figsize=(12, 4))
+        ax.fill_between(t_s, -0.2, 1.2, where=truth, step='post', color='#2ecc71', alpha=0.15, label='真值: 有人')
+        ax.step(t_s, fixed * 0.9, where='post', color='#e74c3c', label='固定阈值')
+        ax.step(t_s, adaptive * 1.0, where='post', color='#3498db', label='自适应 + 迟滞')
+        if calib_rows:
+            ax.axvspan(0, t_s[calib_rows - 1], color='gray', alpha=0.2, label='空房标定')
+        ax.set_yticks([0, 1])
+        ax.set_yticklabels(['无人', '有人'])
+        ax.set_xlabel('测试时间 (秒)')
+        ax.set_title('固定阈值与自适应阈值的存在判定对比 (日志回放)')
+        ax.legend(loc='upper right', fontsize=8)
+        ax.grid(True, linestyle=':', alpha=0.6)
+        plt.savefig('output/csi_adaptive_threshold.pdf', bbox_inches='tight')
+        plt.savefig('output/csi_adaptive_threshold.png', bbox_inches='tight')
+        print("✅ 回放对比图已生成: output/csi_adaptive_threshold.pdf")
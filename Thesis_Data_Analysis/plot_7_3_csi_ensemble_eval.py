@@ -0,0 +1,231 @@
+import re
+import os
+import argparse
+import pandas as pd
+import matplotlib.pyplot as plt
+import numpy as np
+
+# ==========================================
+# 1. 全局配置
+# ==========================================
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 11
+plt.rcParams['figure.dpi'] = 300
+
+# 与固件 dev_csi.c 保持一致
+CONSECUTIVE_HITS = 2          # 连续超阈值次数才判定有人
+LEAVE_TIMEOUT_MS = 15000      # 最后一次活动后多久判定离开
+FUSE_THRESHOLD = 100          # CSI_FUSE_THRESHOLD
+FUSE_NORM_CAP = 300           # CSI_FUSE_NORM_CAP
+
+
+def parse_ensemble_log(input_txt, absent_labels):
+    """解析 [雷达-ENS] 日志与 <标签> 标注，返回每 500ms 一行的 DataFrame。"""
+    if not os.path.exists(input_txt):
+        print(f"❌ 错误：找不到日志文件 {input_txt}")
+        return None, {}
+
+    # I (时间戳) Dev_CSI: [雷达-ENS] V1:12/8 V2:300/150 V3:400/250 | 融合:150/100 | 模式:0 | 探测:200ms
+    ens_pattern = re.compile(r"I\s+\((\d+)\)\s+Dev_CSI:\s+\[雷达-ENS\]\s+(.*?)\|\s*融合:(\d+)/(\d+)")
+    det_pattern = re.compile(r"(V\w+):(\d+)/(\d+)")
+    probe_pattern = re.compile(r"探测:(\d+)ms")
+    tag_pattern = re.compile(r"<(/?)([^>]+)>")
+
+    rows = []
+    thresholds = {}
+    current_state = "未标注"
+
+    with open(input_txt, 'r', encoding='utf-8', errors='ignore') as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+
+            tag_match = tag_pattern.match(line)
+            if tag_match:
+                current_state = "未标注" if tag_match.group(1) == "/" else tag_match.group(2)
+                continue
+
+            m = ens_pattern.search(line)
+            if not m or current_state == "未标注":
+                continue
+
+            row = {'Timestamp_ms': int(m.group(1)), 'State': current_state,
+                   'Present': current_state not in absent_labels,
+                   'Fused_dev': int(m.group(3))}
+            p = probe_pattern.search(line)
+            row['Probe_ms'] = int(p.group(1)) if p else 50   # 旧固件固定 50ms
+            for name, score, th in det_pattern.findall(m.group(2)):
+                row[name] = int(score)
+                thresholds[name] = int(th)
+            rows.append(row)
+
+    if not rows:
+        print("❌ 未找到 [雷达-ENS] 标注数据，请确认固件处于 csi0 模式且日志已用 <标签> 包裹。")
+        return None, {}
+
+    return pd.DataFrame(rows), thresholds
+
+
+def fuse(df, thresholds, weights):
+    """按固件同样的规则离线重算融合得分 (便于调权重)。"""
+    acc = np.zeros(len(df))
+    wsum = 0
+    for name, th in thresholds.items():
+        w = weights.get(name, 0)
+        if w == 0 or th == 0:
+            continue
+        norm = np.minimum(df[name].to_numpy() * FUSE_THRESHOLD // th, FUSE_NORM_CAP)
+        acc += norm * w
+        wsum += w
+    return acc // wsum if wsum else acc
+
+
+def simulate_decision(ts, scores, threshold):
+    """复现 csi_monitor_task 的判定逻辑，返回每个采样点的 is_present。"""
+    out = np.zeros(len(ts), dtype=bool)
+    consecutive = 0
+    present = False
+    last_active = None
+    for i, (t, s) in enumerate(zip(ts, scores)):
+        if s > threshold:
+            consecutive += 1
+            if consecutive >= CONSECUTIVE_HITS:
+                last_active = t
+                present = True
+        else:
+            consecutive = 0
+        if present and last_active is not None and t - last_active > LEAVE_TIMEOUT_MS:
+            present = False
+        out[i] = present
+    return out
+
+
+def evaluate(ts, truth, decision):
+    """计算检测延迟与误关灯指标。"""
+    latencies = []
+    missed = 0
+    false_off = 0
+    present_total = 0
+    present_off = 0
+    absent_total = 0
+    absent_on = 0
+
+    # 按真值切分连续片段
+    seg_start = 0
+    for i in range(1, len(ts) + 1):
+        if i < len(ts) and truth[i] == truth[seg_start]:
+            continue
+        seg = slice(seg_start, i)
+        if truth[seg_start]:
+            dec = decision[seg]
+            present_total += len(dec)
+            # 片段开始时灯已是开的 (沿用上一段)，不计入检测延迟
+            if not dec[0]:
+                hit = np.argmax(dec) if dec.any() else -1
+                if hit < 0:
+                    missed += 1
+                else:
+                    latencies.append((ts[seg_start + hit] - ts[seg_start]) / 1000.0)
+            first_on = np.argmax(dec) if dec.any() else len(dec)
+            after = dec[first_on:]
+            present_off += int((~after).sum())
+            false_off += int(np.sum(after[:-1] & ~after[1:]))
+        else:
+            dec = decision[seg]
+            absent_total += len(dec)
+            absent_on += int(dec.sum())
+        seg_start = i
+
+    return {
+        '检测延迟均值(s)': np.mean(latencies) if latencies else np.nan,
+        '检测延迟最大(s)': np.max(latencies) if latencies else np.nan,
+        '漏检片段数': missed,
+        '误关灯次数': false_off,
+        '有人时段关灯占比(%)': 100.0 * present_off / present_total if present_total else np.nan,
+        '无人时段开灯占比(%)': 100.0 * absent_on / absent_total if absent_total else np.nan,
+    }
+
+
+def plot_eval(df, decisions, table, output_prefix):
+    t = (df['Timestamp_ms'] - df['Timestamp_ms'].iloc[0]) / 1000.0
+    names = list(decisions.keys())
+
+    fig = plt.figure(figsize=(12, 8))
+    gs = fig.add_gridspec(2, 1, height_ratios=[2, 1], hspace=0.35)
+
+    # --- 子图 1: 真值与各算法判定时序 ---
+    ax1 = fig.add_subplot(gs[0])
+    ax1.fill_between(t, -0.5, len(names) - 0.5, where=df['Present'], step='post',
+                     color='#2ecc71', alpha=0.15, label='真值: 有人')
+    for k, name in enumerate(names):
+        ax1.step(t, decisions[name] * 0.8 + k - 0.4, where='post', linewidth=1.5, label=name)
+    ax1.set_yticks(range(len(names)))
+    ax1.set_yticklabels(names)
+    ax1.set_xlabel('测试时间 (秒)')
+    ax1.set_title('各检测算法与融合判定的存在状态时序')
+    ax1.legend(loc='upper right', fontsize=8)
+    ax1.grid(True, linestyle=':', alpha=0.6)
+
+    # --- 子图 2: 检测延迟与误关灯对比 ---
+    ax2 = fig.add_subplot(gs[1])
+    x = np.arange(len(names))
+    ax2.bar(x - 0.2, table['检测延迟均值(s)'].fillna(0), width=0.4, color='#3498db', label='检测延迟均值 (s)')
+    ax2b = ax2.twinx()
+    ax2b.bar(x + 0.2, table['有人时段关灯占比(%)'].fillna(0), width=0.4, color='#e74c3c', label='有人时段关灯占比 (%)')
+    ax2.set_xticks(x)
+    ax2.set_xticklabels(names)
+    ax2.set_ylabel('延迟 (s)')
+    ax2b.set_ylabel('误关灯占比 (%)')
+    ax2.set_title('检测延迟与误关灯率对比')
+    h1, l1 = ax2.get_legend_handles_labels()
+    h2, l2 = ax2b.get_legend_handles_labels()
+    ax2.legend(h1 + h2, l1 + l2, loc='upper right', fontsize=8)
+
+    plt.savefig(f'{output_prefix}.pdf', bbox_inches='tight')
+    plt.savefig(f'{output_prefix}.png', bbox_inches='tight')
+    print(f"✅ 融合评估图表已生成: {output_prefix}.pdf")
+
+
+def parse_weights(text):
+    weights = {}
+    for item in text.split(','):
+        if '=' in item:
+            k, v = item.split('=', 1)
+            weights[k.strip()] = int(v)
+    return weights
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='CSI 多算法融合离线评估 (检测延迟 / 误关灯率)')
+    parser.add_argument('--input', default='data/csi_ensemble_annotated.txt', help='带 <标签> 标注的串口日志')
+    parser.add_argument('--absent-labels', default='无人,离开',
+                        help='表示"房间无人"的标签 (逗号分隔)，其余标签视为有人')
+    parser.add_argument('--weights', default='V1=1,V2=1,V3=2', help='离线重算融合得分的权重，与固件 s_detectors[] 一致')
+    args = parser.parse_args()
+
+    absent = {s.strip() for s in args.absent_labels.split(',') if s.strip()}
+    df, thresholds = parse_ensemble_log(args.input, absent)
+    if df is not None:
+        df = df.dropna().reset_index(drop=True)
+        df['Fused'] = fuse(df, thresholds, parse_weights(args.weights))
+
+        ts = df['Timestamp_ms'].to_numpy()
+        truth = df['Present'].to_numpy()
+        decisions = {}
+        for name, th in sorted(thresholds.items()):
+            decisions[name] = simulate_decision(ts, df[name].to_numpy(), th)
+        decisions['融合'] = simulate_decision(ts, df['Fused'].to_numpy(), FUSE_THRESHOLD)
+
+        table = pd.DataFrame({name: evaluate(ts, truth, dec) for name, dec in decisions.items()}).T
+        print("=" * 60)
+        print("📊 CSI 多算法融合评估:")
+        print(table.round(2))
+        print("=" * 60)
+        table.to_csv('data/parsed_csi_ensemble_eval.csv', encoding='utf-8-sig')
+
+        plot_eval(df, decisions, table, 'output/csi_ensemble_eval')
@@ -0,0 +1,119 @@
+import os
+import argparse
+import pandas as pd
+import matplotlib.pyplot as plt
+import numpy as np
+
+from plot_7_3_csi_ensemble_eval import (parse_ensemble_log, simulate_decision, evaluate,
+                                        LEAVE_TIMEOUT_MS, FUSE_THRESHOLD)
+
+# ==========================================
+# 1. 全局配置 (与固件 dev_csi.c 保持一致)
+# ==========================================
+PROBE_FAST_MS = 50              # CSI_PROBE_FAST_MS，同时是"改造前"的固定速率
+PROBE_STEADY_MS = 100           # CSI_PROBE_STEADY_MS
+PROBE_IDLE_MS = 200             # CSI_PROBE_IDLE_MS
+PROBE_HOLD_MS = 3000            # CSI_PROBE_HOLD_MS
+PROBE_STEADY_AFTER_MS = 10000   # CSI_PROBE_STEADY_AFTER_MS
+LEVEL_NAMES = {PROBE_FAST_MS: 'FAST', PROBE_STEADY_MS: 'STEADY', PROBE_IDLE_MS: 'IDLE'}
+
+
+def replay_scheduler(ts, fused, decision):
+    """在固定 50ms 的旧日志上回放探测速率调度，得到每个窗口"本应"使用的探测间隔。"""
+    out = np.full(len(ts), PROBE_FAST_MS)
+    fast_until = -1
+    present_since = last_active = None
+    prev_present = False
+    for i, (t, f, present) in enumerate(zip(ts, fused, decision)):
+        over = f > FUSE_THRESHOLD
+        if over:
+            fast_until = t + PROBE_HOLD_MS
+            if present:
+                last_active = t
+        if present and not prev_present:
+            present_since = last_active = t
+        prev_present = present
+        if not present:
+            out[i] = PROBE_FAST_MS if t < fast_until else PROBE_IDLE_MS
+        else:
+            steady = (t - present_since >= PROBE_STEADY_AFTER_MS and
+                      t - last_active < LEAVE_TIMEOUT_MS / 2)
+            out[i] = PROBE_STEADY_MS if steady else PROBE_FAST_MS
+    return out
+
+
+def probe_budget(ts, interval_ms, airtime_us):
+    """按窗口时长 / 探测间隔累计探测包数，并与固定 50ms 对比。"""
+    dt = np.diff(ts, append=ts[-1] + np.median(np.diff(ts)) if len(ts) > 1 else ts[-1] + 500)
+    hours = dt.sum() / 3600000.0
+    sent = float(np.sum(dt / interval_ms))
+    fixed = float(np.sum(dt / PROBE_FAST_MS))
+    share = {LEVEL_NAMES.get(k, str(k)): 100.0 * dt[interval_ms == k].sum() / dt.sum() for k in np.unique(interval_ms)}
+    return {
+        '探测包/小时': sent / hours,
+        '固定50ms 包/小时': fixed / hours,
+        '节省包/小时': (fixed - sent) / hours,
+        '节省比例(%)': 100.0 * (fixed - sent) / fixed if fixed else np.nan,
+        '节省空口时间(s/小时)': (fixed - sent) / hours * airtime_us / 1e6,
+    }, share
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='CSI 自适应探测速率回放 (探测包节省 / 检测延迟影响)')
+    parser.add_argument('--input', default='data/csi_ensemble_annotated.txt',
+                        help='带 <标签> 的 [雷达-ENS] 日志 (csiprobe1 自适应，或旧固件/固定速率日志)')
+    parser.add_argument('--baseline', default=None,
+                        help='可选: 同一场景下 csiprobe0 (固定 50ms) 录制的对照日志，用于比较检测延迟')
+    parser.add_argument('--absent-labels', default='无人,离开', help='表示"房间无人"的标签 (逗号分隔)')
+    parser.add_argument('--airtime-us', type=float, default=250.0,
+                        help='一次 Ping 请求+应答占用的空口时间 (us)，用于折算节省的空口时间')
+    args = parser.parse_args()
+
+    absent = {s.strip() for s in args.absent_labels.split(',') if s.strip()}
+    df, _ = parse_ensemble_log(args.input, absent)
+    if df is not None:
+        ts = df['Timestamp_ms'].to_numpy()
+        truth = df['Present'].to_numpy()
+        fused = df['Fused_dev'].to_numpy()
+        decision = simulate_decision(ts, fused, FUSE_THRESHOLD)
+
+        logged = df['Probe_ms'].to_numpy()
+        if np.all(logged == PROBE_FAST_MS):
+            print("ℹ️ 日志为固定 50ms 探测，按固件调度逻辑回放自适应探测间隔。")
+            interval = replay_scheduler(ts, fused, decision)
+        else:
+            interval = logged
+
+        budget, share = probe_budget(ts, interval, args.airtime_us)
+        rows = {'自适应探测': dict(budget, **evaluate(ts, truth, decision))}
+
+        if args.baseline:
+            bdf, _ = parse_ensemble_log(args.baseline, absent)
+            if bdf is not None:
+                bts = bdf['Timestamp_ms'].to_numpy()
+                bdec = simulate_decision(bts, bdf['Fused_dev'].to_numpy(), FUSE_THRESHOLD)
+                bbudget, _ = probe_budget(bts, bdf['Probe_ms'].to_numpy(), args.airtime_us)
+                rows['固定50ms (对照)'] = dict(bbudget, **evaluate(bts, bdf['Present'].to_numpy(), bdec))
+
+        table = pd.DataFrame(rows).T
+        print("=" * 60)
+        print("📊 CSI 自适应探测速率回放结果:")
+        print(table.round(2).T)
+        print("  各档位时间占比: " + ", ".join(f"{k} {v:.1f}%" for k, v in share.items()))
+        print("=" * 60)
+        table.to_csv('data/parsed_csi_probe_rate.csv', encoding='utf-8-sig')
+
+        t_s = (ts - ts[0]) / 1000.0
+        fig, ax1 = plt.subplots(figsize=(12, 4))
+        ax1.fill_between(t_s, 0, 1000.0 / PROBE_FAST_MS, where=truth, step='post',
+                         color='#2ecc71', alpha=0.15, label='真值: 有人')
+        ax1.step(t_s, 1000.0 / interval, where='post', color='#3498db', label='自适应探测速率')
+        ax1.axhline(1000.0 / PROBE_FAST_MS, color='#e74c3c', linestyle='--', label='原固定速率 (20 包/s)')
+        ax1.set_ylabel('探测速率 (包/s)')
+        ax1.set_xlabel('测试时间 (秒)')
+        ax1.set_title(f"自适应探测速率时序 (节省 {budget['节省比例(%)']:.1f}% 探测包)")
+        ax1.legend(loc='upper right', fontsize=8)
+        ax1.grid(True, linestyle=':', alpha=0.6)
+        plt.savefig('output/csi_probe_rate.pdf', bbox_inches='tight')
+        plt.savefig('output/csi_probe_rate.png', bbox_inches='tight')
+        print("✅ 探测速率图表已生成: output/csi_probe_rate.pdf")
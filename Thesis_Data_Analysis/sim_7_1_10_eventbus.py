@@ -0,0 +1,158 @@
+"""STM32 事件总线测试: 主机端编译固件 EventBus.c，检验无锁队列与分发逻辑，并做生产者 / 消费者双线程压力测试。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/eventbus_host.c 与固件 EventBus.c 编译成主机程序
+     (host/stub 提供 stm32f10x.h，__DMB 用完整内存栅栏代替)。
+  2. 固定用例: FIFO 顺序与 uint8_t 下标回绕、满时丢弃计数、历史最高占用、先中断队列后主循环队列的分发顺序、
+     处理函数中新投递的事件留到下一次、订阅范围检查、[EvtBus] 统计行。
+  3. 压力测试: 生产者线程 (模拟中断) 每 --produce-us 调用 EventBus_PostFromISR，消费者线程 (模拟主循环)
+     分别以 --dispatch-us 中的各个间隔调用 EventBus_Dispatch_Task，每档 --race-s 秒。
+检查项 (任一不满足退出码 1):
+  * 固定用例全部通过
+  * 每档压力测试: 分发顺序与序号一致 (无乱序 / 重复)、载荷与序号一致 (无半写槽位)、
+    投递成功 + 丢弃 = 尝试次数、收到 = 投递成功、队列 Dropped 与生产者看到的失败次数一致
+丢弃率与历史最高占用取决于主机线程调度 (单核主机上两个线程分时运行)，只作参考，不作判定。
+
+用法:
+    py sim_7_1_10_eventbus.py
+    py sim_7_1_10_eventbus.py --race-s 5 --produce-us 10 --dispatch-us 0 100 1000
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+STM32_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'eventbus_host.c'),
+    os.path.join(STM32_DIR, 'System', 'EventBus.c'),
+]
+# host/stub 放在最前，替换固件的 stm32f10x.h
+INCLUDES = [os.path.join(HOST_DIR, 'stub'), os.path.join(STM32_DIR, 'System'),
+            os.path.join(STM32_DIR, 'User'), os.path.join(STM32_DIR, 'Hardware', 'USART_DMA')]
+EXE_SUFFIX = '.exe' if sys.platform == 'win32' else ''
+
+RACE_COLS = ['dispatch_us', 'attempts', 'posted', 'dropped', 'queue_dropped', 'received',
+             'order_err', 'payload_err', 'high_water']
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 编译与运行主机测试程序
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in INCLUDES] + SOURCES + \
+        ['-lpthread', '-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def run_unit(exe):
+    proc = subprocess.run([exe, 'unit'], capture_output=True, text=True)
+    rows = [line.split(',', 3) for line in proc.stdout.splitlines()]
+    cases = [r for r in rows if r[0] == 'case']
+    print(f"\nEventBus.c 固定用例: {sum(r[2] == '1' for r in cases)}/{len(cases)} 通过")
+    for r in rows:
+        if r[0] == 'case':
+            print(f"  {'✅' if r[2] == '1' else '❌'} {r[1]}")
+        elif r[0] == 'fail':
+            print(f"     eventbus_host.c:{r[2]} {r[3]}")
+    return proc.returncode == 0 and len(cases) > 0
+
+
+def run_race(exe, seconds, produce_us, dispatch_us):
+    proc = subprocess.run([exe, 'race', str(seconds), str(produce_us), str(dispatch_us)],
+                          capture_output=True, text=True)
+    row = next((line.split(',')[1:] for line in proc.stdout.splitlines() if line.startswith('race,')), None)
+    if row is None:
+        return None, proc.returncode
+    return dict(zip(RACE_COLS, map(int, row))), proc.returncode
+
+
+# ==========================================
+# 3. 绘图
+# ==========================================
+def plot_race(df, output_pdf):
+    fig, ax1 = plt.subplots(figsize=(8, 4.5))
+    x = [str(v) for v in df['dispatch_us']]
+    ax1.bar(x, 100.0 * df['dropped'] / df['attempts'], color='tab:red', alpha=0.6, label='丢弃率')
+    ax1.set_xlabel('消费者分发间隔 (us)')
+    ax1.set_ylabel('丢弃率 (%)')
+    ax2 = ax1.twinx()
+    ax2.plot(x, df['high_water'], 'o-', color='tab:blue', label='历史最高占用')
+    ax2.set_ylabel('历史最高占用 (事件)')
+    ax2.set_ylim(0, df['high_water'].max() * 1.2 + 1)
+    lines = ax1.get_legend_handles_labels()[0] + ax2.get_legend_handles_labels()[0]
+    labels = ax1.get_legend_handles_labels()[1] + ax2.get_legend_handles_labels()[1]
+    ax1.legend(lines, labels, loc='upper left')
+    ax1.set_title('EventBus 中断队列: 分发间隔与丢弃 (主机双线程)')
+    ax1.grid(alpha=0.3, axis='y')
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    exe = os.path.join('output', 'eventbus_host' + EXE_SUFFIX)
+    build(exe)
+    fail = []
+    if not run_unit(exe):
+        fail.append('EventBus.c 固定用例失败')
+
+    rows = []
+    print(f"\n压力测试: 生产者每 {args.produce_us}us 投递一次，每档 {args.race_s}s")
+    for d in args.dispatch_us:
+        row, rc = run_race(exe, args.race_s, args.produce_us, d)
+        if row is None:
+            fail.append(f'分发间隔 {d}us 的压力测试异常退出 (退出码 {rc})')
+            continue
+        rows.append(row)
+        print(f"  分发间隔 {d:>5d}us: 尝试 {row['attempts']} | 投递 {row['posted']} | 丢弃 {row['dropped']} "
+              f"(队列计数 {row['queue_dropped']}) | 收到 {row['received']} | 乱序 {row['order_err']} | "
+              f"载荷错误 {row['payload_err']} | 最高占用 {row['high_water']}")
+        if rc != 0:
+            fail.append(f'分发间隔 {d}us: 计数核对失败或出现乱序 / 载荷错误')
+
+    if rows:
+        df = pd.DataFrame(rows, columns=RACE_COLS)
+        df.to_csv(args.csv, index=False)
+        print(f"✅ 已写入 {args.csv}")
+        if not args.no_plot:
+            plot_race(df, args.pdf)
+            print(f"✅ 图表已保存 {args.pdf}")
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('\n✅ 固定用例通过，压力测试无乱序 / 半写槽位，丢弃计数与投递结果一致')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='STM32 事件总线: 固定用例 + 生产者 / 消费者压力测试 (主机端)')
+    parser.add_argument('--race-s', type=int, default=2, help='每档压力测试时长 (s)')
+    parser.add_argument('--produce-us', type=int, default=20, help='生产者投递间隔 (us)')
+    parser.add_argument('--dispatch-us', type=int, nargs='+', default=[0, 50, 200, 1000],
+                        help='消费者分发间隔 (us)，每个值一档')
+    parser.add_argument('--csv', default='data/eventbus_race.csv')
+    parser.add_argument('--pdf', default='output/eventbus_race.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
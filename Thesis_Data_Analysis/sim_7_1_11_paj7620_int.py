@@ -0,0 +1,165 @@
+"""STM32 PAJ7620 手势驱动测试: 主机端编译固件 PAJ7620.c，用寄存器级传感器模型检验 INT 驱动的按需读取。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/paj7620_host.c 与固件 PAJ7620.c 编译成主机程序
+     (host/stub 提供 stm32f10x.h 中的 GPIO / EXTI / NVIC 声明，I2C_Lib_* 接到 PAJ7620 寄存器模型)。
+  2. 固定用例: 初始化读清残留标志、空闲时只有保底读、INT 下降沿触发读取与回调、漏沿靠电平补读、
+     WAVE (标志 2)、FORWARD 近距调光每周期读亮度并在低于阈值时退出、反向手势滤波、总线错误后重读、
+     阻塞全量读先处理在途的一轮、[PAJ] 统计行。
+  3. 负载仿真: gest 任务 10ms 周期运行 --seconds 秒，随机手势平均间隔 --gap-ms，FORWARD 后保持 1~4s 近距调光；
+     统计实际总线占用，并与 "每个周期都读手势标志 (近距时再读亮度)" 的轮询方式对比。
+检查项 (任一不满足退出码 1):
+  * 固定用例全部通过
+  * 负载仿真中每个手势都得到对应回调，且延迟不超过 --max-latency-ms
+  * 按需读取的总线占用低于每周期轮询
+
+用法:
+    py sim_7_1_11_paj7620_int.py
+    py sim_7_1_11_paj7620_int.py --seconds 300 --gap-ms 1000 --seed 7
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+STM32_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'paj7620_host.c'),
+    os.path.join(STM32_DIR, 'Hardware', 'Sensor', 'PAJ7620.c'),
+]
+# host/stub 放在最前，替换固件的 stm32f10x.h
+INCLUDES = [os.path.join(HOST_DIR, 'stub'), os.path.join(STM32_DIR, 'System'),
+            os.path.join(STM32_DIR, 'User'), os.path.join(STM32_DIR, 'Hardware', 'USART_DMA'),
+            os.path.join(STM32_DIR, 'Hardware', 'I2C_Driver'), os.path.join(STM32_DIR, 'Hardware', 'Sensor')]
+EXE_SUFFIX = '.exe' if sys.platform == 'win32' else ''
+
+LOAD_COLS = ['calls', 'prox_calls', 'gestures', 'hooks_ok', 'max_latency_ms', 'flag_reads', 'obj_reads',
+             'bus_us', 'flag_us', 'obj_us']
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 编译与运行主机测试程序
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in INCLUDES] + SOURCES + ['-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def run_unit(exe):
+    proc = subprocess.run([exe, 'unit'], capture_output=True, text=True)
+    rows = [line.split(',', 3) for line in proc.stdout.splitlines()]
+    cases = [r for r in rows if r[0] == 'case']
+    print(f"\nPAJ7620.c 固定用例: {sum(r[2] == '1' for r in cases)}/{len(cases)} 通过")
+    for r in rows:
+        if r[0] == 'case':
+            print(f"  {'✅' if r[2] == '1' else '❌'} {r[1]}")
+        elif r[0] == 'fail':
+            print(f"     paj7620_host.c:{r[2]} {r[3]}")
+    return proc.returncode == 0 and len(cases) > 0
+
+
+def run_load(exe, seconds, gap_ms, seed):
+    proc = subprocess.run([exe, 'load', str(seconds), str(gap_ms), str(seed)], capture_output=True, text=True)
+    row, paj = None, ''
+    for line in proc.stdout.splitlines():
+        if line.startswith('load,'):
+            row = dict(zip(LOAD_COLS, map(int, line.split(',')[1:])))
+        elif line.startswith('paj,'):
+            paj = line[4:]
+    return row, paj, proc.returncode
+
+
+def bus_percent(row, seconds):
+    """按需读取与每周期轮询的总线占用 (%)"""
+    on_demand = 100.0 * row['bus_us'] / (seconds * 1e6)
+    polling = 100.0 * (row['calls'] * row['flag_us'] + row['prox_calls'] * row['obj_us']) / (seconds * 1e6)
+    return on_demand, polling
+
+
+# ==========================================
+# 3. 绘图
+# ==========================================
+def plot_bus(on_demand, polling, output_pdf):
+    fig, ax = plt.subplots(figsize=(6, 4.5))
+    bars = ax.bar(['每周期轮询', 'INT 按需读取'], [polling, on_demand], color=['tab:gray', 'tab:green'], width=0.5)
+    for b in bars:
+        ax.text(b.get_x() + b.get_width() / 2, b.get_height(), f'{b.get_height():.2f}%', ha='center', va='bottom')
+    ax.set_ylabel('I2C 总线占用 (%)')
+    ax.set_title('PAJ7620 手势读取的总线占用 (主机仿真)')
+    ax.grid(alpha=0.3, axis='y')
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    exe = os.path.join('output', 'paj7620_host' + EXE_SUFFIX)
+    build(exe)
+    fail = []
+    if not run_unit(exe):
+        fail.append('PAJ7620.c 固定用例失败')
+
+    print(f"\n负载仿真: {args.seconds}s，手势平均间隔 {args.gap_ms}ms，种子 {args.seed}")
+    row, paj, rc = run_load(exe, args.seconds, args.gap_ms, args.seed)
+    if row is None:
+        fail.append(f'负载仿真异常退出 (退出码 {rc})')
+    else:
+        on_demand, polling = bus_percent(row, args.seconds)
+        print(f"  gest 调用 {row['calls']} 次 (近距调光 {row['prox_calls']}) | 手势 {row['gestures']}，"
+              f"正确回调 {row['hooks_ok']} | 最大延迟 {row['max_latency_ms']}ms")
+        print(f"  读手势标志 {row['flag_reads']} 次 | 读亮度 {row['obj_reads']} 次 | "
+              f"总线占用 {on_demand:.2f}% (每周期轮询 {polling:.2f}%)")
+        print(f"  {paj}")
+        if rc != 0 or row['hooks_ok'] != row['gestures']:
+            fail.append(f"{row['gestures'] - row['hooks_ok']} 个手势没有得到对应回调")
+        if row['max_latency_ms'] > args.max_latency_ms:
+            fail.append(f"手势回调延迟 {row['max_latency_ms']}ms 超过 {args.max_latency_ms}ms")
+        if on_demand >= polling:
+            fail.append('按需读取的总线占用没有低于每周期轮询')
+
+        df = pd.DataFrame([dict(row, seconds=args.seconds, bus_pct=round(on_demand, 3),
+                                polling_bus_pct=round(polling, 3))])
+        df.to_csv(args.csv, index=False)
+        print(f"✅ 已写入 {args.csv}")
+        if not args.no_plot:
+            plot_bus(on_demand, polling, args.pdf)
+            print(f"✅ 图表已保存 {args.pdf}")
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('\n✅ 固定用例通过，所有手势按时回调，按需读取的总线占用低于每周期轮询')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='STM32 PAJ7620 手势驱动: 固定用例 + 负载仿真 (主机端)')
+    parser.add_argument('--seconds', type=int, default=60, help='负载仿真时长 (s)')
+    parser.add_argument('--gap-ms', type=int, default=3000, help='随机手势的平均间隔 (ms)')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--max-latency-ms', type=int, default=30,
+                        help='手势到回调的最大允许延迟 (ms)，默认 3 个 gest 周期')
+    parser.add_argument('--csv', default='data/paj7620_load.csv')
+    parser.add_argument('--pdf', default='output/paj7620_bus.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
@@ -0,0 +1,540 @@
+"""STM32 主循环调度仿真: 旧 super-loop vs 协作式调度器 (Scheduler.c) 的编码器处理延迟。
+
+在主机上按微秒推进一个离散事件模型:
+  * 旧版: 逐字复刻 V13.1 main.c 的 while(1) (每轮 Protocol/编码器/按键/手势，
+    50/100/2000ms 分支里依次执行 Control/UI 整行刷新/心跳 + 阻塞式 DHT11)。
+  * 新版: 从固件 main.c 解析 SCHED_TASK 任务表，按 Scheduler.c 的规则
+    (到期任务中优先级最高者执行一步、分步恢复、周期对齐、丢弃错过的释放) 调度。
+两种模型使用同一条随机生成的旋钮操作序列，编码器延迟 = 旋钮转过一格 -> ControlManager 处理完成
+(新版经 EventBus: enc 任务投递事件，evt 分发任务调用处理函数)。
+
+另外用 $CC (默认 gcc) 把固件 Scheduler.c 与 host/scheduler_host.c 编译成主机程序 (SysTick / DWT / __WFI 用虚拟时钟替代):
+  * 固定用例: 优先级与表中顺序、分步恢复、周期对齐、丢弃错过的释放、超时计数、DWT / SysTick 回绕、
+    空闲 __WFI、[Sched] 统计任务的串口让步与清零。任一失败退出码 1。
+  * 用同一任务表 (各任务按下方耗时写成分步脚本，UI 取 6 个脏页全部刷新的最坏情况) 和同一条旋钮序列
+    驱动真实的 Scheduler.c，得到 "Scheduler.c (主机)" 一行延迟，并检查最坏延迟不超过
+    1 个节拍 + 低优先级任务的最长单步 + 编码器链路上各任务单步之和 (超出退出码 1)。
+
+各操作耗时为按 I2C / DHT11 时序估算的默认值 (旧版为软件 I2C + 忙等 DHT11，新版为硬件 I2C + DHT11 输入捕获)，
+可用 --cost 覆盖为实测值
+(实测值见串口 [Sched] 统计行的 max/avg 字段)。
+
+用法:
+    py sim_7_1_4_scheduler_latency.py
+    py sim_7_1_4_scheduler_latency.py --duration 300 --cost oled_page=60 --cost paj=40
+"""
+
+import argparse
+import os
+import re
+import shlex
+import subprocess
+import sys
+
+import numpy as np
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+STM32_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project')
+MAIN_C = os.path.join(STM32_DIR, 'User', 'main.c')
+CONFIG_H = os.path.join(STM32_DIR, 'User', 'Config.h')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+
+HOST_SOURCES = [
+    os.path.join(HOST_DIR, 'scheduler_host.c'),
+    os.path.join(STM32_DIR, 'System', 'Scheduler.c'),
+]
+# host/stub 放在最前，替换固件的 stm32f10x.h
+HOST_INCLUDES = [os.path.join(HOST_DIR, 'stub'), os.path.join(STM32_DIR, 'System'),
+                 os.path.join(STM32_DIR, 'User'), os.path.join(STM32_DIR, 'Hardware', 'USART_DMA')]
+EXE_SUFFIX = '.exe' if sys.platform == 'win32' else ''
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+TICK_US = 1000              # SysTick 1ms
+ENC_STEP = 15               # ENCODER_SW_MULTIPLIER
+SCHED_DONE, SCHED_NEXT_STEP = 0, 1
+
+# 默认耗时 (us)，72MHz + 软件 I2C (I2C_Delay ~1us) 估算
+DEFAULT_COST = {
+    'sched': 3,             # Scheduler_Run 选择任务 + DWT 计时开销
+    'loop': 2,              # 旧版每轮 tick 比较开销
+    'proto': 25,            # Protocol_Process 无数据时
+    'enc_poll': 4,          # Encoder_Get
+    'on_enc': 180,          # 编码器事件处理 (LightCtrl + 串口组帧)
+    'evt_post': 3,          # EventBus_Post
+    'evt_poll': 3,          # EventBus_Dispatch_Task 队列为空时
+    'key': 12,              # KeyManager_Tick + GetEvent
+    'paj_sw': 1100,         # 旧版 PAJ7620_ReadAllData: 软件 I2C 1 次写 + 7 次单字节读
+    'paj': 3,               # INT 触发: 无手势时只检查标志位与 INT 引脚电平，不访问 I2C
+    'ctrl': 40,             # Control_Task
+    'oled_char_sw': 2200,   # 旧版 OLED_ShowChar: 软件 I2C 22 次事务
+    'oled_page': 40,        # 帧缓冲: 提交一个脏页 (命令 + 数据两个事务，DMA 后台发送)
+    'oled_poll': 4,         # 帧缓冲: 上一页仍在传输，检查状态后让出
+    'oled_byte_us': 23,     # I2C1 400kHz 每字节总线时间 (9 位 + 间隙)
+    'ui_compose': 60,       # sprintf 排版
+    'hb': 120,              # Protocol_Report_Heartbeat
+    'ldr_sw': 50,           # 旧版 LDR_GetLuxPercentage: 8 次软件触发转换，忙等 EOC
+    'ldr': 2,               # ADC + DMA 后台采样，只读取滤波结果
+    'dht_start': 5,         # DHT11_Start
+    'dht_hold_ms': 20,      # DHT11_START_HOLD_MS
+    'dht_read': 4200,       # 旧版 DHT11_Read_Finish: 忙等接收应答 + 40 位
+    'dht_begin': 5,         # DHT11_Begin_Capture: 释放总线，打开 TIM2 输入捕获
+    'dht_frame_ms': 8,      # DHT11_FRAME_MS: 后台捕获一帧 (42 次捕获中断，每次约 1us)
+    'dht_decode': 30,       # DHT11_Get_Result: 按下降沿间隔解码 40 位
+    'env_report': 150,      # Protocol_Report_Env + 模型更新
+    'stats_line': 200,      # [Sched] 一行格式化
+}
+
+
+# ==========================================
+# 2. 被控对象: 旋钮操作序列与灯 / 屏幕状态
+# ==========================================
+def gen_encoder_events(duration_s, rng, gap_s=3.0):
+    """随机生成旋钮操作: 每隔 ~gap_s 秒转一次，每次 3~20 格，格间隔 15~80ms。"""
+    events = []
+    t = rng.uniform(0.2, 1.0) * 1e6
+    while t < duration_s * 1e6:
+        n = int(rng.integers(3, 21))
+        direction = 1 if rng.random() < 0.5 else -1
+        for _ in range(n):
+            events.append((int(t), direction))
+            t += rng.uniform(15e3, 80e3)
+        t += rng.exponential(gap_s) * 1e6
+    return [e for e in events if e[0] < duration_s * 1e6]
+
+
+class Lamp:
+    """复刻 UIManager 的页面排版，用于计算每次刷新实际变化的字符数。"""
+
+    def __init__(self, rng):
+        self.rng = rng
+        self.bri, self.cct = 500, 500
+        self.temp, self.humi, self.lux = 25.0, 45.0, 400.0
+
+    def on_encoder(self, diff):
+        self.bri = int(min(1000, max(0, self.bri + diff)))
+
+    def on_sensor(self):
+        self.lux = float(min(1000, max(0, self.lux + self.rng.integers(-30, 31))))
+        if self.rng.random() < 0.1:
+            self.humi += self.rng.choice([-1, 1])
+
+    def lines(self):
+        lux_percent = min(100, int(self.lux / 10.0))
+        return [
+            f"Bri: {self.bri:<4d}  [F]",
+            f"CCT: {self.cct:<4d}     ",
+            f"{self.temp:2.0f}C {self.humi:2.0f}% L:{lux_percent:3d}%",
+        ]
+
+
+def pad16(s):
+    return (s + ' ' * 16)[:16]
+
+
+# ==========================================
+# 3. 旧版 super-loop (V13.1 main.c)
+# ==========================================
+def simulate_legacy(events, duration_us, cost, rng):
+    lamp = Lamp(rng)
+    t, ei = 0, 0
+    tick_50 = tick_100 = tick_2000 = 0
+    last_lines = [None, None, None]
+    latencies, busy = [], 0
+
+    while t < duration_us:
+        now = t // TICK_US
+        t0 = t
+        t += cost['loop'] + cost['proto'] + cost['enc_poll']
+
+        # 编码器: Encoder_Get 在本轮开始时读出累积的格数
+        pending = []
+        while ei < len(events) and events[ei][0] <= t - cost['enc_poll']:
+            pending.append(events[ei])
+            ei += 1
+        if pending:
+            t += cost['on_enc']
+            lamp.on_encoder(sum(d for _, d in pending) * ENC_STEP)
+            latencies += [t - te for te, _ in pending]
+
+        t += cost['key'] + cost['paj_sw']
+
+        if now - tick_50 >= 50:
+            tick_50 = now
+            t += cost['ctrl']
+        if now - tick_100 >= 100:
+            tick_100 = now
+            # OLED_ShowString 整行重写变化的行
+            t += cost['ui_compose']
+            for i, line in enumerate(lamp.lines()):
+                if line != last_lines[i]:
+                    t += len(line) * cost['oled_char_sw']
+                    last_lines[i] = line
+        if now - tick_2000 >= 2000:
+            tick_2000 = now
+            t += cost['hb'] + cost['ldr_sw']
+            t += cost['dht_start'] + cost['dht_hold_ms'] * TICK_US + cost['dht_read'] + cost['env_report']
+            lamp.on_sensor()
+
+        busy += t - t0  # 旧版没有空闲: 一直在轮询
+
+    return np.array(latencies), busy, None
+
+
+# ==========================================
+# 4. 协作式调度器 (Scheduler.c + main.c 任务表)
+# ==========================================
+def parse_task_table(main_c=MAIN_C, config_h=CONFIG_H):
+    with open(config_h, encoding='utf-8') as f:
+        macros = dict(re.findall(r'#define\s+(\w+)\s+(\d+)', f.read()))
+    with open(main_c, encoding='utf-8') as f:
+        src = f.read()
+    pat = re.compile(r'SCHED_TASK\(\s*"(\w+)"\s*,\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*\)')
+
+    def val(x):
+        return int(macros[x]) if x in macros else int(x)
+
+    tasks = []
+    for name, func, period, deadline, prio in pat.findall(src):
+        tasks.append({'name': name, 'func': func, 'period': val(period),
+                      'deadline': val(deadline) or val(period), 'prio': val(prio)})
+    if not tasks:
+        raise SystemExit(f"❌ 未在 {main_c} 中找到 SCHED_TASK 任务表")
+    return tasks
+
+
+class SchedModel:
+    """各任务入口的单步行为 (耗时, 返回值)，与固件中对应函数的分步方式一致。"""
+
+    def __init__(self, tasks, events, cost, rng):
+        self.cost, self.events, self.ei = cost, events, 0
+        self.lamp = Lamp(rng)
+        self.latencies = []
+        self.evt_queue = []     # EventBus 中待分发的编码器事件 (转动时刻, 方向)
+        self.ui_text = [pad16(s) for s in self.lamp.lines()]
+        self.ui_shown = [' ' * 16] * 3
+        self.ui_page_left = [2] * 3
+        self.ui_bus_until = 0
+        self.ui_pending = False
+        self.sensor_step = 0
+        self.stats_idx = 0
+        self.n_tasks = len(tasks)
+
+    def step(self, name, t):
+        c = self.cost
+        if name == 'enc':
+            pending = []
+            while self.ei < len(self.events) and self.events[self.ei][0] <= t:
+                pending.append(self.events[self.ei])
+                self.ei += 1
+            dur = c['enc_poll']
+            if pending:
+                dur += c['evt_post']
+                self.evt_queue.append(pending)
+            return dur, SCHED_DONE
+        if name == 'evt':
+            dur = c['evt_poll']
+            for pending in self.evt_queue:
+                dur += c['on_enc']
+                self.lamp.on_encoder(sum(d for _, d in pending) * ENC_STEP)
+                self.latencies += [t + dur - te for te, _ in pending]
+            self.evt_queue = []
+            return dur, SCHED_DONE
+        if name == 'key':
+            return c['key'], SCHED_DONE
+        if name == 'proto':
+            return c['proto'], SCHED_DONE
+        if name == 'gest':
+            return c['paj'], SCHED_DONE
+        if name == 'ctrl':
+            return c['ctrl'], SCHED_DONE
+        if name == 'hb':
+            return c['hb'], SCHED_DONE
+        if name == 'ui':
+            dur = 0
+            if not self.ui_pending:
+                dur += c['ui_compose']
+                self.ui_text = [pad16(s) for s in self.lamp.lines()]
+                self.ui_pending = True
+            # 帧缓冲 (OLED_Flush_Step): 上一页还在 DMA 传输时只检查状态，否则提交下一个脏页
+            if t < self.ui_bus_until:
+                return dur + c['oled_poll'], SCHED_NEXT_STEP
+            for i in range(3):
+                diff = [j for j in range(16) if self.ui_text[i][j] != self.ui_shown[i][j]]
+                if diff:
+                    # 一行文字 = 2 页，每页发送 [最左, 最右] 变化字符覆盖的列
+                    cols = (diff[-1] - diff[0] + 1) * 8
+                    self.ui_page_left[i] -= 1
+                    if self.ui_page_left[i] == 0:
+                        self.ui_shown[i] = self.ui_text[i]
+                        self.ui_page_left[i] = 2
+                    self.ui_bus_until = t + dur + c['oled_page'] + (5 + cols + 2) * c['oled_byte_us']
+                    return dur + c['oled_page'], SCHED_NEXT_STEP
+            self.ui_pending = False
+            return dur, SCHED_DONE
+        if name == 'sensor':
+            if self.sensor_step == 0:
+                self.sensor_step = 1
+                return c['ldr'] + c['dht_start'], c['dht_hold_ms']
+            if self.sensor_step == 1:
+                self.sensor_step = 2
+                return c['dht_begin'], c['dht_frame_ms']
+            self.sensor_step = 0
+            self.lamp.on_sensor()
+            return c['dht_decode'] + c['env_report'], SCHED_DONE
+        if name in ('evstat', 'paj'):
+            return c['stats_line'], SCHED_DONE
+        if name == 'i2c':
+            return 2 * c['stats_line'], SCHED_DONE  # 每条总线一行
+        if name == 'stats':
+            self.stats_idx += 1
+            if self.stats_idx <= self.n_tasks:
+                return c['stats_line'], SCHED_NEXT_STEP
+            self.stats_idx = 0
+            return c['stats_line'], SCHED_DONE
+        return 10, SCHED_DONE  # 未建模的新任务: 视为轻量任务
+
+
+def simulate_scheduler(tasks, events, duration_us, cost, rng):
+    model = SchedModel(tasks, events, cost, rng)
+    for tk in tasks:
+        tk.update(active=False, release=0, next_run=0, runs=0, step_max=0, resp_max=0, overruns=0, skips=0)
+    t, busy = 0, 0
+
+    while t < duration_us:
+        now = t // TICK_US
+        ready = [tk for tk in tasks if now - tk['next_run'] >= 0]
+        if not ready:
+            t = (now + 1) * TICK_US  # __WFI 休眠到下一个 SysTick
+            continue
+        sel = min(ready, key=lambda tk: tk['prio'])  # min 保持表中顺序，与固件的 "<" 比较一致
+        if not sel['active']:
+            sel['active'] = True
+            sel['release'] = sel['next_run']
+
+        t0 = t
+        t += cost['sched']
+        dur, ret = model.step(sel['name'], t)
+        t += dur
+        busy += t - t0
+        sel['step_max'] = max(sel['step_max'], dur)
+
+        now = t // TICK_US
+        if ret != SCHED_DONE:
+            sel['next_run'] = now + ret
+            continue
+        resp = now - sel['release']
+        sel['active'] = False
+        sel['runs'] += 1
+        sel['resp_max'] = max(sel['resp_max'], resp)
+        if resp > sel['deadline']:
+            sel['overruns'] += 1
+        nxt = sel['release'] + sel['period']
+        if now - nxt >= sel['period']:
+            missed = (now - nxt) // sel['period']
+            sel['skips'] += missed
+            nxt += missed * sel['period']
+        sel['next_run'] = nxt
+
+    return np.array(model.latencies), busy, tasks
+
+
+# ==========================================
+# 5. 主机编译的 Scheduler.c
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in HOST_INCLUDES] + HOST_SOURCES + ['-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def host_script(name, cost):
+    """SchedModel 中各任务的分步方式写成 "耗时:返回值" 脚本；UI 按 6 个脏页都要刷新的最坏情况。"""
+    c = cost
+    if name == 'enc':
+        return str(c['enc_poll'])
+    if name == 'evt':
+        return str(c['evt_poll'])
+    if name == 'ui':
+        steps = [f"{c['ui_compose'] + c['oled_page']}:{SCHED_NEXT_STEP}"]
+        steps += [f"{c['oled_poll']}:{SCHED_NEXT_STEP} {c['oled_page']}:{SCHED_NEXT_STEP}"] * 5
+        return ' '.join(steps + ['0'])
+    if name == 'sensor':
+        return (f"{c['ldr'] + c['dht_start']}:{c['dht_hold_ms']} {c['dht_begin']}:{c['dht_frame_ms']} "
+                f"{c['dht_decode'] + c['env_report']}")
+    if name == 'stats':
+        return ''   # 调用固件 Scheduler_Stats_Task
+    simple = {'key': c['key'], 'proto': c['proto'], 'gest': c['paj'], 'ctrl': c['ctrl'], 'hb': c['hb'],
+              'evstat': c['stats_line'], 'paj': c['stats_line'], 'i2c': 2 * c['stats_line']}
+    return str(simple.get(name, 10))
+
+
+def run_host(tasks, events, duration_s, cost, csv):
+    exe = os.path.join('output', 'scheduler_host' + EXE_SUFFIX)
+    build(exe)
+
+    unit = subprocess.run([exe, 'unit'], capture_output=True, text=True)
+    rows = [line.split(',', 3) for line in unit.stdout.splitlines()]
+    cases = [r for r in rows if r[0] == 'case']
+    print(f"\nScheduler.c 固定用例: {sum(r[2] == '1' for r in cases)}/{len(cases)} 通过")
+    for r in rows:
+        if r[0] == 'fail':
+            print(f"  ❌ {r[1]} (scheduler_host.c:{r[2]}) {r[3]}")
+
+    task_file = os.path.join('output', 'scheduler_tasks.txt')
+    event_file = os.path.join('output', 'scheduler_events.txt')
+    with open(task_file, 'w', encoding='utf-8') as f:
+        for k in ('sched', 'evt_post', 'on_enc', 'stats_line'):
+            f.write(f"param,{k},{cost[k]}\n")
+        for tk in tasks:
+            f.write(f"task,{tk['name']},{tk['period']},{tk['deadline']},{tk['prio']},"
+                    f"{host_script(tk['name'], cost)}\n")
+    with open(event_file, 'w', encoding='utf-8') as f:
+        f.writelines(f"{t}\n" for t, _ in events)
+
+    proc = subprocess.run([exe, 'latency', task_file, event_file, str(duration_s), csv],
+                          capture_output=True, text=True, check=True)
+    out = {'step': {}, 'sched': []}
+    for line in proc.stdout.splitlines():
+        key, rest = line.split(',', 1)
+        if key == 'step':
+            name, us = rest.split(',')
+            out['step'][name] = int(us)
+        elif key == 'sched':
+            out['sched'].append(rest)
+        else:
+            out[key] = [int(v) for v in rest.split(',')]
+    lat = pd.read_csv(csv)['latency_us'].to_numpy()
+    return unit.returncode == 0 and len(cases) > 0, lat, out
+
+
+def latency_bound_us(tasks, steps):
+    """enc 错过一次轮询最多再等 1 个节拍，期间可能正好开始一个低优先级任务的最长单步，
+    之后 enc 与同优先级 / 更高优先级的任务 (含 evt) 依次各执行一步。"""
+    evt_prio = next(tk['prio'] for tk in tasks if tk['name'] == 'evt')
+    hi = sum(steps[tk['name']] for tk in tasks if tk['prio'] <= evt_prio)
+    lo = max([steps[tk['name']] for tk in tasks if tk['prio'] > evt_prio] or [0])
+    return TICK_US + lo + hi
+
+
+# ==========================================
+# 6. 汇总与绘图
+# ==========================================
+def summarize(name, lat_us, busy_us, duration_us):
+    if len(lat_us) == 0:
+        return {'Model': name, 'Events': 0}
+    ms = lat_us / 1000.0
+    return {
+        'Model': name,
+        'Events': len(ms),
+        'P50_ms': round(float(np.percentile(ms, 50)), 2),
+        'P99_ms': round(float(np.percentile(ms, 99)), 2),
+        'Max_ms': round(float(ms.max()), 2),
+        'Over_10ms_pct': round(float((ms > 10).mean() * 100), 2),
+        'CPU_busy_pct': round(busy_us / duration_us * 100, 1),
+    }
+
+
+def plot_cdf(results, output_pdf):
+    plt.figure(figsize=(8, 4.5))
+    for name, lat in results:
+        ms = np.sort(lat / 1000.0)
+        if len(ms) == 0:
+            continue
+        plt.step(ms, np.arange(1, len(ms) + 1) / len(ms), where='post', label=f"{name} (max {ms[-1]:.1f} ms)")
+    plt.xscale('log')
+    plt.xlabel('编码器处理延迟 (ms)')
+    plt.ylabel('累计概率')
+    plt.title('STM32 主循环编码器延迟: super-loop vs 协作式调度器')
+    plt.grid(True, which='both', alpha=0.3)
+    plt.legend()
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+    plt.close()
+
+
+def main(args):
+    cost = dict(DEFAULT_COST)
+    for item in args.cost:
+        k, v = item.split('=')
+        if k not in cost:
+            raise SystemExit(f"❌ 未知的耗时项 {k}，可选: {', '.join(cost)}")
+        cost[k] = int(v)
+
+    duration_us = int(args.duration * 1e6)
+    events = gen_encoder_events(args.duration, np.random.default_rng(args.seed), args.gap)
+    tasks = parse_task_table(args.main)
+    print(f"仿真 {args.duration:.0f}s，旋钮 {len(events)} 格，任务表 {len(tasks)} 项 ({args.main})")
+
+    lat_old, busy_old, _ = simulate_legacy(events, duration_us, cost, np.random.default_rng(args.seed + 1))
+    lat_new, busy_new, tasks = simulate_scheduler(tasks, events, duration_us, cost, np.random.default_rng(args.seed + 1))
+    unit_ok, lat_host, host = run_host(tasks, events, args.duration, cost, args.host_csv)
+
+    df = pd.DataFrame([summarize('super-loop (V13.1)', lat_old, busy_old, duration_us),
+                       summarize('Scheduler', lat_new, busy_new, duration_us),
+                       summarize('Scheduler.c (主机)', lat_host, host['busy'][0], duration_us)])
+    print("\n编码器延迟 (旋钮转过一格 -> ControlManager 处理完成):")
+    print(df.to_string(index=False))
+
+    print("\n调度器任务统计 (对应串口 [Sched] 行):")
+    for tk in tasks:
+        print(f"  {tk['name']:<6s} prio={tk['prio']} period={tk['period']:>5d}ms runs={tk['runs']:>6d} "
+              f"max={tk['step_max']:>5d}us resp={tk['resp_max']}/{tk['deadline']}ms "
+              f"ovr={tk['overruns']} skip={tk['skips']}")
+    print("\n主机编译的 Scheduler.c 最后一轮串口输出:")
+    for line in host['sched']:
+        print(f"  {line}")
+
+    out = pd.DataFrame({'Model': ['super-loop'] * len(lat_old) + ['Scheduler'] * len(lat_new),
+                        'Latency_us': np.concatenate([lat_old, lat_new]).astype(int)})
+    out.to_csv(args.csv, index=False)
+    print(f"\n✅ 逐格延迟已写入 {args.csv} / {args.host_csv}")
+
+    if not args.no_plot:
+        plot_cdf([('super-loop', lat_old), ('Scheduler', lat_new), ('Scheduler.c (主机)', lat_host)], args.pdf)
+        print(f"✅ 图表已保存 {args.pdf}")
+
+    fail = []
+    if not unit_ok:
+        fail.append('Scheduler.c 固定用例失败')
+    events_total, handled = host['lat'][0], host['lat'][1]
+    if events_total - handled > 1:  # 仿真结束时最后一格可能尚未分发
+        fail.append(f'Scheduler.c 只处理了 {handled}/{events_total} 格')
+    bound = latency_bound_us(tasks, host['step'])
+    print(f"Scheduler.c 最坏延迟 {host['lat'][4] / 1000.0:.2f}ms，理论上限 {bound / 1000.0:.2f}ms")
+    if host['lat'][4] > bound:
+        fail.append(f"Scheduler.c 最坏延迟 {host['lat'][4] / 1000.0:.2f}ms 超过理论上限 {bound / 1000.0:.2f}ms")
+    if args.max_latency_ms is not None:
+        for name, lat in (('调度器模型', lat_new), ('Scheduler.c', lat_host)):
+            if len(lat) and lat.max() / 1000.0 > args.max_latency_ms:
+                fail.append(f"{name}最坏延迟 {lat.max() / 1000.0:.2f}ms 超过门限 {args.max_latency_ms}ms")
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    return 0
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='STM32 主循环调度仿真 (编码器最坏延迟)')
+    parser.add_argument('--duration', type=float, default=120.0, help='仿真时长 (s)')
+    parser.add_argument('--gap', type=float, default=3.0, help='两次旋钮操作的平均间隔 (s)')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--cost', action='append', default=[], help='覆盖耗时估计，如 oled_page=60 (us)')
+    parser.add_argument('--main', default=MAIN_C, help='读取 SCHED_TASK 任务表的 main.c')
+    parser.add_argument('--max-latency-ms', type=float, default=None, help='调度器最坏延迟门限，超出退出码 1')
+    parser.add_argument('--csv', default='data/sim_scheduler_latency.csv')
+    parser.add_argument('--host-csv', default='data/sim_scheduler_latency_host.csv', help='主机编译的 Scheduler.c 逐格延迟')
+    parser.add_argument('--pdf', default='output/scheduler_latency.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
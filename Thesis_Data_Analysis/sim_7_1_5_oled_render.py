@@ -0,0 +1,114 @@
+"""OLED 帧缓冲渲染测试: 主机端编译固件 OLED_FB.c + UIManager.c，逐次更新统计 I2C 字节数并导出画面。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/oled_fb_host.c 与固件源文件编译成主机程序
+     (host/stub 只提供 stm32f10x.h 的基本类型，OLED.c 的硬件部分由测试程序替换)。
+  2. 运行一组界面更新场景 (开机、旋钮调节、焦点切换、传感器刷新/故障)，每次更新后:
+     模拟 GDDRAM 必须与帧缓冲逐字节一致，否则退出码 1 (脏区跟踪漏刷)；
+     每帧导出为 output/oled_frames/frame_NNN.pbm。
+  3. 对比旧版逐字符刷新 (每个变化的 8x16 字符格 66 字节) 与帧缓冲按页刷新的字节数。
+
+用法:
+    py sim_7_1_5_oled_render.py
+    CC=clang py sim_7_1_5_oled_render.py --no-plot
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+STM32_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'oled_fb_host.c'),
+    os.path.join(STM32_DIR, 'Hardware', 'OLED', 'OLED_FB.c'),
+    os.path.join(STM32_DIR, 'App', 'UI', 'UIManager.c'),
+    os.path.join(STM32_DIR, 'App', 'SystemModel', 'SystemModel.c'),
+]
+INCLUDES = [
+    os.path.join(HOST_DIR, 'stub'),
+    os.path.join(STM32_DIR, 'Hardware', 'OLED'),
+    os.path.join(STM32_DIR, 'App', 'UI'),
+    os.path.join(STM32_DIR, 'App', 'SystemModel'),
+    os.path.join(STM32_DIR, 'System'),
+]
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 编译与运行主机测试程序
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O1', '-Wall', '-Wno-missing-braces']
+    cmd += [f'-I{d}' for d in INCLUDES] + SOURCES + ['-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def plot_bytes(df, output_pdf):
+    fig, ax = plt.subplots(figsize=(10, 4.5))
+    x = range(len(df))
+    ax.bar([i - 0.2 for i in x], df['legacy_bytes'], width=0.4, label='旧版逐字符刷新', color='#bbbbbb')
+    ax.bar([i + 0.2 for i in x], df['bytes'], width=0.4, label='帧缓冲按页刷新', color='#1f77b4')
+    ax.set_xticks(list(x))
+    ax.set_xticklabels(df['name'], rotation=45, ha='right')
+    ax.set_yscale('symlog', linthresh=100)
+    ax.set_ylabel('每次更新 I2C 字节数')
+    ax.set_title('OLED 界面更新的 I2C 传输量')
+    ax.grid(axis='y', alpha=0.3)
+    ax.legend()
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    os.makedirs(args.frames, exist_ok=True)
+    build(args.exe)
+    rc = subprocess.run([args.exe, args.frames, args.csv]).returncode
+
+    df = pd.read_csv(args.csv)
+    print("\n每次界面更新的 I2C 传输量 (bytes 含地址/控制字节):")
+    print(df.to_string(index=False))
+
+    upd = df[df['step'] > 0]
+    total_new, total_old = upd['bytes'].sum(), upd['legacy_bytes'].sum()
+    print(f"\n开机整屏: {df.loc[0, 'bytes']} B (旧版 {df.loc[0, 'legacy_bytes']} B)")
+    print(f"后续 {len(upd)} 次更新: 平均 {upd['bytes'].mean():.0f} B / 最大 {upd['bytes'].max()} B，"
+          f"旧版平均 {upd['legacy_bytes'].mean():.0f} B，合计减少 {100.0 * (1 - total_new / total_old):.1f}%")
+    print(f"✅ 逐次统计已写入 {args.csv}，画面已导出到 {args.frames}/")
+
+    if not args.no_plot:
+        plot_bytes(df, args.pdf)
+        print(f"✅ 图表已保存 {args.pdf}")
+
+    if rc != 0:
+        print("❌ 模拟 GDDRAM 与帧缓冲不一致 (见上方错误输出)")
+    return rc
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='OLED 帧缓冲渲染测试 (主机端)')
+    parser.add_argument('--exe', default=os.path.join('output', 'oled_fb_host' + ('.exe' if sys.platform == 'win32' else '')))
+    parser.add_argument('--frames', default=os.path.join('output', 'oled_frames'))
+    parser.add_argument('--csv', default='data/oled_flush_bytes.csv')
+    parser.add_argument('--pdf', default='output/oled_flush_bytes.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
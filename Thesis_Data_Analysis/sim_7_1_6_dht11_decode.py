@@ -0,0 +1,98 @@
+"""DHT11 输入捕获解码测试: 主机端编译固件 DHT11_Decode.c，用带抖动的合成捕获序列检验解码器。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/dht11_decode_host.c 与固件 DHT11_Decode.c 编译成主机程序。
+  2. 固定用例: 标准帧、16 位计数器回绕、多余的沿、无应答、帧截断、毛刺、漏沿、校验和错误。
+  3. 抖动扫描: 脉宽在手册范围内随机，每个捕获值再叠加 ±J us 抖动，统计解码成功率、
+     检出错误 (TIMING / CHECKSUM) 与错误数据被接受的帧数。
+固定用例失败，或抖动不超过 --jitter-ok 时有任何一帧未正确解码，退出码 1。
+
+用法:
+    py sim_7_1_6_dht11_decode.py
+    py sim_7_1_6_dht11_decode.py --frames 20000 --jitter-ok 6
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DHT11_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project', 'Hardware', 'DHT11')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'dht11_decode_host.c'),
+    os.path.join(DHT11_DIR, 'DHT11_Decode.c'),
+]
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 编译与运行主机测试程序
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O1', '-Wall', f'-I{DHT11_DIR}'] + SOURCES + ['-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def plot_rates(df, output_pdf):
+    fig, ax = plt.subplots(figsize=(8, 4.5))
+    pct = lambda col: 100.0 * df[col] / df['frames']
+    ax.plot(df['jitter_us'], pct('ok'), 'o-', label='正确解码')
+    ax.plot(df['jitter_us'], pct('timing'), 's--', label='检出: 位宽超限')
+    ax.plot(df['jitter_us'], pct('checksum'), '^--', label='检出: 校验和错误')
+    ax.plot(df['jitter_us'], pct('wrong_accepted'), 'x-', color='red', label='错误数据被接受')
+    ax.set_xlabel('每个捕获值的抖动幅度 ±J (us)')
+    ax.set_ylabel('帧比例 (%)')
+    ax.set_title('DHT11 下降沿间隔解码的抖动容限')
+    ax.grid(alpha=0.3)
+    ax.legend()
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    build(args.exe)
+    rc = subprocess.run([args.exe, args.csv, str(args.frames), str(args.jitter_ok)]).returncode
+
+    df = pd.read_csv(args.csv)
+    clean = df[df['ok'] == df['frames']]['jitter_us']
+    print(f"\n100% 正确解码的最大抖动: ±{clean.max()}us (门限 ±{args.jitter_ok}us)，"
+          f"全部档位错误数据被接受 {df['wrong_accepted'].sum()} 帧 / {df['frames'].sum()} 帧")
+    print(f"✅ 扫描结果已写入 {args.csv}")
+
+    if not args.no_plot:
+        plot_rates(df, args.pdf)
+        print(f"✅ 图表已保存 {args.pdf}")
+
+    if rc != 0:
+        print("❌ 解码测试失败 (见上方输出)")
+    return rc
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='DHT11 输入捕获解码测试 (主机端)')
+    parser.add_argument('--frames', type=int, default=5000, help='每个抖动档位的帧数')
+    parser.add_argument('--jitter-ok', type=int, default=8, help='此抖动 (us) 及以下必须全部正确解码')
+    parser.add_argument('--exe', default=os.path.join('output', 'dht11_decode_host' + ('.exe' if sys.platform == 'win32' else '')))
+    parser.add_argument('--csv', default='data/dht11_decode_jitter.csv')
+    parser.add_argument('--pdf', default='output/dht11_decode_jitter.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
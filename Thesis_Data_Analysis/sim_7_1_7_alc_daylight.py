@@ -0,0 +1,227 @@
+"""环境光补偿 (ALC) 闭环仿真: 主机端编译固件 ALC.c，配合桌面照度 + LDR 采样链模型整定 PI 参数，
+检查有无可见振荡，并统计相对固定亮度的节能比例。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/alc_host.c 与固件 App/Lighting/ALC.c 编译成主机程序
+     (Config.h 直接包含，LDR 块长度 / IIR 系数 / ALC_* 参数与固件一致)。
+  2. 稳定域扫描: 关闭限速 (max_step=1000)，扫描 Kp x Ki，灯效系数取 50% / 100% / 150%
+     (不同灯高、桌面反射率)，记录最坏情况的超调与多余的输出反转 (可见振荡)。
+  3. 限速扫描: 固定 Config.h 中的 Kp / Ki，扫描每周期最大步长，对比跟踪误差与调光速度。
+  4. 以 Config.h 参数跑 600s 日照场景，画出环境光 / 测量值 / 亮度曲线，统计节能比例。
+判据 (任一灯效系数不满足则退出码 1):
+  超调 <= 10 (1%)、多余反转 = 0、恒定段亮度峰峰值 < 10，
+  且 Config.h 的 Ki 不超过稳定域边界 (关闭限速时出现多余反转的最小 Ki) 的一半。
+
+用法:
+    py sim_7_1_7_alc_daylight.py
+    py sim_7_1_7_alc_daylight.py --no-plot
+"""
+
+import argparse
+import io
+import os
+import re
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+STM32_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+CONFIG_H = os.path.join(STM32_DIR, 'User', 'Config.h')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'alc_host.c'),
+    os.path.join(STM32_DIR, 'App', 'Lighting', 'ALC.c'),
+]
+INCLUDES = [
+    os.path.join(STM32_DIR, 'User'),
+    os.path.join(STM32_DIR, 'App', 'Lighting'),
+]
+
+COLUMNS = ['gain', 'kp', 'ki', 'step', 'db', 'overshoot', 'settle_s', 'iae', 'reversals',
+           'hold_pp', 'max_rate', 'energy_alc', 'energy_fixed', 'saved_pct']
+GAINS = [50, 100, 150]
+KP_GRID = [0, 128, 256, 512, 1024, 2048]
+KI_GRID = [64, 128, 256, 512, 1024, 2048, 4096, 8192]
+STEP_GRID = [2, 4, 6, 10, 20, 50, 1000]
+
+MAX_OVERSHOOT = 10
+VISIBLE_SWING = 10
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 编译与运行主机仿真程序
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in INCLUDES] + SOURCES + ['-lm', '-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def read_config():
+    """从 Config.h 读取 ALC_* 参数"""
+    with open(CONFIG_H, encoding='utf-8') as f:
+        text = f.read()
+    cfg = {}
+    for key in ['ALC_KP_Q8', 'ALC_KI_Q8', 'ALC_MAX_STEP', 'ALC_DEADBAND', 'ALC_PERIOD_MS', 'ALC_MIN_BRI']:
+        m = re.search(rf'#define\s+{key}\s+(\d+)', text)
+        if not m:
+            raise SystemExit(f'{key} not found in {CONFIG_H}')
+        cfg[key] = int(m.group(1))
+    return cfg
+
+
+def run(exe, gain, params=None, trace='-'):
+    args = [exe, trace, str(gain)] + ([str(p) for p in params] if params else [])
+    out = subprocess.run(args, check=True, capture_output=True, text=True).stdout
+    return pd.read_csv(io.StringIO(out), header=None, names=COLUMNS).iloc[0]
+
+
+def worst(rows):
+    """多个灯效系数下的最坏情况"""
+    df = pd.DataFrame(rows)
+    return pd.Series({
+        'overshoot': df['overshoot'].max(),
+        'reversals': df['reversals'].max(),
+        'hold_pp': df['hold_pp'].max(),
+        'iae': df['iae'].max(),
+        'max_rate': df['max_rate'].max(),
+    })
+
+
+# ==========================================
+# 3. 扫描与绘图
+# ==========================================
+def sweep_gains(exe, cfg):
+    rows = []
+    for kp in KP_GRID:
+        for ki in KI_GRID:
+            w = worst([run(exe, g, [kp, ki, 1000, cfg['ALC_DEADBAND']]) for g in GAINS])
+            rows.append({'kp': kp, 'ki': ki, **w.to_dict()})
+    return pd.DataFrame(rows)
+
+
+def sweep_steps(exe, cfg):
+    rows = []
+    for step in STEP_GRID:
+        w = worst([run(exe, g, [cfg['ALC_KP_Q8'], cfg['ALC_KI_Q8'], step, cfg['ALC_DEADBAND']]) for g in GAINS])
+        rows.append({'step': step, **w.to_dict()})
+    return pd.DataFrame(rows)
+
+
+def plot_stability(df, cfg, output_pdf):
+    fig, ax = plt.subplots(figsize=(8, 4.5))
+    for kp, grp in df.groupby('kp'):
+        ax.plot(grp['ki'], grp['reversals'], 'o-', label=f'Kp={kp / 256:g}')
+    ax.axvline(cfg['ALC_KI_Q8'], color='red', ls='--', label=f"Config Ki={cfg['ALC_KI_Q8'] / 256:g}")
+    ax.set_xscale('log', base=2)
+    ax.set_xlabel('Ki (Q8)')
+    ax.set_ylabel('多余的输出反转次数 (最坏情况)')
+    ax.set_title('ALC 稳定域 (关闭限速，灯效 50%~150%)')
+    ax.grid(alpha=0.3)
+    ax.legend(fontsize=9)
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def plot_traces(traces, output_pdf):
+    fig, axes = plt.subplots(3, 1, figsize=(10, 8), sharex=True)
+    for gain, df in traces.items():
+        axes[1].plot(df['t_s'], df['meas'], lw=1, label=f'测量值 (灯效 {gain}%)')
+        axes[2].plot(df['t_s'], df['bri'] / 10, lw=1, label=f'ALC 亮度 (灯效 {gain}%)')
+    ref = traces[100]
+    axes[0].plot(ref['t_s'], ref['ambient_lux'], color='orange', label='环境光')
+    axes[0].plot(ref['t_s'], ref['desk_lux'], color='k', lw=1, label='桌面照度 (灯效 100%)')
+    axes[0].set_ylabel('照度 (lx)')
+    axes[1].plot(ref['t_s'], ref['target'], 'r--', lw=1, label='目标 (灯效 100%)')
+    axes[1].set_ylabel('LDR 读数 (0~1000)')
+    axes[2].set_ylabel('亮度 (%)')
+    axes[2].set_xlabel('时间 (s)')
+    for ax in axes:
+        ax.grid(alpha=0.3)
+        ax.legend(fontsize=8, loc='upper right')
+    axes[0].set_title('日光补偿闭环: 600s 压缩日照场景 (含云遮与顶灯阶跃)')
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    build(args.exe)
+    cfg = read_config()
+    print(f"\nConfig.h: Kp={cfg['ALC_KP_Q8']}/256 Ki={cfg['ALC_KI_Q8']}/256 step={cfg['ALC_MAX_STEP']} "
+          f"deadband={cfg['ALC_DEADBAND']} period={cfg['ALC_PERIOD_MS']}ms min={cfg['ALC_MIN_BRI']}")
+
+    # --- 稳定域 ---
+    stab = sweep_gains(args.exe, cfg)
+    stab.to_csv('data/alc_stability.csv', index=False)
+    unstable = stab[(stab['reversals'] > 0) | (stab['overshoot'] > MAX_OVERSHOOT)]
+    ki_limit = unstable[unstable['kp'] == cfg['ALC_KP_Q8']]['ki'].min() if not unstable.empty else None
+    print("\n[稳定域] 关闭限速，最坏情况下多余的输出反转次数:")
+    print(stab.pivot(index='kp', columns='ki', values='reversals').to_string())
+    print(f"Kp={cfg['ALC_KP_Q8']} 时出现超调或多余反转的最小 Ki: {ki_limit}")
+
+    # --- 限速 ---
+    steps = sweep_steps(args.exe, cfg)
+    steps.to_csv('data/alc_step_sweep.csv', index=False)
+    print("\n[限速] Config 增益下不同每周期步长 (最坏情况):")
+    print(steps.to_string(index=False))
+
+    # --- Config 参数的日照场景 ---
+    traces, results = {}, []
+    for g in GAINS:
+        path = f'data/alc_trace_g{g}.csv'
+        results.append(run(args.exe, g, trace=path))
+        traces[g] = pd.read_csv(path)
+    res = pd.DataFrame(results)
+    res.to_csv('data/alc_result.csv', index=False)
+
+    print("\n[日照场景] Config.h 参数:")
+    print(res[['gain', 'overshoot', 'settle_s', 'reversals', 'hold_pp', 'max_rate', 'saved_pct']].to_string(index=False))
+    print(f"相对固定亮度节能: {res['saved_pct'].min():.1f}% ~ {res['saved_pct'].max():.1f}% "
+          f"(亮度积分近似 PWM 功耗，固定亮度 = 夜间达到同一目标所需亮度)")
+
+    fail = []
+    if (res['overshoot'] > MAX_OVERSHOOT).any():
+        fail.append(f'超调超过 {MAX_OVERSHOOT}')
+    if (res['reversals'] > 0).any():
+        fail.append('出现多余的输出反转 (可见振荡)')
+    if (res['hold_pp'] >= VISIBLE_SWING).any():
+        fail.append(f'恒定段亮度峰峰值 >= {VISIBLE_SWING}')
+    if ki_limit is not None and cfg['ALC_KI_Q8'] * 2 > ki_limit:
+        fail.append(f"Ki={cfg['ALC_KI_Q8']} 稳定裕度不足 2 倍 (边界 {ki_limit})")
+
+    if not args.no_plot:
+        plot_stability(stab, cfg, args.pdf_stability)
+        plot_traces(traces, args.pdf_trace)
+        print(f"✅ 图表已保存 {args.pdf_stability}, {args.pdf_trace}")
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('✅ 无可见振荡，稳定裕度满足要求')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='环境光补偿闭环仿真 (主机端)')
+    parser.add_argument('--exe', default=os.path.join('output', 'alc_host' + ('.exe' if sys.platform == 'win32' else '')))
+    parser.add_argument('--pdf-stability', default='output/alc_stability.pdf')
+    parser.add_argument('--pdf-trace', default='output/alc_daylight.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
@@ -0,0 +1,217 @@
+"""LED 感知亮度查找表生成与混光测试: 生成固件 Hardware/LED/LED_CIE_LUT.c (CIE 1931 明度 -> 线性亮度)，
+再在主机端编译 LED_Mix.c，检查亮度单调、恒光通量色温混光和时间抖动序列，并与旧版线性映射对比。
+
+流程:
+  1. 按 CIE 1931 公式生成 257 点 Q16 查找表，与固件中已提交的 LED_CIE_LUT.c 比对；
+     不一致时退出码 1 (--write 时改为重新写入该文件)。
+  2. 用 $CC (默认 gcc) 把 host/led_mix_host.c 与固件 LED_Mix.c、LED_CIE_LUT.c 编译成主机程序。
+  3. 以 Config.h 的 LED_WARM_FLUX / LED_COLD_FLUX 及几组不对称光通量运行，检查:
+     每档亮度都有变化 (flat = 0)、总光通量随亮度单调 (mono = 0)、
+     同一亮度下各色温总光通量偏差 < 0.01 L* (相邻亮度档的 1/10)、抖动序列平均值精确 (dither_err = 0)。
+  4. 画出新旧映射的 L* 曲线与相邻档 L* 步长。
+
+用法:
+    py sim_7_1_8_led_cie_lut.py
+    py sim_7_1_8_led_cie_lut.py --write      # 重新生成固件查找表
+    py sim_7_1_8_led_cie_lut.py --no-plot
+"""
+
+import argparse
+import io
+import os
+import re
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+STM32_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+LED_DIR = os.path.join(STM32_DIR, 'Hardware', 'LED')
+CONFIG_H = os.path.join(STM32_DIR, 'User', 'Config.h')
+LUT_C = os.path.join(LED_DIR, 'LED_CIE_LUT.c')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'led_mix_host.c'),
+    os.path.join(LED_DIR, 'LED_Mix.c'),
+    LUT_C,
+]
+INCLUDES = [LED_DIR]
+
+LUT_SIZE = 257
+COLUMNS = ['warm_flux', 'cold_flux', 'flat', 'mono', 'lumen_err', 'dither_err',
+           'dL_new_max', 'dL_new_min', 'dL_old_max', 'dL_old_min']
+EXTRA_FLUX = [(100, 130), (130, 100), (60, 100)]
+MAX_LUMEN_ERR = 0.01    # CIE L*
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 查找表生成
+# ==========================================
+def cie1931_y(lstar):
+    """CIE 1931 明度 L* (0~100) -> 相对亮度 Y (0~1)"""
+    if lstar > 8:
+        return ((lstar + 16) / 116) ** 3
+    return lstar / 903.3
+
+
+def make_lut():
+    return [round(cie1931_y(100 * i / (LUT_SIZE - 1)) * 65535) for i in range(LUT_SIZE)]
+
+
+def render_lut(lut):
+    rows = []
+    for i in range(0, LUT_SIZE, 8):
+        rows.append('    ' + ' '.join(f'{v:5d},' for v in lut[i:i + 8]))
+    return (
+        '/**\n'
+        '  ******************************************************************************\n'
+        '  * @file    LED_CIE_LUT.c\n'
+        '  * @brief   CIE 1931 明度 -> 线性亮度查找表 (Q16)\n'
+        '  * @note    LED_CIE_LUT[i] = Y(L* = 100 * i / 256) * 65535\n'
+        '  *          Y = ((L* + 16) / 116)^3 (L* > 8)，Y = L* / 903.3 (L* <= 8)\n'
+        '  *          由 Thesis_Data_Analysis/sim_7_1_8_led_cie_lut.py --write 生成，请勿手工修改。\n'
+        '  ******************************************************************************\n'
+        '  */\n'
+        '#include "LED_Mix.h"\n'
+        '\n'
+        'const uint16_t LED_CIE_LUT[LED_LUT_SIZE] =\n'
+        '{\n'
+        + '\n'.join(rows) + '\n'
+        '};\n'
+    )
+
+
+def check_lut(args):
+    lut = make_lut()
+    if any(b <= a for a, b in zip(lut, lut[1:])):
+        raise SystemExit('LUT 不是严格递增')
+    text = render_lut(lut)
+    if args.write:
+        with open(LUT_C, 'w', encoding='utf-8', newline='\n') as f:
+            f.write(text)
+        print(f'✅ 已生成 {LUT_C}')
+        return True
+    try:
+        with open(LUT_C, encoding='utf-8') as f:
+            same = f.read() == text
+    except FileNotFoundError:
+        same = False
+    print(('✅' if same else '❌') + f' 固件查找表 {"与生成结果一致" if same else "缺失或过期，请加 --write 重新生成"}')
+    return same
+
+
+# ==========================================
+# 3. 编译与运行主机测试程序
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in INCLUDES] + SOURCES + ['-lm', '-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def read_flux():
+    with open(CONFIG_H, encoding='utf-8') as f:
+        text = f.read()
+    flux = []
+    for key in ['LED_WARM_FLUX', 'LED_COLD_FLUX']:
+        m = re.search(rf'#define\s+{key}\s+(\d+)', text)
+        if not m:
+            raise SystemExit(f'{key} not found in {CONFIG_H}')
+        flux.append(int(m.group(1)))
+    return tuple(flux)
+
+
+def run(exe, flux, trace='-'):
+    out = subprocess.run([exe, trace, str(flux[0]), str(flux[1])], check=True, capture_output=True, text=True).stdout
+    return pd.read_csv(io.StringIO(out), header=None, names=COLUMNS).iloc[0]
+
+
+# ==========================================
+# 4. 绘图
+# ==========================================
+def plot_mapping(df, output_pdf):
+    fig, axes = plt.subplots(1, 2, figsize=(11, 4.5))
+    pct = df['bri'] / 10
+    axes[0].plot(pct, df['L_old'], label='旧: 占空比 = 亮度 (线性)')
+    axes[0].plot(pct, df['L_new'], label='新: CIE 1931 查找表')
+    axes[0].set_xlabel('亮度设定 (%)')
+    axes[0].set_ylabel('感知明度 L*')
+    axes[0].set_title('亮度设定 -> 感知明度')
+
+    axes[1].plot(pct[1:], df['L_old'].diff()[1:], label='旧: 线性')
+    axes[1].plot(pct[1:], df['L_new'].diff()[1:], label='新: 查找表 + 抖动')
+    axes[1].set_yscale('log')
+    axes[1].set_xlabel('亮度设定 (%)')
+    axes[1].set_ylabel('相邻档 ΔL*')
+    axes[1].set_title('每档感知步长 (越平越均匀)')
+    for ax in axes:
+        ax.grid(alpha=0.3)
+        ax.legend(fontsize=9)
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    lut_ok = check_lut(args)
+
+    build(args.exe)
+    flux = read_flux()
+    print(f'\nConfig.h: LED_WARM_FLUX={flux[0]} LED_COLD_FLUX={flux[1]}')
+
+    trace = 'data/led_mix_trace.csv'
+    rows = [run(args.exe, flux, trace)] + [run(args.exe, f) for f in EXTRA_FLUX]
+    res = pd.DataFrame(rows)
+    res.to_csv('data/led_mix_result.csv', index=False)
+    print(res.to_string(index=False))
+
+    r = res.iloc[0]
+    print(f"\n相邻档 ΔL*: 旧版线性 {r['dL_old_min']:.3f} ~ {r['dL_old_max']:.3f} "
+          f"(最大/最小 {r['dL_old_max'] / r['dL_old_min']:.0f} 倍)，"
+          f"新版 {r['dL_new_min']:.3f} ~ {r['dL_new_max']:.3f}")
+
+    fail = []
+    if not lut_ok:
+        fail.append('固件查找表过期')
+    if (res['flat'] > 0).any():
+        fail.append('存在无变化的亮度档')
+    if (res['mono'] > 0).any():
+        fail.append('总光通量随亮度不单调')
+    if (res['lumen_err'] >= MAX_LUMEN_ERR).any():
+        fail.append(f'色温混光总光通量偏差 >= {MAX_LUMEN_ERR} L*')
+    if (res['dither_err'] > 0).any():
+        fail.append('抖动序列平均值不精确')
+
+    if not args.no_plot:
+        plot_mapping(pd.read_csv(trace), args.pdf)
+        print(f"✅ 图表已保存 {args.pdf}")
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('✅ 查找表单调，色温混光恒光通量，抖动序列精确')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='LED 感知亮度查找表生成与混光测试 (主机端)')
+    parser.add_argument('--exe', default=os.path.join('output', 'led_mix_host' + ('.exe' if sys.platform == 'win32' else '')))
+    parser.add_argument('--pdf', default='output/led_cie_mapping.pdf')
+    parser.add_argument('--write', action='store_true', help='重新生成固件 LED_CIE_LUT.c')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
@@ -0,0 +1,193 @@
+"""LED 渐变引擎测试: 在主机端编译固件 LED_Fade.c、LED_Mix.c，按 LED.c 的方式模拟 DMA 双半缓冲与半满 / 全满中断，
+检查单次渐变的时长、单调性和结束状态，并对比无极调光 / ESP32 滑块拖动时渐变与旧版立即跳变的感知亮度台阶。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/led_fade_host.c 与固件 LED_Fade.c、LED_Mix.c、LED_CIE_LUT.c 编译成主机程序。
+  2. 以 Config.h 的 FADE_PROX_MS 运行，检查:
+     所有场景结束后两半缓冲为终值且中断关闭 (final_ok = 1)、单次渐变暖 / 冷两路均单调 (mono = 0)、
+     到达终值的时刻不晚于设定时长 + 2 块 (14.6ms)、
+     连续目标 (prox / drag) 相邻块 ΔL* 小于立即跳变且 < 1 L*。
+  3. 把 host/control_fade_host.c 与固件 ControlManager.c、LightCtrl.c 等编译成第二个主机程序 (LED 驱动打桩)，
+     经 EventBus 投递近距调光事件，检查每个新目标都调用 LED_FadeTo、目标不变时不重复渐变、远程回显被跳过。
+  4. 画出阶跃渐变 (IN_OUT 400ms) 与连续目标的逐块 L* 轨迹。
+
+用法:
+    py sim_7_1_9_led_fade.py
+    py sim_7_1_9_led_fade.py --no-plot
+"""
+
+import argparse
+import io
+import os
+import re
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+STM32_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+LED_DIR = os.path.join(STM32_DIR, 'Hardware', 'LED')
+CONFIG_H = os.path.join(STM32_DIR, 'User', 'Config.h')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'led_fade_host.c'),
+    os.path.join(LED_DIR, 'LED_Fade.c'),
+    os.path.join(LED_DIR, 'LED_Mix.c'),
+    os.path.join(LED_DIR, 'LED_CIE_LUT.c'),
+]
+INCLUDES = [LED_DIR]
+
+# 业务层调用链: ControlManager / LightCtrl 真实源码，LED 驱动与协议打桩 (host/stub 放在最前)
+APP_DIR = os.path.join(STM32_DIR, 'App')
+CONTROL_SOURCES = [
+    os.path.join(HOST_DIR, 'control_fade_host.c'),
+    os.path.join(APP_DIR, 'Control', 'ControlManager.c'),
+    os.path.join(APP_DIR, 'Lighting', 'LightCtrl.c'),
+    os.path.join(APP_DIR, 'Lighting', 'ALC.c'),
+    os.path.join(APP_DIR, 'SystemModel', 'SystemModel.c'),
+    os.path.join(STM32_DIR, 'System', 'EventBus.c'),
+]
+CONTROL_INCLUDES = [os.path.join(HOST_DIR, 'stub')] + \
+    [os.path.join(APP_DIR, d) for d in ('Control', 'Lighting', 'Protocol', 'SystemModel')] + \
+    [os.path.join(STM32_DIR, d) for d in ('System', 'User')] + \
+    [os.path.join(STM32_DIR, 'Hardware', d) for d in ('LED', 'LDR', 'Key', 'Sensor', 'USART_DMA')]
+EXE_SUFFIX = '.exe' if sys.platform == 'win32' else ''
+
+COLUMNS = ['name', 'ease', 'ms', 'reach_ms', 'mono', 'final_ok', 'dL_new', 'dL_old', 'refills_per_s']
+EASE_NAMES = ['LINEAR', 'IN', 'OUT', 'IN_OUT']
+BLOCK_MS = 16 * 32768 / 72e3    # 一个块 (16 个 PWM 周期)
+REACH_TOL_MS = 2 * BLOCK_MS
+MAX_CHAIN_DL = 1.0              # CIE L*
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 编译与运行主机测试程序
+# ==========================================
+def build(exe, sources=SOURCES, includes=INCLUDES):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in includes] + sources + ['-lm', '-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def run_control(exe):
+    """ControlManager → LightCtrl → LED_FadeTo 调用链的固定用例"""
+    proc = subprocess.run([exe, 'unit'], capture_output=True, text=True)
+    rows = [line.split(',', 3) for line in proc.stdout.splitlines()]
+    cases = [r for r in rows if r[0] == 'case']
+    print(f"\nControlManager 调用链: {sum(r[2] == '1' for r in cases)}/{len(cases)} 通过")
+    for r in rows:
+        if r[0] == 'case':
+            print(f"  {'✅' if r[2] == '1' else '❌'} {r[1]}")
+        elif r[0] == 'fail':
+            print(f"     control_fade_host.c:{r[2]} {r[3]}")
+    return proc.returncode == 0 and len(cases) > 0
+
+
+def read_prox_ms():
+    with open(CONFIG_H, encoding='utf-8') as f:
+        m = re.search(r'#define\s+FADE_PROX_MS\s+(\d+)', f.read())
+    if not m:
+        raise SystemExit(f'FADE_PROX_MS not found in {CONFIG_H}')
+    return int(m.group(1))
+
+
+def run(exe, prox_ms, trace_dir):
+    out = subprocess.run([exe, trace_dir, str(prox_ms)], check=True, capture_output=True, text=True).stdout
+    return pd.read_csv(io.StringIO(out), header=None, names=COLUMNS)
+
+
+# ==========================================
+# 3. 绘图
+# ==========================================
+def plot_traces(output_pdf):
+    fig, axes = plt.subplots(1, 2, figsize=(11, 4.5))
+    for name, label in [('up', '0 → 100%'), ('down', '80% → 5%'), ('cct', '色温 0 → 100% (60%)')]:
+        df = pd.read_csv(f'data/led_fade_{name}.csv')
+        axes[0].step(df['t_ms'], df['L_new'], where='post', label=f'渐变 {label}')
+    axes[0].set_title('单次渐变 (IN_OUT 400ms)')
+
+    for name, label in [('prox', '无极调光'), ('drag', '滑块拖动')]:
+        df = pd.read_csv(f'data/led_fade_{name}.csv')
+        line = axes[1].step(df['t_ms'], df['L_new'], where='post', label=f'{label}: 渐变')
+        axes[1].step(df['t_ms'], df['L_old'], where='post', color=line[0].get_color(),
+                     alpha=0.4, linestyle='--', label=f'{label}: 立即跳变')
+    axes[1].set_xlim(0, 1500)
+    axes[1].set_title('每 50ms 一个新目标')
+
+    for ax in axes:
+        ax.set_xlabel('时间 (ms)')
+        ax.set_ylabel('块平均感知明度 L*')
+        ax.grid(alpha=0.3)
+        ax.legend(fontsize=9)
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    build(args.exe)
+    prox_ms = read_prox_ms()
+    print(f'\nConfig.h: FADE_PROX_MS={prox_ms}')
+
+    res = run(args.exe, prox_ms, 'data')
+    res.to_csv('data/led_fade_result.csv', index=False)
+
+    step = res[~res['name'].isin(['prox', 'drag'])].copy()
+    chain = res[res['name'].isin(['prox', 'drag'])]
+    step['ease'] = step['ease'].map(lambda e: EASE_NAMES[e])
+    step['late_ms'] = step['reach_ms'] - step['ms']
+    print(step.to_string(index=False))
+    print()
+    print(chain.to_string(index=False))
+
+    print(f"\n单次渐变到达终值: 比设定时长晚 {step['late_ms'].min():.1f} ~ {step['late_ms'].max():.1f} ms "
+          f"(允许 {REACH_TOL_MS:.1f} ms)，渐变期间中断 {res['refills_per_s'].max():.1f} 次/秒")
+    for _, r in chain.iterrows():
+        print(f"{r['name']}: 相邻块 ΔL* 最大 {r['dL_new']:.3f} (立即跳变 {r['dL_old']:.3f})")
+
+    fail = []
+    control_exe = os.path.join('output', 'control_fade_host' + EXE_SUFFIX)
+    build(control_exe, CONTROL_SOURCES, CONTROL_INCLUDES)
+    if not run_control(control_exe):
+        fail.append('ControlManager 调用链用例失败 (近距调光 / 回显跳过)')
+    if (res['final_ok'] != 1).any():
+        fail.append('渐变结束后缓冲不是终值或中断未关闭')
+    if (step['mono'] > 0).any():
+        fail.append('单次渐变不单调')
+    if (step['late_ms'] > REACH_TOL_MS).any():
+        fail.append(f'单次渐变晚于设定时长 {REACH_TOL_MS:.1f} ms 以上')
+    if (chain['dL_new'] >= chain['dL_old']).any() or (chain['dL_new'] >= MAX_CHAIN_DL).any():
+        fail.append(f'连续目标的相邻块 ΔL* 未小于立即跳变或 >= {MAX_CHAIN_DL} L*')
+
+    if not args.no_plot:
+        plot_traces(args.pdf)
+        print(f"✅ 图表已保存 {args.pdf}")
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('✅ 渐变按时到达且单调，结束后静止，连续目标无可见台阶')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='LED 渐变引擎测试 (主机端)')
+    parser.add_argument('--exe', default=os.path.join('output', 'led_fade_host' + EXE_SUFFIX))
+    parser.add_argument('--pdf', default='output/led_fade.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
@@ -0,0 +1,124 @@
+"""本地意图匹配测试: 在主机端编译 ESP32 固件的 svc_intent.c，用中文语料检查意图 / 槽位识别与执行动作，并统计匹配耗时。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/intent_host.c、固件 svc_intent.c 与 host/stub_esp32 桩编译成主机程序
+     (DataCenter 由测试程序替换)。
+  2. 逐条运行 data/intent_corpus.csv (text,intent,value)，每条重复 N 次取平均耗时；
+     并执行一组 Svc_Intent_Process 动作用例 (步进、下限、开关联动、定时到期关灯、取消定时)。
+     任一语料识别错误或动作结果不符时退出码 1。
+  3. 按意图类别汇总准确率与耗时，画出各类别的匹配耗时。
+
+注意: 耗时为主机 CPU 上的数值，只用于比较语法规则的相对开销；
+设备上的实际耗时见 ESP32 日志中的 "[TIMING] Intent" 行 (us)。
+
+用法:
+    py sim_7_2_2_intent_corpus.py
+    py sim_7_2_2_intent_corpus.py --repeat 1000 --no-plot
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+ESP32_DIR = os.path.join(SCRIPT_DIR, '..', 'ESP32_Firmware_Code', 'ESP32_Firmware', 'components')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+CORPUS = os.path.join(SCRIPT_DIR, 'data', 'intent_corpus.csv')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'intent_host.c'),
+    os.path.join(HOST_DIR, 'stub_esp32', 'esp_timer_host.c'),
+    os.path.join(ESP32_DIR, '3_Service', 'src', 'svc_intent.c'),
+]
+INCLUDES = [
+    os.path.join(HOST_DIR, 'stub_esp32'),
+    os.path.join(ESP32_DIR, '3_Service', 'include'),
+    os.path.join(ESP32_DIR, '1_DataRepo', 'include'),
+]
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 编译与运行主机测试程序
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in INCLUDES] + SOURCES + ['-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def plot_latency(df, output_pdf):
+    g = df.groupby('expect')['us'].agg(['mean', 'max']).sort_values('mean')
+    fig, ax = plt.subplots(figsize=(10, 4.5))
+    x = range(len(g))
+    ax.bar([i - 0.2 for i in x], g['mean'], width=0.4, label='平均')
+    ax.bar([i + 0.2 for i in x], g['max'], width=0.4, label='最大')
+    ax.set_xticks(list(x))
+    ax.set_xticklabels(g.index, rotation=45, ha='right')
+    ax.set_ylabel('匹配耗时 (us, 主机)')
+    ax.set_title('本地意图匹配耗时 (按期望意图分类)')
+    ax.grid(axis='y', alpha=0.3)
+    ax.legend()
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    build(args.exe)
+    proc = subprocess.run([args.exe, CORPUS, str(args.repeat)], capture_output=True, text=True)
+    with open(args.csv, 'w', encoding='utf-8') as f:
+        f.write(proc.stdout)
+    if proc.stderr:
+        print(proc.stderr.strip())
+
+    df = pd.read_csv(args.csv)
+    bad = df[df['ok'] != 1]
+    if len(bad):
+        print('\n识别错误的语料:')
+        print(bad.to_string(index=False))
+
+    summary = df.groupby('expect').agg(n=('ok', 'size'), correct=('ok', 'sum'), us_mean=('us', 'mean'), us_max=('us', 'max'))
+    print('\n按意图汇总:')
+    print(summary.to_string(float_format=lambda v: f'{v:.3f}'))
+
+    hits = df[df['expect'] != 'NONE']
+    print(f"\n语料 {len(df)} 条 (本地指令 {len(hits)} / 回落 LampMind {len(df) - len(hits)})，"
+          f"正确 {int(df['ok'].sum())} 条 ({100.0 * df['ok'].mean():.1f}%)")
+    print(f"匹配耗时 (主机，{args.repeat} 次平均): 平均 {df['us'].mean():.3f} us / 最大 {df['us'].max():.3f} us")
+    print(f"✅ 逐条结果已写入 {args.csv}")
+
+    if not args.no_plot:
+        plot_latency(df, args.pdf)
+        print(f"✅ 图表已保存 {args.pdf}")
+
+    if proc.returncode != 0:
+        print('❌ 语料识别或动作结果与期望不一致')
+        return 1
+    print('✅ 语料与动作用例全部通过')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='本地意图匹配语料测试 (主机端)')
+    parser.add_argument('--exe', default=os.path.join('output', 'intent_host' + ('.exe' if sys.platform == 'win32' else '')))
+    parser.add_argument('--repeat', type=int, default=200)
+    parser.add_argument('--csv', default='data/intent_result.csv')
+    parser.add_argument('--pdf', default='output/intent_latency.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
@@ -0,0 +1,297 @@
+"""MQTT 状态上报吞吐测试: 在主机端编译 ESP32 固件的 agent_mqtt.c / agent_mqtt_outbox.c，
+连接本机 mosquitto 模拟拖动滑块，测量实际发出的消息数 / 字节数，并检查订阅端还原出的状态。
+
+流程:
+  1. 启动 broker: 指定 --broker 时使用已有 broker，否则在空闲端口上启动 PATH 中的 mosquitto。
+  2. 用 $CC (默认 gcc) 把 host/mqtt_host.c、固件 agent_mqtt.c、agent_mqtt_outbox.c、cJSON.c
+     与 host/stub_esp32 桩 (FreeRTOS / NVS / esp-mqtt，esp-mqtt 桩是真正的 MQTT 3.1.1 客户端) 编译成主机程序。
+  3. paho 订阅 device/lamp/status 后运行 "mqtt_host sweep"，按 --rate 频率改变亮度 / 色温 --duration 秒。
+  4. 统计订阅端收到的 msgs/s、bytes/s，与"每次变化发一条全量"的旧做法对比；
+     把收到的快照 + 增量按顺序合并，结果必须等于设备端最终状态，
+     且消息速率不超过合并窗口 (app_config.h 的 MQTT_COALESCE_MS) 允许的上限，否则退出码 1。
+
+用法:
+    py sim_7_2_3_mqtt_throughput.py
+    py sim_7_2_3_mqtt_throughput.py --broker 192.168.10.150:1883 --duration 20 --rate 50
+"""
+
+import argparse
+import json
+import os
+import re
+import shlex
+import shutil
+import socket
+import subprocess
+import sys
+import threading
+import time
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+try:
+    import paho.mqtt.client as mqtt
+except ImportError as exc:  # pragma: no cover
+    raise SystemExit("缺少依赖库 paho-mqtt，请先执行：pip install paho-mqtt") from exc
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+ESP32_DIR = os.path.join(SCRIPT_DIR, '..', 'ESP32_Firmware_Code', 'ESP32_Firmware')
+COMP_DIR = os.path.join(ESP32_DIR, 'components')
+CJSON_DIR = os.path.join(SCRIPT_DIR, '..', '智能台灯stm32端', 'Project', 'ExternLibrary')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+STUB_DIR = os.path.join(HOST_DIR, 'stub_esp32')
+APP_CONFIG_H = os.path.join(ESP32_DIR, 'main', 'app_config.h')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'mqtt_host.c'),
+    os.path.join(STUB_DIR, 'esp_timer_host.c'),
+    os.path.join(STUB_DIR, 'freertos_host.c'),
+    os.path.join(STUB_DIR, 'nvs_host.c'),
+    os.path.join(STUB_DIR, 'mqtt_client_host.c'),
+    os.path.join(COMP_DIR, '3_Service', 'src', 'agents', 'agent_mqtt.c'),
+    os.path.join(COMP_DIR, '3_Service', 'src', 'agents', 'agent_mqtt_outbox.c'),
+    os.path.join(CJSON_DIR, 'cJSON.c'),
+]
+INCLUDES = [
+    STUB_DIR,
+    os.path.join(COMP_DIR, '3_Service', 'include'),
+    os.path.join(COMP_DIR, '1_DataRepo', 'include'),
+    os.path.join(ESP32_DIR, 'main'),
+    CJSON_DIR,
+]
+
+TOPIC_STATUS = 'device/lamp/status'
+STATE_KEYS = ['power', 'brightness', 'color_temp', 'temp', 'hum']
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. broker / 编译 / 订阅端 (sim_7_2_4 复用)
+# ==========================================
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in INCLUDES] + SOURCES + ['-lpthread', '-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def read_config(name):
+    with open(APP_CONFIG_H, encoding='utf-8') as f:
+        m = re.search(rf'#define\s+{name}\s+(\d+)', f.read())
+    if not m:
+        raise SystemExit(f'{name} not found in {APP_CONFIG_H}')
+    return int(m.group(1))
+
+
+def wait_port(host, port, timeout=5.0):
+    t0 = time.time()
+    while time.time() - t0 < timeout:
+        try:
+            socket.create_connection((host, port), timeout=0.5).close()
+            return True
+        except OSError:
+            time.sleep(0.05)
+    return False
+
+
+def free_port():
+    s = socket.socket()
+    s.bind(('127.0.0.1', 0))
+    port = s.getsockname()[1]
+    s.close()
+    return port
+
+
+class Broker:
+    """--broker 给定时只记录地址；否则在空闲端口启动本机 mosquitto，可 kill / restart (断网测试用)。"""
+
+    def __init__(self, spec):
+        self.proc = None
+        if spec:
+            host, _, port = spec.partition(':')
+            self.host, self.port, self.external = host, int(port or 1883), True
+        else:
+            if not shutil.which('mosquitto'):
+                raise SystemExit('未找到 mosquitto，请安装 (apt install mosquitto / choco install mosquitto) 或用 --broker 指定')
+            self.host, self.port, self.external = '127.0.0.1', free_port(), False
+            self.start()
+
+    def start(self):
+        if self.external:
+            return
+        self.proc = subprocess.Popen(['mosquitto', '-p', str(self.port)],
+                                     stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        if not wait_port(self.host, self.port):
+            raise SystemExit('mosquitto 启动失败')
+
+    def kill(self):
+        if self.proc:
+            self.proc.kill()
+            self.proc.wait()
+            self.proc = None
+
+    def env(self):
+        env = dict(os.environ)
+        env['HOST_MQTT_HOST'] = self.host
+        env['HOST_MQTT_PORT'] = str(self.port)
+        return env
+
+
+def make_client(client_id):
+    """兼容 paho-mqtt 1.x / 2.x 的客户端构造。"""
+    if hasattr(mqtt, 'CallbackAPIVersion'):
+        return mqtt.Client(mqtt.CallbackAPIVersion.VERSION1, client_id=client_id, protocol=mqtt.MQTTv311)
+    return mqtt.Client(client_id=client_id, protocol=mqtt.MQTTv311)
+
+
+class Recorder:
+    """订阅端: 记录收到的每条消息 (接收时刻、主题、长度、内容)。保留消息 (订阅前遗留的) 单独标记。"""
+
+    def __init__(self, broker, topics):
+        self.rows = []
+        self.lock = threading.Lock()
+        self.ready = threading.Event()
+        self.client = make_client(f'thesis_rec_{os.getpid()}')
+        self.client.on_connect = lambda c, u, f, rc: ([c.subscribe(t, qos=1) for t in topics], self.ready.set())
+        self.client.on_message = self._on_message
+        self.client.reconnect_delay_set(min_delay=0.1, max_delay=0.5)   # broker 重启后尽快重新订阅
+        self.client.connect(broker.host, broker.port, keepalive=30)
+        self.client.loop_start()
+        if not self.ready.wait(5):
+            raise SystemExit('订阅端连接 broker 失败')
+        time.sleep(0.2)
+
+    def _on_message(self, _c, _u, msg):
+        with self.lock:
+            self.rows.append({'t': time.time(), 'topic': msg.topic, 'bytes': len(msg.payload),
+                              'retain': int(msg.retain), 'payload': msg.payload.decode('utf-8', 'replace')})
+
+    def frame(self):
+        self.client.loop_stop()
+        self.client.disconnect()
+        with self.lock:
+            return pd.DataFrame(self.rows, columns=['t', 'topic', 'bytes', 'retain', 'payload'])
+
+
+def merge_status(df):
+    """按顺序合并快照与增量，返回还原出的状态。"""
+    state = {}
+    for p in df['payload']:
+        obj = json.loads(p)
+        state.update({k: obj[k] for k in STATE_KEYS if k in obj})
+    return state
+
+
+def parse_host_output(text):
+    out = {}
+    for line in text.splitlines():
+        key, *vals = line.split(',')
+        out[key] = [int(v) for v in vals]
+    return out
+
+
+# ==========================================
+# 3. 绘图
+# ==========================================
+def plot_rate(status, requests_per_s, full_len, output_pdf):
+    t = status['t'] - status['t'].iloc[0]
+    sec = t.astype(int)
+    per_s = status.groupby(sec)['bytes'].agg(['size', 'sum'])
+
+    fig, axes = plt.subplots(1, 2, figsize=(11, 4.5))
+    axes[0].bar(per_s.index, per_s['size'], label='实际 (合并增量)')
+    axes[0].axhline(requests_per_s, color='r', linestyle='--', label='每次变化发一条')
+    axes[0].set_ylabel('消息数 / 秒')
+    axes[1].bar(per_s.index, per_s['sum'], label='实际 (合并增量)')
+    axes[1].axhline(requests_per_s * full_len, color='r', linestyle='--', label='每次变化发一条全量')
+    axes[1].set_ylabel('payload 字节 / 秒')
+    for ax in axes:
+        ax.set_xlabel('时间 (s)')
+        ax.grid(axis='y', alpha=0.3)
+        ax.legend(fontsize=9)
+    fig.suptitle('拖动滑块时的状态上报流量')
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    coalesce_ms = read_config('MQTT_COALESCE_MS')
+    build(args.exe)
+    broker = Broker(args.broker)
+    try:
+        rec = Recorder(broker, [TOPIC_STATUS])
+        proc = subprocess.run([args.exe, 'sweep', str(args.duration), str(args.rate)],
+                              capture_output=True, text=True, env=broker.env(), timeout=args.duration + 30)
+        time.sleep(0.5)
+        df = rec.frame()
+    finally:
+        broker.kill()
+
+    if proc.returncode != 0:
+        print(proc.stderr.strip())
+        raise SystemExit(f'mqtt_host 退出码 {proc.returncode}')
+    host = parse_host_output(proc.stdout)
+    requests = host['sweep'][0]
+    final = dict(zip(STATE_KEYS, host['final']))
+    req, pubs, snaps, skipped, pub_bytes = host['stats']
+
+    status = df[(df['topic'] == TOPIC_STATUS) & (df['retain'] == 0)].reset_index(drop=True)
+    status.to_csv(args.csv, index=False)
+
+    dur = args.duration
+    full_len = status['bytes'].iloc[0]         # 连上后的第一条是全量快照
+    naive_bytes = requests * full_len
+    got = merge_status(status)
+    max_rate = 1000.0 / coalesce_ms
+
+    print(f'\napp_config.h: MQTT_COALESCE_MS={coalesce_ms}')
+    print(f'设备端: 请求 {req} 次，发出 {pubs} 条 (快照 {snaps}，跳过 {skipped})，payload {pub_bytes} B')
+    print(f'订阅端: 收到 {len(status)} 条 / {status["bytes"].sum()} B，'
+          f'{len(status) / dur:.1f} msgs/s，{status["bytes"].sum() / dur:.0f} B/s')
+    print(f'每次变化发一条全量: {args.rate} msgs/s，{naive_bytes / dur:.0f} B/s '
+          f'(消息数 -{100 * (1 - len(status) / requests):.1f}%，字节 -{100 * (1 - status["bytes"].sum() / naive_bytes):.1f}%)')
+    print(f'设备最终状态 {final}')
+    print(f'订阅端还原 {got}')
+    print(f'✅ 逐条消息已写入 {args.csv}')
+
+    if not args.no_plot:
+        plot_rate(status, args.rate, full_len, args.pdf)
+        print(f'✅ 图表已保存 {args.pdf}')
+
+    fail = []
+    if got != final:
+        fail.append('订阅端按增量还原的状态与设备最终状态不一致')
+    if len(status) != pubs:
+        fail.append(f'订阅端收到 {len(status)} 条，设备端发出 {pubs} 条')
+    # 每个合并窗口最多一条增量，外加开头的快照
+    if (len(status) - 1) / dur > max_rate * 1.1:
+        fail.append(f'消息速率超过合并窗口上限 {max_rate:.1f} msgs/s')
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('✅ 增量合并后状态一致，消息速率受合并窗口限制')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='MQTT 状态上报吞吐测试 (主机端 + mosquitto)')
+    parser.add_argument('--broker', default=None, help='host:port，缺省时启动本机 mosquitto')
+    parser.add_argument('--duration', type=int, default=10, help='拖动滑块的时长 (s)')
+    parser.add_argument('--rate', type=int, default=50, help='滑块变化频率 (Hz)')
+    parser.add_argument('--exe', default=os.path.join('output', 'mqtt_host' + ('.exe' if sys.platform == 'win32' else '')))
+    parser.add_argument('--csv', default='data/mqtt_throughput.csv')
+    parser.add_argument('--pdf', default='output/mqtt_throughput.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
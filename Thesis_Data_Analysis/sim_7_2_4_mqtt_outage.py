@@ -0,0 +1,204 @@
+"""MQTT 断网恢复测试: 在主机端运行固件 agent_mqtt.c / agent_mqtt_outbox.c，中途停止并重启本机 mosquitto，
+检查离线发件箱的回放顺序、NVS 溢出的写入量、状态还原与遗嘱消息。
+
+流程:
+  1. 编译与 sim_7_2_3_mqtt_throughput.py 相同的主机程序，在空闲端口启动 PATH 中的 mosquitto。
+  2. paho 订阅状态 / 事件 / availability 主题后运行 "mqtt_host outage"：
+     Agent_MQTT_Init 之前先发 3 条事件，连上后每 --event-ms 发一条带序号的事件并周期性改变亮度。
+  3. 第 --kill-at 秒停止 broker，--outage 秒后在同一端口重启；设备端按重连间隔
+     (HOST_MQTT_RECONNECT_MS，默认 2000ms，订阅端先于设备重连) 自动重连并回放发件箱。
+  4. 设备端打印统计后，强制结束设备进程 (不发 DISCONNECT)，broker 应代发遗嘱 offline。
+检查项 (任一不满足退出码 1):
+  * 事件序号 0 ~ N-1 全部收到 (含联网前的 3 条)，首次到达顺序严格递增 (新事件没有越过排队中的旧事件)
+  * 订阅端按顺序合并状态消息的结果等于设备最终状态
+  * 发件箱无丢弃、已清空，且本次断网确实触发了 NVS 溢出
+    (默认参数下离线约 6s 产生 ~75 条消息，超过 PSRAM 队列 MQTT_OUTBOX_CAPACITY=64、
+     不超过 PSRAM + NVS 的 96 条；更长的断网会按设计丢弃最旧的块)
+  * NVS 写入字节 / 溢出条数 不超过单条记录大小的 1.1 倍 (追加写，不重写已有数据)
+  * 重连后 availability 为 online，进程被结束后收到 offline 遗嘱
+
+用法:
+    py sim_7_2_4_mqtt_outage.py
+    py sim_7_2_4_mqtt_outage.py --kill-at 3 --outage 5 --event-ms 80
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+import time
+
+import matplotlib.pyplot as plt
+
+from sim_7_2_3_mqtt_throughput import (Broker, Recorder, build, merge_status, parse_host_output,
+                                       COMP_DIR, TOPIC_STATUS, STATE_KEYS)
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+OUTBOX_H = os.path.join(COMP_DIR, '3_Service', 'include', 'agents', 'agent_mqtt_outbox.h')
+TOPIC_EVENT = 'device/lamp/event'
+TOPIC_AVAIL = 'device/lamp/esp32_001/availability'
+MAX_NVS_OVERHEAD = 1.1
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+
+def spill_record_size():
+    """NVS 中每条记录的大小 = 4 字节头 + MQTT_OUTBOX_PAYLOAD_MAX (见 agent_mqtt_outbox.c 的 OutboxSpill_t)。"""
+    with open(OUTBOX_H, encoding='utf-8') as f:
+        return 4 + int(re.search(r'#define\s+MQTT_OUTBOX_PAYLOAD_MAX\s+(\d+)', f.read()).group(1))
+
+
+class HostProcess:
+    """后台运行 mqtt_host，逐行收集 stdout。"""
+
+    def __init__(self, cmd, env):
+        self.lines = []
+        self.proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True, env=env)
+        threading.Thread(target=self._read, daemon=True).start()
+
+    def _read(self):
+        for line in self.proc.stdout:
+            self.lines.append(line.strip())
+
+    def wait_line(self, key, timeout):
+        t0 = time.time()
+        while time.time() - t0 < timeout:
+            if any(l.split(',')[0] == key for l in self.lines):
+                return True
+            if self.proc.poll() is not None:
+                time.sleep(0.2)
+                return any(l.split(',')[0] == key for l in self.lines)
+            time.sleep(0.05)
+        return False
+
+
+# ==========================================
+# 2. 绘图
+# ==========================================
+def plot_events(events, t_kill, t_restart, output_pdf):
+    t0 = events['t'].iloc[0]
+    fig, ax = plt.subplots(figsize=(10, 4.5))
+    ax.plot(events['t'] - t0, events['seq'], '.', markersize=3)
+    ax.axvspan(t_kill - t0, t_restart - t0, color='r', alpha=0.15, label='broker 停止')
+    ax.set_xlabel('订阅端接收时刻 (s)')
+    ax.set_ylabel('事件序号')
+    ax.set_title('broker 停止 / 重启期间的事件到达 (离线发件箱回放)')
+    ax.grid(alpha=0.3)
+    ax.legend()
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    build(args.exe)
+    broker = Broker(None)
+    env = broker.env()
+    env.setdefault('HOST_MQTT_RECONNECT_MS', '2000')
+    duration = args.kill_at + args.outage + args.after
+    host = None
+    try:
+        rec = Recorder(broker, [TOPIC_STATUS, TOPIC_EVENT, TOPIC_AVAIL])
+        host = HostProcess([args.exe, 'outage', str(duration), str(args.event_ms)], env)
+        if not host.wait_line('connected', 10):
+            raise SystemExit('mqtt_host 未能连接 broker: ' + host.proc.stderr.read())
+
+        time.sleep(args.kill_at)
+        t_kill = time.time()
+        broker.kill()
+        print(f'broker 已停止 {args.outage}s ...')
+        time.sleep(args.outage)
+        t_restart = time.time()
+        broker.start()
+        print('broker 已重启')
+
+        if not host.wait_line('done', duration + 60):
+            raise SystemExit('mqtt_host 未在限定时间内清空发件箱')
+        time.sleep(0.5)
+        t_lwt = time.time()
+        host.proc.kill()    # SIGKILL: 不发 DISCONNECT，模拟掉电
+        host.proc.wait()
+        time.sleep(args.lwt_wait)
+        df = rec.frame()
+    finally:
+        if host and host.proc.poll() is None:
+            host.proc.kill()
+        broker.kill()
+
+    out = parse_host_output('\n'.join(host.lines))
+    n_events = out['events'][0]
+    final = dict(zip(STATE_KEYS, out['final']))
+    queued, spilled, dropped, replayed, pending = out['outbox']
+    nvs_writes, nvs_bytes, nvs_erases = out['nvs']
+    df = df[df['retain'] == 0].reset_index(drop=True)
+    df.to_csv(args.csv, index=False)
+
+    # 事件: 首次到达的序号
+    ev = df[df['topic'] == TOPIC_EVENT].copy()
+    ev['seq'] = [json.loads(p)['val'] for p in ev['payload']]
+    first = ev.drop_duplicates('seq')
+    missing = sorted(set(range(n_events)) - set(first['seq']))
+    inversions = int((first['seq'].diff().dropna() <= 0).sum())
+    dup = len(ev) - len(first)
+
+    got = merge_status(df[df['topic'] == TOPIC_STATUS])
+    avail = df[df['topic'] == TOPIC_AVAIL]
+    online_after = [json.loads(p)['online'] for t, p in zip(avail['t'], avail['payload']) if t_restart <= t < t_lwt]
+    lwt = [json.loads(p)['online'] for t, p in zip(avail['t'], avail['payload']) if t >= t_lwt]
+    rec_size = spill_record_size()
+    per_msg = nvs_bytes / spilled if spilled else 0
+
+    print(f'\n事件: 发出 {n_events} 条，收到 {len(first)} 条 (重复 {dup})，缺失 {len(missing)}，乱序 {inversions}')
+    print(f'发件箱: 入队 {queued}，溢出到 NVS {spilled}，丢弃 {dropped}，回放 {replayed}，剩余 {pending}')
+    print(f'NVS: 写入 {nvs_writes} 次 / {nvs_bytes} B (每条溢出消息 {per_msg:.1f} B，记录大小 {rec_size} B)，擦除 {nvs_erases} 次')
+    print(f'设备最终状态 {final}')
+    print(f'订阅端还原 {got}')
+    print(f'availability: 重连后 {online_after}，进程结束后 {lwt}')
+    print(f'✅ 逐条消息已写入 {args.csv}')
+
+    if not args.no_plot:
+        plot_events(first, t_kill, t_restart, args.pdf)
+        print(f'✅ 图表已保存 {args.pdf}')
+
+    fail = []
+    if missing:
+        fail.append(f'缺失事件 {missing[:10]}')
+    if inversions:
+        fail.append(f'事件乱序 {inversions} 处')
+    if got != final:
+        fail.append('订阅端还原的状态与设备最终状态不一致')
+    if dropped or pending:
+        fail.append(f'发件箱丢弃 {dropped} 条 / 剩余 {pending} 条')
+    if not spilled:
+        fail.append('断网期间未触发 NVS 溢出，请加长 --outage 或减小 --event-ms')
+    elif per_msg > rec_size * MAX_NVS_OVERHEAD:
+        fail.append(f'NVS 每条溢出消息写入 {per_msg:.0f} B，超过记录大小的 {MAX_NVS_OVERHEAD} 倍')
+    if not online_after or online_after[-1] != 1:
+        fail.append('重连后 availability 不是 online')
+    if lwt != [0]:
+        fail.append('进程结束后未收到 offline 遗嘱')
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('✅ 断网期间的事件按顺序补发，NVS 只追加写入，状态与遗嘱正确')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='MQTT 断网恢复测试 (主机端 + mosquitto)')
+    parser.add_argument('--kill-at', type=int, default=3, help='连上后多少秒停止 broker')
+    parser.add_argument('--outage', type=int, default=4, help='broker 停止时长 (s)')
+    parser.add_argument('--after', type=int, default=4, help='重启后继续产生事件的时长 (s)')
+    parser.add_argument('--event-ms', type=int, default=100, help='事件间隔 (ms)')
+    parser.add_argument('--lwt-wait', type=float, default=2, help='结束进程后等待遗嘱的时间 (s)')
+    parser.add_argument('--exe', default=os.path.join('output', 'mqtt_host' + ('.exe' if sys.platform == 'win32' else '')))
+    parser.add_argument('--csv', default='data/mqtt_outage.csv')
+    parser.add_argument('--pdf', default='output/mqtt_outage.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
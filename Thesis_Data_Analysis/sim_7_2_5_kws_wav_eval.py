@@ -0,0 +1,301 @@
+"""唤醒词 WAV 回放评估: 在主机端编译 ESP32 固件的 svc_wakeword.c，把 WAV 语料逐帧送进监听任务使用的
+_process_frame (I2S 32bit -> 16bit、WakeNet detect、负载统计)，报告负样本的误唤醒 / 小时、正样本的检出率与每帧耗时。
+
+注意: ESP-SR 的 WakeNet (MFCC 前端 + 量化模型) 只以 ESP32 / ESP32-S3 预编译库发布，无法在主机上链接运行。
+默认由 host/stub_esp32/wakenet_host.c 的替身模型 ("能量包络 + 时长" 检测器) 实现同一个 esp_wn_iface_t 接口，
+此时结果只检验固件的帧处理 / 唤醒后暂停路径与本脚本，不代表 WakeNet 的误唤醒率与检出率；
+有主机端可编译的模型实现 (同一组 esp_wn_iface / esp_srmodel 函数) 时用 --model-src 替换。
+设备上 WakeNet 的实际数值见 ESP32 日志 "[KWS] CPU load: x% | Detections: n in t s"
+(在无人说唤醒词的环境下运行，n / t * 3600 即误唤醒 / 小时)。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/kws_host.c (直接包含固件 svc_wakeword.c)、模型实现与 FreeRTOS 桩编译成主机程序。
+  2. 固定用例: I2S 样本移位与限幅、统计周期到达时 audio_sec / cpu_load_pct 的更新。
+  3. 回放 --pos (每个文件含一次唤醒词) 与 --neg (不含唤醒词的长录音) 目录下的 16kHz / 16bit / 单声道 WAV；
+     唤醒后跳过 --refractory-ms 的音频 (板上唤醒后麦克风交给 ASR，回到 IDLE 前不监听)。
+     未给出目录时生成合成语料 data/kws_synth: 正样本为底噪中的一段 0.5~1.0s 双音节谐波，
+     负样本为底噪中的短促敲击、2~6s 的持续音和长句式音节串。
+检查项 (任一不满足退出码 1):
+  * 固定用例全部通过，所有 WAV 都能读取
+  * 合成语料: 正样本全部检出，负样本无误唤醒
+  * 给出 --min-detect-rate / --max-fa-per-hour 时按其检查
+每帧耗时为主机数值，只用于比较模型开销和发现回归。
+
+用法:
+    py sim_7_2_5_kws_wav_eval.py
+    py sim_7_2_5_kws_wav_eval.py --pos data/kws/pos --neg data/kws/neg --max-fa-per-hour 1
+"""
+
+import argparse
+import glob
+import os
+import shlex
+import subprocess
+import sys
+import wave
+
+import numpy as np
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+ESP32_DIR = os.path.join(SCRIPT_DIR, '..', 'ESP32_Firmware_Code', 'ESP32_Firmware')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+STUB_DIR = os.path.join(HOST_DIR, 'stub_esp32')
+
+MODEL_SRC = os.path.join(STUB_DIR, 'wakenet_host.c')
+SOURCES = [
+    os.path.join(HOST_DIR, 'kws_host.c'),
+    os.path.join(STUB_DIR, 'freertos_host.c'),
+]
+INCLUDES = [STUB_DIR, os.path.join(ESP32_DIR, 'main')] + \
+    [os.path.join(ESP32_DIR, 'components', c, 'include') for c in ('1_DataRepo', '2_Device', '3_Service', '5_Utils')]
+EXE_SUFFIX = '.exe' if sys.platform == 'win32' else ''
+
+RATE = 16000
+SYNTH_DIR = os.path.join('data', 'kws_synth')
+SYNTH_POS = 40              # 正样本条数 (每条 3s)
+SYNTH_NEG_MIN = 5           # 每个负样本文件的时长 (min)
+SYNTH_NEG_FILES = 3
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+def db_to_amp(db):
+    return 32768.0 * 10 ** (db / 20)
+
+
+def harmonic(rng, n, level_db):
+    """谐波复音 (基频带轻微颤动)，RMS 为 level_db dBFS"""
+    t = np.arange(n) / RATE
+    f0 = rng.uniform(110, 230) * (1 + 0.05 * np.sin(2 * np.pi * rng.uniform(2, 5) * t))
+    phase = 2 * np.pi * np.cumsum(f0) / RATE
+    x = sum(np.sin(k * phase) / k for k in (1, 2, 3))
+    return x / np.sqrt(np.mean(x ** 2)) * db_to_amp(level_db)
+
+
+def fade(x, ms=20):
+    n = min(len(x) // 2, int(RATE * ms / 1000))
+    ramp = np.linspace(0, 1, n)
+    x[:n] *= ramp
+    x[len(x) - n:] *= ramp[::-1]
+    return x
+
+
+def syllables(rng, total_s, level_db, gap_ms):
+    """若干音节首尾相接，音节之间留 gap_ms 的短停顿"""
+    out = []
+    left = int(total_s * RATE)
+    while left > 0:
+        n = min(left, int(rng.uniform(0.18, 0.3) * RATE))
+        out.append(fade(harmonic(rng, n, level_db)))
+        gap = np.zeros(int(rng.uniform(*gap_ms) * RATE / 1000))
+        out.append(gap)
+        left -= n + len(gap)
+    return np.concatenate(out)[:int(total_s * RATE)]
+
+
+def write_wav(path, x):
+    with wave.open(path, 'wb') as w:
+        w.setnchannels(1)
+        w.setsampwidth(2)
+        w.setframerate(RATE)
+        w.writeframes(np.clip(np.round(x), -32768, 32767).astype('<i2').tobytes())
+
+
+def synth_corpus(root, seed):
+    """合成正 / 负样本 WAV，返回 (正样本目录, 负样本目录)"""
+    rng = np.random.default_rng(seed)
+    pos_dir, neg_dir = os.path.join(root, 'pos'), os.path.join(root, 'neg')
+    for d in (pos_dir, neg_dir):
+        os.makedirs(d, exist_ok=True)
+        for f in glob.glob(os.path.join(d, '*.wav')):
+            os.remove(f)
+
+    for i in range(SYNTH_POS):
+        x = rng.normal(0, db_to_amp(-55), 3 * RATE)
+        word = syllables(rng, rng.uniform(0.5, 1.0), -20, (40, 100))
+        start = int(rng.uniform(0.8, 1.2) * RATE)
+        x[start:start + len(word)] += word
+        write_wav(os.path.join(pos_dir, f'pos_{i:03d}.wav'), x)
+
+    for i in range(SYNTH_NEG_FILES):
+        n = SYNTH_NEG_MIN * 60 * RATE
+        drift = 10 ** (4 * np.sin(2 * np.pi * np.arange(n) / n * rng.uniform(1, 3)) / 20)
+        x = rng.normal(0, db_to_amp(-55), n) * drift
+        pos = int(rng.uniform(2, 5) * RATE)
+        while True:
+            kind = rng.integers(3)
+            if kind == 0:       # 敲击 / 关门
+                ev = fade(rng.normal(0, db_to_amp(-25), int(rng.uniform(0.02, 0.15) * RATE)), 5)
+            elif kind == 1:     # 持续音 (风扇、音乐)
+                ev = fade(harmonic(rng, int(rng.uniform(2, 6) * RATE), -25), 100)
+            else:               # 长句: 音节间停顿短，连成一段
+                ev = syllables(rng, rng.uniform(2, 4), -20, (40, 120))
+            if pos + len(ev) >= n:
+                break
+            x[pos:pos + len(ev)] += ev
+            pos += len(ev) + int(rng.uniform(2, 8) * RATE)
+        write_wav(os.path.join(neg_dir, f'neg_{i:02d}.wav'), x)
+    return pos_dir, neg_dir
+
+
+# ==========================================
+# 2. 编译与运行主机测试程序
+# ==========================================
+def build(exe, model_src):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall'] + [f'-I{d}' for d in INCLUDES] + SOURCES + [model_src] + \
+        ['-lpthread', '-lm', '-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def run_unit(exe):
+    proc = subprocess.run([exe, 'unit'], capture_output=True, text=True)
+    rows = [line.split(',', 3) for line in proc.stdout.splitlines()]
+    cases = [r for r in rows if r[0] == 'case']
+    print(f"\nsvc_wakeword.c 固定用例: {sum(r[2] == '1' for r in cases)}/{len(cases)} 通过")
+    for r in rows:
+        if r[0] == 'case':
+            print(f"  {'✅' if r[2] == '1' else '❌'} {r[1]}")
+        elif r[0] == 'fail':
+            print(f"     kws_host.c:{r[2]} {r[3]}")
+    return proc.returncode == 0 and len(cases) > 0
+
+
+def run_eval(exe, wav, refractory_ms):
+    proc = subprocess.run([exe, 'eval', wav, str(refractory_ms)], capture_output=True, text=True)
+    row = None
+    for line in proc.stdout.splitlines():
+        f = line.split(',')
+        if f[0] == 'eval':
+            row = dict(audio_ms=int(f[1]), frames=int(f[2]), detections=int(f[3]),
+                       frame_us_mean=float(f[4]), frame_us_max=int(f[5]), chunk=int(f[6]))
+    if proc.returncode != 0 or row is None:
+        print(f"  ❌ {proc.stderr.strip() or f'{wav}: 退出码 {proc.returncode}'}")
+        return None
+    return row
+
+
+def evaluate(exe, dirs, refractory_ms):
+    rows = []
+    for kind, d in dirs:
+        files = sorted(glob.glob(os.path.join(d, '*.wav')))
+        if not files:
+            print(f"  ❌ {d} 中没有 WAV 文件")
+            rows.append(dict(set=kind, file=d, ok=0))
+        for wav in files:
+            r = run_eval(exe, wav, refractory_ms)
+            rows.append(dict(set=kind, file=os.path.basename(wav), ok=int(r is not None), **(r or {})))
+    return pd.DataFrame(rows)
+
+
+def summarize(df):
+    pos, neg = df[(df['set'] == 'pos') & (df['ok'] == 1)], df[(df['set'] == 'neg') & (df['ok'] == 1)]
+    ok = df[df['ok'] == 1]
+    s = dict(pos_files=len(pos), neg_hours=neg['audio_ms'].sum() / 3.6e6 if len(neg) else 0.0)
+    s['detect_rate'] = 100.0 * (pos['detections'] > 0).mean() if len(pos) else float('nan')
+    s['false_accepts'] = int(neg['detections'].sum()) if len(neg) else 0
+    s['fa_per_hour'] = s['false_accepts'] / s['neg_hours'] if s['neg_hours'] > 0 else float('nan')
+    frames = ok['frames'].sum()
+    s['frame_us_mean'] = (ok['frame_us_mean'] * ok['frames']).sum() / frames if frames else 0.0
+    s['frame_us_max'] = int(ok['frame_us_max'].max()) if frames else 0
+    s['frame_ms'] = 1000.0 * ok['chunk'].iloc[0] / RATE if frames else 0.0
+    s['cpu_pct'] = 100.0 * s['frame_us_mean'] / (s['frame_ms'] * 1000) if frames else 0.0
+    return s
+
+
+# ==========================================
+# 3. 绘图
+# ==========================================
+def plot_summary(s, output_pdf):
+    fig, axes = plt.subplots(1, 3, figsize=(11, 4))
+    items = [('检出率 (%)', s['detect_rate'], 'tab:green'), ('误唤醒 / 小时', s['fa_per_hour'], 'tab:red'),
+             ('每帧耗时占帧长 (%)', s['cpu_pct'], 'tab:blue')]
+    for ax, (label, v, color) in zip(axes, items):
+        ax.bar([0], [0 if np.isnan(v) else v], color=color, width=0.5)
+        ax.text(0, 0 if np.isnan(v) else v, '—' if np.isnan(v) else f'{v:.2f}', ha='center', va='bottom')
+        ax.set_xticks([])
+        ax.set_title(label)
+        ax.grid(alpha=0.3, axis='y')
+    fig.suptitle('唤醒词 WAV 回放评估 (主机端)')
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    exe = os.path.join('output', 'kws_host' + EXE_SUFFIX)
+    build(exe, args.model_src)
+    fail = []
+    if not run_unit(exe):
+        fail.append('svc_wakeword.c 固定用例失败')
+
+    synth = not args.pos and not args.neg
+    if synth:
+        pos_dir, neg_dir = synth_corpus(SYNTH_DIR, args.seed)
+        print(f"\n未给出语料目录，已生成合成语料 {SYNTH_DIR} (正样本 {SYNTH_POS} 条，"
+              f"负样本 {SYNTH_NEG_FILES} x {SYNTH_NEG_MIN} min)")
+    else:
+        pos_dir, neg_dir = args.pos, args.neg
+    dirs = [(k, d) for k, d in (('pos', pos_dir), ('neg', neg_dir)) if d]
+
+    print(f"回放 (唤醒后跳过 {args.refractory_ms}ms)，模型: {os.path.basename(args.model_src)}")
+    df = evaluate(exe, dirs, args.refractory_ms)
+    df.to_csv(args.csv, index=False)
+    if (df['ok'] == 0).any():
+        fail.append(f"{int((df['ok'] == 0).sum())} 个 WAV 无法回放")
+
+    s = summarize(df)
+    if pos_dir:
+        print(f"  正样本 {s['pos_files']} 条 | 检出率 {s['detect_rate']:.1f}%")
+    if neg_dir:
+        print(f"  负样本 {s['neg_hours'] * 60:.1f} min | 误唤醒 {s['false_accepts']} 次 = {s['fa_per_hour']:.2f} 次/小时")
+    print(f"  每帧 ({s['frame_ms']:.0f}ms 音频) 处理耗时: 平均 {s['frame_us_mean']:.1f}us / 最大 {s['frame_us_max']}us "
+          f"(主机) = {s['cpu_pct']:.3f}% 单核")
+    print(f"✅ 逐文件结果已写入 {args.csv}")
+
+    if synth:
+        if pos_dir and s['detect_rate'] < 100:
+            fail.append(f"合成正样本检出率 {s['detect_rate']:.1f}% < 100%")
+        if neg_dir and s['false_accepts'] > 0:
+            fail.append(f"合成负样本误唤醒 {s['false_accepts']} 次")
+    if args.min_detect_rate is not None and not s['detect_rate'] >= args.min_detect_rate:
+        fail.append(f"检出率 {s['detect_rate']:.1f}% 低于 {args.min_detect_rate}%")
+    if args.max_fa_per_hour is not None and not s['fa_per_hour'] <= args.max_fa_per_hour:
+        fail.append(f"误唤醒 {s['fa_per_hour']:.2f} 次/小时 超过 {args.max_fa_per_hour}")
+
+    if not args.no_plot:
+        plot_summary(s, args.pdf)
+        print(f"✅ 图表已保存 {args.pdf}")
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('\n✅ 固定用例通过，语料回放结果满足检查项')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='唤醒词 WAV 回放评估: 误唤醒 / 小时、检出率、每帧耗时 (主机端)')
+    parser.add_argument('--pos', help='正样本 WAV 目录 (16kHz / 16bit / 单声道，每个文件含一次唤醒词)')
+    parser.add_argument('--neg', help='负样本 WAV 目录 (不含唤醒词的长录音)')
+    parser.add_argument('--refractory-ms', type=int, default=5000,
+                        help='唤醒后不监听的时长 (ms)，默认等于 ASR 录音时长')
+    parser.add_argument('--model-src', default=MODEL_SRC, help='esp_wn_iface_t 的主机端实现 (.c)')
+    parser.add_argument('--min-detect-rate', type=float, help='正样本检出率下限 (%%)')
+    parser.add_argument('--max-fa-per-hour', type=float, help='负样本误唤醒上限 (次/小时)')
+    parser.add_argument('--seed', type=int, default=1, help='合成语料的随机种子')
+    parser.add_argument('--csv', default='data/kws_eval.csv')
+    parser.add_argument('--pdf', default='output/kws_eval.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
@@ -0,0 +1,244 @@
+"""CSI 采集回放测试: 在主机端编译 ESP32 固件的 dev_csi.c，把录制的 CSI 原始帧逐帧回放给前端与全部检测器，
+报告每帧处理耗时，并按标注检查融合得分能否区分有人 / 无人。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/csi_replay_host.c (直接包含固件 dev_csi.c)、固件 csi_mlp.c
+     与 host/stub_esp32 桩 (Wi-Fi / Ping / FreeRTOS / NVS) 编译成主机程序。
+  2. 回放命令行给出的采集目录 (csi_capture_receiver.py 的输出，格式见 csi_capture_loader.py)；
+     未给出时生成一段合成采集 data/csi_capture_synth:
+     无人 40s -> 活动 30s -> 静止 20s -> 无人 30s (最后一段按无人探测速率 200ms 一帧，检验帧率补偿)。
+  3. 每帧记录前端 (|I|+|Q|) 与检测器处理耗时 (ns)，每 500ms 采集时间评估一次窗口，输出得分与融合得分。
+检查项 (任一不满足退出码 1):
+  * 采集中的每一帧都被处理
+  * 有标注时: 有人 (静止 / 微动 / 活动) 窗口的平均融合得分高于无人窗口
+  * 合成采集: 活动窗口融合得分超过判定阈值的比例 >= 80%，无人窗口 <= 5%
+主机耗时只用于比较算法开销和发现回归，不代表 ESP32 上的绝对耗时 (设备端以 [CSI-FE] 日志为准)。
+
+用法:
+    py sim_7_3_1_csi_replay.py
+    py sim_7_3_1_csi_replay.py data/csi_capture_20260101_120000 data/csi_capture_20260102_093000
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+
+import numpy as np
+import pandas as pd
+import matplotlib.pyplot as plt
+
+from csi_capture_loader import COLUMNS, IQ_STRIDE, LABEL_NAMES, write_meta
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEV_DIR = os.path.join(SCRIPT_DIR, '..', 'ESP32_Firmware_Code', 'ESP32_Firmware', 'components', '2_Device')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+STUB_DIR = os.path.join(HOST_DIR, 'stub_esp32')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'csi_replay_host.c'),
+    os.path.join(DEV_DIR, 'src', 'csi_mlp.c'),
+    os.path.join(STUB_DIR, 'freertos_host.c'),
+    os.path.join(STUB_DIR, 'nvs_host.c'),
+]
+INCLUDES = [STUB_DIR, os.path.join(DEV_DIR, 'include'), os.path.join(DEV_DIR, 'src')]
+
+FUSE_THRESHOLD = 100        # dev_csi.c CSI_FUSE_THRESHOLD
+SYNTH_DIR = os.path.join('data', 'csi_capture_synth')
+SYNTH_SEGMENTS = [(1, 40, 50), (4, 30, 50), (2, 20, 50), (1, 30, 200)]   # (标注, 秒, 帧间隔 ms)
+SYNTH_MIN_ACTIVE = 0.8
+SYNTH_MAX_EMPTY = 0.05
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 合成采集 / 编译 / 回放
+# ==========================================
+def synth_capture(path, seed=1):
+    """多径信道模型: 固定的 6 条静态路径 + 人体反射路径 (活动: 幅度大、相位快速变化；静止: 呼吸引起的小幅慢变)，
+    叠加接收噪声与 AGC 增益抖动后量化为 int8 I/Q，写成与 csi_capture_receiver.py 相同的按列格式。"""
+    rng = np.random.default_rng(seed)
+    n_sub = IQ_STRIDE // 2
+    k = np.arange(n_sub)
+    static = sum(rng.uniform(4, 10) * np.exp(-2j * np.pi * k * rng.uniform(0, 0.05) + 1j * rng.uniform(0, 2 * np.pi))
+                 for _ in range(6))
+    body_tau = rng.uniform(0.01, 0.04)
+
+    ts, label = [], []
+    t = 0.0
+    for lab, seconds, dt_ms in SYNTH_SEGMENTS:
+        end = t + seconds
+        while t < end:
+            ts.append(t)
+            label.append(lab)
+            t += (dt_ms + rng.uniform(-5, 5)) / 1000.0
+    ts = np.array(ts)
+    label = np.array(label, dtype=np.uint8)
+    n = len(ts)
+
+    phase = np.zeros(n)
+    amp = np.zeros(n)
+    for i in range(1, n):
+        dt = ts[i] - ts[i - 1]
+        if label[i] == 4:       # 走动: 路径长度连续变化，相位 ~ 2 周/s，幅度随姿态起伏
+            phase[i] = phase[i - 1] + 2 * np.pi * dt * rng.normal(2.0, 0.8)
+            amp[i] = 6 + 3 * np.sin(2 * np.pi * 0.7 * ts[i]) + rng.normal(0, 0.5)
+        elif label[i] == 2:     # 静坐: 呼吸 0.25Hz，相位摆动 ±1.5 rad
+            phase[i] = 1.5 * np.sin(2 * np.pi * 0.25 * ts[i])
+            amp[i] = 4
+    body = amp[:, None] * np.exp(-2j * np.pi * k[None, :] * body_tau + 1j * phase[:, None])
+    gain = 1 + rng.normal(0, 0.01, (n, 1))
+    noise = rng.normal(0, 0.6, (n, n_sub)) + 1j * rng.normal(0, 0.6, (n, n_sub))
+    h = (static[None, :] + body) * gain + noise
+
+    iq = np.empty((n, IQ_STRIDE), dtype=np.int8)
+    iq[:, 0::2] = np.clip(np.round(h.imag), -127, 127)
+    iq[:, 1::2] = np.clip(np.round(h.real), -127, 127)
+
+    os.makedirs(path, exist_ok=True)
+    cols = {
+        'ts_us': (ts * 1e6).astype(np.uint64) + 1_000_000,
+        'seq': np.arange(n),
+        'rssi': rng.integers(-52, -46, n),
+        'channel': np.full(n, 6),
+        'label': label,
+        'flags': np.zeros(n),
+        'iq_len': np.full(n, IQ_STRIDE),
+    }
+    for name, dtype in COLUMNS.items():
+        np.asarray(cols[name]).astype(dtype).tofile(os.path.join(path, f'{name}.bin'))
+    iq.tofile(os.path.join(path, 'iq.bin'))
+    write_meta(path, n)
+    print(f'已生成合成采集 {path}: {n} 帧，{ts[-1]:.0f}s')
+    return n
+
+
+def build(exe):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    # ESP-IDF 中 uint32_t 为 unsigned long，固件日志的 %lu 在主机 (unsigned int) 上会误报 -Wformat
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall', '-Wno-format'] + [f'-I{d}' for d in INCLUDES] + SOURCES + \
+        ['-lpthread', '-lm', '-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    subprocess.run(cmd, check=True)
+
+
+def replay(exe, cap_dir, name):
+    frames_csv = os.path.join('data', f'csi_replay_{name}_frames.csv')
+    windows_csv = os.path.join('data', f'csi_replay_{name}_windows.csv')
+    out = subprocess.run([exe, cap_dir, frames_csv, windows_csv], check=True, capture_output=True, text=True).stdout
+    summary = {}
+    dets = []
+    for line in out.splitlines():
+        key, *vals = line.split(',')
+        if key == 'det':
+            dets.append((vals[0], int(vals[1]), float(vals[2]), int(vals[3])))
+        else:
+            summary[key] = [float(v) for v in vals]
+    return summary, dets, pd.read_csv(frames_csv), pd.read_csv(windows_csv), frames_csv, windows_csv
+
+
+# ==========================================
+# 3. 绘图
+# ==========================================
+def plot_replay(name, frames, windows, output_pdf):
+    fig, (ax1, ax2) = plt.subplots(2, 1, figsize=(10, 7))
+    ax1.hist((frames['fe_ns'] + frames['proc_ns']) / 1000, bins=80, color='tab:blue', alpha=0.8)
+    ax1.set_xlabel('每帧处理耗时 (us，前端 + 全部检测器，主机)')
+    ax1.set_ylabel('帧数')
+    ax1.set_title(f'CSI 回放 {name}: 每帧处理耗时分布')
+    ax1.grid(alpha=0.3)
+
+    for lab, grp in windows.groupby('label'):
+        ax2.plot(grp['t_s'], grp['fused'], '.', markersize=4, label=LABEL_NAMES.get(int(lab), str(lab)))
+    ax2.axhline(FUSE_THRESHOLD, color='r', linestyle='--', label='判定阈值')
+    ax2.set_xlabel('采集时间 (s)')
+    ax2.set_ylabel('融合得分')
+    ax2.set_title('500ms 窗口融合得分 (按标注着色)')
+    ax2.grid(alpha=0.3)
+    ax2.legend(fontsize=9)
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+    plt.close(fig)
+
+
+def main(args):
+    build(args.exe)
+    captures = args.captures
+    synthetic = not captures
+    if synthetic:
+        synth_capture(SYNTH_DIR)
+        captures = [SYNTH_DIR]
+
+    fail = []
+    for cap_dir in captures:
+        name = os.path.basename(os.path.normpath(cap_dir))
+        with open(os.path.join(cap_dir, 'ts_us.bin'), 'rb') as f:
+            n_cap = len(f.read()) // 8
+        summary, dets, frames, windows, frames_csv, windows_csv = replay(args.exe, cap_dir, name)
+        n, dur_ms = summary['frames']
+        fe = summary['fe_ns']
+        proc = summary['proc_ns']
+
+        print(f'\n[{name}] 帧: {int(n)} / {n_cap} | 时长: {dur_ms / 1000:.1f}s | 窗口: {len(windows)}')
+        print(f'  前端 |I|+|Q|: 平均 {fe[0]:.0f} ns, p50 {fe[1]:.0f}, p99 {fe[2]:.0f}, 最大 {fe[3]:.0f}')
+        print(f'  检测器合计:   平均 {proc[0]:.0f} ns, p50 {proc[1]:.0f}, p99 {proc[2]:.0f}, 最大 {proc[3]:.0f}')
+        for det, weight, mean_ns, max_ns in dets:
+            print(f'    {det} (权重 {weight}): 平均 {mean_ns:.0f} ns, 最大 {max_ns} ns')
+        infer = summary['infer_ns']
+        if infer[2]:
+            print(f'  V4 推理: 平均 {infer[0]:.0f} ns, 最大 {infer[1]:.0f} ns ({int(infer[2])} 窗口)')
+        else:
+            print('  V4 未注册 (csi_mlp_weights.h 为占位权重)')
+        print(f'✅ 逐帧耗时 {frames_csv}，窗口得分 {windows_csv}')
+
+        if int(n) != n_cap:
+            fail.append(f'{name}: 只处理了 {int(n)} / {n_cap} 帧')
+
+        empty = windows[windows['label'] == 1]['fused']
+        occupied = windows[windows['label'].isin([2, 3, 4])]['fused']
+        if len(empty) and len(occupied):
+            print(f'  融合得分: 无人 平均 {empty.mean():.1f} ({(empty > FUSE_THRESHOLD).mean():.1%} 超阈值) | '
+                  f'有人 平均 {occupied.mean():.1f} ({(occupied > FUSE_THRESHOLD).mean():.1%} 超阈值)')
+            if occupied.mean() <= empty.mean():
+                fail.append(f'{name}: 有人窗口的平均融合得分不高于无人窗口')
+        else:
+            print('  采集缺少无人 / 有人标注，跳过得分检查')
+
+        if synthetic:
+            active = windows[windows['label'] == 4]['fused']
+            hit = (active > FUSE_THRESHOLD).mean()
+            false_alarm = (empty > FUSE_THRESHOLD).mean()
+            if hit < SYNTH_MIN_ACTIVE:
+                fail.append(f'合成采集活动窗口检出率 {hit:.1%} < {SYNTH_MIN_ACTIVE:.0%}')
+            if false_alarm > SYNTH_MAX_EMPTY:
+                fail.append(f'合成采集无人窗口误报率 {false_alarm:.1%} > {SYNTH_MAX_EMPTY:.0%}')
+
+        if not args.no_plot:
+            pdf = os.path.join('output', f'csi_replay_{name}.pdf')
+            plot_replay(name, frames, windows, pdf)
+            print(f'✅ 图表已保存 {pdf}')
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('\n✅ 所有帧均已回放，融合得分随标注变化')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='CSI 采集回放: 每帧处理耗时与检测得分 (主机端)')
+    parser.add_argument('captures', nargs='*', help='csi_capture_receiver.py 生成的采集目录 (省略时使用合成采集)')
+    parser.add_argument('--exe', default=os.path.join('output', 'csi_replay_host' + ('.exe' if sys.platform == 'win32' else '')))
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
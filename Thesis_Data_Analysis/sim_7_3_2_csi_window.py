@@ -0,0 +1,156 @@
+"""CSI 窗口统计测试: 在主机端编译 ESP32 固件的 dev_csi.c，检查 V2 / V3 流式窗口统计的正确性与耗时，
+并对窗口双缓冲交接 (csi_proc 写 / csi_monitor 读) 做双线程压力测试。
+
+流程:
+  1. 用 $CC (默认 gcc) 把 host/csi_window_host.c (直接包含固件 dev_csi.c) 与 host/stub_esp32 桩编译成主机程序；
+     非 Windows 平台另外用 -fsanitize=thread 编译一份，只跑压力测试 (编译器不支持时跳过并提示)。
+  2. equiv: --windows 个随机窗口 (每窗 0~80 个样本，含大量重复值)，V3 流式截尾均值与排序参考实现、
+     V2 流式极差与全量 min/max 逐窗比较。
+  3. bench: 每窗 4 / 10 / 20 / 32 / 64 个样本时，原实现 (32 点历史 + 冒泡排序) 与流式实现的单窗耗时。
+     原实现超过 32 个样本后直接丢弃，64 点一栏的原实现耗时并不包含被丢掉的样本。
+  4. race: 写线程每帧 begin / 写 / end，读线程随机 0~200us 翻转并读取旧窗口，持续 --race-s 秒。
+检查项 (任一不满足退出码 1):
+  * equiv 中 V3 / V2 与参考实现不一致的窗口数为 0
+  * race 中读到写入中窗口的次数为 0，读线程累计的样本数与序号和等于写线程写入的
+  * ThreadSanitizer 版本 (若可编译) 没有报告数据竞争
+
+用法:
+    py sim_7_3_2_csi_window.py
+    py sim_7_3_2_csi_window.py --windows 1000000 --race-s 10 --no-tsan
+"""
+
+import argparse
+import io
+import os
+import shlex
+import subprocess
+import sys
+
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# ==========================================
+# 1. 全局配置与初始化
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEV_DIR = os.path.join(SCRIPT_DIR, '..', 'ESP32_Firmware_Code', 'ESP32_Firmware', 'components', '2_Device')
+HOST_DIR = os.path.join(SCRIPT_DIR, 'host')
+STUB_DIR = os.path.join(HOST_DIR, 'stub_esp32')
+
+SOURCES = [
+    os.path.join(HOST_DIR, 'csi_window_host.c'),
+    os.path.join(DEV_DIR, 'src', 'csi_mlp.c'),
+    os.path.join(STUB_DIR, 'freertos_host.c'),
+    os.path.join(STUB_DIR, 'nvs_host.c'),
+]
+INCLUDES = [STUB_DIR, os.path.join(DEV_DIR, 'include'), os.path.join(DEV_DIR, 'src')]
+EXE_SUFFIX = '.exe' if sys.platform == 'win32' else ''
+
+os.makedirs('data', exist_ok=True)
+os.makedirs('output', exist_ok=True)
+
+plt.rcParams['font.sans-serif'] = ['SimHei', 'Songti SC', 'Arial Unicode MS']
+plt.rcParams['axes.unicode_minus'] = False
+plt.rcParams['font.size'] = 12
+plt.rcParams['figure.dpi'] = 300
+
+
+# ==========================================
+# 2. 编译与运行主机测试程序
+# ==========================================
+def build(exe, extra=(), check=True):
+    cc = shlex.split(os.environ.get('CC', 'gcc'))
+    # ESP-IDF 中 uint32_t 为 unsigned long，固件日志的 %lu 在主机 (unsigned int) 上会误报 -Wformat
+    cmd = cc + ['-std=gnu99', '-O2', '-Wall', '-Wno-format'] + list(extra) + [f'-I{d}' for d in INCLUDES] + \
+        SOURCES + ['-lpthread', '-lm', '-o', exe]
+    print('$ ' + ' '.join(shlex.quote(c) for c in cmd))
+    return subprocess.run(cmd, check=check).returncode == 0
+
+
+def run(exe, *args):
+    proc = subprocess.run([exe, *map(str, args)], capture_output=True, text=True)
+    rows = [line.split(',') for line in proc.stdout.splitlines()]
+    return proc, rows
+
+
+# ==========================================
+# 3. 绘图
+# ==========================================
+def plot_bench(df, output_pdf):
+    fig, ax = plt.subplots(figsize=(8, 4.5))
+    x = range(len(df))
+    ax.bar([i - 0.2 for i in x], df['old_ns'], width=0.4, label='原实现 (拷贝 + 冒泡排序，32 点上限)')
+    ax.bar([i + 0.2 for i in x], df['new_ns'], width=0.4, label='流式截尾均值')
+    ax.set_xticks(list(x))
+    ax.set_xticklabels([str(n) for n in df['n']])
+    ax.set_xlabel('每窗口样本数')
+    ax.set_ylabel('单窗口耗时 (ns，主机)')
+    ax.set_title('V3 截尾均值: 原实现与流式实现耗时对比')
+    ax.grid(alpha=0.3, axis='y')
+    ax.legend()
+    plt.tight_layout()
+    plt.savefig(output_pdf)
+
+
+def main(args):
+    exe = os.path.join('output', 'csi_window_host' + EXE_SUFFIX)
+    build(exe)
+    fail = []
+
+    _, rows = run(exe, 'equiv', args.windows)
+    _, windows, samples, bad3, bad2 = rows[0]
+    print(f'\nequiv: {windows} 个窗口 / {samples} 个样本 | V3 不一致 {bad3} | V2 不一致 {bad2}')
+    if int(bad3) or int(bad2):
+        fail.append(f'流式统计与参考实现不一致 (V3 {bad3} / V2 {bad2} 个窗口)')
+
+    _, rows = run(exe, 'bench')
+    bench = pd.DataFrame([[int(r[1]), float(r[2]), float(r[3])] for r in rows], columns=['n', 'old_ns', 'new_ns'])
+    bench['speedup'] = bench['old_ns'] / bench['new_ns']
+    bench.to_csv(args.csv, index=False)
+    print('\nbench (单窗口 ns，主机):')
+    print(bench.to_string(index=False, float_format=lambda v: f'{v:.1f}'))
+    print(f'✅ 已写入 {args.csv}')
+
+    targets = [('普通', exe)]
+    if not args.no_tsan and sys.platform != 'win32':
+        tsan = os.path.join('output', 'csi_window_host_tsan' + EXE_SUFFIX)
+        if build(tsan, ['-g', '-fsanitize=thread'], check=False):
+            targets.append(('ThreadSanitizer', tsan))
+        else:
+            print('⚠️ 编译器不支持 -fsanitize=thread，跳过 TSan 压力测试')
+    for name, target in targets:
+        proc, rows = run(target, 'race', args.race_s)
+        race = [r for r in rows if r[0] == 'race']
+        if proc.returncode != 0 or not race:
+            fail.append(f'{name} 压力测试异常退出 (退出码 {proc.returncode})')
+            print(proc.stderr[-2000:])
+            continue
+        writes, swaps, overlaps, lost, spins = race[0][1:]
+        print(f'\nrace ({name}, {args.race_s}s): 写入 {writes} 次 | 翻转 {swaps} 次 | 读线程等待 {spins} 次 | '
+              f'重叠 {overlaps} | 丢失 {lost}')
+        if int(overlaps) or int(lost):
+            fail.append(f'{name} 压力测试: 重叠 {overlaps} 次，丢失 {lost} 个样本')
+        if 'ThreadSanitizer' in proc.stderr:
+            fail.append('ThreadSanitizer 报告了数据竞争')
+            print(proc.stderr[-2000:])
+
+    if not args.no_plot:
+        plot_bench(bench, args.pdf)
+        print(f'✅ 图表已保存 {args.pdf}')
+
+    if fail:
+        print('❌ ' + '; '.join(fail))
+        return 1
+    print('\n✅ 流式统计与参考实现一致，窗口交接无重叠、无丢样本')
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='CSI 窗口统计: 正确性 / 耗时 / 交接压力测试 (主机端)')
+    parser.add_argument('--windows', type=int, default=200000, help='equiv 随机窗口数')
+    parser.add_argument('--race-s', type=int, default=5, help='压力测试时长 (s)')
+    parser.add_argument('--no-tsan', action='store_true', help='不编译 / 运行 ThreadSanitizer 版本')
+    parser.add_argument('--csv', default='data/csi_window_bench.csv')
+    parser.add_argument('--pdf', default='output/csi_window_bench.pdf')
+    parser.add_argument('--no-plot', action='store_true')
+    raise SystemExit(main(parser.parse_args()))
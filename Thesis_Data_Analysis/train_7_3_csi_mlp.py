@@ -0,0 +1,434 @@
+"""CSI 存在检测 int8 小型 MLP (固件 V4 检测器) 的训练、量化导出与回归检查。
+
+数据来自 csi_capture_receiver.py 的采集目录 (带 csilabel 标注)。特征提取逐位复刻
+固件 components/2_Device/src/csi_mlp.c，每 500ms (与 csi_monitor 周期一致) 一个窗口:
+    标注 1 (无人) -> 0，标注 2~4 (静止/微动/活动) -> 1，未标注窗口跳过。
+
+用法:
+    py train_7_3_csi_mlp.py data/csi_capture_A data/csi_capture_B          # 训练并导出 csi_mlp_weights.h
+    py train_7_3_csi_mlp.py data/csi_capture_C --check --min-acc 0.90      # 回归检查当前头文件，不达标退出码 1
+
+--check 同时把固件 csi_mlp.c 编译为主机动态库 (需要 gcc)，逐帧喂入同一份数据，
+要求 C 实现与本脚本的整数推理结果一致，并统计主机单窗口推理耗时。
+"""
+
+import argparse
+import ctypes
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+import numpy as np
+import pandas as pd
+
+from csi_capture_loader import load_capture, amplitudes
+
+# ==========================================
+# 1. 全局配置 (与固件 csi_mlp.h / dev_csi.c 保持一致)
+# ==========================================
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEVICE_DIR = os.path.join(SCRIPT_DIR, '..', 'ESP32_Firmware_Code', 'ESP32_Firmware', 'components', '2_Device')
+HEADER_PATH = os.path.join(DEVICE_DIR, 'src', 'csi_mlp_weights.h')
+C_SOURCE = os.path.join(DEVICE_DIR, 'src', 'csi_mlp.c')
+C_INCLUDE = os.path.join(DEVICE_DIR, 'include')
+
+BANDS = 16                  # CSI_MLP_BANDS
+N_IN = 20                   # CSI_MLP_IN
+N_HIDDEN = 16               # CSI_MLP_HIDDEN
+MAX_SUBCARRIERS = 128       # dev_csi.c MAX_SUBCARRIERS
+WINDOW_US = 500000          # csi_monitor 周期
+INPUT_SCALE = 32.0          # 训练时浮点输入 = 量化特征 / 32
+TH_PRESENT = 500            # V4 阈值 (概率 x1000)
+PRESENT_LABELS = (2, 3, 4)
+ABSENT_LABEL = 1
+
+
+# ==========================================
+# 2. 特征提取 (逐位复刻 csi_mlp.c)
+# ==========================================
+def _quant(x):
+    q = np.float32(8.0) * np.log2(np.float32(1.0) + np.float32(x))
+    return 127 if q >= 127.0 else int(q)
+
+
+def _var(sq, s, n):
+    a, b = sq * n, s * s
+    return (a - b) // (n * n) if a > b else 0
+
+
+class WindowAccumulator:
+    """CSI_MLP_State_t + CSI_MLP_Window_t 的 Python 版本 (Python int 无溢出，数值与 C 的 u32/u64 一致)。"""
+
+    def __init__(self):
+        self.prev_band = None
+        self.reset()
+
+    def reset(self):
+        self.frames = self.diffs = self.diff_sum = 0
+        self.band_sum = np.zeros(BANDS, dtype=np.int64)
+        self.band_sq = np.zeros(BANDS, dtype=np.int64)
+        self.amp_min = self.amp_max = self.amp_sum = 0
+        self.rssi_sum = self.rssi_sq = 0
+
+    def push(self, amps, rssi):
+        sub_count = len(amps)
+        total = int(amps.sum())
+        if sub_count < BANDS or total < sub_count:
+            return
+        inv = ((sub_count * 100) << 16) // total
+        band_size = sub_count // BANDS
+        norm = (amps[:band_size * BANDS].astype(np.int64) * inv) >> 16
+        band = norm.reshape(BANDS, band_size).sum(axis=1) // band_size
+
+        self.band_sum += band
+        self.band_sq += band * band
+        if self.prev_band is not None:
+            self.diff_sum += int(np.abs(band - self.prev_band).sum()) // BANDS
+            self.diffs += 1
+        self.prev_band = band
+
+        if self.frames == 0 or total < self.amp_min:
+            self.amp_min = total
+        if self.frames == 0 or total > self.amp_max:
+            self.amp_max = total
+        self.amp_sum += total
+        self.rssi_sum += int(rssi)
+        self.rssi_sq += int(rssi) * int(rssi)
+        self.frames += 1
+
+    def features(self):
+        n = self.frames
+        if n < 2:
+            return None
+        out = np.zeros(N_IN, dtype=np.int8)
+        var = [_var(int(self.band_sq[b]), int(self.band_sum[b]), n) for b in range(BANDS)]
+        out[:BANDS] = [_quant(v) for v in var]
+        out[16] = _quant(self.diff_sum // self.diffs if self.diffs else 0)
+        out[17] = _quant((self.amp_max - self.amp_min) * 1000 * n // self.amp_sum if self.amp_sum else 0)
+        rs = self.rssi_sum
+        out[18] = _quant((self.rssi_sq * n - rs * rs) * 16 // (n * n) if self.rssi_sq * n > rs * rs else 0)
+        out[19] = _quant(max(var))
+        return out
+
+
+def iter_frames(cap):
+    """逐帧产出 (窗口序号, 标注, 幅值, rssi)，幅值定义与固件 csi_rx_cb 相同。"""
+    n = len(cap['ts_us'])
+    if n == 0:
+        return
+    t0 = int(cap['ts_us'][0])
+    step = 4096
+    for start in range(0, n, step):
+        rows = slice(start, min(start + step, n))
+        amp = amplitudes(cap, rows)
+        ts = np.asarray(cap['ts_us'][rows], dtype=np.int64)
+        sub = np.minimum(np.asarray(cap['iq_len'][rows], dtype=np.int64) // 2, MAX_SUBCARRIERS)
+        lab = np.asarray(cap['label'][rows])
+        rssi = np.asarray(cap['rssi'][rows])
+        for i in range(len(ts)):
+            yield (int(ts[i]) - t0) // WINDOW_US, int(lab[i]), amp[i, :sub[i]], int(rssi[i])
+
+
+def extract_windows(paths, c_lib=None):
+    """返回 DataFrame: 每个有效窗口一行 (采集目录、窗口序号、标注、20 维量化特征[、C 实现的特征与得分])。"""
+    rows = []
+    for path in paths:
+        cap = load_capture(path)
+        acc = WindowAccumulator()
+        c_acc = c_lib.new_accumulator() if c_lib else None
+        cur, labels = None, []
+
+        def close_window():
+            x = acc.features()
+            c_x, c_score = (c_lib.features(c_acc) if c_lib else (None, None))
+            acc.reset()
+            if c_lib:
+                c_lib.reset_window(c_acc)
+            if x is None or not labels:
+                return
+            vals, cnts = np.unique(labels, return_counts=True)
+            label = int(vals[np.argmax(cnts)])
+            if label != ABSENT_LABEL and label not in PRESENT_LABELS:
+                return
+            row = {'Capture': os.path.basename(os.path.normpath(path)), 'Window': cur, 'Label': label,
+                   'Present': int(label in PRESENT_LABELS)}
+            row.update({f'x{i}': int(v) for i, v in enumerate(x)})
+            if c_lib:
+                row['C_Match'] = int(c_x is not None and np.array_equal(c_x, x))
+                row['C_Score'] = c_score
+            rows.append(row)
+
+        for win, label, amps, rssi in iter_frames(cap):
+            if cur is not None and win != cur:
+                close_window()
+                labels = []
+            cur = win
+            labels.append(label)
+            acc.push(amps, rssi)
+            if c_lib:
+                c_lib.push(c_acc, amps, rssi)
+        if cur is not None:
+            close_window()
+    return pd.DataFrame(rows)
+
+
+# ==========================================
+# 3. 训练 (numpy 浮点) 与 int8 量化
+# ==========================================
+def train_float(X, y, epochs, lr, seed):
+    rng = np.random.default_rng(seed)
+    W1 = rng.normal(0, np.sqrt(2.0 / N_IN), (N_HIDDEN, N_IN))
+    b1 = np.zeros(N_HIDDEN)
+    w2 = rng.normal(0, np.sqrt(1.0 / N_HIDDEN), N_HIDDEN)
+    b2 = 0.0
+    params = [W1, b1, w2, np.array([b2])]
+    m = [np.zeros_like(p) for p in params]
+    v = [np.zeros_like(p) for p in params]
+    pos_w = (len(y) - y.sum()) / max(y.sum(), 1)   # 类别不平衡时按比例加权
+
+    for t in range(1, epochs + 1):
+        z = X @ params[0].T + params[1]
+        h = np.maximum(z, 0)
+        p = 1.0 / (1.0 + np.exp(-(h @ params[2] + params[3][0])))
+        w = np.where(y > 0, pos_w, 1.0)
+        g = w * (p - y) / len(y)
+        gz = np.outer(g, params[2]) * (z > 0)
+        grads = [gz.T @ X, gz.sum(axis=0), h.T @ g, np.array([g.sum()])]
+        for k in range(4):
+            m[k] = 0.9 * m[k] + 0.1 * grads[k]
+            v[k] = 0.999 * v[k] + 0.001 * grads[k] ** 2
+            params[k] -= lr * (m[k] / (1 - 0.9 ** t)) / (np.sqrt(v[k] / (1 - 0.999 ** t)) + 1e-8)
+    return params[0], params[1], params[2], float(params[3][0])
+
+
+def quantize(W1, b1, w2, b2, X):
+    """int8 量化: 隐层 acc = B1 + W1q·x，右移 S1 回到 [0,127]；输出 logit = (B2 + W2q·h) / OUT_SCALE。"""
+    s1 = 127.0 / max(np.abs(W1).max(), 1e-6)
+    W1q = np.clip(np.round(W1 * s1), -127, 127).astype(np.int8)
+    B1 = np.round(b1 * s1 * INPUT_SCALE).astype(np.int32)   # acc = z * s1 * INPUT_SCALE
+    acc_max = max(int(np.max(X.astype(np.int32) @ W1q.T.astype(np.int32) + B1)), 1)
+    S1 = max(0, int(np.ceil(np.log2(acc_max / 127.0))))
+    a = s1 * INPUT_SCALE / (1 << S1)    # h_q = h * a
+    s2 = 127.0 / max(np.abs(w2).max(), 1e-6)
+    W2q = np.clip(np.round(w2 * s2), -127, 127).astype(np.int8)
+    B2 = int(round(b2 * s2 * a))
+    return {'W1': W1q, 'B1': B1, 'W2': W2q, 'B2': B2, 'S1': S1, 'OUT_SCALE': float(s2 * a)}
+
+
+def infer_int(q, X):
+    """与 CSI_MLP_Infer 相同的整数推理，返回概率 x1000 (uint32 截断)。"""
+    acc = X.astype(np.int32) @ q['W1'].T.astype(np.int32) + q['B1']
+    h = np.clip(acc >> q['S1'], 0, 127)
+    out = h @ q['W2'].astype(np.int32) + q['B2']
+    logit = out.astype(np.float32) / np.float32(q['OUT_SCALE'])
+    return (np.float32(1000.0) / (np.float32(1.0) + np.exp(-logit))).astype(np.uint32)
+
+
+# ==========================================
+# 4. 头文件导出 / 读取
+# ==========================================
+def export_header(q, path, note):
+    rows = ',\n'.join('    { ' + ', '.join(f'{int(v):4d}' for v in r) + ' }' for r in q['W1'])
+    text = (
+        "#pragma once\n"
+        "// 由 Thesis_Data_Analysis/train_7_3_csi_mlp.py 自动生成，请勿手动修改\n"
+        f"// {note}\n"
+        "#include <stdint.h>\n\n"
+        "#define CSI_MLP_TRAINED     1\n"
+        f"#define CSI_MLP_S1          {q['S1']}\n"
+        f"#define CSI_MLP_OUT_SCALE   {q['OUT_SCALE']:.6f}f\n"
+        f"#define CSI_MLP_B2          {q['B2']}\n\n"
+        f"static const int8_t CSI_MLP_W1[{N_HIDDEN}][{N_IN}] = {{\n{rows}\n}};\n"
+        f"static const int32_t CSI_MLP_B1[{N_HIDDEN}] = {{ {', '.join(str(int(v)) for v in q['B1'])} }};\n"
+        f"static const int8_t CSI_MLP_W2[{N_HIDDEN}] = {{ {', '.join(str(int(v)) for v in q['W2'])} }};\n"
+    )
+    with open(path, 'w', encoding='utf-8', newline='\n') as f:
+        f.write(text)
+
+
+def load_header(path):
+    with open(path, 'r', encoding='utf-8') as f:
+        text = f.read()
+
+    def define(name):
+        return re.search(rf'#define\s+{name}\s+([-\d.]+)f?', text).group(1)
+
+    def array(name):
+        body = re.search(rf'{name}\[[^=]*=\s*\{{(.*?)\}};', text, re.S).group(1)
+        return [int(v) for v in re.findall(r'-?\d+', body)]
+
+    w1 = array('CSI_MLP_W1')
+    w1 = (w1 + [0] * (N_HIDDEN * N_IN))[:N_HIDDEN * N_IN]   # 占位头文件用 { { 0 } } 缩写
+    return {
+        'TRAINED': int(define('CSI_MLP_TRAINED')),
+        'S1': int(define('CSI_MLP_S1')),
+        'OUT_SCALE': float(define('CSI_MLP_OUT_SCALE')),
+        'B2': int(define('CSI_MLP_B2')),
+        'W1': np.array(w1, dtype=np.int8).reshape(N_HIDDEN, N_IN),
+        'B1': np.array((array('CSI_MLP_B1') + [0] * N_HIDDEN)[:N_HIDDEN], dtype=np.int32),
+        'W2': np.array((array('CSI_MLP_W2') + [0] * N_HIDDEN)[:N_HIDDEN], dtype=np.int8),
+    }
+
+
+# ==========================================
+# 5. 固件 C 实现的主机版本 (ctypes)
+# ==========================================
+class _State(ctypes.Structure):
+    _fields_ = [('prev_band', ctypes.c_uint16 * BANDS), ('has_prev', ctypes.c_bool)]
+
+
+class _Window(ctypes.Structure):
+    _fields_ = [('frames', ctypes.c_uint32), ('diffs', ctypes.c_uint32),
+                ('band_sum', ctypes.c_uint32 * BANDS), ('band_sq', ctypes.c_uint64 * BANDS),
+                ('diff_sum', ctypes.c_uint32), ('amp_min', ctypes.c_uint32), ('amp_max', ctypes.c_uint32),
+                ('amp_sum', ctypes.c_uint64), ('rssi_sum', ctypes.c_int32), ('rssi_sq', ctypes.c_uint32)]
+
+
+class CsiMlpLib:
+    """把 csi_mlp.c (连同当前 csi_mlp_weights.h) 编译为动态库，供回放数据逐帧调用。"""
+
+    def __init__(self, build_dir, header):
+        # 源文件与待检查的头文件复制到同一目录，保证 #include "csi_mlp_weights.h" 取到的是 --header
+        src = os.path.join(build_dir, 'csi_mlp.c')
+        shutil.copy(C_SOURCE, src)
+        shutil.copy(header, os.path.join(build_dir, 'csi_mlp_weights.h'))
+        so = os.path.join(build_dir, 'libcsi_mlp.so')
+        subprocess.run(['gcc', '-O2', '-shared', '-fPIC', '-std=gnu11', '-I', C_INCLUDE, src,
+                        '-o', so, '-lm'], check=True)
+        self.lib = ctypes.CDLL(so)
+        self.lib.CSI_MLP_Accumulate.argtypes = [ctypes.POINTER(_State), ctypes.POINTER(_Window),
+                                                ctypes.POINTER(ctypes.c_uint16), ctypes.c_int,
+                                                ctypes.c_uint32, ctypes.c_int8]
+        self.lib.CSI_MLP_Features.argtypes = [ctypes.POINTER(_Window), ctypes.POINTER(ctypes.c_int8)]
+        self.lib.CSI_MLP_Features.restype = ctypes.c_bool
+        self.lib.CSI_MLP_Infer.argtypes = [ctypes.POINTER(ctypes.c_int8)]
+        self.lib.CSI_MLP_Infer.restype = ctypes.c_uint32
+        self.infer_ns = []
+
+    def new_accumulator(self):
+        return _State(), _Window()
+
+    def reset_window(self, acc):
+        ctypes.memset(ctypes.byref(acc[1]), 0, ctypes.sizeof(_Window))
+
+    def push(self, acc, amps, rssi):
+        a = np.ascontiguousarray(amps, dtype=np.uint16)
+        self.lib.CSI_MLP_Accumulate(ctypes.byref(acc[0]), ctypes.byref(acc[1]),
+                                    a.ctypes.data_as(ctypes.POINTER(ctypes.c_uint16)),
+                                    len(a), int(a.sum()), rssi)
+
+    def features(self, acc):
+        x = (ctypes.c_int8 * N_IN)()
+        if not self.lib.CSI_MLP_Features(ctypes.byref(acc[1]), x):
+            return None, None
+        t0 = time.perf_counter_ns()
+        score = self.lib.CSI_MLP_Infer(x)
+        self.infer_ns.append(time.perf_counter_ns() - t0)
+        return np.frombuffer(x, dtype=np.int8).copy(), int(score)
+
+
+# ==========================================
+# 6. 评估
+# ==========================================
+def metrics(y, score):
+    pred = score > TH_PRESENT
+    tp = int(np.sum(pred & (y == 1)))
+    tn = int(np.sum(~pred & (y == 0)))
+    fp = int(np.sum(pred & (y == 0)))
+    fn = int(np.sum(~pred & (y == 1)))
+    n = max(len(y), 1)
+    return {'窗口数': len(y), '准确率': (tp + tn) / n,
+            '召回率': tp / max(tp + fn, 1), '误报率': fp / max(fp + tn, 1)}
+
+
+def _print_metrics(title, m):
+    print(f"{title}: 窗口 {m['窗口数']} | 准确率 {m['准确率'] * 100:.2f}% | "
+          f"召回率 {m['召回率'] * 100:.2f}% | 误报率 {m['误报率'] * 100:.2f}%")
+
+
+def run_train(args):
+    df = extract_windows(args.captures)
+    if df.empty or df['Present'].nunique() < 2:
+        sys.exit("错误: 需要同时包含 无人(1) 与 有人(2~4) 标注的窗口")
+    X = df[[f'x{i}' for i in range(N_IN)]].to_numpy(dtype=np.int8)
+    y = df['Present'].to_numpy()
+
+    # 每个采集按时间顺序切分，避免相邻窗口同时出现在训练集和测试集
+    test = np.zeros(len(df), dtype=bool)
+    for _, idx in df.groupby('Capture').indices.items():
+        test[idx[int(len(idx) * (1 - args.test_frac)):]] = True
+    W1, b1, w2, b2 = train_float(X[~test] / INPUT_SCALE, y[~test], args.epochs, args.lr, args.seed)
+    q = quantize(W1, b1, w2, b2, X[~test])
+
+    df['Score'] = infer_int(q, X)
+    m_train, m_test = metrics(y[~test], df['Score'][~test].to_numpy()), metrics(y[test], df['Score'][test].to_numpy())
+    _print_metrics("训练集 (int8)", m_train)
+    _print_metrics("测试集 (int8)", m_test)
+
+    note = (f"训练数据: {', '.join(sorted(df['Capture'].unique()))} | "
+            f"测试集准确率 {m_test['准确率'] * 100:.2f}% ({m_test['窗口数']} 窗口)")
+    export_header(q, args.header, note)
+    print(f"权重已导出: {os.path.normpath(args.header)}")
+
+    os.makedirs('data', exist_ok=True)
+    df['Split'] = np.where(test, 'test', 'train')
+    df.to_csv('data/parsed_csi_mlp_windows.csv', index=False, encoding='utf-8-sig')
+
+
+def run_check(args):
+    q = load_header(args.header)
+    if not q['TRAINED']:
+        print("警告: 头文件为占位权重 (CSI_MLP_TRAINED = 0)")
+
+    c_lib = None
+    if not args.no_c:
+        try:
+            build_dir = tempfile.mkdtemp(prefix='csi_mlp_')
+            c_lib = CsiMlpLib(build_dir, args.header)
+        except (OSError, subprocess.CalledProcessError) as e:
+            print(f"警告: 无法编译固件 csi_mlp.c ({e})，只运行 Python 整数推理")
+
+    df = extract_windows(args.captures, c_lib)
+    if df.empty:
+        sys.exit("错误: 没有带标注的有效窗口")
+    X = df[[f'x{i}' for i in range(N_IN)]].to_numpy(dtype=np.int8)
+    y = df['Present'].to_numpy()
+    df['Score'] = infer_int(q, X)
+    m = metrics(y, df['Score'].to_numpy())
+    _print_metrics("回放 (Python int8)", m)
+
+    ok = m['准确率'] >= args.min_acc
+    if c_lib:
+        feat_match = df['C_Match'].mean()
+        score_diff = int(np.max(np.abs(df['C_Score'].to_numpy(dtype=np.int64) - df['Score'].to_numpy(dtype=np.int64))))
+        _print_metrics("回放 (固件 C)", metrics(y, df['C_Score'].to_numpy()))
+        ns = np.array(c_lib.infer_ns)
+        print(f"C/Python 特征一致率: {feat_match * 100:.2f}% | 得分最大偏差: {score_diff} | "
+              f"主机推理耗时: 中位 {np.median(ns) / 1000:.2f} us, P99 {np.percentile(ns, 99) / 1000:.2f} us")
+        if feat_match < 1.0 or score_diff > 1:
+            print("失败: 固件 C 实现与训练脚本不一致")
+            ok = False
+
+    if m['准确率'] < args.min_acc:
+        print(f"失败: 准确率 {m['准确率'] * 100:.2f}% < 门限 {args.min_acc * 100:.2f}%")
+    print("通过" if ok else "未通过")
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='CSI int8 MLP 训练 / 导出 / 回归检查')
+    parser.add_argument('captures', nargs='+', help='csi_capture_receiver.py 生成的采集目录')
+    parser.add_argument('--header', default=HEADER_PATH, help='导出 / 检查的权重头文件')
+    parser.add_argument('--check', action='store_true', help='不训练，只用现有头文件做回放回归检查')
+    parser.add_argument('--min-acc', type=float, default=0.90, help='--check 的准确率门限')
+    parser.add_argument('--no-c', action='store_true', help='--check 时不编译固件 C 实现')
+    parser.add_argument('--test-frac', type=float, default=0.3, help='每个采集末尾用作测试集的比例')
+    parser.add_argument('--epochs', type=int, default=2000)
+    parser.add_argument('--lr', type=float, default=0.01)
+    parser.add_argument('--seed', type=int, default=0)
+    args = parser.parse_args()
+    run_check(args) if args.check else run_train(args)
@@ -2,8 +2,12 @@
 /**
   ******************************************************************************
   * @file    ControlManager.c
-  * @brief   业务逻辑控制器 (V13.1 Proximity Sync Fix)
+  * @brief   业务逻辑控制器 (V13.5 Fade Engine)
   * @note    修复无极调光结束后状态不同步的问题
+  *          输入事件改由 EventBus 按类型分发，不再由驱动回调直接调用
+  *          [新增] 环境光补偿: 顺时针画圈开启 (保持当前照度)，逆时针关闭；远程 alc 指令
+  *          [V13.4] 无极调光直接设置亮度 / 色温模型 (LightCtrl_SetLevel)，不再用浮点换算 PWM
+  *          [V13.5] 无极调光逐段渐变衔接；新增远程 fade 指令
   ******************************************************************************
   */
 #include "ControlManager.h"
@@ -13,7 +17,9 @@
 #include "SystemModel.h"
 #include "PAJ7620.h"
 #include "SystemSupport.h"
-#include <string.h>
+#include "EventBus.h"
+#include "Key.h"
+#include "Config.h"
 #include <stdlib.h> // for abs()
 
 // --- 配置参数 ---
@@ -34,6 +40,22 @@ static uint8_t  s_ProxLocked = 0;
 static uint8_t  s_ProxLastStableVal = 0;
 static uint32_t s_ProxStableTick = 0;
 
+// --- 上报协议使用的按键名 / 动作名 (按 ID / KeyEventType_t 查表) ---
+static const char* const s_KeyNames[] = { "ModeSW" };
+static const char* const s_KeyActNames[] = {
+    [KEY_EVT_CLICK]        = "click",
+    [KEY_EVT_DOUBLE_CLICK] = "double",
+    [KEY_EVT_TRIPLE_CLICK] = "triple",
+    [KEY_EVT_HOLD_START]   = "hold",
+    [KEY_EVT_HOLD_END]     = "release",
+};
+
+static void _OnEncoder(const Event_t *evt);
+static void _OnKey(const Event_t *evt);
+static void _OnGesture(const Event_t *evt);
+static void _OnProximity(const Event_t *evt);
+static void _OnProximityExit(const Event_t *evt);
+
 // --- 内部回调 ---
 static void _OnProto_Mode(uint8_t mode) {
     s_Mode = (mode == 0) ? CTRL_MODE_LOCAL : CTRL_MODE_REMOTE_UI;
@@ -41,9 +63,25 @@ static void _OnProto_Mode(uint8_t mode) {
 }
 
 static void _OnProto_Light(uint16_t warm, uint16_t cold) {
+    // 闭环期间 ESP32 对 state 上报的回显不能当作手动接管，否则 ALC 一上报就会被关掉
+    if (LightCtrl_IsALCEcho(warm, cold)) return;
     LightCtrl_SetRawPWM(warm, cold);
 }
 
+static void _OnProto_ALC(uint8_t enable, int16_t target) {
+    LightCtrl_SetALC(enable, target);
+}
+
+// [新增] {"cmd":"fade"}: cct < 0 表示保持当前色温
+static void _OnProto_Fade(uint16_t bri, int16_t cct, uint16_t ms, uint8_t ease) {
+    uint16_t c = (cct < 0) ? (uint16_t)g_SystemModel.Light.ColorTemp : (uint16_t)cct;
+    uint16_t cold = (uint16_t)((uint32_t)bri * c / 1000);
+
+    // 与 light 相同: 闭环期间忽略对 state 上报的回显
+    if (LightCtrl_IsALCEcho(bri - cold, cold)) return;
+    LightCtrl_FadeTo(bri, c, ms, ease);
+}
+
 static void Control_ToggleMode(void) {
     if (s_Mode == CTRL_MODE_LOCAL) {
         s_Mode = CTRL_MODE_REMOTE_UI;
@@ -58,11 +96,20 @@ void Control_Init(void) {
     LightCtrl_Init();
     Protocol_SetModeCallback(_OnProto_Mode);
     Protocol_SetLightCallback(_OnProto_Light);
+    Protocol_SetALCCallback(_OnProto_ALC);
+    Protocol_SetFadeCallback(_OnProto_Fade);
+
+    EventBus_Subscribe(EVT_ENCODER, _OnEncoder);
+    EventBus_Subscribe(EVT_KEY, _OnKey);
+    EventBus_Subscribe(EVT_GESTURE, _OnGesture);
+    EventBus_Subscribe(EVT_PROXIMITY, _OnProximity);
+    EventBus_Subscribe(EVT_PROXIMITY_EXIT, _OnProximityExit);
 }
 
-// --- 事件处理 ---
+// --- 事件处理 (由 EventBus_Dispatch_Task 调用) ---
 
-void Control_OnEncoder(int16_t diff) {
+static void _OnEncoder(const Event_t *evt) {
+    int16_t diff = evt->Value;
     if(s_Mode == CTRL_MODE_REMOTE_UI){
         Protocol_Report_Encoder(diff);
     }
@@ -80,42 +127,50 @@ void Control_OnEncoder(int16_t diff) {
     }
 }
 
-void Control_OnKey(const char* key_name, const char* action) {
-    Protocol_Report_Key(key_name, action);
+static void _OnKey(const Event_t *evt) {
+    KeyEventType_t type = (KeyEventType_t)evt->Value;
+    const char* action = (type < sizeof(s_KeyActNames) / sizeof(s_KeyActNames[0])) ? s_KeyActNames[type] : NULL;
+
+    if (evt->Src >= sizeof(s_KeyNames) / sizeof(s_KeyNames[0]) || action == NULL) return;
+    Protocol_Report_Key(s_KeyNames[evt->Src], action);
 
-    if (strcmp(key_name, "ModeSW") == 0) 
+    if (evt->Src == KEY_ID_MODE) 
     {
-        if (strcmp(action, "hold") == 0) {
-            s_IsLongPressing = 1;
-            USART_DMA_Printf("[Ctrl] Long Press START (ColorTemp Mode)\r\n");
-        }
-        else if (strcmp(action, "release") == 0) {
-            s_IsLongPressing = 0;
-            g_SystemModel.Light.Focus = FOCUS_BRIGHTNESS;
-            USART_DMA_Printf("[Ctrl] Long Press END\r\n");
-        }
-        else if (strcmp(action, "triple") == 0) {
-            Control_ToggleMode();
-        }
-        else if (strcmp(action, "click") == 0) {
-            if (g_SystemModel.Light.Focus == FOCUS_BRIGHTNESS) {
-                g_SystemModel.Light.Focus = FOCUS_COLOR_TEMP;
-                USART_DMA_Printf("[Ctrl] Focus -> CCT\r\n");
-            } else {
+        switch (type) {
+            case KEY_EVT_HOLD_START:
+                s_IsLongPressing = 1;
+                USART_DMA_Printf("[Ctrl] Long Press START (ColorTemp Mode)\r\n");
+                break;
+            case KEY_EVT_HOLD_END:
+                s_IsLongPressing = 0;
                 g_SystemModel.Light.Focus = FOCUS_BRIGHTNESS;
-                USART_DMA_Printf("[Ctrl] Focus -> Bri\r\n");
-            }
-        }
-        else if (strcmp(action, "double") == 0) {
-            if (s_Mode == CTRL_MODE_LOCAL) {
-                LightCtrl_SetRawPWM(250, 250); 
-                USART_DMA_Printf("[Ctrl] Reset (Double Click)\r\n");
-            }
+                USART_DMA_Printf("[Ctrl] Long Press END (%lu ms)\r\n", (unsigned long)evt->Param);
+                break;
+            case KEY_EVT_TRIPLE_CLICK:
+                Control_ToggleMode();
+                break;
+            case KEY_EVT_CLICK:
+                if (g_SystemModel.Light.Focus == FOCUS_BRIGHTNESS) {
+                    g_SystemModel.Light.Focus = FOCUS_COLOR_TEMP;
+                    USART_DMA_Printf("[Ctrl] Focus -> CCT\r\n");
+                } else {
+                    g_SystemModel.Light.Focus = FOCUS_BRIGHTNESS;
+                    USART_DMA_Printf("[Ctrl] Focus -> Bri\r\n");
+                }
+                break;
+            case KEY_EVT_DOUBLE_CLICK:
+                if (s_Mode == CTRL_MODE_LOCAL) {
+                    LightCtrl_SetRawPWM(250, 250); 
+                    USART_DMA_Printf("[Ctrl] Reset (Double Click)\r\n");
+                }
+                break;
+            default: break;
         }
     }
 }
 
-void Control_OnGesture(uint8_t gesture) {
+static void _OnGesture(const Event_t *evt) {
+    uint8_t gesture = (uint8_t)evt->Value;
     Protocol_Report_Gesture(gesture);
 
     if (s_Mode == CTRL_MODE_LOCAL) {
@@ -142,12 +197,19 @@ void Control_OnGesture(uint8_t gesture) {
                 LightCtrl_SetRawPWM(0, 0);
                 USART_DMA_Printf("[Ctrl] Local: OFF\r\n");
                 break;
+            case PAJ7620_GESTURE_CLOCKWISE:
+                LightCtrl_SetALC(1, -1);
+                break;
+            case PAJ7620_GESTURE_COUNTER_CW:
+                LightCtrl_SetALC(0, 0);
+                break;
             default: break;
         }
     }
 }
 
-void Control_OnProximity(uint8_t brightness) {
+static void _OnProximity(const Event_t *evt) {
+    uint8_t brightness = (uint8_t)evt->Value;
     if (s_Mode != CTRL_MODE_LOCAL) return;
     if (s_ProxLocked) return;
 
@@ -176,27 +238,22 @@ void Control_OnProximity(uint8_t brightness) {
     if (System_GetTick() - last_update_tick > 50) {
         last_update_tick = System_GetTick();
 
+        // 只算出目标，模型由 LightCtrl_FadeTo 在输出时更新
+        uint16_t bri = (uint16_t)g_SystemModel.Light.Brightness;
+        uint16_t cct = (uint16_t)g_SystemModel.Light.ColorTemp;
         if (g_SystemModel.Light.Focus == FOCUS_BRIGHTNESS) {
-            g_SystemModel.Light.Brightness = target_val;
+            bri = (uint16_t)target_val;
         } else {
-            g_SystemModel.Light.ColorTemp = target_val;
+            cct = (uint16_t)target_val;
         }
 
-        uint16_t bri = g_SystemModel.Light.Brightness;
-        uint16_t cct = g_SystemModel.Light.ColorTemp;
-        
-        float bri_factor = bri / 1000.0f;
-        float cct_factor = cct / 1000.0f;
-        
-        uint16_t warm = (uint16_t)((1.0f - cct_factor) * 1000 * bri_factor);
-        uint16_t cold = (uint16_t)(cct_factor * 1000 * bri_factor);
-        
-        LightCtrl_SetRawPWM(warm, cold);
+        LightCtrl_FadeTo(bri, cct, FADE_PROX_MS, LED_EASE_LINEAR);
     }
 }
 
 // [新增] 退出无极调光时的处理
-void Control_OnProximityExit(void) {
+static void _OnProximityExit(const Event_t *evt) {
+    (void)evt;
     if (s_Mode != CTRL_MODE_LOCAL) return;
     
     // 解除锁定状态
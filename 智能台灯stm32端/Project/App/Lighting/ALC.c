@@ -0,0 +1,50 @@
+/**
+  ******************************************************************************
+  * @file    ALC.c
+  * @brief   环境光补偿 PI 控制器实现
+  ******************************************************************************
+  */
+#include "ALC.h"
+
+static int32_t _Clamp32(int32_t val, int32_t min, int32_t max)
+{
+    if (val < min) return min;
+    if (val > max) return max;
+    return val;
+}
+
+void ALC_Init(ALC_t *c, int16_t kp_q8, int16_t ki_q8, int16_t max_step,
+              int16_t deadband, int16_t out_min, int16_t out_max)
+{
+    c->Kp_Q8 = kp_q8;
+    c->Ki_Q8 = ki_q8;
+    c->MaxStep = max_step;
+    c->Deadband = deadband;
+    c->OutMin = out_min;
+    c->OutMax = out_max;
+    ALC_Reset(c, out_min);
+}
+
+void ALC_Reset(ALC_t *c, int16_t out)
+{
+    c->OutQ8 = _Clamp32(out, c->OutMin, c->OutMax) * 256;
+    c->PrevErr = 0;
+}
+
+int16_t ALC_Step(ALC_t *c, int16_t target, int16_t meas)
+{
+    int32_t e = (int32_t)target - meas;
+
+    // 死区内视为到位；死区外减去死区宽度，误差在死区边缘连续变化，不产生突跳
+    if (e > c->Deadband)       e -= c->Deadband;
+    else if (e < -c->Deadband) e += c->Deadband;
+    else                       e = 0;
+
+    int32_t du = (int32_t)c->Kp_Q8 * (e - c->PrevErr) + (int32_t)c->Ki_Q8 * e;
+    du = _Clamp32(du, -(int32_t)c->MaxStep * 256, (int32_t)c->MaxStep * 256);
+
+    c->OutQ8 = _Clamp32(c->OutQ8 + du, (int32_t)c->OutMin * 256, (int32_t)c->OutMax * 256);
+    c->PrevErr = (int16_t)e;
+
+    return (int16_t)((c->OutQ8 + 128) >> 8);
+}
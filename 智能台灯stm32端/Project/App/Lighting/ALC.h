@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file    ALC.h
+  * @brief   环境光补偿 (Ambient Light Compensation) 的 PI 控制器
+  * @note    桌面照度 = 环境光 + 台灯贡献，LDR 测到的是两者之和。控制器按固定周期
+  *          比较目标值与 LDR 滤波值，调整台灯亮度使总照度保持在目标附近:
+  *          白天环境光足够时自动调暗 (日光补偿节能)，天黑后再调亮。
+  *
+  *          - 增量式 PI: dU = Kp * (e - e_prev) + Ki * e，输出本身就是积分器，
+  *            限幅时不会继续累积 (天然抗积分饱和)
+  *          - 死区: |e| <= Deadband 视为到位，避免 LDR 噪声引起输出来回抖动
+  *          - 限速: 每周期 |dU| <= MaxStep，亮度变化平缓，人眼察觉不到跳变
+  *          - 全部为整数运算 (增益 Q8，输出内部保留 8 位小数)
+  *
+  *          本文件不依赖硬件，可在主机上编译测试 (Thesis_Data_Analysis/host/alc_host.c)。
+  ******************************************************************************
+  */
+#ifndef __ALC_H
+#define __ALC_H
+
+#include <stdint.h>
+
+/**
+  * @brief 控制器参数与状态
+  */
+typedef struct {
+    int16_t Kp_Q8;          /*!< 比例增益 x256 */
+    int16_t Ki_Q8;          /*!< 积分增益 x256 (每周期) */
+    int16_t MaxStep;        /*!< 每周期输出最大变化量 */
+    int16_t Deadband;       /*!< 误差死区 */
+    int16_t OutMin;         /*!< 输出下限 */
+    int16_t OutMax;         /*!< 输出上限 */
+    int32_t OutQ8;          /*!< 当前输出 x256 */
+    int16_t PrevErr;        /*!< 上一周期的误差 (已扣除死区) */
+} ALC_t;
+
+/**
+  * @brief  设置控制参数，输出清零
+  */
+void ALC_Init(ALC_t *c, int16_t kp_q8, int16_t ki_q8, int16_t max_step,
+              int16_t deadband, int16_t out_min, int16_t out_max);
+
+/**
+  * @brief  无扰切换: 以 out 作为当前输出重新开始 (进入闭环 / 外部改动亮度后调用)
+  */
+void ALC_Reset(ALC_t *c, int16_t out);
+
+/**
+  * @brief  执行一个控制周期
+  * @param  target: 目标测量值
+  * @param  meas:   当前测量值 (与 target 同一量纲)
+  * @retval 新的输出 (已限幅)
+  */
+int16_t ALC_Step(ALC_t *c, int16_t target, int16_t meas);
+
+#endif
@@ -1,23 +1,52 @@
 /**
   ******************************************************************************
   * @file    LightCtrl.c
-  * @brief   灯光控制业务逻辑 (V6.3 Force Report Support)
+  * @brief   灯光控制业务逻辑 (V6.6 Fade Engine)
+  * @note    [V6.6] 远程设置 / 无极调光改为渐变 (LED_FadeTo)，模型立即更新为目标值，
+  *          过渡由 LED 驱动的 DMA 逐 PWM 周期输出；编码器等本地操作仍立即生效并打断渐变。
+  * @note    [V6.5] 亮度 / 色温经 LED_Mix (CIE 1931 查找表 + 恒光通量混光) 换算为
+  *          Q4 占空比，由 LED 驱动抖动输出；全程整数运算。上报的 warm / cold 仍为
+  *          0~1000 的模型分量 (warm + cold = 亮度)，与 ESP32 协议保持一致。
+  * @note    [新增] 环境光补偿 (ALC): 以 LDR 滤波值为反馈，PI 控制器自动调整亮度，
+  *          使桌面照度保持在目标值附近 (白天自动调暗节能)。闭环在本地运行，不依赖 ESP32。
+  *          闭环期间: 编码器 / 手势调亮度改为调整目标值；其余直接设置 PWM 的操作
+  *          (远程 light 指令、双击复位、关灯、无极调光) 视为手动接管，自动退出闭环。
   ******************************************************************************
   */
 #include "LightCtrl.h"
 #include "LED.h"
+#include "LED_Mix.h"
+#include "LDR.h"
+#include "ALC.h"
+#include "Config.h"
 #include "Protocol.h"
+#include "USART_DMA.h"
 #include "SystemModel.h" // 引用全局模型
 #include "SystemSupport.h"
+#include <stdlib.h> // for abs()
 
 // --- 内部变量 ---
 static uint8_t s_IsDirty = 0;
 static uint32_t s_LastChangeTime = 0;
 
-// 缓存当前的 PWM 值，用于上报
+// 缓存当前的暖 / 冷分量 (0~1000 模型量纲)，用于上报
 static uint16_t s_CurrWarm = 0;
 static uint16_t s_CurrCold = 0;
 
+// 最近一次交给 LED 驱动的亮度 / 色温 (判断新目标是否与输出相同)
+static uint16_t s_OutBri = 0;
+static uint16_t s_OutCct = 0;
+
+// 最近一次上报的 PWM 值 (ALC 回显判定)
+static uint16_t s_RepWarm = 0;
+static uint16_t s_RepCold = 0;
+
+// --- [新增] 环境光补偿 ---
+static ALC_t s_Alc;
+static uint8_t s_AlcOn = 0;
+static int16_t s_AlcTarget = 0;     // 目标 LDR 读数 (0-1000，与 LDR_GetLuxPercentage 同量纲)
+static uint32_t s_AlcNextTick = 0;
+
 // --- 辅助函数 ---
 static int16_t _Clamp(int16_t val, int16_t min, int16_t max) {
     if (val < min) return min;
@@ -25,33 +54,46 @@ static int16_t _Clamp(int16_t val, int16_t min, int16_t max) {
     return val;
 }
 
-// 将模型数据应用到硬件
-static void _ApplyModelToHardware(void) {
-    uint16_t warm, cold;
-    float bri_factor = g_SystemModel.Light.Brightness / 1000.0f;
-    float cct_factor = g_SystemModel.Light.ColorTemp / 1000.0f;
+// 将模型数据应用到硬件 (fade_ms = 0 时立即生效)
+static void _ApplyModelToHardware(uint32_t fade_ms, uint8_t ease) {
+    uint16_t bri = (uint16_t)g_SystemModel.Light.Brightness;
+    uint16_t cct = (uint16_t)g_SystemModel.Light.ColorTemp;
 
-    warm = (uint16_t)((1.0f - cct_factor) * 1000 * bri_factor);
-    cold = (uint16_t)(cct_factor * 1000 * bri_factor);
-
-    // 驱动硬件
-    LED_SetDualColor(warm, cold);
+    // 驱动硬件: 感知亮度 -> 线性光输出 -> 按光通量分配到两路
+    LED_FadeTo(bri, cct, fade_ms, ease);
+    s_OutBri = bri;
+    s_OutCct = cct;
     
-    // 更新缓存用于上报
-    s_CurrWarm = warm;
-    s_CurrCold = cold;
+    // 更新缓存用于上报 (渐变期间即为目标值)
+    s_CurrCold = (uint16_t)((uint32_t)bri * cct / 1000);
+    s_CurrWarm = bri - s_CurrCold;
+}
+
+static void _Report(void) {
+    Protocol_Report_State(s_CurrWarm, s_CurrCold);
+    s_RepWarm = s_CurrWarm;
+    s_RepCold = s_CurrCold;
+    s_IsDirty = 0;
 }
 
 void LightCtrl_Init(void) {
     LED_Init();
-    _ApplyModelToHardware();
+    LED_Mix_Init(LED_WARM_FLUX, LED_COLD_FLUX);
+    ALC_Init(&s_Alc, ALC_KP_Q8, ALC_KI_Q8, ALC_MAX_STEP, ALC_DEADBAND, ALC_MIN_BRI, 1000);
+    _ApplyModelToHardware(0, LED_EASE_LINEAR);
 }
 
 void LightCtrl_AdjustBrightness(int16_t delta) {
+    // 闭环期间调节的是目标照度，亮度由控制器平滑跟随
+    if (s_AlcOn) {
+        s_AlcTarget = _Clamp(s_AlcTarget + delta, 0, 1000);
+        return;
+    }
+
     g_SystemModel.Light.Brightness += delta;
     g_SystemModel.Light.Brightness = _Clamp(g_SystemModel.Light.Brightness, 0, 1000);
     
-    _ApplyModelToHardware();
+    _ApplyModelToHardware(0, LED_EASE_LINEAR);
     
     s_IsDirty = 1;
     s_LastChangeTime = System_GetTick();
@@ -61,46 +103,121 @@ void LightCtrl_AdjustColorTemp(int16_t delta) {
     g_SystemModel.Light.ColorTemp += delta;
     g_SystemModel.Light.ColorTemp = _Clamp(g_SystemModel.Light.ColorTemp, 0, 1000);
     
-    _ApplyModelToHardware();
+    _ApplyModelToHardware(0, LED_EASE_LINEAR);
     
     s_IsDirty = 1;
     s_LastChangeTime = System_GetTick();
 }
 
+// [新增] 直接设置亮度 / 色温 (手动接管，退出闭环，不触发上报)
+void LightCtrl_SetLevel(uint16_t bri, uint16_t cct) {
+    LightCtrl_FadeTo(bri, cct, 0, LED_EASE_LINEAR);
+}
+
+// [新增] 渐变到目标亮度 / 色温 (手动接管，退出闭环，不触发上报)
+void LightCtrl_FadeTo(uint16_t bri, uint16_t cct, uint32_t ms, uint8_t ease) {
+    LightCtrl_SetALC(0, 0);
+
+    if (ms > FADE_MAX_MS) ms = FADE_MAX_MS;
+    if (ease > LED_EASE_IN_OUT) ease = LED_EASE_LINEAR;
+    if (bri > 1000) bri = 1000;
+    if (cct > 1000) cct = 1000;
+
+    // 目标与 LED 当前输出相同 (如 ESP32 对 state 上报的回显)，无需重新渐变
+    // 与最近一次输出比较而不是与模型比较: 调用方可能已先把目标写进模型
+    if (!LED_IsFading() && bri == s_OutBri && cct == s_OutCct) {
+        return;
+    }
+
+    g_SystemModel.Light.Brightness = (int16_t)bri;
+    g_SystemModel.Light.ColorTemp = (int16_t)cct;
+    _ApplyModelToHardware(ms, ease);
+
+    s_IsDirty = 0;
+}
+
 // 远程控制接口
 void LightCtrl_SetRawPWM(uint16_t warm, uint16_t cold) {
-    // 1. 直接驱动硬件
-    LED_SetDualColor(warm, cold);
-    s_CurrWarm = warm;
-    s_CurrCold = cold;
-    
-    // 2. 反向更新模型 (近似值)，确保 UI 显示正确
+    // 1. 暖 / 冷分量换算回模型 (亮度 = 两路之和，色温 = 冷光占比)
     uint32_t total = warm + cold;
-    if (total > 1000) total = 1000;
-    
-    g_SystemModel.Light.Brightness = (int16_t)total;
-    
+    uint16_t cct = (uint16_t)g_SystemModel.Light.ColorTemp;
     if (total > 0) {
-        g_SystemModel.Light.ColorTemp = (int16_t)((cold * 1000) / total);
+        cct = (uint16_t)((cold * 1000) / total);
     }
-    
-    // 远程设置通常不需要回传 State，避免死循环
-    s_IsDirty = 0; 
+    if (total > 1000) total = 1000;
+
+    // 2. 短渐变过渡 (避免跳变)；远程设置通常不需要回传 State，避免死循环
+    LightCtrl_FadeTo((uint16_t)total, cct, FADE_RAW_MS, LED_EASE_OUT);
 }
 
 uint16_t LightCtrl_GetBrightness(void) { return g_SystemModel.Light.Brightness; }
 uint16_t LightCtrl_GetColorTemp(void) { return g_SystemModel.Light.ColorTemp; }
 
+/* ============================================================
+ *                 [新增] 环境光补偿 (ALC)
+ * ============================================================ */
+
+void LightCtrl_SetALC(uint8_t enable, int16_t target) {
+    if (!enable) {
+        if (s_AlcOn) {
+            s_AlcOn = 0;
+            USART_DMA_Printf("[ALC] OFF (Bri:%d)\r\n", g_SystemModel.Light.Brightness);
+        }
+        return;
+    }
+
+    // 目标 < 0: 保持当前照度
+    if (target < 0) target = (int16_t)LDR_GetLuxPercentage();
+    s_AlcTarget = _Clamp(target, 0, 1000);
+
+    // 从当前亮度无扰切入 (已在闭环中时只更新目标)
+    if (!s_AlcOn) {
+        ALC_Reset(&s_Alc, g_SystemModel.Light.Brightness);
+        s_AlcNextTick = System_GetTick();
+        s_AlcOn = 1;
+    }
+    USART_DMA_Printf("[ALC] ON (Target:%d, Lux:%d)\r\n", s_AlcTarget, LDR_GetLuxPercentage());
+}
+
+uint8_t LightCtrl_IsALC(void) { return s_AlcOn; }
+int16_t LightCtrl_GetALCTarget(void) { return s_AlcTarget; }
+
+uint8_t LightCtrl_IsALCEcho(uint16_t warm, uint16_t cold) {
+    // ESP32 收到 state 后按百分比取整再下发 light，与上报值相差在取整误差以内
+    return s_AlcOn &&
+           abs((int)warm - (int)s_RepWarm) <= ALC_ECHO_TOL &&
+           abs((int)cold - (int)s_RepCold) <= ALC_ECHO_TOL;
+}
+
+static void _ALC_Step(void) {
+    uint32_t now = System_GetTick();
+    if ((int32_t)(now - s_AlcNextTick) < 0) return;
+
+    // 固定节拍；落后超过一个周期 (任务被长时间阻塞) 时重新对齐，不补跑
+    s_AlcNextTick += ALC_PERIOD_MS;
+    if ((int32_t)(now - s_AlcNextTick) >= 0) s_AlcNextTick = now + ALC_PERIOD_MS;
+
+    int16_t bri = ALC_Step(&s_Alc, s_AlcTarget, (int16_t)LDR_GetLuxPercentage());
+    if (bri != g_SystemModel.Light.Brightness) {
+        g_SystemModel.Light.Brightness = bri;
+        _ApplyModelToHardware(0, LED_EASE_LINEAR);
+
+        // 连续调光期间不上报，稳定 200ms 后由节流上报同步一次
+        s_IsDirty = 1;
+        s_LastChangeTime = now;
+    }
+}
+
 void LightCtrl_Task(void) {
+    if (s_AlcOn) _ALC_Step();
+
     // 节流上报：上报 Warm/Cold 值
     if (s_IsDirty && (System_GetTick() - s_LastChangeTime > 200)) {
-        Protocol_Report_State(s_CurrWarm, s_CurrCold);
-        s_IsDirty = 0;
+        _Report();
     }
 }
 
 // [新增] 强制上报当前灯光状态
 void LightCtrl_ForceReport(void) {
-    Protocol_Report_State(s_CurrWarm, s_CurrCold);
-    s_IsDirty = 0; // 上报后清除脏标记，避免重复上报
+    _Report(); // 上报后清除脏标记，避免重复上报
 }
@@ -2,6 +2,7 @@
 #define __LIGHT_CTRL_H
 
 #include <stdint.h>
+#include "LED_Fade.h" // LED_Ease_t
 
 // --- 接口 ---
 void LightCtrl_Init(void);
@@ -12,17 +13,34 @@ void LightCtrl_AdjustBrightness(int16_t delta);
 void LightCtrl_AdjustColorTemp(int16_t delta);
 
 // 远程控制 (绝对设置)
-// 直接设置 PWM 占空比 (0-1000)
+// 设置暖 / 冷分量 (0-1000，两路之和为亮度)，经 FADE_RAW_MS 短渐变输出，同时退出环境光补偿
 void LightCtrl_SetRawPWM(uint16_t warm, uint16_t cold);
 
+// [新增] 直接设置亮度 / 色温 (0-1000)，同时退出环境光补偿，不触发上报
+void LightCtrl_SetLevel(uint16_t bri, uint16_t cct);
+
+// [新增] 渐变到目标亮度 / 色温，ms = 0 时立即设置；ease 见 LED_Ease_t
+// 模型立即更新为目标值，中途再次调用从当前输出继续；同时退出环境光补偿，不触发上报
+void LightCtrl_FadeTo(uint16_t bri, uint16_t cct, uint32_t ms, uint8_t ease);
+
 // 获取当前状态 (用于上报)
 uint16_t LightCtrl_GetBrightness(void);
 uint16_t LightCtrl_GetColorTemp(void);
 
-// 周期性任务 (处理节流上报)
+// 周期性任务 (ALC 闭环 + 节流上报)
 void LightCtrl_Task(void);
 
 // [新增] 强制上报当前灯光状态 (用于无极调光结束时同步)
 void LightCtrl_ForceReport(void);
 
+// [新增] 环境光补偿 (ALC): 按 LDR 读数闭环调节亮度，保持桌面照度恒定
+// target: 目标 LDR 读数 (0-1000)，< 0 表示保持当前照度；enable = 0 时忽略 target
+// 闭环期间 AdjustBrightness 调整的是目标值，SetRawPWM 会退出闭环
+void LightCtrl_SetALC(uint8_t enable, int16_t target);
+uint8_t LightCtrl_IsALC(void);
+int16_t LightCtrl_GetALCTarget(void);
+
+// [新增] 闭环期间收到的 light 指令是否只是 ESP32 对上报状态的回显 (是则应忽略)
+uint8_t LightCtrl_IsALCEcho(uint16_t warm, uint16_t cold);
+
 #endif
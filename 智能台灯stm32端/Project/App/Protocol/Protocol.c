@@ -3,6 +3,7 @@
 #include "Protocol_CRC.h" // [新增] 引入 CRC 模块
 #include "USART_DMA.h"
 #include "cJSON.h"
+#include "Config.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>       // [新增] 用于 strtol
@@ -15,6 +16,8 @@ static uint16_t s_AppRxLen = 0;
 // --- 回调函数 ---
 static Proto_ModeCallback_t s_ModeCb = NULL;
 static Proto_LightCallback_t s_LightCb = NULL;
+static Proto_ALCCallback_t s_ALCCb = NULL;
+static Proto_FadeCallback_t s_FadeCb = NULL;
 
 // --- 内部辅助：检查 QoS 水位线 ---
 static int _CheckQoS(void)
@@ -39,7 +42,24 @@ static void _Send_With_CRC(const char* json_str)
     USART_DMA_Send((uint8_t*)out_buf, strlen(out_buf));
 }
 
+// --- 内部辅助：读取整数字段并检查范围 ---
+// 返回 1: 有效 (写入 *out)；0: 字段不存在；-1: 不是数字或超出 [min, max]
+// 用 valuedouble 比较，避免 valueint 对超大 / 负数饱和或截断后被强转成合法值
+static int _GetIntField(cJSON *root, const char *key, int32_t min, int32_t max, int32_t *out)
+{
+    cJSON *item = cJSON_GetObjectItem(root, key);
+    if (item == NULL) return 0;
+    if (!cJSON_IsNumber(item) || item->valuedouble < min || item->valuedouble > max)
+    {
+        USART_DMA_Printf("[Proto] Bad field \"%s\", drop.\r\n", key);
+        return -1;
+    }
+    *out = item->valueint;
+    return 1;
+}
+
 // --- 内部辅助：解析 JSON 指令 ---
+// 必填字段缺失或任一字段越界时整条指令丢弃，不调用回调
 static void _ParseJsonCmd(char* json_str)
 {
     cJSON *root = cJSON_Parse(json_str);
@@ -48,24 +68,46 @@ static void _ParseJsonCmd(char* json_str)
         cJSON *cmd = cJSON_GetObjectItem(root, "cmd");
         if (cJSON_IsString(cmd))
         {
-            // 1. 模式切换指令
+            // 1. 模式切换指令: {"cmd":"mode","val":0|1}
             if (strcmp(cmd->valuestring, "mode") == 0)
             {
-                cJSON *val = cJSON_GetObjectItem(root, "val");
-                if (cJSON_IsNumber(val) && s_ModeCb)
+                int32_t val;
+                if (_GetIntField(root, "val", 0, 1, &val) == 1 && s_ModeCb)
                 {
-                    s_ModeCb((uint8_t)val->valueint);
+                    s_ModeCb((uint8_t)val);
                 }
             }
-            // 2. 灯光控制指令
+            // 2. 灯光控制指令: {"cmd":"light","warm":0~1000,"cold":0~1000}
             else if (strcmp(cmd->valuestring, "light") == 0)
             {
-                cJSON *warm = cJSON_GetObjectItem(root, "warm");
-                cJSON *cold = cJSON_GetObjectItem(root, "cold");
-                
-                if (cJSON_IsNumber(warm) && cJSON_IsNumber(cold) && s_LightCb)
+                int32_t warm, cold;
+                if (_GetIntField(root, "warm", 0, PROTOCOL_LEVEL_MAX, &warm) == 1 &&
+                    _GetIntField(root, "cold", 0, PROTOCOL_LEVEL_MAX, &cold) == 1 && s_LightCb)
+                {
+                    s_LightCb((uint16_t)warm, (uint16_t)cold);
+                }
+            }
+            // 3. [新增] 环境光补偿指令: {"cmd":"alc","en":1,"target":600}，target 可省略 (保持当前照度)
+            else if (strcmp(cmd->valuestring, "alc") == 0)
+            {
+                int32_t en, target = -1;
+                if (_GetIntField(root, "en", 0, 1, &en) == 1 &&
+                    _GetIntField(root, "target", 0, PROTOCOL_LEVEL_MAX, &target) >= 0 && s_ALCCb)
+                {
+                    s_ALCCb((uint8_t)en, (int16_t)target);
+                }
+            }
+            // 4. [新增] 渐变指令: {"cmd":"fade","bri":800,"cct":500,"ms":400,"ease":3}
+            //    cct 可省略 (保持当前色温)，ease 可省略 (默认 3 = 缓入缓出)
+            else if (strcmp(cmd->valuestring, "fade") == 0)
+            {
+                int32_t bri, ms, cct = -1, ease = 3;
+                if (_GetIntField(root, "bri", 0, PROTOCOL_LEVEL_MAX, &bri) == 1 &&
+                    _GetIntField(root, "ms", 0, FADE_MAX_MS, &ms) == 1 &&
+                    _GetIntField(root, "cct", 0, PROTOCOL_LEVEL_MAX, &cct) >= 0 &&
+                    _GetIntField(root, "ease", 0, PROTOCOL_EASE_MAX, &ease) >= 0 && s_FadeCb)
                 {
-                    s_LightCb((uint16_t)warm->valueint, (uint16_t)cold->valueint);
+                    s_FadeCb((uint16_t)bri, (int16_t)cct, (uint16_t)ms, (uint8_t)ease);
                 }
             }
         }
@@ -174,6 +216,8 @@ void Protocol_Process(void)
 
 void Protocol_SetModeCallback(Proto_ModeCallback_t cb) { s_ModeCb = cb; }
 void Protocol_SetLightCallback(Proto_LightCallback_t cb) { s_LightCb = cb; }
+void Protocol_SetALCCallback(Proto_ALCCallback_t cb) { s_ALCCb = cb; }
+void Protocol_SetFadeCallback(Proto_FadeCallback_t cb) { s_FadeCb = cb; }
 
 /* ============================================================
  * 发送接口实现 (重构：先组装 JSON，再调用 _Send_With_CRC)
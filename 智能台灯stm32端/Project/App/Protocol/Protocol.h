@@ -7,9 +7,16 @@
 /** @brief QoS 水位线阈值 (百分比) */
 #define PROTOCOL_QOS_THRESHOLD  70
 
+/** @brief 下行指令的取值范围 (任一字段越界或类型不符，整条指令丢弃) */
+#define PROTOCOL_LEVEL_MAX      1000    // warm / cold / bri / cct / alc target
+#define PROTOCOL_EASE_MAX       3       // 与 LED_EASE_IN_OUT 一致
+// fade 的 ms 上限为 Config.h 中的 FADE_MAX_MS
+
 /* --- 回调函数类型定义 --- */
 typedef void (*Proto_ModeCallback_t)(uint8_t mode);
 typedef void (*Proto_LightCallback_t)(uint16_t warm, uint16_t cold);
+typedef void (*Proto_ALCCallback_t)(uint8_t enable, int16_t target); // [新增] target < 0: 保持当前照度
+typedef void (*Proto_FadeCallback_t)(uint16_t bri, int16_t cct, uint16_t ms, uint8_t ease); // [新增] cct < 0: 保持当前色温
 
 /* --- 基础接口 --- */
 void Protocol_Init(void);
@@ -23,6 +30,8 @@ void Protocol_Process(void);
 /* --- 回调注册 --- */
 void Protocol_SetModeCallback(Proto_ModeCallback_t cb);
 void Protocol_SetLightCallback(Proto_LightCallback_t cb);
+void Protocol_SetALCCallback(Proto_ALCCallback_t cb);
+void Protocol_SetFadeCallback(Proto_FadeCallback_t cb);
 
 /* --- 发送接口 (高优先级) --- */
 void Protocol_Report_Encoder(int16_t diff);
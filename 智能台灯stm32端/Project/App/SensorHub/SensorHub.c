@@ -1,6 +1,6 @@
 /**
   * @file    SensorHub.c
-  * @brief   传感器中心 (V6.5 Data Sync Fix)
+  * @brief   传感器中心 (V6.6 DHT11 Input Capture)
   */
 #include "SensorHub.h"
 #include "DHT11.h"
@@ -8,6 +8,7 @@
 #include "Protocol.h"
 #include "USART_DMA.h"
 #include "SystemModel.h"  // <--- 新增：用于更新本地模型
+#include "Scheduler.h"
 
 void SensorHub_Init(void)
 {
@@ -27,29 +28,59 @@ void SensorHub_Init(void)
     LDR_Init(); 
 }
 
-void SensorHub_Task(void)
+/**
+  * @brief  传感器任务 (分步执行，由调度器驱动)
+  * @note   第 1 步: 读光强并发出 DHT11 起始信号，让出 CPU 20ms
+  *         第 2 步: 释放总线，TIM2 输入捕获在后台接收 40 位数据，让出 CPU 8ms
+  *         第 3 步: 解码捕获结果，更新模型并上报
+  */
+uint32_t SensorHub_Task(void)
 {
+    static uint8_t s_Step = 0;
+    static uint16_t s_LuxPercent = 0;
     uint8_t temp_int, humi_int;
-    uint16_t lux_percent = 0;
+    uint8_t ret;
     
-    // 1. 读取光强
-    lux_percent = LDR_GetLuxPercentage();
+    if (s_Step == 0)
+    {
+        // 1. 读取光强
+        s_LuxPercent = LDR_GetLuxPercentage();
+        
+        // 2. 发出温湿度起始信号，等待期间其他任务照常运行
+        DHT11_Start();
+        s_Step = 1;
+        return DHT11_START_HOLD_MS;
+    }
+    if (s_Step == 1)
+    {
+        DHT11_Begin_Capture();
+        s_Step = 2;
+        return DHT11_FRAME_MS;
+    }
+    s_Step = 0;
     
-    // 2. 读取温湿度
-    if (DHT11_Read_Data(&temp_int, &humi_int) == 0)
+    // 3. 读取温湿度 (此时一帧早已收完，仍未完成说明设备无应答)
+    ret = DHT11_Get_Result(&temp_int, &humi_int);
+    if (ret == DHT11_BUSY)
+    {
+        DHT11_Abort();
+        ret = DHT11_ERROR;
+    }
+    if (ret == DHT11_OK)
     {
         // 【关键修复】更新本地数据模型 (供 OLED 显示)
         g_SystemModel.Sensor.Temperature = (float)temp_int;
         g_SystemModel.Sensor.Humidity = (float)humi_int;
-        g_SystemModel.Sensor.Lux = (float)lux_percent;
+        g_SystemModel.Sensor.Lux = (float)s_LuxPercent;
 
         // 上报给 ESP32
-        Protocol_Report_Env((int8_t)temp_int, humi_int, lux_percent);
+        Protocol_Report_Env((int8_t)temp_int, humi_int, s_LuxPercent);
     }
     else
     {
         // 读取失败处理
         g_SystemModel.Sensor.Temperature = -99.0f; // 错误码
-        USART_DMA_Printf("[Sensor] DHT11 Read Error\r\n");
+        USART_DMA_Printf("[Sensor] DHT11 Read Error (%d)\r\n", DHT11_Get_LastError());
     }
+    return SCHED_DONE;
 }
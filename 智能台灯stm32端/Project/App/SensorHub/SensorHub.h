@@ -1,7 +1,9 @@
 #ifndef __SENSOR_HUB_H
 #define __SENSOR_HUB_H
 
+#include <stdint.h>
+
 void SensorHub_Init(void);
-void SensorHub_Task(void); // 周期性调用 (建议 2秒一次)
+uint32_t SensorHub_Task(void); // 分步任务 (建议 2秒一次)，返回值见 Scheduler.h
 
 #endif
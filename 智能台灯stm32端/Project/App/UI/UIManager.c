@@ -1,36 +1,98 @@
 /**
   * @file    UIManager.c
-  * @brief   UI 管理器实现 (V6.3 Force Refresh)
+  * @brief   UI 管理器实现 (V7.0 Framebuffer)
+  * @note    页面先画到 1KB 帧缓冲 (OLED_FB)，只有像素真正变化的列才会标记为脏；
+  *          刷新时每步提交一个脏页的变化列区间 (I2C1 DMA 后台发送)，
+  *          下一步确认发送完成后再提交下一页，单步耗时只剩提交开销。
   */
 #include "UIManager.h"
 #include "SystemModel.h"
 #include "OLED.h"
+#include "OLED_FB.h"
+#include "Scheduler.h"
 #include <stdio.h>
 #include <string.h>
 
+#define UI_COLS             16
+#define UI_LINE_Y(line)     (((line) - 1) * 16)
+
+// 亮度 / 色温行布局: [焦点图标][标签 3 字符][进度条][数值 4 字符]
+#define UI_LABEL_X          8
+#define UI_BAR_X            34
+#define UI_BAR_W            58
+#define UI_BAR_H            8
+#define UI_VALUE_X          96
+
+// 焦点指示 (8x16 右三角)
+static const uint8_t ICON_FOCUS[16] = {
+    0xF0, 0xE0, 0xC0, 0x80, 0x00, 0x00, 0x00, 0x00,
+    0x0F, 0x07, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00
+};
+
 static SystemModel_t s_LastModel;
+static uint8_t s_Pending = 0;            // 1: 帧缓冲尚未全部刷到屏幕
 
 static void UI_Draw_Home_Page(void);
 
+/** @brief 写入一行文本 (不足一行补空格，清掉旧内容残留) */
+static void UI_SetLine(uint8_t line, const char *str)
+{
+    char buf[UI_COLS + 1];
+    uint8_t i;
+    for (i = 0; i < UI_COLS && str[i] != '\0'; i++) buf[i] = str[i];
+    for (; i < UI_COLS; i++) buf[i] = ' ';
+    buf[UI_COLS] = '\0';
+    OLED_FB_DrawString(0, UI_LINE_Y(line), buf);
+}
+
+/** @brief 数值调节行: 焦点图标 + 标签 + 进度条 (0~1000 映射到 0~100%) + 数值 */
+static void UI_DrawLevelLine(uint8_t line, const char *label, int16_t value, uint8_t focused)
+{
+    char str[8];
+    uint8_t y = UI_LINE_Y(line);
+
+    if (focused) OLED_FB_DrawBitmap(0, y, 8, 16, ICON_FOCUS);
+    else         OLED_FB_FillRect(0, y, 8, 16, 0);
+
+    OLED_FB_DrawString(UI_LABEL_X, y, label);
+    OLED_FB_DrawBar(UI_BAR_X, y + (16 - UI_BAR_H) / 2, UI_BAR_W, UI_BAR_H,
+                    (uint8_t)((value < 0 ? 0 : value) / 10));
+    snprintf(str, sizeof(str), "%4d", value);
+    OLED_FB_DrawString(UI_VALUE_X, y, str);
+}
+
 void UIManager_Init(void)
 {
     OLED_Init();
     
-    // 强制清屏并显示标题，不检查 IsReady
-    OLED_Clear();
-    OLED_ShowString(1, 1, "--- SMART LAMP ---");
+    // 标题直接画到帧缓冲并立即刷新，不检查 IsReady
+    OLED_FB_Clear();
+    OLED_FB_DrawString(0, UI_LINE_Y(1), "--- SMART LAMP ---");
+    OLED_Refresh();
 
     // 初始化上一帧数据为非法值，确保第一次进入 Task 时强制全屏刷新
     memset(&s_LastModel, 0xFF, sizeof(SystemModel_t));
+    s_Pending = 0;
 }
 
-void UIManager_Task(void)
+uint32_t UIManager_Task(void)
 {
     // 【修改点】暂时移除离线检测，强制刷新，排除 I2C ACK 失败导致的黑屏
     // if (OLED_IsReady() == 0) return;
 
-    UI_Draw_Home_Page();
-    s_LastModel = g_SystemModel;
+    // 新周期: 根据模型变化重新绘制 (上一帧还没刷完时不能改帧缓冲，先刷完再比较)
+    if (!s_Pending)
+    {
+        UI_Draw_Home_Page();
+        s_LastModel = g_SystemModel;
+        s_Pending = 1;
+    }
+
+    // 每步最多提交一个脏页，DMA 在后台发送
+    if (OLED_Flush_Step()) return SCHED_NEXT_STEP;
+
+    s_Pending = 0;
+    return SCHED_DONE;
 }
 
 static void UI_Draw_Home_Page(void)
@@ -43,20 +105,14 @@ static void UI_Draw_Home_Page(void)
     if (curr->Light.Brightness != last->Light.Brightness || 
         curr->Light.Focus != last->Light.Focus)
     {
-        sprintf(str, "Bri: %-4d  %s", 
-                curr->Light.Brightness, 
-                (curr->Light.Focus == FOCUS_BRIGHTNESS) ? "[F]" : "   ");
-        OLED_ShowString(2, 1, str);
+        UI_DrawLevelLine(2, "Bri", curr->Light.Brightness, curr->Light.Focus == FOCUS_BRIGHTNESS);
     }
 
     // --- 2. 刷新色温 ---
     if (curr->Light.ColorTemp != last->Light.ColorTemp || 
         curr->Light.Focus != last->Light.Focus)
     {
-        sprintf(str, "CCT: %-4d  %s", 
-                curr->Light.ColorTemp, 
-                (curr->Light.Focus == FOCUS_COLOR_TEMP) ? "[F]" : "   ");
-        OLED_ShowString(3, 1, str);
+        UI_DrawLevelLine(3, "CCT", curr->Light.ColorTemp, curr->Light.Focus == FOCUS_COLOR_TEMP);
     }
 
     // --- 3. 刷新环境数据 ---
@@ -66,18 +122,19 @@ static void UI_Draw_Home_Page(void)
     {
         if (curr->Sensor.Temperature <= -90.0f)
         {
-            OLED_ShowString(4, 1, "Sensor Error!   ");
+            UI_SetLine(4, "Sensor Error!");
         }
         else
         {
             int lux_percent = (int)(curr->Sensor.Lux / 10.0f);
-            if(lux_percent > 100) lux_percent = 100;
+            if (lux_percent < 0) lux_percent = 0;
+            if (lux_percent > 100) lux_percent = 100;
 
-            sprintf(str, "%2.0fC %2.0f%% L:%3d%%", 
+            snprintf(str, sizeof(str), "%2.0fC %2.0f%% L:%3d%%",
                     curr->Sensor.Temperature, 
                     curr->Sensor.Humidity,
                     lux_percent);
-            OLED_ShowString(4, 1, str);
+            UI_SetLine(4, str);
         }
     }
 }
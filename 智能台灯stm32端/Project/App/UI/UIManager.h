@@ -8,6 +8,8 @@
 #ifndef __UI_MANAGER_H
 #define __UI_MANAGER_H
 
+#include <stdint.h>
+
 /**
   * @brief  UI 系统初始化
   * @note   初始化 OLED 硬件，并绘制初始界面框架
@@ -15,10 +17,11 @@
 void UIManager_Init(void);
 
 /**
-  * @brief  UI 刷新任务
-  * @note   建议在主循环中以较低频率调用 (如 100ms/次)
-  *         函数内部会自动进行脏检测，仅刷新变化的数据。
+  * @brief  UI 刷新任务 (分步执行，由调度器驱动)
+  * @note   建议以较低频率释放 (如 100ms/次)
+  *         页面画到帧缓冲，仅刷新像素有变化的列区间，每步提交一个脏页 (DMA 后台发送)。
+  * @return 返回值见 Scheduler.h (SCHED_DONE / SCHED_NEXT_STEP)
   */
-void UIManager_Task(void);
+uint32_t UIManager_Task(void);
 
 #endif
@@ -1,108 +1,94 @@
 /**
   ******************************************************************************
   * @file    DHT11.c
-  * @brief   DHT11 温湿度传感器驱动实现
+  * @brief   DHT11 温湿度传感器驱动实现 (V2.0 Input Capture)
+  * @note    TIM2 以 1MHz 自由运行，CH2 捕获 PA1 下降沿；捕获中断只保存计数值，
+  *          凑满 42 个沿后停止定时器。原先的 Delay_us 忙等版本每次读取阻塞约 4ms，
+  *          且 Delay_us 被中断打断时会把 '0' 读成 '1'。
   ******************************************************************************
   */
 #include "DHT11.h"
-#include "SystemSupport.h" // 需要 Delay_us
+#include "DHT11_Decode.h"
+#include "SystemSupport.h" // 需要 Delay_ms
 
 #define DHT11_IO_PORT    GPIOA
 #define DHT11_IO_PIN     GPIO_Pin_1
 #define DHT11_RCC        RCC_APB2Periph_GPIOA
 
+#define DHT11_TIM        TIM2
+
 /* 内部宏：控制 GPIO 输入输出 */
 #define DHT11_IO_OUT()   {GPIOA->CRL &= 0xFFFFFF0F; GPIOA->CRL |= 0x00000030;} // PA1 推挽输出
-#define DHT11_IO_IN()    {GPIOA->CRL &= 0xFFFFFF0F; GPIOA->CRL |= 0x00000080;} // PA1 上拉输入
+#define DHT11_IO_IN()    {GPIOA->CRL &= 0xFFFFFF0F; GPIOA->CRL |= 0x00000080;} // PA1 上拉输入 (TIM2_CH2)
 
-/* 内部宏：读写电平 */
+/* 内部宏：写电平 */
 #define DHT11_DQ_OUT(x)  GPIO_WriteBit(DHT11_IO_PORT, DHT11_IO_PIN, (BitAction)(x))
-#define DHT11_DQ_IN      GPIO_ReadInputDataBit(DHT11_IO_PORT, DHT11_IO_PIN)
 
-/**
-  * @brief  复位 DHT11
-  */
-static void DHT11_Rst(void)
-{
-    DHT11_IO_OUT();     // 设置为输出
-    DHT11_DQ_OUT(0);    // 拉低数据线
-    Delay_ms(20);       // 拉低至少 18ms
-    DHT11_DQ_OUT(1);    // 拉高数据线
-    Delay_us(30);       // 主机拉高 20~40us
-}
+// --- 捕获缓冲 (中断写，任务读) ---
+static volatile uint16_t s_Edges[DHT11_EDGE_NUM];
+static volatile uint8_t  s_EdgeCount = 0;
+static volatile uint8_t  s_Capturing = 0;
+static volatile uint8_t  s_Overrun = 0;     // 捕获溢出: 上一个沿还没读走又来了新沿
+static uint8_t s_LastError = DHT11_DEC_OK;
 
 /**
-  * @brief  检查 DHT11 是否响应
-  * @retval 0: 存在, 1: 不存在
+  * @brief  TIM2: 1MHz 自由运行，CH2 下降沿输入捕获
   */
-static uint8_t DHT11_Check(void)
+static void DHT11_TIM_Init(void)
 {
-    uint8_t retry = 0;
-    DHT11_IO_IN();      // 设置为输入
-    
-    // 等待 DHT11 拉低 (响应信号)
-    while (DHT11_DQ_IN && retry < 100)
-    {
-        retry++;
-        Delay_us(1);
-    }
-    if (retry >= 100) return 1;
-    
-    retry = 0;
-    // 等待 DHT11 拉高 (响应结束)
-    while (!DHT11_DQ_IN && retry < 100)
-    {
-        retry++;
-        Delay_us(1);
-    }
-    if (retry >= 100) return 1;
-    
-    return 0;
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
+    TIM_ICInitTypeDef TIM_ICInitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+
+    TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInitStructure.TIM_Period = 65536 - 1;
+    TIM_TimeBaseInitStructure.TIM_Prescaler = 72 - 1;       // 1us
+    TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(DHT11_TIM, &TIM_TimeBaseInitStructure);
+
+    TIM_ICStructInit(&TIM_ICInitStructure);
+    TIM_ICInitStructure.TIM_Channel = TIM_Channel_2;
+    TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Falling;
+    TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    TIM_ICInitStructure.TIM_ICFilter = 0x9;                 // fDTS/8, N=8: 滤掉 < 1us 的毛刺
+    TIM_ICInit(DHT11_TIM, &TIM_ICInitStructure);
+
+    TIM_ITConfig(DHT11_TIM, TIM_IT_CC2, DISABLE);
+
+    // 捕获值由硬件锁存，中断只需在下一个沿 (>= 60us) 之前读走
+    NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
 }
 
-/**
-  * @brief  读取一位数据
-  */
-static uint8_t DHT11_Read_Bit(void)
+static void DHT11_Capture_Stop(void)
 {
-    uint8_t retry = 0;
-    
-    // 等待变为低电平 (上一位数据结束，开始下一位)
-    while (DHT11_DQ_IN && retry < 100)
-    {
-        retry++;
-        Delay_us(1);
-    }
-    
-    retry = 0;
-    // 等待变为高电平 (数据开始传输)
-    while (!DHT11_DQ_IN && retry < 100)
-    {
-        retry++;
-        Delay_us(1);
-    }
-    
-    // 延时 40us 后检测电平
-    // '0': 高电平持续 26-28us
-    // '1': 高电平持续 70us
-    Delay_us(40);
-    
-    if (DHT11_DQ_IN) return 1;
-    else return 0;
+    TIM_ITConfig(DHT11_TIM, TIM_IT_CC2, DISABLE);
+    TIM_Cmd(DHT11_TIM, DISABLE);
+    s_Capturing = 0;
 }
 
-/**
-  * @brief  读取一个字节
-  */
-static uint8_t DHT11_Read_Byte(void)
+void TIM2_IRQHandler(void)
 {
-    uint8_t i, dat = 0;
-    for (i = 0; i < 8; i++)
+    if (TIM_GetITStatus(DHT11_TIM, TIM_IT_CC2) != RESET)
     {
-        dat <<= 1;
-        dat |= DHT11_Read_Bit();
+        uint16_t cap = TIM_GetCapture2(DHT11_TIM);  // 读 CCR2 同时清除 CC2IF
+
+        if (TIM_GetFlagStatus(DHT11_TIM, TIM_FLAG_CC2OF) != RESET)
+        {
+            TIM_ClearFlag(DHT11_TIM, TIM_FLAG_CC2OF);
+            s_Overrun = 1;
+        }
+
+        if (s_EdgeCount < DHT11_EDGE_NUM) s_Edges[s_EdgeCount++] = cap;
+        if (s_EdgeCount >= DHT11_EDGE_NUM) DHT11_Capture_Stop();
     }
-    return dat;
 }
 
 /**
@@ -111,40 +97,110 @@ static uint8_t DHT11_Read_Byte(void)
 uint8_t DHT11_Init(void)
 {
     GPIO_InitTypeDef GPIO_InitStructure;
+    uint8_t temp, humi;
+
     RCC_APB2PeriphClockCmd(DHT11_RCC, ENABLE);
     
     GPIO_InitStructure.GPIO_Pin = DHT11_IO_PIN;
     GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP; // 初始推挽输出
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
     GPIO_Init(DHT11_IO_PORT, &GPIO_InitStructure);
-    
-    DHT11_Rst();
-    return DHT11_Check();
+    DHT11_DQ_OUT(1);
+
+    DHT11_TIM_Init();
+
+    // 只判断设备是否应答，首次读取的数据 / 校验不作要求
+    DHT11_Read_Data(&temp, &humi);
+    return (s_LastError == DHT11_DEC_NO_RESPONSE) ? 1 : 0;
 }
 
 /**
-  * @brief  读取温湿度数据
+  * @brief  读取温湿度数据 (阻塞 ~25ms)
   */
 uint8_t DHT11_Read_Data(uint8_t *temp, uint8_t *humi)
 {
-    uint8_t buf[5];
-    uint8_t i;
-    
-    DHT11_Rst();
-    if (DHT11_Check() == 0)
+    uint8_t ret;
+
+    DHT11_Start();
+    Delay_ms(DHT11_START_HOLD_MS);
+    DHT11_Begin_Capture();
+    Delay_ms(DHT11_FRAME_MS);
+
+    ret = DHT11_Get_Result(temp, humi);
+    if (ret == DHT11_BUSY)
     {
-        for (i = 0; i < 5; i++)
-        {
-            buf[i] = DHT11_Read_Byte();
-        }
-        
-        // 校验和检查: buf[4] == buf[0] + buf[1] + buf[2] + buf[3]
-        if (buf[4] == (buf[0] + buf[1] + buf[2] + buf[3]))
-        {
-            *humi = buf[0]; // 湿度整数部分
-            *temp = buf[2]; // 温度整数部分
-            return 0;
-        }
+        DHT11_Abort();
+        ret = DHT11_ERROR;
     }
-    return 1;
+    return ret;
+}
+
+/**
+  * @brief  [新增] 分步读取 - 第 1 步: 拉低总线发送起始信号
+  */
+void DHT11_Start(void)
+{
+    DHT11_Capture_Stop();
+    DHT11_IO_OUT();
+    DHT11_DQ_OUT(0);
+}
+
+/**
+  * @brief  [新增] 分步读取 - 第 2 步: 释放总线，开始捕获下降沿
+  * @note   先输出高电平结束起始信号，再切为输入: CNF=10 时 ODR 决定上 / 下拉，
+  *         ODR 仍为 0 会接成内部下拉。之后由上拉保持高电平 (上升沿不捕获)，DHT11 在 20~40us 后拉低应答
+  */
+void DHT11_Begin_Capture(void)
+{
+    s_EdgeCount = 0;
+    s_Overrun = 0;
+    s_Capturing = 1;
+
+    TIM_SetCounter(DHT11_TIM, 0);
+    TIM_ClearITPendingBit(DHT11_TIM, TIM_IT_CC2);
+    TIM_ClearFlag(DHT11_TIM, TIM_FLAG_CC2OF);
+    TIM_ITConfig(DHT11_TIM, TIM_IT_CC2, ENABLE);
+    TIM_Cmd(DHT11_TIM, ENABLE);
+
+    DHT11_DQ_OUT(1);    // ODR = 1: 输入模式下为上拉
+    DHT11_IO_IN();
+}
+
+/**
+  * @brief  [新增] 分步读取 - 第 3 步: 取回结果
+  */
+uint8_t DHT11_Get_Result(uint8_t *temp, uint8_t *humi)
+{
+    uint16_t edges[DHT11_EDGE_NUM];
+    uint8_t buf[5];
+    uint8_t n, i;
+
+    if (s_Capturing) return DHT11_BUSY;
+
+    n = s_EdgeCount;
+    for (i = 0; i < n; i++) edges[i] = s_Edges[i];
+
+    s_LastError = DHT11_Decode(edges, n, buf);
+    if (s_LastError == DHT11_DEC_OK && s_Overrun) s_LastError = DHT11_DEC_TIMING;
+    if (s_LastError != DHT11_DEC_OK) return DHT11_ERROR;
+
+    *humi = buf[0]; // 湿度整数部分
+    *temp = buf[2]; // 温度整数部分
+    return DHT11_OK;
+}
+
+/**
+  * @brief  [新增] 放弃本次读取 (帧未收完，如设备不在线)，保留已捕获的沿用于诊断
+  */
+void DHT11_Abort(void)
+{
+    uint8_t temp, humi;
+
+    DHT11_Capture_Stop();
+    DHT11_Get_Result(&temp, &humi);     // 按已捕获的沿数记录失败原因
+}
+
+uint8_t DHT11_Get_LastError(void)
+{
+    return s_LastError;
 }
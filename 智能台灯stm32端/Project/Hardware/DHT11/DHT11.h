@@ -1,9 +1,12 @@
 /**
   ******************************************************************************
   * @file    DHT11.h
-  * @brief   DHT11 温湿度传感器驱动
+  * @brief   DHT11 温湿度传感器驱动 (V2.0 Input Capture)
   * @note    单总线协议，对时序要求严格
-  *          引脚: PA1
+  *          引脚: PA1 (TIM2_CH2)
+  *          起始信号由 GPIO 拉低；释放总线后由 TIM2 输入捕获在后台记录每个下降沿的时刻，
+  *          帧结束后再由 DHT11_Decode() 按位宽解码，接收期间不占用 CPU，
+  *          也不会因为中断打断忙等延时而读错位。
   ******************************************************************************
   */
 #ifndef __DHT11_H
@@ -11,18 +14,46 @@
 
 #include "stm32f10x.h"
 
+// 起始信号拉低时间 (ms)，手册要求 >= 18ms
+#define DHT11_START_HOLD_MS     20
+
+// 释放总线后等待一帧接收完成的时间 (ms)，一帧最长约 5.2ms
+#define DHT11_FRAME_MS          8
+
+// DHT11_Get_Result 返回值
+#define DHT11_OK                0
+#define DHT11_ERROR             1
+#define DHT11_BUSY              2       // 仍在接收
+
 /**
-  * @brief  DHT11 初始化
+  * @brief  DHT11 初始化 (GPIO + TIM2 输入捕获，并阻塞读取一次检测设备)
   * @retval 0: 成功 (检测到设备), 1: 失败
   */
 uint8_t DHT11_Init(void);
 
 /**
-  * @brief  读取温湿度数据
+  * @brief  读取温湿度数据 (阻塞 ~25ms，仅用于初始化 / 调试)
   * @param  temp: 温度值指针 (范围 0-50°C)
   * @param  humi: 湿度值指针 (范围 20-90%)
   * @retval 0: 读取成功, 1: 读取失败
   */
 uint8_t DHT11_Read_Data(uint8_t *temp, uint8_t *humi);
 
+/**
+  * @brief  [新增] 分步读取 (供调度器使用，整个过程不阻塞)
+  * @note   1. DHT11_Start():         拉低总线发送起始信号
+  *         2. DHT11_Begin_Capture(): 至少 DHT11_START_HOLD_MS 后调用，释放总线并开始捕获
+  *         3. DHT11_Get_Result():    DHT11_FRAME_MS 后调用，取回解码结果；
+  *            若仍返回 DHT11_BUSY 可稍后再取，或直接调用 DHT11_Abort() 放弃本次读取
+  */
+void DHT11_Start(void);
+void DHT11_Begin_Capture(void);
+uint8_t DHT11_Get_Result(uint8_t *temp, uint8_t *humi);
+void DHT11_Abort(void);
+
+/**
+  * @brief  最近一次读取失败的原因 (DHT11_DecStatus_t，用于打印诊断)
+  */
+uint8_t DHT11_Get_LastError(void);
+
 #endif
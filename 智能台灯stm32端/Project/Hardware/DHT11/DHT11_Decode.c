@@ -0,0 +1,33 @@
+/**
+  ******************************************************************************
+  * @file    DHT11_Decode.c
+  * @brief   DHT11 单总线帧解码实现
+  ******************************************************************************
+  */
+#include "DHT11_Decode.h"
+
+DHT11_DecStatus_t DHT11_Decode(const uint16_t *edges, uint8_t n, uint8_t out[5])
+{
+    uint16_t dt;
+    uint8_t i;
+
+    if (n == 0) return DHT11_DEC_NO_RESPONSE;
+    if (n < DHT11_EDGE_NUM) return DHT11_DEC_SHORT;
+
+    dt = (uint16_t)(edges[1] - edges[0]);
+    if (dt < DHT11_RESP_MIN_US || dt > DHT11_RESP_MAX_US) return DHT11_DEC_TIMING;
+
+    for (i = 0; i < 5; i++) out[i] = 0;
+
+    for (i = 0; i < 40; i++)
+    {
+        dt = (uint16_t)(edges[i + 2] - edges[i + 1]);
+        if (dt < DHT11_BIT_MIN_US || dt > DHT11_BIT_MAX_US) return DHT11_DEC_TIMING;
+
+        out[i >> 3] <<= 1;
+        if (dt >= DHT11_BIT_THRESH_US) out[i >> 3] |= 1;
+    }
+
+    if ((uint8_t)(out[0] + out[1] + out[2] + out[3]) != out[4]) return DHT11_DEC_CHECKSUM;
+    return DHT11_DEC_OK;
+}
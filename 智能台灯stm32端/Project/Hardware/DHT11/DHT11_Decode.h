@@ -0,0 +1,49 @@
+/**
+  ******************************************************************************
+  * @file    DHT11_Decode.h
+  * @brief   DHT11 单总线帧解码 (由下降沿捕获时刻计算位宽)
+  * @note    DHT11 每一位 = 50us 低电平 + 26~28us ('0') / 70us ('1') 高电平，
+  *          所以相邻两个下降沿的间隔 ≈78us 为 '0'、≈120us 为 '1'，只需捕获下降沿。
+  *          一帧共 42 个下降沿:
+  *            edge[0]      DHT11 响应 (拉低 80us + 拉高 80us)
+  *            edge[1..40]  40 个数据位的起始
+  *            edge[41]     最后一位结束 (拉低 50us 后释放总线)
+  *          本文件不依赖硬件，可在主机上编译测试。
+  ******************************************************************************
+  */
+#ifndef __DHT11_DECODE_H
+#define __DHT11_DECODE_H
+
+#include <stdint.h>
+
+#define DHT11_EDGE_NUM          42
+
+// 下降沿间隔判定 (us，计数器 1MHz)
+// 手册范围: '0' = 48~55 + 23~28 = 71~83us，'1' = 48~55 + 68~74 = 116~129us，
+// 漏掉一个沿时两位合并 >= 142us，因此上限取 150 以便识别漏沿
+#define DHT11_RESP_MIN_US       120     // 响应: 80 + 80
+#define DHT11_RESP_MAX_US       220
+#define DHT11_BIT_MIN_US        40
+#define DHT11_BIT_MAX_US        150
+#define DHT11_BIT_THRESH_US     100     // 间隔 >= 该值判为 '1'
+
+/**
+  * @brief 解码结果
+  */
+typedef enum {
+    DHT11_DEC_OK = 0,
+    DHT11_DEC_NO_RESPONSE,      /*!< 没有捕获到任何下降沿 (设备不在线) */
+    DHT11_DEC_SHORT,            /*!< 下降沿不足 42 个 (帧被截断) */
+    DHT11_DEC_TIMING,           /*!< 间隔超出范围 (毛刺 / 漏沿) */
+    DHT11_DEC_CHECKSUM          /*!< 校验和错误 */
+} DHT11_DecStatus_t;
+
+/**
+  * @brief  由下降沿捕获值解码 5 字节数据
+  * @param  edges: 16 位自由运行计数器 (1MHz) 的捕获值，回绕由无符号减法处理
+  * @param  n:     捕获到的沿数，多于 42 个时只使用前 42 个
+  * @param  out:   湿度整数/小数、温度整数/小数、校验和
+  */
+DHT11_DecStatus_t DHT11_Decode(const uint16_t *edges, uint8_t n, uint8_t out[5]);
+
+#endif
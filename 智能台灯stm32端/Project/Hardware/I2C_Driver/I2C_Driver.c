@@ -1,11 +1,22 @@
 /**
   ******************************************************************************
   * @file    I2C_Driver.c
-  * @brief   软件模拟 I2C 实现
+  * @brief   I2C 驱动实现: 硬件 / 软件模式分发 + 软件模拟 I2C (回退路径)
   ******************************************************************************
   */
 #include "I2C_Driver.h"
+#include "I2C_HW.h"
 #include "SystemSupport.h" // 需要 Delay_us
+#include "USART_DMA.h"
+#include "Scheduler.h"
+#include <string.h>
+
+// --- 各总线当前模式 (下标 0: I2C1, 1: I2C2) ---
+#define BUS_IDX(I2Cx)   ((I2Cx) == I2C1 ? 0 : 1)
+
+static uint8_t s_IsHW[2] = { 0, 0 };
+static I2C_BusStats_t s_SoftStats[2];   // 软件模式下的统计 (硬件模式的在 I2C_HW.c)
+static uint32_t s_StatsStart = 0;
 
 // --- 引脚定义 ---
 // Group 1: OLED (I2C1 Remap)
@@ -179,9 +190,11 @@ static uint8_t I2C_ReadByte(unsigned char ack)
     return receive;
 }
 
-// --- 接口实现 ---
+/* ============================================================
+ *                 软件模拟 I2C 事务
+ * ============================================================ */
 
-void I2C_Lib_Init(I2C_TypeDef* I2Cx)
+static void I2C_Soft_Init(I2C_TypeDef* I2Cx)
 {
     GPIO_InitTypeDef GPIO_InitStructure;
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
@@ -209,7 +222,7 @@ void I2C_Lib_Init(I2C_TypeDef* I2Cx)
     }
 }
 
-uint8_t I2C_Lib_Write(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t* pData, uint16_t Size)
+static uint8_t I2C_Soft_Write(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t* pData, uint16_t Size)
 {
     I2C_SelectPort(I2Cx);
     I2C_Start();
@@ -229,7 +242,7 @@ uint8_t I2C_Lib_Write(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8
     return 0;
 }
 
-uint8_t I2C_Lib_Read(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t* pData, uint16_t Size)
+static uint8_t I2C_Soft_Read(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t* pData, uint16_t Size)
 {
     I2C_SelectPort(I2Cx);
     
@@ -259,7 +272,7 @@ uint8_t I2C_Lib_Read(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_
     return 0;
 }
 
-uint8_t I2C_Lib_WriteDirect(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t* pData, uint16_t Size)
+static uint8_t I2C_Soft_WriteDirect(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t* pData, uint16_t Size)
 {
     I2C_SelectPort(I2Cx);
     I2C_Start();
@@ -276,17 +289,163 @@ uint8_t I2C_Lib_WriteDirect(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t* pData,
     return 0;
 }
 
+/** @brief 以软件模拟同步执行一个事务 */
+static void I2C_Soft_Run(I2C_TypeDef* I2Cx, I2C_Xfer_t* x)
+{
+    I2C_BusStats_t* st = &s_SoftStats[BUS_IDX(I2Cx)];
+    uint32_t cyc = System_GetCycle();
+    uint8_t err;
+
+    if (x->IsRead)      err = I2C_Soft_Read(I2Cx, x->Addr, x->Reg, x->Buf, x->Len);
+    else if (x->HasReg) err = I2C_Soft_Write(I2Cx, x->Addr, x->Reg, x->Buf, x->Len);
+    else                err = I2C_Soft_WriteDirect(I2Cx, x->Addr, x->Buf, x->Len);
+
+    x->BusUs = (uint16_t)((System_GetCycle() - cyc) / (SystemCoreClock / 1000000));
+    st->Xfers++;
+    st->Bytes += x->Len + (x->HasReg ? 1 : 0);
+    st->BusUs += x->BusUs;
+    if (err) st->Nacks++;
+
+    x->Next = NULL;
+    x->Status = err ? I2C_XFER_NACK : I2C_XFER_OK;
+    if (x->Done) x->Done(x);
+}
+
+/* ============================================================
+ *                 模式切换
+ * ============================================================ */
+
+/**
+  * @brief  硬件总线连续出错时永久回退到软件模拟 (直到复位)
+  */
+static void I2C_CheckFallback(I2C_TypeDef* I2Cx)
+{
+    uint8_t idx = BUS_IDX(I2Cx);
+    if (!s_IsHW[idx] || !I2C_HW_IsFailed(I2Cx)) return;
+
+    I2C_HW_DeInit(I2Cx);
+    s_IsHW[idx] = 0;
+    I2C_Soft_Init(I2Cx);
+    USART_DMA_Printf("[I2C] I2C%u 硬件总线连续出错，回退到软件模拟\r\n", idx + 1);
+}
+
+/* ============================================================
+ *                 接口实现
+ * ============================================================ */
+
+void I2C_Lib_Init(I2C_TypeDef* I2Cx)
+{
+    uint8_t idx = BUS_IDX(I2Cx);
+    uint8_t use_hw = (I2Cx == I2C1) ? I2C1_USE_HW : I2C2_USE_HW;
+
+    memset(&s_SoftStats[idx], 0, sizeof(I2C_BusStats_t));
+    s_StatsStart = System_GetTick();
+
+    if (use_hw)
+    {
+        if (I2C_HW_Init(I2Cx) == 0)
+        {
+            s_IsHW[idx] = 1;
+            return;
+        }
+        I2C_HW_DeInit(I2Cx);
+        USART_DMA_Printf("[I2C] I2C%u 总线恢复后仍 BUSY，使用软件模拟\r\n", idx + 1);
+    }
+
+    s_IsHW[idx] = 0;
+    I2C_Soft_Init(I2Cx);
+}
+
+void I2C_Lib_Submit(I2C_TypeDef* I2Cx, I2C_Xfer_t* x)
+{
+    if (x->IsRead && !x->HasReg) x->IsRead = 0; // 不支持无寄存器地址的读，按地址探测处理
+
+    if (s_IsHW[BUS_IDX(I2Cx)])
+    {
+        I2C_HW_Submit(I2Cx, x);
+    }
+    else
+    {
+        I2C_Soft_Run(I2Cx, x);
+    }
+}
+
+void I2C_Lib_Poll(I2C_TypeDef* I2Cx)
+{
+    if (!s_IsHW[BUS_IDX(I2Cx)]) return;
+    I2C_HW_Poll(I2Cx);
+    I2C_CheckFallback(I2Cx);
+}
+
+uint8_t I2C_Lib_IsHardware(I2C_TypeDef* I2Cx)
+{
+    return s_IsHW[BUS_IDX(I2Cx)];
+}
+
+/** @brief 阻塞执行一个事务: 提交后等待完成 (硬件模式下等待期间处理超时) */
+static uint8_t I2C_Transfer(I2C_TypeDef* I2Cx, uint8_t DevAddr, int16_t RegAddr, uint8_t IsRead,
+                            uint8_t* pData, uint16_t Size)
+{
+    I2C_Xfer_t x;
+    memset(&x, 0, sizeof(x));
+    x.Addr = DevAddr;
+    x.HasReg = (RegAddr >= 0);
+    x.Reg = (uint8_t)RegAddr;
+    x.IsRead = IsRead;
+    x.Buf = pData;
+    x.Len = Size;
+
+    I2C_Lib_Submit(I2Cx, &x);
+    while (x.Status == I2C_XFER_PENDING)
+    {
+        I2C_Lib_Poll(I2Cx);
+    }
+    I2C_Lib_Poll(I2Cx);
+    return (x.Status == I2C_XFER_OK) ? 0 : 1;
+}
+
+uint8_t I2C_Lib_Write(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t* pData, uint16_t Size)
+{
+    return I2C_Transfer(I2Cx, DevAddr, RegAddr, 0, pData, Size);
+}
+
+uint8_t I2C_Lib_Read(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t* pData, uint16_t Size)
+{
+    return I2C_Transfer(I2Cx, DevAddr, RegAddr, 1, pData, Size);
+}
+
+uint8_t I2C_Lib_WriteDirect(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t* pData, uint16_t Size)
+{
+    return I2C_Transfer(I2Cx, DevAddr, -1, 0, pData, Size);
+}
+
 uint8_t I2C_Lib_IsDeviceReady(I2C_TypeDef* I2Cx, uint8_t DevAddr)
 {
-    I2C_SelectPort(I2Cx);
-    I2C_Start();
-    
-    I2C_SendByte(DevAddr);
-    if (I2C_WaitAck()) {
-        I2C_Stop();
-        return 1; // 失败
+    return I2C_Transfer(I2Cx, DevAddr, -1, 0, NULL, 0);
+}
+
+uint32_t I2C_Lib_Stats_Task(void)
+{
+    static const char* const s_ModeNames[2][2] = {
+        { "sw", "hw-dma" },     // I2C1
+        { "sw", "hw-irq" },     // I2C2
+    };
+    uint32_t window = System_GetTick() - s_StatsStart;
+
+    for (uint8_t idx = 0; idx < 2; idx++)
+    {
+        I2C_TypeDef* I2Cx = idx ? I2C2 : I2C1;
+        I2C_BusStats_t st = s_SoftStats[idx];
+        memset(&s_SoftStats[idx], 0, sizeof(I2C_BusStats_t));
+        I2C_HW_TakeStats(I2Cx, &st);
+
+        uint32_t permille = window ? st.BusUs / window : 0;
+        USART_DMA_Printf("[I2C] I2C%u %-6s xfers=%lu bytes=%lu bus=%lu.%lu%% nack=%u err=%u rec=%u\r\n",
+                         idx + 1, s_ModeNames[idx][s_IsHW[idx]],
+                         (unsigned long)st.Xfers, (unsigned long)st.Bytes,
+                         (unsigned long)(permille / 10), (unsigned long)(permille % 10),
+                         st.Nacks, st.BusErrs, st.Recovers);
     }
-    
-    I2C_Stop();
-    return 0; // 成功
+    s_StatsStart = System_GetTick();
+    return SCHED_DONE;
 }
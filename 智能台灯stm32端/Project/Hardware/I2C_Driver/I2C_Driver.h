@@ -1,8 +1,10 @@
 /**
   ******************************************************************************
   * @file    I2C_Driver.h
-  * @brief   通用软件模拟 I2C 驱动 (高可靠版)
-  * @note    完全替代不稳定的硬件 I2C，接口保持兼容
+  * @brief   通用 I2C 驱动 (V2.0 硬件 I2C + 软件回退)
+  * @note    默认使用硬件 I2C (I2C_HW.c)，中断/DMA 完成传输，并提供非阻塞事务队列；
+  *          软件模拟 I2C 保留为回退路径: Config.h 中关闭 I2Cx_USE_HW，或硬件总线
+  *          连续出错 (F103 I2C 勘误导致 BUSY 锁死等) 时自动切换，接口保持兼容。
   ******************************************************************************
   */
 #ifndef __I2C_DRIVER_H
@@ -10,12 +12,59 @@
 
 #include "stm32f10x.h"
 
-// --- 接口定义 (保持与原硬件驱动一致) ---
+/* ============================================================
+ *                 事务描述 (非阻塞接口)
+ * ============================================================ */
 
 /**
-  * @brief  初始化 I2C GPIO
-  * @param  I2Cx: 仅用于区分引脚组
-  *         - I2C1: SCL=PB8,  SDA=PB9  (用于 OLED)
+  * @brief 事务状态
+  */
+typedef enum {
+    I2C_XFER_OK = 0,
+    I2C_XFER_PENDING,       /*!< 排队中 / 传输中 */
+    I2C_XFER_NACK,          /*!< 设备未应答 (不计入总线错误) */
+    I2C_XFER_BUS_ERR,       /*!< 总线错误 / 仲裁丢失 / 溢出 */
+    I2C_XFER_TIMEOUT        /*!< 超时被中止 */
+} I2C_XferStatus_t;
+
+/**
+  * @brief 单个 I2C 事务
+  * @note  提交后直到 Status 不再是 PENDING 之前，事务本身和 Buf 都必须保持有效
+  *        (用静态变量，不要用栈上的局部变量提交非阻塞事务)。
+  */
+typedef struct I2C_Xfer {
+    uint8_t  Addr;              /*!< 8 位设备写地址 */
+    uint8_t  Reg;               /*!< 寄存器地址 (HasReg = 1 时有效) */
+    uint8_t  HasReg;            /*!< 1: 先发送寄存器地址 */
+    uint8_t  IsRead;            /*!< 1: 读 (寄存器地址之后重复起始) */
+    uint8_t *Buf;
+    uint16_t Len;               /*!< 数据字节数，0 表示仅探测地址 */
+    volatile uint8_t Status;    /*!< I2C_XferStatus_t */
+    uint16_t BusUs;             /*!< 完成后填写: 起始条件 -> 完成的总线占用时间 */
+    void (*Done)(struct I2C_Xfer *x); /*!< 完成回调 (可为 NULL，硬件模式下在中断中调用) */
+    struct I2C_Xfer *Next;      /*!< 驱动内部队列链接 */
+} I2C_Xfer_t;
+
+/**
+  * @brief 总线统计 (I2C_Lib_Stats_Task 打印后清零)
+  */
+typedef struct {
+    uint32_t Xfers;             /*!< 完成的事务数 */
+    uint32_t Bytes;             /*!< 传输的字节数 (含寄存器地址) */
+    uint32_t BusUs;             /*!< 累计总线占用时间 */
+    uint16_t Nacks;
+    uint16_t BusErrs;           /*!< 总线错误 + 超时 */
+    uint16_t Recovers;          /*!< 总线恢复次数 (SWRST + 9 个 SCL 脉冲) */
+} I2C_BusStats_t;
+
+/* ============================================================
+ *                 阻塞接口 (保持与原驱动一致)
+ * ============================================================ */
+
+/**
+  * @brief  初始化 I2C 总线
+  * @param  I2Cx:
+  *         - I2C1: SCL=PB8,  SDA=PB9  (重映射，用于 OLED)
   *         - I2C2: SCL=PB10, SDA=PB11 (用于 PAJ7620)
   */
 void I2C_Lib_Init(I2C_TypeDef* I2Cx);
@@ -26,7 +75,7 @@ void I2C_Lib_Init(I2C_TypeDef* I2Cx);
 uint8_t I2C_Lib_Write(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t* pData, uint16_t Size);
 
 /**
-  * @brief  读寄存器
+  * @brief  读寄存器 (Size > 1 时为连续寄存器突发读)
   */
 uint8_t I2C_Lib_Read(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t RegAddr, uint8_t* pData, uint16_t Size);
 
@@ -40,4 +89,31 @@ uint8_t I2C_Lib_WriteDirect(I2C_TypeDef* I2Cx, uint8_t DevAddr, uint8_t* pData,
   */
 uint8_t I2C_Lib_IsDeviceReady(I2C_TypeDef* I2Cx, uint8_t DevAddr);
 
+/* ============================================================
+ *                 非阻塞接口
+ * ============================================================ */
+
+/**
+  * @brief  提交事务到总线队列，立即返回
+  * @note   硬件模式下按提交顺序依次传输，完成后更新 Status 并调用 Done；
+  *         软件模式下在本函数内同步完成。只能在主循环 (任务) 中调用。
+  */
+void I2C_Lib_Submit(I2C_TypeDef* I2Cx, I2C_Xfer_t* x);
+
+/**
+  * @brief  总线维护: 超时中止、错误恢复、必要时回退到软件模式
+  * @note   等待非阻塞事务期间周期调用 (阻塞接口内部已自动调用)
+  */
+void I2C_Lib_Poll(I2C_TypeDef* I2Cx);
+
+/**
+  * @brief  当前是否工作在硬件模式
+  */
+uint8_t I2C_Lib_IsHardware(I2C_TypeDef* I2Cx);
+
+/**
+  * @brief  统计打印任务: 每条总线一行 [I2C]，打印后清零
+  */
+uint32_t I2C_Lib_Stats_Task(void);
+
 #endif
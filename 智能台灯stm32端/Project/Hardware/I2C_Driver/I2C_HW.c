@@ -0,0 +1,606 @@
+/**
+  ******************************************************************************
+  * @file    I2C_HW.c
+  * @brief   STM32F103 硬件 I2C 主机驱动实现
+  * @note    一个事务的阶段:
+  *          START -> 写地址 -> [寄存器地址 -> 重复 START -> 读地址] -> 数据 -> STOP
+  *          除了等待 STOP 释放 (约 1 个位时间) 外，中断里不做任何忙等。
+  ******************************************************************************
+  */
+#include "I2C_HW.h"
+#include "SystemSupport.h"
+#include <string.h>
+
+// --- 事务阶段 ---
+typedef enum {
+    PH_IDLE = 0,
+    PH_START,           // 已发 START，等待 SB
+    PH_ADDR_W,          // 已发写地址，等待 ADDR
+    PH_REG,             // 已发寄存器地址 (读事务)，等待 BTF 后重复起始
+    PH_RESTART,         // 已发重复 START，等待 SB
+    PH_ADDR_R,          // 已发读地址，等待 ADDR
+    PH_TX,              // 发送数据 (中断逐字节或 DMA)
+    PH_RX1,             // 接收 1 字节
+    PH_RX2,             // 接收 2 字节 (POS)
+    PH_RXN,             // 接收 >= 3 字节 (中断逐字节，最后 3 字节按 BTF 收尾)
+    PH_RX_DMA           // DMA 接收 (LAST 位自动 NACK)
+} I2C_Phase_t;
+
+// --- 总线上下文 ---
+typedef struct {
+    I2C_TypeDef*         I2Cx;
+    uint16_t             SclPin;
+    uint16_t             SdaPin;
+    DMA_Channel_TypeDef* DmaTx;     // NULL: 中断逐字节
+    DMA_Channel_TypeDef* DmaRx;
+
+    I2C_Xfer_t*          Head;      // 队首 = 正在传输的事务
+    I2C_Xfer_t*          Tail;
+    volatile uint8_t     Phase;
+    uint16_t             Idx;       // 中断模式下已传输的数据字节数
+    uint32_t             StartCyc;  // 本事务起始时刻 (DWT)
+    uint32_t             StartTick; // 本事务起始时刻 (ms，用于超时)
+
+    volatile uint8_t     NeedRecover;
+    uint8_t              ConsecErr; // 连续总线错误次数 (成功一次清零)
+    I2C_BusStats_t       Stats;
+} I2C_Bus_t;
+
+#define ERR_FLAGS   (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR | I2C_SR1_TIMEOUT)
+
+static I2C_Bus_t s_Bus[2] = {
+    { I2C1, GPIO_Pin_8,  GPIO_Pin_9,  DMA1_Channel6, DMA1_Channel7 },
+    { I2C2, GPIO_Pin_10, GPIO_Pin_11, NULL,          NULL          },
+};
+static uint32_t s_CycPerUs = 72;
+
+static I2C_Bus_t* _Bus(I2C_TypeDef* I2Cx)
+{
+    return (I2Cx == I2C1) ? &s_Bus[0] : &s_Bus[1];
+}
+
+/** @brief 有界等待某个条件 (只用于 1~2 个位时间内必然满足的场合) */
+#define SPIN_UNTIL(cond)    do { uint16_t _n = 2000; while (!(cond) && --_n); } while (0)
+
+/* ============================================================
+ *                 GPIO / 外设 / 总线恢复
+ * ============================================================ */
+
+static void _Pins_Config(I2C_Bus_t* b, GPIOMode_TypeDef mode)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+    GPIO_InitStructure.GPIO_Pin = b->SclPin | b->SdaPin;
+    GPIO_InitStructure.GPIO_Mode = mode;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(GPIOB, &GPIO_InitStructure);
+}
+
+static void _Bit_Delay(void)
+{
+    volatile int i = 40; // 约 5us，恢复时序不要求精确
+    while (i--);
+}
+
+/**
+  * @brief  总线解锁: 从机卡在输出 0 时，最多补 9 个 SCL 脉冲，再手动产生 STOP
+  */
+static void _Bus_Clear(I2C_Bus_t* b)
+{
+    GPIO_SetBits(GPIOB, b->SclPin | b->SdaPin);
+    _Pins_Config(b, GPIO_Mode_Out_OD);
+    _Bit_Delay();
+
+    for (uint8_t i = 0; i < 9 && !GPIO_ReadInputDataBit(GPIOB, b->SdaPin); i++)
+    {
+        GPIO_ResetBits(GPIOB, b->SclPin); _Bit_Delay();
+        GPIO_SetBits(GPIOB, b->SclPin);   _Bit_Delay();
+    }
+
+    // STOP: SCL 高时 SDA 由低变高
+    GPIO_ResetBits(GPIOB, b->SclPin); _Bit_Delay();
+    GPIO_ResetBits(GPIOB, b->SdaPin); _Bit_Delay();
+    GPIO_SetBits(GPIOB, b->SclPin);   _Bit_Delay();
+    GPIO_SetBits(GPIOB, b->SdaPin);   _Bit_Delay();
+}
+
+/**
+  * @brief  外设复位并重新配置 (勘误: BUSY 锁死只能靠 SWRST 清除)
+  */
+static void _Periph_Reset(I2C_Bus_t* b)
+{
+    I2C_InitTypeDef I2C_InitStructure;
+    I2C_TypeDef* I2Cx = b->I2Cx;
+
+    I2Cx->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN | I2C_CR2_ITBUFEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+    I2Cx->CR1 |= I2C_CR1_SWRST;
+    I2Cx->CR1 &= ~I2C_CR1_SWRST;
+
+    I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
+    I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
+    I2C_InitStructure.I2C_OwnAddress1 = 0x00;
+    I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
+    I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+    I2C_InitStructure.I2C_ClockSpeed = I2C_HW_SPEED_HZ;
+    I2C_Init(I2Cx, &I2C_InitStructure);
+    I2C_Cmd(I2Cx, ENABLE);
+}
+
+static void _Recover(I2C_Bus_t* b)
+{
+    b->I2Cx->CR1 &= ~I2C_CR1_PE;
+    _Bus_Clear(b);
+    _Pins_Config(b, GPIO_Mode_AF_OD);
+    _Periph_Reset(b);
+    b->NeedRecover = 0;
+    b->Stats.Recovers++;
+}
+
+/* ============================================================
+ *                 事务调度
+ * ============================================================ */
+
+static void _Dma_Start(DMA_Channel_TypeDef* ch, uint8_t* buf, uint16_t len)
+{
+    ch->CCR &= ~DMA_CCR1_EN;
+    ch->CMAR = (uint32_t)buf;
+    ch->CNDTR = len;
+    ch->CCR |= DMA_CCR1_EN;
+}
+
+static void _Start_Head(I2C_Bus_t* b)
+{
+    I2C_TypeDef* I2Cx = b->I2Cx;
+
+    b->Phase = PH_START;
+    b->Idx = 0;
+    b->StartCyc = System_GetCycle();
+    b->StartTick = System_GetTick();
+
+    SPIN_UNTIL(!(I2Cx->CR1 & I2C_CR1_STOP)); // 上一事务的 STOP 尚未发出时不能置 START
+    I2Cx->CR1 &= ~I2C_CR1_POS;
+    I2Cx->CR1 |= I2C_CR1_ACK;
+    I2Cx->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+    I2Cx->CR1 |= I2C_CR1_START;
+}
+
+/**
+  * @brief  结束队首事务 (统计、出队、回调)，不启动下一个
+  */
+static void _Finish(I2C_Bus_t* b, uint8_t status)
+{
+    I2C_TypeDef* I2Cx = b->I2Cx;
+    I2C_Xfer_t* x = b->Head;
+
+    I2Cx->CR2 &= ~(I2C_CR2_ITBUFEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+    if (b->DmaTx) b->DmaTx->CCR &= ~DMA_CCR1_EN;
+    if (b->DmaRx) b->DmaRx->CCR &= ~DMA_CCR1_EN;
+
+    x->BusUs = (uint16_t)((System_GetCycle() - b->StartCyc) / s_CycPerUs);
+    b->Stats.Xfers++;
+    b->Stats.Bytes += x->Len + (x->HasReg ? 1 : 0);
+    b->Stats.BusUs += x->BusUs;
+
+    if (status == I2C_XFER_OK) b->ConsecErr = 0;
+    else if (status == I2C_XFER_NACK) b->Stats.Nacks++;
+    else { b->Stats.BusErrs++; b->ConsecErr++; }
+
+    b->Head = x->Next;
+    if (b->Head == NULL)
+    {
+        b->Tail = NULL;
+        b->Phase = PH_IDLE;
+        I2Cx->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN);
+    }
+
+    x->Next = NULL;
+    x->Status = status;
+    if (x->Done) x->Done(x);
+}
+
+/** @brief 正常结束: 结算后启动下一个事务 */
+static void _Complete(I2C_Bus_t* b, uint8_t status)
+{
+    _Finish(b, status);
+    if (b->Head) _Start_Head(b);
+}
+
+/** @brief 异常结束: 队列中所有事务以同一状态失败，待主循环恢复总线 */
+static void _Abort_All(I2C_Bus_t* b, uint8_t status)
+{
+    while (b->Head) _Finish(b, status);
+    b->NeedRecover = 1;
+}
+
+/* ============================================================
+ *                 中断处理
+ * ============================================================ */
+
+static void _On_AddrWrite(I2C_Bus_t* b, I2C_Xfer_t* x)
+{
+    I2C_TypeDef* I2Cx = b->I2Cx;
+    (void)I2Cx->SR2; // 读 SR1 + SR2 清 ADDR
+
+    // 仅探测地址
+    if (!x->HasReg && x->Len == 0)
+    {
+        I2Cx->CR1 |= I2C_CR1_STOP;
+        _Complete(b, I2C_XFER_OK);
+        return;
+    }
+
+    if (x->HasReg)
+    {
+        I2Cx->DR = x->Reg;
+        if (x->IsRead) { b->Phase = PH_REG; return; }
+    }
+
+    b->Phase = PH_TX;
+    if (x->Len == 0) return;                    // 只有寄存器地址，等待 BTF
+
+    if (b->DmaTx)
+    {
+        _Dma_Start(b->DmaTx, x->Buf, x->Len);
+        I2Cx->CR2 |= I2C_CR2_DMAEN;
+    }
+    else
+    {
+        I2Cx->CR2 |= I2C_CR2_ITBUFEN;
+    }
+}
+
+static void _On_AddrRead(I2C_Bus_t* b, I2C_Xfer_t* x)
+{
+    I2C_TypeDef* I2Cx = b->I2Cx;
+
+    if (x->Len == 1)
+    {
+        // 勘误: 清 ADDR 与置 STOP 之间不能被打断 (本中断已是最高抢占优先级)
+        I2Cx->CR1 &= ~I2C_CR1_ACK;
+        (void)I2Cx->SR2;
+        I2Cx->CR1 |= I2C_CR1_STOP;
+        b->Phase = PH_RX1;
+        I2Cx->CR2 |= I2C_CR2_ITBUFEN;
+    }
+    else if (b->DmaRx)
+    {
+        _Dma_Start(b->DmaRx, x->Buf, x->Len);
+        I2Cx->CR2 |= I2C_CR2_DMAEN | I2C_CR2_LAST;
+        (void)I2Cx->SR2;
+        b->Phase = PH_RX_DMA;
+    }
+    else if (x->Len == 2)
+    {
+        // POS 已在 SB 阶段置位: 清 ADDR 后立即关 ACK，作用于第 2 个字节
+        (void)I2Cx->SR2;
+        I2Cx->CR1 &= ~I2C_CR1_ACK;
+        b->Phase = PH_RX2;
+    }
+    else
+    {
+        (void)I2Cx->SR2;
+        b->Phase = PH_RXN;
+        if (x->Len > 3) I2Cx->CR2 |= I2C_CR2_ITBUFEN; // 剩余 3 字节之前按 RXNE 逐字节读
+    }
+}
+
+static void _On_BTF(I2C_Bus_t* b, I2C_Xfer_t* x)
+{
+    I2C_TypeDef* I2Cx = b->I2Cx;
+
+    switch (b->Phase)
+    {
+        case PH_REG:
+            I2Cx->CR1 |= I2C_CR1_START;
+            b->Phase = PH_RESTART;
+            break;
+
+        case PH_TX:
+            // DMA 模式: 计数未归零说明 DMA 还没跟上，等下一次 BTF
+            if (b->DmaTx && x->Len && b->DmaTx->CNDTR) break;
+            I2Cx->CR1 |= I2C_CR1_STOP;
+            _Complete(b, I2C_XFER_OK);
+            break;
+
+        case PH_RX2:
+            // DR = 字节 1，移位寄存器 = 字节 2
+            I2Cx->CR1 |= I2C_CR1_STOP;
+            x->Buf[0] = I2Cx->DR;
+            x->Buf[1] = I2Cx->DR;
+            _Complete(b, I2C_XFER_OK);
+            break;
+
+        case PH_RXN:
+            if (x->Len - b->Idx == 3)
+            {
+                // DR = N-2，移位寄存器 = N-1: 关 ACK 后读出 N-2，让 N 以 NACK 结束
+                I2Cx->CR1 &= ~I2C_CR1_ACK;
+                x->Buf[b->Idx++] = I2Cx->DR;
+            }
+            else
+            {
+                // DR = N-1，移位寄存器 = N
+                I2Cx->CR1 |= I2C_CR1_STOP;
+                x->Buf[b->Idx++] = I2Cx->DR;
+                SPIN_UNTIL(I2Cx->SR1 & I2C_SR1_RXNE);
+                x->Buf[b->Idx++] = I2Cx->DR;
+                _Complete(b, I2C_XFER_OK);
+            }
+            break;
+
+        default:
+            (void)I2Cx->DR; // 意外的 BTF，读 DR 清除，避免中断风暴
+            break;
+    }
+}
+
+static void _EV_IRQHandler(I2C_Bus_t* b)
+{
+    I2C_TypeDef* I2Cx = b->I2Cx;
+    I2C_Xfer_t* x = b->Head;
+    uint16_t sr1 = I2Cx->SR1;
+
+    if (x == NULL)
+    {
+        I2Cx->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN);
+        return;
+    }
+
+    // 1. 起始条件已发出: 发送地址
+    if (sr1 & I2C_SR1_SB)
+    {
+        if (b->Phase == PH_START && (x->HasReg || !x->IsRead))
+        {
+            I2Cx->DR = x->Addr & 0xFE;
+            b->Phase = PH_ADDR_W;
+        }
+        else
+        {
+            if (x->Len == 2 && b->DmaRx == NULL) I2Cx->CR1 |= I2C_CR1_POS;
+            I2Cx->DR = x->Addr | 0x01;
+            b->Phase = PH_ADDR_R;
+        }
+        return;
+    }
+
+    // 2. 地址已应答
+    if (sr1 & I2C_SR1_ADDR)
+    {
+        if (b->Phase == PH_ADDR_W) _On_AddrWrite(b, x);
+        else                       _On_AddrRead(b, x);
+        return;
+    }
+
+    // 3. 缓冲区事件 (仅中断逐字节模式打开 ITBUFEN)
+    if (I2Cx->CR2 & I2C_CR2_ITBUFEN)
+    {
+        if (b->Phase == PH_TX && (sr1 & I2C_SR1_TXE))
+        {
+            I2Cx->DR = x->Buf[b->Idx++];
+            if (b->Idx >= x->Len) I2Cx->CR2 &= ~I2C_CR2_ITBUFEN; // 最后一个字节已装入，等待 BTF
+            return;
+        }
+        if (sr1 & I2C_SR1_RXNE)
+        {
+            if (b->Phase == PH_RX1)
+            {
+                x->Buf[0] = I2Cx->DR;
+                _Complete(b, I2C_XFER_OK);
+                return;
+            }
+            if (b->Phase == PH_RXN)
+            {
+                x->Buf[b->Idx++] = I2Cx->DR;
+                if (x->Len - b->Idx <= 3) I2Cx->CR2 &= ~I2C_CR2_ITBUFEN; // 最后 3 字节按 BTF 收尾
+                return;
+            }
+        }
+    }
+
+    // 4. 字节传输完成
+    if (sr1 & I2C_SR1_BTF) _On_BTF(b, x);
+}
+
+static void _ER_IRQHandler(I2C_Bus_t* b)
+{
+    I2C_TypeDef* I2Cx = b->I2Cx;
+    uint16_t sr1 = I2Cx->SR1;
+
+    I2Cx->SR1 = (uint16_t)~(sr1 & ERR_FLAGS); // 错误标志写 0 清除
+
+    if (b->Head == NULL) return;
+
+    if (sr1 & I2C_SR1_AF)
+    {
+        // 设备未应答: 发 STOP 结束本事务，总线本身正常，继续下一个
+        I2Cx->CR1 |= I2C_CR1_STOP;
+        _Complete(b, I2C_XFER_NACK);
+        return;
+    }
+
+    // 仲裁丢失时已不是主机，不能再发 STOP
+    if (!(sr1 & I2C_SR1_ARLO)) I2Cx->CR1 |= I2C_CR1_STOP;
+    I2Cx->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN);
+    _Abort_All(b, I2C_XFER_BUS_ERR);
+}
+
+void I2C1_EV_IRQHandler(void) { _EV_IRQHandler(&s_Bus[0]); }
+void I2C1_ER_IRQHandler(void) { _ER_IRQHandler(&s_Bus[0]); }
+void I2C2_EV_IRQHandler(void) { _EV_IRQHandler(&s_Bus[1]); }
+void I2C2_ER_IRQHandler(void) { _ER_IRQHandler(&s_Bus[1]); }
+
+/**
+  * @brief  I2C1 DMA 接收完成: 最后一个字节已由 LAST 位回 NACK，发 STOP 结束
+  */
+void DMA1_Channel7_IRQHandler(void)
+{
+    if (DMA_GetITStatus(DMA1_IT_TC7) != RESET)
+    {
+        DMA_ClearITPendingBit(DMA1_IT_TC7);
+        if (s_Bus[0].Head && s_Bus[0].Phase == PH_RX_DMA)
+        {
+            I2C1->CR1 |= I2C_CR1_STOP;
+            _Complete(&s_Bus[0], I2C_XFER_OK);
+        }
+    }
+}
+
+/* ============================================================
+ *                 接口实现
+ * ============================================================ */
+
+static void _Dma_Init(DMA_Channel_TypeDef* ch, I2C_TypeDef* I2Cx, uint32_t dir)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    DMA_DeInit(ch);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&I2Cx->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = 0;
+    DMA_InitStructure.DMA_DIR = dir;
+    DMA_InitStructure.DMA_BufferSize = 1;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(ch, &DMA_InitStructure);
+}
+
+static void _NVIC_Enable(uint8_t irq)
+{
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannel = irq;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0; // 勘误: I2C 事件必须及时响应
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+uint8_t I2C_HW_Init(I2C_TypeDef* I2Cx)
+{
+    I2C_Bus_t* b = _Bus(I2Cx);
+
+    s_CycPerUs = SystemCoreClock / 1000000;
+    b->Head = b->Tail = NULL;
+    b->Phase = PH_IDLE;
+    b->ConsecErr = 0;
+    b->NeedRecover = 0;
+    memset(&b->Stats, 0, sizeof(b->Stats));
+
+    // 1. 时钟
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB | RCC_APB2Periph_AFIO, ENABLE);
+    if (I2Cx == I2C1)
+    {
+        RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
+        GPIO_PinRemapConfig(GPIO_Remap_I2C1, ENABLE); // SCL/SDA -> PB8/PB9
+    }
+    else
+    {
+        RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C2, ENABLE);
+    }
+
+    // 2. 先用 GPIO 解锁总线 (上电时从机可能卡在半个字节)，再交给外设
+    _Bus_Clear(b);
+    _Pins_Config(b, GPIO_Mode_AF_OD);
+    _Periph_Reset(b);
+
+    // 3. DMA (仅 I2C1)
+    if (b->DmaTx)
+    {
+        RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+        _Dma_Init(b->DmaTx, I2Cx, DMA_DIR_PeripheralDST);
+        _Dma_Init(b->DmaRx, I2Cx, DMA_DIR_PeripheralSRC);
+        DMA_ITConfig(b->DmaRx, DMA_IT_TC, ENABLE); // 发送完成由 BTF 判定，不需要 TX 中断
+        _NVIC_Enable(DMA1_Channel7_IRQn);
+    }
+
+    // 4. 事件 / 错误中断
+    _NVIC_Enable(I2Cx == I2C1 ? I2C1_EV_IRQn : I2C2_EV_IRQn);
+    _NVIC_Enable(I2Cx == I2C1 ? I2C1_ER_IRQn : I2C2_ER_IRQn);
+
+    return (I2Cx->SR2 & I2C_SR2_BUSY) ? 1 : 0;
+}
+
+void I2C_HW_DeInit(I2C_TypeDef* I2Cx)
+{
+    I2C_Bus_t* b = _Bus(I2Cx);
+
+    __disable_irq();
+    I2Cx->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN);
+    _Abort_All(b, I2C_XFER_BUS_ERR);
+    __enable_irq();
+
+    NVIC_DisableIRQ(I2Cx == I2C1 ? I2C1_EV_IRQn : I2C2_EV_IRQn);
+    NVIC_DisableIRQ(I2Cx == I2C1 ? I2C1_ER_IRQn : I2C2_ER_IRQn);
+    if (b->DmaRx) NVIC_DisableIRQ(DMA1_Channel7_IRQn);
+
+    I2C_Cmd(I2Cx, DISABLE);
+    if (I2Cx == I2C1) GPIO_PinRemapConfig(GPIO_Remap_I2C1, DISABLE);
+    b->NeedRecover = 0;
+}
+
+void I2C_HW_Submit(I2C_TypeDef* I2Cx, I2C_Xfer_t* x)
+{
+    I2C_Bus_t* b = _Bus(I2Cx);
+
+    if (b->NeedRecover && b->Head == NULL) _Recover(b);
+
+    x->Status = I2C_XFER_PENDING;
+    x->BusUs = 0;
+    x->Next = NULL;
+
+    __disable_irq();
+    if (b->Tail)
+    {
+        b->Tail->Next = x;
+        b->Tail = x;
+    }
+    else
+    {
+        b->Head = b->Tail = x;
+        _Start_Head(b);
+    }
+    __enable_irq();
+}
+
+void I2C_HW_Poll(I2C_TypeDef* I2Cx)
+{
+    I2C_Bus_t* b = _Bus(I2Cx);
+
+    if (b->Head && (System_GetTick() - b->StartTick) > I2C_HW_TIMEOUT_MS)
+    {
+        __disable_irq();
+        if (b->Head) // 关中断后复查，可能刚好完成
+        {
+            I2Cx->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN);
+            _Abort_All(b, I2C_XFER_TIMEOUT);
+        }
+        __enable_irq();
+    }
+
+    if (b->NeedRecover && b->Head == NULL) _Recover(b);
+}
+
+uint8_t I2C_HW_IsFailed(I2C_TypeDef* I2Cx)
+{
+    return _Bus(I2Cx)->ConsecErr >= I2C_HW_MAX_BUS_ERR;
+}
+
+void I2C_HW_TakeStats(I2C_TypeDef* I2Cx, I2C_BusStats_t* stats)
+{
+    I2C_Bus_t* b = _Bus(I2Cx);
+    I2C_BusStats_t s;
+
+    __disable_irq();
+    s = b->Stats;
+    memset(&b->Stats, 0, sizeof(b->Stats));
+    __enable_irq();
+
+    stats->Xfers    += s.Xfers;
+    stats->Bytes    += s.Bytes;
+    stats->BusUs    += s.BusUs;
+    stats->Nacks    += s.Nacks;
+    stats->BusErrs  += s.BusErrs;
+    stats->Recovers += s.Recovers;
+}
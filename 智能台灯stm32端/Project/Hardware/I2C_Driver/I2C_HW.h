@@ -0,0 +1,49 @@
+/**
+  ******************************************************************************
+  * @file    I2C_HW.h
+  * @brief   STM32F103 硬件 I2C 主机驱动 (中断 / DMA 完成 + 事务队列)
+  * @note    由 I2C_Driver.c 调用，业务代码请使用 I2C_Lib_* 接口。
+  *          - I2C1 (PB8/PB9 重映射): DMA1 Ch6 (TX) / Ch7 (RX)
+  *          - I2C2 (PB10/PB11):      中断逐字节 (DMA1 Ch4/Ch5 已被 USART1 占用)
+  *          按 AN2824 / 勘误手册处理 F103 I2C 的时序要求:
+  *          接收 1 / 2 / 3 字节收尾的 ACK、POS、STOP 设置顺序，
+  *          I2C 中断使用最高抢占优先级，BUSY 锁死时用 SWRST + 9 个 SCL 脉冲恢复。
+  ******************************************************************************
+  */
+#ifndef __I2C_HW_H
+#define __I2C_HW_H
+
+#include "I2C_Driver.h"
+
+/**
+  * @brief  初始化硬件 I2C (GPIO 复用开漏、外设、DMA、NVIC)
+  * @retval 0: 成功, 1: 总线恢复后仍然 BUSY (应回退到软件模式)
+  */
+uint8_t I2C_HW_Init(I2C_TypeDef* I2Cx);
+
+/**
+  * @brief  关闭硬件 I2C，中止所有排队事务 (回退到软件模式前调用)
+  */
+void I2C_HW_DeInit(I2C_TypeDef* I2Cx);
+
+/**
+  * @brief  事务入队 (队列空闲时立即发起起始条件)
+  */
+void I2C_HW_Submit(I2C_TypeDef* I2Cx, I2C_Xfer_t* x);
+
+/**
+  * @brief  超时检查与错误恢复 (主循环上下文)
+  */
+void I2C_HW_Poll(I2C_TypeDef* I2Cx);
+
+/**
+  * @brief  连续总线错误次数是否已达到 I2C_HW_MAX_BUS_ERR
+  */
+uint8_t I2C_HW_IsFailed(I2C_TypeDef* I2Cx);
+
+/**
+  * @brief  统计累加到 stats 并清零内部计数
+  */
+void I2C_HW_TakeStats(I2C_TypeDef* I2Cx, I2C_BusStats_t* stats);
+
+#endif
@@ -1,62 +1,181 @@
+/**
+ * @file LDR.c
+ * @brief 光敏电阻驱动实现 (V2.0 ADC + DMA)
+ * @note  采样链路: TIM1 CC1 (LDR_SAMPLE_RATE_HZ) -> ADC1 单次转换 -> DMA1_Ch1 循环写入
+ *        s_DmaBuf (2 个块)。DMA 半满 / 全满中断时，另一半正在被写入，当前一半可安全读取:
+ *          块平均: 每块 LDR_BLOCK_SAMPLES 点求和，缩放为 x16 的 16 位值 (过采样抽取)
+ *          IIR:    y += (x - y) / 2^LDR_IIR_SHIFT
+ *        块长取 10ms，正好是 50Hz 市电灯光闪烁 (100Hz) 的一个周期，块平均即可滤掉闪烁。
+ */
 #include "LDR.h"
+#include "Config.h"
+
+#define LDR_BUF_LEN     (LDR_BLOCK_SAMPLES * 2)
+
+static volatile uint16_t s_DmaBuf[LDR_BUF_LEN];
+
+static volatile uint16_t s_BlockRaw = 0;    // 最近一块的平均值 (0-4095)
+static volatile uint16_t s_Filtered = 0;    // IIR 输出 (0-65520)
+static volatile uint32_t s_BlockCount = 0;
+static uint32_t s_IirAcc = 0;               // IIR 状态: y << LDR_IIR_SHIFT
+
+/**
+ * @brief 处理一个块: 平均 + IIR (DMA 中断上下文)
+ */
+static void LDR_ProcessBlock(const volatile uint16_t *p)
+{
+    uint32_t sum = 0;
+    uint16_t x;
+    uint16_t i;
+
+    for (i = 0; i < LDR_BLOCK_SAMPLES; i++) sum += p[i];
+
+    x = (uint16_t)((sum * 16u) / LDR_BLOCK_SAMPLES);   // 0-65520
+    s_BlockRaw = (uint16_t)(sum / LDR_BLOCK_SAMPLES);
+
+    if (s_BlockCount == 0)
+    {
+        s_IirAcc = (uint32_t)x << LDR_IIR_SHIFT;        // 第一块直接作为初值，避免上电爬升
+    }
+    else
+    {
+        s_IirAcc = s_IirAcc - (s_IirAcc >> LDR_IIR_SHIFT) + x;
+    }
+    s_Filtered = (uint16_t)(s_IirAcc >> LDR_IIR_SHIFT);
+    s_BlockCount++;
+}
+
+void DMA1_Channel1_IRQHandler(void)
+{
+    if (DMA_GetITStatus(DMA1_IT_HT1) != RESET)
+    {
+        DMA_ClearITPendingBit(DMA1_IT_HT1);
+        LDR_ProcessBlock(&s_DmaBuf[0]);
+    }
+    if (DMA_GetITStatus(DMA1_IT_TC1) != RESET)
+    {
+        DMA_ClearITPendingBit(DMA1_IT_TC1);
+        LDR_ProcessBlock(&s_DmaBuf[LDR_BLOCK_SAMPLES]);
+    }
+}
+
+/**
+ * @brief TIM1 CC1 作为 ADC 触发源 (PA8 保持默认输入，不输出波形)
+ */
+static void LDR_Trigger_Init(void)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM1, ENABLE);
+
+    TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInitStructure.TIM_Period = 1000000 / LDR_SAMPLE_RATE_HZ - 1;
+    TIM_TimeBaseInitStructure.TIM_Prescaler = 72 - 1;       // 1MHz
+    TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(TIM1, &TIM_TimeBaseInitStructure);
+
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
+    TIM_OCInitStructure.TIM_Pulse = (1000000 / LDR_SAMPLE_RATE_HZ) / 2;
+    TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+    TIM_OC1Init(TIM1, &TIM_OCInitStructure);
+
+    // 高级定时器的比较事件需要 MOE 才能触发 ADC
+    TIM_CtrlPWMOutputs(TIM1, ENABLE);
+    TIM_Cmd(TIM1, ENABLE);
+}
 
 void LDR_Init(void)
 {
-    // 1. 开启 GPIOA 和 ADC1 时钟
+    GPIO_InitTypeDef GPIO_InitStructure;
+    ADC_InitTypeDef ADC_InitStructure;
+    DMA_InitTypeDef DMA_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    // 1. 开启 GPIOA、ADC1 和 DMA1 时钟
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_ADC1, ENABLE);
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
     
     // 2. 配置 ADC 时钟分频 (72MHz / 6 = 12MHz, 不超过 14MHz)
     RCC_ADCCLKConfig(RCC_PCLK2_Div6);
 
     // 3. 配置 PA0 为模拟输入
-    GPIO_InitTypeDef GPIO_InitStructure;
     GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;
     GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;
     GPIO_Init(GPIOA, &GPIO_InitStructure);
 
-    // 4. ADC 初始化
-    ADC_InitTypeDef ADC_InitStructure;
+    // 4. DMA1_Ch1: ADC1->DR -> s_DmaBuf，循环模式，半满 / 全满中断
+    DMA_DeInit(DMA1_Channel1);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ADC1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)s_DmaBuf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = LDR_BUF_LEN;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel1, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel1, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+    // 块处理只是几十次加法，最低优先级即可 (下一半写满前有 10ms)
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel1_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+    DMA_Cmd(DMA1_Channel1, ENABLE);
+
+    // 5. ADC 初始化: 单通道，每次 TIM1_CC1 事件转换一次
     ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;
     ADC_InitStructure.ADC_ScanConvMode = DISABLE;
     ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;
-    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None;
+    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T1_CC1;
     ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
     ADC_InitStructure.ADC_NbrOfChannel = 1;
     ADC_Init(ADC1, &ADC_InitStructure);
 
-    // 5. 使能 ADC 并校准
+    // 光敏分压源阻抗较高，用最长采样时间 (239.5 + 12.5 周期 = 21us @12MHz)
+    ADC_RegularChannelConfig(ADC1, ADC_Channel_0, 1, ADC_SampleTime_239Cycles5);
+    ADC_DMACmd(ADC1, ENABLE);
+
+    // 6. 使能 ADC 并校准
     ADC_Cmd(ADC1, ENABLE);
     
     ADC_ResetCalibration(ADC1);
     while(ADC_GetResetCalibrationStatus(ADC1));
     ADC_StartCalibration(ADC1);
     while(ADC_GetCalibrationStatus(ADC1));
+
+    // 7. 打开外部触发，启动触发定时器
+    ADC_ExternalTrigConvCmd(ADC1, ENABLE);
+    LDR_Trigger_Init();
 }
 
 uint16_t LDR_GetRawValue(void)
 {
-    // 设置序列、通道和采样时间
-    ADC_RegularChannelConfig(ADC1, ADC_Channel_0, 1, ADC_SampleTime_55Cycles5);
-    
-    // 软件触发转换
-    ADC_SoftwareStartConvCmd(ADC1, ENABLE);
-    
-    // 等待转换完成
-    while(ADC_GetFlagStatus(ADC1, ADC_FLAG_EOC) == RESET);
-    
-    return ADC_GetConversionValue(ADC1);
+    return s_BlockRaw;
+}
+
+uint16_t LDR_GetFiltered(void)
+{
+    return s_Filtered;
+}
+
+uint32_t LDR_GetBlockCount(void)
+{
+    return s_BlockCount;
 }
 
 uint16_t LDR_GetLuxPercentage(void)
 {
-    uint32_t sum = 0;
-    // 连续采样 8 次取平均值，滤除高频噪声
-    for(int i = 0; i < 8; i++) {
-        sum += LDR_GetRawValue();
-    }
-    uint16_t avg = sum / 8;
-    
-    // 将 0-4095 映射到 0-1000
+    // 将 0-65520 映射到 0-1000
     // 注意：如果你的电路是光强越大电压越高，直接映射即可
-    return (uint16_t)((avg * 1000) / 4095);
+    return (uint16_t)(((uint32_t)s_Filtered * 1000) / 65520);
 }
@@ -1,6 +1,9 @@
 /**
  * @file LDR.h
  * @brief 光敏电阻驱动，使用 ADC1_IN0 (PA0)
+ * @note  V2.0: TIM1_CC1 定时触发 ADC1，DMA1_Ch1 循环搬运到双缓冲，
+ *        半满 / 全满中断里做块平均 (过采样抽取) 和一阶 IIR 滤波，
+ *        读取接口只返回最新结果，不再阻塞等待转换。
  */
 #ifndef __LDR_H
 #define __LDR_H
@@ -8,13 +11,13 @@
 #include "stm32f10x.h"
 
 /**
- * @brief 初始化 LDR 所需的 ADC 和 GPIO
+ * @brief 初始化 LDR 所需的 ADC、DMA、触发定时器和 GPIO，初始化后自动持续采样
  */
 void LDR_Init(void);
 
 /**
  * @brief 获取当前环境光强度原始值
- * @return uint16_t ADC 采样值 (0-4095)
+ * @return uint16_t 最近一个块 (LDR_BLOCK_SAMPLES 次采样) 的平均值 (0-4095)
  */
 uint16_t LDR_GetRawValue(void);
 
@@ -24,4 +27,15 @@ uint16_t LDR_GetRawValue(void);
  */
 uint16_t LDR_GetLuxPercentage(void);
 
+/**
+ * @brief [新增] 获取 IIR 滤波后的高分辨率值 (供闭环控制使用)
+ * @return uint16_t 0-65520 (12 位 ADC 值 x16，过采样带来额外的有效位)
+ */
+uint16_t LDR_GetFiltered(void);
+
+/**
+ * @brief [新增] 已完成的块数 (每 LDR_BLOCK_SAMPLES 次采样加 1，可用于判断数据是否更新)
+ */
+uint32_t LDR_GetBlockCount(void);
+
 #endif
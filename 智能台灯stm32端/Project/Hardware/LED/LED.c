@@ -2,26 +2,75 @@
   ******************************************************************************
   * @file    LED.c
   * @author  XYY
-  * @version V1.1
+  * @version V2.1
   * @date    2023-10-27
   * @brief   LED驱动模块实现，基于 TIM3 PWM 模式
+  * @note    [V2.0] 15 位 PWM + 时间抖动:
+  *          - TIM3 不分频，ARR = 32767，PWM 频率 72MHz / 32768 = 2.197kHz
+  *            (高于 IEEE 1789 建议的 1.25kHz 低风险频闪限值)。
+  *          - 占空比以 Q4 (计数值 x16) 给出，小数部分由 LED_Dither_Fill 展开为 16 个 PWM
+  *            周期的比较值序列，存放在 s_DitherBuf (CCR1 / CCR2 交错)。
+  *          - TIM3 更新事件触发 DMA1_Ch3，经 DMAR 突发写入 CCR1、CCR2，循环模式，
+  *            每个 PWM 周期换一组比较值，全程无 CPU 参与；比较值预装载，下个周期生效。
+  *          [V2.1] 渐变引擎 (LED_Fade.c): 缓冲区扩为两个块，渐变期间打开 DMA 半满 / 全满
+  *          中断，每读完一个块填充下一个过渡块；渐变结束后关闭中断，回到静止抖动。
   ******************************************************************************
   */
 
 #include "LED.h"
 
+// [新增] 两个块的抖动 / 过渡序列: [帧][0] = CCR1 (暖), [帧][1] = CCR2 (冷)
+static uint16_t s_DitherBuf[LED_BLOCK_LEN * 2];
+
+// [新增] 渐变状态 (主循环与 DMA 中断共用，主循环修改前先关中断)
+static LED_Fade_t s_Fade;
+
+static void _FadeIT(FunctionalState state)
+{
+    DMA_ITConfig(DMA1_Channel3, DMA_IT_HT | DMA_IT_TC, state);
+}
+
+/**
+  * @brief  静止输出: 两个块写成同一组抖动序列 (调用前需已关闭渐变中断)
+  */
+static void _Hold(void)
+{
+    s_Fade.State = LED_FADE_IDLE;
+    LED_Fade_Hold(&s_Fade, &s_DitherBuf[0]);
+    LED_Fade_Hold(&s_Fade, &s_DitherBuf[LED_BLOCK_LEN]);
+}
+
+void DMA1_Channel3_IRQHandler(void)
+{
+    uint8_t more = 1;
+
+    // 读完的那一半在另一半播放完之后才会再被读取，有 7.3ms 的填充时间
+    if (DMA_GetITStatus(DMA1_IT_HT3) != RESET)
+    {
+        DMA_ClearITPendingBit(DMA1_IT_HT3);
+        more = LED_Fade_Refill(&s_Fade, &s_DitherBuf[0]);
+    }
+    if (DMA_GetITStatus(DMA1_IT_TC3) != RESET)
+    {
+        DMA_ClearITPendingBit(DMA1_IT_TC3);
+        more = LED_Fade_Refill(&s_Fade, &s_DitherBuf[LED_BLOCK_LEN]);
+    }
+    if (!more) _FadeIT(DISABLE);
+}
+
 /**
   * @brief  LED PWM 初始化函数
   * @note   配置 TIM3 为 PWM 模式 1
   *         频率计算: 72MHz / (PSC+1) / (ARR+1)
-  *         设定频率 1kHz, 分辨率 1000级:
-  *         72,000,000 / 72 / 1000 = 1000Hz
+  *         设定频率 2.197kHz, 分辨率 32768级:
+  *         72,000,000 / 1 / 32768 = 2197Hz
   */
 void LED_Init(void)
 {
     /* 1. 开启时钟 */
     RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);    // 开启 TIM3 时钟
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);   // 开启 GPIOA 时钟
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);      // [新增] 开启 DMA1 时钟
 
     /* 2. 配置 GPIO (PA6, PA7) */
     GPIO_InitTypeDef GPIO_InitStructure;
@@ -35,9 +84,9 @@ void LED_Init(void)
     TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
     TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
     
-    // 目标频率 1kHz, 分辨率 1000级
-    TIM_TimeBaseInitStructure.TIM_Prescaler = 72 - 1;       // PSC: 预分频器 (72M / 72 = 1MHz 计数频率)
-    TIM_TimeBaseInitStructure.TIM_Period = 1000 - 1;        // ARR: 自动重装值 (1MHz / 1000 = 1kHz PWM频率)
+    // 目标频率 2.197kHz, 分辨率 32768级
+    TIM_TimeBaseInitStructure.TIM_Prescaler = 0;                    // PSC: 不分频 (72MHz 计数频率)
+    TIM_TimeBaseInitStructure.TIM_Period = LED_PWM_PERIOD - 1;      // ARR: 72MHz / 32768 = 2.197kHz
     TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0;
     TIM_TimeBaseInit(TIM3, &TIM_TimeBaseInitStructure);
 
@@ -54,10 +103,134 @@ void LED_Init(void)
     // 配置通道 2 (PA7 - Cold/Blue)
     TIM_OC2Init(TIM3, &TIM_OCInitStructure);
 
-    /* 5. 启动定时器 */
+    // [新增] 比较值预装载: DMA 在周期开头写入，下一个周期整体生效，不产生半截脉冲
+    TIM_OC1PreloadConfig(TIM3, TIM_OCPreload_Enable);
+    TIM_OC2PreloadConfig(TIM3, TIM_OCPreload_Enable);
+    TIM_ARRPreloadConfig(TIM3, ENABLE);
+
+    /* 5. [新增] 配置 DMA1_Ch3 (TIM3_UP): s_DitherBuf -> TIM3->DMAR，循环模式 */
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_DeInit(DMA1_Channel3);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&TIM3->DMAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)s_DitherBuf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = LED_BLOCK_LEN * 2;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Low;      // 一个 PWM 周期 (455us) 内完成即可
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel3, &DMA_InitStructure);
+    DMA_Cmd(DMA1_Channel3, ENABLE);
+
+    // [新增] 渐变填充中断: 只在渐变期间打开，计算量为一次混光 + 32 次插值
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel3_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    LED_Fade_Set(&s_Fade, 0, 0);
+
+    // 每个更新事件突发 2 次传输: DMAR -> CCR1, CCR2
+    TIM_DMAConfig(TIM3, TIM_DMABase_CCR1, TIM_DMABurstLength_2Transfers);
+    TIM_DMACmd(TIM3, TIM_DMA_Update, ENABLE);
+
+    /* 6. 启动定时器 */
     TIM_Cmd(TIM3, ENABLE);
 }
 
+/**
+  * @brief  [新增] 按感知亮度 / 色温立即输出 (打断正在进行的渐变)
+  * @param  bri 亮度 0~1000
+  * @param  cct 色温 0 (全暖) ~ 1000 (全冷)
+  */
+void LED_SetLevel(uint16_t bri, uint16_t cct)
+{
+    _FadeIT(DISABLE);
+    LED_Fade_Set(&s_Fade, bri, cct);
+    _Hold();
+}
+
+/**
+  * @brief  [新增] 从当前输出渐变到目标亮度 / 色温
+  * @param  ms   时长，0 表示立即设置
+  * @param  ease 缓动曲线 (LED_Ease_t)
+  * @note   渐变中途再次调用时从当前位置继续；过渡值由 DMA 逐 PWM 周期写入
+  */
+void LED_FadeTo(uint16_t bri, uint16_t cct, uint32_t ms, uint8_t ease)
+{
+    if (ms == 0)
+    {
+        LED_SetLevel(bri, cct);
+        return;
+    }
+
+    _FadeIT(DISABLE);
+    if (s_Fade.State == LED_FADE_IDLE)
+    {
+        // 静止时两半内容相同，填充 DMA 当前未读取的那一半即可开始
+        uint16_t *next = (DMA_GetCurrDataCounter(DMA1_Channel3) > LED_BLOCK_LEN) ?
+                         &s_DitherBuf[LED_BLOCK_LEN] : &s_DitherBuf[0];
+        LED_Fade_Start(&s_Fade, bri, cct, ms, ease);
+        LED_Fade_Refill(&s_Fade, next);
+        DMA_ClearITPendingBit(DMA1_IT_HT3 | DMA1_IT_TC3);
+    }
+    else
+    {
+        // 渐变中: 已排队的块保持不变，后续块沿新曲线继续
+        LED_Fade_Start(&s_Fade, bri, cct, ms, ease);
+    }
+    _FadeIT(ENABLE);
+}
+
+/**
+  * @brief  [新增] 是否正在渐变
+  */
+uint8_t LED_IsFading(void)
+{
+    return s_Fade.State != LED_FADE_IDLE;
+}
+
+/**
+  * @brief  [新增] 设置暖光占空比 (Q4)
+  * @param  DutyQ4 占空比，范围 0~LED_DUTY_MAX_Q4
+  * @retval 无
+  */
+void LED_SetWarmQ4(uint32_t DutyQ4)
+{
+    _FadeIT(DISABLE);
+    s_Fade.WarmQ4 = (DutyQ4 > LED_DUTY_MAX_Q4) ? LED_DUTY_MAX_Q4 : DutyQ4;
+    _Hold();
+}
+
+/**
+  * @brief  [新增] 设置冷光占空比 (Q4)
+  * @param  DutyQ4 占空比，范围 0~LED_DUTY_MAX_Q4
+  * @retval 无
+  */
+void LED_SetColdQ4(uint32_t DutyQ4)
+{
+    _FadeIT(DISABLE);
+    s_Fade.ColdQ4 = (DutyQ4 > LED_DUTY_MAX_Q4) ? LED_DUTY_MAX_Q4 : DutyQ4;
+    _Hold();
+}
+
+/**
+  * @brief  [新增] 同时设置双色温占空比 (Q4)
+  * @note   DMA 正在循环读取缓冲区，更新过程中最多有一组 (7.3ms) 新旧值混合，人眼不可见；
+  *         直接设置占空比后，下一次渐变仍从最近一次 LED_SetLevel / LED_FadeTo 的位置起算
+  */
+void LED_SetDualColorQ4(uint32_t WarmQ4, uint32_t ColdQ4)
+{
+    _FadeIT(DISABLE);
+    s_Fade.WarmQ4 = (WarmQ4 > LED_DUTY_MAX_Q4) ? LED_DUTY_MAX_Q4 : WarmQ4;
+    s_Fade.ColdQ4 = (ColdQ4 > LED_DUTY_MAX_Q4) ? LED_DUTY_MAX_Q4 : ColdQ4;
+    _Hold();
+}
+
 /**
   * @brief  设置暖光（黄灯）亮度
   * @param  Brightness 亮度占空比，范围 0~1000
@@ -67,7 +240,7 @@ void LED_SetWarm(uint16_t Brightness)
 {
     // 限制范围防止越界
     if (Brightness > 1000) Brightness = 1000;
-    TIM_SetCompare1(TIM3, Brightness); // 修改 CCR1
+    LED_SetWarmQ4((uint32_t)Brightness * LED_DUTY_MAX_Q4 / 1000);
 }
 
 /**
@@ -79,7 +252,7 @@ void LED_SetCold(uint16_t Brightness)
 {
     // 限制范围防止越界
     if (Brightness > 1000) Brightness = 1000;
-    TIM_SetCompare2(TIM3, Brightness); // 修改 CCR2
+    LED_SetColdQ4((uint32_t)Brightness * LED_DUTY_MAX_Q4 / 1000);
 }
 
 /**
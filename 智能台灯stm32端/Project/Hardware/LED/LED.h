@@ -2,9 +2,11 @@
   ******************************************************************************
   * @file    LED.h
   * @author  XYY
-  * @version V1.1
+  * @version V2.1
   * @date    2023-10-27
-  * @brief   LED驱动模块头文件，提供双色温PWM控制接口 (1000级分辨率)
+  * @brief   LED驱动模块头文件，提供双色温PWM控制接口 (15 位 PWM + 4 位时间抖动)
+  * @note    [V2.0] 感知亮度 / 色温到占空比的换算见 LED_Mix.h；
+  *          LED_SetWarm / LED_SetCold / LED_SetDualColor 保留为线性 0~1000 占空比接口
   ******************************************************************************
   */
 
@@ -12,15 +14,65 @@
 #define __LED_H
 
 #include "stm32f10x.h"
+#include "LED_Mix.h"
+#include "LED_Fade.h"
 
 /**
   * @brief  LED PWM 初始化函数
   * @param  无
   * @retval 无
   * @note   初始化 PA6(TIM3_CH1) 和 PA7(TIM3_CH2) 为复用推挽输出，并启动 PWM
+  *         [V2.0] 占用 DMA1_Ch3 (TIM3_UP) 循环刷新比较值
   */
 void LED_Init(void);
 
+/**
+  * @brief  [新增] 按感知亮度 / 色温立即输出 (经 LED_Mix 查找表，打断正在进行的渐变)
+  * @param  bri 亮度 0~1000
+  * @param  cct 色温 0 (全暖) ~ 1000 (全冷)
+  * @retval 无
+  */
+void LED_SetLevel(uint16_t bri, uint16_t cct);
+
+/**
+  * @brief  [新增] 从当前输出渐变到目标亮度 / 色温
+  * @param  bri  目标亮度 0~1000
+  * @param  cct  目标色温 0~1000
+  * @param  ms   时长 (ms)，0 表示立即设置
+  * @param  ease 缓动曲线 (LED_Ease_t)
+  * @retval 无
+  * @note   过渡值由 DMA 逐 PWM 周期写入，CPU 每 7.3ms 填充一个块；中途再次调用从当前位置继续
+  */
+void LED_FadeTo(uint16_t bri, uint16_t cct, uint32_t ms, uint8_t ease);
+
+/**
+  * @brief  [新增] 是否正在渐变
+  * @retval 1: 渐变中
+  */
+uint8_t LED_IsFading(void);
+
+/**
+  * @brief  [新增] 设置暖光占空比 (Q4, 计数值 x16)
+  * @param  DutyQ4 范围 0~LED_DUTY_MAX_Q4，低 4 位由时间抖动实现
+  * @retval 无
+  */
+void LED_SetWarmQ4(uint32_t DutyQ4);
+
+/**
+  * @brief  [新增] 设置冷光占空比 (Q4, 计数值 x16)
+  * @param  DutyQ4 范围 0~LED_DUTY_MAX_Q4，低 4 位由时间抖动实现
+  * @retval 无
+  */
+void LED_SetColdQ4(uint32_t DutyQ4);
+
+/**
+  * @brief  [新增] 同时设置双色温占空比 (Q4)
+  * @param  WarmQ4 暖光占空比
+  * @param  ColdQ4 冷光占空比
+  * @retval 无
+  */
+void LED_SetDualColorQ4(uint32_t WarmQ4, uint32_t ColdQ4);
+
 /**
   * @brief  设置暖光（黄灯）亮度
   * @param  Brightness 亮度占空比，范围 0~1000
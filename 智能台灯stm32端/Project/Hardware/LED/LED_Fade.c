@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    LED_Fade.c
+  * @brief   LED 渐变引擎实现
+  ******************************************************************************
+  */
+#include "LED_Fade.h"
+
+#define LED_FADE_MAX_MS 600000u     // 块数 x 32768 不超过 32 位 (协议层另有 Config.h 的 FADE_MAX_MS)
+
+/**
+  * @brief  块内按 PWM 周期从 q0 线性过渡到 q1，跨帧误差扩散 (平均值与插值曲线一致)
+  */
+static void _Ramp(uint16_t *dst, uint32_t q0, uint32_t q1, uint8_t *acc)
+{
+    int32_t diff = (int32_t)q1 - (int32_t)q0;
+
+    for (uint8_t k = 1; k <= LED_DITHER_FRAMES; k++)
+    {
+        uint32_t s = (uint32_t)((int32_t)q0 + diff * k / (int32_t)LED_DITHER_FRAMES) + *acc;
+        *dst = (uint16_t)(s >> LED_DITHER_BITS);
+        *acc = (uint8_t)(s & (LED_DITHER_FRAMES - 1));
+        dst += 2;
+    }
+}
+
+uint16_t LED_Ease(uint8_t ease, uint16_t t_q15)
+{
+    uint32_t t = (t_q15 > 32768) ? 32768 : t_q15;
+
+    switch (ease)
+    {
+        case LED_EASE_IN:     return (uint16_t)((t * t) >> 15);
+        case LED_EASE_OUT:    return (uint16_t)((t * (65536 - t)) >> 15);
+        case LED_EASE_IN_OUT: return (uint16_t)((((t * t) >> 15) * (98304 - 2 * t)) >> 15);
+        default:              return (uint16_t)t;
+    }
+}
+
+void LED_Fade_Set(LED_Fade_t *f, uint16_t bri, uint16_t cct)
+{
+    f->Bri = f->Bri0 = f->Bri1 = (uint32_t)(bri > 1000 ? 1000 : bri) << 4;
+    f->Cct = f->Cct0 = f->Cct1 = (cct > 1000) ? 1000 : cct;
+    f->State = LED_FADE_IDLE;
+    LED_Mix_Fine(f->Bri, f->Cct, &f->WarmQ4, &f->ColdQ4);
+}
+
+void LED_Fade_Start(LED_Fade_t *f, uint16_t bri, uint16_t cct, uint32_t ms, uint8_t ease)
+{
+    if (ms > LED_FADE_MAX_MS) ms = LED_FADE_MAX_MS;
+
+    // 从最近一个块末端继续，WarmQ4 / ColdQ4 与累加器保持不变，过渡连续
+    f->Bri0 = f->Bri;
+    f->Cct0 = f->Cct;
+    f->Bri1 = (uint32_t)(bri > 1000 ? 1000 : bri) << 4;
+    f->Cct1 = (cct > 1000) ? 1000 : cct;
+    f->Ease = ease;
+    f->Blocks = (ms * 1000 + LED_BLOCK_US / 2) / LED_BLOCK_US;
+    if (f->Blocks == 0) f->Blocks = 1;
+    f->Elapsed = 0;
+    f->State = LED_FADE_RUN;
+}
+
+uint8_t LED_Fade_Refill(LED_Fade_t *f, uint16_t *block)
+{
+    uint32_t warm, cold;
+
+    switch (f->State)
+    {
+        case LED_FADE_RUN:
+        {
+            f->Elapsed++;
+            uint16_t e = LED_Ease(f->Ease, (uint16_t)((f->Elapsed * 32768u) / f->Blocks));
+            f->Bri = (uint32_t)((int32_t)f->Bri0 + ((int32_t)f->Bri1 - (int32_t)f->Bri0) * e / 32768);
+            f->Cct = (uint16_t)((int32_t)f->Cct0 + ((int32_t)f->Cct1 - (int32_t)f->Cct0) * e / 32768);
+
+            LED_Mix_Fine(f->Bri, f->Cct, &warm, &cold);
+            _Ramp(&block[0], f->WarmQ4, warm, &f->AccW);
+            _Ramp(&block[1], f->ColdQ4, cold, &f->AccC);
+            f->WarmQ4 = warm;
+            f->ColdQ4 = cold;
+
+            if (f->Elapsed >= f->Blocks) f->State = LED_FADE_TAIL;
+            return 1;
+        }
+
+        // 最后一个过渡块可能还在另一半里播放，两半都写成终值后才能停止刷新
+        case LED_FADE_TAIL:
+            LED_Fade_Hold(f, block);
+            f->State = LED_FADE_TAIL2;
+            return 1;
+
+        case LED_FADE_TAIL2:
+            LED_Fade_Hold(f, block);
+            f->State = LED_FADE_IDLE;
+            return 0;
+
+        default:
+            LED_Fade_Hold(f, block);
+            return 0;
+    }
+}
+
+void LED_Fade_Hold(const LED_Fade_t *f, uint16_t *block)
+{
+    LED_Dither_Fill(f->WarmQ4, &block[0], 2);
+    LED_Dither_Fill(f->ColdQ4, &block[1], 2);
+}
@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    LED_Fade.h
+  * @brief   LED 渐变引擎: 按缓动曲线从当前亮度 / 色温过渡到目标值
+  * @note    - LED.c 的 DMA 循环缓冲分为两半，每半是一个块 (LED_DITHER_FRAMES 个 PWM 周期，
+  *            7.3ms)。DMA 读完一半时由中断调用 LED_Fade_Refill 填充这一半的下一个块。
+  *          - 缓动曲线按块计算 (亮度带 4 位小数，在感知亮度域插值)，块内按 PWM 周期
+  *            对 Q4 占空比线性插值并做误差扩散，每个 PWM 周期的比较值都不同，由 DMA 写入，
+  *            CPU 只在块边界参与 (约 137 次 / 秒)。
+  *          - 渐变中途重新设定目标时从当前位置继续，不会跳变。
+  *          本文件不依赖硬件，可在主机上编译测试。
+  ******************************************************************************
+  */
+#ifndef __LED_FADE_H
+#define __LED_FADE_H
+
+#include <stdint.h>
+#include "LED_Mix.h"
+
+// 一个块的时长 (us): 16 x 32768 / 72MHz
+#define LED_TIM_CLK_MHZ         72
+#define LED_BLOCK_US            (LED_DUTY_MAX_Q4 / LED_TIM_CLK_MHZ)
+
+// 一个块在缓冲区中占用的元素数 (CCR1 / CCR2 交错)
+#define LED_BLOCK_LEN           (LED_DITHER_FRAMES * 2)
+
+/** @brief 缓动曲线 (与协议 "ease" 字段取值一致) */
+typedef enum {
+    LED_EASE_LINEAR = 0,    // 匀速
+    LED_EASE_IN,            // 先慢后快 t^2
+    LED_EASE_OUT,           // 先快后慢 1-(1-t)^2
+    LED_EASE_IN_OUT         // 两头慢 3t^2-2t^3
+} LED_Ease_t;
+
+typedef enum {
+    LED_FADE_IDLE = 0,      // 静止: 两半缓冲都是同一组抖动序列
+    LED_FADE_RUN,           // 正在输出过渡块
+    LED_FADE_TAIL,          // 最后一个过渡块正在播放，本半已改为终值
+    LED_FADE_TAIL2          // 另一半也改为终值后回到 IDLE
+} LED_FadeState_t;
+
+typedef struct {
+    uint32_t Bri0, Bri1;        // 起点 / 终点亮度 (x16)
+    uint16_t Cct0, Cct1;        // 起点 / 终点色温
+    uint32_t Bri;               // 最近一个块末端的亮度 (x16)
+    uint16_t Cct;
+    uint32_t Blocks;            // 总块数
+    uint32_t Elapsed;           // 已输出块数
+    uint8_t  Ease;
+    uint8_t  State;
+    uint32_t WarmQ4, ColdQ4;    // 最近一个块末端的占空比
+    uint8_t  AccW, AccC;        // 跨帧误差扩散累加器
+} LED_Fade_t;
+
+/**
+  * @brief  静止设置到指定亮度 / 色温 (不渐变)，之后用 LED_Fade_Hold 填充缓冲
+  */
+void LED_Fade_Set(LED_Fade_t *f, uint16_t bri, uint16_t cct);
+
+/**
+  * @brief  从当前位置开始渐变
+  * @param  ms:   时长，换算为块数 (至少 1 块)
+  * @param  ease: LED_Ease_t
+  * @note   调用后需立即用 LED_Fade_Refill 填充 DMA 当前未读取的那一半
+  */
+void LED_Fade_Start(LED_Fade_t *f, uint16_t bri, uint16_t cct, uint32_t ms, uint8_t ease);
+
+/**
+  * @brief  填充一个块 (DMA 读完这一半时调用)
+  * @retval 1: 仍需继续填充; 0: 两半缓冲均已是终值，可关闭中断
+  */
+uint8_t LED_Fade_Refill(LED_Fade_t *f, uint16_t *block);
+
+/**
+  * @brief  用当前占空比的静止抖动序列填充一个块
+  */
+void LED_Fade_Hold(const LED_Fade_t *f, uint16_t *block);
+
+/**
+  * @brief  缓动曲线
+  * @param  t_q15: 进度 0~32768
+  * @retval 0~32768
+  */
+uint16_t LED_Ease(uint8_t ease, uint16_t t_q15);
+
+#endif
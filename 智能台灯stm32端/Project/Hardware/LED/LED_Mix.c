@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    LED_Mix.c
+  * @brief   感知亮度校正 / 恒光通量混光 / 时间抖动实现
+  ******************************************************************************
+  */
+#include "LED_Mix.h"
+
+#define GAIN_SHIFT      12      // 光通量补偿系数 Q12 (Q4 占空比最大 2^19，相乘不超过 32 位)
+
+static uint16_t s_WarmGain = 1u << GAIN_SHIFT;
+static uint16_t s_ColdGain = 1u << GAIN_SHIFT;
+
+void LED_Mix_Init(uint16_t warm_flux, uint16_t cold_flux)
+{
+    if (warm_flux == 0 || cold_flux == 0)
+    {
+        s_WarmGain = s_ColdGain = 1u << GAIN_SHIFT;
+        return;
+    }
+
+    // 以较暗的一路为基准，较亮的一路降额
+    uint16_t ref = (warm_flux < cold_flux) ? warm_flux : cold_flux;
+    s_WarmGain = (uint16_t)((((uint32_t)ref << GAIN_SHIFT) + warm_flux / 2) / warm_flux);
+    s_ColdGain = (uint16_t)((((uint32_t)ref << GAIN_SHIFT) + cold_flux / 2) / cold_flux);
+}
+
+uint32_t LED_Mix_Linear(uint16_t level)
+{
+    return LED_Mix_LinearFine((uint32_t)level << 4);
+}
+
+uint32_t LED_Mix_LinearFine(uint32_t level_x16)
+{
+    if (level_x16 >= 16000) return LED_DUTY_MAX_Q4;
+
+    // 表位置 Q8: level / 1000 * 256
+    uint32_t pos = (level_x16 << 12) / 1000;
+    uint32_t idx = pos >> 8;
+    uint32_t frac = pos & 0xFF;
+
+    // 插值结果 Q24 (表值 Q16 x 256)，再换算为 Q4 占空比 (满量程 2^19)
+    uint32_t y = ((uint32_t)LED_CIE_LUT[idx] << 8) + (LED_CIE_LUT[idx + 1] - LED_CIE_LUT[idx]) * frac;
+    return (y + 16) >> 5;
+}
+
+void LED_Mix(uint16_t bri, uint16_t cct, uint32_t *warm_q4, uint32_t *cold_q4)
+{
+    LED_Mix_Fine((uint32_t)bri << 4, cct, warm_q4, cold_q4);
+}
+
+void LED_Mix_Fine(uint32_t bri_x16, uint16_t cct, uint32_t *warm_q4, uint32_t *cold_q4)
+{
+    if (cct > 1000) cct = 1000;
+
+    uint32_t y = LED_Mix_LinearFine(bri_x16);
+    uint32_t cold = y * cct / 1000;
+    uint32_t warm = y - cold;
+
+    *warm_q4 = (warm * s_WarmGain + (1u << (GAIN_SHIFT - 1))) >> GAIN_SHIFT;
+    *cold_q4 = (cold * s_ColdGain + (1u << (GAIN_SHIFT - 1))) >> GAIN_SHIFT;
+}
+
+void LED_Dither_Fill(uint32_t duty_q4, uint16_t *dst, uint16_t stride)
+{
+    if (duty_q4 > LED_DUTY_MAX_Q4) duty_q4 = LED_DUTY_MAX_Q4;
+
+    uint16_t base = (uint16_t)(duty_q4 >> LED_DITHER_BITS);
+    uint8_t frac = (uint8_t)(duty_q4 & (LED_DITHER_FRAMES - 1));
+    uint8_t acc = 0;
+
+    // 一阶误差扩散: 多出的 frac 个计数均匀分布在 16 帧中
+    for (uint8_t i = 0; i < LED_DITHER_FRAMES; i++)
+    {
+        acc += frac;
+        if (acc >= LED_DITHER_FRAMES)
+        {
+            acc -= LED_DITHER_FRAMES;
+            *dst = base + 1;
+        }
+        else
+        {
+            *dst = base;
+        }
+        dst += stride;
+    }
+}
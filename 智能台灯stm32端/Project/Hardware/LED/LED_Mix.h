@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    LED_Mix.h
+  * @brief   亮度感知校正 (CIE 1931) + 恒光通量双色温混光 + 时间抖动 (整数运算)
+  * @note    - 亮度 0~1000 是"感知亮度" (CIE L* 的 0~100% 线性映射)，经 257 点查找表
+  *            插值换算为线性光输出，低亮度区的步进不再跳变，高亮度区也不再浪费档位；
+  *            查找表 LED_CIE_LUT.c 由 Thesis_Data_Analysis/sim_7_1_8_led_cie_lut.py 生成。
+  *          - 色温 0~1000 按光通量分配到暖 / 冷两路，并按两路满占空比光通量之比补偿，
+  *            同一亮度下调节色温时总光通量不变。
+  *          - 输出为 Q4 占空比 (PWM 计数值 x16)，低 4 位由 LED.c 在 16 个 PWM 周期内
+  *            用一阶误差扩散 (sigma-delta) 抖动实现，等效 19 位分辨率。
+  *          本文件不依赖硬件，可在主机上编译测试。
+  ******************************************************************************
+  */
+#ifndef __LED_MIX_H
+#define __LED_MIX_H
+
+#include <stdint.h>
+
+// PWM: 72MHz / 32768 = 2.197kHz (PSC = 0, ARR = 32767)，CCR = 32768 时 100% 占空比
+#define LED_PWM_BITS            15
+#define LED_PWM_PERIOD          (1u << LED_PWM_BITS)
+
+// 时间抖动: 2^4 = 16 个 PWM 周期一组 (7.3ms)
+#define LED_DITHER_BITS         4
+#define LED_DITHER_FRAMES       (1u << LED_DITHER_BITS)
+#define LED_DUTY_MAX_Q4         (LED_PWM_PERIOD << LED_DITHER_BITS)
+
+// 查找表: L* = 100 * i / 256 (i = 0~256) 对应的线性亮度，Q16 (65535 = 满亮)
+#define LED_LUT_SIZE            257
+
+extern const uint16_t LED_CIE_LUT[LED_LUT_SIZE];
+
+/**
+  * @brief  设置两路 LED 满占空比时的相对光通量 (任意单位，如实测 lm)
+  * @note   光通量较大的一路按比例降额，保证任意色温下总光通量相同
+  */
+void LED_Mix_Init(uint16_t warm_flux, uint16_t cold_flux);
+
+/**
+  * @brief  感知亮度 -> 线性光输出
+  * @param  level: 0~1000 (超出按 1000 处理)
+  * @retval Q4 占空比 0 ~ LED_DUTY_MAX_Q4
+  */
+uint32_t LED_Mix_Linear(uint16_t level);
+
+/**
+  * @brief  [新增] 同 LED_Mix_Linear，亮度带 4 位小数 (0~16000)，供渐变引擎平滑插值
+  */
+uint32_t LED_Mix_LinearFine(uint32_t level_x16);
+
+/**
+  * @brief  亮度 + 色温 -> 两路 Q4 占空比
+  * @param  bri: 感知亮度 0~1000
+  * @param  cct: 色温 0 (全暖) ~ 1000 (全冷)
+  */
+void LED_Mix(uint16_t bri, uint16_t cct, uint32_t *warm_q4, uint32_t *cold_q4);
+
+/**
+  * @brief  [新增] 同 LED_Mix，亮度带 4 位小数 (0~16000)
+  */
+void LED_Mix_Fine(uint32_t bri_x16, uint16_t cct, uint32_t *warm_q4, uint32_t *cold_q4);
+
+/**
+  * @brief  生成一组抖动序列: LED_DITHER_FRAMES 个 PWM 比较值，平均值恰好等于 duty_q4 / 16
+  * @param  dst:    输出首地址
+  * @param  stride: 相邻两帧在 dst 中的间隔 (元素数，多通道交错存放时使用)
+  */
+void LED_Dither_Fill(uint32_t duty_q4, uint16_t *dst, uint16_t stride);
+
+#endif
@@ -1,17 +1,29 @@
 /**
   ******************************************************************************
   * @file    OLED.c
-  * @brief   OLED 驱动 (V6.3 Init Fix)
+  * @brief   OLED 驱动 (V7.0 Framebuffer)
+  * @note    显示内容先画到 OLED_FB 帧缓冲，再按页把变化的列区间刷到屏幕:
+  *          每个脏页 = 1 次命令事务 (设置页/列地址) + 1 次数据事务 (控制字节 0x40 + 连续数据)，
+  *          数据直接从帧缓冲经 I2C1 DMA 发出。原先每个数据字节都是一次独立的 I2C 事务。
   ******************************************************************************
   */
 #include "stm32f10x.h"
 #include "OLED.h"
-#include "OLED_Font.h"
+#include "OLED_FB.h"
 #include "I2C_Driver.h"
+#include <stddef.h>
 
 #define OLED_I2C_ADDR   0x78
 #define OLED_I2C        I2C1
 
+#define OLED_CTRL_CMD   0x00    // 控制字节: 后续均为命令
+#define OLED_CTRL_DATA  0x40    // 控制字节: 后续均为显存数据
+
+// --- 异步刷新用的事务 (提交后到完成前必须保持有效) ---
+static uint8_t    s_PageCmd[3];
+static I2C_Xfer_t s_CmdXfer;
+static I2C_Xfer_t s_DataXfer;
+
 /**
   * @brief  检测 OLED 是否连接正常
   */
@@ -27,61 +39,77 @@ uint8_t OLED_IsReady(void)
 static void OLED_WriteCommand(uint8_t Command)
 {
     uint8_t data[2];
-    data[0] = 0x00; 
+    data[0] = OLED_CTRL_CMD;
     data[1] = Command;
     I2C_Lib_WriteDirect(OLED_I2C, OLED_I2C_ADDR, data, 2);
 }
 
-static void OLED_WriteData(uint8_t Data)
+/* ============================================================
+ *                 帧缓冲刷新
+ * ============================================================ */
+
+/** @brief 写页回调: 控制字节作为 "寄存器地址"，数据直接取自帧缓冲 */
+static void OLED_SubmitPage(uint8_t page, uint8_t col, const uint8_t *data, uint8_t len)
 {
-    uint8_t data[2];
-    data[0] = 0x40; 
-    data[1] = Data;
-    I2C_Lib_WriteDirect(OLED_I2C, OLED_I2C_ADDR, data, 2);
+    s_PageCmd[0] = 0xB0 | page;
+    s_PageCmd[1] = 0x10 | (col >> 4);
+    s_PageCmd[2] = 0x00 | (col & 0x0F);
+
+    s_CmdXfer.Addr = OLED_I2C_ADDR;
+    s_CmdXfer.Reg = OLED_CTRL_CMD;
+    s_CmdXfer.HasReg = 1;
+    s_CmdXfer.IsRead = 0;
+    s_CmdXfer.Buf = s_PageCmd;
+    s_CmdXfer.Len = sizeof(s_PageCmd);
+    s_CmdXfer.Done = NULL;
+
+    s_DataXfer.Addr = OLED_I2C_ADDR;
+    s_DataXfer.Reg = OLED_CTRL_DATA;
+    s_DataXfer.HasReg = 1;
+    s_DataXfer.IsRead = 0;
+    s_DataXfer.Buf = (uint8_t *)data;
+    s_DataXfer.Len = len;
+    s_DataXfer.Done = NULL;
+
+    I2C_Lib_Submit(OLED_I2C, &s_CmdXfer);
+    I2C_Lib_Submit(OLED_I2C, &s_DataXfer);
+}
+
+uint8_t OLED_Flush_Step(void)
+{
+    if (s_CmdXfer.Status == I2C_XFER_PENDING || s_DataXfer.Status == I2C_XFER_PENDING)
+    {
+        I2C_Lib_Poll(OLED_I2C);
+        return 1;
+    }
+    return OLED_FB_Flush(OLED_SubmitPage, 1);
 }
 
-void OLED_SetCursor(uint8_t Y, uint8_t X)
+void OLED_Refresh(void)
 {
-    OLED_WriteCommand(0xB0 | Y);
-    OLED_WriteCommand(0x10 | ((X & 0xF0) >> 4));
-    OLED_WriteCommand(0x00 | (X & 0x0F));
+    while (OLED_Flush_Step());
 }
 
+/* ============================================================
+ *                 兼容接口 (画到帧缓冲后立即刷新)
+ * ============================================================ */
+
 void OLED_Clear(void)
 {
-    uint8_t i, j;
-    for (j = 0; j < 8; j++)
-    {
-        OLED_SetCursor(j, 0);
-        for (i = 0; i < 128; i++)
-        {
-            OLED_WriteData(0x00);
-        }
-    }
+    OLED_FB_Clear();
+    OLED_Refresh();
 }
 
 void OLED_ShowChar(uint8_t Line, uint8_t Column, char Char)
 {
-    uint8_t i;
-    OLED_SetCursor((Line - 1) * 2, (Column - 1) * 8);
-    for (i = 0; i < 8; i++)
-    {
-        OLED_WriteData(OLED_F8x16[Char - ' '][i]);
-    }
-    OLED_SetCursor((Line - 1) * 2 + 1, (Column - 1) * 8);
-    for (i = 0; i < 8; i++)
-    {
-        OLED_WriteData(OLED_F8x16[Char - ' '][i + 8]);
-    }
+    OLED_FB_DrawChar((Column - 1) * 8, (Line - 1) * 16, Char);
+    OLED_Refresh();
 }
 
 void OLED_ShowString(uint8_t Line, uint8_t Column, char *String)
 {
-    uint8_t i;
-    for (i = 0; String[i] != '\0'; i++)
-    {
-        OLED_ShowChar(Line, Column + i, String[i]);
-    }
+    OLED_FB_DrawString((Column - 1) * 8, (Line - 1) * 16, String);
+    OLED_Refresh();
 }
 
 static uint32_t OLED_Pow(uint32_t X, uint32_t Y)
@@ -190,5 +218,7 @@ void OLED_Init(void)
     OLED_WriteCommand(0x14);
     OLED_WriteCommand(0xAF); 
 
-    OLED_Clear();
+    // 屏幕显存内容未知: 清空帧缓冲并整屏刷新一次
+    OLED_FB_Reset();
+    OLED_Refresh();
 }
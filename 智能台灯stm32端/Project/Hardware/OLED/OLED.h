@@ -12,6 +12,18 @@ void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Le
 void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length);
 void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length);
 
+/**
+  * @brief  非阻塞刷新一步: 上一页还在传输时直接返回，否则提交下一个脏页
+  * @note   绘图请使用 OLED_FB.h 的接口，刷新完成 (返回 0) 之前不要修改帧缓冲
+  * @retval 1: 还有页在传输或待刷新, 0: 屏幕已与帧缓冲一致
+  */
+uint8_t OLED_Flush_Step(void);
+
+/**
+  * @brief  阻塞刷新全部脏页
+  */
+void OLED_Refresh(void);
+
 /**
   * @brief  [新增] 检测 OLED 是否在线
   * @retval 1: 在线, 0: 离线
@@ -0,0 +1,193 @@
+/**
+  ******************************************************************************
+  * @file    OLED_FB.c
+  * @brief   SSD1306 帧缓冲与绘图实现
+  ******************************************************************************
+  */
+#include "OLED_FB.h"
+#include "OLED_Font.h"
+#include <string.h>
+
+#define FONT_W          8
+#define FONT_H          16
+#define FONT_FIRST      ' '
+#define FONT_NUM        (sizeof(OLED_F8x16) / sizeof(OLED_F8x16[0]))
+
+static uint8_t s_FB[OLED_PAGES][OLED_WIDTH];
+static uint8_t s_DirtyLo[OLED_PAGES];   // 脏列区间 [Lo, Hi]，Lo > Hi 表示该页干净
+static uint8_t s_DirtyHi[OLED_PAGES];
+
+/* ============================================================
+ *                 内部辅助
+ * ============================================================ */
+
+static void _MarkClean(uint8_t page)
+{
+    s_DirtyLo[page] = 0xFF;
+    s_DirtyHi[page] = 0;
+}
+
+/** @brief 按掩码合并一个字节，值变化时扩展脏区间 */
+static void _Merge(uint8_t page, uint8_t x, uint8_t bits, uint8_t mask)
+{
+    if (page >= OLED_PAGES || x >= OLED_WIDTH || mask == 0) return;
+
+    uint8_t old = s_FB[page][x];
+    uint8_t val = (uint8_t)((old & ~mask) | (bits & mask));
+    if (val == old) return;
+
+    s_FB[page][x] = val;
+    if (x < s_DirtyLo[page]) s_DirtyLo[page] = x;
+    if (x > s_DirtyHi[page]) s_DirtyHi[page] = x;
+}
+
+/** @brief 在 (x, y) 处竖直写入 8 个像素 (bit0 在 y)，y 不必按页对齐 */
+static void _MergeColumn(uint8_t x, uint8_t y, uint8_t bits, uint8_t mask)
+{
+    uint8_t page = y >> 3;
+    uint8_t sh = y & 7;
+    uint16_t b = (uint16_t)bits << sh;
+    uint16_t m = (uint16_t)mask << sh;
+
+    _Merge(page, x, (uint8_t)b, (uint8_t)m);
+    if (sh) _Merge(page + 1, x, (uint8_t)(b >> 8), (uint8_t)(m >> 8));
+}
+
+/* ============================================================
+ *                 帧缓冲管理
+ * ============================================================ */
+
+void OLED_FB_Reset(void)
+{
+    memset(s_FB, 0, sizeof(s_FB));
+    for (uint8_t p = 0; p < OLED_PAGES; p++)
+    {
+        s_DirtyLo[p] = 0;
+        s_DirtyHi[p] = OLED_WIDTH - 1;
+    }
+}
+
+uint8_t OLED_FB_IsDirty(void)
+{
+    for (uint8_t p = 0; p < OLED_PAGES; p++)
+    {
+        if (s_DirtyLo[p] <= s_DirtyHi[p]) return 1;
+    }
+    return 0;
+}
+
+uint8_t OLED_FB_Flush(OLED_FB_WritePage_t write, uint8_t max_pages)
+{
+    uint8_t n = 0;
+
+    for (uint8_t p = 0; p < OLED_PAGES && n < max_pages; p++)
+    {
+        uint8_t lo = s_DirtyLo[p];
+        uint8_t hi = s_DirtyHi[p];
+        if (lo > hi) continue;
+
+        _MarkClean(p);
+        write(p, lo, &s_FB[p][lo], (uint8_t)(hi - lo + 1));
+        n++;
+    }
+    return n;
+}
+
+const uint8_t (*OLED_FB_GetBuffer(void))[OLED_WIDTH]
+{
+    return (const uint8_t (*)[OLED_WIDTH])s_FB;
+}
+
+/* ============================================================
+ *                 绘图接口
+ * ============================================================ */
+
+void OLED_FB_Clear(void)
+{
+    OLED_FB_FillRect(0, 0, OLED_WIDTH, OLED_HEIGHT, 0);
+}
+
+void OLED_FB_SetPixel(uint8_t x, uint8_t y, uint8_t on)
+{
+    if (y >= OLED_HEIGHT) return;
+    _Merge(y >> 3, x, on ? 0xFF : 0x00, (uint8_t)(1u << (y & 7)));
+}
+
+void OLED_FB_FillRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t on)
+{
+    uint16_t y_end = (uint16_t)y + h;      // 不含
+    if (y_end > OLED_HEIGHT) y_end = OLED_HEIGHT;
+    if (y >= y_end) return;
+
+    for (uint8_t p = y >> 3; p <= (uint8_t)((y_end - 1) >> 3); p++)
+    {
+        // 本页内被覆盖的行
+        uint8_t top = (p == (y >> 3)) ? (y & 7) : 0;
+        uint8_t bot = (p == ((y_end - 1) >> 3)) ? ((y_end - 1) & 7) : 7;
+        uint8_t mask = (uint8_t)((0xFFu << top) & (0xFFu >> (7 - bot)));
+
+        for (uint16_t i = x; i < (uint16_t)x + w && i < OLED_WIDTH; i++)
+        {
+            _Merge(p, (uint8_t)i, on ? 0xFF : 0x00, mask);
+        }
+    }
+}
+
+void OLED_FB_DrawRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    if (w == 0 || h == 0) return;
+    OLED_FB_FillRect(x, y, w, 1, 1);
+    OLED_FB_FillRect(x, y + h - 1, w, 1, 1);
+    OLED_FB_FillRect(x, y, 1, h, 1);
+    OLED_FB_FillRect(x + w - 1, y, 1, h, 1);
+}
+
+void OLED_FB_DrawBar(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t percent)
+{
+    if (w < 3 || h < 3) return;
+    if (percent > 100) percent = 100;
+
+    uint8_t inner = w - 2;
+    uint8_t fill = (uint8_t)((uint16_t)inner * percent / 100);
+
+    OLED_FB_DrawRect(x, y, w, h);
+    OLED_FB_FillRect(x + 1, y + 1, fill, h - 2, 1);
+    OLED_FB_FillRect(x + 1 + fill, y + 1, inner - fill, h - 2, 0);
+}
+
+void OLED_FB_DrawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bmp)
+{
+    uint8_t src_pages = (h + 7) / 8;
+
+    for (uint8_t sp = 0; sp < src_pages; sp++)
+    {
+        uint16_t y0 = (uint16_t)y + sp * 8;
+        if (y0 >= OLED_HEIGHT) break;
+
+        uint8_t rows = h - sp * 8;
+        uint8_t mask = (rows >= 8) ? 0xFF : (uint8_t)((1u << rows) - 1);
+
+        for (uint8_t i = 0; i < w; i++)
+        {
+            if ((uint16_t)x + i >= OLED_WIDTH) break;
+            _MergeColumn(x + i, (uint8_t)y0, bmp[sp * w + i], mask);
+        }
+    }
+}
+
+void OLED_FB_DrawChar(uint8_t x, uint8_t y, char c)
+{
+    uint8_t idx = (uint8_t)(c - FONT_FIRST);
+    if ((uint8_t)c < FONT_FIRST || idx >= FONT_NUM) idx = '?' - FONT_FIRST;
+    OLED_FB_DrawBitmap(x, y, FONT_W, FONT_H, OLED_F8x16[idx]);
+}
+
+void OLED_FB_DrawString(uint8_t x, uint8_t y, const char *str)
+{
+    uint16_t cx = x;
+    while (*str != '\0' && cx < OLED_WIDTH)
+    {
+        OLED_FB_DrawChar((uint8_t)cx, y, *str++);
+        cx += FONT_W;
+    }
+}
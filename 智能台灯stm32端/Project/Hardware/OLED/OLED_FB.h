@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    OLED_FB.h
+  * @brief   SSD1306 128x64 帧缓冲 (1KB) + 按页脏区跟踪 + 绘图接口
+  * @note    所有绘图只改 RAM 中的帧缓冲，字节值确实变化时才扩展该页的脏列区间；
+  *          OLED_FB_Flush() 把每个脏页的 [最左, 最右] 变化列作为一段连续数据交给
+  *          写页回调 (一次 I2C 事务)。本文件不依赖硬件，可在主机上编译测试。
+  *
+  *          坐标: x 0~127 向右，y 0~63 向下；超出屏幕的部分被裁剪。
+  *          位图格式与 SSD1306 GDDRAM 相同: 按页 (8 行) 存放，每页 w 个字节，
+  *          字节的 bit0 是该页最上面一行 (OLED_F8x16 字模即 w=8, h=16 的位图)。
+  ******************************************************************************
+  */
+#ifndef __OLED_FB_H
+#define __OLED_FB_H
+
+#include <stdint.h>
+
+#define OLED_WIDTH      128
+#define OLED_HEIGHT     64
+#define OLED_PAGES      (OLED_HEIGHT / 8)
+
+/**
+  * @brief 写页回调: 把 data[0..len-1] 写到第 page 页、从第 col 列开始的位置
+  * @note  data 直接指向帧缓冲，异步发送时在完成前不要修改帧缓冲
+  */
+typedef void (*OLED_FB_WritePage_t)(uint8_t page, uint8_t col, const uint8_t *data, uint8_t len);
+
+/* ============================================================
+ *                 帧缓冲管理
+ * ============================================================ */
+
+/**
+  * @brief  清空帧缓冲并把整屏标记为脏 (屏幕内容未知时使用，如上电初始化)
+  */
+void OLED_FB_Reset(void);
+
+/**
+  * @brief  是否还有未刷新的脏页
+  */
+uint8_t OLED_FB_IsDirty(void);
+
+/**
+  * @brief  刷新脏页
+  * @param  write:     写页回调
+  * @param  max_pages: 本次最多刷新的页数 (分步刷新时传 1)
+  * @retval 本次刷新的页数，0 表示帧缓冲已与屏幕一致
+  */
+uint8_t OLED_FB_Flush(OLED_FB_WritePage_t write, uint8_t max_pages);
+
+/**
+  * @brief  只读访问帧缓冲 ([page][x]，用于调试 / 主机端导出图像)
+  */
+const uint8_t (*OLED_FB_GetBuffer(void))[OLED_WIDTH];
+
+/* ============================================================
+ *                 绘图接口
+ * ============================================================ */
+void OLED_FB_Clear(void);
+void OLED_FB_SetPixel(uint8_t x, uint8_t y, uint8_t on);
+void OLED_FB_FillRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t on);
+void OLED_FB_DrawRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+/**
+  * @brief  进度条: 1 像素边框，内部按 percent (0~100) 从左向右填充，其余清空
+  */
+void OLED_FB_DrawBar(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t percent);
+
+/**
+  * @brief  绘制位图 (不透明: 位图范围内的 0 会清掉原有像素)
+  */
+void OLED_FB_DrawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bmp);
+
+/**
+  * @brief  8x16 字符 / 字符串 (字符串超出右边界的部分被裁剪)
+  */
+void OLED_FB_DrawChar(uint8_t x, uint8_t y, char c);
+void OLED_FB_DrawString(uint8_t x, uint8_t y, const char *str);
+
+#endif
@@ -1,20 +1,29 @@
 /**
   ******************************************************************************
   * @file    PAJ7620.c
-  * @brief   PAJ7620U2 驱动 (V10.2 Exit Hook)
+  * @brief   PAJ7620U2 驱动 (V10.4 INT Driven)
   * @note    增加退出无极调光的回调
+  *          轮询改为连续寄存器突发读，非阻塞提交
+  *          INT 引脚 (PB5, EXTI5) 有效时才读手势标志，近距调光模式下才定时读物体亮度，
+  *          无手势时不再占用 I2C 总线 (仅保留低频保底轮询)
   ******************************************************************************
   */
 #include "PAJ7620.h"
 #include "I2C_Driver.h"
 #include "USART_DMA.h"
 #include "SystemSupport.h"
+#include "Scheduler.h"
 #include <string.h>
 
 // --- 配置 ---
 #define PAJ_I2C_PORT            I2C2    
 #define PAJ_I2C_ADDR            0xE6    
 
+// INT 引脚 (低电平有效，读清手势标志后释放)
+#define PAJ_INT_PORT            GPIOB
+#define PAJ_INT_PIN             GPIO_Pin_5
+#define PAJ_INT_EXTI_LINE       EXTI_Line5
+
 // 阈值参数
 #define PAJ_PROXIMITY_EXIT_TH   20   // 退出近距模式的亮度阈值
 #define PAJ_REVERSE_FILTER_TIME 600  // 反向动作过滤时间 (ms)
@@ -24,6 +33,31 @@ static PAJ_State_t s_State = PAJ_STATE_IDLE;
 static uint8_t s_LastGesture = 0;    // 记录上一次的有效手势
 static uint32_t s_LastGestureTick = 0;
 
+// --- 非阻塞轮询: 3 段连续寄存器 (Bank 0 已在初始化末尾选中，轮询时不再切换) ---
+enum { PAJ_BURST_FLAG = 0, PAJ_BURST_OBJ, PAJ_BURST_VEL, PAJ_BURST_NUM };
+#define PAJ_MASK_FLAG           (1u << PAJ_BURST_FLAG)
+#define PAJ_MASK_OBJ            (1u << PAJ_BURST_OBJ)
+#define PAJ_MASK_ALL            ((1u << PAJ_BURST_NUM) - 1)
+
+static uint8_t s_BufFlag[2];    // 0x43-0x44: 手势标志 1/2
+static uint8_t s_BufObj[3];     // 0xB0-0xB2: 物体亮度, 物体大小 L/H
+static uint8_t s_BufVel[4];     // 0xC3-0xC6: 速度 X L/H, Y L/H
+static I2C_Xfer_t s_Burst[PAJ_BURST_NUM];
+static uint8_t s_PollInFlight = 0;
+static uint8_t s_PollMask = 0;          // 本轮提交的段 (PAJ_MASK_xxx)
+static uint32_t s_LastFlagTick = 0;     // 上一次读手势标志的时刻 (保底轮询)
+
+static uint8_t PAJ_TryHandle(void);
+
+static volatile uint8_t  s_IntPending = 0;
+static volatile uint32_t s_IntCount = 0;
+
+// --- 总线占用统计 ([PAJ] 行) ---
+static uint32_t s_PollCount = 0;
+static uint32_t s_PollBusSumUs = 0;
+static uint32_t s_PollBusMaxUs = 0;
+static uint32_t s_StatsStart = 0;
+
 // --- 官方初始化数组 ---
 static const uint8_t PAJ7620_Init_Regs[][2] = {
     {0xEF,0x00}, {0x41,0xFF}, {0x42,0x01}, {0x46,0x2D}, {0x47,0x0F}, 
@@ -50,6 +84,48 @@ static uint8_t PAJ_Read(uint8_t reg, uint8_t *val) {
     return I2C_Lib_Read(PAJ_I2C_PORT, PAJ_I2C_ADDR, reg, val, 1);
 }
 
+// --- INT 引脚: PB5 下降沿 -> EXTI5 ---
+#if PAJ_USE_INT_PIN
+static void PAJ_INT_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+    EXTI_InitTypeDef EXTI_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB | RCC_APB2Periph_AFIO, ENABLE);
+
+    GPIO_InitStructure.GPIO_Pin = PAJ_INT_PIN;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(PAJ_INT_PORT, &GPIO_InitStructure);
+
+    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource5);
+    EXTI_InitStructure.EXTI_Line = PAJ_INT_EXTI_LINE;
+    EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+    EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+    EXTI_Init(&EXTI_InitStructure);
+
+    // 中断里只置标志，用最低的抢占优先级
+    NVIC_InitStructure.NVIC_IRQChannel = EXTI9_5_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+    if (EXTI_GetITStatus(PAJ_INT_EXTI_LINE) != RESET)
+    {
+        EXTI_ClearITPendingBit(PAJ_INT_EXTI_LINE);
+        s_IntPending = 1;
+        s_IntCount++;
+        PAJ7620_Hook_OnIntFromISR();
+    }
+}
+#endif
+
 // --- 初始化 ---
 uint8_t PAJ7620_Init(void)
 {
@@ -64,31 +140,117 @@ uint8_t PAJ7620_Init(void)
         PAJ_Write(PAJ7620_Init_Regs[i][0], PAJ7620_Init_Regs[i][1]);
     }
     PAJ_Write(0xEF, 0x00);
+
+#if PAJ_USE_INT_PIN
+    PAJ_INT_Init();
+#endif
+    // 读清上电以来残留的手势标志，让 INT 回到高电平
+    I2C_Lib_Read(PAJ_I2C_PORT, PAJ_I2C_ADDR, PAJ_ADDR_INT_FLAG1, s_BufFlag, sizeof(s_BufFlag));
+    s_LastFlagTick = System_GetTick();
+    s_StatsStart = s_LastFlagTick;
     return 0;
 }
 
-// --- 读取全量数据 ---
-void PAJ7620_ReadAllData(PAJ7620_Data_t *data)
+// --- 突发读 ---
+static void PAJ_SetupBurst(I2C_Xfer_t *x, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    memset(x, 0, sizeof(I2C_Xfer_t));
+    x->Addr = PAJ_I2C_ADDR;
+    x->Reg = reg;
+    x->HasReg = 1;
+    x->IsRead = 1;
+    x->Buf = buf;
+    x->Len = len;
+}
+
+static void PAJ_SubmitPoll(uint8_t mask)
+{
+    PAJ_SetupBurst(&s_Burst[PAJ_BURST_FLAG], PAJ_ADDR_INT_FLAG1, s_BufFlag, sizeof(s_BufFlag));
+    PAJ_SetupBurst(&s_Burst[PAJ_BURST_OBJ], PAJ_ADDR_OBJ_BRIGHTNESS, s_BufObj, sizeof(s_BufObj));
+    PAJ_SetupBurst(&s_Burst[PAJ_BURST_VEL], PAJ_ADDR_VEL_X_L, s_BufVel, sizeof(s_BufVel));
+
+    s_PollMask = mask;
+    s_PollInFlight = 1;
+    if (mask & PAJ_MASK_FLAG) s_LastFlagTick = System_GetTick();
+
+    for (uint8_t i = 0; i < PAJ_BURST_NUM; i++) {
+        if (mask & (1u << i)) I2C_Lib_Submit(PAJ_I2C_PORT, &s_Burst[i]);
+    }
+}
+
+/**
+ * @brief  取回一轮突发读结果 (只填写本轮读取的字段，其余为 0)
+ * @retval 0: 仍在传输, 1: 已完成 (data 已填写，失败时 IsConnected = 0)
+ */
+static uint8_t PAJ_CollectPoll(PAJ7620_Data_t *data)
 {
-    uint8_t buf[2];
+    uint32_t bus_us = 0;
+    uint8_t ok = 1;
+
+    for (uint8_t i = 0; i < PAJ_BURST_NUM; i++) {
+        if (!(s_PollMask & (1u << i))) continue;
+        if (s_Burst[i].Status == I2C_XFER_PENDING) {
+            I2C_Lib_Poll(PAJ_I2C_PORT);
+            return 0;
+        }
+        if (s_Burst[i].Status != I2C_XFER_OK) ok = 0;
+        bus_us += s_Burst[i].BusUs;
+    }
+    s_PollInFlight = 0;
+
+    s_PollCount++;
+    s_PollBusSumUs += bus_us;
+    if (bus_us > s_PollBusMaxUs) s_PollBusMaxUs = bus_us;
+
     memset(data, 0, sizeof(PAJ7620_Data_t));
-    
-    if (PAJ_Write(0xEF, 0x00) != 0) { data->IsConnected = 0; return; }
-    
-    PAJ_Read(PAJ_ADDR_INT_FLAG1, &data->GestureFlag1);
-    PAJ_Read(PAJ_ADDR_INT_FLAG2, &data->GestureFlag2);
-    PAJ_Read(PAJ_ADDR_OBJ_BRIGHTNESS, &data->ObjectBrightness);
-    PAJ_Read(PAJ_ADDR_OBJ_SIZE_L, &buf[0]);
-    PAJ_Read(PAJ_ADDR_OBJ_SIZE_H, &buf[1]);
-    data->ObjectSize = (uint16_t)buf[0] | ((uint16_t)buf[1] << 8);
-    
-    uint8_t vx, vy;
-    PAJ_Read(PAJ_ADDR_VEL_X_L, &vx);
-    PAJ_Read(PAJ_ADDR_VEL_Y_L, &vy);
-    data->VelocityX = (int8_t)vx;
-    data->VelocityY = (int8_t)vy;
-    
+    if (!ok) return 1;
+
+    if (s_PollMask & PAJ_MASK_FLAG) {
+        data->GestureFlag1 = s_BufFlag[0];
+        data->GestureFlag2 = s_BufFlag[1];
+    }
+    if (s_PollMask & PAJ_MASK_OBJ) {
+        data->ObjectBrightness = s_BufObj[0];
+        data->ObjectSize = (uint16_t)s_BufObj[1] | ((uint16_t)s_BufObj[2] << 8);
+    }
+    if (s_PollMask & (1u << PAJ_BURST_VEL)) {
+        data->VelocityX = (int8_t)s_BufVel[0];
+        data->VelocityY = (int8_t)s_BufVel[2];
+    }
     data->IsConnected = 1;
+    return 1;
+}
+
+/**
+ * @brief  本轮需要读取哪些寄存器段
+ * @note   手势标志: INT 有效 (EXTI 下降沿，或电平仍为低 —— 标志未读清前 INT 保持低，
+ *         漏掉的沿也能补上) 或距上次读取超过 PAJ_IDLE_POLL_MS (INT 未接线时的保底)；
+ *         物体亮度: 仅近距调光模式下每次都读。
+ */
+static uint8_t PAJ_NextPollMask(void)
+{
+    uint8_t mask = 0;
+
+#if PAJ_USE_INT_PIN
+    if (s_IntPending || !GPIO_ReadInputDataBit(PAJ_INT_PORT, PAJ_INT_PIN) ||
+        System_GetTick() - s_LastFlagTick >= PAJ_IDLE_POLL_MS) {
+        s_IntPending = 0;
+        mask |= PAJ_MASK_FLAG;
+    }
+#else
+    mask |= PAJ_MASK_FLAG;
+#endif
+
+    if (s_State == PAJ_STATE_PROXIMITY_CTRL) mask |= PAJ_MASK_OBJ;
+    return mask;
+}
+
+// --- 读取全量数据 (阻塞) ---
+void PAJ7620_ReadAllData(PAJ7620_Data_t *data)
+{
+    while (s_PollInFlight && !PAJ_TryHandle()); // 在途的一轮照常处理，避免丢掉读清的手势标志
+    PAJ_SubmitPoll(PAJ_MASK_ALL);
+    while (!PAJ_CollectPoll(data));
 }
 
 // --- 辅助函数：判断是否为反向手势 ---
@@ -102,14 +264,10 @@ static uint8_t Is_Reverse_Gesture(uint8_t curr, uint8_t last) {
 }
 
 // --- V10.1 核心逻辑 ---
-void PAJ7620_Process_StateMachine(void)
+static void PAJ_HandleData(const PAJ7620_Data_t *data, uint8_t mask)
 {
-    PAJ7620_Data_t data;
-    PAJ7620_ReadAllData(&data);
-    if (!data.IsConnected) return;
-
-    uint8_t g1 = data.GestureFlag1;
-    uint8_t g2 = data.GestureFlag2;
+    uint8_t g1 = data->GestureFlag1;
+    uint8_t g2 = data->GestureFlag2;
     uint32_t now = System_GetTick();
 
     // ---------------------------------------------------------
@@ -163,7 +321,8 @@ void PAJ7620_Process_StateMachine(void)
 
         // --- 模式 B: 近距控制模式 (PROXIMITY) ---
         case PAJ_STATE_PROXIMITY_CTRL:
-            if (data.ObjectBrightness < PAJ_PROXIMITY_EXIT_TH) {
+            if (!(mask & PAJ_MASK_OBJ)) break; // 本轮是进入近距模式前提交的，没有亮度数据
+            if (data->ObjectBrightness < PAJ_PROXIMITY_EXIT_TH) {
                 s_State = PAJ_STATE_IDLE;
                 USART_DMA_Printf("[PAJ] 退出调光\r\n");
                 
@@ -175,12 +334,60 @@ void PAJ7620_Process_StateMachine(void)
                 PAJ7620_Hook_OnProximityExit();
             }
             else {
-                PAJ7620_Hook_OnProximity(data.ObjectBrightness);
+                PAJ7620_Hook_OnProximity(data->ObjectBrightness);
             }
             break;
     }
 }
 
+/**
+ * @brief  取回在途的一轮读数并处理
+ * @retval 0: 仍在传输, 1: 已处理
+ */
+static uint8_t PAJ_TryHandle(void)
+{
+    PAJ7620_Data_t data;
+    uint8_t mask = s_PollMask;
+
+    if (!PAJ_CollectPoll(&data)) return 0;
+    if (data.IsConnected) PAJ_HandleData(&data, mask);
+    return 1;
+}
+
+void PAJ7620_Process_StateMachine(void)
+{
+    // 1. 上一轮还在总线上: 先取回处理
+    if (s_PollInFlight && !PAJ_TryHandle()) return;
+
+    // 2. 按需提交下一轮 (无手势且不在近距模式时什么也不读)
+    uint8_t mask = PAJ_NextPollMask();
+    if (mask == 0) return;
+    PAJ_SubmitPoll(mask);
+
+    // 3. 软件 I2C 模式下已同步完成，可立即处理；硬件模式下留到下一次调用
+    PAJ_TryHandle();
+}
+
+// --- 统计 ---
+uint32_t PAJ7620_Stats_Task(void)
+{
+    uint32_t window = System_GetTick() - s_StatsStart;
+    uint32_t permille = window ? s_PollBusSumUs / window : 0;
+
+    USART_DMA_Printf("[PAJ] int=%lu reads=%lu bus=%lu.%lu%% avg=%luus max=%luus (%s)\r\n",
+                     (unsigned long)s_IntCount, (unsigned long)s_PollCount,
+                     (unsigned long)(permille / 10), (unsigned long)(permille % 10),
+                     (unsigned long)(s_PollCount ? s_PollBusSumUs / s_PollCount : 0),
+                     (unsigned long)s_PollBusMaxUs,
+                     I2C_Lib_IsHardware(PAJ_I2C_PORT) ? "hw" : "sw");
+    s_IntCount = 0;
+    s_PollCount = 0;
+    s_PollBusSumUs = 0;
+    s_PollBusMaxUs = 0;
+    s_StatsStart = System_GetTick();
+    return SCHED_DONE;
+}
+
 // --- Weak Hooks ---
 __weak void PAJ7620_Hook_OnUp(void) {}
 __weak void PAJ7620_Hook_OnDown(void) {}
@@ -193,3 +400,4 @@ __weak void PAJ7620_Hook_OnCounterClockwise(void) {}
 __weak void PAJ7620_Hook_OnWave(void) {}
 __weak void PAJ7620_Hook_OnProximity(uint8_t brightness) {}
 __weak void PAJ7620_Hook_OnProximityExit(void) {} // [新增]
+__weak void PAJ7620_Hook_OnIntFromISR(void) {}
@@ -10,7 +10,7 @@
 #define PAJ_ADDR_OBJ_BRIGHTNESS 0xB0
 #define PAJ_ADDR_OBJ_SIZE_L     0xB1
 #define PAJ_ADDR_OBJ_SIZE_H     0xB2
-#define PAJ_ADDR_VEL_X_L        0xC3
+#define PAJ_ADDR_VEL_X_L        0xC3    // 0xC3-0xC6: X L/H, Y L/H (连续，一次突发读)
 #define PAJ_ADDR_VEL_Y_L        0xC5
 
 // --- 手势掩码 (统一命名) ---
@@ -43,13 +43,24 @@ typedef struct {
 
 // --- 接口 ---
 uint8_t PAJ7620_Init(void);
+
+/**
+ * @brief 阻塞读取全量数据 (3 次突发读)
+ */
 void PAJ7620_ReadAllData(PAJ7620_Data_t *data);
 
 /**
  * @brief 核心状态机处理函数 (需在主循环高速调用)
+ * @note  非阻塞: 每次调用先处理上一轮读数，再按需提交下一轮 (硬件 I2C 下结果滞后一个调用周期)。
+ *        只有 INT 有效时读手势标志、近距调光模式下读物体亮度，其余时间不访问总线。
  */
 void PAJ7620_Process_StateMachine(void);
 
+/**
+ * @brief 统计打印任务: [PAJ] INT 次数、读取次数、I2C 总线占用率及每次读取的平均 / 最大总线时间，打印后清零
+ */
+uint32_t PAJ7620_Stats_Task(void);
+
 // --- Hook 声明 ---
 void PAJ7620_Hook_OnUp(void);
 void PAJ7620_Hook_OnDown(void);
@@ -72,4 +83,11 @@ void PAJ7620_Hook_OnProximity(uint8_t brightness);
  */
 void PAJ7620_Hook_OnProximityExit(void);
 
+/**
+ * @brief INT 下降沿回调 (EXTI9_5 中断上下文)
+ * @note  只能做中断安全的操作 (如 EventBus_PostFromISR)；不实现时仍由下一次
+ *        PAJ7620_Process_StateMachine 根据 INT 标志读取手势。
+ */
+void PAJ7620_Hook_OnIntFromISR(void);
+
 #endif
@@ -0,0 +1,122 @@
+/**
+  ******************************************************************************
+  * @file    EventBus.c
+  * @brief   轻量级事件总线实现
+  ******************************************************************************
+  */
+#include "EventBus.h"
+#include "Scheduler.h"
+#include "USART_DMA.h"
+#include "stm32f10x.h"
+#include <string.h>
+
+#define EVT_QUEUE_MASK  (EVT_QUEUE_SIZE - 1)
+
+#if (EVT_QUEUE_SIZE & EVT_QUEUE_MASK) || (EVT_QUEUE_SIZE > 128)
+#error "EVT_QUEUE_SIZE must be a power of 2 and <= 128"
+#endif
+
+static EventQueue_t s_MainQ;    // 生产者: 主循环
+static EventQueue_t s_IsrQ;     // 生产者: 中断
+static EventHandler_t s_Handlers[EVT_TYPE_NUM];
+static uint32_t s_Dispatched = 0;
+
+/* ============================================================
+ *                 队列原语
+ * ============================================================ */
+
+uint8_t EventQueue_Count(const EventQueue_t *q)
+{
+    return (uint8_t)(q->Head - q->Tail);
+}
+
+uint8_t EventQueue_Push(EventQueue_t *q, const Event_t *evt)
+{
+    uint8_t head = q->Head;
+    uint8_t used = (uint8_t)(head - q->Tail);
+
+    if (used >= EVT_QUEUE_SIZE)
+    {
+        q->Dropped++;
+        return 0;
+    }
+
+    q->Buf[head & EVT_QUEUE_MASK] = *evt;
+    __DMB();                    // 先写完数据，再发布新的 Head
+    q->Head = (uint8_t)(head + 1);
+
+    if (used + 1 > q->HighWater) q->HighWater = used + 1;
+    return 1;
+}
+
+uint8_t EventQueue_Pop(EventQueue_t *q, Event_t *evt)
+{
+    uint8_t tail = q->Tail;
+
+    if (tail == q->Head) return 0;
+    __DMB();                    // 先看到新的 Head，再读数据 (与 Push 中的屏障配对)
+
+    *evt = q->Buf[tail & EVT_QUEUE_MASK];
+    __DMB();                    // 先读完数据，再释放槽位
+    q->Tail = (uint8_t)(tail + 1);
+    return 1;
+}
+
+/* ============================================================
+ *                 总线接口
+ * ============================================================ */
+
+void EventBus_Init(void)
+{
+    memset(&s_MainQ, 0, sizeof(s_MainQ));
+    memset(&s_IsrQ, 0, sizeof(s_IsrQ));
+    memset(s_Handlers, 0, sizeof(s_Handlers));
+    s_Dispatched = 0;
+}
+
+void EventBus_Subscribe(EventType_t type, EventHandler_t handler)
+{
+    if (type > EVT_NONE && type < EVT_TYPE_NUM) s_Handlers[type] = handler;
+}
+
+uint8_t EventBus_Post(EventType_t type, uint8_t src, int16_t value, uint32_t param)
+{
+    Event_t evt = { (uint8_t)type, src, value, param };
+    return EventQueue_Push(&s_MainQ, &evt);
+}
+
+uint8_t EventBus_PostFromISR(EventType_t type, uint8_t src, int16_t value, uint32_t param)
+{
+    Event_t evt = { (uint8_t)type, src, value, param };
+    return EventQueue_Push(&s_IsrQ, &evt);
+}
+
+/** @brief 最多取出 n 个事件并分发 (处理函数中新投递的事件留到下一次) */
+static void _Drain(EventQueue_t *q, uint8_t n)
+{
+    Event_t evt;
+    while (n-- && EventQueue_Pop(q, &evt))
+    {
+        if (evt.Type < EVT_TYPE_NUM && s_Handlers[evt.Type] != NULL)
+        {
+            s_Handlers[evt.Type](&evt);
+        }
+        s_Dispatched++;
+    }
+}
+
+uint32_t EventBus_Dispatch_Task(void)
+{
+    _Drain(&s_IsrQ, EventQueue_Count(&s_IsrQ));
+    _Drain(&s_MainQ, EventQueue_Count(&s_MainQ));
+    return SCHED_DONE;
+}
+
+uint32_t EventBus_Stats_Task(void)
+{
+    USART_DMA_Printf("[EvtBus] dispatched=%lu | main %u/%u hw=%u drop=%u | isr %u/%u hw=%u drop=%u\r\n",
+                     (unsigned long)s_Dispatched,
+                     EventQueue_Count(&s_MainQ), EVT_QUEUE_SIZE, s_MainQ.HighWater, s_MainQ.Dropped,
+                     EventQueue_Count(&s_IsrQ), EVT_QUEUE_SIZE, s_IsrQ.HighWater, s_IsrQ.Dropped);
+    return SCHED_DONE;
+}
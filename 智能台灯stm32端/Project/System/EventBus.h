@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    EventBus.h
+  * @brief   轻量级事件总线 (无锁单生产者 FIFO + 按类型分发表)
+  * @note    驱动 / 中断只负责投递紧凑的类型化事件，业务层按事件类型订阅处理函数，
+  *          由主循环中的分发任务统一消费，驱动与 ControlManager 不再直接互相调用。
+  *
+  *          每个队列只允许一个生产者上下文 (无锁的前提):
+  *          - EventBus_Post():        主循环 (调度器任务) 中调用
+  *          - EventBus_PostFromISR(): 中断中调用，多个中断共用时须为同一抢占优先级 (互不嵌套)
+  *          两个队列之间不保证先后顺序，同一队列内严格 FIFO。
+  ******************************************************************************
+  */
+#ifndef __EVENT_BUS_H
+#define __EVENT_BUS_H
+
+#include <stdint.h>
+
+// 队列深度，必须为 2 的幂且 <= 128 (下标为自由递增的 uint8_t)
+#define EVT_QUEUE_SIZE      32
+
+/**
+  * @brief 事件类型 (同时是分发表下标)
+  */
+typedef enum {
+    EVT_NONE = 0,
+    EVT_ENCODER,            /*!< Value: 编码器增量 */
+    EVT_KEY,                /*!< Src: 按键 ID, Value: KeyEventType_t, Param: 长按时长 ms */
+    EVT_GESTURE,            /*!< Value: PAJ7620_GESTURE_xxx */
+    EVT_PROXIMITY,          /*!< Value: 物体亮度 (0-255) */
+    EVT_PROXIMITY_EXIT,     /*!< 退出近距无极调光 */
+    EVT_GESTURE_INT,        /*!< PAJ7620 INT 下降沿 (中断投递)，无载荷 */
+    EVT_TYPE_NUM
+} EventType_t;
+
+/**
+  * @brief 紧凑事件 (8 字节)
+  */
+typedef struct {
+    uint8_t  Type;          /*!< EventType_t */
+    uint8_t  Src;           /*!< 事件源编号 (如按键 ID) */
+    int16_t  Value;         /*!< 主载荷 */
+    uint32_t Param;         /*!< 附加载荷 */
+} Event_t;
+
+typedef void (*EventHandler_t)(const Event_t *evt);
+
+/**
+  * @brief 单生产者 / 单消费者环形队列
+  * @note  Head 只由生产者写，Tail 只由消费者写，二者均自由递增、按 2 的幂取模
+  */
+typedef struct {
+    Event_t          Buf[EVT_QUEUE_SIZE];
+    volatile uint8_t Head;
+    volatile uint8_t Tail;
+    uint8_t          HighWater;     /*!< 历史最高占用 (生产者维护) */
+    uint16_t         Dropped;       /*!< 队列满丢弃的事件数 (生产者维护) */
+} EventQueue_t;
+
+/* ============================================================
+ *                 队列原语
+ * ============================================================ */
+uint8_t EventQueue_Push(EventQueue_t *q, const Event_t *evt);   // 1: 成功, 0: 满 (丢弃)
+uint8_t EventQueue_Pop(EventQueue_t *q, Event_t *evt);          // 1: 取到事件, 0: 空
+uint8_t EventQueue_Count(const EventQueue_t *q);
+
+/* ============================================================
+ *                 总线接口
+ * ============================================================ */
+void EventBus_Init(void);
+
+/**
+  * @brief  订阅某类事件 (每种类型一个处理函数，后注册的覆盖先注册的)
+  */
+void EventBus_Subscribe(EventType_t type, EventHandler_t handler);
+
+/**
+  * @brief  投递事件
+  * @retval 1: 成功, 0: 队列满被丢弃
+  */
+uint8_t EventBus_Post(EventType_t type, uint8_t src, int16_t value, uint32_t param);
+uint8_t EventBus_PostFromISR(EventType_t type, uint8_t src, int16_t value, uint32_t param);
+
+/**
+  * @brief  分发任务: 取出进入时已在队列中的事件，按类型调用处理函数
+  * @note   放入调度器任务表，排在各生产者任务之后，同一节拍内即可完成分发
+  */
+uint32_t EventBus_Dispatch_Task(void);
+
+/**
+  * @brief  统计打印任务: [EvtBus] 各队列当前占用 / 历史最高 / 丢弃数
+  */
+uint32_t EventBus_Stats_Task(void);
+
+#endif
@@ -0,0 +1,156 @@
+/**
+  ******************************************************************************
+  * @file    Scheduler.c
+  * @brief   协作式节拍调度器实现
+  ******************************************************************************
+  */
+#include "Scheduler.h"
+#include "SystemSupport.h"
+#include "USART_DMA.h"
+#include <string.h>
+
+// 统计打印时的串口水位上限 (%)，避免挤占协议帧的发送缓冲
+#define SCHED_STATS_TX_LIMIT    50
+
+static Sched_Task_t *s_Tasks = NULL;
+static uint8_t  s_TaskNum = 0;
+static uint32_t s_CycPerUs = 72;
+static uint32_t s_StatsStart = 0;   // 本统计窗口起点 (tick)
+
+/* ============================================================
+ *                 内部辅助
+ * ============================================================ */
+
+/**
+  * @brief  任务本周期完成: 统计响应时间并计算下一次释放时刻
+  * @note   释放时刻按周期对齐；若已错过整周期 (上一周期拖得太久)，丢弃错过的释放并计数
+  */
+static void _Complete(Sched_Task_t *t, uint32_t now)
+{
+    uint32_t resp = now - t->Release;
+    uint32_t deadline = t->Deadline_ms ? t->Deadline_ms : t->Period_ms;
+    uint32_t next = t->Release + t->Period_ms;
+
+    t->Active = 0;
+    t->Stats.Runs++;
+    if (resp > t->Stats.RespMaxMs) t->Stats.RespMaxMs = resp;
+    if (resp > deadline) t->Stats.Overruns++;
+
+    if ((int32_t)(now - next) >= (int32_t)t->Period_ms)
+    {
+        uint32_t missed = (now - next) / t->Period_ms;
+        t->Stats.Skips += missed;
+        next += missed * t->Period_ms;
+    }
+    t->NextRun = next;
+}
+
+static void _ResetStats(void)
+{
+    for (uint8_t i = 0; i < s_TaskNum; i++)
+    {
+        memset(&s_Tasks[i].Stats, 0, sizeof(Sched_Stats_t));
+    }
+    s_StatsStart = System_GetTick();
+}
+
+/* ============================================================
+ *                 接口实现
+ * ============================================================ */
+
+void Scheduler_Init(Sched_Task_t *tasks, uint8_t num)
+{
+    s_Tasks = tasks;
+    s_TaskNum = num;
+    s_CycPerUs = SystemCoreClock / 1000000; // DWT CYCCNT 已在 System_Init 中开启
+
+    uint32_t now = System_GetTick();
+    for (uint8_t i = 0; i < num; i++)
+    {
+        tasks[i].Active = 0;
+        tasks[i].NextRun = now;
+    }
+    _ResetStats();
+}
+
+void Scheduler_Run(void)
+{
+    uint32_t now = System_GetTick();
+    Sched_Task_t *sel = NULL;
+
+    // 1. 挑选已到期 (释放或恢复) 且优先级最高的任务
+    for (uint8_t i = 0; i < s_TaskNum; i++)
+    {
+        Sched_Task_t *t = &s_Tasks[i];
+        if ((int32_t)(now - t->NextRun) < 0) continue;
+        if (sel == NULL || t->Priority < sel->Priority) sel = t;
+    }
+
+    if (sel == NULL)
+    {
+#if SCHED_IDLE_WFI
+        __WFI(); // 休眠到下一个中断 (SysTick 每 1ms 唤醒一次，DMA 照常工作)
+#endif
+        return;
+    }
+
+    if (!sel->Active)
+    {
+        sel->Active = 1;
+        sel->Release = sel->NextRun; // 以名义释放时刻计算响应时间，包含排队等待
+    }
+
+    // 2. 执行一步并计时
+    uint32_t cyc = System_GetCycle();
+    uint32_t ret = sel->Func();
+    uint32_t us = (System_GetCycle() - cyc) / s_CycPerUs;
+
+    sel->Stats.Steps++;
+    sel->Stats.ExecSumUs += us;
+    if (us > sel->Stats.StepMaxUs) sel->Stats.StepMaxUs = us;
+
+    // 3. 分步任务: 记录恢复时刻；完成: 结算本周期
+    now = System_GetTick();
+    if (ret != SCHED_DONE)
+    {
+        sel->NextRun = now + ret;
+        return;
+    }
+    _Complete(sel, now);
+}
+
+uint32_t Scheduler_Stats_Task(void)
+{
+    static uint8_t s_Idx = 0;
+
+    if (USART_DMA_GetUsage() > SCHED_STATS_TX_LIMIT) return SCHED_NEXT_STEP;
+
+    // 第 0 步: 汇总行
+    if (s_Idx == 0)
+    {
+        uint32_t window = System_GetTick() - s_StatsStart;
+        uint32_t busy_us = 0;
+        for (uint8_t i = 0; i < s_TaskNum; i++) busy_us += s_Tasks[i].Stats.ExecSumUs;
+        uint32_t permille = window ? busy_us / window : 0;
+
+        USART_DMA_Printf("[Sched] window=%lums cpu=%lu.%lu%%\r\n",
+                         (unsigned long)window, (unsigned long)(permille / 10), (unsigned long)(permille % 10));
+        s_Idx = 1;
+        return SCHED_NEXT_STEP;
+    }
+
+    // 第 1..N 步: 每步一个任务
+    const Sched_Task_t *t = &s_Tasks[s_Idx - 1];
+    const Sched_Stats_t *st = &t->Stats;
+    USART_DMA_Printf("[Sched] %-6s runs=%lu max=%luus avg=%luus resp=%lu/%ums ovr=%u skip=%u\r\n",
+                     t->Name, (unsigned long)st->Runs, (unsigned long)st->StepMaxUs,
+                     (unsigned long)(st->Steps ? st->ExecSumUs / st->Steps : 0),
+                     (unsigned long)st->RespMaxMs, t->Deadline_ms ? t->Deadline_ms : t->Period_ms,
+                     st->Overruns, st->Skips);
+
+    if (++s_Idx <= s_TaskNum) return SCHED_NEXT_STEP;
+
+    s_Idx = 0;
+    _ResetStats();
+    return SCHED_DONE;
+}
@@ -0,0 +1,79 @@
+/**
+  ******************************************************************************
+  * @file    Scheduler.h
+  * @brief   协作式节拍调度器 (静态任务表)
+  * @note    非抢占: 每次调度只执行一个任务的"一步"，执行完立即回到调度点按优先级重选。
+  *          因此高优先级任务 (编码器/按键) 的最坏等待 = 其他任务中最长的单步耗时。
+  *          耗时长的任务应拆分为可恢复的多步，通过返回值告诉调度器何时继续。
+  ******************************************************************************
+  */
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#include <stdint.h>
+
+/* ============================================================
+ *                 任务入口返回值
+ * ============================================================ */
+#define SCHED_DONE          0u  // 本周期工作已完成，等待下一次释放
+#define SCHED_NEXT_STEP     1u  // 还有后续步骤，下一个节拍继续
+// 其余正数 N: 还有后续步骤，N ms 后继续 (例如 DHT11 起始信号需保持 20ms)
+
+typedef uint32_t (*Sched_Func_t)(void);
+
+/**
+  * @brief 单个任务的运行统计 (每个统计周期清零)
+  */
+typedef struct {
+    uint32_t Runs;          /*!< 完成的周期数 */
+    uint32_t Steps;         /*!< 执行的步数 */
+    uint32_t StepMaxUs;     /*!< 单步最长耗时 (DWT 周期计数换算) */
+    uint32_t ExecSumUs;     /*!< 累计执行时间 (用于计算 CPU 占用) */
+    uint32_t RespMaxMs;     /*!< 释放 -> 完成 的最长响应时间 */
+    uint16_t Overruns;      /*!< 响应时间超过截止时间的次数 */
+    uint16_t Skips;         /*!< 因上一周期未完成而丢弃的释放次数 */
+} Sched_Stats_t;
+
+/**
+  * @brief 任务控制块 (静态配置 + 调度器维护的运行时状态)
+  */
+typedef struct {
+    const char*   Name;         /*!< 任务名 (统计打印用，建议 <= 6 字符) */
+    Sched_Func_t  Func;         /*!< 任务入口，每次调用执行一步 */
+    uint16_t      Period_ms;    /*!< 释放周期 (>= 1) */
+    uint16_t      Deadline_ms;  /*!< 相对释放时刻的截止时间，0 表示等于周期 */
+    uint8_t       Priority;     /*!< 数值越小优先级越高，相同时按表中顺序 */
+
+    uint8_t       Active;       /*!< 1: 本周期已释放且未完成 (包括分步进行中) */
+    uint32_t      Release;      /*!< 本周期的释放时刻 (tick) */
+    uint32_t      NextRun;      /*!< 下一次可执行的时刻 (下次释放或恢复时刻) */
+    Sched_Stats_t Stats;
+} Sched_Task_t;
+
+/** @brief 任务表条目 (名称, 入口, 周期ms, 截止ms, 优先级) */
+#define SCHED_TASK(name, func, period, deadline, prio) \
+    { (name), (func), (period), (deadline), (prio), 0, 0, 0, {0} }
+
+/* ============================================================
+ *                 接口
+ * ============================================================ */
+
+/**
+  * @brief  绑定静态任务表 (单步计时使用 System_Init 开启的 DWT 周期计数器)
+  * @note   所有任务在调用时刻同时首次释放
+  */
+void Scheduler_Init(Sched_Task_t *tasks, uint8_t num);
+
+/**
+  * @brief  调度一次: 挑选优先级最高的就绪任务执行一步
+  * @note   在 super-loop 中反复调用；无就绪任务时按配置 __WFI 休眠到下一个 SysTick
+  */
+void Scheduler_Run(void);
+
+/**
+  * @brief  统计打印任务 (可作为普通任务放入任务表)
+  * @note   每步打印一个任务的 [Sched] 统计行，打印完一轮后清零统计
+  */
+uint32_t Scheduler_Stats_Task(void);
+
+#endif
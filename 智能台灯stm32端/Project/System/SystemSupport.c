@@ -1,5 +1,10 @@
 #include "SystemSupport.h"
 
+// --- DWT 周期计数器 (旧版 core_cm3.h 未定义 DWT 结构体，直接按地址访问) ---
+#define DWT_CTRL        (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT      (*(volatile uint32_t *)0xE0001004)
+#define DWT_CTRL_CYCCNTENA  (1ul << 0)
+
 // 全局系统节拍计数器
 static volatile uint32_t g_SystemTick = 0;
 
@@ -18,6 +23,11 @@ void System_Init(void)
     {
         while (1);
     }
+
+    /* 2. 开启 DWT CYCCNT (72MHz 下约 59s 回绕，只用于差值计时，回绕无影响) */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
 }
 
 /**
@@ -28,6 +38,14 @@ uint32_t System_GetTick(void)
     return g_SystemTick;
 }
 
+/**
+  * @brief  获取 CPU 周期计数
+  */
+uint32_t System_GetCycle(void)
+{
+    return DWT_CYCCNT;
+}
+
 /**
   * @brief  Tick 递增 (在 ISR 中调用)
   */
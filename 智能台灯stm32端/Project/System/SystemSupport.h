@@ -6,7 +6,7 @@
 
 /**
   * @brief  系统基础服务初始化
-  * @note   配置 SysTick 产生系统节拍
+  * @note   配置 SysTick 产生系统节拍，并开启 DWT 周期计数器
   */
 void System_Init(void);
 
@@ -16,6 +16,12 @@ void System_Init(void);
   */
 uint32_t System_GetTick(void);
 
+/**
+  * @brief  获取 DWT 周期计数 (SystemCoreClock 频率自由递增)
+  * @note   用于微秒级耗时统计，取两次差值后除以 (SystemCoreClock / 1000000)
+  */
+uint32_t System_GetCycle(void);
+
 /**
   * @brief  SysTick 中断处理函数
   * @note   需要在 stm32f10x_it.c 的 SysTick_Handler 中调用
@@ -14,6 +14,94 @@
 // 计算每个节拍的微秒数 (1000Hz -> 1000us = 1ms)
 #define SYSTEM_TICK_PERIOD_US   (1000000 / SYSTEM_TICK_FREQ)
 
+/* ============================================================
+ *                 Scheduler Settings
+ * ============================================================ */
+// [Sched] 任务统计打印周期 (ms)
+#define SCHED_STATS_PERIOD_MS   10000
+
+// 无就绪任务时执行 __WFI 休眠到下一个 SysTick (调试器连接异常时可改为 0)
+#define SCHED_IDLE_WFI          1
+
+/* ============================================================
+ *                 I2C Settings
+ * ============================================================ */
+// 1: 硬件 I2C (中断 / DMA 完成，非阻塞队列)  0: 软件模拟 I2C
+#define I2C1_USE_HW             1       // OLED,    PB8/PB9 重映射, DMA1 Ch6/Ch7
+#define I2C2_USE_HW             1       // PAJ7620, PB10/PB11, 中断逐字节 (Ch4/Ch5 被 USART1 占用)
+
+// 硬件 I2C 时钟 (OLED 与 PAJ7620 均支持 400kHz 快速模式)
+#define I2C_HW_SPEED_HZ         400000
+
+// 单个事务超时 (ms)，超时后中止队列并做总线恢复
+#define I2C_HW_TIMEOUT_MS       5
+
+// 连续总线错误 / 超时达到该次数后回退到软件模拟 (F103 I2C 勘误兜底)
+#define I2C_HW_MAX_BUS_ERR      3
+
+/* ============================================================
+ *                 Gesture Settings
+ * ============================================================ */
+// 1: 使用 PAJ7620 INT 引脚 (PB5, EXTI5) 触发读取  0: 每个 gest 周期都读手势标志
+#define PAJ_USE_INT_PIN         1
+
+// INT 模式下的保底轮询间隔 (ms)，INT 未接线 / 漏沿时手势最多延迟这么久
+#define PAJ_IDLE_POLL_MS        500
+
+/* ============================================================
+ *                 Ambient Light (LDR) Settings
+ * ============================================================ */
+// ADC 采样率 (Hz)，由 TIM1 CC1 触发，DMA1_Ch1 搬运
+#define LDR_SAMPLE_RATE_HZ      4000
+
+// 每块采样数: 4kHz x 40 = 10ms，正好一个 100Hz 灯光闪烁周期，块平均后输出 100Hz
+#define LDR_BLOCK_SAMPLES       40
+
+// 块输出的一阶 IIR 系数 1/2^N (3 -> 时间常数约 8 块 = 80ms)
+#define LDR_IIR_SHIFT           3
+
+/* ============================================================
+ *                 Ambient Light Compensation (ALC) Settings
+ * ============================================================ */
+// 闭环周期 (ms)，在 ctrl 任务 (50ms) 中执行，应为其整数倍
+#define ALC_PERIOD_MS           50
+
+// PI 增益 (x256，增量式: dU = Kp*(e - e_prev) + Ki*e)，由 sim_7_1_7_alc_daylight.py 整定
+#define ALC_KP_Q8               256
+#define ALC_KI_Q8               512
+
+// 每周期亮度最大变化量 (0~1000 量纲)，限制调光速度使变化不可察觉
+#define ALC_MAX_STEP            6
+
+// 误差死区 (LDR 0~1000 量纲)，到位后不再跟随噪声微调
+#define ALC_DEADBAND            2
+
+// 闭环时的最低亮度，环境光再强也不会把灯完全关掉
+#define ALC_MIN_BRI             50
+
+// 闭环期间收到与最近一次上报相差不超过该值的 "light" 指令，视为 ESP32 回显而忽略
+#define ALC_ECHO_TOL            20
+
+/* ============================================================
+ *                 LED Mixing Settings
+ * ============================================================ */
+// 暖 / 冷两路满占空比时的相对光通量 (实测 lm 或照度计读数均可，只看比值)
+// 较亮的一路会按比例降额，保证调节色温时总光通量不变
+#define LED_WARM_FLUX           100
+#define LED_COLD_FLUX           100
+
+/* ============================================================
+ *                 Fade Engine Settings
+ * ============================================================ */
+// 远程 light 指令 / 双击复位 / 关灯的过渡时长 (ms)，0 = 立即跳变
+#define FADE_RAW_MS             150
+
+// 无极调光每 50ms 更新一次目标，过渡时长略长于更新间隔，输出连续不停顿
+#define FADE_PROX_MS            60
+
+// 协议 fade 指令的最大时长 (ms)
+#define FADE_MAX_MS             60000
+
 /* ============================================================
  *                 Encoder Settings
  * ============================================================ */
@@ -34,6 +122,9 @@
 #define KEY_REPEAT_RATE_MS          0       // 长按连发间隔 (0=关闭)
 
 
+// 按键 ID (KeyManager 掩码位号，同时作为 EVT_KEY 事件的 Src)
+#define KEY_ID_MODE                 0       // ModeSW (PB1)
+
 // [新增] 连击判定窗口
 // 松手后，如果在此时间内再次按下，则判定为连击；否则结算为单击
 #define KEY_MULTI_CLICK_GAP_MS      250 
@@ -2,13 +2,18 @@
 /**
   ******************************************************************************
   * @file    main.c
-  * @brief   主程序 (V13.1 Proximity Sync Fix)
+  * @brief   主程序 (V13.4 HW I2C)
   * @note    集成 KeyManager V2.0，支持多键、连击与长按
   *          修复无极调光结束后状态不同步的问题
+  *          主循环改为静态任务表 + 协作式调度器 (Scheduler.c)
+  *          输入事件经 EventBus 投递给 ControlManager，驱动与业务解耦
+  *          OLED / PAJ7620 改用硬件 I2C (DMA / 中断完成)，手势轮询非阻塞
   ******************************************************************************
   */
 #include "stm32f10x.h"
 #include "SystemSupport.h"
+#include "Scheduler.h"
+#include "EventBus.h"
 #include "USART_DMA.h"
 #include "Protocol.h"
 #include "ControlManager.h"
@@ -20,41 +25,54 @@
 #include "Encoder.h"
 #include "PAJ7620.h"
 #include "KeyManager.h" // 新的按键管理器
+#include "I2C_Driver.h"
 
 /* ============================================================
  *      按键定义与 ID 映射
  * ============================================================ */
 static Key_t Key_Mode;
 
-// 定义 ID (用于掩码位移)
-#define KID_MODE    0
-
-// 定义掩码 (方便判断)
-#define MASK_MODE   (1 << KID_MODE)
+// 定义掩码 (方便判断)，ID 见 Config.h
+#define MASK_MODE   KEY_MASK(KEY_ID_MODE)
 
 /* ============================================================
- *      回调函数实现 (连接驱动层与业务层)
+ *      回调函数实现 (驱动层 -> EventBus)
  * ============================================================ */
 
 // --- 手势事件回调 (离散) ---
-void PAJ7620_Hook_OnUp(void)        { Control_OnGesture(PAJ7620_GESTURE_UP); }
-void PAJ7620_Hook_OnDown(void)      { Control_OnGesture(PAJ7620_GESTURE_DOWN); }
-void PAJ7620_Hook_OnLeft(void)      { Control_OnGesture(PAJ7620_GESTURE_LEFT); }
-void PAJ7620_Hook_OnRight(void)     { Control_OnGesture(PAJ7620_GESTURE_RIGHT); }
-void PAJ7620_Hook_OnForward(void)   { Control_OnGesture(PAJ7620_GESTURE_FORWARD); }
-void PAJ7620_Hook_OnBackward(void)  { Control_OnGesture(PAJ7620_GESTURE_BACKWARD); }
-void PAJ7620_Hook_OnClockwise(void) { Control_OnGesture(PAJ7620_GESTURE_CLOCKWISE); }
-void PAJ7620_Hook_OnCounterClockwise(void) { Control_OnGesture(PAJ7620_GESTURE_COUNTER_CW); }
-void PAJ7620_Hook_OnWave(void)      { Control_OnGesture(PAJ7620_GESTURE_WAVE); }
+void PAJ7620_Hook_OnUp(void)        { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_UP, 0); }
+void PAJ7620_Hook_OnDown(void)      { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_DOWN, 0); }
+void PAJ7620_Hook_OnLeft(void)      { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_LEFT, 0); }
+void PAJ7620_Hook_OnRight(void)     { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_RIGHT, 0); }
+void PAJ7620_Hook_OnForward(void)   { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_FORWARD, 0); }
+void PAJ7620_Hook_OnBackward(void)  { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_BACKWARD, 0); }
+void PAJ7620_Hook_OnClockwise(void) { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_CLOCKWISE, 0); }
+void PAJ7620_Hook_OnCounterClockwise(void) { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_COUNTER_CW, 0); }
+void PAJ7620_Hook_OnWave(void)      { EventBus_Post(EVT_GESTURE, 0, PAJ7620_GESTURE_WAVE, 0); }
 
 // --- 手势事件回调 (实时) ---
 void PAJ7620_Hook_OnProximity(uint8_t brightness) {
-    Control_OnProximity(brightness);
+    EventBus_Post(EVT_PROXIMITY, 0, brightness, 0);
 }
 
 // [新增] 退出无极调光回调
 void PAJ7620_Hook_OnProximityExit(void) {
-    Control_OnProximityExit();
+    EventBus_Post(EVT_PROXIMITY_EXIT, 0, 0, 0);
+}
+
+// --- 手势 INT (中断上下文) ---
+void PAJ7620_Hook_OnIntFromISR(void) {
+    EventBus_PostFromISR(EVT_GESTURE_INT, 0, 0, 0);
+}
+
+/**
+ * @brief INT 事件: 在同一节拍的分发任务中就提交手势标志读取，
+ *        不必等到下一个 10ms 的 gest 周期 (gest 任务照常运行，负责取回结果与近距调光)
+ */
+static void OnGestureInt(const Event_t *evt)
+{
+    (void)evt;
+    PAJ7620_Process_StateMachine();
 }
 
 /* ============================================================
@@ -70,10 +88,98 @@ void Hardware_Init_Keys(void)
 
     // 3. 初始化并注册按键
     // ModeSW: PB1, 低电平有效 (0)
-    Key_Init(&Key_Mode, KID_MODE, GPIOB, GPIO_Pin_1, 0);
+    Key_Init(&Key_Mode, KEY_ID_MODE, GPIOB, GPIO_Pin_1, 0);
     KeyManager_Register(&Key_Mode);
 }
 
+/* ============================================================
+ *      调度任务 (每次调用执行一步，返回值见 Scheduler.h)
+ * ============================================================ */
+static uint32_t Task_Protocol(void)
+{
+    Protocol_Process();
+    return SCHED_DONE;
+}
+
+static uint32_t Task_Encoder(void)
+{
+    int16_t enc_diff = Encoder_Get();
+    if (enc_diff != 0) {
+        EventBus_Post(EVT_ENCODER, 0, enc_diff, 0);
+    }
+    return SCHED_DONE;
+}
+
+static uint32_t Task_Key(void)
+{
+    // 按键状态机处理 (核心逻辑)
+    KeyManager_Tick();
+
+    // 按键事件投递 (适配层)
+    KeyEvent_t k_evt;
+    if (KeyManager_GetEvent(&k_evt))
+    {
+        // 仅处理 Mode 键 (未来可扩展组合键)
+        if (k_evt.Mask == MASK_MODE)
+        {
+            switch (k_evt.Type) {
+                case KEY_EVT_CLICK:
+                case KEY_EVT_DOUBLE_CLICK:
+                case KEY_EVT_TRIPLE_CLICK:
+                case KEY_EVT_HOLD_START:
+                case KEY_EVT_HOLD_END:
+                    // Param: 长按结束时为长按时长 (ms)
+                    EventBus_Post(EVT_KEY, KEY_ID_MODE, (int16_t)k_evt.Type, k_evt.Param);
+                    break;
+                default: break;
+            }
+        }
+    }
+    return SCHED_DONE;
+}
+
+static uint32_t Task_Gesture(void)
+{
+    PAJ7620_Process_StateMachine();
+    return SCHED_DONE;
+}
+
+static uint32_t Task_Control(void)
+{
+    Control_Task();
+    return SCHED_DONE;
+}
+
+static uint32_t Task_Heartbeat(void)
+{
+    static uint32_t hb_count = 0;
+    Protocol_Report_Heartbeat(hb_count++);
+    return SCHED_DONE;
+}
+
+/* ============================================================
+ *      静态任务表
+ *      优先级数值越小越优先；同一时刻只执行一个任务的一步，
+ *      因此编码器/按键的最坏延迟由其他任务的最长单步决定。
+ *      修改后可用 Thesis_Data_Analysis/sim_7_1_4_scheduler_latency.py 回放评估。
+ * ============================================================ */
+static Sched_Task_t s_Tasks[] = {
+    //          名称      入口              周期ms  截止ms  优先级
+    SCHED_TASK("enc",    Task_Encoder,        1,      5,    0),
+    SCHED_TASK("key",    Task_Key,            5,     10,    0),
+    SCHED_TASK("evt",    EventBus_Dispatch_Task, 1,   5,    0),   // 排在生产者之后，同一节拍内分发
+    SCHED_TASK("proto",  Task_Protocol,       1,     10,    1),
+    SCHED_TASK("gest",   Task_Gesture,       10,     20,    2),
+    SCHED_TASK("ctrl",   Task_Control,       50,      0,    3),
+    SCHED_TASK("ui",     UIManager_Task,    100,    200,    4),
+    SCHED_TASK("hb",     Task_Heartbeat,   2000,      0,    5),
+    SCHED_TASK("sensor", SensorHub_Task,   2000,    100,    5),
+    SCHED_TASK("stats",  Scheduler_Stats_Task, SCHED_STATS_PERIOD_MS, 0, 7),
+    SCHED_TASK("evstat", EventBus_Stats_Task,  SCHED_STATS_PERIOD_MS, 0, 7),
+    SCHED_TASK("i2c",    I2C_Lib_Stats_Task,   SCHED_STATS_PERIOD_MS, 0, 7),
+    SCHED_TASK("paj",    PAJ7620_Stats_Task,   SCHED_STATS_PERIOD_MS, 0, 7),
+};
+
 /* ============================================================
  *      主函数
  * ============================================================ */
@@ -84,12 +190,13 @@ int main(void)
     Delay_ms(100); // 等待电源稳定
     USART_DMA_Init();
     
-    printf("\r\n=== Smart Lamp System V13.1 (Proximity Sync Fix) ===\r\n");
+    printf("\r\n=== Smart Lamp System V13.4 (HW I2C) ===\r\n");
 
     // 2. 数据模型初始化 (必须最先)
     SystemModel_Init();
 
-    // 3. 业务层初始化
+    // 3. 业务层初始化 (EventBus 须先于 Control_Init，后者在其中订阅事件)
+    EventBus_Init();
     Protocol_Init();
     Control_Init();   
     SensorHub_Init(); 
@@ -98,87 +205,19 @@ int main(void)
     // 4. 输入设备初始化
     Encoder_Init();
     Hardware_Init_Keys(); // 初始化新按键库
-    
+
+    EventBus_Subscribe(EVT_GESTURE_INT, OnGestureInt);   // 先订阅，PAJ7620_Init 中才打开 EXTI
     if (PAJ7620_Init() != 0) {
         printf("[Main] Gesture Init Failed.\r\n");
     } else {
         printf("[Main] Gesture Ready.\r\n");
     }
 
-    // 5. 调度器计时器
-    uint32_t tick_50ms = 0;
-    uint32_t tick_100ms = 0;
-    uint32_t tick_2000ms = 0;
-    uint32_t hb_count = 0;
+    // 5. 启动调度器 (所有任务在此刻首次释放)
+    Scheduler_Init(s_Tasks, sizeof(s_Tasks) / sizeof(s_Tasks[0]));
 
     while (1)
     {
-        uint32_t now = System_GetTick();
-
-        // --- L1: 实时任务 (尽可能快) ---
-        Protocol_Process(); 
-        
-        // 编码器处理
-        int16_t enc_diff = Encoder_Get();
-        if (enc_diff != 0) {
-            Control_OnEncoder(enc_diff);
-        }
-
-        // 按键状态机处理 (核心逻辑)
-        KeyManager_Tick();
-
-        // 按键事件分发 (适配层)
-        KeyEvent_t k_evt;
-        if (KeyManager_GetEvent(&k_evt))
-        {
-            // 仅处理 Mode 键 (未来可扩展组合键)
-            if (k_evt.Mask == MASK_MODE)
-            {
-                char* act_str = NULL;
-                switch (k_evt.Type) {
-                    case KEY_EVT_CLICK:         act_str = "click";   break;
-                    case KEY_EVT_DOUBLE_CLICK:  act_str = "double";  break;
-                    case KEY_EVT_TRIPLE_CLICK:  act_str = "triple";  break;
-                    case KEY_EVT_HOLD_START:    act_str = "hold";    break;
-                    case KEY_EVT_HOLD_END:      act_str = "release"; break;
-                    default: break;
-                }
-                
-                if (act_str != NULL) {
-                    // 转发给业务层
-                    Control_OnKey("ModeSW", act_str);
-                    
-                    // 如果是长按结束，还可以打印时长用于调试
-                    if (k_evt.Type == KEY_EVT_HOLD_END) {
-                        printf("[Main] Hold Duration: %d ms\r\n", k_evt.Param);
-                    }
-                }
-            }
-        }
-
-        // 手势状态机处理
-        PAJ7620_Process_StateMachine();
-
-        // --- L2: 50ms 任务 (业务逻辑) ---
-        if (now - tick_50ms >= 50)
-        {
-            tick_50ms = now;
-            Control_Task(); 
-        }
-
-        // --- L3: 100ms 任务 (UI 刷新) ---
-        if (now - tick_100ms >= 100)
-        {
-            tick_100ms = now;
-            UIManager_Task(); 
-        }
-
-        // --- L4: 2000ms 任务 (传感器 & 心跳) ---
-        if (now - tick_2000ms >= 2000)
-        {
-            tick_2000ms = now;
-            Protocol_Report_Heartbeat(hb_count++);
-            SensorHub_Task();
-        }
+        Scheduler_Run();
     }
 }